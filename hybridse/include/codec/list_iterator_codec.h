@@ -105,6 +105,8 @@ class ColumnImpl : public WrapListImpl<V, Row> {
     V At(uint64_t pos) override { return GetFieldUnsafe(root_->At(pos)); }
 
     ListV<Row> *root() const override { return root_; }
+    uint32_t GetRowIdx() const { return row_idx_; }
+    uint32_t GetColIdx() const { return col_idx_; }
 
  protected:
     ListV<Row> *root_;
@@ -31,6 +31,29 @@ using hybridse::base::ConstIterator;
 /// key type is `uint64_t` and value type is Row
 typedef ConstIterator<uint64_t, Row> RowIterator;
 
+/// \brief Reference to an encoded row inside a storage segment.
+///
+/// It does not hold the ownership of `buf`, which is only valid as long
+/// as the iterator producing it is alive.
+struct RowRef {
+    uint64_t key;
+    const int8_t *buf;
+    size_t size;
+};
+
+/// \brief A RowIterator which is able to gather several rows in one call.
+///
+/// Storage iterators implement it to save a virtual call per method per row
+/// and to prefetch row buffers ahead of the consumer. Consumers detect it
+/// with `dynamic_cast` and fall back to the row by row interface otherwise.
+class BatchRowIterator : public RowIterator {
+ public:
+    /// Gather at most `max_size` rows starting from current position into
+    /// `batch`, move the iterator past them and return the number of rows
+    /// gathered. Return 0 if the iterator is not Valid().
+    virtual size_t GetBatch(RowRef *batch, size_t max_size) = 0;
+};
+
 /// \brief A iterator over a Row-Iterator<codec::Row> pairs dataset.
 ///
 /// \b Example
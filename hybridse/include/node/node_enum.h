@@ -53,6 +53,7 @@ enum SqlNodeType {
     kIndexVersion,
     kIndexTTL,
     kIndexTTLType,
+    kIndexKeyEncoding,
     kName,
     kConst,
     kLimit,
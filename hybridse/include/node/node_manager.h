@@ -163,6 +163,7 @@ class NodeManager {
     SqlNode *MakeIndexTsNode(const std::string &ts);
     SqlNode *MakeIndexTTLNode(ExprListNode *ttl_expr);
     SqlNode *MakeIndexTTLTypeNode(const std::string &ttl_type);
+    SqlNode *MakeIndexKeyEncodingNode(const std::string &key_encoding);
     SqlNode *MakeIndexVersionNode(const std::string &version);
     SqlNode *MakeIndexVersionNode(const std::string &version, int count);
 
@@ -1948,6 +1948,16 @@ class IndexTTLTypeNode : public SqlNode {
  private:
     std::string ttl_type_;
 };
+class IndexKeyEncodingNode : public SqlNode {
+ public:
+    explicit IndexKeyEncodingNode(const std::string &key_encoding)
+        : SqlNode(kIndexKeyEncoding, 0, 0), key_encoding_(key_encoding) {}
+
+    const std::string &key_encoding() const { return key_encoding_; }
+
+ private:
+    std::string key_encoding_;
+};
 
 class ColumnIndexNode : public SqlNode {
  public:
@@ -1959,6 +1969,7 @@ class ColumnIndexNode : public SqlNode {
           abs_ttl_(-2),
           lat_ttl_(-2),
           ttl_type_(""),
+          key_encoding_(""),
           name_("") {}
 
     std::vector<std::string> &GetKey() { return key_; }
@@ -1982,6 +1993,9 @@ class ColumnIndexNode : public SqlNode {
     const std::string &ttl_type() const { return ttl_type_; }
     void set_ttl_type(const std::string &ttl_type) { ttl_type_ = ttl_type; }
 
+    const std::string &key_encoding() const { return key_encoding_; }
+    void set_key_encoding(const std::string &key_encoding) { key_encoding_ = key_encoding; }
+
     int64_t GetAbsTTL() const { return abs_ttl_; }
     int64_t GetLatTTL() const { return lat_ttl_; }
 
@@ -2063,6 +2077,7 @@ class ColumnIndexNode : public SqlNode {
     int64_t abs_ttl_;
     int64_t lat_ttl_;
     std::string ttl_type_;
+    std::string key_encoding_;
     std::string name_;
 };
 class CmdNode : public SqlNode {
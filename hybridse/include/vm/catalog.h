@@ -60,6 +60,57 @@ typedef std::map<std::string, ColInfo> Types;
 /// \typedef IndexHint a map with string type key and IndexSt value
 typedef std::map<std::string, IndexSt> IndexHint;
 
+/// Statistics of an index, used by the physical planner to estimate the cost
+/// of looking up rows with the index.
+struct IndexStatistics {
+    uint64_t key_cnt = 0;  ///< number of distinct keys
+    uint64_t row_cnt = 0;  ///< number of rows, bounded by ttl
+    /// Histogram of rows per key over sampled keys, the i-th bucket is the
+    /// number of sampled keys holding [2^i, 2^(i+1)) rows
+    std::vector<uint64_t> key_histogram;
+
+    /// Add the row count of a sampled key into key_histogram
+    void AddSampledKey(uint64_t rows) {
+        if (0 == rows) {
+            return;
+        }
+        size_t bucket = 63 - __builtin_clzll(rows);
+        if (key_histogram.size() <= bucket) {
+            key_histogram.resize(bucket + 1, 0);
+        }
+        key_histogram[bucket]++;
+    }
+};
+
+/// One side of a column value range. The value is in the text form of the
+/// column type, e.g, "100", "1.5" or the string itself
+struct RangeBound {
+    bool bounded = false;    ///< false if there is no limit on this side
+    bool inclusive = false;  ///< true if the value itself is in the range
+    std::string value;
+};
+
+/// A value range of a column, the rows in which can be scanned with an
+/// ordered range index on the column
+struct ColumnRange {
+    std::string column;
+    RangeBound lower;
+    RangeBound upper;
+
+    bool Valid() const {
+        return !column.empty() && (lower.bounded || upper.bounded);
+    }
+    const std::string ToString() const {
+        std::string str = column;
+        str.append(lower.bounded ? (lower.inclusive ? "[" : "(") + lower.value
+                                 : "(-inf");
+        str.append(", ");
+        str.append(upper.bounded ? upper.value + (upper.inclusive ? "]" : ")")
+                                 : "+inf)");
+        return str;
+    }
+};
+
 class PartitionHandler;
 class TableHandler;
 class RowHandler;
@@ -245,6 +296,36 @@ class TableHandler : public DataHandler {
     /// and return OrderType::kNoneOrder by default.
     virtual const OrderType GetOrderType() const { return kNoneOrder; }
 
+    /// Collect statistics of given index into `stats`.
+    /// Return `false` by default, which means no statistics are available.
+    virtual bool GetIndexStatistics(const std::string& index_name,
+                                    IndexStatistics* stats) {
+        return false;
+    }
+
+    /// Return true if the rows can be scanned by the value range of `column`
+    /// with an ordered range index. Return `false` by default.
+    virtual bool HasRangeIndex(const std::string& column) { return false; }
+
+    /// Return the iterator of rows whose value is in `range`, the rows may be
+    /// in any order. Return `null` by default, which means the range can not
+    /// be scanned and the whole table should be iterated.
+    virtual std::unique_ptr<RowIterator> GetRangeIterator(
+        const ColumnRange& range) {
+        return std::unique_ptr<RowIterator>();
+    }
+
+    /// Get the version of the rows in the dataset into `version`, it changes
+    /// once any row is added or removed. Return `false` by default, which
+    /// means the version is unknown and the rows can not be cached.
+    virtual bool GetVersion(uint64_t* version) { return false; }
+
+    /// Get the time into `expire_time`, the rows with keys not later than
+    /// it are expired. Rows expire as time goes by without changing the
+    /// version. Return `false` by default, which means the rows never expire
+    /// by time.
+    virtual bool GetExpireTime(uint64_t* expire_time) { return false; }
+
     /// Return Tablet binding to specify index and key.
     /// Return `null` by default.
     virtual std::shared_ptr<Tablet> GetTablet(const std::string& index_name,
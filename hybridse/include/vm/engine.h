@@ -34,6 +34,7 @@
 #include "proto/fe_common.pb.h"
 #include "vm/catalog.h"
 #include "vm/engine_context.h"
+#include "vm/profile.h"
 #include "vm/router.h"
 
 namespace hybridse {
@@ -42,6 +43,9 @@ namespace vm {
 using ::hybridse::codec::Row;
 
 inline constexpr const char* LONG_WINDOWS = "long_windows";
+// the count of keys whose window scans are cached across requests by every
+// window of a deployment, see WindowScanCache
+inline constexpr const char* WINDOW_CACHE = "window_cache";
 
 class Engine;
 /// \brief An options class for controlling engine behaviour.
@@ -178,6 +182,15 @@ class RunSession {
     /// Return if this run session support printing debug information.
     bool IsDebug() { return is_debug_; }
 
+    /// Enable collecting per-runner statistics while running a query.
+    void EnableProfile() { is_profile_ = true; }
+    /// Disable collecting per-runner statistics while running a query.
+    void DisableProfile() { is_profile_ = false; }
+    /// Return if this run session collects per-runner statistics.
+    bool IsProfile() const { return is_profile_; }
+    /// Return the profile of the last run, null if profiling is disabled.
+    std::shared_ptr<const RunProfile> GetProfile() const { return profile_; }
+
     /// Bind this run session with specific procedure
     void SetSpName(const std::string& sp_name) { sp_name_ = sp_name; }
     /// Return the engine mode of this run session
@@ -195,9 +208,43 @@ class RunSession {
     std::shared_ptr<hybridse::vm::CompileInfo> compile_info_;
     hybridse::vm::EngineMode engine_mode_;
     bool is_debug_;
+    bool is_profile_ = false;
+    std::shared_ptr<RunProfile> profile_;
     std::string sp_name_;
     std::shared_ptr<const std::unordered_map<std::string, std::string>> options_ = nullptr;
     friend Engine;
+    class ProfileRun;
+};
+
+/// \brief BatchRunCursor iterates the output rows of a batch mode query lazily.
+///
+/// Rows are computed by the runners only when they are pulled, the cursor
+/// keeps the compiled plan and the running context alive until it is
+/// destroyed. A cursor is not thread-safe.
+class BatchRunCursor {
+ public:
+    ~BatchRunCursor();
+    /// Return true if the cursor points to a valid row
+    bool Valid() const;
+    /// Return the row the cursor points to
+    const Row& GetValue() const;
+    /// Move the cursor to the next row
+    void Next();
+
+ private:
+    BatchRunCursor(const std::shared_ptr<CompileInfo>& compile_info,
+                   const Row& parameter_row, bool is_debug,
+                   const std::shared_ptr<RunProfile>& profile);
+    bool Open();
+
+    std::shared_ptr<CompileInfo> compile_info_;
+    std::unique_ptr<RunnerContext> ctx_;
+    std::shared_ptr<RunProfile> profile_;
+    std::shared_ptr<DataHandler> output_;
+    std::unique_ptr<RowIterator> iter_;
+    Row row_;
+    bool row_valid_;
+    friend class BatchRunSession;
 };
 
 /// \brief BatchRunSession is a kind of RunSession designed for batch mode query.
@@ -215,6 +262,10 @@ class BatchRunSession : public RunSession {
     /// Query results will be returned as std::vector<Row> in output
     int32_t Run(std::vector<Row>& output,  // NOLINT
                 uint64_t limit = 0);
+
+    /// \brief Query sql with parameter row in batch mode without
+    /// materializing the result. Return null if the query fails to run.
+    std::shared_ptr<BatchRunCursor> OpenCursor(const Row& parameter_row);
     /// Bing the run session with specific parameter schema
     void SetParameterSchema(const codec::Schema& schema) { parameter_schema_ = schema; }
     /// Return query parameter schema.
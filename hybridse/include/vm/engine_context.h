@@ -59,6 +59,10 @@ class CompileInfo {
     virtual const hybridse::vm::BatchRequestInfo& GetBatchRequestInfo()
         const = 0;
     virtual const hybridse::vm::PhysicalOpNode* GetPhysicalPlan() const = 0;
+    /// Return the position of the router column in the request schema, -1
+    /// if the query is not routed by a request column. It is parsed from the
+    /// physical plan on the first call and kept with the compile info.
+    virtual int32_t GetRouterColIdx() const = 0;
     virtual void DumpPhysicalPlan(std::ostream& output,
                                   const std::string& tab) = 0;
     virtual void DumpClusterJob(std::ostream& output,
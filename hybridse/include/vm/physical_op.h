@@ -905,6 +905,9 @@ class Filter {
             << ", left_keys=" << node::ExprString(left_key_.keys())
             << ", right_keys=" << node::ExprString(right_key_.keys())
             << ", index_keys=" << node::ExprString(index_key_.keys());
+        if (range_scan_.Valid()) {
+            oss << ", range_scan=" << range_scan_.ToString();
+        }
         return oss.str();
     }
     const std::string FnDetail() const {
@@ -919,6 +922,7 @@ class Filter {
     const Key &right_key() const { return right_key_; }
     const Key &index_key() const { return index_key_; }
     const ConditionFilter &condition() const { return condition_; }
+    const ColumnRange &range_scan() const { return range_scan_; }
     virtual void ResolvedRelatedColumns(
         std::vector<const node::ExprNode *> *columns) const {
         left_key_.ResolvedRelatedColumns(columns);
@@ -934,6 +938,9 @@ class Filter {
     Key left_key_;
     Key right_key_;
     Key index_key_;
+    // the rows are scanned by the value range with a range index before the
+    // condition is applied, the condition still contains the range predicates
+    ColumnRange range_scan_;
 };
 
 class Join : public Filter {
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HYBRIDSE_INCLUDE_VM_PROFILE_H_
+#define HYBRIDSE_INCLUDE_VM_PROFILE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace hybridse {
+namespace vm {
+
+/// \brief Storage access counters of a query run.
+struct ProfileCounters {
+    uint64_t seek_cnt = 0;
+    uint64_t next_cnt = 0;
+    uint64_t decode_bytes = 0;
+
+    ProfileCounters& operator+=(const ProfileCounters& other) {
+        seek_cnt += other.seek_cnt;
+        next_cnt += other.next_cnt;
+        decode_bytes += other.decode_bytes;
+        return *this;
+    }
+    ProfileCounters operator-(const ProfileCounters& other) const {
+        ProfileCounters res;
+        res.seek_cnt = seek_cnt - other.seek_cnt;
+        res.next_cnt = next_cnt - other.next_cnt;
+        res.decode_bytes = decode_bytes - other.decode_bytes;
+        return res;
+    }
+};
+
+/// \brief Storage counters for query profiling.
+///
+/// The storage iterators call the Count* functions on every access, they only
+/// cost an atomic load unless a profiling run is in progress. The counters of
+/// the run are found in a local slot, which is thread-local by default. A
+/// server running queries in coroutines that may resume on another thread
+/// (e.g. bthreads blocked on an rpc) should install a coroutine-local slot
+/// with `SetLocalSlot` before running any query.
+class Profiler {
+ public:
+    typedef ProfileCounters* (*GetSlotFn)();
+    typedef void (*SetSlotFn)(ProfileCounters*);
+
+    /// Replace the thread-local slot, reset it with nullptr functions
+    static void SetLocalSlot(GetSlotFn get, SetSlotFn set) {
+        get_slot_ = get;
+        set_slot_ = set;
+    }
+
+    static bool IsEnabled() { return nullptr != Current(); }
+    static void CountSeek() {
+        ProfileCounters* counters = Current();
+        if (nullptr != counters) {
+            counters->seek_cnt++;
+        }
+    }
+    static void CountNext() {
+        ProfileCounters* counters = Current();
+        if (nullptr != counters) {
+            counters->next_cnt++;
+        }
+    }
+    static void CountDecode(uint64_t bytes) {
+        ProfileCounters* counters = Current();
+        if (nullptr != counters) {
+            counters->decode_bytes += bytes;
+        }
+    }
+
+    /// \brief Count into `counters` during the lifetime of the guard, nothing
+    /// changes if `counters` is null
+    ///
+    /// The guard must be destroyed in the same thread or coroutine it is
+    /// created in.
+    class Guard {
+     public:
+        explicit Guard(ProfileCounters* counters)
+            : counters_(counters), prev_(nullptr) {
+            if (nullptr != counters_) {
+                prev_ = Current();
+                active_.fetch_add(1, std::memory_order_relaxed);
+                SetCurrent(counters_);
+            }
+        }
+        ~Guard() {
+            if (nullptr != counters_) {
+                SetCurrent(prev_);
+                active_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+     private:
+        ProfileCounters* const counters_;
+        ProfileCounters* prev_;
+    };
+
+ private:
+    static ProfileCounters* Current() {
+        if (0 == active_.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return nullptr == get_slot_ ? tls_counters_ : get_slot_();
+    }
+    static void SetCurrent(ProfileCounters* counters) {
+        if (nullptr == set_slot_) {
+            tls_counters_ = counters;
+        } else {
+            set_slot_(counters);
+        }
+    }
+
+    // number of guards alive in all threads
+    inline static std::atomic<int32_t> active_{0};
+    inline static GetSlotFn get_slot_ = nullptr;
+    inline static SetSlotFn set_slot_ = nullptr;
+    inline static thread_local ProfileCounters* tls_counters_ = nullptr;
+};
+
+/// \brief Execution statistics of a runner.
+///
+/// Time and counters exclude the producers of the runner. Rows are -1 if the
+/// data handler is evaluated lazily and can not be counted without running it.
+struct RunnerProfile {
+    int32_t id = -1;
+    std::string type;
+    std::vector<int32_t> producers;
+    uint64_t run_cnt = 0;
+    uint64_t time_ns = 0;
+    int64_t rows_in = 0;
+    int64_t rows_out = 0;
+    ProfileCounters counters;
+};
+
+/// \brief Per-runner profile of a query run, like the output of `EXPLAIN ANALYZE`.
+class RunProfile {
+ public:
+    /// Return the profile of runner `id`, create it if not exist
+    RunnerProfile* GetRunner(int32_t id) { return &runners_[id]; }
+    const std::map<int32_t, RunnerProfile>& GetRunners() const { return runners_; }
+
+    /// Set the root runner, the runner tree is printed from it
+    void SetRoot(int32_t id) { root_ = id; }
+    int32_t GetRoot() const { return root_; }
+
+    /// Wall time and counters of the whole run, including the rows pulled
+    /// from lazy data handlers after the runners return. The storage counts
+    /// into `MutableTotalCounters` under a `Profiler::Guard` of the run
+    void SetTotalTime(uint64_t time_ns) { total_time_ns_ = time_ns; }
+    uint64_t GetTotalTime() const { return total_time_ns_; }
+    ProfileCounters* MutableTotalCounters() { return &total_counters_; }
+    const ProfileCounters& GetTotalCounters() const { return total_counters_; }
+
+    void Print(std::ostream& output) const;
+    std::string ToString() const;
+
+ private:
+    void PrintRunner(std::ostream& output, int32_t id, const std::string& tab,
+                     std::vector<int32_t>* visited) const;
+
+    std::map<int32_t, RunnerProfile> runners_;
+    int32_t root_ = -1;
+    uint64_t total_time_ns_ = 0;
+    ProfileCounters total_counters_;
+};
+
+}  // namespace vm
+}  // namespace hybridse
+#endif  // HYBRIDSE_INCLUDE_VM_PROFILE_H_
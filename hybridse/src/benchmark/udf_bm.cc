@@ -33,6 +33,20 @@ static void BM_RequestUnionSumColDouble(benchmark::State& state) {  // NOLINT
     SumRequestUnionTableCol(&state, BENCHMARK, state.range(0), "col4");
 }
 
+static void BM_MemVectorizedSumColInt(benchmark::State& state) {  // NOLINT
+    VectorizedSumMemTableCol(&state, BENCHMARK, state.range(0), "col1");
+}
+
+static void BM_MemVectorizedSumColDouble(benchmark::State& state) {  // NOLINT
+    VectorizedSumMemTableCol(&state, BENCHMARK, state.range(0), "col4");
+}
+
+static void BM_RequestUnionVectorizedSumColDouble(
+    benchmark::State& state) {  // NOLINT
+    VectorizedSumRequestUnionTableCol(&state, BENCHMARK, state.range(0),
+                                      "col4");
+}
+
 static void BM_ArraySumColInt(benchmark::State& state) {  // NOLINT
     SumArrayListCol(&state, BENCHMARK, state.range(0), "col1");
 }
@@ -140,6 +154,21 @@ BENCHMARK(BM_MemSumColDouble)
     ->Args({100})
     ->Args({1000})
     ->Args({10000});
+BENCHMARK(BM_MemVectorizedSumColInt)
+    ->Args({10})
+    ->Args({100})
+    ->Args({1000})
+    ->Args({10000});
+BENCHMARK(BM_MemVectorizedSumColDouble)
+    ->Args({10})
+    ->Args({100})
+    ->Args({1000})
+    ->Args({10000});
+BENCHMARK(BM_RequestUnionVectorizedSumColDouble)
+    ->Args({10})
+    ->Args({100})
+    ->Args({1000})
+    ->Args({10000});
 BENCHMARK(BM_Day)->Args({1})->Args({10})->Args({100})->Args({1000})->Args(
     {10000});
 BENCHMARK(BM_Month)->Args({1})->Args({10})->Args({100})->Args({1000})->Args(
@@ -25,6 +25,7 @@
 #include "codegen/window_ir_builder.h"
 #include "gtest/gtest.h"
 #include "udf/udf.h"
+#include "udf/udf_library.h"
 #include "udf/udf_test.h"
 #include "vm/jit_runtime.h"
 #include "vm/mem_catalog.h"
@@ -148,8 +149,8 @@ int32_t RunCopyToTimeTable(MemTimeTableHandler& segment,  // NOLINT
 }
 
 template <typename V>
-auto CreateSumFunc() {
-    return udf::UdfFunctionBuilder("sum")
+auto CreateSumFunc(const std::string& fn_name = "sum") {
+    return udf::UdfFunctionBuilder(fn_name)
         .args<codec::ListRef<V>>()
         .template returns<V>()
         .build();
@@ -280,7 +281,8 @@ void SumArrayListCol(benchmark::State* state, MODE mode, int64_t data_size,
 }
 
 void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
-                   int64_t data_size, const std::string& col_name) {
+                   int64_t data_size, const std::string& col_name,
+                   const std::string& fn_name = "sum") {
     vm::SchemasContext schemas_context;
     schemas_context.BuildTrivial(window->GetDatabase(), {window->GetSchema()});
     codegen::MemoryWindowDecodeIRBuilder builder(&schemas_context, nullptr);
@@ -312,7 +314,7 @@ void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
             case BENCHMARK: {
                 switch (type.base_) {
                     case node::kInt32: {
-                        auto sum = CreateSumFunc<int32_t>();
+                        auto sum = CreateSumFunc<int32_t>(fn_name);
                         ::hybridse::codec::ListRef<int32_t> list_ref({buf});
                         for (auto _ : *state) {
                             benchmark::DoNotOptimize(sum(list_ref));
@@ -320,7 +322,7 @@ void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
                         break;
                     }
                     case node::kInt64: {
-                        auto sum = CreateSumFunc<int64_t>();
+                        auto sum = CreateSumFunc<int64_t>(fn_name);
                         ::hybridse::codec::ListRef<int64_t> list_ref({buf});
                         for (auto _ : *state) {
                             benchmark::DoNotOptimize(sum(list_ref));
@@ -328,7 +330,7 @@ void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
                         break;
                     }
                     case node::kDouble: {
-                        auto sum = CreateSumFunc<double>();
+                        auto sum = CreateSumFunc<double>(fn_name);
                         ::hybridse::codec::ListRef<double> list_ref({buf});
                         for (auto _ : *state) {
                             benchmark::DoNotOptimize(sum(list_ref));
@@ -336,7 +338,7 @@ void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
                         break;
                     }
                     case node::kFloat: {
-                        auto sum = CreateSumFunc<float>();
+                        auto sum = CreateSumFunc<float>(fn_name);
                         ::hybridse::codec::ListRef<float> list_ref({buf});
                         for (auto _ : *state) {
                             benchmark::DoNotOptimize(sum(list_ref));
@@ -351,7 +353,7 @@ void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
             case TEST: {
                 switch (type.base_) {
                     case node::kInt32: {
-                        auto sum = CreateSumFunc<int32_t>();
+                        auto sum = CreateSumFunc<int32_t>(fn_name);
                         ::hybridse::codec::ListRef<int32_t> list_ref({buf});
                         if (sum(list_ref) <= 0) {
                             FAIL();
@@ -359,7 +361,7 @@ void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
                         break;
                     }
                     case node::kInt64: {
-                        auto sum = CreateSumFunc<int64_t>();
+                        auto sum = CreateSumFunc<int64_t>(fn_name);
                         ::hybridse::codec::ListRef<int64_t> list_ref({buf});
                         if (sum(list_ref) <= 0) {
                             FAIL();
@@ -367,7 +369,7 @@ void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
                         break;
                     }
                     case node::kDouble: {
-                        auto sum = CreateSumFunc<double>();
+                        auto sum = CreateSumFunc<double>(fn_name);
                         ::hybridse::codec::ListRef<double> list_ref({buf});
                         if (sum(list_ref) <= 0) {
                             FAIL();
@@ -375,7 +377,7 @@ void DoSumTableCol(vm::TableHandler* window, benchmark::State* state, MODE mode,
                         break;
                     }
                     case node::kFloat: {
-                        auto sum = CreateSumFunc<float>();
+                        auto sum = CreateSumFunc<float>(fn_name);
                         ::hybridse::codec::ListRef<float> list_ref({buf});
                         if (sum(list_ref) <= 0) {
                             FAIL();
@@ -417,6 +419,35 @@ void SumRequestUnionTableCol(benchmark::State* state, MODE mode,
     DoSumTableCol(request_union.get(), state, mode, data_size, col_name);
 }
 
+void VectorizedSumMemTableCol(benchmark::State* state, MODE mode,
+                              int64_t data_size, const std::string& col_name) {
+    type::TableDef table_def;
+    std::vector<Row> buffer;
+    CaseDataMock::BuildOnePkTableData(table_def, buffer, data_size);
+    vm::MemTableHandler window(&table_def.columns());
+    for (int i = 0; i < data_size - 1; ++i) {
+        window.AddRow(buffer[i]);
+    }
+    DoSumTableCol(&window, state, mode, data_size, col_name,
+                  udf::UdfLibrary::GetVectorizedUdafName("sum"));
+}
+
+void VectorizedSumRequestUnionTableCol(benchmark::State* state, MODE mode,
+                                       int64_t data_size,
+                                       const std::string& col_name) {
+    type::TableDef table_def;
+    std::vector<Row> buffer;
+    CaseDataMock::BuildOnePkTableData(table_def, buffer, data_size);
+    auto window = std::make_shared<vm::MemTableHandler>(&table_def.columns());
+    for (int i = 0; i < data_size - 1; ++i) {
+        window->AddRow(buffer[i]);
+    }
+    auto request_union = std::make_shared<vm::RequestUnionTableHandler>(
+        1, buffer[data_size - 1], window);
+    DoSumTableCol(request_union.get(), state, mode, data_size, col_name,
+                  udf::UdfLibrary::GetVectorizedUdafName("sum"));
+}
+
 bool CTimeDays(int data_size) {
     for (int i = 0; i < data_size; i++) {
         udf::v1::dayofmonth(1590115420000L + ((i)) * 86400000);
@@ -26,6 +26,11 @@ void SumMemTableCol(benchmark::State* state, MODE mode, int64_t data_size,
                     const std::string& col_name);
 void SumRequestUnionTableCol(benchmark::State* state, MODE mode,
                              int64_t data_size, const std::string& col_name);
+void VectorizedSumMemTableCol(benchmark::State* state, MODE mode,
+                              int64_t data_size, const std::string& col_name);
+void VectorizedSumRequestUnionTableCol(benchmark::State* state, MODE mode,
+                                       int64_t data_size,
+                                       const std::string& col_name);
 void SumArrayListCol(benchmark::State* state, MODE mode, int64_t data_size,
                      const std::string& col_name);
 void CopyMemTable(benchmark::State* state, MODE mode, int64_t data_size);
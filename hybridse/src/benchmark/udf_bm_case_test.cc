@@ -45,6 +45,20 @@ TEST_F(UdfBMCaseTest, SumRequestUnionTableCol1_TEST) {
     SumRequestUnionTableCol(nullptr, TEST, 10000L, "col1");
 }
 
+TEST_F(UdfBMCaseTest, VectorizedSumMemTableCol1_TEST) {
+    VectorizedSumMemTableCol(nullptr, TEST, 10L, "col1");
+    VectorizedSumMemTableCol(nullptr, TEST, 100L, "col1");
+    VectorizedSumMemTableCol(nullptr, TEST, 1000L, "col1");
+    VectorizedSumMemTableCol(nullptr, TEST, 10000L, "col1");
+}
+
+TEST_F(UdfBMCaseTest, VectorizedSumRequestUnionTableCol1_TEST) {
+    VectorizedSumRequestUnionTableCol(nullptr, TEST, 10L, "col1");
+    VectorizedSumRequestUnionTableCol(nullptr, TEST, 100L, "col1");
+    VectorizedSumRequestUnionTableCol(nullptr, TEST, 1000L, "col1");
+    VectorizedSumRequestUnionTableCol(nullptr, TEST, 10000L, "col1");
+}
+
 TEST_F(UdfBMCaseTest, CopyMemSegment_TEST) {
     CopyMemSegment(nullptr, TEST, 10L);
     CopyMemSegment(nullptr, TEST, 100L);
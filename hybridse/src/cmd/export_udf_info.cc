@@ -16,6 +16,7 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include "absl/strings/match.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "yaml-cpp/yaml.h"
@@ -118,6 +119,10 @@ int ExportUdfInfo(const std::string& dir, const std::string& filename) {
     yaml_out << YAML::BeginMap;
     for (auto& pair : registries) {
         std::string name = pair.first;
+        // vectorized udaf implementations are internal, not sql functions
+        if (absl::EndsWith(name, udf::UdfLibrary::GetVectorizedUdafName(""))) {
+            continue;
+        }
         auto signature_table = pair.second->signature_table.GetTable();
 
         yaml_out << YAML::Key << name;
@@ -519,6 +519,10 @@ SqlNode *NodeManager::MakeColumnIndexNode(SqlNodeList *index_item_list) {
                     index_ptr->set_ttl_type(ttl_type_node->ttl_type());
                     break;
                 }
+                case kIndexKeyEncoding: {
+                    index_ptr->set_key_encoding(dynamic_cast<IndexKeyEncodingNode *>(node_ptr)->key_encoding());
+                    break;
+                }
                 default: {
                     LOG(WARNING) << "can not handle type " << NameOfSqlNodeType(node_ptr->GetType())
                                  << " for column index";
@@ -720,6 +724,10 @@ SqlNode *NodeManager::MakeIndexTTLTypeNode(const std::string &ttl_type) {
     SqlNode *node_ptr = new IndexTTLTypeNode(ttl_type);
     return RegisterNode(node_ptr);
 }
+SqlNode *NodeManager::MakeIndexKeyEncodingNode(const std::string &key_encoding) {
+    SqlNode *node_ptr = new IndexKeyEncodingNode(key_encoding);
+    return RegisterNode(node_ptr);
+}
 SqlNode *NodeManager::MakeIndexVersionNode(const std::string &version) {
     SqlNode *node_ptr = new IndexVersionNode(version);
     return RegisterNode(node_ptr);
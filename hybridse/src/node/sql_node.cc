@@ -1074,6 +1074,9 @@ std::string NameOfSqlNodeType(const SqlNodeType &type) {
         case kIndexTTLType:
             output = "kIndexTTLType";
             break;
+        case kIndexKeyEncoding:
+            output = "kIndexKeyEncoding";
+            break;
         case kIndexTTL:
             output = "kIndexTTL";
             break;
@@ -1365,6 +1368,10 @@ void ColumnIndexNode::Print(std::ostream &output, const std::string &org_tab) co
     output << "\n";
     PrintValue(output, tab, ttl_type_, "ttl_type", false);
     output << "\n";
+    if (!key_encoding_.empty()) {
+        PrintValue(output, tab, key_encoding_, "key_encoding", false);
+        output << "\n";
+    }
     PrintValue(output, tab, version_, "version_column", false);
     output << "\n";
     PrintValue(output, tab, std::to_string(version_count_), "version_count", true);
@@ -56,7 +56,10 @@ Status LambdafyProjects::Transform(
                     require_agg_vec->push_back(false);
                 }
             }
-        } else if (legacy_agg_opt_ && FallBackToLegacyAgg(origin_expr)) {
+        } else if (legacy_agg_opt_ && FallBackToLegacyAgg(origin_expr) &&
+                   !ResolveVectorizedAgg(origin_expr, nullptr)) {
+            // the vectorized implementation is preferred to the legacy agg
+            // builder for the aggregates it supports
             auto expr = origin_expr->DeepCopy(nm);
             CHECK_TRUE(expr != nullptr, kCodegenError);
             out_list->AddChild(expr);
@@ -100,6 +103,15 @@ Status LambdafyProjects::VisitExpr(node::ExprNode* expr,
                     return Status::OK();
                 }
             } else if (library->IsUdaf(fn->function_name(), child_num)) {
+                std::string vectorized_name;
+                if (ResolveVectorizedAgg(call, &vectorized_name)) {
+                    // column ref is kept as is, thus resolved to the window
+                    // column list
+                    *out = ctx_->node_manager()->MakeFuncNode(
+                        vectorized_name, {call->GetChild(0)}, nullptr);
+                    *has_agg = true;
+                    return base::Status::OK();
+                }
                 CHECK_STATUS(VisitAggExpr(call, row_arg, window_arg, out, has_agg));
                 return base::Status::OK();
             }
@@ -445,5 +457,60 @@ bool LambdafyProjects::FallBackToLegacyAgg(const node::ExprNode* expr) {
     return true;
 }
 
+bool LambdafyProjects::ResolveVectorizedAgg(const node::ExprNode* expr,
+                                            std::string* vectorized_name) {
+    if (expr->GetExprType() != node::kExprCall) {
+        return false;
+    }
+    auto call = dynamic_cast<const node::CallExprNode*>(expr);
+    auto fn = dynamic_cast<const node::ExternalFnDefNode*>(call->GetFnDef());
+    if (fn == nullptr || call->GetChildNum() != 1) {
+        return false;
+    }
+    auto input_expr = call->GetChild(0);
+    if (input_expr->GetExprType() != node::kExprColumnRef) {
+        return false;
+    }
+    auto col = dynamic_cast<const node::ColumnRefNode*>(input_expr);
+    size_t schema_idx;
+    size_t col_idx;
+    auto schemas_ctx = ctx_->schemas_context();
+    if (!schemas_ctx->ResolveColumnRefIndex(col, &schema_idx, &col_idx)
+             .isOK()) {
+        return false;
+    }
+    node::DataType elem_type;
+    switch (schemas_ctx->GetSchema(schema_idx)->Get(col_idx).type()) {
+        case hybridse::type::kInt16:
+            elem_type = node::kInt16;
+            break;
+        case hybridse::type::kInt32:
+            elem_type = node::kInt32;
+            break;
+        case hybridse::type::kInt64:
+            elem_type = node::kInt64;
+            break;
+        case hybridse::type::kFloat:
+            elem_type = node::kFloat;
+            break;
+        case hybridse::type::kDouble:
+            elem_type = node::kDouble;
+            break;
+        default:
+            return false;
+    }
+    auto nm = ctx_->node_manager();
+    auto name = udf::UdfLibrary::GetVectorizedUdafName(fn->function_name());
+    auto list_type =
+        nm->MakeTypeNode(node::kList, nm->MakeTypeNode(elem_type));
+    if (ctx_->library()->Find(name, {list_type}) == nullptr) {
+        return false;
+    }
+    if (vectorized_name != nullptr) {
+        *vectorized_name = name;
+    }
+    return true;
+}
+
 }  // namespace passes
 }  // namespace hybridse
@@ -82,6 +82,12 @@ class LambdafyProjects {
 
     // to make compatible with legacy agg builder
     bool FallBackToLegacyAgg(const node::ExprNode* expr);
+
+    // whether `expr` is a udaf over a single numeric column with a
+    // vectorized implementation registered in library, whose name is
+    // returned in `vectorized_name` if not null
+    bool ResolveVectorizedAgg(const node::ExprNode* expr,
+                              std::string* vectorized_name);
     bool legacy_agg_opt_;
     std::unordered_set<std::string> agg_opt_fn_names_ = {"sum", "min", "max",
                                                          "count", "avg"};
@@ -83,6 +83,74 @@ TEST_F(LambdafyProjectsTest, Test) {
     lambda->Print(std::cerr, "");
 }
 
+TEST_F(LambdafyProjectsTest, VectorizedAggPreferredToLegacyAgg) {
+    auto schema = udf::MakeLiteralSchema<int32_t, float, double>();
+    vm::SchemasContext schemas_ctx;
+    schemas_ctx.BuildTrivial({&schema});
+
+    Status status;
+    node::NodeManager nm;
+
+    const std::string sql =
+        "select "
+        "    sum(col_0), "
+        "    max(col_2), "
+        "    sum(col_0 + 1), "
+        "    count_where(col_1, col_2 > 2) "
+        "from t1 group by col_0, col_1, col_2;";
+    node::PlanNodeList trees;
+    ASSERT_TRUE(plan::PlanAPI::CreatePlanTreeFromScript(sql, trees, &nm, status)) << status;
+    ASSERT_EQ(1u, trees.size());
+    auto query_plan = dynamic_cast<node::QueryPlanNode *>(trees[0]);
+    ASSERT_TRUE(query_plan != nullptr);
+    auto project_plan =
+        dynamic_cast<node::ProjectPlanNode *>(query_plan->GetChildren()[0]);
+    ASSERT_TRUE(project_plan != nullptr);
+    auto project_list_node = dynamic_cast<node::ProjectListNode *>(
+        project_plan->project_list_vec_[0]);
+    ASSERT_TRUE(project_list_node != nullptr);
+    std::vector<const node::ExprNode *> exprs;
+    for (auto plan_node : project_list_node->GetProjects()) {
+        auto pp_node = dynamic_cast<node::ProjectNode *>(plan_node);
+        exprs.push_back(pp_node->GetExpression());
+    }
+
+    auto lib = udf::DefaultUdfLibrary::get();
+    node::ExprAnalysisContext ctx(&nm, lib, &schemas_ctx, nullptr);
+    // with the legacy agg builder enabled, as the physical plan does
+    LambdafyProjects transformer(&ctx, true);
+    std::vector<int> is_agg_vec;
+    node::LambdaNode *lambda;
+    status = transformer.Transform(exprs, &lambda, &is_agg_vec);
+    ASSERT_TRUE(status.isOK()) << status;
+    ASSERT_EQ(std::vector<int>({1, 1, 1, 1}), is_agg_vec);
+
+    // aggregates over a single numeric column go to the vectorized ones,
+    // the others keep the generic udaf path
+    std::vector<std::string> expect_fn = {"sum.vectorized", "max.vectorized",
+                                          "", ""};
+    auto body = lambda->body();
+    ASSERT_EQ(expect_fn.size(), body->GetChildNum());
+    for (size_t i = 0; i < expect_fn.size(); ++i) {
+        std::string fn_name;
+        auto call = dynamic_cast<node::CallExprNode *>(body->GetChild(i));
+        if (call != nullptr) {
+            auto fn = dynamic_cast<const node::ExternalFnDefNode *>(
+                call->GetFnDef());
+            if (fn != nullptr) {
+                fn_name = fn->function_name();
+            }
+        }
+        if (expect_fn[i].empty()) {
+            ASSERT_EQ(std::string::npos, fn_name.find(".vectorized"))
+                << body->GetChild(i)->GetExprString();
+        } else {
+            ASSERT_EQ(expect_fn[i], fn_name)
+                << body->GetChild(i)->GetExprString();
+        }
+    }
+}
+
 }  // namespace passes
 }  // namespace hybridse
 
@@ -529,7 +529,9 @@ bool GroupAndSortOptimized::TransformKeysAndOrderExpr(const SchemasContext* root
 
     std::vector<bool> match_bitmap;
     std::vector<bool> state_bitmap(columns.size(), true);
-    if (!MatchBestIndex(columns, order_columns, table_handler, &state_bitmap, index_name, &match_bitmap)) {
+    IndexCostModel cost_model(table_handler);
+    if (!MatchBestIndex(columns, order_columns, table_handler, &state_bitmap, index_name, &match_bitmap,
+                        &cost_model)) {
         return false;
     }
     if (match_bitmap.size() != columns.size()) {
@@ -550,7 +552,8 @@ bool GroupAndSortOptimized::MatchBestIndex(
     const std::vector<std::string>& columns,
     const std::vector<std::string>& order_columns,
     std::shared_ptr<TableHandler> table_handler, std::vector<bool>* bitmap_ptr,
-    std::string* index_name, std::vector<bool>* index_bitmap) {
+    std::string* index_name, std::vector<bool>* index_bitmap,
+    IndexCostModel* cost_model) {
     if (nullptr == bitmap_ptr || nullptr == index_name) {
         LOG(WARNING)
             << "fail to match best index: bitmap or index_name ptr is null";
@@ -582,6 +585,8 @@ bool GroupAndSortOptimized::MatchBestIndex(
     }
     // Go through the all indexs to find out index meet the requirements.
     // Notice: only deal with index specific by given index name when (*index_name) is non-emtpy
+    // Prefer the cheapest one according to the cost model if several indexes match
+    std::string matched_index_name;
     for (auto iter = index_hint.cbegin(); iter != index_hint.cend(); iter++) {
         IndexSt index = iter->second;
 
@@ -605,11 +610,17 @@ bool GroupAndSortOptimized::MatchBestIndex(
             keys.insert(key_iter->name);
         }
         if (column_set == keys) {
-            *index_name = index.name;
-            *index_bitmap = bitmap;
-            return true;
+            if (matched_index_name.empty() ||
+                cost_model->Compare(index.name, matched_index_name) < 0) {
+                matched_index_name = index.name;
+            }
         }
     }
+    if (!matched_index_name.empty()) {
+        *index_name = matched_index_name;
+        *index_bitmap = bitmap;
+        return true;
+    }
 
     std::string best_index_name;
     std::vector<bool> best_index_bitmap;
@@ -621,15 +632,21 @@ bool GroupAndSortOptimized::MatchBestIndex(
             std::string name;
             std::vector<bool> sub_best_bitmap;
             if (MatchBestIndex(columns, order_columns, table_handler,
-                               bitmap_ptr, &name, &sub_best_bitmap)) {
+                               bitmap_ptr, &name, &sub_best_bitmap,
+                               cost_model)) {
                 succ = true;
                 if (best_index_name.empty()) {
                     best_index_name = name;
                     best_index_bitmap = sub_best_bitmap;
                 } else {
+                    // Choose the index scanning less rows per lookup, and
+                    // the one with more keys when the cost is unknown
                     auto org_index = index_hint.at(best_index_name);
                     auto new_index = index_hint.at(name);
-                    if (org_index.keys.size() < new_index.keys.size()) {
+                    int cost = cost_model->Compare(name, best_index_name);
+                    if (cost < 0 ||
+                        (0 == cost &&
+                         org_index.keys.size() < new_index.keys.size())) {
                         best_index_name = name;
                         best_index_bitmap = sub_best_bitmap;
                     }
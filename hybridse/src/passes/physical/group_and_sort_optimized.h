@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include "passes/physical/index_cost_model.h"
 #include "passes/physical/transform_up_physical_pass.h"
 
 namespace hybridse {
@@ -90,7 +91,8 @@ class GroupAndSortOptimized : public TransformUpPysicalPass {
                         const std::vector<std::string>& order_columns,
                         std::shared_ptr<TableHandler> table_handler,
                         std::vector<bool>* bitmap, std::string* index_name,
-                        std::vector<bool>* best_bitmap);  // NOLINT
+                        std::vector<bool>* best_bitmap,
+                        IndexCostModel* cost_model);  // NOLINT
 };
 }  // namespace passes
 }  // namespace hybridse
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2021 4paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "passes/physical/index_cost_model.h"
+
+#include <utility>
+
+namespace hybridse {
+namespace passes {
+
+// costs within this ratio are regarded as equal
+static const double kCostTolerance = 1.2;
+
+double IndexCostModel::EstimateScanRows(const IndexStatistics& stats) {
+    double weighted = 0;
+    double total = 0;
+    for (size_t i = 0; i < stats.key_histogram.size(); i++) {
+        // take the middle of bucket [2^i, 2^(i+1)) as rows of its keys
+        double rows = 1.5 * static_cast<double>(1ull << i);
+        double keys = static_cast<double>(stats.key_histogram[i]);
+        weighted += keys * rows * rows;
+        total += keys * rows;
+    }
+    if (total > 0) {
+        return weighted / total;
+    }
+    if (stats.key_cnt > 0) {
+        return static_cast<double>(stats.row_cnt) / stats.key_cnt;
+    }
+    return -1;
+}
+
+double IndexCostModel::EstimateScanRows(const std::string& index_name) {
+    auto iter = cache_.find(index_name);
+    if (iter != cache_.end()) {
+        return iter->second;
+    }
+    double rows = -1;
+    IndexStatistics stats;
+    if (table_handler_ &&
+        table_handler_->GetIndexStatistics(index_name, &stats)) {
+        rows = EstimateScanRows(stats);
+    }
+    cache_.insert(std::make_pair(index_name, rows));
+    return rows;
+}
+
+int IndexCostModel::Compare(const std::string& lhs, const std::string& rhs) {
+    double lhs_rows = EstimateScanRows(lhs);
+    double rhs_rows = EstimateScanRows(rhs);
+    if (lhs_rows < 0 || rhs_rows < 0) {
+        return 0;
+    }
+    if (lhs_rows * kCostTolerance < rhs_rows) {
+        return -1;
+    }
+    if (rhs_rows * kCostTolerance < lhs_rows) {
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace passes
+}  // namespace hybridse
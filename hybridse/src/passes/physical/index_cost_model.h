@@ -0,0 +1,61 @@
+/*
+ * Copyright 2021 4paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HYBRIDSE_SRC_PASSES_PHYSICAL_INDEX_COST_MODEL_H_
+#define HYBRIDSE_SRC_PASSES_PHYSICAL_INDEX_COST_MODEL_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include "vm/catalog.h"
+
+namespace hybridse {
+namespace passes {
+
+using hybridse::vm::IndexStatistics;
+using hybridse::vm::TableHandler;
+
+/**
+ * Estimate the cost of looking up a table by its indexes, based on the
+ * statistics provided by `TableHandler::GetIndexStatistics`.
+ *
+ * The cost of an index is the expected number of rows scanned for one
+ * lookup. Keys are looked up about as often as they are written, so the
+ * expectation is weighted by rows per key: sum(n_k^2) / sum(n_k) over the
+ * sampled keys, falling back to the mean rows per key without samples.
+ */
+class IndexCostModel {
+ public:
+    explicit IndexCostModel(std::shared_ptr<TableHandler> table_handler)
+        : table_handler_(table_handler) {}
+
+    /// Return the estimated rows scanned for one lookup on the index, or
+    /// a negative value if the index has no statistics
+    double EstimateScanRows(const std::string& index_name);
+
+    /// Return -1 if index `lhs` is cheaper than `rhs`, 1 if it is more
+    /// expensive and 0 if they are not comparable
+    int Compare(const std::string& lhs, const std::string& rhs);
+
+    static double EstimateScanRows(const IndexStatistics& stats);
+
+ private:
+    std::shared_ptr<TableHandler> table_handler_;
+    std::map<std::string, double> cache_;
+};
+
+}  // namespace passes
+}  // namespace hybridse
+#endif  // HYBRIDSE_SRC_PASSES_PHYSICAL_INDEX_COST_MODEL_H_
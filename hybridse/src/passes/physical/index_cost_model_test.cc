@@ -0,0 +1,97 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "passes/physical/index_cost_model.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "vm/mem_catalog.h"
+
+namespace hybridse {
+namespace passes {
+
+class StatsTableHandler : public vm::MemTableHandler {
+ public:
+    bool GetIndexStatistics(const std::string& index_name,
+                            IndexStatistics* stats) override {
+        auto iter = stats_.find(index_name);
+        if (iter == stats_.end()) {
+            return false;
+        }
+        *stats = iter->second;
+        return true;
+    }
+    std::map<std::string, IndexStatistics> stats_;
+};
+
+class IndexCostModelTest : public ::testing::Test {};
+
+TEST_F(IndexCostModelTest, EstimateScanRowsTest) {
+    IndexStatistics stats;
+    ASSERT_LT(IndexCostModel::EstimateScanRows(stats), 0);
+
+    stats.key_cnt = 10;
+    stats.row_cnt = 50;
+    ASSERT_DOUBLE_EQ(5.0, IndexCostModel::EstimateScanRows(stats));
+
+    // keys holding 1 row: bucket 0
+    stats.AddSampledKey(1);
+    ASSERT_DOUBLE_EQ(1.5, IndexCostModel::EstimateScanRows(stats));
+    // a hot key dominates the expected rows of a lookup
+    stats.AddSampledKey(1000);
+    ASSERT_EQ(10u, stats.key_histogram.size());
+    ASSERT_EQ(1u, stats.key_histogram[9]);
+    ASSERT_GT(IndexCostModel::EstimateScanRows(stats), 700.0);
+    stats.AddSampledKey(0);
+    ASSERT_EQ(10u, stats.key_histogram.size());
+}
+
+TEST_F(IndexCostModelTest, CompareTest) {
+    auto table = std::make_shared<StatsTableHandler>();
+    IndexStatistics low_selectivity;
+    low_selectivity.key_cnt = 2;
+    low_selectivity.row_cnt = 10000;
+    IndexStatistics high_selectivity;
+    high_selectivity.key_cnt = 5000;
+    high_selectivity.row_cnt = 10000;
+    IndexStatistics similar;
+    similar.key_cnt = 4500;
+    similar.row_cnt = 10000;
+    table->stats_["index1"] = low_selectivity;
+    table->stats_["index2"] = high_selectivity;
+    table->stats_["index3"] = similar;
+
+    IndexCostModel cost_model(table);
+    ASSERT_EQ(1, cost_model.Compare("index1", "index2"));
+    ASSERT_EQ(-1, cost_model.Compare("index2", "index1"));
+    ASSERT_EQ(0, cost_model.Compare("index2", "index3"));
+    // unknown index is not comparable
+    ASSERT_EQ(0, cost_model.Compare("index1", "index_not_exist"));
+
+    IndexCostModel no_stats(std::make_shared<vm::MemTableHandler>());
+    ASSERT_EQ(0, no_stats.Compare("index1", "index2"));
+}
+
+}  // namespace passes
+}  // namespace hybridse
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2021 4paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "passes/physical/range_filter_optimized.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "passes/physical/condition_optimized.h"
+
+namespace hybridse {
+namespace passes {
+
+using hybridse::vm::DataProviderType;
+using hybridse::vm::PhysicalDataProviderNode;
+using hybridse::vm::PhysicalFilterNode;
+using hybridse::vm::PhysicalOpType;
+
+static void AddBound(const node::ColumnRefNode* column,
+                     const node::ConstNode* value, bool is_lower,
+                     bool inclusive,
+                     std::vector<RangeFilterOptimized::ColumnBounds>* bounds) {
+    RangeFilterOptimized::ColumnBounds* column_bounds = nullptr;
+    for (auto& cur : *bounds) {
+        if (cur.column->Equals(column)) {
+            column_bounds = &cur;
+            break;
+        }
+    }
+    if (nullptr == column_bounds) {
+        bounds->emplace_back();
+        column_bounds = &bounds->back();
+        column_bounds->column = column;
+    }
+    if (is_lower && nullptr == column_bounds->lower) {
+        column_bounds->lower = value;
+        column_bounds->lower_inclusive = inclusive;
+    } else if (!is_lower && nullptr == column_bounds->upper) {
+        column_bounds->upper = value;
+        column_bounds->upper_inclusive = inclusive;
+    }
+}
+
+static const node::ConstNode* AsConst(const node::ExprNode* expr) {
+    if (nullptr == expr || node::kExprPrimary != expr->GetExprType()) {
+        return nullptr;
+    }
+    auto value = dynamic_cast<const node::ConstNode*>(expr);
+    return value->IsNull() ? nullptr : value;
+}
+
+static const node::ColumnRefNode* AsColumn(const node::ExprNode* expr) {
+    if (nullptr == expr || node::kExprColumnRef != expr->GetExprType()) {
+        return nullptr;
+    }
+    return dynamic_cast<const node::ColumnRefNode*>(expr);
+}
+
+void RangeFilterOptimized::ExtractColumnBounds(
+    const node::ExprNode* condition, std::vector<ColumnBounds>* bounds) {
+    node::ExprListNode and_conditions;
+    if (!ConditionOptimized::TransfromAndConditionList(condition,
+                                                       &and_conditions)) {
+        return;
+    }
+    for (auto expr : and_conditions.children_) {
+        if (node::kExprBetween == expr->GetExprType()) {
+            auto between = dynamic_cast<const node::BetweenExpr*>(expr);
+            auto column = AsColumn(between->GetLhs());
+            auto low = AsConst(between->GetLow());
+            auto high = AsConst(between->GetHigh());
+            if (between->is_not_between() || nullptr == column ||
+                nullptr == low || nullptr == high) {
+                continue;
+            }
+            AddBound(column, low, true, true, bounds);
+            AddBound(column, high, false, true, bounds);
+            continue;
+        }
+        if (node::kExprBinary != expr->GetExprType()) {
+            continue;
+        }
+        auto binary = dynamic_cast<const node::BinaryExpr*>(expr);
+        auto op = binary->GetOp();
+        if (node::kFnOpLt != op && node::kFnOpLe != op && node::kFnOpGt != op &&
+            node::kFnOpGe != op) {
+            continue;
+        }
+        auto column = AsColumn(binary->GetChild(0));
+        auto value = AsConst(binary->GetChild(1));
+        // `const op column` is the same as `column reversed(op) const`
+        bool reversed = false;
+        if (nullptr == column || nullptr == value) {
+            column = AsColumn(binary->GetChild(1));
+            value = AsConst(binary->GetChild(0));
+            reversed = true;
+        }
+        if (nullptr == column || nullptr == value) {
+            continue;
+        }
+        bool is_lower = (node::kFnOpGt == op || node::kFnOpGe == op) != reversed;
+        bool inclusive = node::kFnOpLe == op || node::kFnOpGe == op;
+        AddBound(column, value, is_lower, inclusive, bounds);
+    }
+}
+
+bool RangeFilterOptimized::MakeRangeBound(const node::ConstNode* value,
+                                          bool inclusive,
+                                          type::Type column_type,
+                                          RangeBound* bound) {
+    if (nullptr == value) {
+        bound->bounded = false;
+        return true;
+    }
+    bool is_integer = node::kInt16 == value->GetDataType() ||
+                      node::kInt32 == value->GetDataType() ||
+                      node::kInt64 == value->GetDataType();
+    bool is_number = is_integer || node::kFloat == value->GetDataType() ||
+                     node::kDouble == value->GetDataType();
+    switch (column_type) {
+        case type::kInt16:
+        case type::kInt32:
+        case type::kInt64:
+        case type::kTimestamp: {
+            if (!is_integer) {
+                return false;
+            }
+            bound->value = std::to_string(value->GetAsInt64());
+            break;
+        }
+        case type::kFloat:
+        case type::kDouble: {
+            if (!is_number) {
+                return false;
+            }
+            // the shortest text which reads back to the same double
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%.17g", value->GetAsDouble());
+            bound->value = buf;
+            break;
+        }
+        case type::kVarchar: {
+            if (node::kVarchar != value->GetDataType()) {
+                return false;
+            }
+            bound->value = value->GetStr();
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+    bound->bounded = true;
+    bound->inclusive = inclusive;
+    return true;
+}
+
+bool RangeFilterOptimized::Transform(PhysicalOpNode* in,
+                                     PhysicalOpNode** output) {
+    *output = in;
+    if (PhysicalOpType::kPhysicalOpFilter != in->GetOpType()) {
+        return false;
+    }
+    auto filter_op = dynamic_cast<PhysicalFilterNode*>(in);
+    auto producer = filter_op->GetProducer(0);
+    if (PhysicalOpType::kPhysicalOpDataProvider != producer->GetOpType()) {
+        return false;
+    }
+    auto scan_op = dynamic_cast<PhysicalDataProviderNode*>(producer);
+    if (DataProviderType::kProviderTypeTable != scan_op->provider_type_ ||
+        nullptr == filter_op->filter_.condition_.condition()) {
+        return false;
+    }
+    std::vector<ColumnBounds> bounds;
+    ExtractColumnBounds(filter_op->filter_.condition_.condition(), &bounds);
+
+    auto table_handler = scan_op->table_handler_;
+    const auto& types = table_handler->GetTypes();
+    ColumnRange best;
+    for (const auto& column_bounds : bounds) {
+        size_t column_id;
+        int path_idx;
+        size_t child_column_id;
+        size_t source_column_id;
+        const PhysicalOpNode* source = nullptr;
+        auto column = column_bounds.column;
+        Status status = scan_op->schemas_ctx()->ResolveColumnID(
+            column->GetDBName(), column->GetRelationName(),
+            column->GetColumnName(), &column_id, &path_idx, &child_column_id,
+            &source_column_id, &source);
+        if (!status.isOK() || source != scan_op) {
+            continue;
+        }
+        std::string column_name;
+        if (!scan_op->schemas_ctx()
+                 ->ResolveColumnNameByID(source_column_id, &column_name)
+                 .isOK()) {
+            continue;
+        }
+        auto iter = types.find(column_name);
+        if (iter == types.end() || !table_handler->HasRangeIndex(column_name)) {
+            continue;
+        }
+        ColumnRange range;
+        range.column = column_name;
+        if (!MakeRangeBound(column_bounds.lower, column_bounds.lower_inclusive,
+                            iter->second.type, &range.lower) ||
+            !MakeRangeBound(column_bounds.upper, column_bounds.upper_inclusive,
+                            iter->second.type, &range.upper) ||
+            !range.Valid()) {
+            continue;
+        }
+        // prefer the range bounded on both sides
+        if (!best.Valid() ||
+            (range.lower.bounded && range.upper.bounded &&
+             !(best.lower.bounded && best.upper.bounded))) {
+            best = range;
+        }
+    }
+    if (!best.Valid()) {
+        return false;
+    }
+    DLOG(INFO) << "scan filter input with range index: " << best.ToString();
+    filter_op->filter_.range_scan_ = best;
+    return true;
+}
+
+}  // namespace passes
+}  // namespace hybridse
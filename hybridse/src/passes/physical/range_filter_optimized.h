@@ -0,0 +1,67 @@
+/*
+ * Copyright 2021 4paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HYBRIDSE_SRC_PASSES_PHYSICAL_RANGE_FILTER_OPTIMIZED_H_
+#define HYBRIDSE_SRC_PASSES_PHYSICAL_RANGE_FILTER_OPTIMIZED_H_
+
+#include <vector>
+
+#include "passes/physical/transform_up_physical_pass.h"
+
+namespace hybridse {
+namespace passes {
+
+using hybridse::vm::ColumnRange;
+using hybridse::vm::RangeBound;
+
+/**
+ * Scan the rows of a filter on table with a range index if the condition
+ * compares an indexed column with constants, e.g.
+ *   `WHERE amount > 100`, `WHERE amount BETWEEN 100 AND 200`
+ * The condition is kept as it is and applied on the scanned rows.
+ */
+class RangeFilterOptimized : public TransformUpPysicalPass {
+ public:
+    explicit RangeFilterOptimized(PhysicalPlanContext* plan_ctx)
+        : TransformUpPysicalPass(plan_ctx) {}
+    ~RangeFilterOptimized() {}
+
+    // the constant bounds of a column in the condition
+    struct ColumnBounds {
+        const node::ColumnRefNode* column = nullptr;
+        const node::ConstNode* lower = nullptr;
+        bool lower_inclusive = false;
+        const node::ConstNode* upper = nullptr;
+        bool upper_inclusive = false;
+    };
+
+    // Collect the bounds of the columns compared with constants in the
+    // conjunctions of `condition`, the first bound found wins for each side
+    static void ExtractColumnBounds(const node::ExprNode* condition,
+                                    std::vector<ColumnBounds>* bounds);
+
+    // Make the bound of a column in type `column_type` from a constant.
+    // Return false if the constant can not be compared with the column in the
+    // order of the range index
+    static bool MakeRangeBound(const node::ConstNode* value, bool inclusive,
+                               type::Type column_type, RangeBound* bound);
+
+ private:
+    bool Transform(PhysicalOpNode* in, PhysicalOpNode** output);
+};
+}  // namespace passes
+}  // namespace hybridse
+
+#endif  // HYBRIDSE_SRC_PASSES_PHYSICAL_RANGE_FILTER_OPTIMIZED_H_
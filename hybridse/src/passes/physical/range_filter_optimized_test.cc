@@ -0,0 +1,120 @@
+/*
+ * Copyright 2021 4paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "passes/physical/range_filter_optimized.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "node/node_manager.h"
+
+namespace hybridse {
+namespace passes {
+
+class RangeFilterOptimizedTest : public ::testing::Test {};
+
+TEST_F(RangeFilterOptimizedTest, ExtractColumnBoundsTest) {
+    node::NodeManager nm;
+    auto amount = nm.MakeColumnRefNode("amount", "t1");
+    auto price = nm.MakeColumnRefNode("price", "t1");
+    auto name = nm.MakeColumnRefNode("name", "t1");
+    auto conditions = nm.MakeExprList();
+    // amount > 100 and 200 >= amount and amount < 10
+    conditions->AddChild(nm.MakeBinaryExprNode(
+        amount, nm.MakeConstNode(100), node::kFnOpGt));
+    conditions->AddChild(nm.MakeBinaryExprNode(
+        nm.MakeConstNode(200), amount, node::kFnOpGe));
+    conditions->AddChild(nm.MakeBinaryExprNode(amount, nm.MakeConstNode(10),
+                                               node::kFnOpLt));
+    // price between 1.5 and 2.5
+    conditions->AddChild(nm.MakeBetweenExpr(price, nm.MakeConstNode(1.5),
+                                            nm.MakeConstNode(2.5), false));
+    // name not between "a" and "b", name = "c" and name < price are skipped
+    conditions->AddChild(nm.MakeBetweenExpr(name, nm.MakeConstNode("a"),
+                                            nm.MakeConstNode("b"), true));
+    conditions->AddChild(
+        nm.MakeBinaryExprNode(name, nm.MakeConstNode("c"), node::kFnOpEq));
+    conditions->AddChild(nm.MakeBinaryExprNode(name, price, node::kFnOpLt));
+
+    std::vector<RangeFilterOptimized::ColumnBounds> bounds;
+    RangeFilterOptimized::ExtractColumnBounds(nm.MakeAndExpr(conditions),
+                                              &bounds);
+    ASSERT_EQ(2u, bounds.size());
+    ASSERT_EQ("amount", bounds[0].column->GetColumnName());
+    ASSERT_EQ(100, bounds[0].lower->GetInt());
+    ASSERT_FALSE(bounds[0].lower_inclusive);
+    ASSERT_EQ(200, bounds[0].upper->GetInt());
+    ASSERT_TRUE(bounds[0].upper_inclusive);
+    ASSERT_EQ("price", bounds[1].column->GetColumnName());
+    ASSERT_DOUBLE_EQ(1.5, bounds[1].lower->GetDouble());
+    ASSERT_TRUE(bounds[1].lower_inclusive);
+    ASSERT_DOUBLE_EQ(2.5, bounds[1].upper->GetDouble());
+    ASSERT_TRUE(bounds[1].upper_inclusive);
+
+    // single condition without AND
+    bounds.clear();
+    RangeFilterOptimized::ExtractColumnBounds(
+        nm.MakeBinaryExprNode(amount, nm.MakeConstNode(5), node::kFnOpLe),
+        &bounds);
+    ASSERT_EQ(1u, bounds.size());
+    ASSERT_EQ(nullptr, bounds[0].lower);
+    ASSERT_EQ(5, bounds[0].upper->GetInt());
+    ASSERT_TRUE(bounds[0].upper_inclusive);
+}
+
+TEST_F(RangeFilterOptimizedTest, MakeRangeBoundTest) {
+    node::NodeManager nm;
+    RangeBound bound;
+    ASSERT_TRUE(RangeFilterOptimized::MakeRangeBound(nullptr, true,
+                                                     type::kInt64, &bound));
+    ASSERT_FALSE(bound.bounded);
+
+    ASSERT_TRUE(RangeFilterOptimized::MakeRangeBound(
+        nm.MakeConstNode(-100), false, type::kInt64, &bound));
+    ASSERT_TRUE(bound.bounded);
+    ASSERT_FALSE(bound.inclusive);
+    ASSERT_EQ("-100", bound.value);
+    ASSERT_TRUE(RangeFilterOptimized::MakeRangeBound(
+        nm.MakeConstNode(static_cast<int64_t>(1650000000000)), true,
+        type::kTimestamp, &bound));
+    ASSERT_EQ("1650000000000", bound.value);
+    ASSERT_TRUE(RangeFilterOptimized::MakeRangeBound(
+        nm.MakeConstNode(0.1), true, type::kDouble, &bound));
+    ASSERT_DOUBLE_EQ(0.1, std::stod(bound.value));
+    ASSERT_TRUE(RangeFilterOptimized::MakeRangeBound(
+        nm.MakeConstNode(3), true, type::kFloat, &bound));
+    ASSERT_EQ("3", bound.value);
+    ASSERT_TRUE(RangeFilterOptimized::MakeRangeBound(
+        nm.MakeConstNode("abc"), true, type::kVarchar, &bound));
+    ASSERT_EQ("abc", bound.value);
+
+    // the constants not in the order of the column
+    ASSERT_FALSE(RangeFilterOptimized::MakeRangeBound(
+        nm.MakeConstNode(1.5), true, type::kInt32, &bound));
+    ASSERT_FALSE(RangeFilterOptimized::MakeRangeBound(
+        nm.MakeConstNode("1"), true, type::kInt32, &bound));
+    ASSERT_FALSE(RangeFilterOptimized::MakeRangeBound(
+        nm.MakeConstNode(1), true, type::kVarchar, &bound));
+    ASSERT_FALSE(RangeFilterOptimized::MakeRangeBound(
+        nm.MakeConstNode("2022-01-05"), true, type::kDate, &bound));
+}
+
+}  // namespace passes
+}  // namespace hybridse
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1459,6 +1459,7 @@ base::Status ConvertColumnIndexNode(const zetasql::ASTIndexDefinition* ast_def_n
 //   "ts"       -> IndexTsNode
 //   "ttl"      -> IndexTTLNode
 //   "ttl_type" -> IndexTTLTypeNode
+//   "key_encoding" -> IndexKeyEncodingNode
 //   "version"  -> IndexVersionNode
 base::Status ConvertIndexOption(const zetasql::ASTOptionsEntry* entry, node::NodeManager* node_manager,
                                 node::SqlNode** output) {
@@ -1571,6 +1572,14 @@ base::Status ConvertIndexOption(const zetasql::ASTOptionsEntry* entry, node::Nod
         CHECK_STATUS(AstPathExpressionToString(entry->value()->GetAsOrNull<zetasql::ASTPathExpression>(), &ttl_type));
         *output = node_manager->MakeIndexTTLTypeNode(ttl_type);
         return base::Status::OK();
+    } else if (boost::equals("key_encoding", name)) {
+        std::string key_encoding;
+        CHECK_TRUE(zetasql::AST_PATH_EXPRESSION == entry->value()->node_kind(), common::kSqlAstError,
+                   "Invalid key_encoding, should be path expression");
+        CHECK_STATUS(
+            AstPathExpressionToString(entry->value()->GetAsOrNull<zetasql::ASTPathExpression>(), &key_encoding));
+        *output = node_manager->MakeIndexKeyEncodingNode(key_encoding);
+        return base::Status::OK();
     } else if (boost::equals("version", name)) {
         switch (entry->value()->node_kind()) {
             case zetasql::AST_PATH_EXPRESSION: {
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <deque>
+#include <vector>
+
+#include "codec/list_iterator_codec.h"
+#include "udf/default_udf_library.h"
+#include "udf/simd_kernels.h"
+#include "udf/udf_registry.h"
+#include "vm/jit_runtime.h"
+
+using hybridse::codec::ListRef;
+
+namespace hybridse {
+namespace udf {
+
+/**
+ * Non-null values of a column list in a contiguous buffer. Window columns
+ * are `ColumnImpl` over the window rows, they are decoded directly from the
+ * row buffers without going through the per-element column iterator.
+ */
+template <typename V>
+struct ColumnValues {
+    codec::ListV<codec::Row>* root = nullptr;
+    uint32_t row_idx = 0;
+    uint32_t col_idx = 0;
+    std::vector<V> values;
+    // values widened to double, filled on demand for avg
+    bool has_doubles = false;
+    std::vector<double> doubles;
+
+    void Fill(codec::ListV<V>* list, codec::ColumnImpl<V>* column) {
+        values.clear();
+        has_doubles = false;
+        doubles.clear();
+        if (column != nullptr) {
+            auto root = column->root();
+            values.reserve(root->GetCount());
+            auto iter = root->GetIterator();
+            if (!iter) {
+                return;
+            }
+            iter->SeekToFirst();
+            V value;
+            bool is_null;
+            while (iter->Valid()) {
+                column->GetField(iter->GetValue(), &value, &is_null);
+                if (!is_null) {
+                    values.push_back(value);
+                }
+                iter->Next();
+            }
+        } else {
+            auto iter = list->GetIterator();
+            if (!iter) {
+                return;
+            }
+            iter->SeekToFirst();
+            while (iter->Valid()) {
+                values.push_back(iter->GetValue());
+                iter->Next();
+            }
+        }
+    }
+
+    const std::vector<double>& GetDoubles() {
+        if (!has_doubles) {
+            doubles.assign(values.begin(), values.end());
+            has_doubles = true;
+        }
+        return doubles;
+    }
+};
+
+/**
+ * Thread local cache of the materialized window columns, so several
+ * aggregates over the same column of a window, e.g. `sum(x)` and `avg(x)`,
+ * decode the column only once. Entries are keyed by the window and the
+ * column position, and live until the end of the current run step of the
+ * jit runtime, during which the window does not change.
+ */
+template <typename V>
+class ColumnValuesCache {
+ public:
+    static ColumnValuesCache* Get() {
+        thread_local ColumnValuesCache<V> cache;
+        return &cache;
+    }
+
+    ColumnValues<V>* Materialize(ListRef<V>* list_ref) {
+        auto list = reinterpret_cast<codec::ListV<V>*>(list_ref->list);
+        auto column = dynamic_cast<codec::ColumnImpl<V>*>(list);
+        auto runtime = vm::JitRuntime::get();
+        if (column == nullptr || !runtime->InRunStep()) {
+            scratch_.Fill(list, column);
+            return &scratch_;
+        }
+        if (runtime->GetRunStepId() != run_step_) {
+            run_step_ = runtime->GetRunStepId();
+            used_ = 0;
+        }
+        for (size_t i = 0; i < used_; ++i) {
+            auto& entry = entries_[i];
+            if (entry.root == column->root() &&
+                entry.row_idx == column->GetRowIdx() &&
+                entry.col_idx == column->GetColIdx()) {
+                return &entry;
+            }
+        }
+        if (used_ == entries_.size()) {
+            entries_.emplace_back();
+        }
+        auto entry = &entries_[used_++];
+        entry->root = column->root();
+        entry->row_idx = column->GetRowIdx();
+        entry->col_idx = column->GetColIdx();
+        entry->Fill(list, column);
+        return entry;
+    }
+
+ private:
+    uint64_t run_step_ = 0;
+    // entries_[0, used_) are materialized in the current run step, the
+    // others are kept to reuse their buffers
+    size_t used_ = 0;
+    std::deque<ColumnValues<V>> entries_;
+    ColumnValues<V> scratch_;
+};
+
+template <typename V>
+struct VectorizedUdafImpl {
+    static V Sum(ListRef<V>* list) {
+        auto& values = ColumnValuesCache<V>::Get()->Materialize(list)->values;
+        return simd::Sum(values.data(), values.size());
+    }
+
+    static void Min(ListRef<V>* list, V* output, bool* is_null) {
+        auto& values = ColumnValuesCache<V>::Get()->Materialize(list)->values;
+        *is_null = values.empty();
+        *output = values.empty() ? V(0) : simd::Min(values.data(), values.size());
+    }
+
+    static void Max(ListRef<V>* list, V* output, bool* is_null) {
+        auto& values = ColumnValuesCache<V>::Get()->Materialize(list)->values;
+        *is_null = values.empty();
+        *output = values.empty() ? V(0) : simd::Max(values.data(), values.size());
+    }
+
+    static double Avg(ListRef<V>* list) {
+        auto& values =
+            ColumnValuesCache<V>::Get()->Materialize(list)->GetDoubles();
+        return simd::Sum(values.data(), values.size()) / values.size();
+    }
+
+    static int64_t Count(ListRef<V>* list) {
+        return ColumnValuesCache<V>::Get()->Materialize(list)->values.size();
+    }
+};
+
+template <typename V>
+void RegisterVectorizedUdaf(UdfLibrary* lib) {
+    using Impl = VectorizedUdafImpl<V>;
+    lib->RegisterExternal(UdfLibrary::GetVectorizedUdafName("sum"))
+        .list_argument_at(0)
+        .args<ListRef<V>>(reinterpret_cast<void*>(Impl::Sum))
+        .template returns<V>();
+    lib->RegisterExternal(UdfLibrary::GetVectorizedUdafName("min"))
+        .list_argument_at(0)
+        .args<ListRef<V>>(reinterpret_cast<void*>(Impl::Min))
+        .return_by_arg(true)
+        .template returns<Nullable<V>>();
+    lib->RegisterExternal(UdfLibrary::GetVectorizedUdafName("max"))
+        .list_argument_at(0)
+        .args<ListRef<V>>(reinterpret_cast<void*>(Impl::Max))
+        .return_by_arg(true)
+        .template returns<Nullable<V>>();
+    lib->RegisterExternal(UdfLibrary::GetVectorizedUdafName("avg"))
+        .list_argument_at(0)
+        .args<ListRef<V>>(reinterpret_cast<void*>(Impl::Avg))
+        .template returns<double>();
+    lib->RegisterExternal(UdfLibrary::GetVectorizedUdafName("count"))
+        .list_argument_at(0)
+        .args<ListRef<V>>(reinterpret_cast<void*>(Impl::Count))
+        .template returns<int64_t>();
+}
+
+void DefaultUdfLibrary::InitVectorizedUdafs() {
+    RegisterVectorizedUdaf<int16_t>(this);
+    RegisterVectorizedUdaf<int32_t>(this);
+    RegisterVectorizedUdaf<int64_t>(this);
+    RegisterVectorizedUdaf<float>(this);
+    RegisterVectorizedUdaf<double>(this);
+}
+
+}  // namespace udf
+}  // namespace hybridse
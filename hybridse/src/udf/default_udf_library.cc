@@ -1985,6 +1985,7 @@ void DefaultUdfLibrary::Init() {
 
     InitWindowFunctions();
     InitUdaf();
+    InitVectorizedUdafs();
     InitFeatureZero();
 }
 
@@ -41,6 +41,7 @@ class DefaultUdfLibrary : public UdfLibrary {
     void InitMinByCateUdafs();
     void initMaxByCateUdaFs();
     void InitAvgByCateUdafs();
+    void InitVectorizedUdafs();
     void InitFeatureZero();
 
     static DefaultUdfLibrary inst_;
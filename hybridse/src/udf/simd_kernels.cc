@@ -0,0 +1,141 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "udf/simd_kernels.h"
+
+#include <limits>
+
+namespace hybridse {
+namespace udf {
+namespace simd {
+
+enum class SimdIsa { kScalar, kAvx2, kAvx512 };
+
+// kernels of an isa are only linked in when the build enables them, see
+// SIMD_AVX2_ENABLE and SIMD_AVX512_ENABLE
+static SimdIsa DetectSimdIsa() {
+#if defined(__x86_64__) && (defined(HYBRIDSE_SIMD_AVX512) || \
+                            defined(HYBRIDSE_SIMD_AVX2))
+    __builtin_cpu_init();
+#if defined(HYBRIDSE_SIMD_AVX512)
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdIsa::kAvx512;
+    }
+#endif
+#if defined(HYBRIDSE_SIMD_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdIsa::kAvx2;
+    }
+#endif
+#endif
+    return SimdIsa::kScalar;
+}
+
+static SimdIsa GetSimdIsaType() {
+    static const SimdIsa isa = DetectSimdIsa();
+    return isa;
+}
+
+const char* GetSimdIsa() {
+    switch (GetSimdIsaType()) {
+        case SimdIsa::kAvx512:
+            return "avx512";
+        case SimdIsa::kAvx2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+template <typename T>
+T Sum(const T* data, size_t size) {
+    if constexpr (std::is_same_v<T, int16_t> || std::is_floating_point_v<T>) {
+        return ScalarSum(data, size);
+    } else {
+        switch (GetSimdIsaType()) {
+#if defined(HYBRIDSE_SIMD_AVX512)
+            case SimdIsa::kAvx512:
+                return avx512::Sum(data, size);
+#endif
+#if defined(HYBRIDSE_SIMD_AVX2)
+            case SimdIsa::kAvx2:
+                return avx2::Sum(data, size);
+#endif
+            default:
+                return ScalarSum(data, size);
+        }
+    }
+}
+
+template <typename T>
+T Min(const T* data, size_t size) {
+    if constexpr (std::is_same_v<T, int16_t>) {
+        return ScalarMin(data, size, std::numeric_limits<T>::max());
+    } else {
+        switch (GetSimdIsaType()) {
+#if defined(HYBRIDSE_SIMD_AVX512)
+            case SimdIsa::kAvx512:
+                return avx512::Min(data, size);
+#endif
+#if defined(HYBRIDSE_SIMD_AVX2)
+            case SimdIsa::kAvx2:
+                return avx2::Min(data, size);
+#endif
+            default:
+                return ScalarMin(data, size, std::numeric_limits<T>::max());
+        }
+    }
+}
+
+template <typename T>
+T Max(const T* data, size_t size) {
+    if constexpr (std::is_same_v<T, int16_t>) {
+        return ScalarMax(data, size, std::numeric_limits<T>::lowest());
+    } else {
+        switch (GetSimdIsaType()) {
+#if defined(HYBRIDSE_SIMD_AVX512)
+            case SimdIsa::kAvx512:
+                return avx512::Max(data, size);
+#endif
+#if defined(HYBRIDSE_SIMD_AVX2)
+            case SimdIsa::kAvx2:
+                return avx2::Max(data, size);
+#endif
+            default:
+                return ScalarMax(data, size, std::numeric_limits<T>::lowest());
+        }
+    }
+}
+
+template int16_t Sum<int16_t>(const int16_t*, size_t);
+template int32_t Sum<int32_t>(const int32_t*, size_t);
+template int64_t Sum<int64_t>(const int64_t*, size_t);
+template float Sum<float>(const float*, size_t);
+template double Sum<double>(const double*, size_t);
+template int16_t Min<int16_t>(const int16_t*, size_t);
+template int32_t Min<int32_t>(const int32_t*, size_t);
+template int64_t Min<int64_t>(const int64_t*, size_t);
+template float Min<float>(const float*, size_t);
+template double Min<double>(const double*, size_t);
+template int16_t Max<int16_t>(const int16_t*, size_t);
+template int32_t Max<int32_t>(const int32_t*, size_t);
+template int64_t Max<int64_t>(const int64_t*, size_t);
+template float Max<float>(const float*, size_t);
+template double Max<double>(const double*, size_t);
+
+}  // namespace simd
+}  // namespace udf
+}  // namespace hybridse
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HYBRIDSE_SRC_UDF_SIMD_KERNELS_H_
+#define HYBRIDSE_SRC_UDF_SIMD_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace hybridse {
+namespace udf {
+namespace simd {
+
+/**
+ * Reduction kernels over contiguous column values, used by the vectorized
+ * built-in aggregates. The AVX-512 and AVX2 kernels are built in their own
+ * sources with the matching target flags, and picked at runtime by what the
+ * cpu supports, falling back to a plain scalar loop.
+ *
+ * Integer sums wrap around on overflow, same as the codegen'd `sum`.
+ * Floating point sums are always sequential scalar loops: adding in several
+ * lanes rounds differently, so the result would depend on the isa of the
+ * host and differ from the offline result.
+ */
+
+/**
+ * Name of the instruction set the kernels run with: "avx512", "avx2" or
+ * "scalar".
+ */
+const char* GetSimdIsa();
+
+template <typename T>
+T Sum(const T* data, size_t size);
+
+template <typename T>
+T Min(const T* data, size_t size);
+
+template <typename T>
+T Max(const T* data, size_t size);
+
+// Scalar loops, also used for the tails of the simd kernels. They are kept
+// local to each source, so the copies built with avx flags are never picked
+// by the linker for the scalar path.
+template <typename T>
+static inline T ScalarSum(const T* data, size_t size) {
+    if constexpr (std::is_integral_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        U acc = 0;
+        for (size_t i = 0; i < size; ++i) {
+            acc += static_cast<U>(data[i]);
+        }
+        return static_cast<T>(acc);
+    } else {
+        T acc = 0;
+        for (size_t i = 0; i < size; ++i) {
+            acc += data[i];
+        }
+        return acc;
+    }
+}
+
+template <typename T>
+static inline T ScalarMin(const T* data, size_t size, T init) {
+    T acc = init;
+    for (size_t i = 0; i < size; ++i) {
+        acc = data[i] < acc ? data[i] : acc;
+    }
+    return acc;
+}
+
+template <typename T>
+static inline T ScalarMax(const T* data, size_t size, T init) {
+    T acc = init;
+    for (size_t i = 0; i < size; ++i) {
+        acc = data[i] > acc ? data[i] : acc;
+    }
+    return acc;
+}
+
+// AVX2 kernels, only to be called if the cpu supports avx2
+namespace avx2 {
+int32_t Sum(const int32_t* data, size_t size);
+int64_t Sum(const int64_t* data, size_t size);
+int32_t Min(const int32_t* data, size_t size);
+int64_t Min(const int64_t* data, size_t size);
+float Min(const float* data, size_t size);
+double Min(const double* data, size_t size);
+int32_t Max(const int32_t* data, size_t size);
+int64_t Max(const int64_t* data, size_t size);
+float Max(const float* data, size_t size);
+double Max(const double* data, size_t size);
+}  // namespace avx2
+
+// AVX-512 kernels, only to be called if the cpu supports avx512f
+namespace avx512 {
+int32_t Sum(const int32_t* data, size_t size);
+int64_t Sum(const int64_t* data, size_t size);
+int32_t Min(const int32_t* data, size_t size);
+int64_t Min(const int64_t* data, size_t size);
+float Min(const float* data, size_t size);
+double Min(const double* data, size_t size);
+int32_t Max(const int32_t* data, size_t size);
+int64_t Max(const int64_t* data, size_t size);
+float Max(const float* data, size_t size);
+double Max(const double* data, size_t size);
+}  // namespace avx512
+
+}  // namespace simd
+}  // namespace udf
+}  // namespace hybridse
+
+#endif  // HYBRIDSE_SRC_UDF_SIMD_KERNELS_H_
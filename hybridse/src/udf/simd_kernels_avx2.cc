@@ -0,0 +1,178 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits>
+
+#include "udf/simd_kernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace hybridse {
+namespace udf {
+namespace simd {
+namespace avx2 {
+
+// the bodies are only built when the source is compiled with the target
+// flag, see src/CMakeLists.txt
+#if defined(__AVX2__)
+
+int32_t Sum(const int32_t* data, size_t size) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm256_add_epi32(
+            acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint32_t res = static_cast<uint32_t>(ScalarSum(lanes, 8));
+    return static_cast<int32_t>(
+        res + static_cast<uint32_t>(ScalarSum(data + i, size - i)));
+}
+
+int64_t Sum(const int64_t* data, size_t size) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        acc = _mm256_add_epi64(
+            acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t res = static_cast<uint64_t>(ScalarSum(lanes, 4));
+    return static_cast<int64_t>(
+        res + static_cast<uint64_t>(ScalarSum(data + i, size - i)));
+}
+
+
+int32_t Min(const int32_t* data, size_t size) {
+    __m256i acc = _mm256_set1_epi32(std::numeric_limits<int32_t>::max());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm256_min_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+            acc);
+    }
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return ScalarMin(data + i, size - i,
+                     ScalarMin(lanes, 8, std::numeric_limits<int32_t>::max()));
+}
+
+int32_t Max(const int32_t* data, size_t size) {
+    __m256i acc = _mm256_set1_epi32(std::numeric_limits<int32_t>::lowest());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm256_max_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+            acc);
+    }
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return ScalarMax(
+        data + i, size - i,
+        ScalarMax(lanes, 8, std::numeric_limits<int32_t>::lowest()));
+}
+
+// AVX2 has no 64-bit min/max, emulate it with compare and blend
+int64_t Min(const int64_t* data, size_t size) {
+    __m256i acc = _mm256_set1_epi64x(std::numeric_limits<int64_t>::max());
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256i val =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i gt = _mm256_cmpgt_epi64(acc, val);
+        acc = _mm256_blendv_epi8(acc, val, gt);
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return ScalarMin(data + i, size - i,
+                     ScalarMin(lanes, 4, std::numeric_limits<int64_t>::max()));
+}
+
+int64_t Max(const int64_t* data, size_t size) {
+    __m256i acc = _mm256_set1_epi64x(std::numeric_limits<int64_t>::lowest());
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256i val =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i gt = _mm256_cmpgt_epi64(val, acc);
+        acc = _mm256_blendv_epi8(acc, val, gt);
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return ScalarMax(
+        data + i, size - i,
+        ScalarMax(lanes, 4, std::numeric_limits<int64_t>::lowest()));
+}
+
+float Min(const float* data, size_t size) {
+    __m256 acc = _mm256_set1_ps(std::numeric_limits<float>::max());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm256_min_ps(_mm256_loadu_ps(data + i), acc);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    return ScalarMin(data + i, size - i,
+                     ScalarMin(lanes, 8, std::numeric_limits<float>::max()));
+}
+
+float Max(const float* data, size_t size) {
+    __m256 acc = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm256_max_ps(_mm256_loadu_ps(data + i), acc);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    return ScalarMax(data + i, size - i,
+                     ScalarMax(lanes, 8, std::numeric_limits<float>::lowest()));
+}
+
+double Min(const double* data, size_t size) {
+    __m256d acc = _mm256_set1_pd(std::numeric_limits<double>::max());
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        acc = _mm256_min_pd(_mm256_loadu_pd(data + i), acc);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    return ScalarMin(data + i, size - i,
+                     ScalarMin(lanes, 4, std::numeric_limits<double>::max()));
+}
+
+double Max(const double* data, size_t size) {
+    __m256d acc = _mm256_set1_pd(std::numeric_limits<double>::lowest());
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        acc = _mm256_max_pd(_mm256_loadu_pd(data + i), acc);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    return ScalarMax(
+        data + i, size - i,
+        ScalarMax(lanes, 4, std::numeric_limits<double>::lowest()));
+}
+
+#endif
+
+}  // namespace avx2
+}  // namespace simd
+}  // namespace udf
+}  // namespace hybridse
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits>
+
+#include "udf/simd_kernels.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace hybridse {
+namespace udf {
+namespace simd {
+namespace avx512 {
+
+// the bodies are only built when the source is compiled with the target
+// flag, see src/CMakeLists.txt
+#if defined(__AVX512F__)
+
+int32_t Sum(const int32_t* data, size_t size) {
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        acc = _mm512_add_epi32(acc, _mm512_loadu_si512(data + i));
+    }
+    int32_t res = _mm512_reduce_add_epi32(acc);
+    return static_cast<int32_t>(static_cast<uint32_t>(res) +
+                                static_cast<uint32_t>(
+                                    ScalarSum(data + i, size - i)));
+}
+
+int64_t Sum(const int64_t* data, size_t size) {
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm512_add_epi64(acc, _mm512_loadu_si512(data + i));
+    }
+    int64_t res = _mm512_reduce_add_epi64(acc);
+    return static_cast<int64_t>(static_cast<uint64_t>(res) +
+                                static_cast<uint64_t>(
+                                    ScalarSum(data + i, size - i)));
+}
+
+
+int32_t Min(const int32_t* data, size_t size) {
+    __m512i acc = _mm512_set1_epi32(std::numeric_limits<int32_t>::max());
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        acc = _mm512_min_epi32(_mm512_loadu_si512(data + i), acc);
+    }
+    return ScalarMin(data + i, size - i, _mm512_reduce_min_epi32(acc));
+}
+
+int32_t Max(const int32_t* data, size_t size) {
+    __m512i acc = _mm512_set1_epi32(std::numeric_limits<int32_t>::lowest());
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        acc = _mm512_max_epi32(_mm512_loadu_si512(data + i), acc);
+    }
+    return ScalarMax(data + i, size - i, _mm512_reduce_max_epi32(acc));
+}
+
+int64_t Min(const int64_t* data, size_t size) {
+    __m512i acc = _mm512_set1_epi64(std::numeric_limits<int64_t>::max());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm512_min_epi64(_mm512_loadu_si512(data + i), acc);
+    }
+    return ScalarMin(data + i, size - i,
+                     static_cast<int64_t>(_mm512_reduce_min_epi64(acc)));
+}
+
+int64_t Max(const int64_t* data, size_t size) {
+    __m512i acc = _mm512_set1_epi64(std::numeric_limits<int64_t>::lowest());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm512_max_epi64(_mm512_loadu_si512(data + i), acc);
+    }
+    return ScalarMax(data + i, size - i,
+                     static_cast<int64_t>(_mm512_reduce_max_epi64(acc)));
+}
+
+float Min(const float* data, size_t size) {
+    __m512 acc = _mm512_set1_ps(std::numeric_limits<float>::max());
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        acc = _mm512_min_ps(_mm512_loadu_ps(data + i), acc);
+    }
+    return ScalarMin(data + i, size - i, _mm512_reduce_min_ps(acc));
+}
+
+float Max(const float* data, size_t size) {
+    __m512 acc = _mm512_set1_ps(std::numeric_limits<float>::lowest());
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        acc = _mm512_max_ps(_mm512_loadu_ps(data + i), acc);
+    }
+    return ScalarMax(data + i, size - i, _mm512_reduce_max_ps(acc));
+}
+
+double Min(const double* data, size_t size) {
+    __m512d acc = _mm512_set1_pd(std::numeric_limits<double>::max());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm512_min_pd(_mm512_loadu_pd(data + i), acc);
+    }
+    return ScalarMin(data + i, size - i, _mm512_reduce_min_pd(acc));
+}
+
+double Max(const double* data, size_t size) {
+    __m512d acc = _mm512_set1_pd(std::numeric_limits<double>::lowest());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc = _mm512_max_pd(_mm512_loadu_pd(data + i), acc);
+    }
+    return ScalarMax(data + i, size - i, _mm512_reduce_max_pd(acc));
+}
+
+#endif
+
+}  // namespace avx512
+}  // namespace simd
+}  // namespace udf
+}  // namespace hybridse
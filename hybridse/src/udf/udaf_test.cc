@@ -230,6 +230,45 @@ TEST_F(UdafTest, avg_test) {
     CheckUdf<double, ListRef<double>>("avg", 0.0 / 0, MakeList<double>({}));
 }
 
+TEST_F(UdafTest, vectorized_test) {
+    // cover both vector body and scalar tail of the kernels
+    std::vector<int32_t> values;
+    for (int32_t i = 1; i <= 100; ++i) {
+        values.push_back(i % 2 == 0 ? i : -i);
+    }
+    codec::ArrayListV<int32_t> array_list(&values);
+    ListRef<int32_t> list;
+    list.list = reinterpret_cast<int8_t*>(&array_list);
+    CheckUdf<int32_t, ListRef<int32_t>>(
+        UdfLibrary::GetVectorizedUdafName("sum"), 50, list);
+    CheckUdf<Nullable<int32_t>, ListRef<int32_t>>(
+        UdfLibrary::GetVectorizedUdafName("min"), -99, list);
+    CheckUdf<Nullable<int32_t>, ListRef<int32_t>>(
+        UdfLibrary::GetVectorizedUdafName("max"), 100, list);
+    CheckUdf<double, ListRef<int32_t>>(
+        UdfLibrary::GetVectorizedUdafName("avg"), 0.5, list);
+    CheckUdf<int64_t, ListRef<int32_t>>(
+        UdfLibrary::GetVectorizedUdafName("count"), 100, list);
+
+    CheckUdf<int64_t, ListRef<int64_t>>(
+        UdfLibrary::GetVectorizedUdafName("sum"), 10,
+        MakeList<int64_t>({1, 2, 3, 4}));
+    CheckUdf<double, ListRef<double>>(UdfLibrary::GetVectorizedUdafName("sum"),
+                                      10.0, MakeList<double>({1, 2, 3, 4}));
+    CheckUdf<Nullable<float>, ListRef<float>>(
+        UdfLibrary::GetVectorizedUdafName("max"), 4.0f,
+        MakeList<float>({1, 2, 3, 4}));
+
+    // empty list
+    CheckUdf<int64_t, ListRef<int64_t>>(
+        UdfLibrary::GetVectorizedUdafName("sum"), 0, MakeList<int64_t>({}));
+    CheckUdf<Nullable<int64_t>, ListRef<int64_t>>(
+        UdfLibrary::GetVectorizedUdafName("min"), nullptr,
+        MakeList<int64_t>({}));
+    CheckUdf<double, ListRef<double>>(UdfLibrary::GetVectorizedUdafName("avg"),
+                                      0.0 / 0, MakeList<double>({}));
+}
+
 TEST_F(UdafTest, topk_test) {
     CheckUdf<StringRef, ListRef<int32_t>, ListRef<int32_t>>(
         "top", StringRef("6,6,5,4"), MakeList<int32_t>({1, 6, 3, 4, 5, 2, 6}),
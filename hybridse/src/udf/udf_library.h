@@ -103,6 +103,12 @@ class UdfLibrary {
     bool RequireListAt(const std::string& name, size_t index) const;
     bool IsListReturn(const std::string& name) const;
 
+    // Name of the vectorized implementation for builtin udaf `name`, which
+    // takes the whole column list and computes the result in one call.
+    static std::string GetVectorizedUdafName(const std::string& name) {
+        return name + ".vectorized";
+    }
+
     // register interfaces
     ExprUdfRegistryHelper RegisterExprUdf(const std::string& name);
     LlvmUdfRegistryHelper RegisterCodeGenUdf(const std::string& name);
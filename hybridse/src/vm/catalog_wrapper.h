@@ -340,11 +340,24 @@ class TableFilterWrapper : public TableHandler {
     TableFilterWrapper(std::shared_ptr<TableHandler> table_handler,
                        const Row& parameter,
                        const PredicateFun* fun)
-        : TableHandler(), table_hander_(table_handler), parameter_(parameter), fun_(fun) {}
+        : TableFilterWrapper(table_handler, parameter, fun, nullptr) {}
+    // iterate the rows in `range_scan` only if the table supports it, the
+    // predicate is applied on them as well
+    TableFilterWrapper(std::shared_ptr<TableHandler> table_handler,
+                       const Row& parameter, const PredicateFun* fun,
+                       const ColumnRange* range_scan)
+        : TableHandler(),
+          table_hander_(table_handler),
+          parameter_(parameter),
+          fun_(fun),
+          range_scan_(range_scan) {}
     virtual ~TableFilterWrapper() {}
 
     std::unique_ptr<RowIterator> GetIterator() {
-        auto iter = table_hander_->GetIterator();
+        auto iter = ScanRange();
+        if (!iter) {
+            iter = table_hander_->GetIterator();
+        }
         if (!iter) {
             return std::unique_ptr<RowIterator>();
         } else {
@@ -370,11 +383,11 @@ class TableFilterWrapper : public TableHandler {
         return table_hander_->GetDatabase();
     }
     base::ConstIterator<uint64_t, Row>* GetRawIterator() override {
-        return new IteratorFilterWrapper(
-            static_cast<std::unique_ptr<RowIterator>>(
-                table_hander_->GetRawIterator()),
-            parameter_,
-            fun_);
+        auto iter = ScanRange();
+        if (!iter) {
+            iter.reset(table_hander_->GetRawIterator());
+        }
+        return new IteratorFilterWrapper(std::move(iter), parameter_, fun_);
     }
     virtual std::shared_ptr<PartitionHandler> GetPartition(
         const std::string& index_name);
@@ -385,6 +398,15 @@ class TableFilterWrapper : public TableHandler {
     const Row& parameter_;
     Row value_;
     const PredicateFun* fun_;
+    const ColumnRange* range_scan_;
+
+ private:
+    std::unique_ptr<RowIterator> ScanRange() {
+        if (nullptr == range_scan_) {
+            return std::unique_ptr<RowIterator>();
+        }
+        return table_hander_->GetRangeIterator(*range_scan_);
+    }
 };
 
 class RowProjectWrapper : public RowHandler {
@@ -15,6 +15,8 @@
  */
 
 #include "vm/engine.h"
+#include <chrono>  // NOLINT
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -419,6 +421,36 @@ bool Engine::SetCacheLocked(const std::string& db, const std::string& sql, Engin
 RunSession::RunSession(EngineMode engine_mode) : engine_mode_(engine_mode), is_debug_(false), sp_name_("") {}
 RunSession::~RunSession() {}
 
+// Start a fresh profile of the session if profiling is enabled, count the
+// storage accesses of the run into it and record the total time of the run
+// when it goes out of scope
+class RunSession::ProfileRun {
+ public:
+    ProfileRun(RunSession* session, RunnerContext* ctx)
+        : session_(session),
+          profile_(session->is_profile_ ? std::make_shared<RunProfile>() : nullptr),
+          guard_(profile_ ? profile_->MutableTotalCounters() : nullptr),
+          start_(std::chrono::steady_clock::now()) {
+        session_->profile_ = profile_;
+        if (profile_ && nullptr != ctx) {
+            ctx->SetProfile(profile_.get());
+        }
+    }
+    ~ProfileRun() {
+        if (!profile_) {
+            return;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+        profile_->SetTotalTime(elapsed.count());
+    }
+
+ private:
+    RunSession* session_;
+    std::shared_ptr<RunProfile> profile_;
+    Profiler::Guard guard_;
+    std::chrono::steady_clock::time_point start_;
+};
+
 bool RunSession::SetCompileInfo(const std::shared_ptr<CompileInfo>& compile_info) {
     compile_info_ = compile_info;
     return true;
@@ -441,6 +473,7 @@ int32_t RequestRunSession::Run(const uint32_t task_id, const Row& in_row, Row* o
     DLOG(INFO) << "Request Row Run with task_id " << task_id;
     RunnerContext ctx(&std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context().cluster_job, in_row,
                       sp_name_, is_debug_);
+    ProfileRun profile_run(this, &ctx);
     auto output = task->RunWithCache(ctx);
     if (!output) {
         LOG(WARNING) << "Run request plan output is null";
@@ -467,6 +500,7 @@ int32_t BatchRequestRunSession::Run(const uint32_t id, const std::vector<Row>& r
         LOG(WARNING) << "Fail to run request plan: taskid" << id << " not exist!";
         return -2;
     }
+    ProfileRun profile_run(this, &ctx);
     auto handler = task->BatchRequestRun(ctx);
     if (!handler) {
         LOG(WARNING) << "Run request plan output is null";
@@ -483,36 +517,98 @@ int32_t BatchRunSession::Run(std::vector<Row>& rows, uint64_t limit) {
     return Run(Row(), rows, limit);
 }
 int32_t BatchRunSession::Run(const Row& parameter_row, std::vector<Row>& rows, uint64_t limit) {
+    auto start = std::chrono::steady_clock::now();
+    auto cursor = OpenCursor(parameter_row);
+    if (!cursor) {
+        return -1;
+    }
+    {
+        // the total of profile covers the rows pulled from the lazy outputs
+        Profiler::Guard guard(profile_ ? profile_->MutableTotalCounters() : nullptr);
+        while (cursor->Valid()) {
+            rows.push_back(cursor->GetValue());
+            cursor->Next();
+        }
+    }
+    if (profile_) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        profile_->SetTotalTime(elapsed.count());
+    }
+    return 0;
+}
+std::shared_ptr<BatchRunCursor> BatchRunSession::OpenCursor(const Row& parameter_row) {
+    profile_ = is_profile_ ? std::make_shared<RunProfile>() : nullptr;
+    std::shared_ptr<BatchRunCursor> cursor(new BatchRunCursor(compile_info_, parameter_row, is_debug_, profile_));
+    if (!cursor->Open()) {
+        return nullptr;
+    }
+    return cursor;
+}
+
+BatchRunCursor::BatchRunCursor(const std::shared_ptr<CompileInfo>& compile_info, const Row& parameter_row,
+                               bool is_debug, const std::shared_ptr<RunProfile>& profile)
+    : compile_info_(compile_info), ctx_(), profile_(profile), output_(), iter_(), row_(), row_valid_(false) {
     auto& sql_ctx = std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context();
-    RunnerContext ctx(&sql_ctx.cluster_job, parameter_row, is_debug_);
-    auto output = sql_ctx.cluster_job.GetTask(0).GetRoot()->RunWithCache(ctx);
-    if (!output) {
+    ctx_ = std::make_unique<RunnerContext>(&sql_ctx.cluster_job, parameter_row, is_debug);
+}
+BatchRunCursor::~BatchRunCursor() {
+    // the iterator may refer to the handlers cached in running context
+    iter_.reset();
+    output_.reset();
+    ctx_.reset();
+}
+bool BatchRunCursor::Open() {
+    auto& sql_ctx = std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context();
+    if (profile_) {
+        Profiler::Guard guard(profile_->MutableTotalCounters());
+        ctx_->SetProfile(profile_.get());
+        output_ = sql_ctx.cluster_job.GetTask(0).GetRoot()->RunWithCache(*ctx_);
+        ctx_->SetProfile(nullptr);
+    } else {
+        output_ = sql_ctx.cluster_job.GetTask(0).GetRoot()->RunWithCache(*ctx_);
+    }
+    if (!output_) {
         DLOG(INFO) << "Run batch plan output is empty";
-        return 0;
+        return true;
     }
-    switch (output->GetHanlderType()) {
+    switch (output_->GetHanlderType()) {
         case kTableHandler: {
-            auto iter = std::dynamic_pointer_cast<TableHandler>(output)->GetIterator();
-            if (!iter) {
-                return 0;
+            iter_ = std::dynamic_pointer_cast<TableHandler>(output_)->GetIterator();
+            if (iter_) {
+                iter_->SeekToFirst();
             }
-            iter->SeekToFirst();
-            while (iter->Valid()) {
-                rows.push_back(iter->GetValue());
-                iter->Next();
-            }
-            return 0;
+            return true;
         }
         case kRowHandler: {
-            rows.push_back(std::dynamic_pointer_cast<RowHandler>(output)->GetValue());
-            return 0;
+            row_ = std::dynamic_pointer_cast<RowHandler>(output_)->GetValue();
+            row_valid_ = true;
+            return true;
         }
         case kPartitionHandler: {
             LOG(WARNING) << "Partition output is invalid";
-            return -1;
+            return false;
         }
     }
-    return 0;
+    return true;
+}
+bool BatchRunCursor::Valid() const {
+    if (iter_) {
+        return iter_->Valid();
+    }
+    return row_valid_;
+}
+const Row& BatchRunCursor::GetValue() const {
+    if (iter_) {
+        return iter_->GetValue();
+    }
+    return row_;
+}
+void BatchRunCursor::Next() {
+    if (iter_) {
+        iter_->Next();
+    } else {
+        row_valid_ = false;
+    }
 }
 
 std::shared_ptr<RowHandler> LocalTablet::SubQuery(uint32_t task_id, const std::string& db, const std::string& sql,
@@ -32,9 +32,14 @@ void JitRuntime::AddManagedObject(base::FeBaseObject* obj) {
     }
 }
 
-void JitRuntime::InitRunStep() {}
+void JitRuntime::InitRunStep() {
+    ++run_step_id_;
+    in_run_step_ = true;
+}
 
 void JitRuntime::ReleaseRunStep() {
+    ++run_step_id_;
+    in_run_step_ = false;
     mem_pool_.Reset();
     for (base::FeBaseObject* obj : allocated_obj_pool_) {
         if (obj != nullptr) {
@@ -16,6 +16,7 @@
 #ifndef HYBRIDSE_SRC_VM_JIT_RUNTIME_H_
 #define HYBRIDSE_SRC_VM_JIT_RUNTIME_H_
 
+#include <cstdint>
 #include <list>
 
 #include "base/fe_object.h"
@@ -56,9 +57,22 @@ class JitRuntime {
      */
     void ReleaseRunStep();
 
+    /**
+     * Id of the current run step, changed by both `InitRunStep()` and
+     * `ReleaseRunStep()`, so states cached by id never outlive a run step
+     */
+    uint64_t GetRunStepId() const { return run_step_id_; }
+
+    /**
+     * Whether called between `InitRunStep()` and `ReleaseRunStep()`
+     */
+    bool InRunStep() const { return in_run_step_; }
+
  private:
     openmldb::base::ByteMemoryPool mem_pool_;
     std::list<base::FeBaseObject*> allocated_obj_pool_;
+    uint64_t run_step_id_ = 0;
+    bool in_run_step_ = false;
 
     static thread_local JitRuntime tls_runtime_inst_;
 };
@@ -671,6 +671,7 @@ Status Filter::ReplaceExpr(const passes::ExprReplacer& replacer, node::NodeManag
     CHECK_STATUS(left_key_.ReplaceExpr(replacer, nm, &out->left_key_));
     CHECK_STATUS(right_key_.ReplaceExpr(replacer, nm, &out->right_key_));
     CHECK_STATUS(index_key_.ReplaceExpr(replacer, nm, &out->index_key_));
+    out->range_scan_ = range_scan_;
     return Status::OK();
 }
 
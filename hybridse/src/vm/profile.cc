@@ -0,0 +1,84 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vm/profile.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace hybridse {
+namespace vm {
+
+static void PrintRows(std::ostream& output, int64_t rows) {
+    if (rows < 0) {
+        output << "-";
+    } else {
+        output << rows;
+    }
+}
+
+static void PrintStat(std::ostream& output, uint64_t time_ns, const ProfileCounters& counters) {
+    output << "time=" << std::fixed << std::setprecision(3) << time_ns / 1000000.0 << "ms"
+           << " seeks=" << counters.seek_cnt << " nexts=" << counters.next_cnt
+           << " decoded=" << counters.decode_bytes << "B";
+}
+
+void RunProfile::PrintRunner(std::ostream& output, int32_t id, const std::string& tab,
+                             std::vector<int32_t>* visited) const {
+    auto it = runners_.find(id);
+    if (it == runners_.end()) {
+        return;
+    }
+    const auto& runner = it->second;
+    output << "\n" << tab << "[" << id << "]" << runner.type;
+    if (std::find(visited->begin(), visited->end(), id) != visited->end()) {
+        output << " ...";
+        return;
+    }
+    visited->push_back(id);
+    output << " calls=" << runner.run_cnt << " ";
+    PrintStat(output, runner.time_ns, runner.counters);
+    output << " rows_in=";
+    PrintRows(output, runner.rows_in);
+    output << " rows_out=";
+    PrintRows(output, runner.rows_out);
+    for (auto producer : runner.producers) {
+        PrintRunner(output, producer, tab + "  ", visited);
+    }
+}
+
+void RunProfile::Print(std::ostream& output) const {
+    output << "TOTAL ";
+    PrintStat(output, total_time_ns_, total_counters_);
+    std::vector<int32_t> visited;
+    PrintRunner(output, root_, "  ", &visited);
+    // runners out of the main tree, e.g. the index key of a remote request
+    for (const auto& kv : runners_) {
+        if (std::find(visited.begin(), visited.end(), kv.first) == visited.end()) {
+            PrintRunner(output, kv.first, "  ", &visited);
+        }
+    }
+}
+
+std::string RunProfile::ToString() const {
+    std::ostringstream oss;
+    Print(oss);
+    return oss.str();
+}
+
+}  // namespace vm
+}  // namespace hybridse
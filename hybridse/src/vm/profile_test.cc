@@ -0,0 +1,132 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vm/profile.h"
+
+#include <string>
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+
+namespace hybridse {
+namespace vm {
+
+class ProfileTest : public ::testing::Test {};
+
+TEST_F(ProfileTest, CountersOnlyWhenEnabled) {
+    ProfileCounters counters;
+    Profiler::CountSeek();
+    Profiler::CountNext();
+    Profiler::CountDecode(100);
+    ASSERT_FALSE(Profiler::IsEnabled());
+    {
+        Profiler::Guard guard(&counters);
+        ASSERT_TRUE(Profiler::IsEnabled());
+        {
+            // a nested run without profiling does not turn it off
+            Profiler::Guard inner(nullptr);
+            ASSERT_TRUE(Profiler::IsEnabled());
+        }
+        Profiler::CountSeek();
+        Profiler::CountNext();
+        Profiler::CountNext();
+        Profiler::CountDecode(100);
+        // counters of other threads are not mixed in
+        ProfileCounters other_counters;
+        std::thread t([&other_counters]() {
+            ASSERT_FALSE(Profiler::IsEnabled());
+            Profiler::CountNext();
+            Profiler::Guard other(&other_counters);
+            Profiler::CountNext();
+        });
+        t.join();
+        ASSERT_EQ(1u, other_counters.next_cnt);
+    }
+    ASSERT_FALSE(Profiler::IsEnabled());
+    Profiler::CountNext();
+    ASSERT_EQ(1u, counters.seek_cnt);
+    ASSERT_EQ(2u, counters.next_cnt);
+    ASSERT_EQ(100u, counters.decode_bytes);
+}
+
+// slot of a single coroutine, which may run on any thread
+static ProfileCounters* coroutine_slot = nullptr;
+
+TEST_F(ProfileTest, LocalSlot) {
+    Profiler::SetLocalSlot([]() { return coroutine_slot; },
+                           [](ProfileCounters* counters) { coroutine_slot = counters; });
+    ProfileCounters counters;
+    {
+        Profiler::Guard guard(&counters);
+        Profiler::CountSeek();
+        // the coroutine resumes on another thread
+        std::thread t([]() {
+            Profiler::CountNext();
+            Profiler::CountDecode(8);
+        });
+        t.join();
+    }
+    ASSERT_EQ(nullptr, coroutine_slot);
+    Profiler::SetLocalSlot(nullptr, nullptr);
+    ASSERT_EQ(1u, counters.seek_cnt);
+    ASSERT_EQ(1u, counters.next_cnt);
+    ASSERT_EQ(8u, counters.decode_bytes);
+}
+
+TEST_F(ProfileTest, Print) {
+    RunProfile profile;
+    profile.SetRoot(3);
+    auto root = profile.GetRunner(3);
+    root->id = 3;
+    root->type = "SIMPLE_PROJECT";
+    root->producers = {2};
+    root->run_cnt = 1;
+    root->rows_in = -1;
+    root->rows_out = 1;
+    auto window = profile.GetRunner(2);
+    window->id = 2;
+    window->type = "REQUEST_UNION";
+    window->producers = {1, 0};
+    window->run_cnt = 1;
+    window->time_ns = 2500000;
+    window->counters.seek_cnt = 1;
+    window->counters.next_cnt = 10;
+    window->counters.decode_bytes = 640;
+    window->rows_in = -1;
+    window->rows_out = -1;
+    auto other = profile.GetRunner(5);
+    other->id = 5;
+    other->type = "DATA_PROVIDER";
+    other->run_cnt = 1;
+    profile.SetTotalTime(3000000);
+    *profile.MutableTotalCounters() = window->counters;
+
+    std::string output = profile.ToString();
+    ASSERT_EQ(
+        "TOTAL time=3.000ms seeks=1 nexts=10 decoded=640B\n"
+        "  [3]SIMPLE_PROJECT calls=1 time=0.000ms seeks=0 nexts=0 decoded=0B rows_in=- rows_out=1\n"
+        "    [2]REQUEST_UNION calls=1 time=2.500ms seeks=1 nexts=10 decoded=640B rows_in=- rows_out=-\n"
+        "  [5]DATA_PROVIDER calls=1 time=0.000ms seeks=0 nexts=0 decoded=0B rows_in=0 rows_out=0",
+        output);
+}
+
+}  // namespace vm
+}  // namespace hybridse
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
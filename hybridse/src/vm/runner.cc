@@ -16,8 +16,12 @@
 
 #include "vm/runner.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
 #include <memory>
 #include <string>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -311,10 +315,16 @@ ClusterTask RunnerBuilder::Build(PhysicalOpNode* node, Status& status) {
                 &runner, id_++, node->schemas_ctx(), op->GetLimitCnt(),
                 op->window().range_, op->exclude_current_time(),
                 op->output_request_row());
+            if (window_scan_cache_size_ > 0) {
+                runner->SetWindowScanCache(window_scan_cache_size_);
+            }
             Key index_key;
             if (!op->instance_not_in_window()) {
                 runner->AddWindowUnion(op->window_, right);
                 index_key = op->window_.index_key_;
+                if (op->window_unions_.Empty()) {
+                    ShareWindowScan(op, runner);
+                }
             }
             if (!op->window_unions_.Empty()) {
                 for (auto window_union : op->window_unions_.window_unions_) {
@@ -581,6 +591,50 @@ ClusterTask RunnerBuilder::Build(PhysicalOpNode* node, Status& status) {
     }
 }
 
+// Identify the data read by a physical node: data providers over the same
+// table (and index) read the same data
+static std::string DataSourceKey(const PhysicalOpNode* node) {
+    if (kPhysicalOpDataProvider != node->GetOpType()) {
+        return absl::StrCat("node#", node->node_id());
+    }
+    auto provider = dynamic_cast<const PhysicalDataProviderNode*>(node);
+    auto key = absl::StrCat(DataProviderTypeName(provider->provider_type_),
+                            ":", provider->GetDb(), ".", provider->GetName());
+    if (kProviderTypePartition == provider->provider_type_) {
+        absl::StrAppend(
+            &key, ".",
+            dynamic_cast<const PhysicalPartitionProviderNode*>(node)
+                ->index_name_);
+    }
+    return key;
+}
+
+// Request union runners reading the same partition with the same order and
+// frame end share one window scan, see SharedWindowScan
+void RunnerBuilder::ShareWindowScan(const PhysicalRequestUnionNode* op,
+                                    RequestUnionRunner* runner) {
+    auto& window = op->window();
+    if (!window.range_.Valid()) {
+        return;
+    }
+    auto key = absl::StrCat(
+        DataSourceKey(op->producers().at(0)), "|",
+        DataSourceKey(op->producers().at(1)), "|",
+        window.partition_.ToString(), "|", window.index_key_.ToString(), "|",
+        window.sort_.ToString(), "|", window.range_.range_key()->GetExprString(),
+        "|", op->exclude_current_time());
+    auto& window_range = runner->range_gen_.window_range_;
+    auto iter = window_scans_.find(key);
+    if (iter == window_scans_.end()) {
+        auto scan = std::make_shared<SharedWindowScan>(window_scans_.size(),
+                                                       window_range);
+        window_scans_.insert(std::make_pair(key, scan));
+        runner->SetSharedWindowScan(scan);
+    } else if (iter->second->Merge(window_range)) {
+        runner->SetSharedWindowScan(iter->second);
+    }
+}
+
 ClusterTask RunnerBuilder::BinaryInherit(const ClusterTask& left,
                                          const ClusterTask& right,
                                          Runner* runner, const Key& index_key,
@@ -1041,6 +1095,139 @@ std::shared_ptr<TableHandler> Runner::TableReverse(
     output_table->Reverse();
     return output_table;
 }
+static uint64_t ProfileNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Count rows of the data materialized in memory, the lazy handlers are
+// counted as -1 since iterating them would run the storage scan again
+static int64_t ProfileCountRows(const std::shared_ptr<DataHandler>& data) {
+    if (!data) {
+        return 0;
+    }
+    switch (data->GetHanlderType()) {
+        case kRowHandler:
+            return 1;
+        case kTableHandler: {
+            auto& handler = *data;
+            if (typeid(handler) == typeid(MemTableHandler) ||
+                typeid(handler) == typeid(MemTimeTableHandler)) {
+                return data->GetCount();
+            }
+            return -1;
+        }
+        default:
+            return -1;
+    }
+}
+
+static int64_t ProfileCountRows(const std::shared_ptr<DataHandlerList>& data) {
+    if (!data) {
+        return 0;
+    }
+    int64_t total = 0;
+    for (size_t idx = 0; idx < data->GetSize(); idx++) {
+        int64_t rows = ProfileCountRows(data->Get(idx));
+        if (rows < 0) {
+            return -1;
+        }
+        total += rows;
+    }
+    return total;
+}
+
+static void ProfileAddRows(int64_t rows, int64_t* total) {
+    if (*total < 0 || rows < 0) {
+        *total = -1;
+    } else {
+        *total += rows;
+    }
+}
+
+RunnerProfileScope::RunnerProfileScope(RunnerContext& ctx, const Runner* runner)
+    : ctx_(ctx),
+      profile_(nullptr),
+      run_counters_(nullptr),
+      parent_(nullptr),
+      start_ns_(0),
+      start_counters_(),
+      child_ns_(0),
+      child_counters_() {
+    if (nullptr == ctx.profile()) {
+        return;
+    }
+    profile_ = ctx.profile()->GetRunner(runner->id_);
+    run_counters_ = &ctx.profile()->GetTotalCounters();
+    if (profile_->run_cnt == 0) {
+        profile_->id = runner->id_;
+        profile_->type = runner->GetTypeName();
+        profile_->producers.clear();
+        for (auto producer : runner->GetProducers()) {
+            profile_->producers.push_back(producer->id_);
+        }
+    }
+    profile_->run_cnt++;
+    if (nullptr == ctx.profile_scope_ && ctx.profile()->GetRoot() < 0) {
+        ctx.profile()->SetRoot(runner->id_);
+    }
+    parent_ = ctx.profile_scope_;
+    ctx.profile_scope_ = this;
+    start_counters_ = *run_counters_;
+    start_ns_ = ProfileNowNs();
+}
+
+RunnerProfileScope::~RunnerProfileScope() {
+    if (nullptr == profile_) {
+        return;
+    }
+    uint64_t elapsed = ProfileNowNs() - start_ns_;
+    ProfileCounters counters = *run_counters_ - start_counters_;
+    profile_->time_ns += elapsed - std::min(elapsed, child_ns_);
+    profile_->counters += counters - child_counters_;
+    if (nullptr != parent_) {
+        parent_->child_ns_ += elapsed;
+        parent_->child_counters_ += counters;
+    }
+    ctx_.profile_scope_ = parent_;
+}
+
+void RunnerProfileScope::SetInputs(
+    const std::vector<std::shared_ptr<DataHandler>>& inputs) {
+    if (nullptr == profile_) {
+        return;
+    }
+    for (auto& input : inputs) {
+        ProfileAddRows(ProfileCountRows(input), &profile_->rows_in);
+    }
+}
+
+void RunnerProfileScope::SetInputs(
+    const std::vector<std::shared_ptr<DataHandlerList>>& inputs) {
+    if (nullptr == profile_) {
+        return;
+    }
+    for (auto& input : inputs) {
+        ProfileAddRows(ProfileCountRows(input), &profile_->rows_in);
+    }
+}
+
+void RunnerProfileScope::SetOutput(const std::shared_ptr<DataHandler>& output) {
+    if (nullptr == profile_) {
+        return;
+    }
+    ProfileAddRows(ProfileCountRows(output), &profile_->rows_out);
+}
+
+void RunnerProfileScope::SetOutput(
+    const std::shared_ptr<DataHandlerList>& outputs) {
+    if (nullptr == profile_) {
+        return;
+    }
+    ProfileAddRows(ProfileCountRows(outputs), &profile_->rows_out);
+}
+
 std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
     if (need_cache_) {
         auto cached = ctx.GetBatchCache(id_);
@@ -1049,6 +1236,7 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
             return cached;
         }
     }
+    RunnerProfileScope profile_scope(ctx, this);
     std::shared_ptr<DataHandlerVector> outputs =
         std::make_shared<DataHandlerVector>();
     std::vector<std::shared_ptr<DataHandler>> inputs(producers_.size());
@@ -1057,6 +1245,7 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
     for (size_t idx = producers_.size(); idx > 0; idx--) {
         batch_inputs[idx - 1] = producers_[idx - 1]->BatchRequestRun(ctx);
     }
+    profile_scope.SetInputs(batch_inputs);
 
     for (size_t idx = 0; idx < ctx.GetRequestSize(); idx++) {
         inputs.clear();
@@ -1076,6 +1265,7 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
             }
             auto repeated_data = std::shared_ptr<DataHandlerList>(
                 new DataHandlerRepeater(res, ctx.GetRequestSize()));
+            profile_scope.SetOutput(repeated_data);
             if (need_cache_) {
                 ctx.SetBatchCache(id_, repeated_data);
             }
@@ -1083,6 +1273,7 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
         }
         outputs->Add(res);
     }
+    profile_scope.SetOutput(outputs);
     if (ctx.is_debug()) {
         std::ostringstream oss;
         oss << "RUNNER TYPE: " << RunnerTypeName(type_) << ", ID: " << id_
@@ -1109,12 +1300,15 @@ std::shared_ptr<DataHandler> Runner::RunWithCache(RunnerContext& ctx) {
             return cached;
         }
     }
+    RunnerProfileScope profile_scope(ctx, this);
     std::vector<std::shared_ptr<DataHandler>> inputs(producers_.size());
     for (size_t idx = producers_.size(); idx > 0; idx--) {
         inputs[idx - 1] = producers_[idx - 1]->RunWithCache(ctx);
     }
+    profile_scope.SetInputs(inputs);
 
     auto res = Run(ctx, inputs);
+    profile_scope.SetOutput(res);
     if (ctx.is_debug()) {
         std::ostringstream oss;
         oss << "RUNNER TYPE: " << RunnerTypeName(type_) << ", ID: " << id_ << "\n";
@@ -1140,8 +1334,10 @@ std::shared_ptr<DataHandlerList> DataRunner::BatchRequestRun(
             return cached;
         }
     }
+    RunnerProfileScope profile_scope(ctx, this);
     auto res = std::shared_ptr<DataHandlerList>(
         new DataHandlerRepeater(data_handler_, ctx.GetRequestSize()));
+    profile_scope.SetOutput(res);
 
     if (ctx.is_debug()) {
         std::ostringstream oss;
@@ -1169,12 +1365,14 @@ std::shared_ptr<DataHandlerList> RequestRunner::BatchRequestRun(
             return cached;
         }
     }
+    RunnerProfileScope profile_scope(ctx, this);
     std::shared_ptr<DataHandlerVector> res =
         std::shared_ptr<DataHandlerVector>(new DataHandlerVector());
     for (size_t idx = 0; idx < ctx.GetRequestSize(); idx++) {
         res->Add(std::shared_ptr<MemRowHandler>(
             new MemRowHandler(ctx.GetRequest(idx))));
     }
+    profile_scope.SetOutput(res);
 
     if (ctx.is_debug()) {
         std::ostringstream oss;
@@ -3041,15 +3239,272 @@ std::shared_ptr<DataHandler> RequestUnionRunner::Run(
 
     int64_t ts_gen = range_gen_.Valid() ? range_gen_.ts_gen_.Gen(request) : -1;
 
+    if (shared_scan_ && shared_scan_->runners_cnt() > 1) {
+        // derive window from the scan shared with other runners, the scan
+        // runs once per request by whichever runner comes first
+        auto scan = ctx.GetWindowScan(shared_scan_->id(), request);
+        if (!scan) {
+            auto union_segments = GetUnionSegments(
+                ctx, request, ts_gen, shared_scan_->window_range());
+            scan = RequestUnionWindow(request, union_segments, ts_gen,
+                                      shared_scan_->window_range(), false,
+                                      exclude_current_time_);
+            ctx.SetWindowScan(shared_scan_->id(), request, scan);
+        }
+        return RequestUnionWindow(request, {scan}, ts_gen,
+                                  range_gen_.window_range_,
+                                  output_request_row_, exclude_current_time_);
+    }
+
     // Prepare Union Window
-    auto union_inputs = windows_union_gen_.RunInputs(ctx);
     auto union_segments =
-        windows_union_gen_.GetRequestWindows(request, ctx.GetParameterRow(), union_inputs);
+        GetUnionSegments(ctx, request, ts_gen, range_gen_.window_range_);
     // build window with start and end offset
     return RequestUnionWindow(request, union_segments, ts_gen,
                               range_gen_.window_range_, output_request_row_,
                               exclude_current_time_);
 }
+
+// Rows of the batch locating the same windows are grouped, the storage is
+// scanned once for every group with a frame covering all rows of the group,
+// and the window of each row is cut from the scan result.
+// Only frames bounded by time are supported, others run row by row.
+std::shared_ptr<DataHandlerList> RequestUnionRunner::BatchRequestRun(
+    RunnerContext& ctx) {
+    auto& window_range = range_gen_.window_range_;
+    if (need_batch_cache_ || !range_gen_.Valid() ||
+        Window::kFrameRowsRange != window_range.frame_type_ ||
+        ctx.GetRequestSize() < 2) {
+        return Runner::BatchRequestRun(ctx);
+    }
+    if (need_cache_) {
+        auto cached = ctx.GetBatchCache(id_);
+        if (cached != nullptr) {
+            DLOG(INFO) << "RUNNER ID " << id_ << " HIT CACHE!";
+            return cached;
+        }
+    }
+    RunnerProfileScope profile_scope(ctx, this);
+    auto requests = producers_[0]->BatchRequestRun(ctx);
+    auto tables = producers_[1]->BatchRequestRun(ctx);
+    if (!requests || !tables) {
+        return std::shared_ptr<DataHandlerList>();
+    }
+    profile_scope.SetInputs(std::vector<std::shared_ptr<DataHandlerList>>{requests, tables});
+    auto& parameter = ctx.GetParameterRow();
+    size_t request_size = ctx.GetRequestSize();
+    std::vector<Row> request_rows(request_size);
+    std::vector<int64_t> request_ts(request_size);
+    std::vector<std::shared_ptr<DataHandler>> windows(request_size);
+    std::map<std::string, std::vector<size_t>> groups;
+    for (size_t idx = 0; idx < request_size; idx++) {
+        auto request = requests->Get(idx);
+        if (!request || kRowHandler != request->GetHanlderType() ||
+            !tables->Get(idx)) {
+            continue;
+        }
+        request_rows[idx] =
+            std::dynamic_pointer_cast<RowHandler>(request)->GetValue();
+        request_ts[idx] = range_gen_.ts_gen_.Gen(request_rows[idx]);
+        groups[windows_union_gen_.GetRequestKeys(request_rows[idx], parameter)]
+            .push_back(idx);
+    }
+
+    auto union_inputs = windows_union_gen_.RunInputs(ctx);
+    for (auto& group : groups) {
+        auto& idxs = group.second;
+        size_t max_idx = idxs[0];
+        int64_t min_ts = request_ts[idxs[0]];
+        for (auto idx : idxs) {
+            min_ts = std::min(min_ts, request_ts[idx]);
+            if (request_ts[idx] > request_ts[max_idx]) {
+                max_idx = idx;
+            }
+        }
+        auto union_segments = windows_union_gen_.GetRequestWindows(
+            request_rows[max_idx], parameter, union_inputs);
+        if (1 == idxs.size() || min_ts < 0) {
+            for (auto idx : idxs) {
+                windows[idx] = RequestUnionWindow(
+                    request_rows[idx], union_segments, request_ts[idx],
+                    window_range, output_request_row_, exclude_current_time_);
+            }
+            continue;
+        }
+        // scan from the end of the latest row to the start of the earliest,
+        // an unbounded start (INT64_MIN) stays unbounded
+        WindowRange scan_range = window_range;
+        int64_t ts_diff = request_ts[max_idx] - min_ts;
+        scan_range.start_offset_ =
+            scan_range.start_offset_ < INT64_MIN + ts_diff
+                ? INT64_MIN
+                : scan_range.start_offset_ - ts_diff;
+        scan_range.max_size_ = 0;
+        std::shared_ptr<TableHandler> scan = RequestUnionWindow(
+            request_rows[max_idx], union_segments, request_ts[max_idx],
+            scan_range, false, exclude_current_time_);
+        for (auto idx : idxs) {
+            windows[idx] = RequestUnionWindow(
+                request_rows[idx], {scan}, request_ts[idx], window_range,
+                output_request_row_, exclude_current_time_);
+        }
+    }
+
+    std::shared_ptr<DataHandlerVector> outputs =
+        std::make_shared<DataHandlerVector>();
+    for (auto& window : windows) {
+        outputs->Add(window);
+    }
+    profile_scope.SetOutput(outputs);
+    if (need_cache_) {
+        ctx.SetBatchCache(id_, outputs);
+    }
+    return outputs;
+}
+
+bool SharedWindowScan::Merge(const WindowRange& window_range) {
+    if (window_range.end_offset_ != window_range_.end_offset_) {
+        return false;
+    }
+    WindowRange merged = window_range_;
+    if (merged.frame_type_ != window_range.frame_type_) {
+        // rows in either frame are in the merged frame
+        merged.frame_type_ = Window::kFrameRowsMergeRowsRange;
+    }
+    merged.start_row_ = std::max(merged.start_row_, window_range.start_row_);
+    // rows frame doesn't bound the window with start offset
+    if (Window::kFrameRows == window_range_.frame_type_) {
+        merged.start_offset_ = window_range.start_offset_;
+    } else if (Window::kFrameRows != window_range.frame_type_) {
+        merged.start_offset_ =
+            std::min(merged.start_offset_, window_range.start_offset_);
+    }
+    merged.max_size_ = 0 == merged.max_size_ || 0 == window_range.max_size_
+                           ? 0
+                           : std::max(merged.max_size_, window_range.max_size_);
+    window_range_ = merged;
+    runners_cnt_++;
+    return true;
+}
+
+// Return the segments of the request windows. With the window scan cache,
+// the segment of a single partition which keeps versions is replaced by its
+// scan cached across requests, if the frame is bounded by time
+std::vector<std::shared_ptr<TableHandler>>
+RequestUnionRunner::GetUnionSegments(RunnerContext& ctx, const Row& request,
+                                     int64_t ts_gen,
+                                     const WindowRange& window_range) {
+    auto union_inputs = windows_union_gen_.RunInputs(ctx);
+    auto union_segments = windows_union_gen_.GetRequestWindows(
+        request, ctx.GetParameterRow(), union_inputs);
+    if (!window_cache_ || 1 != union_segments.size() || !union_segments[0] ||
+        ts_gen < 0 || Window::kFrameRowsRange != window_range.frame_type_) {
+        return union_segments;
+    }
+    uint64_t start = (ts_gen + window_range.start_offset_) < 0
+                         ? 0
+                         : (ts_gen + window_range.start_offset_);
+    auto key = windows_union_gen_.GetRequestKeys(request, ctx.GetParameterRow());
+    auto scan = window_cache_->Scan(key, union_segments[0].get(), start);
+    if (!scan) {
+        return union_segments;
+    }
+    // the window refers to the rows of the scan
+    ctx.KeepAlive(scan);
+    return {scan};
+}
+
+bool CachedWindowScan::CopyRow(const uint64_t key, const Row& row) {
+    if (row.GetRowPtrCnt() != 1) {
+        return false;
+    }
+    std::unique_ptr<int8_t[]> buf(new int8_t[row.size()]);
+    memcpy(buf.get(), row.buf(), row.size());
+    AddRow(key, Row(base::RefCountedSlice::Create(buf.get(), row.size())));
+    bufs_.push_back(std::move(buf));
+    return true;
+}
+
+std::shared_ptr<CachedWindowScan> WindowScanCache::Scan(const std::string& key,
+                                                        TableHandler* segment,
+                                                        const uint64_t start) {
+    uint64_t version = 0;
+    if (!segment->GetVersion(&version)) {
+        return std::shared_ptr<CachedWindowScan>();
+    }
+    // the scanned rows before the expire time may be gone in the segment
+    uint64_t expire_time = 0;
+    if (segment->GetExpireTime(&expire_time) && start <= expire_time) {
+        return std::shared_ptr<CachedWindowScan>();
+    }
+    auto scan = Get(key, version, start);
+    if (scan) {
+        return scan;
+    }
+    scan = std::make_shared<CachedWindowScan>(version, start);
+    auto iter = segment->GetIterator();
+    if (iter) {
+        iter->SeekToFirst();
+        while (iter->Valid() && iter->GetKey() >= start) {
+            if (!scan->CopyRow(iter->GetKey(), iter->GetValue())) {
+                return std::shared_ptr<CachedWindowScan>();
+            }
+            iter->Next();
+        }
+    }
+    // rows may be put during the scan, which are not sure to be scanned
+    uint64_t scanned_version = 0;
+    if (segment->GetVersion(&scanned_version) && scanned_version == version) {
+        Put(key, scan);
+    }
+    return scan;
+}
+
+std::shared_ptr<CachedWindowScan> WindowScanCache::Get(const std::string& key,
+                                                       const uint64_t version,
+                                                       const uint64_t start) {
+    std::lock_guard<base::SpinMutex> lock(mu_);
+    auto iter = index_.find(key);
+    if (iter == index_.end()) {
+        return std::shared_ptr<CachedWindowScan>();
+    }
+    auto& scan = iter->second->second;
+    if (scan->version() != version || start < scan->start()) {
+        return std::shared_ptr<CachedWindowScan>();
+    }
+    scans_.splice(scans_.begin(), scans_, iter->second);
+    return scan;
+}
+
+void WindowScanCache::Put(const std::string& key,
+                          std::shared_ptr<CachedWindowScan> scan) {
+    if (0 == capacity_) {
+        return;
+    }
+    // the replaced scan is released out of the lock
+    std::shared_ptr<CachedWindowScan> replaced;
+    std::lock_guard<base::SpinMutex> lock(mu_);
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+        replaced = std::move(iter->second->second);
+        iter->second->second = scan;
+        scans_.splice(scans_.begin(), scans_, iter->second);
+        return;
+    }
+    if (scans_.size() >= capacity_) {
+        replaced = std::move(scans_.back().second);
+        index_.erase(scans_.back().first);
+        scans_.pop_back();
+    }
+    scans_.emplace_front(key, scan);
+    index_.emplace(key, scans_.begin());
+}
+
+const size_t WindowScanCache::size() {
+    std::lock_guard<base::SpinMutex> lock(mu_);
+    return scans_.size();
+}
+
 std::shared_ptr<TableHandler> RequestUnionRunner::RequestUnionWindow(
     const Row& request,
     std::vector<std::shared_ptr<TableHandler>> union_segments, int64_t ts_gen,
@@ -3116,6 +3571,54 @@ std::shared_ptr<TableHandler> RequestUnionRunner::RequestUnionWindow(
         cnt++;
     }
 
+    // Single segment over a storage iterator which gathers rows in batch:
+    // no merging is required, scan it without the per row virtual calls
+    codec::BatchRowIterator* batch_iter =
+        1 == unions_cnt && -1 != max_union_pos
+            ? dynamic_cast<codec::BatchRowIterator*>(
+                  union_segment_iters[0].get())
+            : nullptr;
+    if (nullptr != batch_iter) {
+        const size_t kBatchSize = 64;
+        codec::RowRef batch[kBatchSize];
+        bool finished = false;
+        while (!finished) {
+            size_t batch_size = kBatchSize;
+            if (max_size > 0) {
+                if (cnt >= max_size) {
+                    break;
+                }
+                batch_size =
+                    std::min(batch_size, static_cast<size_t>(max_size - cnt));
+            }
+            size_t gathered = batch_iter->GetBatch(batch, batch_size);
+            if (0 == gathered) {
+                break;
+            }
+            for (size_t i = 0; i < gathered; i++) {
+                if (max_size > 0 && cnt >= max_size) {
+                    finished = true;
+                    break;
+                }
+                auto range_status = window_range.GetWindowPositionStatus(
+                    cnt > rows_start_preceding, batch[i].key > end,
+                    batch[i].key < start);
+                if (WindowRange::kExceedWindow == range_status) {
+                    finished = true;
+                    break;
+                }
+                if (WindowRange::kInWindow == range_status) {
+                    Row row;
+                    row.Reset(batch[i].buf, batch[i].size);
+                    window_table->AddRow(batch[i].key, row);
+                    cnt++;
+                }
+            }
+        }
+        DLOG(INFO) << "REQUEST UNION cnt = " << window_table->GetCount();
+        return window_table;
+    }
+
     while (-1 != max_union_pos) {
         if (max_size > 0 && cnt >= max_size) {
             break;
@@ -3212,6 +3715,7 @@ std::shared_ptr<DataHandlerList> ProxyRequestRunner::BatchRequestRun(
             return cached;
         }
     }
+    RunnerProfileScope profile_scope(ctx, this);
     std::shared_ptr<DataHandlerList> proxy_batch_input =
         producers_[0]->BatchRequestRun(ctx);
     std::shared_ptr<DataHandlerList> index_key_input =
@@ -3250,6 +3754,7 @@ std::shared_ptr<DataHandlerList> ProxyRequestRunner::BatchRequestRun(
         }
         auto repeated_data = std::shared_ptr<DataHandlerList>(
             new DataHandlerRepeater(res->Get(0), proxy_batch_input->GetSize()));
+        profile_scope.SetOutput(repeated_data);
         if (need_cache_) {
             ctx.SetBatchCache(id_, repeated_data);
         }
@@ -3259,6 +3764,7 @@ std::shared_ptr<DataHandlerList> ProxyRequestRunner::BatchRequestRun(
     // if not need batch cache
     // compute each line
     auto outputs = RunBatchInput(ctx, proxy_batch_input, index_key_input);
+    profile_scope.SetOutput(outputs);
     if (ctx.is_debug()) {
         std::ostringstream oss;
         oss << "RUNNER TYPE: " << RunnerTypeName(type_) << ", ID: " << id_
@@ -3741,7 +4247,14 @@ Row Runner::GroupbyProject(const int8_t* fn, const codec::Row& parameter, TableH
     window_ref.list = reinterpret_cast<int8_t*>(table);
     auto window_ptr = reinterpret_cast<const int8_t*>(&window_ref);
 
+    // Init current run step runtime
+    JitRuntime::get()->InitRunStep();
+
     uint32_t ret = udf(row_key, row_ptr, window_ptr, parameter_ptr, &buf);
+
+    // Release current run step resources
+    JitRuntime::get()->ReleaseRunStep();
+
     if (ret != 0) {
         LOG(WARNING) << "fail to run udf " << ret;
         return Row();
@@ -3934,6 +4447,9 @@ std::shared_ptr<DataHandler> FilterGenerator::Filter(
     if (!condition_gen_.Valid()) {
         return table;
     }
+    if (range_scan_.Valid()) {
+        return std::shared_ptr<TableHandler>(new TableFilterWrapper(table, parameter, this, &range_scan_));
+    }
     return std::shared_ptr<TableHandler>(new TableFilterWrapper(table, parameter, this));
 }
 
@@ -3966,6 +4482,20 @@ void RunnerContext::SetCache(int64_t id,
     cache_[id] = data;
 }
 
+std::shared_ptr<TableHandler> RunnerContext::GetWindowScan(
+    int64_t id, const Row& request) const {
+    auto iter = window_scan_cache_.find(std::make_pair(id, request.buf()));
+    if (iter == window_scan_cache_.end()) {
+        return std::shared_ptr<TableHandler>();
+    }
+    return iter->second;
+}
+
+void RunnerContext::SetWindowScan(int64_t id, const Row& request,
+                                  std::shared_ptr<TableHandler> window) {
+    window_scan_cache_[std::make_pair(id, request.buf())] = window;
+}
+
 void RunnerContext::SetRequest(const hybridse::codec::Row& request) {
     request_ = request;
 }
@@ -17,6 +17,7 @@
 #ifndef HYBRIDSE_SRC_VM_RUNNER_H_
 #define HYBRIDSE_SRC_VM_RUNNER_H_
 
+#include <list>
 #include <map>
 #include <memory>
 #include <set>
@@ -25,6 +26,7 @@
 #include <utility>
 #include <vector>
 #include "base/fe_status.h"
+#include "base/spin_lock.h"
 #include "codec/fe_row_codec.h"
 #include "node/node_manager.h"
 #include "vm/aggregator.h"
@@ -33,6 +35,7 @@
 #include "vm/core_api.h"
 #include "vm/mem_catalog.h"
 #include "vm/physical_op.h"
+#include "vm/profile.h"
 namespace hybridse {
 namespace vm {
 
@@ -47,6 +50,7 @@ using vm::Window;
 
 class Runner;
 class RunnerContext;
+class RunnerProfileScope;
 class FnGenerator {
  public:
     explicit FnGenerator(const FnInfo& info)
@@ -256,7 +260,8 @@ class FilterGenerator : public PredicateFun {
  public:
     explicit FilterGenerator(const Filter& filter)
         : condition_gen_(filter.condition_.fn_info()),
-          index_seek_gen_(filter.index_key_) {}
+          index_seek_gen_(filter.index_key_),
+          range_scan_(filter.range_scan_) {}
 
     const bool Valid() const {
         return index_seek_gen_.Valid() || condition_gen_.Valid();
@@ -275,6 +280,7 @@ class FilterGenerator : public PredicateFun {
  private:
     ConditionGenerator condition_gen_;
     IndexSeekGenerator index_seek_gen_;
+    ColumnRange range_scan_;
 };
 class WindowGenerator {
  public:
@@ -637,6 +643,22 @@ class RequestWindowUnionGenerator : public InputsGenerator {
         }
         return union_segments;
     }
+    // Return the keys locating request windows of `row`, rows with the same
+    // keys share the same request windows
+    std::string GetRequestKeys(const Row& row, const Row& parameter) {
+        std::string keys;
+        for (auto& window_gen : windows_gen_) {
+            std::string key =
+                window_gen.index_seek_gen_.Valid()
+                    ? window_gen.index_seek_gen_.index_key_gen_.Gen(row,
+                                                                    parameter)
+                    : "";
+            key.append("|").append(
+                window_gen.filter_gen_.GetKey(row, parameter));
+            keys.append(std::to_string(key.size())).append(":").append(key);
+        }
+        return keys;
+    }
     std::vector<RequestWindowGenertor> windows_gen_;
 };
 class JoinGenerator {
@@ -945,6 +967,87 @@ class WindowAggRunner : public Runner {
     WindowProjectGenerator window_project_gen_;
 };
 
+/// \brief The rows of a segment not earlier than `start`, copied from the
+/// storage and kept across requests by WindowScanCache.
+///
+/// The rows refer to the buffers owned by the scan, so windows cut from it
+/// are valid while the scan is alive.
+class CachedWindowScan : public MemTimeTableHandler {
+ public:
+    CachedWindowScan(const uint64_t version, const uint64_t start)
+        : MemTimeTableHandler(), version_(version), start_(start) {}
+    /// Copy the data of `row` into the scan and append it.
+    /// Return false if the row has more than one slice.
+    bool CopyRow(const uint64_t key, const Row& row);
+    const uint64_t version() const { return version_; }
+    const uint64_t start() const { return start_; }
+
+ private:
+    const uint64_t version_;
+    const uint64_t start_;
+    std::vector<std::unique_ptr<int8_t[]>> bufs_;
+};
+
+/// \brief A LRU cache of the window scans of a RequestUnionRunner, keyed by
+/// the keys locating the request windows.
+///
+/// It is shared by all requests of a deployment. A cached scan is valid as
+/// long as the version of the segment it is copied from is unchanged, see
+/// TableHandler::GetVersion, so the storage is scanned again only after rows
+/// of the key are put or removed. Rows also expire by time without changing
+/// the version, a scan only serves the windows starting after the expire
+/// time of the segment, see TableHandler::GetExpireTime.
+class WindowScanCache {
+ public:
+    explicit WindowScanCache(const size_t capacity) : capacity_(capacity) {}
+    /// Return the scan of `segment` from `start`, which is located by `key`.
+    /// The segment is scanned and the scan is put if it is not cached.
+    /// Return null if the rows of the segment can not be cached.
+    std::shared_ptr<CachedWindowScan> Scan(const std::string& key,
+                                           TableHandler* segment,
+                                           const uint64_t start);
+    /// Return the scan of `key` at `version` which covers the rows from
+    /// `start`, or null if there is no such scan.
+    std::shared_ptr<CachedWindowScan> Get(const std::string& key,
+                                          const uint64_t version,
+                                          const uint64_t start);
+    /// Put the scan of `key`, it replaces the older scan of the key.
+    void Put(const std::string& key, std::shared_ptr<CachedWindowScan> scan);
+    const size_t size();
+
+ private:
+    typedef std::list<
+        std::pair<std::string, std::shared_ptr<CachedWindowScan>>>
+        ScanList;
+    const size_t capacity_;
+    base::SpinMutex mu_;
+    // the most recently used scan is at front
+    ScanList scans_;
+    std::unordered_map<std::string, ScanList::iterator> index_;
+};
+
+/// \brief A window scan shared by RequestUnionRunners which read the same
+/// partition in the same order and whose frames end at the same position.
+///
+/// The scan covers the union of their frames, every runner derives its own
+/// window from the scan result instead of iterating the storage again.
+class SharedWindowScan {
+ public:
+    SharedWindowScan(const int64_t id, const WindowRange& window_range)
+        : id_(id), window_range_(window_range), runners_cnt_(1) {}
+    /// Widen the scan to cover `window_range` too.
+    /// Return false if the frames can't be covered by a single scan.
+    bool Merge(const WindowRange& window_range);
+    const int64_t id() const { return id_; }
+    const WindowRange& window_range() const { return window_range_; }
+    const size_t runners_cnt() const { return runners_cnt_; }
+
+ private:
+    const int64_t id_;
+    WindowRange window_range_;
+    size_t runners_cnt_;
+};
+
 class RequestUnionRunner : public Runner {
  public:
     RequestUnionRunner(const int32_t id, const SchemasContext* schema,
@@ -959,6 +1062,8 @@ class RequestUnionRunner : public Runner {
         RunnerContext& ctx,  // NOLINT
         const std::vector<std::shared_ptr<DataHandler>>& inputs)
         override;  // NOLINT
+    std::shared_ptr<DataHandlerList> BatchRequestRun(
+        RunnerContext& ctx) override;  // NOLINT
     static std::shared_ptr<TableHandler> RequestUnionWindow(
         const Row& request,
         std::vector<std::shared_ptr<TableHandler>> union_segments,
@@ -967,10 +1072,24 @@ class RequestUnionRunner : public Runner {
     void AddWindowUnion(const RequestWindowOp& window, Runner* runner) {
         windows_union_gen_.AddWindowUnion(window, runner);
     }
+    void SetSharedWindowScan(std::shared_ptr<SharedWindowScan> scan) {
+        shared_scan_ = scan;
+    }
+    /// Keep the window scans of at most `capacity` keys across requests.
+    void SetWindowScanCache(const size_t capacity) {
+        window_cache_ = std::make_shared<WindowScanCache>(capacity);
+    }
     RequestWindowUnionGenerator windows_union_gen_;
     RangeGenerator range_gen_;
     bool exclude_current_time_;
     bool output_request_row_;
+    std::shared_ptr<SharedWindowScan> shared_scan_;
+    std::shared_ptr<WindowScanCache> window_cache_;
+
+ private:
+    std::vector<std::shared_ptr<TableHandler>> GetUnionSegments(
+        RunnerContext& ctx, const Row& request, int64_t ts_gen,  // NOLINT
+        const WindowRange& window_range);
 };
 
 class RequestAggUnionRunner : public Runner {
@@ -1431,6 +1550,7 @@ class RunnerBuilder {
                                Status& status) {  // NOLINT
         id_ = 0;
         cluster_job_.Reset();
+        window_scans_.clear();
         auto task =  // NOLINT whitespace/braces
             Build(node, status);
         if (!status.isOK()) {
@@ -1459,6 +1579,12 @@ class RunnerBuilder {
         return cluster_job_;
     }
 
+    /// Cache the window scans of at most `size` keys for every request union
+    /// runner across requests, 0 disables the cache.
+    void SetWindowScanCacheSize(const size_t size) {
+        window_scan_cache_size_ = size;
+    }
+
     template <typename Op, typename... Args>
     void CreateRunner(Op** result_runner, Args&&... args) {
         Op* runner = new Op(std::forward<Args>(args)...);
@@ -1478,6 +1604,11 @@ class RunnerBuilder {
     std::unordered_map<hybridse::vm::Runner*, ::hybridse::vm::Runner*>
         proxy_runner_map_;
     std::set<size_t> batch_common_node_set_;
+    // request union runners sharing window scan, keyed by the scan source
+    std::map<std::string, std::shared_ptr<SharedWindowScan>> window_scans_;
+    size_t window_scan_cache_size_ = 0;
+    void ShareWindowScan(const PhysicalRequestUnionNode* op,
+                         RequestUnionRunner* runner);
     ClusterTask BuildLocalTaskForMultipleRunner(const std::vector<const ClusterTask*>& chidlren, Runner* runner);
     ClusterTask BinaryInherit(const ClusterTask& left, const ClusterTask& right,
                               Runner* runner, const Key& index_key,
@@ -1545,13 +1676,30 @@ class RunnerContext {
     void SetRequest(const hybridse::codec::Row& request);
     void SetRequests(const std::vector<hybridse::codec::Row>& requests);
     bool is_debug() const { return is_debug_; }
+    /// Collect runner statistics into `profile`, profiling is off if it is null
+    void SetProfile(RunProfile* profile) { profile_ = profile; }
+    RunProfile* profile() const { return profile_; }
 
     const std::string& sp_name() { return sp_name_; }
     std::shared_ptr<DataHandler> GetCache(int64_t id) const;
     void SetCache(int64_t id, std::shared_ptr<DataHandler> data);
-    void ClearCache() { cache_.clear(); }
+    void ClearCache() {
+        cache_.clear();
+        window_scan_cache_.clear();
+        kept_data_.clear();
+    }
+    /// Keep `data` alive until the cache is cleared, for the outputs which
+    /// refer to it
+    void KeepAlive(std::shared_ptr<DataHandler> data) {
+        kept_data_.push_back(data);
+    }
     std::shared_ptr<DataHandlerList> GetBatchCache(int64_t id) const;
     void SetBatchCache(int64_t id, std::shared_ptr<DataHandlerList> data);
+    /// Return the result of shared window scan `id` for given request row
+    std::shared_ptr<TableHandler> GetWindowScan(int64_t id,
+                                                const Row& request) const;
+    void SetWindowScan(int64_t id, const Row& request,
+                       std::shared_ptr<TableHandler> window);
 
  private:
     hybridse::vm::ClusterJob* cluster_job_;
@@ -1564,6 +1712,39 @@ class RunnerContext {
     // TODO(chenjing): optimize
     std::map<int64_t, std::shared_ptr<DataHandler>> cache_;
     std::map<int64_t, std::shared_ptr<DataHandlerList>> batch_cache_;
+    std::map<std::pair<int64_t, const int8_t*>, std::shared_ptr<TableHandler>>
+        window_scan_cache_;
+    std::vector<std::shared_ptr<DataHandler>> kept_data_;
+    RunProfile* profile_ = nullptr;
+    // the innermost runner being profiled
+    RunnerProfileScope* profile_scope_ = nullptr;
+    friend class RunnerProfileScope;
+};
+
+/// \brief Record one call of a runner into the profile of the running context.
+///
+/// Scopes of producers nest in the scope of their consumer, the time and
+/// storage counters of the nested scopes are subtracted so that every runner
+/// is charged with its own work only. It does nothing if profiling is off.
+class RunnerProfileScope {
+ public:
+    RunnerProfileScope(RunnerContext& ctx, const Runner* runner);  // NOLINT
+    ~RunnerProfileScope();
+    void SetInputs(const std::vector<std::shared_ptr<DataHandler>>& inputs);
+    void SetInputs(const std::vector<std::shared_ptr<DataHandlerList>>& inputs);
+    void SetOutput(const std::shared_ptr<DataHandler>& output);
+    void SetOutput(const std::shared_ptr<DataHandlerList>& outputs);
+
+ private:
+    RunnerContext& ctx_;
+    RunnerProfile* profile_;
+    // the counters the storage of the run counts into
+    const ProfileCounters* run_counters_;
+    RunnerProfileScope* parent_;
+    uint64_t start_ns_;
+    ProfileCounters start_counters_;
+    uint64_t child_ns_;
+    ProfileCounters child_counters_;
 };
 }  // namespace vm
 }  // namespace hybridse
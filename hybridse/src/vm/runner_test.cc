@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 #include "boost/algorithm/string.hpp"
 #include "case/sql_case.h"
 #include "gtest/gtest.h"
@@ -522,6 +523,277 @@ TEST_F(RunnerTest, RunnerPrintDataMemTimeTableTest) {
         LOG(INFO) << oss.str();
     }
 }
+
+TEST_F(RunnerTest, SharedWindowScanTest) {
+    std::vector<Row> rows;
+    hybridse::type::TableDef temp_table;
+    BuildRows(temp_table, rows);
+    auto segment = std::make_shared<MemTimeTableHandler>();
+    for (uint64_t ts = 100; ts > 0; ts--) {
+        segment->AddRow(ts, rows[ts % rows.size()]);
+    }
+    std::vector<WindowRange> window_ranges = {
+        WindowRange::CreateRowsRangeWindow(-10, 0),
+        WindowRange::CreateRowsWindow(20),
+        WindowRange::CreateRowsRangeWindow(-50, 0, 30),
+        WindowRange::CreateRowsMergeRowsRangeWindow(-5, 8)};
+    SharedWindowScan scan(0, window_ranges[0]);
+    for (size_t i = 1; i < window_ranges.size(); i++) {
+        ASSERT_TRUE(scan.Merge(window_ranges[i]));
+    }
+    ASSERT_EQ(window_ranges.size(), scan.runners_cnt());
+    ASSERT_EQ(Window::kFrameRowsMergeRowsRange, scan.window_range().frame_type_);
+    ASSERT_EQ(-50, scan.window_range().start_offset_);
+    ASSERT_EQ(20u, scan.window_range().start_row_);
+    ASSERT_EQ(0u, scan.window_range().max_size_);
+    // frames end at different position
+    ASSERT_FALSE(scan.Merge(WindowRange::CreateRowsRangeWindow(-10, -1)));
+
+    int64_t ts_gen = 100;
+    auto scan_table = RequestUnionRunner::RequestUnionWindow(
+        rows[0], {segment}, ts_gen, scan.window_range(), false, false);
+    for (auto& window_range : window_ranges) {
+        auto expect = RequestUnionRunner::RequestUnionWindow(
+            rows[0], {segment}, ts_gen, window_range, true, false);
+        auto window = RequestUnionRunner::RequestUnionWindow(
+            rows[0], {scan_table}, ts_gen, window_range, true, false);
+        ASSERT_EQ(expect->GetCount(), window->GetCount());
+        auto expect_iter = expect->GetIterator();
+        auto iter = window->GetIterator();
+        expect_iter->SeekToFirst();
+        iter->SeekToFirst();
+        while (expect_iter->Valid()) {
+            ASSERT_TRUE(iter->Valid());
+            ASSERT_EQ(expect_iter->GetKey(), iter->GetKey());
+            expect_iter->Next();
+            iter->Next();
+        }
+    }
+}
+
+TEST_F(RunnerTest, WindowScanCacheTest) {
+    std::vector<Row> rows;
+    hybridse::type::TableDef temp_table;
+    BuildRows(temp_table, rows);
+    auto scan = std::make_shared<CachedWindowScan>(1, 50);
+    for (uint64_t ts = 100; ts >= 50; ts--) {
+        ASSERT_TRUE(scan->CopyRow(ts, rows[ts % rows.size()]));
+    }
+    ASSERT_EQ(51u, scan->GetCount());
+    // the rows are copied
+    ASSERT_NE(rows[100 % rows.size()].buf(), scan->At(0).buf());
+    ASSERT_EQ(0, rows[100 % rows.size()].compare(scan->At(0)));
+
+    WindowScanCache cache(2);
+    cache.Put("k1", scan);
+    ASSERT_EQ(scan, cache.Get("k1", 1, 50));
+    ASSERT_EQ(scan, cache.Get("k1", 1, 80));
+    // the scan doesn't cover the frame
+    ASSERT_FALSE(cache.Get("k1", 1, 49));
+    // rows of the key changed
+    ASSERT_FALSE(cache.Get("k1", 2, 50));
+    ASSERT_FALSE(cache.Get("k2", 1, 50));
+
+    auto new_scan = std::make_shared<CachedWindowScan>(2, 40);
+    cache.Put("k1", new_scan);
+    ASSERT_EQ(1u, cache.size());
+    ASSERT_EQ(new_scan, cache.Get("k1", 2, 50));
+    cache.Put("k2", std::make_shared<CachedWindowScan>(1, 0));
+    ASSERT_TRUE(cache.Get("k1", 2, 50));
+    // the least recently used scan is evicted
+    cache.Put("k3", std::make_shared<CachedWindowScan>(1, 0));
+    ASSERT_EQ(2u, cache.size());
+    ASSERT_FALSE(cache.Get("k2", 1, 0));
+    ASSERT_TRUE(cache.Get("k1", 2, 50));
+
+    // windows cut from the cached scan are the same as from the segment
+    auto segment = std::make_shared<MemTimeTableHandler>();
+    for (uint64_t ts = 100; ts > 0; ts--) {
+        segment->AddRow(ts, rows[ts % rows.size()]);
+    }
+    auto window_range = WindowRange::CreateRowsRangeWindow(-30, 0, 20);
+    auto expect = RequestUnionRunner::RequestUnionWindow(
+        rows[0], {segment}, 90, window_range, true, false);
+    auto window = RequestUnionRunner::RequestUnionWindow(
+        rows[0], {scan}, 90, window_range, true, false);
+    ASSERT_EQ(expect->GetCount(), window->GetCount());
+    for (uint64_t i = 0; i < expect->GetCount(); i++) {
+        ASSERT_EQ(0, expect->At(i).compare(window->At(i)));
+    }
+}
+
+// A segment with a version whose rows expire by time like the storage
+class ExpiringSegmentHandler : public MemTimeTableHandler {
+ public:
+    bool GetVersion(uint64_t* version) override {
+        *version = version_;
+        return true;
+    }
+    bool GetExpireTime(uint64_t* expire_time) override {
+        *expire_time = expire_time_;
+        return expire_time_ > 0;
+    }
+    std::unique_ptr<RowIterator> GetIterator() override {
+        auto alive = std::make_shared<MemTimeTableHandler>();
+        auto iter = MemTimeTableHandler::GetIterator();
+        iter->SeekToFirst();
+        while (iter->Valid() && iter->GetKey() > expire_time_) {
+            alive->AddRow(iter->GetKey(), iter->GetValue());
+            iter->Next();
+        }
+        alives_.push_back(alive);
+        return alive->GetIterator();
+    }
+    uint64_t version_ = 1;
+    uint64_t expire_time_ = 0;
+    std::vector<std::shared_ptr<MemTimeTableHandler>> alives_;
+};
+
+TEST_F(RunnerTest, WindowScanCacheExpireTest) {
+    std::vector<Row> rows;
+    hybridse::type::TableDef temp_table;
+    BuildRows(temp_table, rows);
+    auto segment = std::make_shared<ExpiringSegmentHandler>();
+    for (uint64_t ts = 100; ts > 0; ts--) {
+        segment->AddRow(ts, rows[ts % rows.size()]);
+    }
+    segment->expire_time_ = 10;
+    WindowScanCache cache(4);
+    auto scan = cache.Scan("k1", segment.get(), 40);
+    ASSERT_TRUE(scan);
+    ASSERT_EQ(61u, scan->GetCount());
+    ASSERT_EQ(scan, cache.Scan("k1", segment.get(), 50));
+
+    // rows up to 60 expire without changing the version, the scan keeps
+    // them, so it no longer serves windows from 60
+    segment->expire_time_ = 60;
+    ASSERT_FALSE(cache.Scan("k1", segment.get(), 50));
+    ASSERT_FALSE(cache.Scan("k1", segment.get(), 60));
+    auto window_range = WindowRange::CreateRowsRangeWindow(-40, 0);
+    std::vector<std::shared_ptr<TableHandler>> union_segments = {segment};
+    auto window = RequestUnionRunner::RequestUnionWindow(
+        rows[0], union_segments, 100, window_range, true, false);
+    // the request row and the alive rows in [61, 100]
+    ASSERT_EQ(41u, window->GetCount());
+    // the cached rows from 61 are still alive
+    ASSERT_EQ(scan, cache.Scan("k1", segment.get(), 61));
+    window_range = WindowRange::CreateRowsRangeWindow(-30, 0);
+    auto expect = RequestUnionRunner::RequestUnionWindow(
+        rows[0], union_segments, 91, window_range, true, false);
+    window = RequestUnionRunner::RequestUnionWindow(rows[0], {scan}, 91,
+                                                     window_range, true, false);
+    ASSERT_EQ(32u, window->GetCount());
+    ASSERT_EQ(expect->GetCount(), window->GetCount());
+    for (uint64_t i = 0; i < expect->GetCount(); i++) {
+        ASSERT_EQ(0, expect->At(i).compare(window->At(i)));
+    }
+
+    // the rows do not expire by time
+    segment->expire_time_ = 0;
+    ASSERT_EQ(scan, cache.Scan("k1", segment.get(), 40));
+    ASSERT_NE(scan, cache.Scan("k1", segment.get(), 30));
+}
+
+// Gathers the rows of a MemTimeTableHandler in batch like the storage
+// iterators, it records the size of every GetBatch call
+class BatchIterator : public codec::BatchRowIterator {
+ public:
+    BatchIterator(std::unique_ptr<RowIterator> it,
+                  std::vector<size_t>* batch_sizes)
+        : it_(std::move(it)), batch_sizes_(batch_sizes) {}
+    bool Valid() const override { return it_->Valid(); }
+    void Next() override { it_->Next(); }
+    const uint64_t& GetKey() const override { return it_->GetKey(); }
+    const Row& GetValue() override { return it_->GetValue(); }
+    bool IsSeekable() const override { return it_->IsSeekable(); }
+    void Seek(const uint64_t& key) override { it_->Seek(key); }
+    void SeekToFirst() override { it_->SeekToFirst(); }
+    size_t GetBatch(codec::RowRef* batch, size_t max_size) override {
+        batch_sizes_->push_back(max_size);
+        size_t cnt = 0;
+        while (cnt < max_size && Valid()) {
+            batch[cnt].key = GetKey();
+            batch[cnt].buf = GetValue().buf();
+            batch[cnt].size = GetValue().size();
+            cnt++;
+            Next();
+        }
+        return cnt;
+    }
+
+ private:
+    std::unique_ptr<RowIterator> it_;
+    std::vector<size_t>* batch_sizes_;
+};
+
+class BatchSegmentHandler : public MemTimeTableHandler {
+ public:
+    std::unique_ptr<RowIterator> GetIterator() override {
+        return std::make_unique<BatchIterator>(
+            MemTimeTableHandler::GetIterator(), &batch_sizes_);
+    }
+    std::vector<size_t> batch_sizes_;
+};
+
+TEST_F(RunnerTest, RequestUnionWindowBatchTest) {
+    std::vector<Row> rows;
+    hybridse::type::TableDef temp_table;
+    BuildRows(temp_table, rows);
+    auto segment = std::make_shared<MemTimeTableHandler>();
+    auto batch_segment = std::make_shared<BatchSegmentHandler>();
+    for (uint64_t ts = 200; ts > 0; ts--) {
+        segment->AddRow(ts, rows[ts % rows.size()]);
+        batch_segment->AddRow(ts, rows[ts % rows.size()]);
+    }
+    std::vector<WindowRange> window_ranges = {
+        WindowRange::CreateRowsRangeWindow(-10, 0),
+        WindowRange::CreateRowsRangeWindow(-30, -5),
+        // longer than a batch
+        WindowRange::CreateRowsRangeWindow(-150, 0),
+        WindowRange::CreateRowsWindow(20),
+        WindowRange::CreateRowsWindow(100),
+        // max size smaller than a batch and across batches
+        WindowRange::CreateRowsRangeWindow(-50, 0, 5),
+        WindowRange::CreateRowsRangeWindow(-150, 0, 70),
+        WindowRange::CreateRowsMergeRowsRangeWindow(-5, 8),
+        WindowRange::CreateRowsMergeRowsRangeWindow(-100, 80, 90)};
+    for (auto& window_range : window_ranges) {
+        for (int64_t ts_gen : {200, 120, 30, 250, -1}) {
+            for (bool exclude_current_time : {false, true}) {
+                batch_segment->batch_sizes_.clear();
+                auto expect = RequestUnionRunner::RequestUnionWindow(
+                    rows[0], {segment}, ts_gen, window_range, true,
+                    exclude_current_time);
+                auto window = RequestUnionRunner::RequestUnionWindow(
+                    rows[0], {batch_segment}, ts_gen, window_range, true,
+                    exclude_current_time);
+                ASSERT_FALSE(batch_segment->batch_sizes_.empty());
+                for (auto size : batch_segment->batch_sizes_) {
+                    ASSERT_GT(size, 0u);
+                    if (window_range.max_size_ > 0) {
+                        ASSERT_LE(size, window_range.max_size_);
+                    }
+                }
+                ASSERT_EQ(expect->GetCount(), window->GetCount())
+                    << "ts_gen " << ts_gen << " start "
+                    << window_range.start_offset_;
+                auto expect_iter = expect->GetIterator();
+                auto iter = window->GetIterator();
+                expect_iter->SeekToFirst();
+                iter->SeekToFirst();
+                while (expect_iter->Valid()) {
+                    ASSERT_TRUE(iter->Valid());
+                    ASSERT_EQ(expect_iter->GetKey(), iter->GetKey());
+                    ASSERT_EQ(0,
+                              expect_iter->GetValue().compare(iter->GetValue()));
+                    expect_iter->Next();
+                    iter->Next();
+                }
+                ASSERT_FALSE(iter->Valid());
+            }
+        }
+    }
+}
 }  // namespace vm
 }  // namespace hybridse
 
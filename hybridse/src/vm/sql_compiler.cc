@@ -18,6 +18,7 @@
 #include <memory>
 #include <utility>
 #include <vector>
+#include "absl/strings/numbers.h"
 #include "boost/filesystem.hpp"
 #include "boost/filesystem/string_file.hpp"
 #include "codec/fe_schema_codec.h"
@@ -302,6 +303,15 @@ bool SqlCompiler::BuildClusterJob(SqlContext& ctx, Status& status) {  // NOLINT
                                  ctx.is_cluster_optimized && is_request_mode,
                                  ctx.batch_request_info.common_column_indices,
                                  ctx.batch_request_info.common_node_set);
+    if (is_request_mode && ctx.options && ctx.options->count(WINDOW_CACHE)) {
+        size_t window_cache_size = 0;
+        if (!absl::SimpleAtoi(ctx.options->at(WINDOW_CACHE), &window_cache_size)) {
+            status.msg = "invalid window_cache option: " + ctx.options->at(WINDOW_CACHE);
+            status.code = common::kExecutionPlanError;
+            return false;
+        }
+        runner_builder.SetWindowScanCacheSize(window_cache_size);
+    }
     ctx.cluster_job = runner_builder.BuildClusterJob(ctx.physical_plan, status);
     return status.isOK();
 }
@@ -18,6 +18,7 @@
 #define HYBRIDSE_SRC_VM_SQL_COMPILER_H_
 
 #include <memory>
+#include <mutex>  // NOLINT
 #include <set>
 #include <string>
 #include <vector>
@@ -30,6 +31,7 @@
 #include "vm/engine_context.h"
 #include "vm/jit_wrapper.h"
 #include "vm/physical_op.h"
+#include "vm/router.h"
 #include "vm/runner.h"
 
 namespace hybridse {
@@ -125,6 +127,25 @@ class SqlCompileInfo : public CompileInfo {
     virtual const hybridse::vm::PhysicalOpNode* GetPhysicalPlan() const {
         return sql_ctx.physical_plan;
     }
+    virtual int32_t GetRouterColIdx() const {
+        std::call_once(router_once_, [this]() {
+            Router router;
+            router.SetMainDb(sql_ctx.request_db_name);
+            router.SetMainTable(sql_ctx.request_name);
+            if (nullptr == sql_ctx.physical_plan ||
+                0 != router.Parse(sql_ctx.physical_plan)) {
+                return;
+            }
+            const auto& schema = sql_ctx.request_schema;
+            for (int32_t i = 0; i < schema.size(); i++) {
+                if (schema.Get(i).name() == router.GetRouterCol()) {
+                    router_col_idx_ = i;
+                    break;
+                }
+            }
+        });
+        return router_col_idx_;
+    }
     virtual hybridse::vm::Runner* GetMainTask() {
         return sql_ctx.cluster_job.GetMainTask().GetRoot();
     }
@@ -144,6 +165,8 @@ class SqlCompileInfo : public CompileInfo {
 
  private:
     hybridse::vm::SqlContext sql_ctx;
+    mutable std::once_flag router_once_;
+    mutable int32_t router_col_idx_ = -1;
 };
 
 class SqlCompiler {
@@ -34,6 +34,7 @@
 #include "passes/physical/left_join_optimized.h"
 #include "passes/physical/limit_optimized.h"
 #include "passes/physical/long_window_optimized.h"
+#include "passes/physical/range_filter_optimized.h"
 #include "passes/physical/simple_project_optimized.h"
 #include "passes/physical/split_aggregation_optimized.h"
 #include "passes/physical/window_column_pruning.h"
@@ -53,6 +54,7 @@ using hybridse::passes::LimitOptimized;
 using hybridse::passes::PhysicalPlanPassType;
 using hybridse::passes::SimpleProjectOptimized;
 using hybridse::passes::WindowColumnPruning;
+using hybridse::passes::RangeFilterOptimized;
 using hybridse::passes::LongWindowOptimized;
 using hybridse::passes::SplitAggregationOptimized;
 
@@ -950,6 +952,7 @@ bool BatchModeTransformer::AddDefaultPasses() {
     AddPass(PhysicalPlanPassType::kPassFilterOptimized);
     AddPass(PhysicalPlanPassType::kPassLeftJoinOptimized);
     AddPass(PhysicalPlanPassType::kPassGroupAndSortOptimized);
+    AddPass(PhysicalPlanPassType::kPassRangeFilterOptimized);
     AddPass(PhysicalPlanPassType::kPassLimitOptimized);
     AddPass(PhysicalPlanPassType::kPassClusterOptimized);
     return false;
@@ -1306,6 +1309,13 @@ void BatchModeTransformer::ApplyPasses(PhysicalOpNode* node,
                 }
                 break;
             }
+            case PhysicalPlanPassType::kPassRangeFilterOptimized: {
+                if (catalog_->IndexSupport()) {
+                    RangeFilterOptimized pass(&plan_ctx_);
+                    transformed = pass.Apply(cur_op, &new_op);
+                }
+                break;
+            }
             case PhysicalPlanPassType::kPassLeftJoinOptimized: {
                 if (catalog_->IndexSupport()) {
                     LeftJoinOptimized pass(&plan_ctx_);
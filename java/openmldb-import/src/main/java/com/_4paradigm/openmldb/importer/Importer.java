@@ -19,6 +19,7 @@ package com._4paradigm.openmldb.importer;
 import com._4paradigm.openmldb.proto.Common;
 import com._4paradigm.openmldb.proto.NS;
 import com._4paradigm.openmldb.proto.Tablet;
+import com._4paradigm.openmldb.proto.Type;
 import com._4paradigm.openmldb.sdk.SdkOption;
 import com._4paradigm.openmldb.sdk.SqlExecutor;
 import com._4paradigm.openmldb.sdk.impl.SqlClusterExecutor;
@@ -153,6 +154,14 @@ public class Importer {
             logger.error("table {}.{} meta data is not found", dbName, tableName);
             return;
         }
+        // keys are built as the column values joined with "|" in buildDimensions, memcomparable keys are built only by
+        // SQLInsertRow, so the rows would be put under keys the queries never seek
+        if (tableMetaData.getColumnKeyList().stream()
+                .anyMatch(key -> key.getKeyEncoding() == Type.KeyEncoding.kMemcomparableKey)) {
+            logger.error("table {}.{} has indexes with memcomparable key encoding, which are unsupported by bulk load, "
+                    + "use insert instead", dbName, tableName);
+            return;
+        }
 
         logger.debug(tableMetaData.toString());
         // TODO(hw): multi-threading insert into one MemTable? or threads num is less than MemTable size?
@@ -17,10 +17,10 @@
 #include "apiserver/api_server_impl.h"
 
 #include <memory>
-#include <set>
 #include <string>
 
 #include "apiserver/interface_provider.h"
+#include "brpc/http_status_code.h"
 #include "brpc/server.h"
 
 namespace openmldb {
@@ -64,6 +64,8 @@ void APIServerImpl::Refresh(google::protobuf::RpcController* cntl_base, const Ht
     if (sql_router_) {
         sql_router_->RefreshCatalog();
     }
+    std::lock_guard<std::mutex> lock(plan_mu_);
+    procedure_plans_.clear();
 }
 
 void APIServerImpl::Process(google::protobuf::RpcController* cntl_base, const HttpRequest*, HttpResponse*,
@@ -78,51 +80,21 @@ void APIServerImpl::Process(google::protobuf::RpcController* cntl_base, const Ht
     const butil::IOBuf& req_body = cntl->request_attachment();
 
     JsonWriter writer;
-    provider_.handle(unresolved_path, method, req_body, writer);
-
-    cntl->response_attachment().append(writer.GetString());
-}
-
-bool APIServerImpl::Json2SQLRequestRow(const butil::rapidjson::Value& non_common_cols_v,
-                                       const butil::rapidjson::Value& common_cols_v,
-                                       std::shared_ptr<openmldb::sdk::SQLRequestRow> row) {
-    auto sch = row->GetSchema();
-
-    // scan all strings to init the total string length
-    decltype(common_cols_v.Size()) str_len_sum = 0;
-    decltype(common_cols_v.Size()) non_common_idx = 0, common_idx = 0;
-    for (decltype(sch->GetColumnCnt()) i = 0; i < sch->GetColumnCnt(); ++i) {
-        // if element is null, GetStringLength() will get 0
-        if (sch->IsConstant(i)) {
-            if (sch->GetColumnType(i) == hybridse::sdk::kTypeString) {
-                str_len_sum += common_cols_v[common_idx].GetStringLength();
-            }
-            ++common_idx;
-        } else {
-            if (sch->GetColumnType(i) == hybridse::sdk::kTypeString) {
-                str_len_sum += non_common_cols_v[non_common_idx].GetStringLength();
-            }
-            ++non_common_idx;
+    if (IsBinaryRowContentType(cntl->http_request().content_type())) {
+        butil::IOBuf resp_body;
+        int status_code = brpc::HTTP_STATUS_OK;
+        provider_.handle_binary(unresolved_path, method, req_body, &resp_body, &status_code, writer);
+        cntl->http_response().set_status_code(status_code);
+        if (!resp_body.empty()) {
+            cntl->http_response().set_content_type(kBinaryRowContentType);
+            cntl->response_attachment().swap(resp_body);
+            return;
         }
+    } else {
+        provider_.handle(unresolved_path, method, req_body, writer);
     }
-    row->Init(static_cast<int32_t>(str_len_sum));
 
-    non_common_idx = 0, common_idx = 0;
-    for (decltype(sch->GetColumnCnt()) i = 0; i < sch->GetColumnCnt(); ++i) {
-        if (sch->IsConstant(i)) {
-            if (!AppendJsonValue(common_cols_v[common_idx], sch->GetColumnType(i), sch->IsColumnNotNull(i), row)) {
-                return false;
-            }
-            ++common_idx;
-        } else {
-            if (!AppendJsonValue(non_common_cols_v[non_common_idx], sch->GetColumnType(i), sch->IsColumnNotNull(i),
-                                 row)) {
-                return false;
-            }
-            ++non_common_idx;
-        }
-    }
-    return true;
+    cntl->response_attachment().append(writer.GetString(), writer.GetSize());
 }
 
 template <typename T>
@@ -281,11 +253,17 @@ void APIServerImpl::RegisterPut() {
 void APIServerImpl::RegisterExecDeployment() {
     provider_.post("/dbs/:db_name/deployments/:sp_name", std::bind(&APIServerImpl::ExecuteProcedure, this,
                 false, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+    provider_.post_binary("/dbs/:db_name/deployments/:sp_name",
+                          std::bind(&APIServerImpl::ExecuteProcedureBinary, this, false, std::placeholders::_1,
+                                    std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
 }
 
 void APIServerImpl::RegisterExecSP() {
     provider_.post("/dbs/:db_name/procedures/:sp_name", std::bind(&APIServerImpl::ExecuteProcedure, this,
                 true, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+    provider_.post_binary("/dbs/:db_name/procedures/:sp_name",
+                          std::bind(&APIServerImpl::ExecuteProcedureBinary, this, true, std::placeholders::_1,
+                                    std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
 }
 
 void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvider::Params& param,
@@ -300,98 +278,98 @@ void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvide
     auto db = db_it->second;
     auto sp = sp_it->second;
 
-    Document document;
-    if (document.Parse(req_body.to_string().c_str()).HasParseError()) {
-        writer << err.Set("Json parse failed");
+    hybridse::sdk::Status status;
+    auto plan = GetProcedurePlan(db, sp, has_common_col, &status);
+    if (!plan) {
+        writer << err.Set(status.msg);
         return;
     }
 
-    butil::rapidjson::Value common_cols_v;
-    if (has_common_col) {
-        auto common_cols = document.FindMember("common_cols");
-        if (common_cols != document.MemberEnd()) {
-            common_cols_v = common_cols->value;  // move
-            if (!common_cols_v.IsArray()) {
-                writer << err.Set("common_cols is not array");
-                return;
-            }
-        } else {
-            common_cols_v.SetArray();  // If there's no common cols, no need to add this field in request
-        }
-    } else {
-        common_cols_v.SetArray();
-    }
-
-    auto input = document.FindMember("input");
-    if (input == document.MemberEnd() || !input->value.IsArray() || input->value.Empty()) {
-        writer << err.Set("Invalid input");
+    // rows are encoded into the batch while the body is parsed
+    auto row_batch = std::make_shared<sdk::SQLRequestRowBatch>(plan->input_schema, plan->common_column_indices);
+    ProcedureRequestReader reader(plan, row_batch);
+    if (!reader.Parse(req_body)) {
+        writer << err.Set(reader.GetError());
         return;
     }
-    const auto& rows = input->value;
 
-    hybridse::sdk::Status status;
-    // We need to use ShowProcedure to get input schema(should know which column is constant).
-    // GetRequestRowByProcedure can't do that.
-    auto sp_info = sql_router_->ShowProcedure(db, sp, &status);
-    if (!sp_info) {
+    auto rs = sql_router_->CallSQLBatchRequestProcedure(db, sp, row_batch, &status);
+    if (!rs) {
         writer << err.Set(status.msg);
         return;
     }
 
-    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info->GetInputSchema());
-    // Hard copy, and RequestRow needs shared schema
-    auto input_schema = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
-    auto common_column_indices = std::make_shared<openmldb::sdk::ColumnIndicesSet>(input_schema);
-    decltype(common_cols_v.Size()) expected_common_size = 0;
-    if (has_common_col) {
-        for (int i = 0; i < input_schema->GetColumnCnt(); ++i) {
-            if (input_schema->IsConstant(i)) {
-                common_column_indices->AddCommonColumnIdx(i);
-                ++expected_common_size;
-            }
-        }
-        if (common_cols_v.Size() != expected_common_size) {
-            writer << err.Set("Invalid common cols size");
-            return;
-        }
+    ExecSPResp resp;
+    // output schema in sp_info is needed for encoding data, so we need a bool in ExecSPResp to know whether to
+    // print schema
+    resp.sp_info = plan->sp_info;
+    resp.need_schema = reader.NeedSchema();
+    resp.rs = rs;
+    // pre-size the output buffer, assume a value takes about 16 bytes in json
+    writer.Reserve(256 + static_cast<size_t>(rs->Size()) * plan->sp_info->GetOutputSchema().GetColumnCnt() * 16);
+    writer << resp;
+}
+
+int APIServerImpl::ExecuteProcedureBinary(bool has_common_col, const InterfaceProvider::Params& param,
+                                          const butil::IOBuf& req_body, butil::IOBuf* resp_body, JsonWriter& writer) {
+    auto err = GeneralError();
+    auto db_it = param.find("db_name");
+    auto sp_it = param.find("sp_name");
+    if (db_it == param.end() || sp_it == param.end()) {
+        writer << err.Set("Invalid path");
+        return brpc::HTTP_STATUS_OK;
     }
-    auto expected_input_size = input_schema->GetColumnCnt() - expected_common_size;
+    auto db = db_it->second;
+    auto sp = sp_it->second;
 
-    // TODO(hw): SQLRequestRowBatch should add common & non-common cols directly
-    auto row_batch = std::make_shared<sdk::SQLRequestRowBatch>(input_schema, common_column_indices);
-    std::set<std::string> col_set;
-    for (decltype(rows.Size()) i = 0; i < rows.Size(); ++i) {
-        if (!rows[i].IsArray() || rows[i].Size() != expected_input_size) {
-            writer << err.Set("Invalid input data row");
-            return;
-        }
-        auto row = std::make_shared<sdk::SQLRequestRow>(input_schema, col_set);
+    hybridse::sdk::Status status;
+    auto plan = GetProcedurePlan(db, sp, has_common_col, &status);
+    if (!plan) {
+        writer << err.Set(status.msg);
+        return brpc::HTTP_STATUS_OK;
+    }
 
-        // sizes have been checked
-        if (!Json2SQLRequestRow(rows[i], common_cols_v, row)) {
-            writer << err.Set("Translate to request row failed");
-            return;
-        }
-        row->Build();
-        row_batch->AddRow(row);
+    auto row_batch = std::make_shared<sdk::SQLRequestRowBatch>(plan->input_schema, plan->common_column_indices);
+    std::string msg;
+    if (!ReadBinaryRequestRows(req_body, *plan->input_schema, row_batch.get(), &msg)) {
+        writer << err.Set(msg);
+        return brpc::HTTP_STATUS_BAD_REQUEST;
     }
 
     auto rs = sql_router_->CallSQLBatchRequestProcedure(db, sp, row_batch, &status);
     if (!rs) {
         writer << err.Set(status.msg);
-        return;
+        return brpc::HTTP_STATUS_OK;
     }
+    auto batch_rs = std::dynamic_pointer_cast<sdk::SQLBatchRequestResultSet>(rs);
+    if (!batch_rs) {
+        writer << err.Set("binary response is unsupported for this result set");
+        return brpc::HTTP_STATUS_OK;
+    }
+    WriteBinaryResponseRows(*batch_rs, resp_body);
+    return brpc::HTTP_STATUS_OK;
+}
 
-    ExecSPResp resp;
-    // output schema in sp_info is needed for encoding data, so we need a bool in ExecSPResp to know whether to
-    // print schema
-    resp.sp_info = sp_info;
-    if (document.HasMember("need_schema") && document["need_schema"].IsBool() &&
-        document["need_schema"].GetBool()) {
-        resp.need_schema = true;
+std::shared_ptr<ProcedurePlan> APIServerImpl::GetProcedurePlan(const std::string& db, const std::string& sp,
+                                                               bool has_common_col, hybridse::sdk::Status* status) {
+    // sp info is cached in sdk catalog, it's cheap to get it. A new sp info means the procedure is recreated or the
+    // catalog is refreshed, the plan should be rebuilt.
+    auto sp_info = sql_router_->ShowProcedure(db, sp, status);
+    if (!sp_info) {
+        return {};
     }
-    resp.rs = rs;
-    writer << resp;
+    auto key = std::make_tuple(db, sp, has_common_col);
+    {
+        std::lock_guard<std::mutex> lock(plan_mu_);
+        auto it = procedure_plans_.find(key);
+        if (it != procedure_plans_.end() && it->second->sp_info == sp_info) {
+            return it->second;
+        }
+    }
+    auto plan = ProcedurePlan::Build(sp_info, has_common_col);
+    std::lock_guard<std::mutex> lock(plan_mu_);
+    procedure_plans_[key] = plan;
+    return plan;
 }
 
 void APIServerImpl::RegisterGetSP() {
@@ -581,16 +559,16 @@ void WriteSchema(JsonWriter& ar, const std::string& name, const hybridse::sdk::S
     ar.EndArray();
 }
 
-void WriteValue(JsonWriter& ar, std::shared_ptr<hybridse::sdk::ResultSet> rs, int i) {  // NOLINT
-    auto schema = rs->GetSchema();
+void WriteValue(JsonWriter& ar, hybridse::sdk::ResultSet* rs, const hybridse::sdk::Schema& schema,  // NOLINT
+                int i, std::string* str_buf) {
     if (rs->IsNULL(i)) {
-        if (schema->IsColumnNotNull(i)) {
-            LOG(ERROR) << "Value in " << schema->GetColumnName(i) << " is null but it can't be null";
+        if (schema.IsColumnNotNull(i)) {
+            LOG(ERROR) << "Value in " << schema.GetColumnName(i) << " is null but it can't be null";
         }
         ar.SetNull();
         return;
     }
-    switch (schema->GetColumnType(i)) {
+    switch (schema.GetColumnType(i)) {
         case hybridse::sdk::kTypeInt32: {
             int32_t value = 0;
             rs->GetInt32(i, &value);
@@ -622,9 +600,8 @@ void WriteValue(JsonWriter& ar, std::shared_ptr<hybridse::sdk::ResultSet> rs, in
             break;
         }
         case hybridse::sdk::kTypeString: {
-            std::string val;
-            rs->GetString(i, &val);
-            ar& val;
+            rs->GetString(i, str_buf);
+            ar& *str_buf;
             break;
         }
         case hybridse::sdk::kTypeTimestamp: {
@@ -675,13 +652,15 @@ JsonWriter& operator&(JsonWriter& ar, ExecSPResp& s) {  // NOLINT
     // data-data: non common cols data
     ar.Member("data");
     ar.StartArray();
-    auto& rs = s.rs;
+    auto rs = s.rs.get();
+    const auto& rs_schema = *rs->GetSchema();
+    std::string str_buf;
     rs->Reset();
     while (rs->Next()) {
         ar.StartArray();
         for (decltype(schema.GetColumnCnt()) i = 0; i < schema.GetColumnCnt(); i++) {
             if (!schema.IsConstant(i)) {
-                WriteValue(ar, rs, i);
+                WriteValue(ar, rs, rs_schema, i, &str_buf);
             }
         }
         ar.EndArray();  // one row end
@@ -696,7 +675,7 @@ JsonWriter& operator&(JsonWriter& ar, ExecSPResp& s) {  // NOLINT
             ar.StartArray();
             for (decltype(schema.GetColumnCnt()) i = 0; i < schema.GetColumnCnt(); i++) {
                 if (schema.IsConstant(i)) {
-                    WriteValue(ar, rs, i);
+                    WriteValue(ar, rs, rs_schema, i, &str_buf);
                 }
             }
             ar.EndArray();  // one row end
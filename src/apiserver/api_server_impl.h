@@ -18,13 +18,18 @@
 #define SRC_APISERVER_API_SERVER_IMPL_H_
 
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "apiserver/binary_row_protocol.h"
 #include "apiserver/interface_provider.h"
 #include "apiserver/json_helper.h"
+#include "apiserver/procedure_request_reader.h"
 #include "json2pb/rapidjson.h"  // rapidjson's DOM-style API
 #include "proto/api_server.pb.h"
 #include "sdk/sql_cluster_router.h"
@@ -66,9 +71,14 @@ class APIServerImpl : public APIServer {
     void ExecuteProcedure(bool has_common_col, const InterfaceProvider::Params& param,
             const butil::IOBuf& req_body, JsonWriter& writer); // NOLINT
 
-    static bool Json2SQLRequestRow(const butil::rapidjson::Value& non_common_cols_v,
-                                   const butil::rapidjson::Value& common_cols_v,
-                                   std::shared_ptr<openmldb::sdk::SQLRequestRow> row);
+    // rows in request and response are in binary row format, see binary_row_protocol.h
+    // returns the http status code, 400 if the request rows are malformed
+    int ExecuteProcedureBinary(bool has_common_col, const InterfaceProvider::Params& param,
+                               const butil::IOBuf& req_body, butil::IOBuf* resp_body, JsonWriter& writer);  // NOLINT
+
+    std::shared_ptr<ProcedurePlan> GetProcedurePlan(const std::string& db, const std::string& sp,
+                                                    bool has_common_col, hybridse::sdk::Status* status);
+
     template <typename T>
     static bool AppendJsonValue(const butil::rapidjson::Value& v, hybridse::sdk::DataType type, bool is_not_null,
                                 T row);
@@ -78,6 +88,9 @@ class APIServerImpl : public APIServer {
     InterfaceProvider provider_;
     // cluster_sdk_ is not owned by this class.
     ::openmldb::sdk::DBSDK* cluster_sdk_ = nullptr;
+    // input plans of procedures, key is {db, sp, has_common_col}
+    std::mutex plan_mu_;
+    std::map<std::tuple<std::string, std::string, bool>, std::shared_ptr<ProcedurePlan>> procedure_plans_;
 };
 
 struct PutResp {
@@ -106,7 +119,9 @@ struct ExecSPResp {
 void WriteSchema(JsonWriter& ar, const std::string& name, const hybridse::sdk::Schema& schema,  // NOLINT
                  bool only_const);
 
-void WriteValue(JsonWriter& ar, std::shared_ptr<hybridse::sdk::ResultSet> rs, int i);  // NOLINT
+// `str_buf` is reused by string values to avoid allocation per value
+void WriteValue(JsonWriter& ar, hybridse::sdk::ResultSet* rs, const hybridse::sdk::Schema& schema,  // NOLINT
+                int i, std::string* str_buf);
 
 // ExecSPResp reading is unsupported now, cuz we decode ResultSet with Schema here, it's irreversible
 JsonWriter& operator&(JsonWriter& ar, ExecSPResp& s);  // NOLINT
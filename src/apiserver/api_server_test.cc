@@ -20,6 +20,7 @@
 #include "brpc/restful.h"
 #include "brpc/server.h"
 #include "butil/logging.h"
+#include "codec/codec.h"
 #include "gflags/gflags.h"
 #include "gtest/gtest.h"
 #include "json2pb/rapidjson.h"
@@ -476,6 +477,52 @@ TEST_F(APIServerTest, procedure) {
         ASSERT_EQ(2, document["data"]["common_cols_data"].Size());
     }
 
+    // call procedure, common_cols after input and unknown members are skipped
+    {
+        brpc::Controller cntl;
+        cntl.http_request().set_method(brpc::HTTP_METHOD_POST);
+        cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/procedures/" + sp_name;
+        cntl.request_attachment().append(R"({
+        "input": [[123, 5.1, 6.1, "2021-08-01"],[234, 5.2, 6.2, "2021-08-02"]],
+        "unknown": {"a": [1, 2, {"b": null}]},
+        "common_cols":["bb", 23, 1590738994000]
+    })");
+        env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+
+        if (document.Parse(cntl.response_attachment().to_string().c_str()).HasParseError()) {
+            ASSERT_TRUE(false) << "response parse failed with code " << document.GetParseError()
+                               << ", raw resp: " << cntl.response_attachment().to_string();
+        }
+        ASSERT_EQ(0, document["code"].GetInt()) << document["msg"].GetString();
+        ASSERT_EQ(2, document["data"]["data"].Size());
+        ASSERT_EQ(2, document["data"]["common_cols_data"].Size());
+    }
+
+    // call procedure with invalid bodies
+    {
+        std::vector<std::pair<std::string, std::string>> cases = {
+            {R"({"common_cols":["bb", 23, 1590738994000], "input": [[123, 5.1, 6.1]]})", "Invalid input data row"},
+            {R"({"common_cols":["bb", 23, 1590738994000], "input": [[123, [5.1], 6.1, "2021-08-01"]]})",
+             "Translate to request row failed"},
+            {R"({"common_cols":["bb", 23], "input": [[123, 5.1, 6.1, "2021-08-01"]]})", "Invalid common cols size"},
+            {R"({"common_cols":["bb", 23, 1590738994000], "input": []})", "Invalid input"},
+            {R"({"common_cols":["bb", 23, 1590738994000], "input": [[123, 5.1, 6.1, "2021-08-01"]])",
+             "Json parse failed"},
+        };
+        for (auto& c : cases) {
+            brpc::Controller cntl;
+            cntl.http_request().set_method(brpc::HTTP_METHOD_POST);
+            cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/procedures/" + sp_name;
+            cntl.request_attachment().append(c.first);
+            env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+            ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+            ASSERT_FALSE(document.Parse(cntl.response_attachment().to_string().c_str()).HasParseError());
+            ASSERT_NE(0, document["code"].GetInt()) << c.first;
+            ASSERT_STREQ(c.second.c_str(), document["msg"].GetString()) << c.first;
+        }
+    }
+
     // drop procedure and table
     std::string drop_sp_sql = "drop procedure " + sp_name + ";";
     ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, drop_sp_sql, &status));
@@ -561,6 +608,97 @@ TEST_F(APIServerTest, no_common) {
         ASSERT_EQ(0, document["data"]["common_cols_data"].Size());
     }
 
+    // call deployment with binary rows
+    {
+        std::string msg;
+        auto sp_info = env->cluster_sdk->GetProcedureInfo(env->db, sp_name, &msg);
+        ASSERT_TRUE(sp_info) << msg;
+        auto input_schema = std::make_shared<::hybridse::sdk::SchemaImpl>(
+            dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info->GetInputSchema()).GetSchema());
+        std::vector<std::string> rows;
+        for (uint32_t i = 0; i < 2; i++) {
+            sdk::SQLRequestRow row(input_schema, std::set<std::string>());
+            ASSERT_TRUE(row.Init(2));
+            ASSERT_TRUE(row.AppendString("bb"));
+            ASSERT_TRUE(row.AppendInt32(23));
+            ASSERT_TRUE(row.AppendInt64(123 + i));
+            ASSERT_TRUE(row.AppendFloat(5.1f));
+            ASSERT_TRUE(row.AppendDouble(6.1));
+            ASSERT_TRUE(row.AppendTimestamp(1590738994000));
+            ASSERT_TRUE(row.AppendDate(2021, 8, 1));
+            ASSERT_TRUE(row.Build());
+            rows.push_back(row.GetRow());
+        }
+        auto make_body = [](const std::vector<std::string>& rows) {
+            butil::IOBuf body;
+            uint32_t row_cnt = rows.size();
+            body.append(&row_cnt, sizeof(row_cnt));
+            for (const auto& row : rows) {
+                body.append(row);
+            }
+            return body;
+        };
+
+        brpc::Controller cntl;
+        cntl.http_request().set_method(brpc::HTTP_METHOD_POST);
+        // parameters of the media type are ignored
+        cntl.http_request().set_content_type(std::string(kBinaryRowContentType) + "; charset=utf-8");
+        cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/deployments/" + sp_name;
+        cntl.request_attachment().append(make_body(rows));
+        env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        ASSERT_EQ(kBinaryRowContentType, cntl.http_response().content_type())
+            << cntl.response_attachment().to_string();
+
+        const auto& resp = cntl.response_attachment();
+        uint32_t resp_row_cnt = 0;
+        uint32_t common_cnt = 0;
+        resp.copy_to(&resp_row_cnt, 4, 0);
+        resp.copy_to(&common_cnt, 4, 4);
+        ASSERT_EQ(2u, resp_row_cnt);
+        ASSERT_EQ(0u, common_cnt);
+        size_t pos = 8;
+        for (uint32_t i = 0; i < resp_row_cnt; i++) {
+            uint32_t row_size = 0;
+            ASSERT_EQ(4u, resp.copy_to(&row_size, 4, pos + 2));
+            pos += row_size;
+        }
+        ASSERT_EQ(resp.size(), pos);
+
+        // malformed rows are rejected with 400 before they are sent to the tablet
+        auto expect_bad_request = [&](const butil::IOBuf& body, const std::string& expect_msg) {
+            brpc::Controller err_cntl;
+            err_cntl.http_request().set_method(brpc::HTTP_METHOD_POST);
+            err_cntl.http_request().set_content_type(kBinaryRowContentType);
+            err_cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/deployments/" + sp_name;
+            err_cntl.request_attachment().append(body);
+            env->http_channel.CallMethod(NULL, &err_cntl, NULL, NULL, NULL);
+            ASSERT_TRUE(err_cntl.Failed());
+            ASSERT_EQ(brpc::HTTP_STATUS_BAD_REQUEST, err_cntl.http_response().status_code());
+            ASSERT_NE(std::string::npos, err_cntl.ErrorText().find(expect_msg)) << err_cntl.ErrorText();
+        };
+        // row count without rows
+        butil::IOBuf no_rows;
+        uint32_t row_cnt = 2;
+        no_rows.append(&row_cnt, sizeof(row_cnt));
+        expect_bad_request(no_rows, "Invalid input data row");
+        // unknown schema version
+        auto bad_version = rows[0];
+        bad_version[1] = 2;
+        expect_bad_request(make_body({bad_version}), "schema version");
+        // the only string column starts after the end of the row
+        auto bad_offset = rows[0];
+        uint32_t str_offset_pos = codec::HEADER_LENGTH + 1 + sizeof(int32_t) + sizeof(int64_t) + sizeof(float) +
+                                  sizeof(double) + sizeof(int64_t) + sizeof(int32_t);
+        bad_offset[str_offset_pos] = static_cast<char>(bad_offset.size() + 1);
+        expect_bad_request(make_body({bad_offset}), "string offset out of bounds");
+        // row is shorter than the fixed columns of the input schema
+        auto truncated = rows[0].substr(0, codec::HEADER_LENGTH + 4);
+        uint32_t truncated_size = truncated.size();
+        memcpy(&truncated[codec::VERSION_LENGTH], &truncated_size, sizeof(truncated_size));
+        expect_bad_request(make_body({truncated}), "row size is less than the input schema");
+    }
+
     // drop procedure and table
     std::string drop_sp_sql = "drop procedure " + sp_name + ";";
     ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, drop_sp_sql, &status));
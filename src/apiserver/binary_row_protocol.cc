@@ -0,0 +1,177 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "apiserver/binary_row_protocol.h"
+
+#include "boost/algorithm/string.hpp"
+#include "codec/codec.h"
+#include "codec/fe_row_codec.h"
+
+namespace openmldb {
+namespace apiserver {
+
+bool IsBinaryRowContentType(const std::string& content_type) {
+    auto media_type = content_type.substr(0, content_type.find(';'));
+    boost::algorithm::trim(media_type);
+    return boost::algorithm::iequals(media_type, kBinaryRowContentType);
+}
+
+// row layout of the input schema, same as codec::RowBuilder
+class RequestRowChecker {
+ public:
+    explicit RequestRowChecker(const hybridse::sdk::Schema& schema) : schema_(schema) {
+        str_field_start_offset_ = codec::HEADER_LENGTH + hybridse::codec::BitMapSize(schema.GetColumnCnt());
+        for (int idx = 0; idx < schema.GetColumnCnt(); idx++) {
+            switch (schema.GetColumnType(idx)) {
+                case hybridse::sdk::kTypeBool:
+                    str_field_start_offset_ += sizeof(bool);
+                    break;
+                case hybridse::sdk::kTypeInt16:
+                    str_field_start_offset_ += sizeof(int16_t);
+                    break;
+                case hybridse::sdk::kTypeInt32:
+                case hybridse::sdk::kTypeDate:
+                    str_field_start_offset_ += sizeof(int32_t);
+                    break;
+                case hybridse::sdk::kTypeFloat:
+                    str_field_start_offset_ += sizeof(float);
+                    break;
+                case hybridse::sdk::kTypeInt64:
+                case hybridse::sdk::kTypeTimestamp:
+                    str_field_start_offset_ += sizeof(int64_t);
+                    break;
+                case hybridse::sdk::kTypeDouble:
+                    str_field_start_offset_ += sizeof(double);
+                    break;
+                case hybridse::sdk::kTypeString:
+                    str_field_cnt_++;
+                    break;
+                default:
+                    valid_ = false;
+                    break;
+            }
+        }
+    }
+
+    bool Check(const int8_t* row, uint32_t size, std::string* msg) const {
+        if (!valid_) {
+            *msg = "Unsupported column type in input schema";
+            return false;
+        }
+        if (static_cast<uint8_t>(row[0]) != 1 || static_cast<uint8_t>(row[1]) != 1) {
+            *msg = "Invalid input data row, unsupported format or schema version";
+            return false;
+        }
+        uint32_t addr_length = hybridse::codec::GetAddrLength(size);
+        uint32_t str_start = str_field_start_offset_ + addr_length * str_field_cnt_;
+        if (size < str_start) {
+            *msg = "Invalid input data row, row size is less than the input schema";
+            return false;
+        }
+        for (int idx = 0; idx < schema_.GetColumnCnt(); idx++) {
+            bool is_null = row[codec::HEADER_LENGTH + (idx >> 3)] & (1 << (idx & 0x07));
+            if (is_null && schema_.IsColumnNotNull(idx)) {
+                *msg = "Invalid input data row, column " + schema_.GetColumnName(idx) + " can't be null";
+                return false;
+            }
+        }
+        // strings are stored in order, each offset is the start of the string and the end of the previous one
+        uint32_t prev_offset = str_start;
+        for (uint32_t i = 0; i < str_field_cnt_; i++) {
+            uint32_t offset = GetStrOffset(row + str_field_start_offset_ + addr_length * i, addr_length);
+            if (offset < prev_offset || offset > size) {
+                *msg = "Invalid input data row, string offset out of bounds";
+                return false;
+            }
+            prev_offset = offset;
+        }
+        return true;
+    }
+
+ private:
+    static uint32_t GetStrOffset(const int8_t* ptr, uint32_t addr_length) {
+        switch (addr_length) {
+            case 1:
+                return *reinterpret_cast<const uint8_t*>(ptr);
+            case 2:
+                return *reinterpret_cast<const uint16_t*>(ptr);
+            case 3:
+                // big-endian, see SQLRequestRow::AppendString
+                return (static_cast<uint32_t>(static_cast<uint8_t>(ptr[0])) << 16) |
+                       (static_cast<uint32_t>(static_cast<uint8_t>(ptr[1])) << 8) |
+                       static_cast<uint32_t>(static_cast<uint8_t>(ptr[2]));
+            default:
+                return *reinterpret_cast<const uint32_t*>(ptr);
+        }
+    }
+
+    const hybridse::sdk::Schema& schema_;
+    bool valid_ = true;
+    uint32_t str_field_start_offset_ = 0;
+    uint32_t str_field_cnt_ = 0;
+};
+
+bool ReadBinaryRequestRows(const butil::IOBuf& body, const hybridse::sdk::Schema& schema,
+                           openmldb::sdk::SQLRequestRowBatch* row_batch, std::string* msg) {
+    uint32_t row_cnt = 0;
+    if (body.copy_to(&row_cnt, sizeof(row_cnt), 0) != sizeof(row_cnt) || row_cnt == 0) {
+        *msg = "Invalid input";
+        return false;
+    }
+    RequestRowChecker checker(schema);
+    size_t pos = sizeof(row_cnt);
+    // rows may cross the blocks of IOBuf, copy a row into a contiguous buffer
+    std::string row;
+    for (uint32_t i = 0; i < row_cnt; ++i) {
+        uint32_t row_size = 0;
+        if (body.copy_to(&row_size, codec::SIZE_LENGTH, pos + codec::VERSION_LENGTH) != codec::SIZE_LENGTH ||
+            row_size < codec::HEADER_LENGTH || pos + row_size > body.size()) {
+            *msg = "Invalid input data row";
+            return false;
+        }
+        body.copy_to(&row, row_size, pos);
+        if (!checker.Check(reinterpret_cast<const int8_t*>(row.data()), row.size(), msg)) {
+            return false;
+        }
+        if (!row_batch->AddRow(reinterpret_cast<const int8_t*>(row.data()), row.size())) {
+            *msg = "Translate to request row failed";
+            return false;
+        }
+        pos += row_size;
+    }
+    if (pos != body.size()) {
+        *msg = "Invalid input, unexpected data after rows";
+        return false;
+    }
+    return true;
+}
+
+void WriteBinaryResponseRows(const openmldb::sdk::SQLBatchRequestResultSet& rs, butil::IOBuf* body) {
+    const auto& response = rs.GetResponse();
+    uint32_t row_cnt = response.count();
+    body->append(&row_cnt, sizeof(row_cnt));
+    uint32_t common_cnt = response.common_column_indices_size();
+    body->append(&common_cnt, sizeof(common_cnt));
+    for (auto idx : response.common_column_indices()) {
+        uint32_t col_idx = idx;
+        body->append(&col_idx, sizeof(col_idx));
+    }
+    // the common row and other rows are in the same layout in tablet response, share the blocks
+    body->append(rs.GetRowsBuf());
+}
+
+}  // namespace apiserver
+}  // namespace openmldb
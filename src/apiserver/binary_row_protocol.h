@@ -0,0 +1,64 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_APISERVER_BINARY_ROW_PROTOCOL_H_
+#define SRC_APISERVER_BINARY_ROW_PROTOCOL_H_
+
+#include <string>
+
+#include "butil/iobuf.h"
+#include "sdk/batch_request_result_set_sql.h"
+#include "sdk/sql_request_row.h"
+
+namespace openmldb {
+namespace apiserver {
+
+/**
+ * Binary row protocol of procedure/deployment execution, used when the request content type is
+ * kBinaryRowContentType. Rows are in the row format of codec::RowBuilder, and every row starts with the header
+ * {uint8 fversion, uint8 sversion, uint32 row size}, so rows are length-prefixed by themselves. All integers are
+ * little-endian.
+ *
+ * Request body:
+ *   uint32 row count
+ *   rows encoded with the whole input schema of the procedure
+ *
+ * Response body:
+ *   uint32 row count
+ *   uint32 common column count N, and N * uint32 common column indices in the output schema
+ *   if N > 0, one row of the common columns
+ *   row count rows of the other columns
+ *
+ * Errors are responded in json like other apis. Malformed request rows, e.g. a fversion or sversion other than 1, or
+ * string offsets out of the row, are responded with http status 400.
+ */
+static constexpr const char* kBinaryRowContentType = "application/x-openmldb-row";
+
+// whether the media type of content type is kBinaryRowContentType, parameters like charset are ignored
+bool IsBinaryRowContentType(const std::string& content_type);
+
+// decode request rows and add them to the batch without decoding the fields. Every row is checked against the input
+// schema first, so a malformed row is rejected here instead of being read out of bounds by the tablet.
+bool ReadBinaryRequestRows(const butil::IOBuf& body, const hybridse::sdk::Schema& schema,
+                           openmldb::sdk::SQLRequestRowBatch* row_batch, std::string* msg);
+
+// pass the rows in response of tablet to body without decoding the fields
+void WriteBinaryResponseRows(const openmldb::sdk::SQLBatchRequestResultSet& rs, butil::IOBuf* body);
+
+}  // namespace apiserver
+}  // namespace openmldb
+
+#endif  // SRC_APISERVER_BINARY_ROW_PROTOCOL_H_
@@ -157,41 +157,75 @@ void InterfaceProvider::registerRequest(brpc::HttpMethod type, std::string const
     requests_[type].push_back(req);
 }
 
-bool InterfaceProvider::handle(const std::string& path, const brpc::HttpMethod& method, const butil::IOBuf& req_body,
-                               JsonWriter& writer) {
+InterfaceProvider& InterfaceProvider::post_binary(const std::string& path, std::function<binary_func> callback) {
+    Url parsed;
+    if (!ReducedUrlParser::parse(path, &parsed)) {
+        LOG(ERROR) << "Fail to parse url " << path;
+        return *this;
+    }
+    binary_requests_[brpc::HttpMethod::HTTP_METHOD_POST].push_back(BuiltBinaryRequest{parsed, std::move(callback)});
+    return *this;
+}
+
+template <typename Request>
+const Request* InterfaceProvider::findRequest(const std::unordered_map<int, std::vector<Request>>& requests,
+                                              const std::string& path, const brpc::HttpMethod& method,
+                                              Params* params, JsonWriter& writer) {
     auto err = GeneralError();
     Url url;
 
     if (!ReducedUrlParser::parse(path, &url)) {
         writer << err.Set("invalid url");
-        return false;
+        return nullptr;
     }
 
-    auto requestList = requests_.find(method);
+    auto requestList = requests.find(method);
 
     // is there any request matching the request type?
-    if (requestList == std::end(requests_)) {
+    if (requestList == std::end(requests)) {
         if (strncmp(HttpMethod2Str(method), "UNKNOWN", 7) != 0) {
             writer << err.Set("unsupported method");
-            return false;
+            return nullptr;
         }
 
         writer << err.Set("invalid method");
-        return false;
+        return nullptr;
     }
 
     // is there a registered request, that matches the url?
     auto request = std::find_if(std::begin(requestList->second), std::end(requestList->second),
-                                [&, this](BuiltRequest const& request) { return matching(url, request.url); });
+                                [&](Request const& request) { return matching(url, request.url); });
 
     if (request == std::end(requestList->second)) {
         writer << err.Set("no match method");
-        return false;
+        return nullptr;
     }
 
-    auto params = extractParameters(url, request->url);
+    *params = extractParameters(url, request->url);
+    return &(*request);
+}
+
+bool InterfaceProvider::handle(const std::string& path, const brpc::HttpMethod& method, const butil::IOBuf& req_body,
+                               JsonWriter& writer) {
+    Params params;
+    auto request = findRequest(requests_, path, method, &params, writer);
+    if (request == nullptr) {
+        return false;
+    }
     request->callback(params, req_body, writer);
     return true;
 }
+
+bool InterfaceProvider::handle_binary(const std::string& path, const brpc::HttpMethod& method,
+                                      const butil::IOBuf& req_body, butil::IOBuf* resp_body, int* status_code,
+                                      JsonWriter& writer) {
+    Params params;
+    auto request = findRequest(binary_requests_, path, method, &params, writer);
+    if (request == nullptr) {
+        return false;
+    }
+    *status_code = request->callback(params, req_body, resp_body, writer);
+    return true;
+}
 }  // namespace apiserver
 }  // namespace openmldb
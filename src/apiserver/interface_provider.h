@@ -144,14 +144,35 @@ class InterfaceProvider {
      */
     InterfaceProvider& post(std::string const& path, std::function<func> callback);
 
+    /**
+     *  Registers a new post request handler for binary body, see binary_row_protocol.h.
+     *  The callback writes the binary response to resp_body, or writes json error to writer, and returns the http
+     *  status code of the response.
+     */
+    using binary_func = int(const Params& params, const butil::IOBuf& req_body, butil::IOBuf* resp_body,
+                            JsonWriter& writer);  // NOLINT
+    InterfaceProvider& post_binary(std::string const& path, std::function<binary_func> callback);
+
     bool handle(const std::string& path, const brpc::HttpMethod& method, const butil::IOBuf& req_body,
                 JsonWriter& writer);  // NOLINT
 
+    bool handle_binary(const std::string& path, const brpc::HttpMethod& method, const butil::IOBuf& req_body,
+                       butil::IOBuf* resp_body, int* status_code, JsonWriter& writer);  // NOLINT
+
  private:
     struct BuiltRequest {
         Url url;
         std::function<func> callback;
     };
+    struct BuiltBinaryRequest {
+        Url url;
+        std::function<binary_func> callback;
+    };
+
+    template <typename Request>
+    static const Request* findRequest(const std::unordered_map<int, std::vector<Request>>& requests,
+                                      const std::string& path, const brpc::HttpMethod& method,
+                                      Params* params, JsonWriter& writer);  // NOLINT
 
     static bool matching(const Url& received, const Url& registered);
     static std::unordered_map<std::string, std::string> extractParameters(const Url& received, const Url& registered);
@@ -161,6 +182,7 @@ class InterfaceProvider {
 
  private:
     std::unordered_map<int, std::vector<BuiltRequest>> requests_;
+    std::unordered_map<int, std::vector<BuiltBinaryRequest>> binary_requests_;
 };
 
 struct GeneralError {
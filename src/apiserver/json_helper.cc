@@ -252,6 +252,10 @@ JsonWriter::~JsonWriter() {
 
 const char* JsonWriter::GetString() const { return STREAM->GetString(); }
 
+size_t JsonWriter::GetSize() const { return STREAM->GetSize(); }
+
+void JsonWriter::Reserve(size_t size) { STREAM->Reserve(size); }
+
 JsonWriter& JsonWriter::StartObject() {
     WRITER->StartObject();
     return *this;
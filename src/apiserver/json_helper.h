@@ -94,6 +94,10 @@ class JsonWriter {
 
     /// Obtains the serialized JSON string.
     const char* GetString() const;
+    /// Obtains the length of the serialized JSON string.
+    size_t GetSize() const;
+    /// Reserves the buffer for at least `size` bytes of output.
+    void Reserve(size_t size);
 
     // Archive concept
 
@@ -0,0 +1,404 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "apiserver/procedure_request_reader.h"
+
+#include <cstring>
+#include <limits>
+#include <set>
+
+#include "absl/strings/numbers.h"
+#include "base/strings.h"
+#include "json2pb/zero_copy_stream_reader.h"
+
+namespace openmldb {
+namespace apiserver {
+
+using butil::rapidjson::SizeType;
+
+std::shared_ptr<ProcedurePlan> ProcedurePlan::Build(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info,
+                                                    bool has_common_col) {
+    auto plan = std::make_shared<ProcedurePlan>();
+    plan->sp_info = sp_info;
+    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info->GetInputSchema());
+    // Hard copy, and RequestRow needs shared schema
+    plan->input_schema = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
+    plan->common_column_indices = std::make_shared<openmldb::sdk::ColumnIndicesSet>(plan->input_schema);
+    plan->has_common_col = has_common_col;
+    const auto& schema = *plan->input_schema;
+    for (int i = 0; i < schema.GetColumnCnt(); ++i) {
+        bool is_common = has_common_col && schema.IsConstant(i);
+        plan->is_common.push_back(is_common);
+        plan->types.push_back(schema.GetColumnType(i));
+        plan->not_null.push_back(schema.IsColumnNotNull(i));
+        if (is_common) {
+            plan->common_column_indices->AddCommonColumnIdx(i);
+            ++plan->common_cnt;
+        } else {
+            ++plan->input_cnt;
+        }
+    }
+    return plan;
+}
+
+ProcedureRequestReader::ProcedureRequestReader(const std::shared_ptr<ProcedurePlan>& plan,
+                                               const std::shared_ptr<openmldb::sdk::SQLRequestRowBatch>& row_batch)
+    : plan_(plan), row_batch_(row_batch) {
+    static const std::set<std::string> record_cols;
+    row_ = std::make_shared<openmldb::sdk::SQLRequestRow>(plan_->input_schema, record_cols);
+    common_ready_ = !plan_->has_common_col || plan_->common_cnt == 0;
+}
+
+bool ProcedureRequestReader::Parse(const butil::IOBuf& body) {
+    butil::IOBufAsZeroCopyInputStream stream(body);
+    json2pb::ZeroCopyStreamReader stream_reader(&stream);
+    butil::rapidjson::Reader reader;
+    reader.Parse(stream_reader, *this);
+    if (reader.HasParseError()) {
+        // the handler may have set a more specific error
+        return SetError("Json parse failed");
+    }
+    if (!input_seen_ || row_cnt_ == 0) {
+        return SetError("Invalid input");
+    }
+    if (!common_ready_) {
+        return SetError("Invalid common cols size");
+    }
+    return true;
+}
+
+bool ProcedureRequestReader::Null() {
+    JsonScalar v;
+    v.type = JsonScalar::kNull;
+    return OnScalar(&v);
+}
+
+bool ProcedureRequestReader::Bool(bool b) {
+    JsonScalar v;
+    v.type = JsonScalar::kBool;
+    v.b = b;
+    return OnScalar(&v);
+}
+
+bool ProcedureRequestReader::Int(int i) { return Int64(i); }
+
+bool ProcedureRequestReader::Uint(unsigned u) { return Int64(u); }
+
+bool ProcedureRequestReader::Int64(int64_t i) {
+    JsonScalar v;
+    v.type = JsonScalar::kInt;
+    v.i = i;
+    v.is_int32 = i >= std::numeric_limits<int32_t>::min() && i <= std::numeric_limits<int32_t>::max();
+    return OnScalar(&v);
+}
+
+bool ProcedureRequestReader::Uint64(uint64_t u) {
+    if (u > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+        // not a valid value of any column type
+        JsonScalar v;
+        return OnScalar(&v);
+    }
+    return Int64(static_cast<int64_t>(u));
+}
+
+bool ProcedureRequestReader::Double(double d) {
+    JsonScalar v;
+    v.type = JsonScalar::kDouble;
+    v.d = d;
+    return OnScalar(&v);
+}
+
+bool ProcedureRequestReader::String(const char* str, SizeType length, bool copy) {
+    JsonScalar v;
+    v.type = JsonScalar::kString;
+    return OnScalar(&v, str, length);
+}
+
+bool ProcedureRequestReader::StartObject() { return OnStart(false); }
+
+bool ProcedureRequestReader::Key(const char* str, SizeType length, bool copy) {
+    if (skip_depth_ > 0 || depth_ != 1) {
+        return true;
+    }
+    auto is_key = [str, length](const char* name) {
+        return length == strlen(name) && memcmp(str, name, length) == 0;
+    };
+    if (is_key("input")) {
+        field_ = input_seen_ ? Field::kUnknown : Field::kInput;
+    } else if (is_key("common_cols") && plan_->has_common_col) {
+        field_ = common_cols_seen_ ? Field::kUnknown : Field::kCommonCols;
+    } else if (is_key("need_schema")) {
+        field_ = Field::kNeedSchema;
+    } else {
+        field_ = Field::kUnknown;
+    }
+    return true;
+}
+
+bool ProcedureRequestReader::EndObject(SizeType member_count) { return OnEnd(); }
+
+bool ProcedureRequestReader::StartArray() { return OnStart(true); }
+
+bool ProcedureRequestReader::EndArray(SizeType element_count) { return OnEnd(); }
+
+bool ProcedureRequestReader::OnScalar(JsonScalar* v, const char* str, size_t length) {
+    if (skip_depth_ > 0) {
+        return true;
+    }
+    if (depth_ == 0) {
+        return SetError("Invalid input");
+    }
+    if (depth_ == 1) {
+        // value of a member in the top object
+        if (field_ == Field::kInput) {
+            return SetError("Invalid input");
+        } else if (field_ == Field::kCommonCols) {
+            return SetError("common_cols is not array");
+        } else if (field_ == Field::kNeedSchema && v->type == JsonScalar::kBool) {
+            need_schema_ = v->b;
+        }
+        field_ = Field::kNone;
+        return true;
+    }
+    if (in_input_) {
+        if (depth_ == 2) {
+            return SetError("Invalid input data row");
+        }
+        if (v->type == JsonScalar::kString) {
+            v->str_offset = strings_.size();
+            v->str_len = length;
+            strings_.append(str, length);
+        }
+        row_values_.push_back(*v);
+    } else if (in_common_cols_) {
+        if (v->type == JsonScalar::kString) {
+            v->str_offset = common_strings_.size();
+            v->str_len = length;
+            common_strings_.append(str, length);
+        }
+        common_values_.push_back(*v);
+    }
+    return true;
+}
+
+bool ProcedureRequestReader::OnStart(bool is_array) {
+    ++depth_;
+    if (skip_depth_ > 0) {
+        return true;
+    }
+    if (depth_ == 1) {
+        return is_array ? SetError("Invalid input") : true;
+    }
+    if (depth_ == 2) {
+        if (field_ == Field::kInput) {
+            if (!is_array) {
+                return SetError("Invalid input");
+            }
+            in_input_ = true;
+            input_seen_ = true;
+        } else if (field_ == Field::kCommonCols) {
+            if (!is_array) {
+                return SetError("common_cols is not array");
+            }
+            in_common_cols_ = true;
+            common_cols_seen_ = true;
+        } else {
+            skip_depth_ = depth_;
+        }
+        return true;
+    }
+    if (in_input_ && depth_ == 3) {
+        return is_array ? true : SetError("Invalid input data row");
+    }
+    // a nested value in an input row or in common_cols is never valid, skip it
+    if (in_input_) {
+        row_values_.emplace_back();
+    } else if (in_common_cols_) {
+        common_values_.emplace_back();
+    }
+    skip_depth_ = depth_;
+    return true;
+}
+
+bool ProcedureRequestReader::OnEnd() {
+    int depth = depth_--;
+    if (skip_depth_ > 0) {
+        if (depth == skip_depth_) {
+            skip_depth_ = 0;
+            if (depth == 2) {
+                field_ = Field::kNone;
+            }
+        }
+        return true;
+    }
+    if (in_input_ && depth == 3) {
+        return FinishRow();
+    }
+    if (depth == 2) {
+        field_ = Field::kNone;
+        if (in_input_) {
+            in_input_ = false;
+        } else if (in_common_cols_) {
+            in_common_cols_ = false;
+            return FinishCommonCols();
+        }
+    }
+    return true;
+}
+
+bool ProcedureRequestReader::FinishRow() {
+    if (row_values_.size() != plan_->input_cnt) {
+        return SetError("Invalid input data row");
+    }
+    ++row_cnt_;
+    if (!common_ready_) {
+        // common_cols is after input, encode the row when common cols are read
+        pending_values_.insert(pending_values_.end(), row_values_.begin(), row_values_.end());
+        row_values_.clear();
+        return true;
+    }
+    bool ok = EncodeRow(row_values_.data());
+    row_values_.clear();
+    strings_.clear();
+    return ok;
+}
+
+bool ProcedureRequestReader::FinishCommonCols() {
+    if (common_values_.size() != plan_->common_cnt) {
+        return SetError("Invalid common cols size");
+    }
+    if (common_ready_) {
+        return true;
+    }
+    common_ready_ = true;
+    for (uint32_t i = 0; i < row_cnt_; ++i) {
+        if (!EncodeRow(pending_values_.data() + i * plan_->input_cnt)) {
+            return false;
+        }
+    }
+    pending_values_.clear();
+    strings_.clear();
+    return true;
+}
+
+bool ProcedureRequestReader::EncodeRow(const JsonScalar* values) {
+    const auto& plan = *plan_;
+    // scan all strings to init the total string length
+    size_t str_len_sum = 0;
+    uint32_t common_idx = 0, non_common_idx = 0;
+    for (size_t i = 0; i < plan.types.size(); ++i) {
+        const auto& v = plan.is_common[i] ? common_values_[common_idx++] : values[non_common_idx++];
+        if (plan.types[i] == hybridse::sdk::kTypeString && v.type == JsonScalar::kString) {
+            str_len_sum += v.str_len;
+        }
+    }
+    row_->Init(static_cast<int32_t>(str_len_sum));
+
+    common_idx = 0, non_common_idx = 0;
+    for (size_t i = 0; i < plan.types.size(); ++i) {
+        bool ok = plan.is_common[i]
+                      ? AppendValue(common_values_[common_idx++], common_strings_, plan.types[i], plan.not_null[i])
+                      : AppendValue(values[non_common_idx++], strings_, plan.types[i], plan.not_null[i]);
+        if (!ok) {
+            return SetError("Translate to request row failed");
+        }
+    }
+    if (!row_->Build() || !row_batch_->AddRow(row_)) {
+        return SetError("Translate to request row failed");
+    }
+    return true;
+}
+
+bool ProcedureRequestReader::AppendValue(const JsonScalar& v, const std::string& arena, hybridse::sdk::DataType type,
+                                         bool is_not_null) {
+    // check if null
+    if (v.type == JsonScalar::kNull) {
+        if (is_not_null) {
+            return false;
+        }
+        return row_->AppendNULL();
+    }
+
+    switch (type) {
+        case hybridse::sdk::kTypeBool: {
+            if (v.type != JsonScalar::kBool) {
+                return false;
+            }
+            return row_->AppendBool(v.b);
+        }
+        case hybridse::sdk::kTypeInt16: {
+            if (v.type != JsonScalar::kInt || v.i < std::numeric_limits<int16_t>::min() ||
+                v.i > std::numeric_limits<int16_t>::max()) {
+                return false;
+            }
+            return row_->AppendInt16(static_cast<int16_t>(v.i));
+        }
+        case hybridse::sdk::kTypeInt32: {
+            if (v.type != JsonScalar::kInt || !v.is_int32) {
+                return false;
+            }
+            return row_->AppendInt32(static_cast<int32_t>(v.i));
+        }
+        case hybridse::sdk::kTypeInt64: {
+            if (v.type != JsonScalar::kInt) {
+                return false;
+            }
+            return row_->AppendInt64(v.i);
+        }
+        case hybridse::sdk::kTypeFloat: {
+            if (v.type != JsonScalar::kDouble) {
+                return false;
+            }
+            return row_->AppendFloat(static_cast<float>(v.d));
+        }
+        case hybridse::sdk::kTypeDouble: {
+            if (v.type != JsonScalar::kDouble) {
+                return false;
+            }
+            return row_->AppendDouble(v.d);
+        }
+        case hybridse::sdk::kTypeString: {
+            if (v.type != JsonScalar::kString) {
+                return false;
+            }
+            return row_->AppendString(arena.data() + v.str_offset, v.str_len);
+        }
+        case hybridse::sdk::kTypeDate: {
+            if (v.type != JsonScalar::kString) {
+                return false;
+            }
+            std::vector<std::string> parts;
+            ::openmldb::base::SplitString(arena.substr(v.str_offset, v.str_len), "-", parts);
+            int32_t year = 0, mon = 0, day = 0;
+            if (parts.size() != 3 || !absl::SimpleAtoi(parts[0], &year) || !absl::SimpleAtoi(parts[1], &mon) ||
+                !absl::SimpleAtoi(parts[2], &day)) {
+                return false;
+            }
+            return row_->AppendDate(year, mon, day);
+        }
+        case hybridse::sdk::kTypeTimestamp: {
+            if (v.type != JsonScalar::kInt) {
+                return false;
+            }
+            return row_->AppendTimestamp(v.i);
+        }
+        default:
+            return false;
+    }
+}
+
+}  // namespace apiserver
+}  // namespace openmldb
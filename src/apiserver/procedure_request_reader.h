@@ -0,0 +1,144 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_APISERVER_PROCEDURE_REQUEST_READER_H_
+#define SRC_APISERVER_PROCEDURE_REQUEST_READER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "json2pb/rapidjson.h"
+#include "sdk/base_impl.h"
+#include "sdk/sql_request_row.h"
+
+namespace openmldb {
+namespace apiserver {
+
+// ProcedurePlan keeps what is needed to decode the requests of a procedure, so the input schema is only copied
+// and analyzed once per procedure.
+struct ProcedurePlan {
+    static std::shared_ptr<ProcedurePlan> Build(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info,
+                                                bool has_common_col);
+
+    std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info;
+    // RequestRow needs shared schema
+    std::shared_ptr<hybridse::sdk::SchemaImpl> input_schema;
+    std::shared_ptr<openmldb::sdk::ColumnIndicesSet> common_column_indices;
+    bool has_common_col = false;
+    // whether the value of input column i is in `common_cols` of the request
+    std::vector<bool> is_common;
+    std::vector<hybridse::sdk::DataType> types;
+    std::vector<bool> not_null;
+    uint32_t common_cnt = 0;
+    uint32_t input_cnt = 0;
+};
+
+// A json scalar read by the SAX reader, strings are kept in an arena of the reader
+struct JsonScalar {
+    enum Type { kNull, kBool, kInt, kDouble, kString, kInvalid };
+    Type type = kInvalid;
+    // int value fits in int32, like rapidjson Value::IsInt()
+    bool is_int32 = false;
+    bool b = false;
+    int64_t i = 0;
+    double d = 0;
+    size_t str_offset = 0;
+    size_t str_len = 0;
+};
+
+// ProcedureRequestReader parses the body of a procedure/deployment request with rapidjson SAX API.
+// The body is read from IOBuf segments directly and every row in `input` is encoded into a request row as soon as
+// it's read, no DOM is built. Rows are buffered only if `common_cols` comes after `input`.
+class ProcedureRequestReader {
+ public:
+    ProcedureRequestReader(const std::shared_ptr<ProcedurePlan>& plan,
+                           const std::shared_ptr<openmldb::sdk::SQLRequestRowBatch>& row_batch);
+
+    // return false if the body is invalid, see GetError()
+    bool Parse(const butil::IOBuf& body);
+
+    const std::string& GetError() const { return error_; }
+
+    bool NeedSchema() const { return need_schema_; }
+
+    // rapidjson SAX handler
+    bool Null();
+    bool Bool(bool b);
+    bool Int(int i);
+    bool Uint(unsigned u);
+    bool Int64(int64_t i);
+    bool Uint64(uint64_t u);
+    bool Double(double d);
+    // only called with kParseNumbersAsStringsFlag, which is not used
+    bool RawNumber(const char* str, butil::rapidjson::SizeType length, bool copy) {
+        return SetError("Json parse failed");
+    }
+    bool String(const char* str, butil::rapidjson::SizeType length, bool copy);
+    bool StartObject();
+    bool Key(const char* str, butil::rapidjson::SizeType length, bool copy);
+    bool EndObject(butil::rapidjson::SizeType member_count);
+    bool StartArray();
+    bool EndArray(butil::rapidjson::SizeType element_count);
+
+ private:
+    enum class Field { kNone, kInput, kCommonCols, kNeedSchema, kUnknown };
+
+    bool OnScalar(JsonScalar* value, const char* str = nullptr, size_t length = 0);
+    bool OnStart(bool is_array);
+    bool OnEnd();
+    bool FinishRow();
+    bool FinishCommonCols();
+    bool EncodeRow(const JsonScalar* values);
+    bool AppendValue(const JsonScalar& v, const std::string& arena, hybridse::sdk::DataType type, bool is_not_null);
+    bool SetError(const std::string& msg) {
+        if (error_.empty()) {
+            error_ = msg;
+        }
+        return false;
+    }
+
+    std::shared_ptr<ProcedurePlan> plan_;
+    std::shared_ptr<openmldb::sdk::SQLRequestRowBatch> row_batch_;
+    // reused by all rows, the batch keeps a copy of the encoded row
+    std::shared_ptr<openmldb::sdk::SQLRequestRow> row_;
+
+    // depth of the current object/array, the top object is depth 1
+    int depth_ = 0;
+    // skip the nested value which ends when depth is back to skip_depth_
+    int skip_depth_ = 0;
+    Field field_ = Field::kNone;
+    bool in_input_ = false;
+    bool in_common_cols_ = false;
+    bool input_seen_ = false;
+    bool common_cols_seen_ = false;
+    bool common_ready_ = false;
+    bool need_schema_ = false;
+    uint32_t row_cnt_ = 0;
+
+    std::vector<JsonScalar> row_values_;
+    std::vector<JsonScalar> pending_values_;
+    std::string strings_;
+    std::vector<JsonScalar> common_values_;
+    std::string common_strings_;
+    std::string error_;
+};
+
+}  // namespace apiserver
+}  // namespace openmldb
+
+#endif  // SRC_APISERVER_PROCEDURE_REQUEST_READER_H_
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_BASE_PARTITION_ROUTER_H_
+#define SRC_BASE_PARTITION_ROUTER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/hash.h"
+
+namespace openmldb {
+namespace base {
+
+// A key is routed to hash % init_num when the table is created, init_num being `pid_num` minus
+// the split count. Splitting partition pid doubles its hash modulus, the keys in the upper half
+// of the new modulus move to new_pid. `splits` is a sequence of PartitionSplit in the order they are made
+template <typename Splits>
+uint32_t GetPartitionId(uint64_t hash, uint32_t pid_num, const Splits& splits) {
+    uint32_t init_num = pid_num - static_cast<uint32_t>(splits.size());
+    if (pid_num == 0 || init_num == 0 || init_num > pid_num) {
+        return 0;
+    }
+    uint32_t pid = static_cast<uint32_t>(hash % init_num);
+    uint64_t modulus = init_num;
+    for (const auto& split : splits) {
+        if (split.pid() != pid) {
+            continue;
+        }
+        modulus *= 2;
+        if (hash % modulus >= modulus / 2) {
+            pid = split.new_pid();
+        }
+    }
+    return pid;
+}
+
+template <typename Splits>
+uint32_t GetPartitionId(const std::string& key, uint32_t pid_num, const Splits& splits) {
+    return GetPartitionId(static_cast<uint64_t>(hash64(key)), pid_num, splits);
+}
+
+// The hash modulus of partition `pid`, all the keys of the partition have the same hash % modulus.
+// Returns 0 if the partition does not exist
+template <typename Splits>
+uint64_t GetPartitionModulus(uint32_t pid, uint32_t pid_num, const Splits& splits) {
+    uint32_t init_num = pid_num - static_cast<uint32_t>(splits.size());
+    if (pid >= pid_num || init_num == 0 || init_num > pid_num) {
+        return 0;
+    }
+    std::vector<uint64_t> modulus(init_num, init_num);
+    for (const auto& split : splits) {
+        if (split.pid() >= modulus.size() || split.new_pid() != modulus.size()) {
+            return 0;
+        }
+        modulus[split.pid()] *= 2;
+        modulus.push_back(modulus[split.pid()]);
+    }
+    return modulus[pid];
+}
+
+}  // namespace base
+}  // namespace openmldb
+
+#endif  // SRC_BASE_PARTITION_ROUTER_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/partition_router.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace base {
+
+class PartitionRouterTest : public ::testing::Test {
+ public:
+    PartitionRouterTest() {}
+    ~PartitionRouterTest() {}
+};
+
+struct Split {
+    uint32_t pid_;
+    uint32_t new_pid_;
+    uint32_t pid() const { return pid_; }
+    uint32_t new_pid() const { return new_pid_; }
+};
+
+TEST_F(PartitionRouterTest, NoSplit) {
+    std::vector<Split> splits;
+    for (uint64_t hash = 0; hash < 100; hash++) {
+        ASSERT_EQ(hash % 8, GetPartitionId(hash, 8, splits));
+    }
+    ASSERT_EQ(0u, GetPartitionId(10, 0, splits));
+    ASSERT_EQ(8u, GetPartitionModulus(3, 8, splits));
+    ASSERT_EQ(0u, GetPartitionModulus(8, 8, splits));
+    ASSERT_EQ(GetPartitionId(hash64("key1"), 8, splits), GetPartitionId(std::string("key1"), 8, splits));
+}
+
+TEST_F(PartitionRouterTest, Split) {
+    // 4 partitions, split pid 1 into 4, then pid 4 into 5 and pid 1 into 6
+    std::vector<Split> splits = {{1, 4}, {4, 5}, {1, 6}};
+    uint32_t pid_num = 7;
+    ASSERT_EQ(4u, GetPartitionModulus(0, pid_num, splits));
+    ASSERT_EQ(16u, GetPartitionModulus(1, pid_num, splits));
+    ASSERT_EQ(16u, GetPartitionModulus(4, pid_num, splits));
+    ASSERT_EQ(16u, GetPartitionModulus(5, pid_num, splits));
+    ASSERT_EQ(16u, GetPartitionModulus(6, pid_num, splits));
+    std::map<uint32_t, uint64_t> remainders;
+    for (uint64_t hash = 0; hash < 1000; hash++) {
+        uint32_t pid = GetPartitionId(hash, pid_num, splits);
+        ASSERT_LT(pid, pid_num);
+        if (hash % 4 != 1) {
+            ASSERT_EQ(hash % 4, pid);
+        }
+        // every key of a partition has the same remainder of the partition modulus
+        uint64_t modulus = GetPartitionModulus(pid, pid_num, splits);
+        auto it = remainders.find(pid);
+        if (it == remainders.end()) {
+            remainders.emplace(pid, hash % modulus);
+        } else {
+            ASSERT_EQ(it->second, hash % modulus);
+        }
+    }
+    ASSERT_EQ(pid_num, remainders.size());
+    ASSERT_EQ(1u, GetPartitionId(1, pid_num, splits));
+    ASSERT_EQ(4u, GetPartitionId(5, pid_num, splits));
+    ASSERT_EQ(5u, GetPartitionId(13, pid_num, splits));
+    ASSERT_EQ(6u, GetPartitionId(9, pid_num, splits));
+}
+
+TEST_F(PartitionRouterTest, InvalidSplit) {
+    std::vector<Split> splits = {{1, 3}};
+    ASSERT_EQ(0u, GetPartitionModulus(0, 3, splits));
+    ASSERT_EQ(0u, GetPartitionId(10, 1, splits));
+}
+
+}  // namespace base
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
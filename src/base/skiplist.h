@@ -40,54 +40,63 @@ struct DefaultComparator {
 };
 
 // Skiplist node , a thread safe structure
+// The level 0 link lives in the node itself, so a level 0 traversal touches
+// one allocation per node. Only nodes higher than 1 allocate the upper links.
 template <class K, class V>
 class Node {
  public:
     // Set data reference and Node height
     Node(const K& key, V& value, uint8_t height)  // NOLINT
-        : height_(height), key_(key), value_(value) {
-        nexts_ = new std::atomic<Node<K, V>*>[height];
+        : height_(height), key_(key), value_(value), next_(NULL), upper_nexts_(NULL) {
+        if (height > 1) {
+            upper_nexts_ = new std::atomic<Node<K, V>*>[height - 1];
+        }
     }
 
-    Node(uint8_t height) : height_(height), key_(), value_() {  // NOLINT
-        nexts_ = new std::atomic<Node<K, V>*>[height];
+    Node(uint8_t height) : height_(height), key_(), value_(), next_(NULL), upper_nexts_(NULL) {  // NOLINT
+        if (height > 1) {
+            upper_nexts_ = new std::atomic<Node<K, V>*>[height - 1];
+        }
     }
 
     // Set the next node with memory barrier
     void SetNext(uint8_t level, Node<K, V>* node) {
         assert(level < height_ && level >= 0);
-        nexts_[level].store(node, std::memory_order_release);
+        Link(level).store(node, std::memory_order_release);
     }
 
     // Set the next node without memory barrier
     void SetNextNoBarrier(uint8_t level, Node<K, V>* node) {
         assert(level < height_ && level >= 0);
-        nexts_[level].store(node, std::memory_order_relaxed);
+        Link(level).store(node, std::memory_order_relaxed);
     }
 
     uint8_t Height() { return height_; }
 
     Node<K, V>* GetNext(uint8_t level) {
         assert(level < height_ && level >= 0);
-        return nexts_[level].load(std::memory_order_acquire);
+        return Link(level).load(std::memory_order_acquire);
     }
 
     Node<K, V>* GetNextNoBarrier(uint8_t level) {
         assert(level < height_ && level >= 0);
-        return nexts_[level].load(std::memory_order_relaxed);
+        return Link(level).load(std::memory_order_relaxed);
     }
 
     V& GetValue() { return value_; }
 
     const K& GetKey() const { return key_; }
 
-    ~Node() { delete[] nexts_; }
+    ~Node() { delete[] upper_nexts_; }
 
  private:
+    std::atomic<Node<K, V>*>& Link(uint8_t level) { return level == 0 ? next_ : upper_nexts_[level - 1]; }
+
     uint8_t const height_;
     K const key_;
     V value_;
-    std::atomic<Node<K, V>*>* nexts_;
+    std::atomic<Node<K, V>*> next_;
+    std::atomic<Node<K, V>*>* upper_nexts_;
 };
 
 template <class K, class V, class Comparator>
@@ -253,6 +262,8 @@ class Skiplist {
 
     Node<K, V>* GetLast() { return tail_.load(std::memory_order_acquire); }
 
+    uint8_t GetBranch() const { return Branch; }
+
     uint32_t GetSize() {
         uint32_t cnt = 0;
         Node<K, V>* node = head_->GetNext(0);
@@ -352,6 +363,17 @@ class Skiplist {
 
         void SeekToLast() { node_ = list_->GetLast(); }
 
+        // Move over the nodes linked at `level` only. About one in Branch^level nodes are linked
+        // at a level, they are picked at random on insertion, so they spread evenly over the keys
+        void SeekToFirst(uint8_t level) {
+            node_ = level < list_->GetMaxHeight() ? list_->head_->GetNext(level) : NULL;
+        }
+
+        void Next(uint8_t level) {
+            assert(Valid());
+            node_ = node_->GetNext(level);
+        }
+
         uint32_t GetSize() { return list_->GetSize(); }
 
      private:
@@ -90,8 +90,8 @@ TEST_F(NodeTest, SetNext) {
 TEST_F(NodeTest, NodeByteSize) {
     std::atomic<Node<Slice, std::string*>*> node0[12];
     ASSERT_EQ(96u, sizeof(node0));
-    ASSERT_EQ(32u, sizeof(Node<uint64_t, void*>));
-    ASSERT_EQ(40u, sizeof(Node<Slice, void*>));
+    ASSERT_EQ(40u, sizeof(Node<uint64_t, void*>));
+    ASSERT_EQ(48u, sizeof(Node<Slice, void*>));
 }
 
 TEST_F(NodeTest, SliceTest) {
@@ -663,6 +663,40 @@ TEST_F(SkiplistTest, Duplicate) {
     ASSERT_FALSE(it->Valid());
 }
 
+TEST_F(SkiplistTest, IterateLevel) {
+    Comparator cmp;
+    Skiplist<uint32_t, uint32_t, Comparator> sl(12, 4, cmp);
+    Skiplist<uint32_t, uint32_t, Comparator>::Iterator* it = sl.NewIterator();
+    it->SeekToFirst(1);
+    ASSERT_FALSE(it->Valid());
+    for (uint32_t i = 0; i < 10000; i++) {
+        uint32_t value = i;
+        sl.Insert(i, value);
+    }
+    // level 0 links all nodes
+    uint32_t cnt = 0;
+    for (it->SeekToFirst(0); it->Valid(); it->Next(0)) {
+        cnt++;
+    }
+    ASSERT_EQ(10000u, cnt);
+    // about one in 16 nodes are linked at level 2, and they spread over all keys
+    std::vector<uint32_t> keys;
+    for (it->SeekToFirst(2); it->Valid(); it->Next(2)) {
+        keys.push_back(it->GetKey());
+    }
+    ASSERT_GT(keys.size(), 400u);
+    ASSERT_LT(keys.size(), 900u);
+    for (size_t i = 1; i < keys.size(); i++) {
+        ASSERT_LT(keys[i - 1], keys[i]);
+    }
+    ASSERT_LT(keys.front(), 500u);
+    ASSERT_GT(keys.back(), 9500u);
+    // no node is so high
+    it->SeekToFirst(11);
+    ASSERT_FALSE(it->Valid());
+    delete it;
+}
+
 }  // namespace base
 }  // namespace openmldb
 
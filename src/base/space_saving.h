@@ -0,0 +1,111 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_BASE_SPACE_SAVING_H_
+#define SRC_BASE_SPACE_SAVING_H_
+
+#include <algorithm>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/spinlock.h"
+
+namespace openmldb {
+namespace base {
+
+// Space-saving heavy hitter sketch. It keeps at most `capacity` counters, a new key takes over the
+// counter of the least counted key, so the count of a tracked key overestimates the real count by at most
+// the count it took over. Any key occurring more than total / capacity times is guaranteed to be tracked
+class SpaceSaving {
+ public:
+    explicit SpaceSaving(uint32_t capacity) : capacity_(std::max(capacity, 1u)), total_(0) {}
+
+    void Offer(const std::string& key, uint64_t cnt = 1) {
+        std::lock_guard<SpinMutex> lock(mu_);
+        total_ += cnt;
+        auto it = counters_.find(key);
+        if (it != counters_.end()) {
+            it->second += cnt;
+            return;
+        }
+        if (counters_.size() < capacity_) {
+            counters_.emplace(key, cnt);
+            return;
+        }
+        auto min_it = counters_.begin();
+        for (auto cur = counters_.begin(); cur != counters_.end(); ++cur) {
+            if (cur->second < min_it->second) {
+                min_it = cur;
+            }
+        }
+        uint64_t min_cnt = min_it->second;
+        counters_.erase(min_it);
+        counters_.emplace(key, min_cnt + cnt);
+    }
+
+    // the keys whose count is at least `min_ratio` of the total, in descending order of count
+    void GetTopK(uint32_t k, double min_ratio, std::vector<std::pair<std::string, uint64_t>>* top) {
+        top->clear();
+        {
+            std::lock_guard<SpinMutex> lock(mu_);
+            for (const auto& kv : counters_) {
+                if (kv.second >= total_ * min_ratio) {
+                    top->emplace_back(kv.first, kv.second);
+                }
+            }
+        }
+        std::sort(top->begin(), top->end(), [](const std::pair<std::string, uint64_t>& l,
+                                               const std::pair<std::string, uint64_t>& r) {
+            return l.second > r.second;
+        });
+        if (top->size() > k) {
+            top->resize(k);
+        }
+    }
+
+    // halve all the counts, so that the sketch follows the recent load
+    void Decay() {
+        std::lock_guard<SpinMutex> lock(mu_);
+        total_ /= 2;
+        for (auto it = counters_.begin(); it != counters_.end();) {
+            it->second /= 2;
+            if (it->second == 0) {
+                it = counters_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    uint64_t GetTotal() {
+        std::lock_guard<SpinMutex> lock(mu_);
+        return total_;
+    }
+
+ private:
+    const uint32_t capacity_;
+    uint64_t total_;
+    std::unordered_map<std::string, uint64_t> counters_;
+    SpinMutex mu_;
+};
+
+}  // namespace base
+}  // namespace openmldb
+
+#endif  // SRC_BASE_SPACE_SAVING_H_
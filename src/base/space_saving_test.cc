@@ -0,0 +1,86 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/space_saving.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace base {
+
+class SpaceSavingTest : public ::testing::Test {
+ public:
+    SpaceSavingTest() {}
+    ~SpaceSavingTest() {}
+};
+
+TEST_F(SpaceSavingTest, TopK) {
+    SpaceSaving sketch(8);
+    // two hot keys among many cold keys
+    for (int i = 0; i < 1000; i++) {
+        sketch.Offer("cold" + std::to_string(i));
+        if (i % 2 == 0) {
+            sketch.Offer("hot1");
+        }
+        if (i % 4 == 0) {
+            sketch.Offer("hot2");
+        }
+    }
+    ASSERT_EQ(1750u, sketch.GetTotal());
+    std::vector<std::pair<std::string, uint64_t>> top;
+    sketch.GetTopK(2, 0, &top);
+    ASSERT_EQ(2u, top.size());
+    ASSERT_EQ("hot1", top[0].first);
+    ASSERT_EQ("hot2", top[1].first);
+    ASSERT_GE(top[0].second, 500u);
+    ASSERT_GE(top[1].second, 250u);
+    sketch.GetTopK(8, 0.2, &top);
+    ASSERT_EQ(1u, top.size());
+    ASSERT_EQ("hot1", top[0].first);
+}
+
+TEST_F(SpaceSavingTest, Decay) {
+    SpaceSaving sketch(2);
+    sketch.Offer("key1", 8);
+    sketch.Offer("key2", 1);
+    sketch.Decay();
+    ASSERT_EQ(4u, sketch.GetTotal());
+    std::vector<std::pair<std::string, uint64_t>> top;
+    sketch.GetTopK(10, 0, &top);
+    ASSERT_EQ(1u, top.size());
+    ASSERT_EQ("key1", top[0].first);
+    ASSERT_EQ(4u, top[0].second);
+    // key3 takes over the counter of key2
+    sketch.Offer("key2");
+    sketch.Offer("key3");
+    sketch.GetTopK(10, 0, &top);
+    ASSERT_EQ(2u, top.size());
+    ASSERT_EQ("key1", top[0].first);
+    ASSERT_EQ("key3", top[1].first);
+    ASSERT_EQ(2u, top[1].second);
+}
+
+}  // namespace base
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
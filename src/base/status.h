@@ -163,7 +163,13 @@ enum ReturnCode {
     kSQLCmdRunError = 901,
 
     kSQLCompileError = 1000,
-    kSQLRunError = 1001
+    kSQLRunError = 1001,
+    kQueryCursorNotFound = 1002,
+    kReplicaTooStale = 1004,
+    // the tablet is overloaded and the request is rejected before running, it is safe to retry later
+    kTabletOverloaded = 1005,
+    // the key is moved to another partition by a split, the client should refresh its table info
+    kPartitionKeyMoved = 1006
 };
 
 struct Status {
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_BASE_YIELD_POINT_H_
+#define SRC_BASE_YIELD_POINT_H_
+
+namespace openmldb {
+namespace base {
+
+// Cooperative preemption of the low priority work. The storage iterators call YieldPoint::Check on every row,
+// it only costs a thread-local check unless a handler is installed on the current thread, which may pause the
+// thread while more urgent work is running. Install it only on the pthreads, not in bthreads
+class YieldPoint {
+ public:
+    using Handler = void (*)(void* arg);
+
+    static void Check() {
+        if (handler_ != nullptr) {
+            handler_(arg_);
+        }
+    }
+
+    // install the handler on current thread during the lifetime of the guard
+    class Guard {
+     public:
+        Guard(Handler handler, void* arg) : prev_handler_(handler_), prev_arg_(arg_) {
+            handler_ = handler;
+            arg_ = arg;
+        }
+        ~Guard() {
+            handler_ = prev_handler_;
+            arg_ = prev_arg_;
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+     private:
+        const Handler prev_handler_;
+        void* const prev_arg_;
+    };
+
+ private:
+    inline static thread_local Handler handler_ = nullptr;
+    inline static thread_local void* arg_ = nullptr;
+};
+
+}  // namespace base
+}  // namespace openmldb
+#endif  // SRC_BASE_YIELD_POINT_H_
@@ -18,10 +18,13 @@
 
 #include <utility>
 
+#include "butil/time.h"
 #include "codec/fe_schema_codec.h"
 #include "codec/sql_rpc_row_codec.h"
 
 DECLARE_int32(request_timeout_ms);
+DECLARE_uint32(sub_query_hedge_delay);
+DECLARE_uint32(sub_query_hedge_max_staleness);
 
 namespace openmldb {
 namespace catalog {
@@ -76,9 +79,15 @@ AsyncTableHandler::AsyncTableHandler(openmldb::RpcCallback<openmldb::api::SQLBat
                                      const bool is_common)
     : hybridse::vm::MemTableHandler("", "", nullptr),
       status_(::hybridse::base::Status::Running()),
-      callback_(callback),
-      request_is_common_(is_common) {
-    callback_->Ref();
+      callbacks_({callback}),
+      request_is_common_(is_common),
+      hedge_client_(),
+      hedge_request_(),
+      hedge_attachment_(),
+      hedge_time_(0),
+      queue_(),
+      queue_idx_(0) {
+    callback->Ref();
 }
 
 std::unique_ptr<hybridse::vm::RowIterator> AsyncTableHandler::GetIterator() {
@@ -100,16 +109,117 @@ hybridse::vm::RowIterator* AsyncTableHandler::GetRawIterator() {
     }
     return nullptr;
 }
+
+void AsyncTableHandler::SetHedge(const std::shared_ptr<::openmldb::client::TabletClient>& client,
+                                 const ::openmldb::api::SQLBatchRequestQueryRequest& request,
+                                 const butil::IOBuf& attachment) {
+    if (!client || FLAGS_sub_query_hedge_delay == 0) {
+        return;
+    }
+    hedge_client_ = client;
+    hedge_request_.CopyFrom(request);
+    hedge_attachment_ = attachment;
+    hedge_time_ = butil::gettimeofday_us() + FLAGS_sub_query_hedge_delay * 1000ul;
+}
+
+bool AsyncTableHandler::Hedge() {
+    if (hedge_time_ == 0 || !status_.isRunning()) {
+        return false;
+    }
+    hedge_time_ = 0;
+    auto cntl = std::make_shared<brpc::Controller>();
+    cntl->request_attachment() = hedge_attachment_;
+    cntl->set_timeout_ms(FLAGS_request_timeout_ms);
+    auto response = std::make_shared<::openmldb::api::SQLBatchRequestQueryResponse>();
+    auto callback = new openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>(response, cntl);
+    callback->Ref();
+    if (queue_) {
+        callback->SetCompletionQueue(queue_, queue_idx_);
+    }
+    if (!hedge_client_->SubBatchRequestQuery(hedge_request_, callback)) {
+        LOG(WARNING) << "fail to send hedged sub query to " << hedge_client_->GetEndpoint();
+        // the request is not sent and the callback will never run
+        callback->UnRef();
+        callback->UnRef();
+        return false;
+    }
+    DLOG(INFO) << "hedge sub query to " << hedge_client_->GetEndpoint();
+    callbacks_.push_back(callback);
+    return true;
+}
+
+void AsyncTableHandler::Watch(const std::shared_ptr<RpcCompletionQueue>& queue, size_t idx) {
+    queue_ = queue;
+    queue_idx_ = idx;
+    for (auto callback : callbacks_) {
+        callback->SetCompletionQueue(queue, idx);
+    }
+}
+
+bool AsyncTableHandler::TryFinish() {
+    if (!status_.isRunning()) {
+        return true;
+    }
+    bool all_done = true;
+    for (auto callback : callbacks_) {
+        if (!callback->IsDone()) {
+            all_done = false;
+            continue;
+        }
+        auto cntl = callback->GetController();
+        auto response = callback->GetResponse();
+        if (cntl && response && !cntl->Failed() && response->code() == 0) {
+            Decode(callback);
+            Cancel();
+            return true;
+        }
+    }
+    if (!all_done) {
+        return false;
+    }
+    // the primary call failed before the hedge delay, fail over to the follower right now
+    if (Hedge()) {
+        return false;
+    }
+    Decode(callbacks_.front());
+    return true;
+}
+
+void AsyncTableHandler::Cancel() {
+    hedge_time_ = 0;
+    for (auto callback : callbacks_) {
+        if (!callback->IsDone() && callback->GetController()) {
+            brpc::StartCancel(callback->GetController()->call_id());
+        }
+    }
+}
+
 void AsyncTableHandler::SyncRpcResponse() {
-    auto cntl = callback_->GetController();
-    auto response = callback_->GetResponse();
+    if (!queue_) {
+        Watch(std::make_shared<RpcCompletionQueue>(), 0);
+    }
+    size_t idx = 0;
+    while (!TryFinish()) {
+        int64_t timeout_us = -1;
+        if (hedge_time_ > 0) {
+            uint64_t now = butil::gettimeofday_us();
+            timeout_us = hedge_time_ > now ? hedge_time_ - now : 0;
+        }
+        if (!queue_->Pop(timeout_us, &idx)) {
+            Hedge();
+        }
+    }
+}
+
+void AsyncTableHandler::Decode(openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback) {
+    auto cntl = callback->GetController();
+    auto response = callback->GetResponse();
     if (!cntl || !response) {
         status_.code = hybridse::common::kRpcError;
         status_.msg = "rpc controller or response is null";
         LOG(WARNING) << status_.msg;
         return;
     }
-    brpc::Join(cntl->call_id());
     if (cntl->Failed()) {
         status_ = ::hybridse::base::Status(::hybridse::common::kRpcError, "request error. " + cntl->ErrorText());
         LOG(WARNING) << status_.msg;
@@ -173,36 +283,60 @@ hybridse::vm::RowIterator* AsyncTablesHandler::GetRawIterator() {
 bool AsyncTablesHandler::SyncAllTableHandlers() {
     DLOG(INFO) << "SyncAllTableHandlers rows_cnt_ " << rows_cnt_;
     Resize(rows_cnt_);
+    // consume the responses in the order they arrive, so that decoding overlaps with the outstanding calls
+    auto queue = std::make_shared<RpcCompletionQueue>();
+    std::vector<std::shared_ptr<AsyncTableHandler>> pending(handlers_.size());
+    size_t pending_cnt = 0;
+    auto cancel_pending = [&pending]() {
+        for (auto& handler : pending) {
+            if (handler) {
+                handler->Cancel();
+            }
+        }
+    };
     for (size_t handler_idx = 0; handler_idx < handlers_.size(); handler_idx++) {
-        auto& handler = handlers_[handler_idx];
-        auto iter = handler->GetIterator();
-        if (!handler->GetStatus().isOK()) {
-            status_.msg = "fail to sync table handler " + std::to_string(handler_idx) + ": " + handler->GetStatus().msg;
-            status_.code = handler->GetStatus().code;
-            LOG(WARNING) << status_;
+        auto async_handler = std::dynamic_pointer_cast<AsyncTableHandler>(handlers_[handler_idx]);
+        if (async_handler && async_handler->GetStatus().isRunning()) {
+            async_handler->Watch(queue, handler_idx);
+            pending[handler_idx] = async_handler;
+            pending_cnt++;
+        } else if (!SyncTableHandler(handler_idx)) {
+            cancel_pending();
             return false;
         }
-        if (!iter) {
-            status_.msg = "fail to sync table hander: iter is null";
-            status_.code = hybridse::common::kResponseError;
-            LOG(WARNING) << status_;
-            return false;
+    }
+    size_t handler_idx = 0;
+    while (pending_cnt > 0) {
+        uint64_t hedge_time = 0;
+        for (const auto& handler : pending) {
+            if (handler && handler->GetHedgeTime() > 0 &&
+                (hedge_time == 0 || handler->GetHedgeTime() < hedge_time)) {
+                hedge_time = handler->GetHedgeTime();
+            }
         }
-        auto& posinfo = posinfos_[handler_idx];
-        auto handler_count = handler->GetCount();
-        if (handler_count != posinfos_[handler_idx].size()) {
-            status_.msg = "fail to sync table : rows cnt " + std::to_string(handler_count) +
-                          " != " + std::to_string(posinfos_[handler_idx].size());
-            status_.code = hybridse::common::kResponseError;
-            LOG(WARNING) << status_;
-            return false;
+        int64_t timeout_us = -1;
+        if (hedge_time > 0) {
+            uint64_t now = butil::gettimeofday_us();
+            timeout_us = hedge_time > now ? hedge_time - now : 0;
+        }
+        if (!queue->Pop(timeout_us, &handler_idx)) {
+            uint64_t now = butil::gettimeofday_us();
+            for (auto& handler : pending) {
+                if (handler && handler->GetHedgeTime() > 0 && handler->GetHedgeTime() <= now) {
+                    handler->Hedge();
+                }
+            }
+            continue;
         }
-        size_t pos_idx = 0;
-        iter->SeekToFirst();
-        while (iter->Valid()) {
-            SetRow(posinfo[pos_idx], iter->GetValue());
-            iter->Next();
-            pos_idx++;
+        auto& handler = pending[handler_idx];
+        if (!handler || !handler->TryFinish()) {
+            continue;
+        }
+        handler.reset();
+        pending_cnt--;
+        if (!SyncTableHandler(handler_idx)) {
+            cancel_pending();
+            return false;
         }
     }
     status_ = hybridse::base::Status::OK();
@@ -210,6 +344,40 @@ bool AsyncTablesHandler::SyncAllTableHandlers() {
     return true;
 }
 
+bool AsyncTablesHandler::SyncTableHandler(size_t handler_idx) {
+    auto& handler = handlers_[handler_idx];
+    auto iter = handler->GetIterator();
+    if (!handler->GetStatus().isOK()) {
+        status_.msg = "fail to sync table handler " + std::to_string(handler_idx) + ": " + handler->GetStatus().msg;
+        status_.code = handler->GetStatus().code;
+        LOG(WARNING) << status_;
+        return false;
+    }
+    if (!iter) {
+        status_.msg = "fail to sync table hander: iter is null";
+        status_.code = hybridse::common::kResponseError;
+        LOG(WARNING) << status_;
+        return false;
+    }
+    auto& posinfo = posinfos_[handler_idx];
+    auto handler_count = handler->GetCount();
+    if (handler_count != posinfos_[handler_idx].size()) {
+        status_.msg = "fail to sync table : rows cnt " + std::to_string(handler_count) +
+                      " != " + std::to_string(posinfos_[handler_idx].size());
+        status_.code = hybridse::common::kResponseError;
+        LOG(WARNING) << status_;
+        return false;
+    }
+    size_t pos_idx = 0;
+    iter->SeekToFirst();
+    while (iter->Valid()) {
+        SetRow(posinfo[pos_idx], iter->GetValue());
+        iter->Next();
+        pos_idx++;
+    }
+    return true;
+}
+
 std::shared_ptr<::hybridse::vm::RowHandler> TabletAccessor::SubQuery(uint32_t task_id, const std::string& db,
                                                                      const std::string& sql,
                                                                      const ::hybridse::codec::Row& row,
@@ -317,6 +485,15 @@ std::shared_ptr<::hybridse::vm::TableHandler> TabletAccessor::SubQuery(uint32_t
     cntl->set_timeout_ms(FLAGS_request_timeout_ms);
     auto callback = new openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>(response, cntl);
     auto async_table_handler = std::make_shared<AsyncTableHandler>(callback, request_is_common);
+    if (hedge_client_ && FLAGS_sub_query_hedge_delay > 0) {
+        // the follower rejects the hedged query if it lags behind the leader too much
+        ::openmldb::api::SQLBatchRequestQueryRequest hedge_request(request);
+        auto bound = hedge_request.mutable_staleness_bound();
+        bound->set_tid(tid_);
+        bound->set_pid(pid_);
+        bound->set_max_ms(FLAGS_sub_query_hedge_max_staleness);
+        async_table_handler->SetHedge(hedge_client_, hedge_request, io_buf);
+    }
     if (!client->SubBatchRequestQuery(request, callback)) {
         LOG(WARNING) << "fail to query tablet";
         return std::make_shared<::hybridse::vm::ErrorTableHandler>(::hybridse::common::kRpcError,
@@ -362,6 +539,24 @@ std::shared_ptr<TabletAccessor> PartitionClientManager::GetFollower() {
     return std::shared_ptr<TabletAccessor>();
 }
 
+std::shared_ptr<TabletAccessor> PartitionClientManager::GetReplica() {
+    uint32_t it = rand_.Next() % (followers_.size() + 1);
+    if (it < followers_.size()) {
+        return followers_[it];
+    }
+    return leader_;
+}
+
+std::shared_ptr<TabletAccessor> PartitionClientManager::GetHedgedLeader(uint32_t tid) {
+    auto follower = GetFollower();
+    if (!leader_ || !follower) {
+        return leader_;
+    }
+    // keep the name of the tablet, so that the sub queries of all partitions on it are still merged into one
+    return std::make_shared<TabletAccessor>(leader_->GetName(), leader_->GetClient(), follower->GetClient(), tid,
+                                            pid_);
+}
+
 TableClientManager::TableClientManager(const TablePartitions& partitions, const ClientManager& client_manager) {
     for (const auto& table_partition : partitions) {
         uint32_t pid = table_partition.pid();
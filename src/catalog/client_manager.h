@@ -61,8 +61,8 @@ class AsyncTableHandler : public ::hybridse::vm::MemTableHandler {
     explicit AsyncTableHandler(openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback,
                                const bool is_common);
     ~AsyncTableHandler() {
-        if (nullptr != callback_) {
-            callback_->UnRef();
+        for (auto callback : callbacks_) {
+            callback->UnRef();
         }
     }
     const uint64_t GetCount() override {
@@ -85,11 +85,32 @@ class AsyncTableHandler : public ::hybridse::vm::MemTableHandler {
     const std::string GetHandlerTypeName() override { return "AsyncTableHandler"; }
     virtual hybridse::base::Status GetStatus() { return status_; }
 
+    // duplicate the request to `client` if no response arrives in --sub_query_hedge_delay ms
+    void SetHedge(const std::shared_ptr<::openmldb::client::TabletClient>& client,
+                  const ::openmldb::api::SQLBatchRequestQueryRequest& request, const butil::IOBuf& attachment);
+    // the time in us to send the hedged request, 0 if there is none to send
+    uint64_t GetHedgeTime() const { return hedge_time_; }
+    bool Hedge();
+    // push `idx` to `queue` when a response arrives
+    void Watch(const std::shared_ptr<RpcCompletionQueue>& queue, size_t idx);
+    // decode the first successful response without blocking, returns false if the result is not known yet
+    bool TryFinish();
+    // cancel the outstanding calls
+    void Cancel();
+
  private:
     void SyncRpcResponse();
+    void Decode(openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback);
     hybridse::base::Status status_;
-    openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback_;
+    // the first one is the primary call, the second one is the hedged call if sent
+    std::vector<openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>*> callbacks_;
     bool request_is_common_;
+    std::shared_ptr<::openmldb::client::TabletClient> hedge_client_;
+    ::openmldb::api::SQLBatchRequestQueryRequest hedge_request_;
+    butil::IOBuf hedge_attachment_;
+    uint64_t hedge_time_;
+    std::shared_ptr<RpcCompletionQueue> queue_;
+    size_t queue_idx_;
 };
 class AsyncTablesHandler : public ::hybridse::vm::MemTableHandler {
  public:
@@ -122,6 +143,7 @@ class AsyncTablesHandler : public ::hybridse::vm::MemTableHandler {
 
  private:
     bool SyncAllTableHandlers();
+    bool SyncTableHandler(size_t handler_idx);
     hybridse::base::Status status_;
     size_t rows_cnt_;
     std::vector<std::vector<size_t>> posinfos_;
@@ -135,6 +157,11 @@ class TabletAccessor : public ::hybridse::vm::Tablet {
     TabletAccessor(const std::string& name, const std::shared_ptr<::openmldb::client::TabletClient>& client)
         : name_(name), tablet_client_(client) {}
 
+    // the leader of partition `pid` which duplicates the slow batch request sub queries to `hedge_client`
+    TabletAccessor(const std::string& name, const std::shared_ptr<::openmldb::client::TabletClient>& client,
+                   const std::shared_ptr<::openmldb::client::TabletClient>& hedge_client, uint32_t tid, uint32_t pid)
+        : name_(name), tablet_client_(client), hedge_client_(hedge_client), tid_(tid), pid_(pid) {}
+
     std::shared_ptr<::openmldb::client::TabletClient> GetClient() {
         return std::atomic_load_explicit(&tablet_client_, std::memory_order_relaxed);
     }
@@ -165,9 +192,22 @@ class TabletAccessor : public ::hybridse::vm::Tablet {
                                                            const bool is_debug) override;
     const std::string& GetName() const { return name_; }
 
+    bool IsHedged() const { return hedge_client_ != nullptr; }
+
+    // true if both hedge the sub queries with a follower of the same partition
+    bool IsHedgedWith(const TabletAccessor& other) const {
+        return hedge_client_ && other.hedge_client_ && tid_ == other.tid_ && pid_ == other.pid_;
+    }
+
+    // the accessor of the same tablet which does not hedge the sub queries
+    std::shared_ptr<TabletAccessor> WithoutHedge() { return std::make_shared<TabletAccessor>(name_, GetClient()); }
+
  private:
     std::string name_;
     std::shared_ptr<::openmldb::client::TabletClient> tablet_client_;
+    std::shared_ptr<::openmldb::client::TabletClient> hedge_client_;
+    uint32_t tid_ = 0;
+    uint32_t pid_ = 0;
 };
 class TabletsAccessor : public ::hybridse::vm::Tablet {
  public:
@@ -186,6 +226,12 @@ class TabletsAccessor : public ::hybridse::vm::Tablet {
             posinfos_.push_back(std::vector<size_t>({rows_cnt_}));
             assign_accessor_idxs_.push_back(accessors_.size() - 1);
         } else {
+            // the sub queries of several partitions are merged, which the follower of one partition may not serve
+            auto merged = std::dynamic_pointer_cast<TabletAccessor>(accessors_[iter->second]);
+            auto tablet_accessor = std::dynamic_pointer_cast<TabletAccessor>(accessor);
+            if (merged && merged->IsHedged() && !(tablet_accessor && merged->IsHedgedWith(*tablet_accessor))) {
+                accessors_[iter->second] = merged->WithoutHedge();
+            }
             posinfos_[iter->second].push_back(rows_cnt_);
             assign_accessor_idxs_.push_back(iter->second);
         }
@@ -218,6 +264,13 @@ class PartitionClientManager {
 
     std::shared_ptr<TabletAccessor> GetFollower();
 
+    // the leader or a follower at random, to spread the reads over the replicas
+    std::shared_ptr<TabletAccessor> GetReplica();
+
+    // the leader which hedges the slow batch request sub queries with a follower of the partition,
+    // the leader itself if there is no follower
+    std::shared_ptr<TabletAccessor> GetHedgedLeader(uint32_t tid);
+
  private:
     uint32_t pid_;
     std::shared_ptr<TabletAccessor> leader_;
@@ -265,6 +318,20 @@ class TableClientManager {
         }
         return std::shared_ptr<TabletAccessor>();
     }
+    std::shared_ptr<TabletAccessor> GetHedgedTablet(uint32_t tid, uint32_t pid) const {
+        auto partition_manager = GetPartitionClientManager(pid);
+        if (partition_manager) {
+            return partition_manager->GetHedgedLeader(tid);
+        }
+        return std::shared_ptr<TabletAccessor>();
+    }
+    std::shared_ptr<TabletAccessor> GetReplica(uint32_t pid) const {
+        auto partition_manager = GetPartitionClientManager(pid);
+        if (partition_manager) {
+            return partition_manager->GetReplica();
+        }
+        return std::shared_ptr<TabletAccessor>();
+    }
     std::shared_ptr<TabletsAccessor> GetTablet(std::vector<uint32_t> pids) const {
         std::shared_ptr<TabletsAccessor> tablets_accessor = std::shared_ptr<TabletsAccessor>(new TabletsAccessor());
         for (size_t idx = 0; idx < pids.size(); idx++) {
@@ -72,6 +72,61 @@ TEST_F(ClientManagerTest, client_manager_test) {
               table_client_manager.GetPartitionClientManager(0)->GetLeader()->GetClient()->GetRealEndpoint());
 }
 
+TEST_F(ClientManagerTest, hedged_leader) {
+    auto leader = std::make_shared<TabletAccessor>(
+        "name0", std::make_shared<::openmldb::client::TabletClient>("name0", "endpoint0"));
+    auto follower = std::make_shared<TabletAccessor>(
+        "name1", std::make_shared<::openmldb::client::TabletClient>("name1", "endpoint1"));
+    PartitionClientManager no_follower(3, leader, {});
+    ASSERT_EQ(leader, no_follower.GetHedgedLeader(1));
+
+    PartitionClientManager partition(3, leader, {follower});
+    auto hedged = partition.GetHedgedLeader(1);
+    ASSERT_TRUE(hedged);
+    // sub queries of all partitions on the same tablet are still merged
+    ASSERT_EQ("name0", hedged->GetName());
+    ASSERT_EQ("endpoint0", hedged->GetClient()->GetRealEndpoint());
+    ASSERT_TRUE(hedged->IsHedged());
+    ASSERT_TRUE(hedged->IsHedgedWith(*partition.GetHedgedLeader(1)));
+
+    PartitionClientManager other_partition(4, leader, {follower});
+    auto other_hedged = other_partition.GetHedgedLeader(1);
+    ASSERT_EQ(hedged->GetName(), other_hedged->GetName());
+    ASSERT_FALSE(hedged->IsHedgedWith(*other_hedged));
+    auto not_hedged = hedged->WithoutHedge();
+    ASSERT_FALSE(not_hedged->IsHedged());
+    ASSERT_EQ("name0", not_hedged->GetName());
+    ASSERT_EQ("endpoint0", not_hedged->GetClient()->GetRealEndpoint());
+}
+
+TEST_F(ClientManagerTest, completion_queue) {
+    RpcCompletionQueue queue;
+    size_t idx = 0;
+    ASSERT_FALSE(queue.Pop(1000, &idx));
+    queue.Push(2);
+    queue.Push(0);
+    ASSERT_TRUE(queue.Pop(-1, &idx));
+    ASSERT_EQ(2u, idx);
+    ASSERT_TRUE(queue.Pop(0, &idx));
+    ASSERT_EQ(0u, idx);
+
+    auto response = std::make_shared<::openmldb::api::SQLBatchRequestQueryResponse>();
+    auto callback = new RpcCallback<::openmldb::api::SQLBatchRequestQueryResponse>(
+        response, std::make_shared<brpc::Controller>());
+    callback->Ref();
+    auto completions = std::make_shared<RpcCompletionQueue>();
+    callback->SetCompletionQueue(completions, 5);
+    ASSERT_FALSE(completions->Pop(1000, &idx));
+    callback->Run();
+    ASSERT_TRUE(completions->Pop(-1, &idx));
+    ASSERT_EQ(5u, idx);
+    // a call which is done already is pushed right away
+    callback->SetCompletionQueue(completions, 6);
+    ASSERT_TRUE(completions->Pop(0, &idx));
+    ASSERT_EQ(6u, idx);
+    callback->UnRef();
+}
+
 }  // namespace catalog
 }  // namespace openmldb
 
@@ -16,6 +16,14 @@
 
 #include "catalog/distribute_iterator.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <utility>
+
+#include "base/yield_point.h"
+#include "vm/profile.h"
+
 namespace openmldb {
 namespace catalog {
 
@@ -23,8 +31,11 @@ FullTableIterator::FullTableIterator(std::shared_ptr<Tables> tables)
     : tables_(tables), cur_pid_(0), it_(), key_(0), value_() {}
 
 void FullTableIterator::SeekToFirst() {
+    ::hybridse::vm::Profiler::CountSeek();
     it_.reset();
     for (const auto& kv : *tables_) {
+        // every partition scanned by a sql counts as a read in the load reported to the nameserver
+        kv.second->IncrReadCnt();
         it_.reset(kv.second->NewTraverseIterator(0));
         it_->SeekToFirst();
         if (it_->Valid()) {
@@ -38,6 +49,8 @@ void FullTableIterator::SeekToFirst() {
 bool FullTableIterator::Valid() const { return it_ && it_->Valid(); }
 
 void FullTableIterator::Next() {
+    ::hybridse::vm::Profiler::CountNext();
+    ::openmldb::base::YieldPoint::Check();
     it_->Next();
     if (!it_->Valid()) {
         auto iter = tables_->find(cur_pid_);
@@ -45,6 +58,7 @@ void FullTableIterator::Next() {
             return;
         }
         for (iter++; iter != tables_->end(); iter++) {
+            iter->second->IncrReadCnt();
             it_.reset(iter->second->NewTraverseIterator(0));
             it_->SeekToFirst();
             if (it_->Valid()) {
@@ -59,18 +73,75 @@ void FullTableIterator::Next() {
 }
 
 const ::hybridse::codec::Row& FullTableIterator::GetValue() {
-    value_ = ::hybridse::codec::Row(
-        ::hybridse::base::RefCountedSlice::Create(it_->GetValue().data(), it_->GetValue().size()));
+    auto data = it_->GetValue();
+    auto iter = tables_->find(cur_pid_);
+    if (iter != tables_->end() && iter->second->GetCompressType() == ::openmldb::type::kZstd) {
+        // the decompressed row is in a buffer reused by the next row
+        auto buf = reinterpret_cast<int8_t*>(malloc(data.size()));
+        memcpy(buf, data.data(), data.size());
+        value_ = ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::CreateManaged(buf, data.size()));
+    } else {
+        value_ = ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::Create(data.data(), data.size()));
+    }
+    ::hybridse::vm::Profiler::CountDecode(data.size());
     return value_;
 }
 
-DistributeWindowIterator::DistributeWindowIterator(std::shared_ptr<Tables> tables, uint32_t index)
-    : tables_(tables), index_(index), cur_pid_(0), pid_num_(1), it_() {
-    if (tables && !tables->empty()) {
-        pid_num_ = tables->begin()->second->GetTableMeta()->table_partition_size();
+RangeTableIterator::RangeTableIterator(std::vector<std::shared_ptr<::openmldb::storage::Table>>&& tables,
+                                       std::vector<std::unique_ptr<::openmldb::storage::TableIterator>>&& its)
+    : tables_(std::move(tables)), its_(std::move(its)), cur_idx_(0), key_(0), value_() {}
+
+void RangeTableIterator::SkipEmpty() {
+    while (cur_idx_ < its_.size() && !its_[cur_idx_]->Valid()) {
+        cur_idx_++;
+        if (cur_idx_ < its_.size()) {
+            tables_[cur_idx_]->IncrReadCnt();
+            its_[cur_idx_]->SeekToFirst();
+        }
+    }
+}
+
+void RangeTableIterator::SeekToFirst() {
+    ::hybridse::vm::Profiler::CountSeek();
+    cur_idx_ = 0;
+    key_ = 0;
+    if (its_.empty()) {
+        return;
+    }
+    tables_[0]->IncrReadCnt();
+    its_[0]->SeekToFirst();
+    SkipEmpty();
+}
+
+bool RangeTableIterator::Valid() const { return cur_idx_ < its_.size() && its_[cur_idx_]->Valid(); }
+
+void RangeTableIterator::Next() {
+    ::hybridse::vm::Profiler::CountNext();
+    ::openmldb::base::YieldPoint::Check();
+    its_[cur_idx_]->Next();
+    key_++;
+    SkipEmpty();
+}
+
+const ::hybridse::codec::Row& RangeTableIterator::GetValue() {
+    auto data = its_[cur_idx_]->GetValue();
+    if (tables_[cur_idx_]->GetCompressType() == ::openmldb::type::kZstd) {
+        // the decompressed row is in a buffer reused by the next row
+        auto buf = reinterpret_cast<int8_t*>(malloc(data.size()));
+        memcpy(buf, data.data(), data.size());
+        value_ = ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::CreateManaged(buf, data.size()));
+    } else {
+        value_ = ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::Create(data.data(), data.size()));
     }
+    ::hybridse::vm::Profiler::CountDecode(data.size());
+    return value_;
 }
 
+DistributeWindowIterator::DistributeWindowIterator(
+    std::shared_ptr<Tables> tables, uint32_t index, uint32_t pid_num,
+    const ::google::protobuf::RepeatedPtrField<::openmldb::common::PartitionSplit>& splits)
+    : tables_(tables), index_(index), cur_pid_(0), pid_num_(pid_num), splits_(splits), it_() {}
+
 void DistributeWindowIterator::Seek(const std::string& key) {
     // assume all partitions in one tablet
     DLOG(INFO) << "seek to key " << key;
@@ -78,11 +149,11 @@ void DistributeWindowIterator::Seek(const std::string& key) {
     if (!tables_) {
         return;
     }
-    if (pid_num_ > 0) {
-        cur_pid_ = (uint32_t)(::openmldb::base::hash64(key) % pid_num_);
-    }
+    cur_pid_ = ::openmldb::base::GetPartitionId(key, pid_num_, splits_);
     auto iter = tables_->find(cur_pid_);
     if (iter != tables_->end()) {
+        // the lookups of the request mode count as reads of the partition owning the key
+        iter->second->IncrReadCnt();
         it_.reset(iter->second->NewWindowIterator(index_));
         it_->Seek(key);
         if (it_->Valid()) {
@@ -109,6 +180,7 @@ void DistributeWindowIterator::SeekToFirst() {
         return;
     }
     for (const auto& kv : *tables_) {
+        kv.second->IncrReadCnt();
         it_.reset(kv.second->NewWindowIterator(index_));
         it_->SeekToFirst();
         if (it_->Valid()) {
@@ -126,6 +198,7 @@ void DistributeWindowIterator::Next() {
             return;
         }
         for (iter++; iter != tables_->end(); iter++) {
+            iter->second->IncrReadCnt();
             it_.reset(iter->second->NewWindowIterator(index_));
             it_->SeekToFirst();
             if (it_->Valid()) {
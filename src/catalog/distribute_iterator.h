@@ -20,8 +20,9 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
-#include "base/hash.h"
+#include "base/partition_router.h"
 #include "storage/table.h"
 #include "vm/catalog.h"
 
@@ -50,9 +51,35 @@ class FullTableIterator : public ::hybridse::codec::ConstIterator<uint64_t, ::hy
     ::hybridse::codec::Row value_;
 };
 
+// Iterates the rows in a value range of a column on the local partitions, each of which is scanned by its range index
+class RangeTableIterator : public ::hybridse::codec::ConstIterator<uint64_t, ::hybridse::codec::Row> {
+ public:
+    RangeTableIterator(std::vector<std::shared_ptr<::openmldb::storage::Table>>&& tables,
+                       std::vector<std::unique_ptr<::openmldb::storage::TableIterator>>&& its);
+    void Seek(const uint64_t& key) override {}
+    void SeekToFirst() override;
+    bool Valid() const override;
+    void Next() override;
+    const ::hybridse::codec::Row& GetValue() override;
+    bool IsSeekable() const override { return false; }
+    // the row num
+    const uint64_t& GetKey() const override { return key_; }
+
+ private:
+    void SkipEmpty();
+
+ private:
+    std::vector<std::shared_ptr<::openmldb::storage::Table>> tables_;
+    std::vector<std::unique_ptr<::openmldb::storage::TableIterator>> its_;
+    uint32_t cur_idx_;
+    uint64_t key_;
+    ::hybridse::codec::Row value_;
+};
+
 class DistributeWindowIterator : public ::hybridse::codec::WindowIterator {
  public:
-    DistributeWindowIterator(std::shared_ptr<Tables> tables, uint32_t index);
+    DistributeWindowIterator(std::shared_ptr<Tables> tables, uint32_t index, uint32_t pid_num,
+                             const ::google::protobuf::RepeatedPtrField<::openmldb::common::PartitionSplit>& splits);
     void Seek(const std::string& key) override;
     void SeekToFirst() override;
     void Next() override;
@@ -66,6 +93,7 @@ class DistributeWindowIterator : public ::hybridse::codec::WindowIterator {
     uint32_t index_;
     uint32_t cur_pid_;
     uint32_t pid_num_;
+    ::google::protobuf::RepeatedPtrField<::openmldb::common::PartitionSplit> splits_;
     std::unique_ptr<::hybridse::codec::WindowIterator> it_;
 };
 
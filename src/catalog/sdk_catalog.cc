@@ -16,7 +16,7 @@
 
 #include "catalog/sdk_catalog.h"
 
-#include "base/hash.h"
+#include "base/partition_router.h"
 #include "glog/logging.h"
 #include "schema/index_util.h"
 #include "schema/schema_adapter.h"
@@ -84,6 +84,12 @@ bool SDKTableHandler::Init() {
         }
         index_hint_.insert(std::make_pair(index_st.name, index_st));
     }
+    for (const auto& column_key : meta_.column_key()) {
+        ::openmldb::codec::IndexKeyEncoder encoder;
+        if (encoder.Init(column_key, meta_.column_desc()) && encoder.IsMemcomparable()) {
+            key_encoders_.emplace(column_key.index_name(), std::move(encoder));
+        }
+    }
     VLOG(5) << "init table handler for table " << name_ << " in db " << db_ << " done";
     return true;
 }
@@ -93,18 +99,30 @@ std::shared_ptr<::hybridse::vm::Tablet> SDKTableHandler::GetTablet(const std::st
     if (index_name.empty() || pk.empty()) {
         return std::shared_ptr<::hybridse::vm::Tablet>();
     }
-    uint32_t pid = 0;
-    uint32_t pid_num = meta_.table_partition_size();
-    if (pid_num > 0) {
-        pid = (uint32_t)(::openmldb::base::hash64(pk) % pid_num);
+    auto encoder = key_encoders_.find(index_name);
+    if (encoder != key_encoders_.end()) {
+        std::string key;
+        if (!encoder->second.EncodeDelimited(pk, &key)) {
+            LOG(WARNING) << "fail to encode key " << pk << " of index " << index_name;
+            return std::shared_ptr<::hybridse::vm::Tablet>();
+        }
+        return table_client_manager_->GetTablet(GetPid(key));
     }
-    return table_client_manager_->GetTablet(pid);
+    return table_client_manager_->GetTablet(GetPid(pk));
+}
+
+uint32_t SDKTableHandler::GetPid(const std::string& pk) const {
+    return ::openmldb::base::GetPartitionId(pk, meta_.table_partition_size(), meta_.partition_split());
 }
 
 std::shared_ptr<TabletAccessor> SDKTableHandler::GetTablet(uint32_t pid) {
     return table_client_manager_->GetTablet(pid);
 }
 
+std::shared_ptr<TabletAccessor> SDKTableHandler::GetReplica(uint32_t pid) {
+    return table_client_manager_->GetReplica(pid);
+}
+
 bool SDKTableHandler::GetTablet(std::vector<std::shared_ptr<TabletAccessor>>* tablets) {
     if (tablets == nullptr) {
         return false;
@@ -28,6 +28,7 @@
 #include "catalog/base.h"
 #include "catalog/client_manager.h"
 #include "client/tablet_client.h"
+#include "codec/index_key_codec.h"
 #include "proto/name_server.pb.h"
 #include "vm/catalog.h"
 
@@ -74,12 +75,17 @@ class SDKTableHandler : public ::hybridse::vm::TableHandler {
 
     std::shared_ptr<TabletAccessor> GetTablet(uint32_t pid);
 
+    std::shared_ptr<TabletAccessor> GetReplica(uint32_t pid);
+
     bool GetTablet(std::vector<std::shared_ptr<TabletAccessor>>* tablets);
 
     inline uint32_t GetTid() const { return meta_.tid(); }
 
     inline uint32_t GetPartitionNum() const { return meta_.table_partition_size(); }
 
+    // the partition which the key is routed to, following the partition splits of the table
+    uint32_t GetPid(const std::string& pk) const;
+
     inline int32_t GetColumnIndex(const std::string& column) {
         auto it = types_.find(column);
         if (it != types_.end()) {
@@ -96,6 +102,8 @@ class SDKTableHandler : public ::hybridse::vm::TableHandler {
     ::hybridse::vm::Types types_;
     ::hybridse::vm::IndexList index_list_;
     ::hybridse::vm::IndexHint index_hint_;
+    // index name -> key encoder
+    std::map<std::string, ::openmldb::codec::IndexKeyEncoder> key_encoders_;
     uint64_t cnt_;
     std::shared_ptr<TableClientManager> table_client_manager_;
 };
@@ -21,7 +21,9 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "base/partition_router.h"
 #include "catalog/distribute_iterator.h"
 #include "codec/list_iterator_codec.h"
 #include "glog/logging.h"
@@ -29,6 +31,8 @@
 #include "schema/schema_adapter.h"
 
 DECLARE_bool(enable_localtablet);
+DECLARE_uint32(planner_stats_sample_key_cnt);
+DECLARE_uint32(sub_query_hedge_delay);
 namespace openmldb {
 namespace catalog {
 
@@ -40,6 +44,7 @@ TabletTableHandler::TabletTableHandler(const ::openmldb::api::TableMeta& meta,
       types_(),
       index_list_(),
       index_hint_(),
+      key_encoders_(),
       table_client_manager_(),
       local_tablet_(local_tablet) {}
 
@@ -51,6 +56,7 @@ TabletTableHandler::TabletTableHandler(const ::openmldb::nameserver::TableInfo&
       types_(),
       index_list_(),
       index_hint_(),
+      key_encoders_(),
       table_client_manager_(),
       local_tablet_(local_tablet) {}
 
@@ -83,6 +89,15 @@ bool TabletTableHandler::UpdateIndex(
         const ::google::protobuf::RepeatedPtrField<::openmldb::common::ColumnKey>& indexs) {
     index_list_.Clear();
     index_hint_.clear();
+    key_encoders_.clear();
+    for (const auto& column_key : indexs) {
+        ::openmldb::codec::IndexKeyEncoder encoder;
+        if (!encoder.Init(column_key, table_st_.GetColumns())) {
+            LOG(WARNING) << "fail to init key encoder of index " << column_key.index_name();
+            continue;
+        }
+        key_encoders_.emplace(column_key.index_name(), std::move(encoder));
+    }
     if (!schema::IndexUtil::ConvertIndex(indexs, &index_list_)) {
         LOG(WARNING) << "fail to conver index to sql index";
         return false;
@@ -134,7 +149,8 @@ std::unique_ptr<::hybridse::codec::WindowIterator> TabletTableHandler::GetWindow
     auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
     if (!tables->empty()) {
         return std::unique_ptr<::hybridse::codec::WindowIterator>(
-            new DistributeWindowIterator(tables, iter->second.index));
+            new DistributeWindowIterator(tables, iter->second.index, table_st_.GetPartitionNum(),
+                                         table_st_.GetPartitionSplit()));
     }
     return std::unique_ptr<::hybridse::codec::WindowIterator>();
 }
@@ -179,9 +195,139 @@ std::shared_ptr<::hybridse::vm::PartitionHandler> TabletTableHandler::GetPartiti
         LOG(WARNING) << "fail to get partition for tablet table handler, index name " << index_name;
         return std::shared_ptr<::hybridse::vm::PartitionHandler>();
     }
+    auto encoder = key_encoders_.find(index_name);
+    if (encoder != key_encoders_.end()) {
+        return std::make_shared<TabletPartitionHandler>(shared_from_this(), index_name, encoder->second);
+    }
     return std::make_shared<TabletPartitionHandler>(shared_from_this(), index_name);
 }
 
+bool TabletTableHandler::GetIndexStatistics(const std::string& index_name, ::hybridse::vm::IndexStatistics* stats) {
+    if (stats == nullptr) {
+        return false;
+    }
+    auto iter = index_hint_.find(index_name);
+    if (iter == index_hint_.end()) {
+        return false;
+    }
+    // the statistics of a part of the partitions are biased, and the plan would depend on which tablet compiles it.
+    // Without all partitions, the planner falls back to the same rule as the sdk, which holds no partition
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    if (tables->empty() || tables->size() < GetPartitionNum()) {
+        return false;
+    }
+    uint32_t sample_cnt = FLAGS_planner_stats_sample_key_cnt / tables->size() + 1;
+    std::vector<uint64_t> key_counts;
+    for (const auto& kv : *tables) {
+        uint64_t pk_cnt = 0;
+        uint64_t idx_cnt = 0;
+        if (!kv.second->GetIndexStats(iter->second.index, sample_cnt, &pk_cnt, &idx_cnt, &key_counts)) {
+            return false;
+        }
+        stats->key_cnt += pk_cnt;
+        stats->row_cnt += idx_cnt;
+    }
+    for (auto cnt : key_counts) {
+        stats->AddSampledKey(cnt);
+    }
+    return true;
+}
+
+bool TabletTableHandler::HasRangeIndex(const std::string& column) {
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    if (tables->empty()) {
+        return false;
+    }
+    for (const auto& kv : *tables) {
+        auto table_meta = kv.second->GetTableMeta();
+        bool found = false;
+        for (const auto& range_index : table_meta->range_index()) {
+            if (range_index.col_name() == column) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<::hybridse::codec::RowIterator> TabletTableHandler::GetRangeIterator(
+    const ::hybridse::vm::ColumnRange& range) {
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    if (tables->empty()) {
+        return std::unique_ptr<::hybridse::codec::RowIterator>();
+    }
+    std::vector<std::shared_ptr<::openmldb::storage::Table>> range_tables;
+    std::vector<std::unique_ptr<::openmldb::storage::TableIterator>> its;
+    for (const auto& kv : *tables) {
+        std::unique_ptr<::openmldb::storage::TableIterator> it(kv.second->NewRangeIterator(range));
+        if (!it) {
+            DLOG(INFO) << "no range index for " << range.ToString() << " in pid " << kv.first;
+            return std::unique_ptr<::hybridse::codec::RowIterator>();
+        }
+        range_tables.push_back(kv.second);
+        its.push_back(std::move(it));
+    }
+    return std::unique_ptr<::hybridse::codec::RowIterator>(
+        new catalog::RangeTableIterator(std::move(range_tables), std::move(its)));
+}
+
+bool TabletTableHandler::GetKeyVersion(const std::string& index_name, const std::string& key, uint64_t* version) {
+    auto iter = index_hint_.find(index_name);
+    if (iter == index_hint_.end()) {
+        return false;
+    }
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    auto table = tables->find(GetPid(key));
+    if (table == tables->end()) {
+        return false;
+    }
+    return table->second->GetKeyVersion(iter->second.index, key, version);
+}
+
+bool TabletTableHandler::GetKeyExpireTime(const std::string& index_name, const std::string& key,
+                                          uint64_t* expire_time) {
+    auto iter = index_hint_.find(index_name);
+    if (iter == index_hint_.end()) {
+        return false;
+    }
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    auto table = tables->find(GetPid(key));
+    if (table == tables->end()) {
+        return false;
+    }
+    auto index_def = table->second->GetIndex(iter->second.index);
+    if (!index_def || !index_def->GetTTL()) {
+        return false;
+    }
+    // the same expire time as the storage iterators of the index see
+    *expire_time = table->second->GetExpireTime(*index_def->GetTTL());
+    return *expire_time > 0;
+}
+
+bool TabletPartitionHandler::GetKeyVersion(const std::string& key, uint64_t* version) {
+    auto table_handler = std::dynamic_pointer_cast<TabletTableHandler>(table_handler_);
+    return table_handler && table_handler->GetKeyVersion(index_name_, key, version);
+}
+
+bool TabletPartitionHandler::GetKeyExpireTime(const std::string& key, uint64_t* expire_time) {
+    auto table_handler = std::dynamic_pointer_cast<TabletTableHandler>(table_handler_);
+    return table_handler && table_handler->GetKeyExpireTime(index_name_, key, expire_time);
+}
+
+bool TabletSegmentHandler::GetVersion(uint64_t* version) {
+    auto partition_handler = std::dynamic_pointer_cast<TabletPartitionHandler>(partition_handler_);
+    return partition_handler && partition_handler->GetKeyVersion(key_, version);
+}
+
+bool TabletSegmentHandler::GetExpireTime(uint64_t* expire_time) {
+    auto partition_handler = std::dynamic_pointer_cast<TabletPartitionHandler>(partition_handler_);
+    return partition_handler && partition_handler->GetKeyExpireTime(key_, expire_time);
+}
+
 void TabletTableHandler::AddTable(std::shared_ptr<::openmldb::storage::Table> table) {
     std::shared_ptr<Tables> old_tables;
     std::shared_ptr<Tables> new_tables;
@@ -222,13 +368,32 @@ void TabletTableHandler::Update(const ::openmldb::nameserver::TableInfo& meta, c
     }
 }
 
+uint32_t TabletTableHandler::GetPid(const std::string& pk) const {
+    return ::openmldb::base::GetPartitionId(pk, table_st_.GetPartitionNum(), table_st_.GetPartitionSplit());
+}
+
+bool TabletTableHandler::EncodeKey(const std::string& index_name, const std::string& key,
+                                   std::string* encoded_key) const {
+    auto iter = key_encoders_.find(index_name);
+    if (iter == key_encoders_.end() || !iter->second.IsMemcomparable()) {
+        *encoded_key = key;
+        return true;
+    }
+    if (!iter->second.EncodeDelimited(key, encoded_key)) {
+        LOG(WARNING) << "fail to encode key " << key << " of index " << index_name;
+        return false;
+    }
+    return true;
+}
+
 std::shared_ptr<::hybridse::vm::Tablet> TabletTableHandler::GetTablet(const std::string& index_name,
                                                                       const std::string& pk) {
     uint32_t pid_num = table_st_.GetPartitionNum();
-    uint32_t pid = 0;
-    if (pid_num > 0) {
-        pid = (uint32_t)(::openmldb::base::hash64(pk) % pid_num);
+    std::string encoded_pk;
+    if (!EncodeKey(index_name, pk, &encoded_pk)) {
+        return std::shared_ptr<::hybridse::vm::Tablet>();
     }
+    uint32_t pid = GetPid(encoded_pk);
     DLOG(INFO) << "pid num " << pid_num << " get tablet with pid = " << pid;
     auto tables = std::atomic_load_explicit(&tables_, std::memory_order_relaxed);
     // return local tablet only when --enable_localtablet==true
@@ -236,7 +401,12 @@ std::shared_ptr<::hybridse::vm::Tablet> TabletTableHandler::GetTablet(const std:
         DLOG(INFO) << "get tablet index_name " << index_name << ", pk " << pk << ", local_tablet_";
         return local_tablet_;
     }
-    auto client_tablet = table_client_manager_->GetTablet(pid);
+    std::shared_ptr<TabletAccessor> client_tablet;
+    if (FLAGS_sub_query_hedge_delay > 0) {
+        client_tablet = table_client_manager_->GetHedgedTablet(table_st_.GetTid(), pid);
+    } else {
+        client_tablet = table_client_manager_->GetTablet(pid);
+    }
     if (!client_tablet) {
         DLOG(INFO) << "get tablet index_name " << index_name << ", pk " << pk << ", tablet nullptr";
     } else {
@@ -433,6 +603,19 @@ bool TabletCatalog::UpdateTableInfo(const ::openmldb::nameserver::TableInfo& tab
             }
             db_it->second.emplace(table_name, handler);
             LOG(INFO) << "add table " << table_name << " db " << db_name;
+        } else if (it->second->GetPartitionNum() != static_cast<uint32_t>(table_info.table_partition_size())) {
+            // the table is split, rebuild the handler so that the routing of all the keys switches at once
+            handler = std::make_shared<TabletTableHandler>(table_info, local_tablet_);
+            if (!handler->Init(client_manager_)) {
+                LOG(WARNING) << "tablet handler init failed";
+                return false;
+            }
+            for (const auto& kv : *(it->second->GetTables())) {
+                handler->AddTable(kv.second);
+            }
+            it->second = handler;
+            LOG(INFO) << "update partition num of table " << table_name << " db " << db_name << " to "
+                      << table_info.table_partition_size();
         } else {
             handler = it->second;
         }
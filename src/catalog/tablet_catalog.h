@@ -28,10 +28,12 @@
 #include "catalog/client_manager.h"
 #include "catalog/distribute_iterator.h"
 #include "client/tablet_client.h"
+#include "codec/index_key_codec.h"
 #include "codec/row.h"
 #include "storage/schema.h"
 #include "storage/table.h"
 #include "sdk/sql_cluster_router.h"
+#include "vm/mem_catalog.h"
 
 namespace openmldb {
 namespace catalog {
@@ -112,6 +114,11 @@ class TabletSegmentHandler : public ::hybridse::vm::TableHandler {
     }
     const std::string GetHandlerTypeName() override { return "TabletSegmentHandler"; }
 
+    // the version of the rows of the key in local storage
+    bool GetVersion(uint64_t *version) override;
+    // the expire time of the abs ttl of the index in local storage
+    bool GetExpireTime(uint64_t *expire_time) override;
+
  private:
     std::shared_ptr<::hybridse::vm::PartitionHandler> partition_handler_;
     std::string key_;
@@ -121,7 +128,11 @@ class TabletPartitionHandler : public ::hybridse::vm::PartitionHandler,
                                public std::enable_shared_from_this<hybridse::vm::PartitionHandler> {
  public:
     TabletPartitionHandler(std::shared_ptr<::hybridse::vm::TableHandler> table_hander, const std::string &index_name)
-        : PartitionHandler(), table_handler_(table_hander), index_name_(index_name) {}
+        : PartitionHandler(), table_handler_(table_hander), index_name_(index_name), key_encoder_() {}
+
+    TabletPartitionHandler(std::shared_ptr<::hybridse::vm::TableHandler> table_hander, const std::string &index_name,
+                           const ::openmldb::codec::IndexKeyEncoder &key_encoder)
+        : PartitionHandler(), table_handler_(table_hander), index_name_(index_name), key_encoder_(key_encoder) {}
 
     ~TabletPartitionHandler() {}
 
@@ -154,14 +165,29 @@ class TabletPartitionHandler : public ::hybridse::vm::PartitionHandler,
         return cnt;
     }
 
+    // the key generated by sql engine is joined with "|", it is encoded as the keys in storage. A key which can not be
+    // encoded matches no key in storage, so its segment is empty
     std::shared_ptr<::hybridse::vm::TableHandler> GetSegment(const std::string &key) override {
+        if (key_encoder_.IsMemcomparable()) {
+            std::string encoded_key;
+            if (!key_encoder_.EncodeDelimited(key, &encoded_key)) {
+                LOG(WARNING) << "fail to encode key " << key << " of index " << index_name_;
+                return std::make_shared<::hybridse::vm::MemTimeTableHandler>(GetName(), GetDatabase(), GetSchema());
+            }
+            return std::make_shared<TabletSegmentHandler>(shared_from_this(), encoded_key);
+        }
         return std::make_shared<TabletSegmentHandler>(shared_from_this(), key);
     }
     const std::string GetHandlerTypeName() override { return "TabletPartitionHandler"; }
 
+    // `key` is the key encoded as the keys in storage
+    bool GetKeyVersion(const std::string &key, uint64_t *version);
+    bool GetKeyExpireTime(const std::string &key, uint64_t *expire_time);
+
  private:
     std::shared_ptr<::hybridse::vm::TableHandler> table_handler_;
     std::string index_name_;
+    ::openmldb::codec::IndexKeyEncoder key_encoder_;
 };
 
 class TabletTableHandler : public ::hybridse::vm::TableHandler,
@@ -203,12 +229,36 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
     std::shared_ptr<::hybridse::vm::PartitionHandler> GetPartition(const std::string &index_name) override;
     const std::string GetHandlerTypeName() override { return "TabletTableHandler"; }
 
+    // statistics are collected from the partitions on local tablet
+    bool GetIndexStatistics(const std::string &index_name, ::hybridse::vm::IndexStatistics *stats) override;
+
+    // true if all the partitions on local tablet have a range index on `column`
+    bool HasRangeIndex(const std::string &column) override;
+
+    std::unique_ptr<::hybridse::codec::RowIterator> GetRangeIterator(const ::hybridse::vm::ColumnRange &range) override;
+
+    // get the version of an encoded key from the partition on local tablet, see storage::Table::GetKeyVersion
+    bool GetKeyVersion(const std::string &index_name, const std::string &key, uint64_t *version);
+    // get the current expire time of the abs ttl of an index from the partition of an encoded key on local tablet,
+    // return false if the rows of the index never expire by time
+    bool GetKeyExpireTime(const std::string &index_name, const std::string &key, uint64_t *expire_time);
+
     std::shared_ptr<::hybridse::vm::Tablet> GetTablet(const std::string &index_name, const std::string &pk) override;
     std::shared_ptr<::hybridse::vm::Tablet> GetTablet(const std::string &index_name,
                                                       const std::vector<std::string> &pks) override;
 
     inline int32_t GetTid() { return table_st_.GetTid(); }
 
+    inline uint32_t GetPartitionNum() const { return table_st_.GetPartitionNum(); }
+
+    uint32_t GetPid(const std::string &pk) const;
+
+    // encode a key generated by sql engine as the keys of the index in storage, return false if the key can not be
+    // encoded, e.g. a column value is not a valid value of the column type
+    bool EncodeKey(const std::string &index_name, const std::string &key, std::string *encoded_key) const;
+
+    std::shared_ptr<Tables> GetTables() const { return std::atomic_load_explicit(&tables_, std::memory_order_acquire); }
+
     void AddTable(std::shared_ptr<::openmldb::storage::Table> table);
 
     bool HasLocalTable();
@@ -233,6 +283,8 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
     ::hybridse::vm::Types types_;
     ::hybridse::vm::IndexList index_list_;
     ::hybridse::vm::IndexHint index_hint_;
+    // index name -> key encoder
+    std::map<std::string, ::openmldb::codec::IndexKeyEncoder> key_encoders_;
     std::shared_ptr<TableClientManager> table_client_manager_;
     std::shared_ptr<hybridse::vm::Tablet> local_tablet_;
 };
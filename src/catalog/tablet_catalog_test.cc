@@ -303,6 +303,47 @@ TEST_F(TabletCatalogTest, segment_handler_pk_not_exist_test) {
     }
 }
 
+TEST_F(TabletCatalogTest, index_statistics_test) {
+    TestArgs args = PrepareTable("t1", 10, 4);
+    TabletTableHandler handler(args.meta[0], std::shared_ptr<hybridse::vm::Tablet>());
+    ClientManager client_manager;
+    ASSERT_TRUE(handler.Init(client_manager));
+    ::hybridse::vm::IndexStatistics stats;
+    // no local partition
+    ASSERT_FALSE(handler.GetIndexStatistics(args.idx_name, &stats));
+    handler.AddTable(args.tables[0]);
+    ASSERT_FALSE(handler.GetIndexStatistics("index_not_exist", &stats));
+    ASSERT_TRUE(handler.GetIndexStatistics(args.idx_name, &stats));
+    ASSERT_EQ(10u, stats.key_cnt);
+    ASSERT_EQ(40u, stats.row_cnt);
+    // all keys hold 4 rows
+    ASSERT_EQ(3u, stats.key_histogram.size());
+    ASSERT_EQ(0u, stats.key_histogram[0]);
+    ASSERT_EQ(0u, stats.key_histogram[1]);
+    ASSERT_EQ(10u, stats.key_histogram[2]);
+}
+
+TEST_F(TabletCatalogTest, index_statistics_partial_partitions_test) {
+    uint32_t pid_num = 8;
+    TestArgs args = PrepareMultiPartitionTable("t1", pid_num);
+    TabletTableHandler handler(args.meta[0], std::shared_ptr<hybridse::vm::Tablet>());
+    ClientManager client_manager;
+    ASSERT_TRUE(handler.Init(client_manager));
+    ::hybridse::vm::IndexStatistics stats;
+    // the statistics of a part of the partitions are not reported
+    for (uint32_t pid = 0; pid < pid_num - 1; pid++) {
+        handler.AddTable(args.tables[pid]);
+        ASSERT_FALSE(handler.GetIndexStatistics(args.idx_name, &stats));
+    }
+    handler.AddTable(args.tables[pid_num - 1]);
+    ASSERT_TRUE(handler.GetIndexStatistics(args.idx_name, &stats));
+    ASSERT_EQ(100u, stats.key_cnt);
+    ASSERT_EQ(500u, stats.row_cnt);
+    // all keys hold 5 rows
+    ASSERT_EQ(3u, stats.key_histogram.size());
+    ASSERT_LT(0u, stats.key_histogram[2]);
+}
+
 TEST_F(TabletCatalogTest, sql_smoke_test) {
     std::shared_ptr<TabletCatalog> catalog(new TabletCatalog());
     ASSERT_TRUE(catalog->Init());
@@ -922,6 +922,18 @@ bool NsClient::DeleteIndex(const std::string& table_name, const std::string& idx
     return DeleteIndex(GetDb(), table_name, idx_name, msg);
 }
 
+bool NsClient::SplitPartition(const std::string& table_name, uint32_t pid, std::string* msg) {
+    ::openmldb::nameserver::SplitPartitionRequest request;
+    ::openmldb::nameserver::GeneralResponse response;
+    request.set_name(table_name);
+    request.set_db(GetDb());
+    request.set_pid(pid);
+    bool ok = client_.SendRequest(&::openmldb::nameserver::NameServer_Stub::SplitPartition, &request, &response,
+                                  FLAGS_request_timeout_ms, 1);
+    *msg = response.msg();
+    return ok && response.code() == 0;
+}
+
 bool NsClient::ShowCatalogVersion(std::map<std::string, uint64_t>* version_map, std::string* msg) {
     if (version_map == nullptr || msg == nullptr) {
         return false;
@@ -225,6 +225,8 @@ class NsClient : public Client {
     bool DeleteIndex(const std::string& db, const std::string& table_name, const std::string& idx_name,
                      std::string& msg);  // NOLINT
 
+    bool SplitPartition(const std::string& table_name, uint32_t pid, std::string* msg);
+
     bool DropProcedure(const std::string& db_name, const std::string& sp_name,
                        std::string& msg);  // NOLINT
 
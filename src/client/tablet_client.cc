@@ -47,13 +47,17 @@ TabletClient::~TabletClient() {}
 int TabletClient::Init() { return client_.Init(); }
 
 bool TabletClient::Query(const std::string& db, const std::string& sql, const std::string& row, brpc::Controller* cntl,
-                         openmldb::api::QueryResponse* response, const bool is_debug) {
+                         openmldb::api::QueryResponse* response, const bool is_debug,
+                         const ::openmldb::api::StalenessBound* bound) {
     if (cntl == NULL || response == NULL) return false;
     ::openmldb::api::QueryRequest request;
     request.set_sql(sql);
     request.set_db(db);
     request.set_is_batch(false);
     request.set_is_debug(is_debug);
+    if (bound != nullptr) {
+        request.mutable_staleness_bound()->CopyFrom(*bound);
+    }
     request.set_row_size(row.size());
     request.set_row_slices(1);
     auto& io_buf = cntl->request_attachment();
@@ -72,13 +76,18 @@ bool TabletClient::Query(const std::string& db, const std::string& sql, const st
 bool TabletClient::Query(const std::string& db, const std::string& sql,
                          const std::vector<openmldb::type::DataType>& parameter_types,
                          const std::string& parameter_row,
-                         brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug) {
+                         brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug,
+                         uint32_t page_size, const bool is_profile) {
     if (cntl == NULL || response == NULL) return false;
     ::openmldb::api::QueryRequest request;
     request.set_sql(sql);
     request.set_db(db);
     request.set_is_batch(true);
     request.set_is_debug(is_debug);
+    request.set_is_profile(is_profile);
+    if (page_size > 0) {
+        request.set_page_size(page_size);
+    }
     request.set_parameter_row_size(parameter_row.size());
     request.set_parameter_row_slices(1);
     for (auto& type : parameter_types) {
@@ -98,6 +107,61 @@ bool TabletClient::Query(const std::string& db, const std::string& sql,
     return true;
 }
 
+bool TabletClient::Query(const std::string& db, const std::string& sql,
+                         const std::vector<openmldb::type::DataType>& parameter_types,
+                         const std::string& parameter_row, const bool is_debug,
+                         openmldb::RpcCallback<openmldb::api::QueryResponse>* callback) {
+    if (callback == nullptr) {
+        return false;
+    }
+    ::openmldb::api::QueryRequest request;
+    request.set_sql(sql);
+    request.set_db(db);
+    request.set_is_batch(true);
+    request.set_is_debug(is_debug);
+    request.set_parameter_row_size(parameter_row.size());
+    request.set_parameter_row_slices(1);
+    for (auto& type : parameter_types) {
+        request.add_parameter_types(type);
+    }
+    auto& io_buf = callback->GetController()->request_attachment();
+    if (!codec::EncodeRpcRow(reinterpret_cast<const int8_t*>(parameter_row.data()), parameter_row.size(), &io_buf)) {
+        LOG(WARNING) << "Encode parameter buffer failed";
+        return false;
+    }
+    return client_.SendRequest(&::openmldb::api::TabletServer_Stub::Query, callback->GetController().get(), &request,
+                               callback->GetResponse().get(), callback);
+}
+
+bool TabletClient::FetchQueryPage(uint64_t cursor_id, uint32_t page_size, brpc::Controller* cntl,
+                                  ::openmldb::api::QueryResponse* response) {
+    if (cntl == NULL || response == NULL) return false;
+    ::openmldb::api::QueryRequest request;
+    request.set_is_batch(true);
+    request.set_cursor_id(cursor_id);
+    request.set_page_size(page_size);
+    bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::Query, cntl, &request, response);
+    if (!ok || response->code() != 0) {
+        LOG(WARNING) << "fail to fetch query page of cursor " << cursor_id;
+        return false;
+    }
+    return true;
+}
+
+bool TabletClient::CloseQueryCursor(uint64_t cursor_id, uint64_t timeout_ms) {
+    ::openmldb::api::QueryRequest request;
+    request.set_is_batch(true);
+    request.set_cursor_id(cursor_id);
+    request.set_close_cursor(true);
+    ::openmldb::api::QueryResponse response;
+    bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::Query, &request, &response, timeout_ms, 0);
+    if (!ok || response.code() != 0) {
+        LOG(WARNING) << "fail to close query cursor " << cursor_id;
+        return false;
+    }
+    return true;
+}
+
 /**
  * Utility function to encode row batch data into rpc attachment buffer
  */
@@ -130,12 +194,15 @@ static bool EncodeRowBatch(std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch>
 bool TabletClient::SQLBatchRequestQuery(const std::string& db, const std::string& sql,
                                         std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch> row_batch,
                                         brpc::Controller* cntl, ::openmldb::api::SQLBatchRequestQueryResponse* response,
-                                        const bool is_debug) {
+                                        const bool is_debug, const ::openmldb::api::StalenessBound* bound) {
     if (cntl == NULL || response == NULL) return false;
     ::openmldb::api::SQLBatchRequestQueryRequest request;
     request.set_sql(sql);
     request.set_db(db);
     request.set_is_debug(is_debug);
+    if (bound != nullptr) {
+        request.mutable_staleness_bound()->CopyFrom(*bound);
+    }
 
     const std::set<size_t>& indices_set = row_batch->common_column_indices();
     for (size_t idx : indices_set) {
@@ -242,11 +309,12 @@ bool TabletClient::UpdateTableMetaForAddField(uint32_t tid, const std::vector<op
 
 bool TabletClient::Put(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
                        const std::vector<std::pair<std::string, uint32_t>>& dimensions) {
-    return Put(tid, pid, time, value, dimensions, 0);
+    return Put(tid, pid, time, value, dimensions, 0).OK();
 }
 
-bool TabletClient::Put(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
-                       const std::vector<std::pair<std::string, uint32_t>>& dimensions, uint32_t format_version) {
+base::Status TabletClient::Put(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
+                               const std::vector<std::pair<std::string, uint32_t>>& dimensions,
+                               uint32_t format_version) {
     ::openmldb::api::PutRequest request;
     request.set_time(time);
     request.set_value(value);
@@ -261,11 +329,15 @@ bool TabletClient::Put(uint32_t tid, uint32_t pid, uint64_t time, const std::str
     ::openmldb::api::PutResponse response;
     bool ok =
         client_.SendRequest(&::openmldb::api::TabletServer_Stub::Put, &request, &response, FLAGS_request_timeout_ms, 1);
-    if (ok && response.code() == 0) {
-        return true;
+    if (!ok) {
+        LOG(WARNING) << "fail to send write request to " << GetEndpoint();
+        return {base::ReturnCode::kError, "fail to send write request to " + GetEndpoint()};
     }
-    LOG(WARNING) << "fail to send write request for " << response.msg() << " and error code " << response.code();
-    return false;
+    if (response.code() != 0) {
+        LOG(WARNING) << "fail to write for " << response.msg() << " and error code " << response.code();
+        return {response.code(), response.msg()};
+    }
+    return {};
 }
 
 
@@ -558,7 +630,12 @@ bool TabletClient::GetManifest(uint32_t tid, uint32_t pid, ::openmldb::api::Mani
 }
 
 bool TabletClient::GetTableStatus(::openmldb::api::GetTableStatusResponse& response) {
+    return GetTableStatus(false, response);
+}
+
+bool TabletClient::GetTableStatus(bool need_hot_key, ::openmldb::api::GetTableStatusResponse& response) {
     ::openmldb::api::GetTableStatusRequest request;
+    request.set_need_hot_key(need_hot_key);
     bool ret = client_.SendRequest(&::openmldb::api::TabletServer_Stub::GetTableStatus, &request, &response,
                                    FLAGS_request_timeout_ms, 1);
     if (ret) {
@@ -1122,6 +1199,43 @@ bool TabletClient::DumpIndexData(uint32_t tid, uint32_t pid, uint32_t partition_
     return true;
 }
 
+bool TabletClient::SplitTable(uint32_t tid, uint32_t pid, uint32_t new_pid, uint64_t modulus,
+                              std::shared_ptr<TaskInfo> task_info) {
+    ::openmldb::api::SplitTableRequest request;
+    ::openmldb::api::GeneralResponse response;
+    request.set_tid(tid);
+    request.set_pid(pid);
+    request.set_new_pid(new_pid);
+    request.set_modulus(modulus);
+    if (task_info) {
+        request.mutable_task_info()->CopyFrom(*task_info);
+    }
+    bool ok = client_.SendRequest(&openmldb::api::TabletServer_Stub::SplitTable, &request, &response,
+                                  FLAGS_request_timeout_ms, 1);
+    if (!ok || response.code() != 0) {
+        return false;
+    }
+    return true;
+}
+
+bool TabletClient::FinishSplitTable(uint32_t tid, uint32_t pid, uint64_t modulus,
+                                    std::shared_ptr<TaskInfo> task_info) {
+    ::openmldb::api::FinishSplitTableRequest request;
+    ::openmldb::api::GeneralResponse response;
+    request.set_tid(tid);
+    request.set_pid(pid);
+    request.set_modulus(modulus);
+    if (task_info) {
+        request.mutable_task_info()->CopyFrom(*task_info);
+    }
+    bool ok = client_.SendRequest(&openmldb::api::TabletServer_Stub::FinishSplitTable, &request, &response,
+                                  FLAGS_request_timeout_ms, 1);
+    if (!ok || response.code() != 0) {
+        return false;
+    }
+    return true;
+}
+
 bool TabletClient::SendIndexData(uint32_t tid, uint32_t pid, const std::map<uint32_t, std::string>& pid_endpoint_map,
                                  std::shared_ptr<TaskInfo> task_info) {
     ::openmldb::api::SendIndexDataRequest request;
@@ -1435,5 +1549,34 @@ bool TabletClient::GetAndFlushDeployStats(::openmldb::api::DeployStatsResponse*
     return ok && res->code() == 0;
 }
 
+base::Status TabletClient::GetBulkLoadInfo(uint32_t tid, uint32_t pid,
+                                           ::openmldb::api::BulkLoadInfoResponse* response) {
+    ::openmldb::api::BulkLoadInfoRequest request;
+    request.set_tid(tid);
+    request.set_pid(pid);
+    bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::GetBulkLoadInfo, &request, response,
+                                  FLAGS_request_timeout_ms, FLAGS_request_max_retry);
+    if (!ok || response->code() != 0) {
+        return {base::ReturnCode::kError, "fail to get bulk load info from " + GetEndpoint() + ". " + response->msg()};
+    }
+    return {};
+}
+
+base::Status TabletClient::BulkLoad(const ::openmldb::api::BulkLoadRequest& request, butil::IOBuf* data) {
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(FLAGS_request_timeout_ms);
+    if (data != nullptr) {
+        cntl.request_attachment().swap(*data);
+    }
+    ::openmldb::api::GeneralResponse response;
+    // not retried, the tablet requires the parts in order
+    bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::BulkLoad, &cntl, &request, &response);
+    if (!ok || response.code() != 0) {
+        return {base::ReturnCode::kError, "fail to bulk load part " + std::to_string(request.part_id()) + " to " +
+                                              GetEndpoint() + ". " + response.msg()};
+    }
+    return {};
+}
+
 }  // namespace client
 }  // namespace openmldb
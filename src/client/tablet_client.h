@@ -69,14 +69,30 @@ class TabletClient : public Client {
 
     bool Query(const std::string& db, const std::string& sql,
                const std::vector<openmldb::type::DataType>& parameter_types, const std::string& parameter_row,
-               brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug = false);
+               brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug = false,
+               uint32_t page_size = 0, const bool is_profile = false);
 
+    // send a batch query without waiting for the response, `callback` runs when it arrives
+    bool Query(const std::string& db, const std::string& sql,
+               const std::vector<openmldb::type::DataType>& parameter_types, const std::string& parameter_row,
+               const bool is_debug, openmldb::RpcCallback<openmldb::api::QueryResponse>* callback);
+
+    // fetch the next page of a batch query opened with page_size
+    bool FetchQueryPage(uint64_t cursor_id, uint32_t page_size, brpc::Controller* cntl,
+                        ::openmldb::api::QueryResponse* response);
+
+    // release a cursor whose rest rows will not be fetched
+    bool CloseQueryCursor(uint64_t cursor_id, uint64_t timeout_ms);
+
+    // `bound` is set when the query is sent to a replica which may be a follower
     bool Query(const std::string& db, const std::string& sql, const std::string& row, brpc::Controller* cntl,
-               ::openmldb::api::QueryResponse* response, const bool is_debug = false);
+               ::openmldb::api::QueryResponse* response, const bool is_debug = false,
+               const ::openmldb::api::StalenessBound* bound = nullptr);
 
     bool SQLBatchRequestQuery(const std::string& db, const std::string& sql,
                               std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch>, brpc::Controller* cntl,
-                              ::openmldb::api::SQLBatchRequestQueryResponse* response, const bool is_debug = false);
+                              ::openmldb::api::SQLBatchRequestQueryResponse* response, const bool is_debug = false,
+                              const ::openmldb::api::StalenessBound* bound = nullptr);
 
     bool Put(uint32_t tid, uint32_t pid, const std::string& pk, uint64_t time, const std::string& value,
              uint32_t format_version = 0);
@@ -87,8 +103,8 @@ class TabletClient : public Client {
     bool Put(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
              const std::vector<std::pair<std::string, uint32_t>>& dimensions);
 
-    bool Put(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
-             const std::vector<std::pair<std::string, uint32_t>>& dimensions, uint32_t format_version);
+    base::Status Put(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
+                     const std::vector<std::pair<std::string, uint32_t>>& dimensions, uint32_t format_version);
 
 
 
@@ -193,6 +209,7 @@ class TabletClient : public Client {
                      ::openmldb::api::Manifest& manifest);  // NOLINT
 
     bool GetTableStatus(::openmldb::api::GetTableStatusResponse& response);  // NOLINT
+    bool GetTableStatus(bool need_hot_key, ::openmldb::api::GetTableStatusResponse& response);  // NOLINT
     bool GetTableStatus(uint32_t tid, uint32_t pid,
                         ::openmldb::api::TableStatus& table_status);  // NOLINT
     bool GetTableStatus(uint32_t tid, uint32_t pid, bool need_schema,
@@ -233,6 +250,11 @@ class TabletClient : public Client {
                        const ::openmldb::common::ColumnKey& column_key, uint32_t idx,
                        std::shared_ptr<TaskInfo> task_info);
 
+    bool SplitTable(uint32_t tid, uint32_t pid, uint32_t new_pid, uint64_t modulus,
+                    std::shared_ptr<TaskInfo> task_info);
+
+    bool FinishSplitTable(uint32_t tid, uint32_t pid, uint64_t modulus, std::shared_ptr<TaskInfo> task_info);
+
     bool GetCatalog(uint64_t* version);
 
     bool SendIndexData(uint32_t tid, uint32_t pid, const std::map<uint32_t, std::string>& pid_endpoint_map,
@@ -286,6 +308,11 @@ class TabletClient : public Client {
 
     bool GetAndFlushDeployStats(::openmldb::api::DeployStatsResponse* res);
 
+    base::Status GetBulkLoadInfo(uint32_t tid, uint32_t pid, ::openmldb::api::BulkLoadInfoResponse* response);
+
+    // the data region of the request is sent in the attachment
+    base::Status BulkLoad(const ::openmldb::api::BulkLoadRequest& request, butil::IOBuf* data);
+
  private:
     ::openmldb::RpcClient<::openmldb::api::TabletServer_Stub> client_;
     std::vector<uint64_t> percentile_;
@@ -27,9 +27,9 @@
 
 #include "base/file_util.h"
 #include "base/glog_wapper.h"
-#include "base/hash.h"
 #include "base/ip.h"
 #include "base/linenoise.h"
+#include "base/partition_router.h"
 #include "base/kv_iterator.h"
 #include "base/server_name.h"
 #include "base/strings.h"
@@ -317,7 +317,7 @@ int PutData(uint32_t tid, const std::map<uint32_t, std::vector<std::pair<std::st
             }
         }
 
-        if (!clients[endpoint]->Put(tid, pid, ts, value, iter->second, format_version)) {
+        if (!clients[endpoint]->Put(tid, pid, ts, value, iter->second, format_version).OK()) {
             printf("put failed. tid %u pid %u endpoint %s ts %lu \n", tid, pid, endpoint.c_str(), ts);
             return -1;
         }
@@ -340,7 +340,7 @@ int PutData(uint32_t tid, const std::map<uint32_t, std::vector<std::pair<std::st
         if (codec.CombinePartitionKey(input_value, &key) < 0) {
             return ::openmldb::base::Status(-1, "combine partition key error");
         }
-        uint32_t pid = (uint32_t)(::openmldb::base::hash64(key) % part_size);
+        uint32_t pid = ::openmldb::base::GetPartitionId(key, part_size, table_info.partition_split());
         if (pid != 0) {
             auto pair = dimensions.emplace(pid, ::openmldb::codec::Dimension());
             dimensions[0].swap(pair.first->second);
@@ -1122,7 +1122,8 @@ void HandleNSDelete(const std::vector<std::string>& parts, ::openmldb::client::N
         }
         uint32_t tid = tables[0].tid();
         std::string key = parts[2];
-        uint32_t pid = (uint32_t)(::openmldb::base::hash64(key) % tables[0].table_partition_size());
+        uint32_t pid =
+            ::openmldb::base::GetPartitionId(key, tables[0].table_partition_size(), tables[0].partition_split());
         std::shared_ptr<::openmldb::client::TabletClient> tablet_client = GetTabletClient(tables[0], pid, msg);
         if (!tablet_client) {
             std::cout << "failed to delete. error msg: " << msg << std::endl;
@@ -1446,7 +1447,8 @@ void HandleNSGet(const std::vector<std::string>& parts, ::openmldb::client::NsCl
         return;
     }
     uint32_t tid = tables[0].tid();
-    uint32_t pid = (uint32_t)(::openmldb::base::hash64(key) % tables[0].table_partition_size());
+    uint32_t pid =
+        ::openmldb::base::GetPartitionId(key, tables[0].table_partition_size(), tables[0].partition_split());
     std::shared_ptr<TabletClient> tb_client = GetTabletClient(tables[0], pid, msg);
     if (!tb_client) {
         std::cout << "failed to get. error msg: " << msg << std::endl;
@@ -1626,7 +1628,8 @@ void HandleNSScan(const std::vector<std::string>& parts, ::openmldb::client::NsC
         return;
     }
     uint32_t tid = tables[0].tid();
-    uint32_t pid = (uint32_t)(::openmldb::base::hash64(key) % tables[0].table_partition_size());
+    uint32_t pid =
+        ::openmldb::base::GetPartitionId(key, tables[0].table_partition_size(), tables[0].partition_split());
     std::shared_ptr<TabletClient> tb_client = GetTabletClient(tables[0], pid, msg);
     if (!tb_client) {
         std::cout << "failed to scan. error msg: " << msg << std::endl;
@@ -1807,7 +1810,8 @@ void HandleNSCount(const std::vector<std::string>& parts, ::openmldb::client::Ns
         return;
     }
     uint32_t tid = tables[0].tid();
-    uint32_t pid = (uint32_t)(::openmldb::base::hash64(key) % tables[0].table_partition_size());
+    uint32_t pid =
+        ::openmldb::base::GetPartitionId(key, tables[0].table_partition_size(), tables[0].partition_split());
     std::shared_ptr<::openmldb::client::TabletClient> tablet_client = GetTabletClient(tables[0], pid, msg);
     if (!tablet_client) {
         std::cout << "failed to count. cannot not found tablet client, pid is " << pid << std::endl;
@@ -2383,6 +2387,7 @@ void HandleNSClientHelp(const std::vector<std::string>& parts, ::openmldb::clien
         printf("switchmode - switch cluster mode\n");
         printf("synctable - synctable from leader cluster to replica cluster\n");
         printf("deleteindx - delete index of specified table\n");
+        printf("splitpartition - split a partition into two\n");
         printf("setsdkendpoint - set sdkendpoint for external network sdk\n");
         printf("showcatalogversion - show catalog version\n");
     } else if (parts.size() == 2) {
@@ -2620,6 +2625,10 @@ void HandleNSClientHelp(const std::vector<std::string>& parts, ::openmldb::clien
             printf("desc: delete index of specified index\n");
             printf("usage: deleteindex table_name index_name");
             printf("usage: deleteindex test index0");
+        } else if (parts[1] == "splitpartition") {
+            printf("desc: move the upper half of the keys of a partition to a new partition\n");
+            printf("usage: splitpartition table_name pid\n");
+            printf("ex: splitpartition table1 0\n");
         } else if (parts[1] == "createdb") {
             printf("desc: create database\n");
             printf("usage: createdb database_name\n");
@@ -2875,6 +2884,27 @@ void HandleNSClientDeleteIndex(const std::vector<std::string>& parts, ::openmldb
     std::cout << "delete index ok" << std::endl;
 }
 
+void HandleNSClientSplitPartition(const std::vector<std::string>& parts, ::openmldb::client::NsClient* client) {
+    if (parts.size() != 3) {
+        std::cout << "Bad format" << std::endl;
+        std::cout << "usage: splitpartition table_name pid" << std::endl;
+        return;
+    }
+    uint32_t pid = 0;
+    try {
+        pid = boost::lexical_cast<uint32_t>(parts[2]);
+    } catch (std::exception const& e) {
+        std::cout << "Invalid args. pid should be uint32_t" << std::endl;
+        return;
+    }
+    std::string msg;
+    if (!client->SplitPartition(parts[1], pid, &msg)) {
+        std::cout << "Fail to split partition. error msg: " << msg << std::endl;
+        return;
+    }
+    std::cout << "split partition ok" << std::endl;
+}
+
 void HandleClientDeleteIndex(const std::vector<std::string>& parts, ::openmldb::client::TabletClient* client) {
     ::openmldb::nameserver::GeneralResponse response;
     if (parts.size() < 4) {
@@ -4170,6 +4200,8 @@ void StartNsClient() {
             HandleNSClientAddIndex(parts, &client);
         } else if (parts[0] == "deleteindex") {
             HandleNSClientDeleteIndex(parts, &client);
+        } else if (parts[0] == "splitpartition") {
+            HandleNSClientSplitPartition(parts, &client);
         } else if (parts[0] == "showdb") {
             HandleNSShowDB(&client);
         } else if (parts[0] == "showcatalogversion") {
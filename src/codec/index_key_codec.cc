@@ -0,0 +1,284 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codec/index_key_codec.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "codec/codec.h"
+#include "codec/field_codec.h"
+#include "codec/schema_codec.h"
+
+namespace openmldb {
+namespace codec {
+
+static bool ParseInteger(const std::string& value, int64_t min, int64_t max, int64_t* out) {
+    if (value.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    int64_t v = strtoll(value.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || v < min || v > max) {
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+static bool ParseDate(const std::string& value, int32_t* date) {
+    if (value.find('-') == std::string::npos) {
+        int64_t v = 0;
+        if (!ParseInteger(value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(), &v)) {
+            return false;
+        }
+        *date = static_cast<int32_t>(v);
+        return true;
+    }
+    uint32_t year = 0;
+    uint32_t month = 0;
+    uint32_t day = 0;
+    char tail = 0;
+    if (sscanf(value.c_str(), "%u-%u-%u%c", &year, &month, &day, &tail) != 3 || year < 1900 || month < 1 ||
+        month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    *date = static_cast<int32_t>(((year - 1900) << 16) | ((month - 1) << 8) | day);
+    return true;
+}
+
+bool IndexKeyEncoder::Init(const ::openmldb::common::ColumnKey& column_key,
+                           const google::protobuf::RepeatedPtrField<::openmldb::common::ColumnDesc>& columns) {
+    encoding_ = column_key.key_encoding();
+    types_.clear();
+    for (const auto& name : column_key.col_name()) {
+        auto iter = std::find_if(columns.begin(), columns.end(),
+                                 [&name](const ::openmldb::common::ColumnDesc& col) { return col.name() == name; });
+        if (iter == columns.end()) {
+            return false;
+        }
+        types_.push_back(iter->data_type());
+    }
+    return true;
+}
+
+bool IndexKeyEncoder::PackColumn(const std::string& value, ::openmldb::type::DataType type, std::string* key) {
+    if (value == NONETOKEN) {
+        key->push_back(KEY_NULL_FLAG);
+        return true;
+    }
+    key->push_back(KEY_NOT_NULL_FLAG);
+    switch (type) {
+        case ::openmldb::type::kBool: {
+            int8_t v = 0;
+            if (value == "true") {
+                v = 1;
+            } else if (value != "false") {
+                return false;
+            }
+            return PackValue(&v, type, key);
+        }
+        case ::openmldb::type::kSmallInt: {
+            int64_t v = 0;
+            if (!ParseInteger(value, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max(), &v)) {
+                return false;
+            }
+            int16_t s = static_cast<int16_t>(v);
+            return PackValue(&s, type, key);
+        }
+        case ::openmldb::type::kInt: {
+            int64_t v = 0;
+            if (!ParseInteger(value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(), &v)) {
+                return false;
+            }
+            int32_t i = static_cast<int32_t>(v);
+            return PackValue(&i, type, key);
+        }
+        case ::openmldb::type::kDate: {
+            int32_t date = 0;
+            if (!ParseDate(value, &date)) {
+                return false;
+            }
+            return PackValue(&date, type, key);
+        }
+        case ::openmldb::type::kBigInt:
+        case ::openmldb::type::kTimestamp: {
+            int64_t v = 0;
+            if (!ParseInteger(value, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), &v)) {
+                return false;
+            }
+            return PackValue(&v, type, key);
+        }
+        case ::openmldb::type::kString:
+        case ::openmldb::type::kVarchar: {
+            const std::string& str = value == EMPTY_STRING ? "" : value;
+            size_t k_size = key->size();
+            key->resize(k_size + GetDstStrSize(str.size()));
+            void* to = &(*key)[k_size];
+            return PackString(str.data(), str.size(), &to) == 0;
+        }
+        default: {
+            PDLOG(WARNING, "unsupported key type %s", ::openmldb::type::DataType_Name(type).c_str());
+            return false;
+        }
+    }
+}
+
+bool IndexKeyEncoder::Encode(const std::vector<std::string>& values, std::string* key) const {
+    key->clear();
+    if (!IsMemcomparable()) {
+        for (const auto& value : values) {
+            if (!key->empty()) {
+                key->append("|");
+            }
+            key->append(value);
+        }
+        return true;
+    }
+    if (values.size() != types_.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < values.size(); i++) {
+        if (!PackColumn(values[i], types_[i], key)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IndexKeyEncoder::EncodeDelimited(const std::string& delimited_key, std::string* key) const {
+    if (!IsMemcomparable()) {
+        key->assign(delimited_key);
+        return true;
+    }
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (true) {
+        size_t pos = delimited_key.find('|', start);
+        if (pos == std::string::npos) {
+            parts.emplace_back(delimited_key.substr(start));
+            break;
+        }
+        parts.emplace_back(delimited_key.substr(start, pos - start));
+        start = pos + 1;
+    }
+    if (parts.size() > types_.size()) {
+        // only the values of string columns can contain the delimiter, merge the redundant parts into
+        // the string column if there is exactly one
+        int32_t str_pos = -1;
+        for (size_t i = 0; i < types_.size(); i++) {
+            if (types_[i] == ::openmldb::type::kString || types_[i] == ::openmldb::type::kVarchar) {
+                if (str_pos >= 0) {
+                    return false;
+                }
+                str_pos = i;
+            }
+        }
+        if (str_pos < 0) {
+            return false;
+        }
+        size_t merge_cnt = parts.size() - types_.size() + 1;
+        for (size_t i = 1; i < merge_cnt; i++) {
+            parts[str_pos].append("|").append(parts[str_pos + i]);
+        }
+        parts.erase(parts.begin() + str_pos + 1, parts.begin() + str_pos + merge_cnt);
+    }
+    return Encode(parts, key);
+}
+
+bool RangeKeyCodec::IsSupportedType(::openmldb::type::DataType type) {
+    switch (type) {
+        case ::openmldb::type::kSmallInt:
+        case ::openmldb::type::kInt:
+        case ::openmldb::type::kBigInt:
+        case ::openmldb::type::kTimestamp:
+        case ::openmldb::type::kFloat:
+        case ::openmldb::type::kDouble:
+        case ::openmldb::type::kString:
+        case ::openmldb::type::kVarchar:
+            return true;
+        default:
+            return false;
+    }
+}
+
+int RangeKeyCodec::PackRow(const RowView& decoder, const int8_t* row, uint32_t idx,
+                           ::openmldb::type::DataType type, std::string* key) {
+    int ret = 0;
+    if (type == ::openmldb::type::kString || type == ::openmldb::type::kVarchar) {
+        char* ch = nullptr;
+        uint32_t length = 0;
+        ret = decoder.GetValue(row, idx, &ch, &length);
+        if (ret != 0) {
+            return ret;
+        }
+        key->push_back(KEY_NOT_NULL_FLAG);
+        size_t k_size = key->size();
+        key->resize(k_size + GetDstStrSize(length));
+        void* to = &(*key)[k_size];
+        return PackString(ch, length, &to) == 0 ? 0 : -1;
+    }
+    if (!IsSupportedType(type)) {
+        return -1;
+    }
+    // large enough for all the fixed width types
+    int64_t value = 0;
+    ret = decoder.GetValue(row, idx, type, &value);
+    if (ret != 0) {
+        return ret;
+    }
+    key->push_back(KEY_NOT_NULL_FLAG);
+    return PackValue(&value, type, key) ? 0 : -1;
+}
+
+bool RangeKeyCodec::PackBound(const std::string& value, ::openmldb::type::DataType type, bool is_lower,
+                              bool* inclusive, std::string* key) {
+    if (!IsSupportedType(type)) {
+        return false;
+    }
+    if (type != ::openmldb::type::kFloat && type != ::openmldb::type::kDouble) {
+        return IndexKeyEncoder::PackColumn(value, type, key);
+    }
+    char* end = nullptr;
+    errno = 0;
+    double d = strtod(value.c_str(), &end);
+    if (value.empty() || errno != 0 || *end != '\0' || std::isnan(d)) {
+        return false;
+    }
+    key->push_back(KEY_NOT_NULL_FLAG);
+    if (type == ::openmldb::type::kDouble) {
+        return PackValue(&d, type, key);
+    }
+    float f = static_cast<float>(d);
+    if (static_cast<double>(f) != d) {
+        if (is_lower && static_cast<double>(f) > d) {
+            f = std::nextafter(f, -std::numeric_limits<float>::infinity());
+        } else if (!is_lower && static_cast<double>(f) < d) {
+            f = std::nextafter(f, std::numeric_limits<float>::infinity());
+        }
+        *inclusive = true;
+    }
+    return PackValue(&f, type, key);
+}
+
+}  // namespace codec
+}  // namespace openmldb
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "proto/type.pb.h"
+
+namespace openmldb {
+namespace codec {
+
+static constexpr char KEY_NULL_FLAG = 0x00;
+static constexpr char KEY_NOT_NULL_FLAG = 0x01;
+
+// Builds the keys of kMemcomparableKey indexes. Every column starts with a null flag byte, integers, dates and
+// timestamps are packed big endian in their fixed width with the sign bit flipped and strings are escaped in
+// groups of 8 bytes, so that memcmp orders the keys by the typed column values.
+// The input values are in the form of the delimited keys, null as NONETOKEN, empty string as EMPTY_STRING
+// and date either as the packed integer or yyyy-mm-dd
+class IndexKeyEncoder {
+ public:
+    IndexKeyEncoder() : encoding_(::openmldb::type::kDelimitedKey), types_() {}
+    IndexKeyEncoder(::openmldb::type::KeyEncoding encoding, const std::vector<::openmldb::type::DataType>& types)
+        : encoding_(encoding), types_(types) {}
+
+    // resolve the column types of `column_key` from `columns`, returns false if a column does not exist
+    bool Init(const ::openmldb::common::ColumnKey& column_key,
+              const google::protobuf::RepeatedPtrField<::openmldb::common::ColumnDesc>& columns);
+
+    inline bool IsMemcomparable() const { return encoding_ == ::openmldb::type::kMemcomparableKey; }
+
+    // encode the column values of an index. The values are joined with "|" for kDelimitedKey
+    bool Encode(const std::vector<std::string>& values, std::string* key) const;
+
+    // encode a key which has been joined with "|", like the keys generated by the sql engine.
+    // A string column may contain the delimiter only if it is the single string column of the index
+    bool EncodeDelimited(const std::string& delimited_key, std::string* key) const;
+
+    static bool PackColumn(const std::string& value, ::openmldb::type::DataType type, std::string* key);
+
+ private:
+    ::openmldb::type::KeyEncoding encoding_;
+    std::vector<::openmldb::type::DataType> types_;
+};
+
+class RowView;
+
+// Builds the keys of range indexes. A value is packed as a column of kMemcomparableKey indexes, and float
+// and double are packed in the same order as well. Null values are not indexed
+class RangeKeyCodec {
+ public:
+    static bool IsSupportedType(::openmldb::type::DataType type);
+
+    // pack the value of column `idx` in `row`, returns 1 if the value is null, -1 if it fails
+    static int PackRow(const RowView& decoder, const int8_t* row, uint32_t idx, ::openmldb::type::DataType type,
+                       std::string* key);
+
+    // pack a bound of the range in text form. The float bound is moved outwards to the nearest float and
+    // becomes inclusive if the value is not a float, so that no row in the range is missed
+    static bool PackBound(const std::string& value, ::openmldb::type::DataType type, bool is_lower,
+                          bool* inclusive, std::string* key);
+};
+
+}  // namespace codec
+}  // namespace openmldb
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codec/index_key_codec.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "codec/codec.h"
+#include "codec/field_codec.h"
+#include "codec/memcomparable_format.h"
+#include "codec/row_codec.h"
+#include "codec/schema_codec.h"
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace codec {
+
+class IndexKeyCodecTest : public ::testing::Test {
+ public:
+    IndexKeyCodecTest() {}
+    ~IndexKeyCodecTest() {}
+};
+
+static std::string EncodeKey(const IndexKeyEncoder& encoder, const std::vector<std::string>& values) {
+    std::string key;
+    EXPECT_TRUE(encoder.Encode(values, &key));
+    return key;
+}
+
+TEST_F(IndexKeyCodecTest, Delimited) {
+    ::openmldb::common::ColumnKey column_key;
+    column_key.add_col_name("card");
+    column_key.add_col_name("mcc");
+    google::protobuf::RepeatedPtrField<::openmldb::common::ColumnDesc> columns;
+    SchemaCodec::SetColumnDesc(columns.Add(), "card", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(columns.Add(), "mcc", ::openmldb::type::kInt);
+    IndexKeyEncoder encoder;
+    ASSERT_TRUE(encoder.Init(column_key, columns));
+    ASSERT_FALSE(encoder.IsMemcomparable());
+    ASSERT_EQ("card0|10", EncodeKey(encoder, {"card0", "10"}));
+    std::string key;
+    ASSERT_TRUE(encoder.EncodeDelimited("card0|10", &key));
+    ASSERT_EQ("card0|10", key);
+}
+
+TEST_F(IndexKeyCodecTest, Order) {
+    IndexKeyEncoder encoder(::openmldb::type::kMemcomparableKey,
+                            {::openmldb::type::kBigInt, ::openmldb::type::kString});
+    std::vector<std::vector<std::string>> values = {
+        {NONETOKEN, "a"}, {"-100", "b"}, {"-2", EMPTY_STRING}, {"-2", "a"}, {"-2", "a\x01"},
+        {"-2", "aaaaaaaab"}, {"9", "a"}, {"10", "a"}, {"100", NONETOKEN}, {"100", "a"}};
+    std::vector<std::string> keys;
+    for (const auto& value : values) {
+        keys.push_back(EncodeKey(encoder, value));
+    }
+    // the keys are already in the order of the typed values
+    std::vector<std::string> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    ASSERT_EQ(keys, sorted);
+    // fixed width for the integer column
+    ASSERT_EQ(1u + sizeof(int64_t) + 1u + RDB_ESCAPE_LENGTH, keys[1].size());
+    ASSERT_EQ(1u + 1u + RDB_ESCAPE_LENGTH, keys[0].size());
+}
+
+TEST_F(IndexKeyCodecTest, Types) {
+    IndexKeyEncoder encoder(::openmldb::type::kMemcomparableKey,
+                            {::openmldb::type::kBool, ::openmldb::type::kSmallInt, ::openmldb::type::kInt,
+                             ::openmldb::type::kDate, ::openmldb::type::kTimestamp});
+    std::string key;
+    ASSERT_TRUE(encoder.Encode({"true", "-1", "1", "2022-1-5", "1650000000000"}, &key));
+    ASSERT_EQ(5u + sizeof(int8_t) + sizeof(int16_t) + sizeof(int32_t) * 2 + sizeof(int64_t), key.size());
+    // the date can be the packed integer as well
+    int32_t date = ((2022 - 1900) << 16) | (0 << 8) | 5;
+    std::string other;
+    ASSERT_TRUE(encoder.Encode({"true", "-1", "1", std::to_string(date), "1650000000000"}, &other));
+    ASSERT_EQ(key, other);
+    ASSERT_LT(EncodeKey(encoder, {"false", "1", "1", "2022-1-5", "1"}), key);
+    ASSERT_LT(key, EncodeKey(encoder, {"true", "-1", "1", "2022-1-6", "0"}));
+    // invalid values
+    ASSERT_FALSE(encoder.Encode({"yes", "-1", "1", "2022-1-5", "1"}, &key));
+    ASSERT_FALSE(encoder.Encode({"true", "40000", "1", "2022-1-5", "1"}, &key));
+    ASSERT_FALSE(encoder.Encode({"true", "-1", "1a", "2022-1-5", "1"}, &key));
+    ASSERT_FALSE(encoder.Encode({"true", "-1", "1", "2022-13-5", "1"}, &key));
+    ASSERT_FALSE(encoder.Encode({"true", "-1", "1", "2022-1-5"}, &key));
+    IndexKeyEncoder float_encoder(::openmldb::type::kMemcomparableKey, {::openmldb::type::kFloat});
+    ASSERT_FALSE(float_encoder.Encode({"1.0"}, &key));
+}
+
+TEST_F(IndexKeyCodecTest, EncodeDelimited) {
+    IndexKeyEncoder encoder(::openmldb::type::kMemcomparableKey,
+                            {::openmldb::type::kInt, ::openmldb::type::kString, ::openmldb::type::kBigInt});
+    std::string key;
+    ASSERT_TRUE(encoder.EncodeDelimited("1|abc|2", &key));
+    ASSERT_EQ(EncodeKey(encoder, {"1", "abc", "2"}), key);
+    // the delimiter in the single string column
+    ASSERT_TRUE(encoder.EncodeDelimited("1|a|b||c|2", &key));
+    ASSERT_EQ(EncodeKey(encoder, {"1", "a|b||c", "2"}), key);
+    ASSERT_FALSE(encoder.EncodeDelimited("1|2", &key));
+
+    IndexKeyEncoder str_encoder(::openmldb::type::kMemcomparableKey,
+                                {::openmldb::type::kString, ::openmldb::type::kString});
+    ASSERT_TRUE(str_encoder.EncodeDelimited("a|b", &key));
+    ASSERT_EQ(EncodeKey(str_encoder, {"a", "b"}), key);
+    // ambiguous
+    ASSERT_FALSE(str_encoder.EncodeDelimited("a|b|c", &key));
+}
+
+TEST_F(IndexKeyCodecTest, RangeKey) {
+    Schema schema;
+    SchemaCodec::SetColumnDesc(schema.Add(), "amount", ::openmldb::type::kDouble);
+    SchemaCodec::SetColumnDesc(schema.Add(), "price", ::openmldb::type::kFloat);
+    SchemaCodec::SetColumnDesc(schema.Add(), "cnt", ::openmldb::type::kSmallInt);
+    SchemaCodec::SetColumnDesc(schema.Add(), "name", ::openmldb::type::kString);
+    RowView decoder(schema);
+    std::vector<std::vector<std::string>> rows = {{"-10.5", "-1", "-3", "a"},
+                                                  {"0", "0.25", "0", "ab"},
+                                                  {"0.1", "0.5", "2", "b"},
+                                                  {"100", "1e10", "300", "bb"}};
+    for (uint32_t idx = 0; idx < 4; idx++) {
+        auto type = schema.Get(idx).data_type();
+        ASSERT_TRUE(RangeKeyCodec::IsSupportedType(type));
+        std::vector<std::string> keys;
+        for (const auto& row : rows) {
+            std::string value;
+            ASSERT_TRUE(RowCodec::EncodeRow(row, schema, 1, value).OK());
+            std::string key;
+            ASSERT_EQ(0, RangeKeyCodec::PackRow(decoder, reinterpret_cast<const int8_t*>(value.data()), idx, type,
+                                                &key));
+            // the bound of the same value is packed the same
+            std::string bound;
+            bool inclusive = false;
+            ASSERT_TRUE(RangeKeyCodec::PackBound(row[idx], type, true, &inclusive, &bound));
+            ASSERT_EQ(key, bound);
+            keys.push_back(key);
+        }
+        std::vector<std::string> sorted = keys;
+        std::sort(sorted.begin(), sorted.end());
+        ASSERT_EQ(keys, sorted);
+    }
+    std::string value;
+    ASSERT_TRUE(RowCodec::EncodeRow({"null", "null", "null", "null"}, schema, 1, value).OK());
+    std::string key;
+    ASSERT_EQ(1, RangeKeyCodec::PackRow(decoder, reinterpret_cast<const int8_t*>(value.data()), 3,
+                                        ::openmldb::type::kString, &key));
+    ASSERT_TRUE(key.empty());
+    ASSERT_FALSE(RangeKeyCodec::IsSupportedType(::openmldb::type::kBool));
+    ASSERT_FALSE(RangeKeyCodec::IsSupportedType(::openmldb::type::kDate));
+}
+
+TEST_F(IndexKeyCodecTest, RangeFloatBound) {
+    auto float_key = [](float f) {
+        std::string key(1, KEY_NOT_NULL_FLAG);
+        PackValue(&f, ::openmldb::type::kFloat, &key);
+        return key;
+    };
+    std::string key;
+    bool inclusive = false;
+    // 0.1 is between two floats, the lower bound is moved down and the upper bound up
+    ASSERT_TRUE(RangeKeyCodec::PackBound("0.1", ::openmldb::type::kFloat, true, &inclusive, &key));
+    ASSERT_TRUE(inclusive);
+    ASSERT_LE(key, float_key(0.1f));
+    key.clear();
+    inclusive = false;
+    ASSERT_TRUE(RangeKeyCodec::PackBound("0.1", ::openmldb::type::kFloat, false, &inclusive, &key));
+    ASSERT_TRUE(inclusive);
+    ASSERT_GE(key, float_key(0.1f));
+    // exact values are kept
+    key.clear();
+    inclusive = false;
+    ASSERT_TRUE(RangeKeyCodec::PackBound("0.5", ::openmldb::type::kFloat, true, &inclusive, &key));
+    ASSERT_FALSE(inclusive);
+    ASSERT_EQ(float_key(0.5f), key);
+    key.clear();
+    ASSERT_FALSE(RangeKeyCodec::PackBound("abc", ::openmldb::type::kDouble, true, &inclusive, &key));
+    key.clear();
+    ASSERT_FALSE(RangeKeyCodec::PackBound("1.5", ::openmldb::type::kInt, true, &inclusive, &key));
+}
+
+}  // namespace codec
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    return RUN_ALL_TESTS();
+}
@@ -19,8 +19,9 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
-#include "base/hash.h"
+#include "base/partition_router.h"
 #include "codec/row_codec.h"
 
 namespace openmldb {
@@ -31,7 +32,8 @@ SDKCodec::SDKCodec(const ::openmldb::nameserver::TableInfo& table_info)
       base_schema_size_(0),
       modify_times_(0),
       version_schema_(),
-      last_ver_(1) {
+      last_ver_(1),
+      partition_split_(table_info.partition_split()) {
     if (table_info.column_desc_size() > 0) {
         ParseColumnDesc(table_info.column_desc());
     }
@@ -43,6 +45,7 @@ SDKCodec::SDKCodec(const ::openmldb::nameserver::TableInfo& table_info)
     ParseSchemaVer(table_info.schema_versions(), add_schema);
     ParseAddedColumnDesc(add_schema);
     ParseTsCol();
+    ParseKeyEncoder();
     for (const auto& name : table_info.partition_key()) {
         auto iter = schema_idx_map_.find(name);
         if (iter != schema_idx_map_.end()) {
@@ -64,6 +67,7 @@ SDKCodec::SDKCodec(const ::openmldb::api::TableMeta& table_info)
     ParseSchemaVer(table_info.schema_versions(), add_schema);
     ParseAddedColumnDesc(table_info.added_column_desc());
     ParseTsCol();
+    ParseKeyEncoder();
 }
 
 void SDKCodec::ParseColumnDesc(const Schema& column_desc) {
@@ -92,6 +96,17 @@ void SDKCodec::ParseTsCol() {
     }
 }
 
+void SDKCodec::ParseKeyEncoder() {
+    key_encoders_.clear();
+    for (const auto& index : index_) {
+        IndexKeyEncoder encoder;
+        if (!encoder.Init(index, schema_)) {
+            encoder = IndexKeyEncoder();
+        }
+        key_encoders_.push_back(std::move(encoder));
+    }
+}
+
 void SDKCodec::ParseAddedColumnDesc(const Schema& column_desc) {
     if (format_version_ == 1) {
         uint32_t idx = schema_.size();
@@ -137,16 +152,17 @@ int SDKCodec::EncodeDimension(const std::map<std::string, std::string>& raw_data
             dimension_idx++;
             continue;
         }
-        std::string key;
+        std::vector<std::string> values;
         for (const auto& name : column_key.col_name()) {
             auto pos = raw_data.find(name);
             if (pos == raw_data.end()) {
                 return -1;
             }
-            if (!key.empty()) {
-                key += "|";
-            }
-            key += pos->second;
+            values.push_back(pos->second);
+        }
+        std::string key;
+        if (!key_encoders_[dimension_idx].Encode(values, &key)) {
+            return -1;
         }
         if (key.empty()) {
             const std::string& index_name = column_key.index_name();
@@ -156,10 +172,7 @@ int SDKCodec::EncodeDimension(const std::map<std::string, std::string>& raw_data
             }
             key = pos->second;
         }
-        uint32_t pid = 0;
-        if (pid_num > 0) {
-            pid = (uint32_t)(::openmldb::base::hash64(key) % pid_num);
-        }
+        uint32_t pid = ::openmldb::base::GetPartitionId(key, pid_num, partition_split_);
         auto pair = dimensions->emplace(pid, Dimension());
         pair.first->second.emplace_back(std::move(key), dimension_idx);
         dimension_idx++;
@@ -175,16 +188,17 @@ int SDKCodec::EncodeDimension(const std::vector<std::string>& raw_data, uint32_t
             dimension_idx++;
             continue;
         }
-        std::string key;
+        std::vector<std::string> values;
         for (const auto& name : column_key.col_name()) {
             auto iter = schema_idx_map_.find(name);
             if (iter == schema_idx_map_.end() || iter->second >= raw_data.size()) {
                 return -1;
             }
-            if (!key.empty()) {
-                key += "|";
-            }
-            key += raw_data[iter->second];
+            values.push_back(raw_data[iter->second]);
+        }
+        std::string key;
+        if (!key_encoders_[dimension_idx].Encode(values, &key)) {
+            return -1;
         }
         if (key.empty()) {
             const std::string& name = column_key.index_name();
@@ -194,10 +208,7 @@ int SDKCodec::EncodeDimension(const std::vector<std::string>& raw_data, uint32_t
             }
             key = raw_data[iter->second];
         }
-        uint32_t pid = 0;
-        if (pid_num > 0) {
-            pid = (uint32_t)(::openmldb::base::hash64(key) % pid_num);
-        }
+        uint32_t pid = ::openmldb::base::GetPartitionId(key, pid_num, partition_split_);
         auto pair = dimensions->emplace(pid, Dimension());
         pair.first->second.emplace_back(std::move(key), dimension_idx);
         dimension_idx++;
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "codec/index_key_codec.h"
 #include "codec/schema_codec.h"
 #include "proto/common.pb.h"
 #include "proto/tablet.pb.h"
@@ -63,6 +64,7 @@ class SDKCodec {
     void ParseAddedColumnDesc(const Schema& column_desc);
     void ParseSchemaVer(const VerSchema& ver_schema, const Schema& add_schema);
     void ParseTsCol();
+    void ParseKeyEncoder();
 
  private:
     Schema schema_;
@@ -70,11 +72,14 @@ class SDKCodec {
     std::map<std::string, uint32_t> schema_idx_map_;
     std::vector<uint32_t> ts_idx_;
     std::vector<uint32_t> partition_col_idx_;
+    // the key encoders in the order of index_
+    std::vector<IndexKeyEncoder> key_encoders_;
     uint32_t format_version_;
     uint32_t base_schema_size_;
     int modify_times_;
     std::map<int32_t, std::shared_ptr<Schema>> version_schema_;
     int32_t last_ver_;
+    ::google::protobuf::RepeatedPtrField<::openmldb::common::PartitionSplit> partition_split_;
 };
 
 }  // namespace codec
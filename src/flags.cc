@@ -39,6 +39,11 @@ DEFINE_uint32(name_server_task_max_concurrency, 8, "config the max concurrency o
 DEFINE_int32(name_server_task_wait_time, 1000, "config the time of task wait");
 DEFINE_uint32(name_server_op_execute_timeout, 2 * 60 * 60 * 1000, "config the timeout of nameserver op");
 DEFINE_bool(auto_failover, false, "enable or disable auto failover");
+DEFINE_bool(enable_partition_rebalance, false, "enable or disable the load aware partition rebalance of nameserver");
+DEFINE_uint32(partition_rebalance_interval, 5 * 60 * 1000, "config the interval of partition rebalance in ms");
+DEFINE_double(partition_rebalance_max_skew, 0.2,
+              "rebalance when the memory or qps of a tablet exceeds the average by more than this ratio");
+DEFINE_uint32(partition_rebalance_max_moves, 2, "config the max count of partition moves in one rebalance round");
 DEFINE_bool(enable_timeseries_table, true, "enable or disable timeseries table");
 DEFINE_int32(max_op_num, 10000, "config the max op num");
 DEFINE_uint32(partition_num, 8, "config the default partition_num");
@@ -57,6 +62,11 @@ DEFINE_bool(use_name, false, "enable or disable use server name");
 DEFINE_string(data_dir, "./data", "the path of data dir");
 DEFINE_bool(enable_distsql, false, "enable or disable distribute sql");
 DEFINE_bool(enable_localtablet, true, "enable or disable local tablet opt when distribute sql circumstance");
+DEFINE_uint32(sub_query_hedge_delay, 0,
+              "config the delay in ms before a slow batch request sub query is duplicated to a follower, "
+              "0 means disable it");
+DEFINE_uint32(sub_query_hedge_max_staleness, 1000,
+              "config the max lag in ms of the follower which serves a hedged batch request sub query");
 DEFINE_string(mini_window_size, "1d", "the default mini window size in pre-aggr table");
 
 // scan configuration
@@ -64,6 +74,23 @@ DEFINE_uint32(scan_max_bytes_size, 2 * 1024 * 1024, "config the max size of scan
 DEFINE_uint32(scan_reserve_size, 1024, "config the size of vec reserve");
 DEFINE_uint32(preview_limit_max_num, 1000, "config the max num of preview limit");
 DEFINE_uint32(preview_default_limit, 100, "config the default limit of preview");
+DEFINE_uint32(query_cursor_max_cnt, 64, "config the max num of opened batch query cursors in tablet");
+DEFINE_uint32(query_cursor_timeout_ms, 60000, "config the idle time before a batch query cursor is released");
+DEFINE_uint32(max_concurrent_query, 0,
+              "config the max num of queries running at the same time in tablet, 0 means no limit");
+DEFINE_uint64(max_inflight_request_bytes, 0,
+              "config the max total bytes of the put and query requests being served in tablet, 0 means no limit");
+DEFINE_uint64(memory_high_water_mark_mb, 0,
+              "config the memory used in MB above which tablet rejects the puts and queries, 0 means no limit");
+DEFINE_uint32(memory_check_interval, 1000, "config the interval in ms of refreshing the memory used of tablet");
+DEFINE_uint32(batch_query_thread_num, 0,
+              "config the num of threads running the batch queries apart from the brpc workers in tablet, "
+              "0 means running them in the brpc workers");
+DEFINE_uint32(low_priority_run_quantum_us, 1000,
+              "config the min time in us the batch queries and gc run between two yields to the online requests");
+DEFINE_uint32(low_priority_max_yield_us, 0,
+              "config the max time in us the batch queries and gc pause at a time while online requests are "
+              "running, 0 disables it");
 // binlog configuration
 DEFINE_int32(binlog_single_file_max_size, 1024 * 4, "the max size of single binlog file");
 DEFINE_int32(binlog_sync_batch_size, 32, "the batch size of sync binlog");
@@ -75,7 +102,17 @@ DEFINE_int32(binlog_sync_to_disk_interval, 20000, "config the interval of sync b
 DEFINE_int32(binlog_delete_interval, 60000, "config the interval of delete binlog");
 DEFINE_int32(binlog_match_logoffset_interval, 1000, "config the interval of match log offset ");
 DEFINE_int32(binlog_name_length, 8, "binlog name length");
+DEFINE_int32(binlog_heartbeat_interval, 1000,
+             "config the interval in ms of telling an idle follower the leader offset. 0 disables it");
 DEFINE_uint32(check_binlog_sync_progress_delta, 100000, "config the delta of check binlog sync progress");
+DEFINE_uint32(split_table_catch_up_round, 100,
+              "config the max rounds of reading binlog to catch up the writes when splitting a partition");
+DEFINE_uint32(split_table_clean_delay, 60000,
+              "config the delay in ms to remove the moved keys from a split partition after the routing switches");
+DEFINE_uint32(hot_key_sample_interval, 0,
+              "config the interval of sampling the key of request mode queries, one in every n queries. 0 disables it");
+DEFINE_double(hot_key_min_ratio, 0.05, "config the min ratio of the sampled queries for a key to be reported as hot");
+DEFINE_uint32(hot_key_decay_interval, 60000, "config the interval in ms of halving the hot key counts");
 DEFINE_uint32(go_back_max_try_cnt, 10, "config max try time of go back");
 
 DEFINE_uint32(put_slow_log_threshold, 50000, "config the threshold of put slow log");
@@ -94,6 +131,7 @@ DEFINE_int32(request_timeout_ms, 20000, "request timeout");
 DEFINE_int32(request_sleep_time, 1000, "the sleep time when request error");
 
 DEFINE_uint32(max_traverse_cnt, 50000, "max traverse iter loop cnt");
+DEFINE_uint32(planner_stats_sample_key_cnt, 1024, "the max number of keys sampled for index statistics of sql planner");
 DEFINE_string(ssd_root_path, "", "the root ssd path of db");
 DEFINE_string(hdd_root_path, "", "the root hdd path of db");
 
@@ -104,6 +142,8 @@ DEFINE_int32(retry_send_file_wait_time_ms, 3000, "conf the wait time when retry
 DEFINE_int32(stream_close_wait_time_ms, 1000, "the wait time before close stream");
 DEFINE_uint32(stream_block_size, 1 * 1204 * 1024, "config the write/read block size in streaming");
 DEFINE_int32(stream_bandwidth_limit, 10 * 1204 * 1024, "the limit bandwidth. Byte/Second");
+DEFINE_uint32(stream_max_inflight_blocks, 8, "the max number of blocks in flight when sending a file");
+DEFINE_uint32(send_file_concurrency, 2, "the number of files sent in parallel");
 
 // if set 23, the task will execute 23:00 every day
 DEFINE_int32(make_snapshot_time, 23, "config the time to make snapshot");
@@ -115,8 +155,15 @@ DEFINE_uint32(make_snapshot_offline_interval, 60 * 60 * 24,
               "makesnapshot from ns. unit is second");
 DEFINE_string(snapshot_compression, "off", "Type of snapshot compression, can be off, snappy, zlib");
 DEFINE_int32(snapshot_pool_size, 1, "the size of tablet thread pool for making snapshot");
+DEFINE_int32(zstd_compress_level, 3, "the compression level of the tables with zstd compress type");
+DEFINE_uint32(zstd_dict_sample_cnt, 10000,
+              "config the record count of a zstd compressed table partition to train the dictionary from");
+DEFINE_uint32(zstd_dict_size, 64 * 1024, "config the max size of the zstd dictionary, unit is byte");
 
 DEFINE_uint32(load_index_max_wait_time, 120 * 60 * 1000, "config the max wait time of load index");
+DEFINE_uint32(add_index_backfill_thread_num, 4,
+              "config the number of threads to build a new index from the rows in memory, "
+              "0 means loading the rows from the snapshot and binlog");
 
 DEFINE_string(recycle_bin_root_path, "/tmp/recycle", "specify the root path of recycle bin");
 DEFINE_bool(recycle_bin_enabled, true, "enable the recycle bin storage");
@@ -130,6 +177,7 @@ DEFINE_uint32(latest_default_skiplist_height, 1, "the default height of skiplist
 DEFINE_uint32(absolute_default_skiplist_height, 4, "the default height of skiplist for absolute table");
 DEFINE_bool(enable_show_tp, false, "enable show tp");
 DEFINE_uint32(max_col_display_length, 256, "config the max length of column display");
+DEFINE_uint64(bulk_load_rpc_size_limit, 32 * 1024 * 1024, "the max size of a bulk load request of load data");
 
 // rocksdb
 DEFINE_bool(disable_wal, true, "If true, do not write WAL for write.");
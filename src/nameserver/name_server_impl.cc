@@ -33,6 +33,7 @@
 #include <utility>
 
 #include "base/glog_wapper.h"
+#include "base/partition_router.h"
 #include "base/proto_util.h"
 #include "base/status.h"
 #include "base/strings.h"
@@ -69,8 +70,13 @@ DECLARE_bool(use_name);
 DECLARE_bool(enable_distsql);
 DECLARE_bool(enable_timeseries_table);
 DECLARE_uint32(sync_deploy_stats_timeout);
+DECLARE_bool(enable_partition_rebalance);
+DECLARE_uint32(partition_rebalance_interval);
+DECLARE_double(partition_rebalance_max_skew);
+DECLARE_uint32(partition_rebalance_max_moves);
 
 using ::openmldb::api::OPType::kAddIndexOP;
+using ::openmldb::api::OPType::kSplitPartitionOP;
 using ::openmldb::base::ReturnCode;
 
 namespace openmldb {
@@ -926,6 +932,12 @@ bool NameServerImpl::RecoverOPTask() {
                     continue;
                 }
                 break;
+            case ::openmldb::api::OPType::kSplitPartitionOP:
+                if (CreateSplitPartitionOPTask(op_data) < 0) {
+                    PDLOG(WARNING, "recover op[%s] failed. op_id[%lu]", op_type_str.c_str(), op_id);
+                    continue;
+                }
+                break;
             default:
                 PDLOG(WARNING, "unsupport recover op[%s]! op_id[%lu]", op_type_str.c_str(), op_id);
                 continue;
@@ -1443,6 +1455,8 @@ bool NameServerImpl::Init(const std::string& zk_cluster, const std::string& zk_p
                                 boost::bind(&NameServerImpl::SchedMakeSnapshot, this));
     task_thread_pool_.DelayTask(FLAGS_sync_deploy_stats_timeout,
                                 boost::bind(&NameServerImpl::ScheduleSyncDeployStats, this));
+    task_thread_pool_.DelayTask(FLAGS_partition_rebalance_interval,
+                                boost::bind(&NameServerImpl::SchedPartitionRebalance, this));
     return true;
 }
 
@@ -1910,6 +1924,10 @@ void NameServerImpl::DeleteTask(const std::vector<uint64_t>& done_task_vec) {
             done_op_list_.push_back(op_data);
             task_vec_[index].pop_front();
             PDLOG(INFO, "delete op[%lu] in running op", op_id);
+            if (op_data->op_info_.op_type() == kSplitPartitionOP) {
+                task_thread_pool_.AddTask(
+                    boost::bind(&NameServerImpl::RollbackSplitPartition, this, op_data->op_info_));
+            }
         } else {
             if (zk_client_->DeleteNode(node)) {
                 PDLOG(INFO, "delete zk op node[%s] success.", node.c_str());
@@ -2263,6 +2281,8 @@ int NameServerImpl::CreateTableOnTablet(const std::shared_ptr<::openmldb::namese
     ::openmldb::type::CompressType compress_type = ::openmldb::type::CompressType::kNoCompress;
     if (table_info->compress_type() == ::openmldb::type::kSnappy) {
         compress_type = ::openmldb::type::CompressType::kSnappy;
+    } else if (table_info->compress_type() == ::openmldb::type::kZstd) {
+        compress_type = ::openmldb::type::CompressType::kZstd;
     }
     ::openmldb::api::TableMeta table_meta;
     table_meta.set_db(table_info->db());
@@ -2282,6 +2302,7 @@ int NameServerImpl::CreateTableOnTablet(const std::shared_ptr<::openmldb::namese
         ::openmldb::common::ColumnKey* column_key = table_meta.add_column_key();
         column_key->CopyFrom(table_info->column_key(idx));
     }
+    table_meta.mutable_range_index()->CopyFrom(table_info->range_index());
     for (const auto& table_partition : table_info->table_partition()) {
         ::openmldb::common::TablePartition* partition = table_meta.add_table_partition();
         partition->set_pid(table_partition.pid());
@@ -2742,6 +2763,7 @@ void NameServerImpl::CancelOP(RpcController* controller, const CancelOPRequest*
         return;
     }
     bool find_op = false;
+    std::shared_ptr<::openmldb::api::OPInfo> split_op_info;
     std::vector<std::shared_ptr<TabletClient>> client_vec;
     {
         std::lock_guard<std::mutex> lock(mu_);
@@ -2755,6 +2777,9 @@ void NameServerImpl::CancelOP(RpcController* controller, const CancelOPRequest*
                     for (auto& task : (*iter)->task_list_) {
                         task->task_info_->set_status(::openmldb::api::kCanceled);
                     }
+                    if ((*iter)->op_info_.op_type() == kSplitPartitionOP) {
+                        split_op_info = std::make_shared<::openmldb::api::OPInfo>((*iter)->op_info_);
+                    }
                     find_op = true;
                     break;
                 }
@@ -2776,6 +2801,9 @@ void NameServerImpl::CancelOP(RpcController* controller, const CancelOPRequest*
             }
             DEBUGLOG("tablet[%s] cancel op success", client->GetEndpoint().c_str());
         }
+        if (split_op_info) {
+            task_thread_pool_.AddTask(boost::bind(&NameServerImpl::RollbackSplitPartition, this, *split_op_info));
+        }
         response->set_code(::openmldb::base::ReturnCode::kOk);
         response->set_msg("ok");
         PDLOG(INFO, "op[%lu] is canceled!", request->op_id());
@@ -5187,6 +5215,117 @@ void NameServerImpl::UpdateTableStatusFun(
     }
 }
 
+void NameServerImpl::SchedPartitionRebalance() {
+    if (running_.load(std::memory_order_acquire) && FLAGS_enable_partition_rebalance) {
+        RebalancePartition();
+    }
+    task_thread_pool_.DelayTask(FLAGS_partition_rebalance_interval,
+                                boost::bind(&NameServerImpl::SchedPartitionRebalance, this));
+}
+
+void NameServerImpl::RebalancePartition() {
+    std::map<std::string, std::shared_ptr<TabletInfo>> tablet_ptr_map;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        for (const auto& kv : tablets_) {
+            if (kv.second->state_ != ::openmldb::type::EndpointState::kHealthy) {
+                PDLOG(INFO, "tablet[%s] is not healthy, skip partition rebalance", kv.first.c_str());
+                return;
+            }
+            tablet_ptr_map.insert(std::make_pair(kv.first, kv.second));
+        }
+    }
+    std::unordered_map<std::string, ::openmldb::api::TableStatus> pos_response;
+    for (const auto& kv : tablet_ptr_map) {
+        ::openmldb::api::GetTableStatusResponse tablet_status_response;
+        if (!kv.second->client_->GetTableStatus(tablet_status_response)) {
+            PDLOG(WARNING, "get table status failed, skip partition rebalance. endpoint[%s]", kv.first.c_str());
+            return;
+        }
+        for (const auto& table_status : tablet_status_response.all_table_status()) {
+            std::string key = std::to_string(table_status.tid()) + "_" + std::to_string(table_status.pid()) + "_" +
+                              kv.first;
+            pos_response.emplace(key, table_status);
+        }
+    }
+    uint64_t cur_time = ::baidu::common::timer::get_micros() / 1000;
+    std::vector<ReplicaLoad> replicas;
+    auto collect = [&](const std::map<std::string, std::shared_ptr<TableInfo>>& table_info_map) {
+        for (const auto& kv : table_info_map) {
+            const auto& table_info = kv.second;
+            if (IsHiddenDb(table_info->db()) || table_info->table_partition_size() == 0) {
+                continue;
+            }
+            for (const auto& table_partition : table_info->table_partition()) {
+                for (const auto& partition_meta : table_partition.partition_meta()) {
+                    if (!partition_meta.is_alive()) {
+                        continue;
+                    }
+                    std::string key = std::to_string(table_info->tid()) + "_" +
+                                      std::to_string(table_partition.pid()) + "_" + partition_meta.endpoint();
+                    auto iter = pos_response.find(key);
+                    if (iter == pos_response.end()) {
+                        continue;
+                    }
+                    ReplicaLoad replica;
+                    replica.db = table_info->db();
+                    replica.name = table_info->name();
+                    replica.tid = table_info->tid();
+                    replica.pid = table_partition.pid();
+                    replica.endpoint = partition_meta.endpoint();
+                    replica.is_leader = partition_meta.is_leader();
+                    replica.mem_bytes = iter->second.record_byte_size() + iter->second.record_idx_byte_size();
+                    replica.read_cnt = iter->second.read_cnt();
+                    replica.offset = iter->second.offset();
+                    replicas.push_back(replica);
+                }
+            }
+        }
+    };
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        collect(table_info_);
+        for (const auto& kv : db_table_info_) {
+            collect(kv.second);
+        }
+    }
+    // the rates are averaged over the whole rebalance interval, so the first round only records the counters
+    rebalancer_.UpdateRates(cur_time, &replicas);
+    std::vector<std::string> endpoints;
+    for (const auto& kv : tablet_ptr_map) {
+        endpoints.push_back(kv.first);
+    }
+    auto moves = PartitionRebalancer::Plan(replicas, endpoints, FLAGS_partition_rebalance_max_skew,
+                                           FLAGS_partition_rebalance_max_moves);
+    if (moves.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    // throttle the moves by leaving the op queues to failover and the ops of the last round
+    for (const auto& op_list : task_vec_) {
+        if (!op_list.empty()) {
+            PDLOG(INFO, "there are ops in progress, skip partition rebalance");
+            return;
+        }
+    }
+    for (const auto& move : moves) {
+        if (move.type == RebalanceMove::kMigrate) {
+            PDLOG(INFO, "rebalance migrate table[%s] db[%s] pid[%u] from %s to %s", move.name.c_str(),
+                  move.db.c_str(), move.pid, move.src_endpoint.c_str(), move.des_endpoint.c_str());
+            CreateMigrateOP(move.src_endpoint, move.name, move.db, move.pid, move.des_endpoint);
+        } else {
+            PDLOG(INFO, "rebalance change leader of table[%s] db[%s] pid[%u] from %s to %s", move.name.c_str(),
+                  move.db.c_str(), move.pid, move.src_endpoint.c_str(), move.des_endpoint.c_str());
+            // the same as restoring a leader, the old leader rejoins as a follower after the transfer
+            if (CreateChangeLeaderOP(move.name, move.db, move.pid, move.des_endpoint, true) < 0) {
+                continue;
+            }
+            CreateRecoverTableOP(move.name, move.db, move.pid, OFFLINE_LEADER_ENDPOINT, true,
+                                 FLAGS_check_binlog_sync_progress_delta, FLAGS_name_server_task_concurrency);
+        }
+    }
+}
+
 int NameServerImpl::CreateDelReplicaOP(const std::string& name, const std::string& db, uint32_t pid,
                                        const std::string& endpoint) {
     std::string value = endpoint;
@@ -8985,6 +9124,11 @@ void NameServerImpl::AddIndex(RpcController* controller, const AddIndexRequest*
         LOG(WARNING) << "table " << name << " has no column key";
         return;
     }
+    // the index data is dispatched by hash % partition_num, which does not hold after split
+    if (table_info->partition_split_size() > 0) {
+        base::SetResponseStatus(ReturnCode::kOperatorNotSupport, "cannot add index to a split table", response);
+        return;
+    }
     if (request->column_keys_size() > 0) {
         auto status = AddMultiIndexs(db, name, table_info, request->column_keys());
         if (status.OK()) {
@@ -9304,6 +9448,430 @@ int NameServerImpl::CreateAddIndexOPTask(std::shared_ptr<OPData> op_data) {
     return 0;
 }
 
+void NameServerImpl::SplitPartition(RpcController* controller, const SplitPartitionRequest* request,
+                                    GeneralResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    if (!running_.load(std::memory_order_acquire)) {
+        base::SetResponseStatus(ReturnCode::kNameserverIsNotLeader, "nameserver is not leader", response);
+        LOG(WARNING) << "cur nameserver is not leader";
+        return;
+    }
+    const std::string& name = request->name();
+    const std::string& db = request->db();
+    uint32_t pid = request->pid();
+    if (!IsClusterMode()) {
+        base::SetResponseStatus(ReturnCode::kOperatorNotSupport, "split partition is only supported in cluster mode",
+                                response);
+        return;
+    }
+    if (IsHiddenDb(db)) {
+        base::SetResponseStatus(ReturnCode::kOperatorNotSupport, "cannot split the table of system database",
+                                response);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    std::shared_ptr<TableInfo> table_info;
+    if (!GetTableInfoUnlock(name, db, &table_info)) {
+        base::SetResponseStatus(ReturnCode::kTableIsNotExist, "table is not exist!", response);
+        LOG(WARNING) << "table[" << name << "] is not exist!";
+        return;
+    }
+    // the keys of the table with partition key are not routed by the hash of the index keys
+    if (table_info->partition_key_size() > 0) {
+        base::SetResponseStatus(ReturnCode::kOperatorNotSupport, "cannot split the table with partition key",
+                                response);
+        return;
+    }
+    uint64_t modulus = ::openmldb::base::GetPartitionModulus(pid, table_info->table_partition_size(),
+                                                             table_info->partition_split());
+    const TablePartition* partition = nullptr;
+    for (const auto& table_partition : table_info->table_partition()) {
+        if (table_partition.pid() == pid) {
+            partition = &table_partition;
+            break;
+        }
+    }
+    if (modulus == 0 || partition == nullptr) {
+        base::SetResponseStatus(ReturnCode::kPidIsNotExist, "pid is not exist", response);
+        LOG(WARNING) << "pid " << pid << " is not exist. table " << name;
+        return;
+    }
+    if (partition->remote_partition_meta_size() > 0) {
+        base::SetResponseStatus(ReturnCode::kOperatorNotSupport, "cannot split the table with replica cluster",
+                                response);
+        return;
+    }
+    for (const auto& meta : partition->partition_meta()) {
+        if (!meta.is_alive()) {
+            base::SetResponseStatus(ReturnCode::kTabletIsNotHealthy, "partition has replica offline", response);
+            LOG(WARNING) << "replica " << meta.endpoint() << " is offline. table " << name << " pid " << pid;
+            return;
+        }
+    }
+    if (partition->term_offset_size() == 0) {
+        base::SetResponseStatus(ReturnCode::kInvalidParameter, "partition has no term", response);
+        return;
+    }
+    // the new pid is decided when the op is created, so the ops of the table cannot run at the same time
+    for (const auto& op_list : task_vec_) {
+        for (const auto& op_data : op_list) {
+            if (op_data->op_info_.name() == name && op_data->op_info_.db() == db) {
+                base::SetResponseStatus(ReturnCode::kOperatorNotSupport, "the table has op running", response);
+                LOG(WARNING) << "op " << op_data->op_info_.op_id() << " is running on table " << name;
+                return;
+            }
+        }
+    }
+    uint32_t new_pid = table_info->table_partition_size();
+    uint64_t term = partition->term_offset(partition->term_offset_size() - 1).term();
+    if (CreateSplitPartitionOP(name, db, pid, new_pid, modulus * 2, term) < 0) {
+        base::SetResponseStatus(ReturnCode::kCreateOpFailed, "create op failed", response);
+        return;
+    }
+    base::SetResponseOK(response);
+    LOG(INFO) << "split partition. table[" << name << "] pid[" << pid << "] new_pid[" << new_pid << "]";
+}
+
+int NameServerImpl::CreateSplitPartitionOP(const std::string& name, const std::string& db, uint32_t pid,
+                                           uint32_t new_pid, uint64_t modulus, uint64_t term) {
+    SplitPartitionMeta split_partition_meta;
+    split_partition_meta.set_name(name);
+    split_partition_meta.set_db(db);
+    split_partition_meta.set_pid(pid);
+    split_partition_meta.set_new_pid(new_pid);
+    split_partition_meta.set_modulus(modulus);
+    split_partition_meta.set_term(term);
+    std::string value;
+    split_partition_meta.SerializeToString(&value);
+    std::shared_ptr<OPData> op_data;
+    if (CreateOPData(kSplitPartitionOP, value, op_data, name, db, pid) < 0) {
+        PDLOG(WARNING, "create SplitPartitionOP data error. table %s pid %u", name.c_str(), pid);
+        return -1;
+    }
+    if (CreateSplitPartitionOPTask(op_data) < 0) {
+        PDLOG(WARNING, "create SplitPartitionOP task failed. table[%s] pid[%u]", name.c_str(), pid);
+        return -1;
+    }
+    if (AddOPData(op_data) < 0) {
+        PDLOG(WARNING, "add op data failed. name[%s] pid[%u]", name.c_str(), pid);
+        return -1;
+    }
+    PDLOG(INFO, "create SplitPartitionOP op ok. op_id[%lu] name[%s] pid[%u]", op_data->op_info_.op_id(),
+          name.c_str(), pid);
+    return 0;
+}
+
+int NameServerImpl::CreateSplitPartitionOPTask(std::shared_ptr<OPData> op_data) {
+    SplitPartitionMeta split_partition_meta;
+    if (!split_partition_meta.ParseFromString(op_data->op_info_.data())) {
+        PDLOG(WARNING, "parse SplitPartitionMeta failed. data[%s]", op_data->op_info_.data().c_str());
+        return -1;
+    }
+    const std::string& name = split_partition_meta.name();
+    const std::string& db = split_partition_meta.db();
+    uint32_t pid = split_partition_meta.pid();
+    uint32_t new_pid = split_partition_meta.new_pid();
+    uint64_t modulus = split_partition_meta.modulus();
+    std::shared_ptr<TableInfo> table_info;
+    if (!GetTableInfoUnlock(name, db, &table_info)) {
+        PDLOG(WARNING, "get table info failed! name[%s]", name.c_str());
+        return -1;
+    }
+    uint32_t tid = table_info->tid();
+    std::string leader_endpoint;
+    std::vector<std::string> endpoints;
+    for (const auto& part : table_info->table_partition()) {
+        if (part.pid() != pid) {
+            continue;
+        }
+        for (const auto& meta : part.partition_meta()) {
+            if (!meta.is_alive()) {
+                continue;
+            }
+            if (meta.is_leader()) {
+                leader_endpoint = meta.endpoint();
+            }
+            endpoints.push_back(meta.endpoint());
+        }
+    }
+    if (leader_endpoint.empty()) {
+        LOG(WARNING) << "get leader failed. table[" << name << "] pid[" << pid << "]";
+        return -1;
+    }
+    uint64_t op_index = op_data->op_info_.op_id();
+    std::shared_ptr<Task> task = std::make_shared<Task>("", std::make_shared<::openmldb::api::TaskInfo>());
+    task->task_info_->set_op_id(op_index);
+    task->task_info_->set_op_type(kSplitPartitionOP);
+    task->task_info_->set_task_type(::openmldb::api::TaskType::kCreateSplitPartition);
+    task->task_info_->set_status(::openmldb::api::TaskStatus::kInited);
+    task->fun_ = boost::bind(&NameServerImpl::CreateSplitPartition, this, split_partition_meta, task->task_info_);
+    op_data->task_list_.push_back(task);
+    task = CreateSplitTableTask(op_index, kSplitPartitionOP, tid, pid, new_pid, modulus, leader_endpoint);
+    if (!task) {
+        LOG(WARNING) << "create split table task failed. tid[" << tid << "] pid[" << pid << "] endpoint["
+                     << leader_endpoint << "]";
+        return -1;
+    }
+    op_data->task_list_.push_back(task);
+    task = std::make_shared<Task>("", std::make_shared<::openmldb::api::TaskInfo>());
+    task->task_info_->set_op_id(op_index);
+    task->task_info_->set_op_type(kSplitPartitionOP);
+    task->task_info_->set_task_type(::openmldb::api::TaskType::kAddPartitionSplit);
+    task->task_info_->set_status(::openmldb::api::TaskStatus::kInited);
+    task->fun_ = boost::bind(&NameServerImpl::AddPartitionSplit, this, split_partition_meta, task->task_info_);
+    op_data->task_list_.push_back(task);
+    // the followers keep the split too, so that the moved keys are still rejected after a failover
+    task = CreateFinishSplitTableTask(op_index, kSplitPartitionOP, tid, pid, modulus, endpoints);
+    if (!task) {
+        LOG(WARNING) << "create finish split table task failed. tid[" << tid << "] pid[" << pid << "]";
+        return -1;
+    }
+    op_data->task_list_.push_back(task);
+    return 0;
+}
+
+std::shared_ptr<Task> NameServerImpl::CreateSplitTableTask(uint64_t op_index, ::openmldb::api::OPType op_type,
+                                                           uint32_t tid, uint32_t pid, uint32_t new_pid,
+                                                           uint64_t modulus, const std::string& endpoint) {
+    std::shared_ptr<TabletInfo> tablet = GetHealthTabletInfoNoLock(endpoint);
+    if (!tablet) {
+        return std::shared_ptr<Task>();
+    }
+    std::shared_ptr<Task> task = std::make_shared<Task>(endpoint, std::make_shared<::openmldb::api::TaskInfo>());
+    task->task_info_->set_op_id(op_index);
+    task->task_info_->set_op_type(op_type);
+    task->task_info_->set_task_type(::openmldb::api::TaskType::kSplitTable);
+    task->task_info_->set_status(::openmldb::api::TaskStatus::kInited);
+    task->task_info_->set_endpoint(endpoint);
+    boost::function<bool()> fun =
+        boost::bind(&TabletClient::SplitTable, tablet->client_, tid, pid, new_pid, modulus, task->task_info_);
+    task->fun_ = boost::bind(&NameServerImpl::WrapTaskFun, this, fun, task->task_info_);
+    return task;
+}
+
+std::shared_ptr<Task> NameServerImpl::CreateFinishSplitTableTask(uint64_t op_index, ::openmldb::api::OPType op_type,
+                                                                 uint32_t tid, uint32_t pid, uint64_t modulus,
+                                                                 const std::vector<std::string>& endpoints) {
+    std::shared_ptr<Task> task = std::make_shared<Task>("", std::make_shared<::openmldb::api::TaskInfo>());
+    for (const auto& endpoint : endpoints) {
+        std::shared_ptr<TabletInfo> tablet = GetHealthTabletInfoNoLock(endpoint);
+        if (!tablet) {
+            return std::shared_ptr<Task>();
+        }
+        std::shared_ptr<Task> sub_task =
+            std::make_shared<Task>(endpoint, std::make_shared<::openmldb::api::TaskInfo>());
+        sub_task->task_info_->set_op_id(op_index);
+        sub_task->task_info_->set_op_type(op_type);
+        sub_task->task_info_->set_task_type(::openmldb::api::TaskType::kFinishSplitTable);
+        sub_task->task_info_->set_status(::openmldb::api::TaskStatus::kInited);
+        sub_task->task_info_->set_endpoint(endpoint);
+        boost::function<bool()> fun =
+            boost::bind(&TabletClient::FinishSplitTable, tablet->client_, tid, pid, modulus, sub_task->task_info_);
+        sub_task->fun_ = boost::bind(&NameServerImpl::WrapTaskFun, this, fun, sub_task->task_info_);
+        task->sub_task_.push_back(sub_task);
+        PDLOG(INFO, "add subtask kFinishSplitTable. op_id[%lu] tid[%u] pid[%u] endpoint[%s]", op_index, tid, pid,
+              endpoint.c_str());
+    }
+    task->task_info_->set_op_id(op_index);
+    task->task_info_->set_op_type(op_type);
+    task->task_info_->set_task_type(::openmldb::api::TaskType::kFinishSplitTable);
+    task->task_info_->set_status(::openmldb::api::TaskStatus::kInited);
+    task->fun_ = boost::bind(&NameServerImpl::RunSubTask, this, task);
+    return task;
+}
+
+bool NameServerImpl::GetSplitPartitionReplicas(const SplitPartitionMeta& split_partition_meta, uint32_t* tid,
+                                               std::string* leader, std::vector<std::string>* followers) {
+    std::shared_ptr<TableInfo> table_info;
+    if (!GetTableInfoUnlock(split_partition_meta.name(), split_partition_meta.db(), &table_info)) {
+        PDLOG(WARNING, "table[%s] is not exist!", split_partition_meta.name().c_str());
+        return false;
+    }
+    if (static_cast<uint32_t>(table_info->table_partition_size()) != split_partition_meta.new_pid()) {
+        PDLOG(WARNING, "partition num of table[%s] has changed to %d", split_partition_meta.name().c_str(),
+              table_info->table_partition_size());
+        return false;
+    }
+    *tid = table_info->tid();
+    leader->clear();
+    followers->clear();
+    for (const auto& part : table_info->table_partition()) {
+        if (part.pid() != split_partition_meta.pid()) {
+            continue;
+        }
+        for (const auto& meta : part.partition_meta()) {
+            if (!meta.is_alive()) {
+                continue;
+            }
+            if (meta.is_leader()) {
+                *leader = meta.endpoint();
+            } else {
+                followers->push_back(meta.endpoint());
+            }
+        }
+    }
+    if (leader->empty()) {
+        PDLOG(WARNING, "no alive leader. table[%s] pid[%u]", split_partition_meta.name().c_str(),
+              split_partition_meta.pid());
+        return false;
+    }
+    return true;
+}
+
+void NameServerImpl::CreateSplitPartition(const SplitPartitionMeta& split_partition_meta,
+                                          std::shared_ptr<::openmldb::api::TaskInfo> task_info) {
+    uint32_t tid = 0;
+    std::string leader;
+    std::vector<std::string> followers;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (!GetSplitPartitionReplicas(split_partition_meta, &tid, &leader, &followers)) {
+            task_info->set_status(::openmldb::api::TaskStatus::kFailed);
+            return;
+        }
+    }
+    uint32_t pid = split_partition_meta.pid();
+    uint32_t new_pid = split_partition_meta.new_pid();
+    // the new partition has the same schema and replicas as the partition being split
+    auto leader_tablet = GetTablet(leader);
+    ::openmldb::api::TableMeta table_meta;
+    if (!leader_tablet || !leader_tablet->client_->GetTableSchema(tid, pid, table_meta)) {
+        PDLOG(WARNING, "get table meta failed. tid[%u] pid[%u] endpoint[%s] op_id[%lu]", tid, pid, leader.c_str(),
+              task_info->op_id());
+        task_info->set_status(::openmldb::api::TaskStatus::kFailed);
+        return;
+    }
+    table_meta.set_pid(new_pid);
+    table_meta.clear_replicas();
+    // the splits of the old partition moved other keys, the new partition starts without any
+    table_meta.clear_split_modulus();
+    std::vector<std::shared_ptr<TabletInfo>> created;
+    bool ok = true;
+    for (const auto& endpoint : followers) {
+        auto tablet = GetTablet(endpoint);
+        table_meta.set_mode(::openmldb::api::TableMode::kTableFollower);
+        if (!tablet || !tablet->client_->CreateTable(table_meta)) {
+            PDLOG(WARNING, "create table failed. tid[%u] pid[%u] endpoint[%s]", tid, new_pid, endpoint.c_str());
+            ok = false;
+            break;
+        }
+        created.push_back(tablet);
+        table_meta.add_replicas(endpoint);
+    }
+    if (ok) {
+        table_meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+        table_meta.set_term(split_partition_meta.term());
+        if (!leader_tablet->client_->CreateTable(table_meta)) {
+            PDLOG(WARNING, "create table failed. tid[%u] pid[%u] endpoint[%s]", tid, new_pid, leader.c_str());
+            ok = false;
+        }
+    }
+    if (!ok) {
+        for (const auto& tablet : created) {
+            tablet->client_->DropTable(tid, new_pid);
+        }
+        task_info->set_status(::openmldb::api::TaskStatus::kFailed);
+        return;
+    }
+    task_info->set_status(::openmldb::api::TaskStatus::kDone);
+    PDLOG(INFO, "create split partition success. tid[%u] pid[%u] new_pid[%u] op_id[%lu]", tid, pid, new_pid,
+          task_info->op_id());
+}
+
+void NameServerImpl::AddPartitionSplit(const SplitPartitionMeta& split_partition_meta,
+                                       std::shared_ptr<::openmldb::api::TaskInfo> task_info) {
+    std::lock_guard<std::mutex> lock(mu_);
+    uint32_t tid = 0;
+    std::string leader;
+    std::vector<std::string> followers;
+    std::shared_ptr<TableInfo> table_info;
+    if (!GetSplitPartitionReplicas(split_partition_meta, &tid, &leader, &followers) ||
+        !GetTableInfoUnlock(split_partition_meta.name(), split_partition_meta.db(), &table_info)) {
+        task_info->set_status(::openmldb::api::TaskStatus::kFailed);
+        return;
+    }
+    std::shared_ptr<TableInfo> cur_table_info(table_info->New());
+    cur_table_info->CopyFrom(*table_info);
+    TablePartition* table_partition = cur_table_info->add_table_partition();
+    table_partition->set_pid(split_partition_meta.new_pid());
+    PartitionMeta* leader_meta = table_partition->add_partition_meta();
+    leader_meta->set_endpoint(leader);
+    leader_meta->set_is_leader(true);
+    leader_meta->set_is_alive(true);
+    for (const auto& endpoint : followers) {
+        PartitionMeta* partition_meta = table_partition->add_partition_meta();
+        partition_meta->set_endpoint(endpoint);
+        partition_meta->set_is_leader(false);
+        partition_meta->set_is_alive(true);
+    }
+    TermPair* term_pair = table_partition->add_term_offset();
+    term_pair->set_term(split_partition_meta.term());
+    term_pair->set_offset(0);
+    ::openmldb::common::PartitionSplit* split = cur_table_info->add_partition_split();
+    split->set_pid(split_partition_meta.pid());
+    split->set_new_pid(split_partition_meta.new_pid());
+    cur_table_info->set_partition_num(cur_table_info->table_partition_size());
+    if (!UpdateZkTableNodeWithoutNotify(cur_table_info.get())) {
+        task_info->set_status(::openmldb::api::TaskStatus::kFailed);
+        return;
+    }
+    table_info->CopyFrom(*cur_table_info);
+    NotifyTableChanged();
+    task_info->set_status(::openmldb::api::TaskStatus::kDone);
+    PDLOG(INFO, "add partition split. table[%s] pid[%u] new_pid[%u] op_id[%lu]", split_partition_meta.name().c_str(),
+          split_partition_meta.pid(), split_partition_meta.new_pid(), task_info->op_id());
+}
+
+void NameServerImpl::RollbackSplitPartition(const ::openmldb::api::OPInfo& op_info) {
+    SplitPartitionMeta split_partition_meta;
+    if (!split_partition_meta.ParseFromString(op_info.data())) {
+        PDLOG(WARNING, "parse SplitPartitionMeta failed. op_id[%lu]", op_info.op_id());
+        return;
+    }
+    uint32_t pid = split_partition_meta.pid();
+    uint32_t new_pid = split_partition_meta.new_pid();
+    uint32_t tid = 0;
+    bool added = false;
+    std::vector<std::shared_ptr<TabletClient>> clients;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        std::shared_ptr<TableInfo> table_info;
+        if (!GetTableInfoUnlock(split_partition_meta.name(), split_partition_meta.db(), &table_info)) {
+            PDLOG(WARNING, "table[%s] is not exist!", split_partition_meta.name().c_str());
+            return;
+        }
+        tid = table_info->tid();
+        for (const auto& part : table_info->table_partition()) {
+            if (part.pid() == new_pid) {
+                added = true;
+            }
+            if (part.pid() != pid) {
+                continue;
+            }
+            for (const auto& meta : part.partition_meta()) {
+                std::shared_ptr<TabletInfo> tablet = GetHealthTabletInfoNoLock(meta.endpoint());
+                if (tablet) {
+                    clients.push_back(tablet->client_);
+                }
+            }
+        }
+    }
+    for (const auto& client : clients) {
+        // the tablet clears the append hook of the split when its op is canceled
+        if (!client->CancelOP(op_info.op_id())) {
+            PDLOG(WARNING, "tablet[%s] cancel op failed. op_id[%lu]", client->GetEndpoint().c_str(),
+                  op_info.op_id());
+        }
+        // the partition is created by the split but not added to the table, nothing routes to it
+        if (!added && client->DropTable(tid, new_pid)) {
+            PDLOG(INFO, "drop split partition. tid[%u] pid[%u] endpoint[%s]", tid, new_pid,
+                  client->GetEndpoint().c_str());
+        }
+    }
+    PDLOG(INFO, "rollback split partition. table[%s] pid[%u] new_pid[%u] op_id[%lu]",
+          split_partition_meta.name().c_str(), pid, new_pid, op_info.op_id());
+}
+
 std::shared_ptr<Task> NameServerImpl::CreateTableSyncTask(uint64_t op_index, ::openmldb::api::OPType op_type,
                                                           uint32_t tid, const boost::function<bool()>& fun) {
     std::shared_ptr<Task> task = std::make_shared<Task>("", std::make_shared<::openmldb::api::TaskInfo>());
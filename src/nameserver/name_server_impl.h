@@ -35,6 +35,7 @@
 #include "client/tablet_client.h"
 #include "codec/schema_codec.h"
 #include "nameserver/cluster_info.h"
+#include "nameserver/partition_rebalancer.h"
 #include "nameserver/system_table.h"
 #include "proto/name_server.pb.h"
 #include "proto/tablet.pb.h"
@@ -290,6 +291,9 @@ class NameServerImpl : public NameServer {
 
     void AddIndex(RpcController* controller, const AddIndexRequest* request, GeneralResponse* response, Closure* done);
 
+    void SplitPartition(RpcController* controller, const SplitPartitionRequest* request, GeneralResponse* response,
+                        Closure* done);
+
     void UseDatabase(RpcController* controller, const UseDatabaseRequest* request, GeneralResponse* response,
                      Closure* done);
 
@@ -588,6 +592,14 @@ class NameServerImpl : public NameServer {
     std::shared_ptr<Task> CreateTableSyncTask(uint64_t op_index, ::openmldb::api::OPType op_type, uint32_t tid,
                                               const boost::function<bool()>& fun);
 
+    std::shared_ptr<Task> CreateSplitTableTask(uint64_t op_index, ::openmldb::api::OPType op_type, uint32_t tid,
+                                               uint32_t pid, uint32_t new_pid, uint64_t modulus,
+                                               const std::string& endpoint);
+
+    std::shared_ptr<Task> CreateFinishSplitTableTask(uint64_t op_index, ::openmldb::api::OPType op_type, uint32_t tid,
+                                                     uint32_t pid, uint64_t modulus,
+                                                     const std::vector<std::string>& endpoints);
+
     bool GetTableInfo(const std::string& table_name, const std::string& db_name,
                       std::shared_ptr<TableInfo>* table_info);
 
@@ -663,6 +675,24 @@ class NameServerImpl : public NameServer {
 
     int CreateAddIndexOPTask(std::shared_ptr<OPData> op_data);
 
+    int CreateSplitPartitionOP(const std::string& name, const std::string& db, uint32_t pid, uint32_t new_pid,
+                               uint64_t modulus, uint64_t term);
+
+    int CreateSplitPartitionOPTask(std::shared_ptr<OPData> op_data);
+
+    // the alive replicas of the partition being split, which the new partition is placed on
+    bool GetSplitPartitionReplicas(const SplitPartitionMeta& split_partition_meta, uint32_t* tid,
+                                   std::string* leader, std::vector<std::string>* followers);
+
+    void CreateSplitPartition(const SplitPartitionMeta& split_partition_meta,
+                              std::shared_ptr<::openmldb::api::TaskInfo> task_info);
+
+    void AddPartitionSplit(const SplitPartitionMeta& split_partition_meta,
+                           std::shared_ptr<::openmldb::api::TaskInfo> task_info);
+
+    // stop forwarding the writes of a failed or canceled split op and drop the new partition if it is not added
+    void RollbackSplitPartition(const ::openmldb::api::OPInfo& op_info);
+
     int DropTableRemoteOP(const std::string& name, const std::string& db, const std::string& alias,
                           uint64_t parent_id = INVALID_PARENT_ID,
                           uint32_t concurrency = FLAGS_name_server_task_concurrency_for_replica_cluster);
@@ -719,6 +749,11 @@ class NameServerImpl : public NameServer {
 
     void SchedMakeSnapshot();
 
+    void SchedPartitionRebalance();
+
+    // collect the partition load of tablets and submit the moves planned by rebalancer_
+    void RebalancePartition();
+
     void MakeTablePartitionSnapshot(uint32_t pid, uint64_t end_offset,
                                     std::shared_ptr<::openmldb::nameserver::TableInfo> table_info);
 
@@ -818,6 +853,7 @@ class NameServerImpl : public NameServer {
     std::unordered_map<std::string, std::unordered_map<std::string, std::shared_ptr<api::ProcedureInfo>>>
         db_sp_info_map_;
     ::openmldb::type::StartupMode startup_mode_;
+    PartitionRebalancer rebalancer_;
 
     // sr_ could be a real instance or nothing, remember always use atomic_* function to access it
     std::shared_ptr<::openmldb::sdk::SQLClusterRouter> sr_ = nullptr;
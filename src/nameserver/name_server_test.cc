@@ -74,6 +74,7 @@ class NameServerImplTest : public ::testing::Test {
         NameServerImpl* nameserver) {
         return nameserver->table_info_;
     }
+    void RebalancePartition(NameServerImpl* nameserver) { nameserver->RebalancePartition(); }
 };
 
 bool StartNS(const std::string& endpoint, brpc::Server* server, brpc::ServerOptions* options) {
@@ -1519,6 +1520,127 @@ TEST_F(NameServerImplTest, ShowCatalogVersion) {
     }
 }
 
+TEST_F(NameServerImplTest, RebalanceChangeLeader) {
+    FLAGS_zk_cluster = "127.0.0.1:6181";
+    FLAGS_zk_root_path = "/rtidb3" + ::openmldb::test::GenRand();
+    FLAGS_endpoint = "127.0.0.1:9635";
+    NameServerImpl* nameserver = new NameServerImpl();
+    ASSERT_TRUE(nameserver->Init(""));
+    sleep(4);
+    brpc::ServerOptions options;
+    brpc::Server server;
+    ASSERT_EQ(0, server.AddService(nameserver, brpc::SERVER_DOESNT_OWN_SERVICE));
+    ASSERT_EQ(0, server.Start(FLAGS_endpoint.c_str(), &options));
+    ::openmldb::RpcClient<::openmldb::nameserver::NameServer_Stub> name_server_client(FLAGS_endpoint, "");
+    name_server_client.Init();
+
+    std::string leader_ep = "127.0.0.1:9537";
+    std::string follower_ep = "127.0.0.1:9538";
+    FLAGS_endpoint = leader_ep;
+    FLAGS_db_root_path = "/tmp/" + ::openmldb::test::GenRand();
+    TabletImpl* tablet = new TabletImpl();
+    ASSERT_TRUE(tablet->Init(""));
+    brpc::ServerOptions options1;
+    brpc::Server server1;
+    ASSERT_EQ(0, server1.AddService(tablet, brpc::SERVER_DOESNT_OWN_SERVICE));
+    ASSERT_EQ(0, server1.Start(FLAGS_endpoint.c_str(), &options1));
+    ASSERT_TRUE(tablet->RegisterZK());
+
+    FLAGS_endpoint = follower_ep;
+    FLAGS_db_root_path = "/tmp/" + ::openmldb::test::GenRand();
+    TabletImpl* tablet2 = new TabletImpl();
+    ASSERT_TRUE(tablet2->Init(""));
+    brpc::ServerOptions options2;
+    brpc::Server server2;
+    ASSERT_EQ(0, server2.AddService(tablet2, brpc::SERVER_DOESNT_OWN_SERVICE));
+    ASSERT_EQ(0, server2.Start(FLAGS_endpoint.c_str(), &options2));
+    ASSERT_TRUE(tablet2->RegisterZK());
+    sleep(2);
+
+    // all leaders are on one tablet, so the reads of the table only load it
+    std::string db_name = "db" + ::openmldb::test::GenRand();
+    ASSERT_TRUE(CreateDB(name_server_client, db_name));
+    std::string name = "test" + ::openmldb::test::GenRand();
+    {
+        CreateTableRequest request;
+        GeneralResponse response;
+        TableInfo* table_info = request.mutable_table_info();
+        table_info->set_name(name);
+        table_info->set_db(db_name);
+        ::openmldb::test::AddDefaultSchema(0, 0, ::openmldb::type::kAbsoluteTime, table_info);
+        for (uint32_t pid = 0; pid < 2; pid++) {
+            TablePartition* partition = table_info->add_table_partition();
+            partition->set_pid(pid);
+            PartitionMeta* meta = partition->add_partition_meta();
+            meta->set_endpoint(leader_ep);
+            meta->set_is_leader(true);
+            meta = partition->add_partition_meta();
+            meta->set_endpoint(follower_ep);
+            meta->set_is_leader(false);
+        }
+        ASSERT_TRUE(name_server_client.SendRequest(&::openmldb::nameserver::NameServer_Stub::CreateTable, &request,
+                                                   &response, FLAGS_request_timeout_ms, 1));
+        ASSERT_EQ(0, response.code());
+    }
+    sleep(2);
+    auto show_table = [&](TableInfo* table_info) {
+        ShowTableRequest request;
+        request.set_name(name);
+        request.set_db(db_name);
+        ShowTableResponse response;
+        ASSERT_TRUE(name_server_client.SendRequest(&::openmldb::nameserver::NameServer_Stub::ShowTable, &request,
+                                                   &response, FLAGS_request_timeout_ms, 1));
+        ASSERT_EQ(0, response.code());
+        ASSERT_EQ(1, response.table_info_size());
+        *table_info = response.table_info(0);
+    };
+    TableInfo table_info;
+    show_table(&table_info);
+
+    // the first round only records the read counters
+    RebalancePartition(nameserver);
+    for (uint32_t pid = 0; pid < 2; pid++) {
+        for (int i = 0; i < 10; i++) {
+            ::openmldb::api::TraverseRequest request;
+            request.set_tid(table_info.tid());
+            request.set_pid(pid);
+            ::openmldb::api::TraverseResponse response;
+            MockClosure closure;
+            tablet->Traverse(NULL, &request, &response, &closure);
+            ASSERT_EQ(0, response.code());
+        }
+    }
+    sleep(1);
+    RebalancePartition(nameserver);
+
+    // one partition is handed over to the idle follower
+    bool moved = false;
+    for (int i = 0; i < 30 && !moved; i++) {
+        sleep(1);
+        show_table(&table_info);
+        for (const auto& partition : table_info.table_partition()) {
+            for (const auto& meta : partition.partition_meta()) {
+                if (meta.endpoint() == follower_ep && meta.is_leader() && meta.is_alive()) {
+                    moved = true;
+                }
+            }
+        }
+    }
+    ASSERT_TRUE(moved);
+    uint32_t leader_cnt = 0;
+    for (const auto& partition : table_info.table_partition()) {
+        for (const auto& meta : partition.partition_meta()) {
+            if (meta.endpoint() == leader_ep && meta.is_leader()) {
+                leader_cnt++;
+            }
+        }
+    }
+    ASSERT_EQ(1u, leader_cnt);
+    delete nameserver;
+    delete tablet;
+    delete tablet2;
+}
+
 }  // namespace nameserver
 }  // namespace openmldb
 
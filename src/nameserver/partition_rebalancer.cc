@@ -0,0 +1,227 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nameserver/partition_rebalancer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+namespace openmldb {
+namespace nameserver {
+
+namespace {
+
+struct TabletLoad {
+    double mem = 0;
+    double qps = 0;
+};
+
+using PartitionKey = std::pair<uint32_t, uint32_t>;
+
+double ReplicaQps(const ReplicaLoad& replica) { return replica.read_qps + replica.put_qps; }
+
+bool IsSkewed(double max, double avg, double max_skew) { return avg > 0 && max > avg * (1 + max_skew); }
+
+}  // namespace
+
+void PartitionRebalancer::UpdateRates(uint64_t cur_time_ms, std::vector<ReplicaLoad>* replicas) {
+    std::map<std::string, Counter> counters;
+    for (auto& replica : *replicas) {
+        std::string key = std::to_string(replica.tid) + "_" + std::to_string(replica.pid) + "_" + replica.endpoint;
+        auto it = counters_.find(key);
+        if (it != counters_.end() && cur_time_ms > it->second.time_ms) {
+            double seconds = (cur_time_ms - it->second.time_ms) / 1000.0;
+            // the counters restart from zero when the partition is reloaded
+            if (replica.read_cnt >= it->second.read_cnt) {
+                replica.read_qps = (replica.read_cnt - it->second.read_cnt) / seconds;
+            }
+            if (replica.offset >= it->second.offset) {
+                replica.put_qps = (replica.offset - it->second.offset) / seconds;
+            }
+        }
+        counters.emplace(key, Counter{replica.read_cnt, replica.offset, cur_time_ms});
+    }
+    counters_.swap(counters);
+}
+
+std::vector<RebalanceMove> PartitionRebalancer::Plan(const std::vector<ReplicaLoad>& replicas,
+                                                     const std::vector<std::string>& endpoints, double max_skew,
+                                                     uint32_t max_moves) {
+    std::vector<RebalanceMove> moves;
+    if (endpoints.size() < 2 || max_moves == 0) {
+        return moves;
+    }
+    std::map<std::string, TabletLoad> tablets;
+    for (const auto& endpoint : endpoints) {
+        tablets[endpoint];
+    }
+    // work on a copy of the placement, so that every planned move is seen by the next one
+    std::vector<ReplicaLoad> model;
+    std::map<PartitionKey, std::vector<size_t>> partitions;
+    for (const auto& replica : replicas) {
+        auto it = tablets.find(replica.endpoint);
+        if (it == tablets.end()) {
+            continue;
+        }
+        it->second.mem += replica.mem_bytes;
+        it->second.qps += ReplicaQps(replica);
+        partitions[{replica.tid, replica.pid}].push_back(model.size());
+        model.push_back(replica);
+    }
+    auto has_replica = [&](const PartitionKey& key, const std::string& endpoint) {
+        for (auto idx : partitions[key]) {
+            if (model[idx].endpoint == endpoint) {
+                return true;
+            }
+        }
+        return false;
+    };
+    // each partition is moved at most once in a round
+    std::set<PartitionKey> moved;
+    while (moves.size() < max_moves) {
+        double total_mem = 0;
+        double total_qps = 0;
+        std::string mem_hot = tablets.begin()->first;
+        std::string qps_hot = mem_hot;
+        for (const auto& kv : tablets) {
+            total_mem += kv.second.mem;
+            total_qps += kv.second.qps;
+            if (kv.second.mem > tablets[mem_hot].mem) {
+                mem_hot = kv.first;
+            }
+            if (kv.second.qps > tablets[qps_hot].qps) {
+                qps_hot = kv.first;
+            }
+        }
+        bool mem_skewed = IsSkewed(tablets[mem_hot].mem, total_mem / tablets.size(), max_skew);
+        bool qps_skewed = IsSkewed(tablets[qps_hot].qps, total_qps / tablets.size(), max_skew);
+        if (!mem_skewed && !qps_skewed) {
+            break;
+        }
+        bool found = false;
+        if (qps_skewed) {
+            // a leader transfer moves the read load without copying any data, so try it first
+            double hot_qps = tablets[qps_hot].qps;
+            double best_max = hot_qps;
+            size_t best_leader = 0;
+            size_t best_follower = 0;
+            for (const auto& kv : partitions) {
+                if (moved.count(kv.first) > 0) {
+                    continue;
+                }
+                for (auto leader : kv.second) {
+                    if (!model[leader].is_leader || model[leader].endpoint != qps_hot) {
+                        continue;
+                    }
+                    for (auto follower : kv.second) {
+                        if (follower == leader) {
+                            continue;
+                        }
+                        double read_qps = model[leader].read_qps - model[follower].read_qps;
+                        double new_max = std::max(hot_qps - read_qps, tablets[model[follower].endpoint].qps + read_qps);
+                        if (new_max < best_max) {
+                            best_max = new_max;
+                            best_leader = leader;
+                            best_follower = follower;
+                            found = true;
+                        }
+                    }
+                }
+            }
+            if (found) {
+                auto& leader = model[best_leader];
+                auto& follower = model[best_follower];
+                double read_qps = leader.read_qps - follower.read_qps;
+                tablets[leader.endpoint].qps -= read_qps;
+                tablets[follower.endpoint].qps += read_qps;
+                std::swap(leader.read_qps, follower.read_qps);
+                leader.is_leader = false;
+                follower.is_leader = true;
+                moved.insert({leader.tid, leader.pid});
+                moves.push_back({RebalanceMove::kChangeLeader, leader.db, leader.name, leader.pid, leader.endpoint,
+                                 follower.endpoint});
+            }
+        }
+        if (!found) {
+            // migrate a follower from the hottest tablet, balancing memory first
+            bool by_mem = mem_skewed;
+            const std::string& hot = by_mem ? mem_hot : qps_hot;
+            auto weight = [by_mem](const ReplicaLoad& replica) {
+                return by_mem ? static_cast<double>(replica.mem_bytes) : ReplicaQps(replica);
+            };
+            auto load = [&](const std::string& endpoint) {
+                return by_mem ? tablets[endpoint].mem : tablets[endpoint].qps;
+            };
+            std::vector<std::string> colds;
+            for (const auto& kv : tablets) {
+                if (kv.first != hot) {
+                    colds.push_back(kv.first);
+                }
+            }
+            std::sort(colds.begin(), colds.end(),
+                      [&](const std::string& l, const std::string& r) { return load(l) < load(r); });
+            size_t best = 0;
+            std::string best_cold;
+            for (const auto& cold : colds) {
+                double gap = load(hot) - load(cold);
+                double best_dist = gap;
+                for (const auto& kv : partitions) {
+                    if (moved.count(kv.first) > 0 || has_replica(kv.first, cold)) {
+                        continue;
+                    }
+                    for (auto idx : kv.second) {
+                        const auto& replica = model[idx];
+                        if (replica.is_leader || replica.endpoint != hot) {
+                            continue;
+                        }
+                        double w = weight(replica);
+                        // moving a replica heavier than the gap only turns the skew around
+                        if (w <= 0 || w >= gap) {
+                            continue;
+                        }
+                        double dist = std::abs(gap / 2 - w);
+                        if (dist < best_dist) {
+                            best_dist = dist;
+                            best = idx;
+                            best_cold = cold;
+                            found = true;
+                        }
+                    }
+                }
+                if (found) {
+                    break;
+                }
+            }
+            if (!found) {
+                break;
+            }
+            auto& replica = model[best];
+            tablets[hot].mem -= replica.mem_bytes;
+            tablets[hot].qps -= ReplicaQps(replica);
+            tablets[best_cold].mem += replica.mem_bytes;
+            tablets[best_cold].qps += ReplicaQps(replica);
+            replica.endpoint = best_cold;
+            moved.insert({replica.tid, replica.pid});
+            moves.push_back({RebalanceMove::kMigrate, replica.db, replica.name, replica.pid, hot, best_cold});
+        }
+    }
+    return moves;
+}
+
+}  // namespace nameserver
+}  // namespace openmldb
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_NAMESERVER_PARTITION_REBALANCER_H_
+#define SRC_NAMESERVER_PARTITION_REBALANCER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace openmldb {
+namespace nameserver {
+
+// The load of one alive replica of a partition, collected from GetTableStatus
+struct ReplicaLoad {
+    std::string db;
+    std::string name;
+    uint32_t tid = 0;
+    uint32_t pid = 0;
+    std::string endpoint;
+    bool is_leader = false;
+    uint64_t mem_bytes = 0;
+    // cumulative counters reported by the tablet
+    uint64_t read_cnt = 0;
+    uint64_t offset = 0;
+    // rates derived from the counters by PartitionRebalancer::UpdateRates
+    double read_qps = 0;
+    double put_qps = 0;
+};
+
+struct RebalanceMove {
+    enum Type {
+        kChangeLeader = 0,
+        kMigrate = 1,
+    };
+    Type type;
+    std::string db;
+    std::string name;
+    uint32_t pid;
+    std::string src_endpoint;
+    std::string des_endpoint;
+};
+
+// PartitionRebalancer computes the partition moves which bring the memory and the
+// request load of tablets back within `max_skew` of the average. A move is either a
+// leader transfer to an existing follower, which shifts the read load only, or a
+// migration of a follower replica, which shifts both memory and load.
+class PartitionRebalancer {
+ public:
+    PartitionRebalancer() = default;
+
+    // Turn the cumulative counters of `replicas` into per second rates against the
+    // counters seen by the previous call. Replicas seen for the first time get zero rates
+    void UpdateRates(uint64_t cur_time_ms, std::vector<ReplicaLoad>* replicas);
+
+    // Plan at most `max_moves` moves among `endpoints`, replicas on other endpoints are ignored
+    static std::vector<RebalanceMove> Plan(const std::vector<ReplicaLoad>& replicas,
+                                           const std::vector<std::string>& endpoints, double max_skew,
+                                           uint32_t max_moves);
+
+ private:
+    struct Counter {
+        uint64_t read_cnt;
+        uint64_t offset;
+        uint64_t time_ms;
+    };
+    std::map<std::string, Counter> counters_;
+};
+
+}  // namespace nameserver
+}  // namespace openmldb
+
+#endif  // SRC_NAMESERVER_PARTITION_REBALANCER_H_
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nameserver/partition_rebalancer.h"
+
+#include <string>
+#include <vector>
+
+#include "base/glog_wapper.h"
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace nameserver {
+
+class PartitionRebalancerTest : public ::testing::Test {
+ public:
+    PartitionRebalancerTest() {}
+    ~PartitionRebalancerTest() {}
+};
+
+ReplicaLoad MakeReplica(uint32_t pid, const std::string& endpoint, bool is_leader, uint64_t mem_bytes,
+                        double read_qps = 0) {
+    ReplicaLoad replica;
+    replica.db = "db1";
+    replica.name = "t1";
+    replica.tid = 1;
+    replica.pid = pid;
+    replica.endpoint = endpoint;
+    replica.is_leader = is_leader;
+    replica.mem_bytes = mem_bytes;
+    replica.read_qps = read_qps;
+    return replica;
+}
+
+TEST_F(PartitionRebalancerTest, UpdateRates) {
+    PartitionRebalancer rebalancer;
+    std::vector<ReplicaLoad> replicas = {MakeReplica(0, "tb1", true, 100)};
+    replicas[0].read_cnt = 100;
+    replicas[0].offset = 10;
+    rebalancer.UpdateRates(1000, &replicas);
+    ASSERT_EQ(0, replicas[0].read_qps);
+    ASSERT_EQ(0, replicas[0].put_qps);
+    replicas[0].read_cnt = 300;
+    replicas[0].offset = 50;
+    rebalancer.UpdateRates(3000, &replicas);
+    ASSERT_DOUBLE_EQ(100, replicas[0].read_qps);
+    ASSERT_DOUBLE_EQ(20, replicas[0].put_qps);
+    // the partition is reloaded and the counters restart
+    replicas[0].read_cnt = 10;
+    replicas[0].offset = 60;
+    replicas[0].read_qps = 0;
+    rebalancer.UpdateRates(4000, &replicas);
+    ASSERT_EQ(0, replicas[0].read_qps);
+    ASSERT_DOUBLE_EQ(10, replicas[0].put_qps);
+}
+
+TEST_F(PartitionRebalancerTest, Balanced) {
+    std::vector<ReplicaLoad> replicas = {
+        MakeReplica(0, "tb1", true, 100, 10), MakeReplica(0, "tb2", false, 100),
+        MakeReplica(1, "tb2", true, 110, 10), MakeReplica(1, "tb1", false, 110),
+    };
+    auto moves = PartitionRebalancer::Plan(replicas, {"tb1", "tb2"}, 0.2, 2);
+    ASSERT_TRUE(moves.empty());
+    moves = PartitionRebalancer::Plan(replicas, {"tb1"}, 0.2, 2);
+    ASSERT_TRUE(moves.empty());
+}
+
+TEST_F(PartitionRebalancerTest, MigrateFollower) {
+    // tb3 is a newly added tablet
+    std::vector<ReplicaLoad> replicas = {
+        MakeReplica(0, "tb1", true, 100), MakeReplica(0, "tb2", false, 100),
+        MakeReplica(1, "tb2", true, 100), MakeReplica(1, "tb1", false, 100),
+        MakeReplica(2, "tb1", true, 100), MakeReplica(2, "tb2", false, 100),
+    };
+    auto moves = PartitionRebalancer::Plan(replicas, {"tb1", "tb2", "tb3"}, 0.2, 1);
+    ASSERT_EQ(1u, moves.size());
+    ASSERT_EQ(RebalanceMove::kMigrate, moves[0].type);
+    ASSERT_EQ("tb1", moves[0].src_endpoint);
+    ASSERT_EQ("tb3", moves[0].des_endpoint);
+    ASSERT_EQ(1u, moves[0].pid);
+    moves = PartitionRebalancer::Plan(replicas, {"tb1", "tb2", "tb3"}, 0.2, 10);
+    ASSERT_EQ(2u, moves.size());
+    for (const auto& move : moves) {
+        ASSERT_EQ(RebalanceMove::kMigrate, move.type);
+        ASSERT_EQ("tb3", move.des_endpoint);
+    }
+    ASSERT_NE(moves[0].pid, moves[1].pid);
+    ASSERT_NE(moves[0].src_endpoint, moves[1].src_endpoint);
+}
+
+TEST_F(PartitionRebalancerTest, ChangeLeader) {
+    // the memory is balanced, but all the leaders are on tb1
+    std::vector<ReplicaLoad> replicas = {
+        MakeReplica(0, "tb1", true, 100, 1000), MakeReplica(0, "tb2", false, 100),
+        MakeReplica(1, "tb1", true, 100, 1000), MakeReplica(1, "tb2", false, 100),
+    };
+    auto moves = PartitionRebalancer::Plan(replicas, {"tb1", "tb2"}, 0.2, 10);
+    ASSERT_EQ(1u, moves.size());
+    ASSERT_EQ(RebalanceMove::kChangeLeader, moves[0].type);
+    ASSERT_EQ("tb1", moves[0].src_endpoint);
+    ASSERT_EQ("tb2", moves[0].des_endpoint);
+    ASSERT_EQ("db1", moves[0].db);
+    ASSERT_EQ("t1", moves[0].name);
+}
+
+TEST_F(PartitionRebalancerTest, NoBetterPlacement) {
+    // one partition holds all the memory, moving it only turns the skew around
+    std::vector<ReplicaLoad> replicas = {
+        MakeReplica(0, "tb1", true, 1000),
+        MakeReplica(1, "tb2", true, 1),
+    };
+    auto moves = PartitionRebalancer::Plan(replicas, {"tb1", "tb2"}, 0.2, 10);
+    ASSERT_TRUE(moves.empty());
+}
+
+}  // namespace nameserver
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    return RUN_ALL_TESTS();
+}
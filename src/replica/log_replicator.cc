@@ -57,9 +57,12 @@ LogReplicator::LogReplicator(uint32_t tid, uint32_t pid, const std::string& path
       nodes_(),
       local_endpoints_(),
       term_(0),
+      leader_offset_(0),
+      caught_up_time_(0),
       mu_(),
       cv_(),
-      wmu_() {
+      wmu_(),
+      append_hook_() {
     binlog_index_ = 0;
     snapshot_log_part_index_.store(-1, std::memory_order_relaxed);
     snapshot_last_offset_.store(0, std::memory_order_relaxed);
@@ -286,6 +289,13 @@ uint64_t LogReplicator::GetLeaderTerm() { return term_.load(std::memory_order_re
 
 void LogReplicator::SetLeaderTerm(uint64_t term) { term_.store(term, std::memory_order_relaxed); }
 
+void LogReplicator::UpdateLeaderOffset(uint64_t leader_offset) {
+    leader_offset_.store(leader_offset, std::memory_order_relaxed);
+    if (GetOffset() >= leader_offset) {
+        caught_up_time_.store(::baidu::common::timer::get_micros() / 1000, std::memory_order_relaxed);
+    }
+}
+
 bool LogReplicator::ApplyEntry(const LogEntry& entry) {
     std::lock_guard<std::mutex> lock(wmu_);
     uint64_t last_log_offset = GetOffset();
@@ -453,9 +463,27 @@ bool LogReplicator::AppendEntry(LogEntry& entry) {
                                      // sync to remote replica
         follower_offset_.store(cur_offset + 1, std::memory_order_relaxed);
     }
+    if (append_hook_) {
+        append_hook_(entry);
+    }
     return true;
 }
 
+bool LogReplicator::SetAppendHook(uint64_t offset, const AppendHook& hook) {
+    std::lock_guard<std::mutex> lock(wmu_);
+    if (log_offset_.load(std::memory_order_relaxed) != offset) {
+        return false;
+    }
+    append_hook_ = hook;
+    PDLOG(INFO, "set append hook at offset %lu. tid %u pid %u", offset, tid_, pid_);
+    return true;
+}
+
+void LogReplicator::ClearAppendHook() {
+    std::lock_guard<std::mutex> lock(wmu_);
+    append_hook_ = nullptr;
+}
+
 bool LogReplicator::RollWLogFile() {
     if (wh_ != NULL) {
         wh_->EndLog();
@@ -19,6 +19,7 @@
 
 #include <atomic>
 #include <condition_variable>  // NOLINT
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -48,6 +49,8 @@ using ::openmldb::storage::Table;
 
 enum ReplicatorRole { kLeaderNode = 1, kFollowerNode };
 
+typedef std::function<void(const ::openmldb::api::LogEntry&)> AppendHook;
+
 class LogReplicator {
  public:
     LogReplicator(uint32_t tid, uint32_t pid, const std::string& path,
@@ -102,12 +105,25 @@ class LogReplicator {
     uint64_t GetLeaderTerm();
     void SetLeaderTerm(uint64_t term);
 
+    // follower only. The leader offset is carried by AppendEntries, the follower is caught up
+    // when its offset reaches the leader offset
+    void UpdateLeaderOffset(uint64_t leader_offset);
+    inline uint64_t GetLeaderOffset() { return leader_offset_.load(std::memory_order_relaxed); }
+    // the time in ms when the follower was last known to be caught up, 0 if never
+    inline uint64_t GetCaughtUpTime() { return caught_up_time_.load(std::memory_order_relaxed); }
+
     void SetSnapshotLogPartIndex(uint64_t offset);
 
     bool ParseBinlogIndex(const std::string& path, uint32_t& index);  // NOLINT
 
     bool DelAllReplicateNode();
 
+    // set the hook which is called with every entry appended after `offset`. It is called under
+    // the write lock, so it sees the entries in the log order. Fail if the log has gone past `offset`
+    bool SetAppendHook(uint64_t offset, const AppendHook& hook);
+
+    void ClearAppendHook();
+
  private:
     bool OpenSeqFile(const std::string& path, SequentialFile** sf);
 
@@ -129,6 +145,8 @@ class LogReplicator {
     std::vector<std::string> local_endpoints_;
 
     std::atomic<uint64_t> term_;
+    std::atomic<uint64_t> leader_offset_;
+    std::atomic<uint64_t> caught_up_time_;
     // sync mutex
     bthread::Mutex mu_;
     bthread::ConditionVariable cv_;
@@ -137,6 +155,7 @@ class LogReplicator {
     std::atomic<uint64_t> snapshot_last_offset_;
 
     std::mutex wmu_;
+    AppendHook append_hook_;
 };
 
 }  // namespace replica
@@ -147,6 +147,52 @@ TEST_F(LogReplicatorTest, BenchMark) {
     ASSERT_TRUE(ok);
 }
 
+TEST_F(LogReplicatorTest, AppendHook) {
+    std::map<std::string, std::string> map;
+    std::string folder = "/tmp/" + GenRand() + "/";
+    LogReplicator replicator(1, 1, folder, map, kLeaderNode);
+    ASSERT_TRUE(replicator.Init());
+    ::openmldb::api::LogEntry entry;
+    entry.set_term(1);
+    entry.set_pk("test");
+    entry.set_value("test");
+    entry.set_ts(9527);
+    ASSERT_TRUE(replicator.AppendEntry(entry));
+    std::vector<uint64_t> offsets;
+    auto hook = [&offsets](const ::openmldb::api::LogEntry& entry) { offsets.push_back(entry.log_index()); };
+    // the log has gone past offset 0
+    ASSERT_FALSE(replicator.SetAppendHook(0, hook));
+    ASSERT_TRUE(replicator.SetAppendHook(1, hook));
+    ASSERT_TRUE(replicator.AppendEntry(entry));
+    ASSERT_TRUE(replicator.AppendEntry(entry));
+    replicator.ClearAppendHook();
+    ASSERT_TRUE(replicator.AppendEntry(entry));
+    ASSERT_EQ(2u, offsets.size());
+    ASSERT_EQ(2u, offsets[0]);
+    ASSERT_EQ(3u, offsets[1]);
+}
+
+TEST_F(LogReplicatorTest, LeaderOffset) {
+    std::map<std::string, std::string> map;
+    std::string folder = "/tmp/" + GenRand() + "/";
+    LogReplicator replicator(1, 1, folder, map, kFollowerNode);
+    ASSERT_TRUE(replicator.Init());
+    replicator.UpdateLeaderOffset(2);
+    ASSERT_EQ(2u, replicator.GetLeaderOffset());
+    ASSERT_EQ(0u, replicator.GetCaughtUpTime());
+    ::openmldb::api::LogEntry entry;
+    entry.set_term(1);
+    entry.set_pk("test");
+    entry.set_value("test");
+    entry.set_ts(9527);
+    for (uint64_t offset = 1; offset <= 2; offset++) {
+        entry.set_log_index(offset);
+        ASSERT_TRUE(replicator.ApplyEntry(entry));
+    }
+    replicator.UpdateLeaderOffset(2);
+    ASSERT_GT(replicator.GetCaughtUpTime(), 0u);
+}
+
 TEST_F(LogReplicatorTest, LeaderAndFollowerMulti) {
     brpc::ServerOptions options;
     brpc::Server server0;
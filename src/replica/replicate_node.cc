@@ -22,11 +22,13 @@
 
 #include "base/glog_wapper.h"  // NOLINT
 #include "base/strings.h"
+#include "common/timer.h"
 
 DECLARE_int32(binlog_sync_batch_size);
 DECLARE_int32(binlog_sync_wait_time);
 DECLARE_int32(binlog_coffee_time);
 DECLARE_int32(binlog_match_logoffset_interval);
+DECLARE_int32(binlog_heartbeat_interval);
 DECLARE_int32(request_max_retry);
 DECLARE_int32(request_timeout_ms);
 DECLARE_string(zk_cluster);
@@ -66,7 +68,8 @@ ReplicateNode::ReplicateNode(const std::string& point, LogParts* logs, const std
       cv_(cv),
       go_back_cnt_(0),
       rep_node_(rep_follower),
-      follower_offset_(follower_offset) {
+      follower_offset_(follower_offset),
+      last_send_time_(0) {
     if (!real_point.empty()) {
         rpc_client_ = openmldb::RpcClient<::openmldb::api::TabletServer_Stub>(real_point);
     }
@@ -114,6 +117,7 @@ void ReplicateNode::SyncData() {
             bthread_usleep(coffee_time * 1000);
             coffee_time = 0;
         }
+        bool heartbeat = false;
         {
             std::unique_lock<bthread::Mutex> lock(*mu_);
             // no new data append and wait
@@ -126,8 +130,18 @@ void ReplicateNode::SyncData() {
                           endpoint_.c_str(), tid_, pid_);
                     return;
                 }
+                if (FLAGS_binlog_heartbeat_interval > 0 && last_sync_offset_ > 0 &&
+                    !rep_node_.load(std::memory_order_relaxed) &&
+                    ::baidu::common::timer::get_micros() / 1000 >= last_send_time_ + FLAGS_binlog_heartbeat_interval) {
+                    heartbeat = true;
+                    break;
+                }
             }
         }
+        if (heartbeat) {
+            SendHeartbeat();
+            continue;
+        }
         int ret;
         if (rep_node_.load(std::memory_order_relaxed)) {
             ret = SyncData(follower_offset_->load(std::memory_order_relaxed));
@@ -141,6 +155,24 @@ void ReplicateNode::SyncData() {
     PDLOG(INFO, "replicate log to endpoint %s for table #tid %u #pid %u exist", endpoint_.c_str(), tid_, pid_);
 }
 
+void ReplicateNode::SendHeartbeat() {
+    ::openmldb::api::AppendEntriesRequest request;
+    ::openmldb::api::AppendEntriesResponse response;
+    request.set_tid(tid_);
+    request.set_pid(pid_);
+    request.set_pre_log_index(last_sync_offset_);
+    request.set_leader_offset(leader_log_offset_->load(std::memory_order_relaxed));
+    if (!FLAGS_zk_cluster.empty()) {
+        request.set_term(term_->load(std::memory_order_relaxed));
+    }
+    last_send_time_ = ::baidu::common::timer::get_micros() / 1000;
+    bool ret = rpc_client_.SendRequest(&::openmldb::api::TabletServer_Stub::AppendEntries, &request, &response,
+                                       FLAGS_request_timeout_ms, 1);
+    if (!ret || response.code() != 0) {
+        DEBUGLOG("fail to send heartbeat to node %s. tid %u pid %u", endpoint_.c_str(), tid_, pid_);
+    }
+}
+
 int ReplicateNode::GetLogIndex() { return log_reader_.GetLogIndex(); }
 
 bool ReplicateNode::IsLogMatched() { return log_matched_; }
@@ -206,6 +238,9 @@ int ReplicateNode::SyncData(uint64_t log_offset) {
         if (!FLAGS_zk_cluster.empty()) {
             request.set_term(term_->load(std::memory_order_relaxed));
         }
+        if (!rep_node_.load(std::memory_order_relaxed)) {
+            request.set_leader_offset(leader_log_offset_->load(std::memory_order_relaxed));
+        }
         uint32_t batchSize = log_offset - last_sync_offset_;
         batchSize = std::min(batchSize, (uint32_t)FLAGS_binlog_sync_batch_size);
         for (uint64_t i = 0; i < batchSize;) {
@@ -275,6 +310,7 @@ int ReplicateNode::SyncData(uint64_t log_offset) {
         if (ret && response.code() == 0) {
             DEBUGLOG("sync log to node[%s] to offset %lld", endpoint_.c_str(), sync_log_offset);
             last_sync_offset_ = sync_log_offset;
+            last_send_time_ = ::baidu::common::timer::get_micros() / 1000;
             if (!rep_node_.load(std::memory_order_relaxed) &&
                 (last_sync_offset_ > follower_offset_->load(std::memory_order_relaxed))) {
                 follower_offset_->store(last_sync_offset_, std::memory_order_relaxed);
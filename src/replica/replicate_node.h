@@ -72,6 +72,9 @@ class ReplicateNode {
  private:
     int MatchLogOffsetFromNode();
 
+    // tell an idle follower the leader offset, so that it knows it is caught up
+    void SendHeartbeat();
+
  private:
     LogReader log_reader_;
     std::vector<::openmldb::api::AppendEntriesRequest> cache_;
@@ -90,6 +93,7 @@ class ReplicateNode {
     uint32_t go_back_cnt_;
     std::atomic<bool> rep_node_;
     std::atomic<uint64_t>* follower_offset_;  // max local cluster follower offset
+    uint64_t last_send_time_;
 };
 
 }  // namespace replica
@@ -35,9 +35,14 @@
 #include <brpc/channel.h>
 #include <brpc/controller.h>
 #include <brpc/retry_policy.h>
+#include <bthread/condition_variable.h>
+#include <bthread/mutex.h>
 #include <gflags/gflags.h>
 
+#include <cerrno>
+#include <deque>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
 #include <utility>
@@ -191,6 +196,41 @@ class RpcClient {
     brpc::Channel* channel_;
 };
 
+// Collects the completions of a group of asynchronous calls, so that the responses
+// are consumed in the order they arrive rather than the order they are sent
+class RpcCompletionQueue {
+ public:
+    void Push(size_t idx) {
+        std::lock_guard<bthread::Mutex> lock(mu_);
+        done_.push_back(idx);
+        cv_.notify_one();
+    }
+
+    // wait at most timeout_us for a completed call, wait forever if timeout_us < 0.
+    // Returns false on timeout
+    bool Pop(int64_t timeout_us, size_t* idx) {
+        std::unique_lock<bthread::Mutex> lock(mu_);
+        while (done_.empty()) {
+            if (timeout_us < 0) {
+                cv_.wait(lock);
+            } else if (cv_.wait_for(lock, timeout_us) == ETIMEDOUT) {
+                if (done_.empty()) {
+                    return false;
+                }
+                break;
+            }
+        }
+        *idx = done_.front();
+        done_.pop_front();
+        return true;
+    }
+
+ private:
+    bthread::Mutex mu_;
+    bthread::ConditionVariable cv_;
+    std::deque<size_t> done_;
+};
+
 template <class Response>
 class RpcCallback : public google::protobuf::Closure {
  public:
@@ -200,10 +240,31 @@ class RpcCallback : public google::protobuf::Closure {
     ~RpcCallback() {}
 
     void Run() override {
-        is_done_.store(true, std::memory_order_release);
+        std::shared_ptr<RpcCompletionQueue> queue;
+        {
+            std::lock_guard<bthread::Mutex> lock(mu_);
+            is_done_.store(true, std::memory_order_release);
+            queue = queue_;
+        }
+        if (queue) {
+            queue->Push(queue_idx_);
+        }
         UnRef();
     }
 
+    // push `idx` to `queue` when the call is done, immediately if it is done already
+    void SetCompletionQueue(const std::shared_ptr<RpcCompletionQueue>& queue, size_t idx) {
+        {
+            std::lock_guard<bthread::Mutex> lock(mu_);
+            queue_idx_ = idx;
+            queue_ = queue;
+            if (!IsDone()) {
+                return;
+            }
+        }
+        queue->Push(idx);
+    }
+
     inline const std::shared_ptr<Response>& GetResponse() const { return response_; }
 
     inline const std::shared_ptr<brpc::Controller>& GetController() const { return cntl_; }
@@ -223,6 +284,9 @@ class RpcCallback : public google::protobuf::Closure {
     std::shared_ptr<brpc::Controller> cntl_;
     std::atomic<bool> is_done_;
     std::atomic<uint32_t> ref_count_;
+    bthread::Mutex mu_;
+    std::shared_ptr<RpcCompletionQueue> queue_;
+    size_t queue_idx_ = 0;
 };
 
 }  // namespace openmldb
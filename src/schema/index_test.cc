@@ -14,6 +14,11 @@
  * limitations under the License.
  */
 
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "schema/index_util.h"
 
@@ -41,6 +46,37 @@ TEST_F(IndexTest, CheckUnique) {
     ASSERT_FALSE(IndexUtil::CheckUnique(indexs).OK());
 }
 
+TEST_F(IndexTest, CheckKeyEncoding) {
+    std::map<std::string, ::openmldb::common::ColumnDesc> column_map;
+    for (const auto& kv : std::vector<std::pair<std::string, ::openmldb::type::DataType>>{
+             {"s1", ::openmldb::type::kString}, {"s2", ::openmldb::type::kVarchar},
+             {"i1", ::openmldb::type::kBigInt}, {"f1", ::openmldb::type::kDouble}}) {
+        ::openmldb::common::ColumnDesc desc;
+        desc.set_name(kv.first);
+        desc.set_data_type(kv.second);
+        column_map.emplace(kv.first, desc);
+    }
+    PBIndex indexs;
+    auto index = indexs.Add();
+    index->set_index_name("index1");
+    index->add_col_name("s1");
+    index->add_col_name("i1");
+    index->set_key_encoding(::openmldb::type::kMemcomparableKey);
+    ASSERT_TRUE(IndexUtil::CheckIndex(column_map, indexs).OK());
+    // the joined values of two string columns can not be split back
+    index->add_col_name("s2");
+    ASSERT_FALSE(IndexUtil::CheckIndex(column_map, indexs).OK());
+    index->set_key_encoding(::openmldb::type::kDelimitedKey);
+    ASSERT_TRUE(IndexUtil::CheckIndex(column_map, indexs).OK());
+
+    ::openmldb::common::ColumnKey column_key;
+    column_key.set_index_name("index2");
+    column_key.add_col_name("i1");
+    column_key.add_col_name("f1");
+    column_key.set_key_encoding(::openmldb::type::kMemcomparableKey);
+    ASSERT_FALSE(IndexUtil::CheckKeyEncoding(column_map, column_key).OK());
+}
+
 }  // namespace schema
 }  // namespace openmldb
 
@@ -107,6 +107,36 @@ base::Status IndexUtil::CheckIndex(const std::map<std::string, ::openmldb::commo
                 return {base::ReturnCode::kError, "ttl check failed"};
             }
         }
+        auto status = CheckKeyEncoding(column_map, column_key);
+        if (!status.OK()) {
+            return status;
+        }
+    }
+    return {};
+}
+
+base::Status IndexUtil::CheckKeyEncoding(const std::map<std::string, ::openmldb::common::ColumnDesc>& column_map,
+        const ::openmldb::common::ColumnKey& column_key) {
+    if (column_key.key_encoding() != ::openmldb::type::kMemcomparableKey) {
+        return {};
+    }
+    uint32_t str_cnt = 0;
+    for (const auto& column_name : column_key.col_name()) {
+        auto iter = column_map.find(column_name);
+        if (iter == column_map.end()) {
+            continue;
+        }
+        auto type = iter->second.data_type();
+        if (type == ::openmldb::type::kFloat || type == ::openmldb::type::kDouble) {
+            return {base::ReturnCode::kError, "memcomparable key does not support the float column " + column_name};
+        }
+        if (type == ::openmldb::type::kString || type == ::openmldb::type::kVarchar) {
+            str_cnt++;
+        }
+    }
+    if (str_cnt > 1) {
+        return {base::ReturnCode::kError,
+            "memcomparable key supports at most one string column, index is: " + column_key.index_name()};
     }
     return {};
 }
@@ -220,7 +250,7 @@ base::Status IndexUtil::CheckNewIndex(const ::openmldb::common::ColumnKey& colum
             return {base::ReturnCode::kError, "duplicated index"};
         }
     }
-    return {};
+    return CheckKeyEncoding(col_map, column_key);
 }
 
 }  // namespace schema
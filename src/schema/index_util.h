@@ -47,6 +47,11 @@ class IndexUtil {
 
     static bool CheckTTL(const ::openmldb::common::TTLSt& ttl);
 
+    // the sql engine looks up a memcomparable key by the column values joined with "|", which can not be split back
+    // if more than one column is a string
+    static base::Status CheckKeyEncoding(const std::map<std::string, ::openmldb::common::ColumnDesc>& column_map,
+            const ::openmldb::common::ColumnKey& column_key);
+
     static bool AddDefaultIndex(openmldb::nameserver::TableInfo* table_info);
 
     static bool FillColumnKey(openmldb::nameserver::TableInfo* table_info);
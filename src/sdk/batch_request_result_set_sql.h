@@ -72,6 +72,10 @@ class SQLBatchRequestResultSet : public ::hybridse::sdk::ResultSet {
 
     inline int32_t Size() { return response_->count(); }
 
+    // the raw response and rows buffer, rows can be passed through without decoding
+    const ::openmldb::api::SQLBatchRequestQueryResponse& GetResponse() const { return *response_; }
+    const butil::IOBuf& GetRowsBuf() const { return cntl_->response_attachment(); }
+
  private:
     inline uint32_t GetRecordSize() { return response_->count(); }
 
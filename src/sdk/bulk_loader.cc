@@ -0,0 +1,793 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/bulk_loader.h"
+
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <fstream>
+#include <thread>  // NOLINT
+
+#include "base/file_util.h"
+#include "base/glog_wapper.h"
+#include "base/hash.h"
+#include "codec/field_codec.h"
+#include "common/timer.h"
+#include "sdk/split.h"
+
+#ifdef __parquet_enable__
+#include "absl/time/civil_time.h"
+#include "parquet/api/reader.h"
+#endif
+
+namespace openmldb {
+namespace sdk {
+
+// the same seed as storage::MemTable, so that a key goes to the same segment
+static constexpr uint32_t SEED = 0xe17a1465;
+// storage::DEFUALT_TS_COL_ID, the ts column id of an index without ts column
+static constexpr uint32_t AUTO_TS_COL_ID = UINT32_MAX;
+// the estimated size of a time entry or the fixed part of a key entry in the index region
+static constexpr uint64_t ENTRY_SIZE = 16;
+// the estimated size of the tags and lengths of a block info and a binlog info
+static constexpr uint64_t DATA_INFO_SIZE = 10;
+// the lines read by the main thread are handed to the workers in batches
+static constexpr uint32_t CSV_BATCH_SIZE = 1024;
+
+SegmentIndexRegion::SegmentIndexRegion(uint32_t ts_cnt, const std::map<uint32_t, uint32_t>& ts_idx_map)
+    : ts_cnt_(ts_cnt), ts_idx_map_(ts_idx_map), entries_(), started_(false), key_it_(), key_entry_idx_(0),
+      time_idx_(0) {}
+
+bool SegmentIndexRegion::Put(const std::string& key, const std::map<uint32_t, uint64_t>& ts_map,
+                             uint32_t block_id) {
+    if (started_ || ts_cnt_ == 0 || ts_idx_map_.empty()) {
+        return false;
+    }
+    if (ts_cnt_ == 1) {
+        auto pos = ts_map.find(ts_idx_map_.begin()->first);
+        if (pos == ts_map.end()) {
+            return false;
+        }
+        auto& key_entries = entries_[key];
+        key_entries.resize(1);
+        key_entries[0].emplace_back(pos->second, block_id);
+        return true;
+    }
+    bool put = false;
+    for (const auto& kv : ts_map) {
+        auto pos = ts_idx_map_.find(kv.first);
+        if (pos == ts_idx_map_.end() || pos->second >= ts_cnt_) {
+            continue;
+        }
+        auto& key_entries = entries_[key];
+        key_entries.resize(ts_cnt_);
+        key_entries[pos->second].emplace_back(kv.second, block_id);
+        put = true;
+    }
+    return put;
+}
+
+bool SegmentIndexRegion::BuildPartial(uint32_t seg_id, uint64_t size_limit, uint64_t* size,
+                                      ::openmldb::api::Segment* segment) {
+    if (!started_) {
+        started_ = true;
+        for (auto& kv : entries_) {
+            for (auto& times : kv.second) {
+                std::stable_sort(times.begin(), times.end(),
+                                 [](const std::pair<uint64_t, uint32_t>& l, const std::pair<uint64_t, uint32_t>& r) {
+                                     return l.first < r.first;
+                                 });
+            }
+        }
+        key_it_ = entries_.begin();
+        key_entry_idx_ = 0;
+        time_idx_ = 0;
+    }
+    segment->set_id(seg_id);
+    bool built = false;
+    for (; key_it_ != entries_.end(); ++key_it_, key_entry_idx_ = 0, time_idx_ = 0) {
+        const auto& key_entries = key_it_->second;
+        ::openmldb::api::Segment::KeyEntries* pb_key_entries = nullptr;
+        for (; key_entry_idx_ < key_entries.size(); key_entry_idx_++, time_idx_ = 0) {
+            const auto& times = key_entries[key_entry_idx_];
+            ::openmldb::api::Segment::KeyEntries::KeyEntry* pb_key_entry = nullptr;
+            for (; time_idx_ < times.size(); time_idx_++) {
+                if (built && *size >= size_limit) {
+                    return false;
+                }
+                if (pb_key_entries == nullptr) {
+                    pb_key_entries = segment->add_key_entries();
+                    pb_key_entries->set_key(key_it_->first);
+                    *size += key_it_->first.size() + ENTRY_SIZE;
+                }
+                if (pb_key_entry == nullptr) {
+                    pb_key_entry = pb_key_entries->add_key_entry();
+                    pb_key_entry->set_key_entry_id(key_entry_idx_);
+                    *size += ENTRY_SIZE;
+                }
+                auto* time_entry = pb_key_entry->add_time_entry();
+                time_entry->set_time(times[time_idx_].first);
+                time_entry->set_block_id(times[time_idx_].second);
+                *size += ENTRY_SIZE;
+                built = true;
+            }
+        }
+    }
+    return true;
+}
+
+BulkLoadPartition::BulkLoadPartition(uint32_t tid, uint32_t pid,
+                                     std::shared_ptr<::openmldb::client::TabletClient> client,
+                                     uint64_t rpc_size_limit)
+    : tid_(tid), pid_(pid), client_(client), rpc_size_limit_(rpc_size_limit), info_(), regions_(), mu_(),
+      part_id_(0), next_block_id_(0), data_offset_(0), data_request_(), data_(), data_size_(0) {}
+
+::openmldb::base::Status BulkLoadPartition::Init() {
+    if (!client_) {
+        return {::openmldb::base::ReturnCode::kError,
+                "fail to get the leader of partition " + std::to_string(tid_) + "-" + std::to_string(pid_)};
+    }
+    auto status = client_->GetBulkLoadInfo(tid_, pid_, &info_);
+    if (!status.OK()) {
+        return status;
+    }
+    if (info_.seg_cnt() == 0 || info_.inner_index_size() != info_.inner_segments_size()) {
+        return {::openmldb::base::ReturnCode::kError, "invalid bulk load info from " + client_->GetEndpoint()};
+    }
+    for (const auto& inner_segments : info_.inner_segments()) {
+        if (inner_segments.segment_size() != static_cast<int>(info_.seg_cnt())) {
+            return {::openmldb::base::ReturnCode::kError, "invalid bulk load info from " + client_->GetEndpoint()};
+        }
+        std::vector<SegmentIndexRegion> segments;
+        segments.reserve(inner_segments.segment_size());
+        for (const auto& segment : inner_segments.segment()) {
+            std::map<uint32_t, uint32_t> ts_idx_map;
+            for (const auto& kv : segment.ts_idx_map()) {
+                ts_idx_map.emplace(kv.key(), kv.value());
+            }
+            segments.emplace_back(segment.ts_cnt(), ts_idx_map);
+        }
+        regions_.push_back(std::move(segments));
+    }
+    data_request_.set_tid(tid_);
+    data_request_.set_pid(pid_);
+    return {};
+}
+
+::openmldb::base::Status BulkLoadPartition::AddRow(const std::string& row,
+                                                   const std::vector<std::pair<std::string, uint32_t>>& dimensions,
+                                                   const std::map<uint32_t, uint64_t>& ts_map, uint64_t time) {
+    if (dimensions.empty() || ts_map.empty()) {
+        return {::openmldb::base::ReturnCode::kError, "empty dimension or ts"};
+    }
+    // the same as MemTable::Put, the first key of an inner index is used
+    std::map<int32_t, const std::string*> inner_index_key_map;
+    for (const auto& dim : dimensions) {
+        int32_t inner_pos = dim.second < static_cast<uint32_t>(info_.inner_index_pos_size())
+                                ? info_.inner_index_pos(dim.second)
+                                : -1;
+        if (inner_pos < 0 || inner_pos >= info_.inner_index_size()) {
+            return {::openmldb::base::ReturnCode::kError, "invalid dimension idx " + std::to_string(dim.second)};
+        }
+        inner_index_key_map.emplace(inner_pos, &dim.first);
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    uint32_t block_id = next_block_id_;
+    uint32_t ref_cnt = 0;
+    for (const auto& kv : inner_index_key_map) {
+        bool need_put = false;
+        for (const auto& index_def : info_.inner_index(kv.first).index_def()) {
+            if (index_def.is_ready()) {
+                ref_cnt++;
+                need_put = true;
+            }
+        }
+        if (!need_put) {
+            continue;
+        }
+        const std::string& key = *kv.second;
+        uint32_t seg_idx = 0;
+        if (info_.seg_cnt() > 1) {
+            seg_idx = ::openmldb::base::hash(key.data(), key.size(), SEED) % info_.seg_cnt();
+        }
+        regions_[kv.first][seg_idx].Put(key, ts_map, block_id);
+    }
+    auto* block_info = data_request_.add_block_info();
+    block_info->set_ref_cnt(ref_cnt);
+    block_info->set_offset(data_offset_);
+    block_info->set_length(row.size());
+    auto* binlog_info = data_request_.add_binlog_info();
+    for (const auto& dim : dimensions) {
+        auto* dimension = binlog_info->add_dimensions();
+        dimension->set_key(dim.first);
+        dimension->set_idx(dim.second);
+    }
+    binlog_info->set_time(time);
+    binlog_info->set_block_id(block_id);
+    data_.append(row);
+    data_offset_ += row.size();
+    data_size_ += row.size() + block_info->ByteSizeLong() + binlog_info->ByteSizeLong() + DATA_INFO_SIZE;
+    next_block_id_++;
+    if (data_size_ >= rpc_size_limit_) {
+        return SendData();
+    }
+    return {};
+}
+
+::openmldb::base::Status BulkLoadPartition::Finish() {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto status = SendData();
+    if (!status.OK()) {
+        return status;
+    }
+    if (next_block_id_ == 0) {
+        return {};
+    }
+    return SendIndex();
+}
+
+::openmldb::base::Status BulkLoadPartition::SendData() {
+    if (data_request_.block_info_size() == 0) {
+        return {};
+    }
+    data_request_.set_part_id(part_id_);
+    auto status = client_->BulkLoad(data_request_, &data_);
+    if (!status.OK()) {
+        return status;
+    }
+    DLOG(INFO) << tid_ << "-" << pid_ << " sent data part " << part_id_ << ", " << data_request_.block_info_size()
+               << " rows";
+    part_id_++;
+    data_request_.clear_block_info();
+    data_request_.clear_binlog_info();
+    data_.clear();
+    data_offset_ = 0;
+    data_size_ = 0;
+    return {};
+}
+
+::openmldb::base::Status BulkLoadPartition::SendIndex() {
+    // inner index -> segment of the regions to send
+    std::vector<std::pair<uint32_t, uint32_t>> pending;
+    for (uint32_t i = 0; i < regions_.size(); i++) {
+        for (uint32_t j = 0; j < regions_[i].size(); j++) {
+            if (!regions_[i][j].Empty()) {
+                pending.emplace_back(i, j);
+            }
+        }
+    }
+    size_t pos = 0;
+    do {
+        ::openmldb::api::BulkLoadRequest request;
+        request.set_tid(tid_);
+        request.set_pid(pid_);
+        request.set_part_id(part_id_);
+        uint64_t size = 0;
+        while (pos < pending.size() && size < rpc_size_limit_) {
+            uint32_t inner_id = pending[pos].first;
+            uint32_t seg_id = pending[pos].second;
+            int last = request.index_region_size() - 1;
+            ::openmldb::api::BulkLoadIndex* index = nullptr;
+            if (last >= 0 && request.index_region(last).inner_index_id() == inner_id) {
+                index = request.mutable_index_region(last);
+            } else {
+                index = request.add_index_region();
+                index->set_inner_index_id(inner_id);
+            }
+            if (regions_[inner_id][seg_id].BuildPartial(seg_id, rpc_size_limit_, &size, index->add_segment())) {
+                pos++;
+            }
+        }
+        request.set_eof(pos >= pending.size());
+        auto status = client_->BulkLoad(request, nullptr);
+        if (!status.OK()) {
+            return status;
+        }
+        part_id_++;
+    } while (pos < pending.size());
+    return {};
+}
+
+BulkLoader::BulkLoader(std::shared_ptr<::openmldb::nameserver::TableInfo> table_info,
+                       std::vector<std::shared_ptr<::openmldb::client::TabletClient>> clients, RowFactory new_row,
+                       uint32_t thread_num, uint64_t rpc_size_limit)
+    : table_info_(table_info), clients_(std::move(clients)), new_row_(std::move(new_row)),
+      thread_num_(std::max(thread_num, 1u)), rpc_size_limit_(rpc_size_limit), partitions_(), ts_cols_(),
+      row_cnt_(0), failed_(false), mu_(), error_() {}
+
+::openmldb::base::Status BulkLoader::Init() {
+    if (!table_info_ || !new_row_) {
+        return {::openmldb::base::ReturnCode::kError, "invalid bulk loader"};
+    }
+    if (static_cast<int>(clients_.size()) != table_info_->table_partition_size()) {
+        return {::openmldb::base::ReturnCode::kError, "the leaders mismatch the partitions of table " +
+                                                          table_info_->name()};
+    }
+    for (uint32_t pid = 0; pid < clients_.size(); pid++) {
+        auto partition = std::make_unique<BulkLoadPartition>(table_info_->tid(), pid, clients_[pid], rpc_size_limit_);
+        auto status = partition->Init();
+        if (!status.OK()) {
+            return status;
+        }
+        partitions_.push_back(std::move(partition));
+    }
+    // the ts columns are the same in all partitions
+    for (const auto& inner_index : partitions_.front()->GetInfo().inner_index()) {
+        for (const auto& index_def : inner_index.index_def()) {
+            uint32_t ts_idx = static_cast<uint32_t>(index_def.ts_idx());
+            if (ts_idx == AUTO_TS_COL_ID) {
+                ts_cols_.emplace(ts_idx, ::openmldb::type::kBigInt);
+            } else if (ts_idx < static_cast<uint32_t>(table_info_->column_desc_size())) {
+                ts_cols_.emplace(ts_idx, table_info_->column_desc(ts_idx).data_type());
+            } else {
+                return {::openmldb::base::ReturnCode::kError, "invalid ts column " + std::to_string(ts_idx)};
+            }
+        }
+    }
+    return {};
+}
+
+::openmldb::base::Status BulkLoader::AddRow(const std::shared_ptr<SQLInsertRow>& row,
+                                            const ::openmldb::codec::RowView& view) {
+    if (!row->IsComplete()) {
+        return {::openmldb::base::ReturnCode::kError, "the row is not complete"};
+    }
+    const auto& value = row->GetRow();
+    const auto* data = reinterpret_cast<const int8_t*>(value.data());
+    uint64_t time = ::baidu::common::timer::get_micros() / 1000;
+    std::map<uint32_t, uint64_t> ts_map;
+    for (const auto& kv : ts_cols_) {
+        int64_t ts = 0;
+        if (kv.first == AUTO_TS_COL_ID) {
+            ts = time;
+        } else if (view.GetInteger(data, kv.first, kv.second, &ts) != 0) {
+            return {::openmldb::base::ReturnCode::kError,
+                    "fail to get ts of column " + table_info_->column_desc(kv.first).name()};
+        }
+        ts_map.emplace(kv.first, ts);
+    }
+    for (const auto& kv : row->GetDimensions()) {
+        if (kv.first >= partitions_.size()) {
+            return {::openmldb::base::ReturnCode::kError, "invalid pid " + std::to_string(kv.first)};
+        }
+        auto status = partitions_[kv.first]->AddRow(value, kv.second, ts_map, time);
+        if (!status.OK()) {
+            return status;
+        }
+    }
+    row_cnt_.fetch_add(1, std::memory_order_relaxed);
+    return {};
+}
+
+::openmldb::base::Status BulkLoader::Finish() {
+    if (failed_.load(std::memory_order_relaxed)) {
+        return GetError();
+    }
+    // the index regions of the partitions are built and sent in parallel
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < std::min<size_t>(thread_num_, partitions_.size()); i++) {
+        threads.emplace_back([this, i] {
+            for (size_t pid = i; pid < partitions_.size(); pid += thread_num_) {
+                auto status = partitions_[pid]->Finish();
+                if (!status.OK()) {
+                    SetError(status);
+                    return;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (failed_.load(std::memory_order_relaxed)) {
+        return GetError();
+    }
+    return {};
+}
+
+void BulkLoader::SetError(const ::openmldb::base::Status& status) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!failed_.load(std::memory_order_relaxed)) {
+        error_ = status;
+        failed_.store(true, std::memory_order_relaxed);
+    }
+}
+
+::openmldb::base::Status BulkLoader::GetError() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return error_;
+}
+
+::openmldb::base::Status BulkLoader::LoadCsv(const std::string& file_path, const std::string& delimiter, char quote,
+                                             bool header, const std::string& null_value) {
+    if (!base::IsExists(file_path)) {
+        return {::openmldb::base::ReturnCode::kError, "file not exist"};
+    }
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        return {::openmldb::base::ReturnCode::kError, "open file failed"};
+    }
+    auto status = Init();
+    if (!status.OK()) {
+        return status;
+    }
+    const auto& columns = table_info_->column_desc();
+    std::string line;
+    if (header) {
+        if (!std::getline(file, line)) {
+            return {::openmldb::base::ReturnCode::kError, "read from file failed"};
+        }
+        std::vector<std::string> cols;
+        ::openmldb::sdk::SplitLineWithDelimiterForStrings(line, delimiter, &cols, quote);
+        if (static_cast<int>(cols.size()) != columns.size()) {
+            return {::openmldb::base::ReturnCode::kError, "mismatch column size"};
+        }
+        for (int i = 0; i < columns.size(); i++) {
+            if (cols[i] != columns.Get(i).name()) {
+                return {::openmldb::base::ReturnCode::kError, "mismatch column name"};
+            }
+        }
+    }
+
+    std::mutex mu;
+    std::condition_variable cv;
+    std::deque<std::vector<std::string>> batches;
+    bool eof = false;
+    auto encode = [&]() {
+        ::openmldb::codec::RowView view(table_info_->column_desc());
+        std::vector<std::string> cols;
+        while (true) {
+            std::vector<std::string> batch;
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait(lock, [&] { return !batches.empty() || eof; });
+                if (batches.empty()) {
+                    return;
+                }
+                batch = std::move(batches.front());
+                batches.pop_front();
+            }
+            cv.notify_all();
+            // the batches are drained after a failure, so that the reader is never blocked
+            for (const auto& line : batch) {
+                if (failed_.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                auto row = new_row_();
+                if (!row) {
+                    SetError({::openmldb::base::ReturnCode::kError, "fail to create insert row"});
+                    break;
+                }
+                cols.clear();
+                ::openmldb::sdk::SplitLineWithDelimiterForStrings(line, delimiter, &cols, quote);
+                auto schema = row->GetSchema();
+                int cnt = schema->GetColumnCnt();
+                if (cnt != static_cast<int>(cols.size())) {
+                    SetError({::openmldb::base::ReturnCode::kError, "line [" + line + "] mismatch column size"});
+                    break;
+                }
+                std::string::size_type str_len_sum = 0;
+                for (int i = 0; i < cnt; i++) {
+                    if (schema->GetColumnType(i) == hybridse::sdk::kTypeString && cols[i] != null_value) {
+                        str_len_sum += cols[i].length();
+                    }
+                }
+                row->Init(static_cast<int>(str_len_sum));
+                bool ok = true;
+                for (int i = 0; i < cnt && ok; i++) {
+                    ok = ::openmldb::codec::AppendColumnValue(cols[i], schema->GetColumnType(i),
+                                                              schema->IsColumnNotNull(i), null_value, row);
+                }
+                if (!ok) {
+                    SetError({::openmldb::base::ReturnCode::kError,
+                              "line [" + line + "] translate to insert row failed"});
+                    break;
+                }
+                auto status = AddRow(row, view);
+                if (!status.OK()) {
+                    SetError({status.code, "line [" + line + "] " + status.msg});
+                    break;
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < thread_num_; i++) {
+        threads.emplace_back(encode);
+    }
+    std::vector<std::string> batch;
+    batch.reserve(CSV_BATCH_SIZE);
+    auto push = [&]() {
+        std::unique_lock<std::mutex> lock(mu);
+        // bound the lines in memory
+        cv.wait(lock, [&] { return batches.size() < thread_num_ * 2; });
+        batches.push_back(std::move(batch));
+        batch.clear();
+        lock.unlock();
+        cv.notify_all();
+    };
+    while (!failed_.load(std::memory_order_relaxed) && std::getline(file, line)) {
+        batch.push_back(std::move(line));
+        if (batch.size() >= CSV_BATCH_SIZE) {
+            push();
+        }
+    }
+    if (!batch.empty()) {
+        push();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        eof = true;
+    }
+    cv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return Finish();
+}
+
+#ifdef __parquet_enable__
+namespace {
+
+// the values of a parquet column in a batch, the values are spread to their rows with the nulls
+struct ParquetColumn {
+    uint32_t idx;
+    ::openmldb::type::DataType type;
+    const parquet::ColumnDescriptor* descr;
+    // the divisor to convert a timestamp to milliseconds
+    int64_t ts_divisor;
+    std::shared_ptr<parquet::ColumnReader> reader;
+    std::vector<int16_t> def_levels;
+    std::vector<uint8_t> nulls;
+    std::unique_ptr<bool[]> bools;
+    std::vector<int32_t> int32s;
+    std::vector<int64_t> int64s;
+    std::vector<float> floats;
+    std::vector<double> doubles;
+    // they point into the reader and are valid until the next batch
+    std::vector<parquet::ByteArray> bytes;
+};
+
+bool CheckParquetType(::openmldb::type::DataType type, const parquet::ColumnDescriptor* descr) {
+    auto physical_type = descr->physical_type();
+    switch (type) {
+        case ::openmldb::type::kBool:
+            return physical_type == parquet::Type::BOOLEAN;
+        case ::openmldb::type::kSmallInt:
+        case ::openmldb::type::kInt:
+            return physical_type == parquet::Type::INT32;
+        case ::openmldb::type::kBigInt:
+            return physical_type == parquet::Type::INT32 || physical_type == parquet::Type::INT64;
+        case ::openmldb::type::kTimestamp:
+            return physical_type == parquet::Type::INT64;
+        case ::openmldb::type::kDate:
+            return physical_type == parquet::Type::INT32 && descr->logical_type()->is_date();
+        case ::openmldb::type::kFloat:
+            return physical_type == parquet::Type::FLOAT;
+        case ::openmldb::type::kDouble:
+            return physical_type == parquet::Type::FLOAT || physical_type == parquet::Type::DOUBLE;
+        case ::openmldb::type::kVarchar:
+        case ::openmldb::type::kString:
+            return physical_type == parquet::Type::BYTE_ARRAY;
+        default:
+            return false;
+    }
+}
+
+int64_t GetTsDivisor(const parquet::ColumnDescriptor* descr) {
+    auto logical_type = descr->logical_type();
+    if (!logical_type->is_timestamp()) {
+        return 1;
+    }
+    switch (static_cast<const parquet::TimestampLogicalType&>(*logical_type).time_unit()) {
+        case parquet::LogicalType::TimeUnit::MICROS:
+            return 1000;
+        case parquet::LogicalType::TimeUnit::NANOS:
+            return 1000000;
+        default:
+            return 1;
+    }
+}
+
+template <typename Reader, typename T>
+int64_t ReadBatch(ParquetColumn* column, int64_t batch_size, T* values) {
+    int16_t max_def_level = column->descr->max_definition_level();
+    column->def_levels.assign(batch_size, 0);
+    int64_t values_read = 0;
+    int64_t levels_read = static_cast<Reader*>(column->reader.get())
+                              ->ReadBatch(batch_size, max_def_level > 0 ? column->def_levels.data() : nullptr,
+                                          nullptr, values, &values_read);
+    column->nulls.assign(levels_read, 0);
+    if (max_def_level > 0) {
+        // the values are dense, move them backwards to their rows
+        for (int64_t i = levels_read - 1, j = values_read - 1; i >= 0; i--) {
+            if (column->def_levels[i] < max_def_level) {
+                column->nulls[i] = 1;
+            } else {
+                values[i] = values[j--];
+            }
+        }
+    }
+    return levels_read;
+}
+
+int64_t ReadBatch(ParquetColumn* column, int64_t batch_size) {
+    switch (column->descr->physical_type()) {
+        case parquet::Type::BOOLEAN:
+            column->bools.reset(new bool[batch_size]);
+            return ReadBatch<parquet::BoolReader>(column, batch_size, column->bools.get());
+        case parquet::Type::INT32:
+            column->int32s.resize(batch_size);
+            return ReadBatch<parquet::Int32Reader>(column, batch_size, column->int32s.data());
+        case parquet::Type::INT64:
+            column->int64s.resize(batch_size);
+            return ReadBatch<parquet::Int64Reader>(column, batch_size, column->int64s.data());
+        case parquet::Type::FLOAT:
+            column->floats.resize(batch_size);
+            return ReadBatch<parquet::FloatReader>(column, batch_size, column->floats.data());
+        case parquet::Type::DOUBLE:
+            column->doubles.resize(batch_size);
+            return ReadBatch<parquet::DoubleReader>(column, batch_size, column->doubles.data());
+        case parquet::Type::BYTE_ARRAY:
+            column->bytes.resize(batch_size);
+            return ReadBatch<parquet::ByteArrayReader>(column, batch_size, column->bytes.data());
+        default:
+            return -1;
+    }
+}
+
+bool AppendParquetValue(const ParquetColumn& column, int64_t i, SQLInsertRow* row) {
+    if (column.nulls[i]) {
+        return row->AppendNULL();
+    }
+    auto physical_type = column.descr->physical_type();
+    switch (column.type) {
+        case ::openmldb::type::kBool:
+            return row->AppendBool(column.bools[i]);
+        case ::openmldb::type::kSmallInt:
+            return row->AppendInt16(static_cast<int16_t>(column.int32s[i]));
+        case ::openmldb::type::kInt:
+            return row->AppendInt32(column.int32s[i]);
+        case ::openmldb::type::kBigInt:
+            return row->AppendInt64(physical_type == parquet::Type::INT32 ? column.int32s[i] : column.int64s[i]);
+        case ::openmldb::type::kTimestamp:
+            return row->AppendTimestamp(column.int64s[i] / column.ts_divisor);
+        case ::openmldb::type::kDate: {
+            absl::CivilDay day = absl::CivilDay(1970, 1, 1) + column.int32s[i];
+            return row->AppendDate(static_cast<uint32_t>(day.year()), day.month(), day.day());
+        }
+        case ::openmldb::type::kFloat:
+            return row->AppendFloat(column.floats[i]);
+        case ::openmldb::type::kDouble:
+            return row->AppendDouble(physical_type == parquet::Type::FLOAT ? column.floats[i] : column.doubles[i]);
+        case ::openmldb::type::kVarchar:
+        case ::openmldb::type::kString:
+            return row->AppendString(reinterpret_cast<const char*>(column.bytes[i].ptr), column.bytes[i].len);
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+#endif
+
+::openmldb::base::Status BulkLoader::LoadParquet(const std::string& file_path) {
+#ifdef __parquet_enable__
+    static constexpr int64_t PARQUET_BATCH_SIZE = 1024;
+    if (!base::IsExists(file_path)) {
+        return {::openmldb::base::ReturnCode::kError, "file not exist"};
+    }
+    std::unique_ptr<parquet::ParquetFileReader> reader;
+    try {
+        reader = parquet::ParquetFileReader::OpenFile(file_path, false);
+    } catch (const std::exception& e) {
+        return {::openmldb::base::ReturnCode::kError, "open parquet file failed, " + std::string(e.what())};
+    }
+    auto status = Init();
+    if (!status.OK()) {
+        return status;
+    }
+    // table column -> parquet column
+    const auto* parquet_schema = reader->metadata()->schema();
+    std::vector<int> column_map;
+    for (const auto& column : table_info_->column_desc()) {
+        int pos = parquet_schema->ColumnIndex(column.name());
+        if (pos < 0) {
+            return {::openmldb::base::ReturnCode::kError, "column " + column.name() + " is not in the file"};
+        }
+        if (!CheckParquetType(column.data_type(), parquet_schema->Column(pos))) {
+            return {::openmldb::base::ReturnCode::kError, "mismatch type of column " + column.name()};
+        }
+        column_map.push_back(pos);
+    }
+    int num_row_groups = reader->metadata()->num_row_groups();
+    reader.reset();
+
+    // every worker reads its row groups with its own reader
+    auto load = [&](uint32_t worker) {
+        try {
+            auto reader = parquet::ParquetFileReader::OpenFile(file_path, false);
+            ::openmldb::codec::RowView view(table_info_->column_desc());
+            const auto& columns = table_info_->column_desc();
+            for (int rg = worker; rg < num_row_groups; rg += thread_num_) {
+                auto row_group = reader->RowGroup(rg);
+                std::vector<ParquetColumn> batch(columns.size());
+                for (int i = 0; i < columns.size(); i++) {
+                    batch[i].idx = i;
+                    batch[i].type = columns.Get(i).data_type();
+                    batch[i].descr = reader->metadata()->schema()->Column(column_map[i]);
+                    batch[i].ts_divisor = GetTsDivisor(batch[i].descr);
+                    batch[i].reader = row_group->Column(column_map[i]);
+                }
+                while (!failed_.load(std::memory_order_relaxed) && batch[0].reader->HasNext()) {
+                    int64_t rows = -1;
+                    for (auto& column : batch) {
+                        int64_t read = ReadBatch(&column, PARQUET_BATCH_SIZE);
+                        if (read < 0 || (rows >= 0 && read != rows)) {
+                            SetError({::openmldb::base::ReturnCode::kError, "mismatch rows of parquet columns"});
+                            return;
+                        }
+                        rows = read;
+                    }
+                    for (int64_t r = 0; r < rows; r++) {
+                        auto row = new_row_();
+                        if (!row) {
+                            SetError({::openmldb::base::ReturnCode::kError, "fail to create insert row"});
+                            return;
+                        }
+                        uint32_t str_len_sum = 0;
+                        for (const auto& column : batch) {
+                            if (column.descr->physical_type() == parquet::Type::BYTE_ARRAY && !column.nulls[r]) {
+                                str_len_sum += column.bytes[r].len;
+                            }
+                        }
+                        row->Init(static_cast<int>(str_len_sum));
+                        for (const auto& column : batch) {
+                            if (!AppendParquetValue(column, r, row.get())) {
+                                SetError({::openmldb::base::ReturnCode::kError,
+                                          "translate column " + columns.Get(column.idx).name() + " of row group " +
+                                              std::to_string(rg) + " failed"});
+                                return;
+                            }
+                        }
+                        auto status = AddRow(row, view);
+                        if (!status.OK()) {
+                            SetError(status);
+                            return;
+                        }
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            SetError({::openmldb::base::ReturnCode::kError, "read parquet file failed, " + std::string(e.what())});
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < std::min<uint32_t>(thread_num_, std::max(num_row_groups, 1)); i++) {
+        threads.emplace_back(load, i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return Finish();
+#else
+    return {::openmldb::base::ReturnCode::kError, "parquet is not supported, build with PARQUET_ENABLE=ON"};
+#endif
+}
+
+}  // namespace sdk
+}  // namespace openmldb
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_SDK_BULK_LOADER_H_
+#define SRC_SDK_BULK_LOADER_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/status.h"
+#include "butil/iobuf.h"
+#include "client/tablet_client.h"
+#include "codec/codec.h"
+#include "proto/name_server.pb.h"
+#include "proto/tablet.pb.h"
+#include "sdk/sql_insert_row.h"
+
+namespace openmldb {
+namespace sdk {
+
+// The index region of a segment. The keys are kept in descending order and the times of a key entry in
+// ascending order, so that every insert of MemTable::BulkLoad lands on the head of the skiplists.
+// The order only holds over the whole load, so the region keeps every key and time in memory until it is built,
+// about the key size plus 12 bytes per row and ts column
+class SegmentIndexRegion {
+ public:
+    SegmentIndexRegion(uint32_t ts_cnt, const std::map<uint32_t, uint32_t>& ts_idx_map);
+
+    // put a block into the key entries of its ts columns like storage::Segment::Put, `ts_map` is
+    // ts column id -> ts
+    bool Put(const std::string& key, const std::map<uint32_t, uint64_t>& ts_map, uint32_t block_id);
+
+    // build the entries into `segment` until `size` reaches `size_limit`, at least one entry is built.
+    // Returns true if all entries are built. No more entries can be put after it is called
+    bool BuildPartial(uint32_t seg_id, uint64_t size_limit, uint64_t* size, ::openmldb::api::Segment* segment);
+
+    bool IsCompleted() const { return started_ && key_it_ == entries_.end(); }
+    bool Empty() const { return entries_.empty(); }
+
+ private:
+    // time -> block id of every ts column of a key
+    using KeyEntries = std::vector<std::vector<std::pair<uint64_t, uint32_t>>>;
+
+    const uint32_t ts_cnt_;
+    const std::map<uint32_t, uint32_t> ts_idx_map_;
+    std::map<std::string, KeyEntries, std::greater<std::string>> entries_;
+    bool started_;
+    std::map<std::string, KeyEntries, std::greater<std::string>>::iterator key_it_;
+    uint32_t key_entry_idx_;
+    uint32_t time_idx_;
+};
+
+// Builds and sends the bulk load requests of a partition. The data region is sent whenever it reaches
+// the rpc size limit, and the index region is sent after all the data. The memory of the index region grows
+// with the rows of the partition until Finish, a large file should be split into several loads
+class BulkLoadPartition {
+ public:
+    BulkLoadPartition(uint32_t tid, uint32_t pid, std::shared_ptr<::openmldb::client::TabletClient> client,
+                      uint64_t rpc_size_limit);
+
+    ::openmldb::base::Status Init();
+
+    const ::openmldb::api::BulkLoadInfoResponse& GetInfo() const { return info_; }
+
+    // add an encoded row, `ts_map` holds the ts column values decoded from the row
+    ::openmldb::base::Status AddRow(const std::string& row,
+                                    const std::vector<std::pair<std::string, uint32_t>>& dimensions,
+                                    const std::map<uint32_t, uint64_t>& ts_map, uint64_t time);
+
+    // send the rest data region and then the index region
+    ::openmldb::base::Status Finish();
+
+    uint64_t GetRowCnt() const { return next_block_id_; }
+
+ private:
+    ::openmldb::base::Status SendData();
+    ::openmldb::base::Status SendIndex();
+
+    const uint32_t tid_;
+    const uint32_t pid_;
+    std::shared_ptr<::openmldb::client::TabletClient> client_;
+    const uint64_t rpc_size_limit_;
+    ::openmldb::api::BulkLoadInfoResponse info_;
+    // index region of inner index -> segment
+    std::vector<std::vector<SegmentIndexRegion>> regions_;
+    std::mutex mu_;
+    int32_t part_id_;
+    uint32_t next_block_id_;
+    uint64_t data_offset_;
+    ::openmldb::api::BulkLoadRequest data_request_;
+    butil::IOBuf data_;
+    uint64_t data_size_;
+};
+
+// Loads a file into a memory table through the bulk load rpc of tablets, bypassing the row by row put path.
+// The rows are encoded in parallel and routed to the partitions, every partition streams its data
+// to the leader as soon as an rpc worth of rows is encoded
+class BulkLoader {
+ public:
+    using RowFactory = std::function<std::shared_ptr<SQLInsertRow>()>;
+
+    BulkLoader(std::shared_ptr<::openmldb::nameserver::TableInfo> table_info,
+               std::vector<std::shared_ptr<::openmldb::client::TabletClient>> clients, RowFactory new_row,
+               uint32_t thread_num, uint64_t rpc_size_limit);
+
+    ::openmldb::base::Status LoadCsv(const std::string& file_path, const std::string& delimiter, char quote,
+                                     bool header, const std::string& null_value);
+
+    // the columns are matched by name, it needs the build option PARQUET_ENABLE
+    ::openmldb::base::Status LoadParquet(const std::string& file_path);
+
+    uint64_t GetRowCnt() const { return row_cnt_.load(std::memory_order_relaxed); }
+
+ private:
+    ::openmldb::base::Status Init();
+    ::openmldb::base::Status AddRow(const std::shared_ptr<SQLInsertRow>& row, const ::openmldb::codec::RowView& view);
+    ::openmldb::base::Status Finish();
+    void SetError(const ::openmldb::base::Status& status);
+    ::openmldb::base::Status GetError();
+
+    std::shared_ptr<::openmldb::nameserver::TableInfo> table_info_;
+    std::vector<std::shared_ptr<::openmldb::client::TabletClient>> clients_;
+    RowFactory new_row_;
+    const uint32_t thread_num_;
+    const uint64_t rpc_size_limit_;
+    std::vector<std::unique_ptr<BulkLoadPartition>> partitions_;
+    // the ts columns of all indexes, col id -> type
+    std::map<uint32_t, ::openmldb::type::DataType> ts_cols_;
+    std::atomic<uint64_t> row_cnt_;
+    std::atomic<bool> failed_;
+    std::mutex mu_;
+    ::openmldb::base::Status error_;
+};
+
+}  // namespace sdk
+}  // namespace openmldb
+#endif  // SRC_SDK_BULK_LOADER_H_
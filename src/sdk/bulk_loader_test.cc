@@ -0,0 +1,229 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/bulk_loader.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+#include "sdk/mini_cluster.h"
+#include "sdk/sql_router.h"
+#include "test/util.h"
+#include "vm/engine.h"
+
+namespace openmldb {
+namespace sdk {
+
+::openmldb::sdk::MiniCluster* mc_;
+
+class BulkLoaderTest : public ::testing::Test {
+ public:
+    BulkLoaderTest() {}
+    ~BulkLoaderTest() {}
+};
+
+TEST_F(BulkLoaderTest, SingleTs) {
+    SegmentIndexRegion region(1, {{2, 0}});
+    ASSERT_TRUE(region.Empty());
+    ASSERT_TRUE(region.Put("key1", {{2, 30}}, 0));
+    ASSERT_TRUE(region.Put("key2", {{2, 20}}, 1));
+    ASSERT_TRUE(region.Put("key1", {{2, 10}}, 2));
+    // the ts column is not in the region
+    ASSERT_FALSE(region.Put("key3", {{3, 10}}, 3));
+    ASSERT_FALSE(region.Empty());
+
+    ::openmldb::api::Segment segment;
+    uint64_t size = 0;
+    ASSERT_TRUE(region.BuildPartial(5, UINT64_MAX, &size, &segment));
+    ASSERT_TRUE(region.IsCompleted());
+    ASSERT_GT(size, 0u);
+    ASSERT_EQ(5u, segment.id());
+    // keys are in descending order and times in ascending order
+    ASSERT_EQ(2, segment.key_entries_size());
+    ASSERT_EQ("key2", segment.key_entries(0).key());
+    ASSERT_EQ("key1", segment.key_entries(1).key());
+    const auto& key_entry = segment.key_entries(1).key_entry(0);
+    ASSERT_EQ(0u, key_entry.key_entry_id());
+    ASSERT_EQ(2, key_entry.time_entry_size());
+    ASSERT_EQ(10u, key_entry.time_entry(0).time());
+    ASSERT_EQ(2u, key_entry.time_entry(0).block_id());
+    ASSERT_EQ(30u, key_entry.time_entry(1).time());
+    ASSERT_EQ(0u, key_entry.time_entry(1).block_id());
+    // no more entries after it is built
+    ASSERT_FALSE(region.Put("key4", {{2, 10}}, 4));
+}
+
+TEST_F(BulkLoaderTest, MultiTs) {
+    SegmentIndexRegion region(2, {{1, 0}, {UINT32_MAX, 1}});
+    ASSERT_TRUE(region.Put("key1", {{1, 100}, {UINT32_MAX, 1000}}, 0));
+    ASSERT_TRUE(region.Put("key1", {{UINT32_MAX, 900}}, 1));
+
+    ::openmldb::api::Segment segment;
+    uint64_t size = 0;
+    ASSERT_TRUE(region.BuildPartial(0, UINT64_MAX, &size, &segment));
+    ASSERT_EQ(1, segment.key_entries_size());
+    const auto& key_entries = segment.key_entries(0);
+    ASSERT_EQ(2, key_entries.key_entry_size());
+    ASSERT_EQ(0u, key_entries.key_entry(0).key_entry_id());
+    ASSERT_EQ(1, key_entries.key_entry(0).time_entry_size());
+    ASSERT_EQ(100u, key_entries.key_entry(0).time_entry(0).time());
+    ASSERT_EQ(1u, key_entries.key_entry(1).key_entry_id());
+    ASSERT_EQ(2, key_entries.key_entry(1).time_entry_size());
+    ASSERT_EQ(900u, key_entries.key_entry(1).time_entry(0).time());
+    ASSERT_EQ(1u, key_entries.key_entry(1).time_entry(0).block_id());
+    ASSERT_EQ(1000u, key_entries.key_entry(1).time_entry(1).time());
+}
+
+TEST_F(BulkLoaderTest, BuildPartial) {
+    SegmentIndexRegion region(1, {{0, 0}});
+    std::map<std::string, uint32_t> expect;
+    for (uint32_t i = 0; i < 100; i++) {
+        std::string key = "key" + std::to_string(i % 10);
+        ASSERT_TRUE(region.Put(key, {{0, i}}, i));
+        expect[key]++;
+    }
+    // at least one entry is built even if the limit is too small
+    std::map<std::string, uint32_t> built;
+    uint32_t parts = 0;
+    bool completed = false;
+    while (!completed) {
+        ::openmldb::api::Segment segment;
+        uint64_t size = 0;
+        completed = region.BuildPartial(0, 1, &size, &segment);
+        ASSERT_EQ(1, segment.key_entries_size());
+        ASSERT_EQ(1, segment.key_entries(0).key_entry_size());
+        ASSERT_EQ(1, segment.key_entries(0).key_entry(0).time_entry_size());
+        built[segment.key_entries(0).key()]++;
+        parts++;
+    }
+    ASSERT_TRUE(region.IsCompleted());
+    ASSERT_EQ(100u, parts);
+    ASSERT_EQ(expect, built);
+
+    SegmentIndexRegion other(1, {{0, 0}});
+    for (uint32_t i = 0; i < 100; i++) {
+        ASSERT_TRUE(other.Put("key" + std::to_string(i % 10), {{0, i}}, i));
+    }
+    parts = 0;
+    uint32_t time_entries = 0;
+    completed = false;
+    while (!completed) {
+        ::openmldb::api::Segment segment;
+        uint64_t size = 0;
+        completed = other.BuildPartial(0, 400, &size, &segment);
+        for (const auto& key_entries : segment.key_entries()) {
+            ASSERT_GT(key_entries.key_entry_size(), 0);
+            for (const auto& key_entry : key_entries.key_entry()) {
+                ASSERT_GT(key_entry.time_entry_size(), 0);
+                time_entries += key_entry.time_entry_size();
+            }
+        }
+        parts++;
+    }
+    ASSERT_GT(parts, 1u);
+    ASSERT_LT(parts, 100u);
+    ASSERT_EQ(100u, time_entries);
+}
+
+TEST_F(BulkLoaderTest, LoadDataInfile) {
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    ::hybridse::sdk::Status status;
+    router->ExecuteSQL("SET @@execute_mode='online';", &status);
+    std::string db = "db" + ::openmldb::test::GenRand();
+    std::string name = "t" + ::openmldb::test::GenRand();
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    // the two indexes on c1 share a multi-ts segment
+    std::string ddl = "create table " + name +
+                      "(c1 string, c2 int, c3 bigint, c4 timestamp, "
+                      "index(key=c1, ts=c3), index(key=c1, ts=c4), index(key=c2, ts=c3)) "
+                      "options(partitionnum=2, replicanum=1);";
+    ASSERT_TRUE(router->ExecuteDDL(db, ddl, &status)) << status.msg;
+    ASSERT_TRUE(router->RefreshCatalog());
+
+    std::string file_path = "/tmp/bulk_load_" + ::openmldb::test::GenRand() + ".csv";
+    {
+        std::ofstream file(file_path);
+        file << "c1,c2,c3,c4\n";
+        for (int i = 0; i < 200; i++) {
+            file << "key" << i % 10 << "," << i % 7 << "," << 1000 + i << "," << 5000 + i << "\n";
+        }
+    }
+    router->ExecuteSQL(db,
+                       "LOAD DATA INFILE '" + file_path + "' INTO TABLE " + name +
+                           " OPTIONS(load_mode='bulk_load', mode='append', thread=2);",
+                       &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+
+    auto rs = router->ExecuteSQL(db, "select * from " + name + ";", &status);
+    ASSERT_TRUE(rs != nullptr) << status.msg;
+    ASSERT_EQ(200, rs->Size());
+    rs = router->ExecuteSQL(db, "select c1, c3 from " + name + " where c1 = 'key3';", &status);
+    ASSERT_TRUE(rs != nullptr) << status.msg;
+    ASSERT_EQ(20, rs->Size());
+    rs = router->ExecuteSQL(db, "select c2, c3 from " + name + " where c2 = 3;", &status);
+    ASSERT_TRUE(rs != nullptr) << status.msg;
+    ASSERT_EQ(29, rs->Size());
+
+    // the windows read the two time lists of the multi-ts segment
+    std::string sql = "select c1, count(c2) over w1 as cnt1, count(c2) over w2 as cnt2 from " + name +
+                      " window w1 as (partition by c1 order by c3 rows_range between 1000 preceding and current row),"
+                      " w2 as (partition by c1 order by c4 rows_range between 100 preceding and current row);";
+    auto row = router->GetRequestRow(db, sql, &status);
+    ASSERT_TRUE(row != nullptr) << status.msg;
+    ASSERT_TRUE(row->Init(4));
+    ASSERT_TRUE(row->AppendString("key3"));
+    ASSERT_TRUE(row->AppendInt32(0));
+    ASSERT_TRUE(row->AppendInt64(1200));
+    ASSERT_TRUE(row->AppendTimestamp(5200));
+    ASSERT_TRUE(row->Build());
+    rs = router->ExecuteSQLRequest(db, sql, row, &status);
+    ASSERT_TRUE(rs != nullptr) << status.msg;
+    ASSERT_EQ(1, rs->Size());
+    ASSERT_TRUE(rs->Next());
+    // all 20 rows of key3 and the request row
+    ASSERT_EQ(21, rs->GetInt64Unsafe(1));
+    // the rows of key3 with c4 in [5100, 5200] and the request row
+    ASSERT_EQ(11, rs->GetInt64Unsafe(2));
+
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop table " + name + ";", &status));
+    ASSERT_TRUE(router->DropDB(db, &status));
+    remove(file_path.c_str());
+}
+
+}  // namespace sdk
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::hybridse::vm::Engine::InitializeGlobalLLVM();
+    FLAGS_zk_session_timeout = 100000;
+    ::openmldb::sdk::MiniCluster mc(6181);
+    ::openmldb::sdk::mc_ = &mc;
+    int ok = ::openmldb::sdk::mc_->SetUp(2);
+    sleep(5);
+    ::testing::InitGoogleTest(&argc, argv);
+    srand(time(NULL));
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    ok = RUN_ALL_TESTS();
+    ::openmldb::sdk::mc_->Close();
+    return ok;
+}
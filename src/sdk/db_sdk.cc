@@ -24,11 +24,11 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
-#include "base/hash.h"
 #include "base/strings.h"
 #include "glog/logging.h"
 
@@ -63,6 +63,65 @@ void ClusterSDK::CheckZk() {
     pool_.DelayTask(2000, [this] { CheckZk(); });
 }
 
+void ClusterSDK::RefreshHotKey() {
+    std::set<std::string> endpoints;
+    {
+        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
+        for (const auto& db_kv : table_to_tablets_) {
+            for (const auto& table_kv : db_kv.second) {
+                for (const auto& partition : table_kv.second->table_partition()) {
+                    for (const auto& meta : partition.partition_meta()) {
+                        endpoints.insert(meta.endpoint());
+                    }
+                }
+            }
+        }
+    }
+    std::map<std::pair<uint32_t, uint32_t>, uint64_t> leader_offsets;
+    std::map<std::pair<uint32_t, uint32_t>, std::vector<std::pair<std::string, uint64_t>>> follower_offsets;
+    auto hot_partitions = std::make_shared<HotPartitions>();
+    for (const auto& endpoint : endpoints) {
+        auto tablet = client_manager_->GetTablet(endpoint);
+        if (!tablet) {
+            continue;
+        }
+        ::openmldb::api::GetTableStatusResponse response;
+        if (!tablet->GetClient()->GetTableStatus(true, response)) {
+            continue;
+        }
+        for (const auto& status : response.all_table_status()) {
+            auto key = std::make_pair(status.tid(), status.pid());
+            if (status.mode() == ::openmldb::api::TableMode::kTableLeader) {
+                leader_offsets[key] = status.offset();
+            } else {
+                follower_offsets[key].emplace_back(endpoint, status.offset());
+            }
+            // the followers report the keys they serve too, so that a key stays hot once it is spread out
+            for (const auto& hot_key : status.hot_key()) {
+                (*hot_partitions)[key].keys.insert(hot_key.key());
+            }
+        }
+    }
+    for (auto it = hot_partitions->begin(); it != hot_partitions->end();) {
+        auto leader_it = leader_offsets.find(it->first);
+        auto follower_it = follower_offsets.find(it->first);
+        if (leader_it != leader_offsets.end() && follower_it != follower_offsets.end()) {
+            for (const auto& kv : follower_it->second) {
+                if (kv.second + options_.hot_key_max_offset_lag >= leader_it->second) {
+                    it->second.followers.push_back(kv.first);
+                }
+            }
+        }
+        if (it->second.followers.empty()) {
+            it = hot_partitions->erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::atomic_store_explicit(&hot_partitions_, hot_partitions, std::memory_order_release);
+    pool_.DelayTask(options_.hot_key_refresh_interval, [this] { RefreshHotKey(); });
+}
+
 bool ClusterSDK::Init() {
     zk_client_ = new ::openmldb::zk::ZkClient(options_.zk_cluster, "", options_.session_timeout, "", options_.zk_path);
     bool ok = zk_client_->Init();
@@ -82,6 +141,9 @@ bool ClusterSDK::Init() {
     ok = BuildCatalog();
     if (!ok) return false;
     CheckZk();
+    if (options_.hot_key_refresh_interval > 0) {
+        pool_.DelayTask(options_.hot_key_refresh_interval, [this] { RefreshHotKey(); });
+    }
     return true;
 }
 
@@ -400,10 +462,21 @@ std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetTablet(const std:
     if (table_handler) {
         auto sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
         if (sdk_table_handler) {
-            uint32_t pid_num = sdk_table_handler->GetPartitionNum();
-            uint32_t pid = 0;
-            if (pid_num > 0) {
-                pid = ::openmldb::base::hash64(pk) % pid_num;
+            uint32_t pid = sdk_table_handler->GetPid(pk);
+            auto hot_partitions = std::atomic_load_explicit(&hot_partitions_, std::memory_order_acquire);
+            if (hot_partitions) {
+                auto it = hot_partitions->find({sdk_table_handler->GetTid(), pid});
+                if (it != hot_partitions->end() && it->second.keys.count(pk) > 0) {
+                    // spread the reads of a hot key over the leader and the fresh followers
+                    const auto& followers = it->second.followers;
+                    uint32_t idx = rand_.Uniform(followers.size() + 1);
+                    if (idx < followers.size()) {
+                        auto tablet = client_manager_->GetTablet(followers[idx]);
+                        if (tablet) {
+                            return tablet;
+                        }
+                    }
+                }
             }
             return sdk_table_handler->GetTablet(pid);
         }
@@ -411,6 +484,21 @@ std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetTablet(const std:
     return {};
 }
 
+std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetReplica(const std::string& db, const std::string& name,
+                                                                       const std::string* pk, uint32_t* tid,
+                                                                       uint32_t* pid) {
+    auto table_handler = GetCatalog()->GetTable(db, name);
+    if (table_handler) {
+        auto sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
+        if (sdk_table_handler && sdk_table_handler->GetPartitionNum() > 0) {
+            *tid = sdk_table_handler->GetTid();
+            *pid = pk != nullptr ? sdk_table_handler->GetPid(*pk) : rand_.Uniform(sdk_table_handler->GetPartitionNum());
+            return sdk_table_handler->GetReplica(*pid);
+        }
+    }
+    return {};
+}
+
 std::shared_ptr<hybridse::sdk::ProcedureInfo> DBSDK::GetProcedureInfo(const std::string& db, const std::string& sp_name,
                                                                       std::string* msg) {
     if (msg == nullptr) {
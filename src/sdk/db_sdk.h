@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -41,8 +42,19 @@ struct ClusterOptions {
     std::string zk_cluster;
     std::string zk_path;
     int32_t session_timeout = 2000;
+    // the interval in ms of pulling the hot keys from the tablets, 0 disables the hot key routing
+    uint32_t hot_key_refresh_interval = 0;
+    // a follower serves the hot keys only if it lags behind the leader by at most this many offsets
+    uint64_t hot_key_max_offset_lag = 1000;
 };
 
+// the hot keys of a partition and the followers which are allowed to serve them
+struct HotPartition {
+    std::set<std::string> keys;
+    std::vector<std::string> followers;
+};
+using HotPartitions = std::map<std::pair<uint32_t, uint32_t>, HotPartition>;
+
 class DBSDK {
  public:
     virtual ~DBSDK() { delete engine_; }
@@ -118,6 +130,11 @@ class DBSDK {
                                                                    uint32_t pid);
     std::shared_ptr<::openmldb::catalog::TabletAccessor> GetTablet(const std::string& db, const std::string& name,
                                                                    const std::string& pk);
+    // a replica of the partition of `pk` or of a random partition if `pk` is null, the partition is
+    // returned in `tid` and `pid`
+    std::shared_ptr<::openmldb::catalog::TabletAccessor> GetReplica(const std::string& db, const std::string& name,
+                                                                    const std::string* pk, uint32_t* tid,
+                                                                    uint32_t* pid);
 
     std::shared_ptr<hybridse::sdk::ProcedureInfo> GetProcedureInfo(const std::string& db, const std::string& sp_name,
                                                                    std::string* msg);
@@ -144,6 +161,8 @@ class DBSDK {
     std::map<std::string, std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>> table_to_tablets_;
 
     ::hybridse::vm::Engine* engine_ = nullptr;
+    // keyed by tid and pid, replaced as a whole on each refresh
+    std::shared_ptr<HotPartitions> hot_partitions_;
 
  private:
     // get/set op should be atomic(actually no reset now)
@@ -176,6 +195,7 @@ class ClusterSDK : public DBSDK {
     bool InitTabletClient();
     void WatchNotify();
     void CheckZk();
+    void RefreshHotKey();
 
  private:
     ClusterOptions options_;
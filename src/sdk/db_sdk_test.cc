@@ -19,6 +19,7 @@
 #include <unistd.h>
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -54,7 +55,7 @@ class DBSDKTest : public ::testing::Test {
     }
     void TearDown() override { mc_->Close(); }
 
-    void CreateTable() {
+    void CreateTable(uint32_t replica_num = 0) {
         table_name_ = "test" + GenRand();
         db_name_ = "db" + GenRand();
         auto ns_client = mc_->GetNsClient();
@@ -66,6 +67,9 @@ class DBSDKTest : public ::testing::Test {
         table_info.set_format_version(1);
         table_info.set_db(db_name_);
         table_info.set_name(table_name_);
+        if (replica_num > 0) {
+            table_info.set_replica_num(replica_num);
+        }
         SchemaCodec::SetColumnDesc(table_info.add_column_desc(), "col1", ::openmldb::type::kString);
         SchemaCodec::SetColumnDesc(table_info.add_column_desc(), "col2", ::openmldb::type::kBigInt);
         SchemaCodec::SetIndex(table_info.add_column_key(), "index0", "col1", "col2", ::openmldb::type::kAbsoluteTime, 0,
@@ -112,6 +116,59 @@ TEST_F(DBSDKTest, smokeTest) {
     ASSERT_TRUE(sdk.Refresh());
 }
 
+TEST_F(DBSDKTest, getReplica) {
+    ClusterOptions option;
+    option.zk_cluster = mc_->GetZkCluster();
+    option.zk_path = mc_->GetZkPath();
+    ClusterSDK sdk(option);
+    ASSERT_TRUE(sdk.Init());
+
+    // a replica on each of the two tablets
+    CreateTable(2);
+    sleep(5);  // let sdk find the new table
+
+    uint32_t tid = 0;
+    uint32_t pid = 0;
+    ASSERT_FALSE(sdk.GetReplica(db_name_, "not_exist", nullptr, &tid, &pid));
+    uint32_t table_tid = sdk.GetTableId(db_name_, table_name_);
+    auto table_ptr = sdk.GetTableInfo(db_name_, table_name_);
+    ASSERT_TRUE(table_ptr);
+    // the replica is picked from the partition of the key, among the leader and the followers
+    std::string key = "key1";
+    std::set<std::string> endpoints;
+    std::set<uint32_t> pids;
+    for (int i = 0; i < 100; i++) {
+        auto replica = sdk.GetReplica(db_name_, table_name_, &key, &tid, &pid);
+        ASSERT_TRUE(replica);
+        ASSERT_EQ(table_tid, tid);
+        endpoints.insert(replica->GetName());
+        pids.insert(pid);
+    }
+    ASSERT_EQ(1u, pids.size());
+    ASSERT_EQ(2u, endpoints.size());
+    pid = *pids.begin();
+    auto leader = sdk.GetTablet(db_name_, table_name_, pid);
+    ASSERT_TRUE(leader);
+    ASSERT_EQ(1u, endpoints.count(leader->GetName()));
+    for (const auto& partition : table_ptr->table_partition()) {
+        if (partition.pid() != pid) {
+            continue;
+        }
+        for (const auto& meta : partition.partition_meta()) {
+            ASSERT_EQ(1u, endpoints.count(meta.endpoint()));
+            ASSERT_EQ(meta.is_leader(), meta.endpoint() == leader->GetName());
+        }
+    }
+    // without a key, any partition may be picked
+    pids.clear();
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(sdk.GetReplica(db_name_, table_name_, nullptr, &tid, &pid));
+        ASSERT_LT(pid, static_cast<uint32_t>(table_ptr->table_partition_size()));
+        pids.insert(pid);
+    }
+    ASSERT_LT(1u, pids.size());
+}
+
 // TODO(hw): StandAlone sdk can access cluster, but it's not a good test. Better to access StandAlone server.
 TEST_F(DBSDKTest, standAloneMode) {
     // mini cluster endpoints' ports are random, so we get the ns address first
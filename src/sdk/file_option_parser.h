@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -70,6 +71,7 @@ class FileOptionsParser {
              std::pair<std::function<bool(const hybridse::node::ConstNode* node)>, hybridse::node::DataType>>
         check_map_;
     char quote_;
+    std::set<std::string> formats_ = {"csv"};
 
  private:
     // default options
@@ -98,10 +100,7 @@ class FileOptionsParser {
     std::function<bool(const hybridse::node::ConstNode* node)> CheckFormat() {
         return [this](const hybridse::node::ConstNode* node) {
             format_ = node->GetAsString();
-            if (format_ != "csv") {
-                return false;
-            }
-            return true;
+            return formats_.count(format_) > 0;
         };
     }
     std::function<bool(const hybridse::node::ConstNode* node)> CheckDelimiter() {
@@ -145,7 +144,40 @@ class FileOptionsParser {
 
 class ReadFileOptionsParser : public FileOptionsParser {
  public:
-    ReadFileOptionsParser() { quote_ = '\0'; }
+    ReadFileOptionsParser() {
+        quote_ = '\0';
+        formats_.insert("parquet");
+        check_map_.emplace("load_mode", std::make_pair(CheckLoadMode(), hybridse::node::kVarchar));
+        check_map_.emplace("thread", std::make_pair(CheckThread(), hybridse::node::kInt32));
+    }
+    const std::string& GetLoadMode() const { return load_mode_; }
+    // 0 means the number of cores
+    uint32_t GetThread() const { return thread_; }
+
+ private:
+    // 'insert' puts the rows one by one, 'bulk_load' builds the segments on the client and sends them in batches
+    std::string load_mode_ = "insert";
+    uint32_t thread_ = 0;
+    std::function<bool(const hybridse::node::ConstNode* node)> CheckLoadMode() {
+        return [this](const hybridse::node::ConstNode* node) {
+            load_mode_ = node->GetAsString();
+            boost::to_lower(load_mode_);
+            if (load_mode_ != "insert" && load_mode_ != "bulk_load") {
+                return false;
+            }
+            return true;
+        };
+    }
+    std::function<bool(const hybridse::node::ConstNode* node)> CheckThread() {
+        return [this](const hybridse::node::ConstNode* node) {
+            int32_t thread = node->GetInt();
+            if (thread < 0) {
+                return false;
+            }
+            thread_ = thread;
+            return true;
+        };
+    }
 };
 
 class WriteFileOptionsParser : public FileOptionsParser {
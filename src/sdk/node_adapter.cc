@@ -312,6 +312,27 @@ bool NodeAdapter::TransformToColumnKey(hybridse::node::ColumnIndexNode* column_i
             ttl_st->set_lat_ttl(base::LatTTLConvert(column_index->GetLatTTL(), true));
         }
     }
+    if (!column_index->key_encoding().empty()) {
+        std::string key_encoding = column_index->key_encoding();
+        std::transform(key_encoding.begin(), key_encoding.end(), key_encoding.begin(), ::tolower);
+        if (key_encoding == "memcomparable") {
+            index->set_key_encoding(openmldb::type::kMemcomparableKey);
+        } else if (key_encoding != "delimited") {
+            status->msg = "CREATE common: key_encoding " + column_index->key_encoding() + " not support";
+            status->code = hybridse::common::kUnsupportSql;
+            return false;
+        }
+        for (const auto& col : index->col_name()) {
+            auto it = column_names.find(col);
+            if (index->key_encoding() == openmldb::type::kMemcomparableKey && it != column_names.end() &&
+                (it->second->data_type() == openmldb::type::kFloat ||
+                 it->second->data_type() == openmldb::type::kDouble)) {
+                status->msg = "CREATE common: memcomparable key does not support the float column " + col;
+                status->code = hybridse::common::kUnsupportSql;
+                return false;
+            }
+        }
+    }
     if (!column_index->GetTs().empty()) {
         // if no column_names, skip check
         if (!column_names.empty()) {
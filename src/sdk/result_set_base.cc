@@ -16,8 +16,12 @@
 
 #include "sdk/result_set_base.h"
 
+#include <string.h>
+
 #include <utility>
 
+#include "codec/fe_row_codec.h"
+
 namespace openmldb {
 namespace sdk {
 
@@ -30,7 +34,10 @@ ResultSetBase::ResultSetBase(const butil::IOBuf* buf, uint32_t count, uint32_t b
       row_view_(std::move(row_view)),
       schema_(),
       position_(0),
-      index_(-1) {
+      index_(-1),
+      columnar_(false),
+      columns_(),
+      flat_buf_() {
     schema_.SetSchema(schema);
 }
 
@@ -44,6 +51,9 @@ bool ResultSetBase::Reset() {
 
 bool ResultSetBase::Next() {
     index_++;
+    if (columnar_) {
+        return index_ < static_cast<int32_t>(count_);
+    }
     if (index_ < static_cast<int32_t>(count_) && position_ < buf_size_) {
         // get row size
         uint32_t row_size = 0;
@@ -62,13 +72,152 @@ bool ResultSetBase::Next() {
     return false;
 }
 
-bool ResultSetBase::IsNULL(int index) { return row_view_->IsNULL(index); }
+bool ResultSetBase::IsNULL(int index) {
+    if (columnar_) {
+        return index >= 0 && static_cast<uint32_t>(index) < columns_.size() && index_ >= 0 &&
+               index_ < static_cast<int32_t>(count_) && columns_[index].is_null[index_];
+    }
+    return row_view_->IsNULL(index);
+}
+
+const ResultColumn* ResultSetBase::GetColumnValue(uint32_t index) const {
+    if (index >= columns_.size() || index_ < 0 || index_ >= static_cast<int32_t>(count_) ||
+        columns_[index].is_null[index_]) {
+        return nullptr;
+    }
+    return &columns_[index];
+}
+
+bool ResultSetBase::DecodeColumns() {
+    if (columnar_) {
+        return true;
+    }
+    if (io_buf_->size() < buf_size_) {
+        LOG(WARNING) << "buf size " << io_buf_->size() << " is less than " << buf_size_;
+        return false;
+    }
+    // refer to the first block if all the rows are in it, otherwise copy them to a flat buffer
+    const char* data = nullptr;
+    if (buf_size_ > 0 && io_buf_->backing_block_num() > 0 && io_buf_->backing_block(0).size() >= buf_size_) {
+        data = io_buf_->backing_block(0).data();
+    } else {
+        flat_buf_.resize(buf_size_);
+        io_buf_->copy_to(flat_buf_.data(), buf_size_, 0);
+        data = flat_buf_.data();
+    }
+    const auto& schema = schema_.GetSchema();
+    ::hybridse::codec::RowView row_view(schema);
+    std::vector<ResultColumn> columns(schema.size());
+    for (int32_t i = 0; i < schema.size(); i++) {
+        columns[i].type = schema.Get(i).type();
+        columns[i].is_null.reserve(count_);
+    }
+    uint32_t position = 0;
+    for (uint32_t row_idx = 0; row_idx < count_; row_idx++) {
+        if (position + ::hybridse::codec::HEADER_LENGTH > buf_size_) {
+            LOG(WARNING) << "invalid row " << row_idx << " at position " << position;
+            return false;
+        }
+        uint32_t row_size = 0;
+        memcpy(&row_size, data + position + 2, 4);
+        if (row_size < ::hybridse::codec::HEADER_LENGTH || position + row_size > buf_size_) {
+            LOG(WARNING) << "invalid row size " << row_size << " at position " << position;
+            return false;
+        }
+        const int8_t* row = reinterpret_cast<const int8_t*>(data + position);
+        for (int32_t i = 0; i < schema.size(); i++) {
+            auto& column = columns[i];
+            int32_t ret = 0;
+            switch (column.type) {
+                case ::hybridse::type::kBool: {
+                    bool value = false;
+                    ret = row_view.GetValue(row, i, column.type, &value);
+                    column.bool_values.push_back(value);
+                    break;
+                }
+                case ::hybridse::type::kInt16: {
+                    int16_t value = 0;
+                    ret = row_view.GetValue(row, i, column.type, &value);
+                    column.int16_values.push_back(value);
+                    break;
+                }
+                case ::hybridse::type::kInt32:
+                case ::hybridse::type::kDate: {
+                    int32_t value = 0;
+                    ret = row_view.GetValue(row, i, column.type, &value);
+                    column.int32_values.push_back(value);
+                    break;
+                }
+                case ::hybridse::type::kInt64:
+                case ::hybridse::type::kTimestamp: {
+                    int64_t value = 0;
+                    ret = row_view.GetValue(row, i, column.type, &value);
+                    column.int64_values.push_back(value);
+                    break;
+                }
+                case ::hybridse::type::kFloat: {
+                    float value = 0;
+                    ret = row_view.GetValue(row, i, column.type, &value);
+                    column.float_values.push_back(value);
+                    break;
+                }
+                case ::hybridse::type::kDouble: {
+                    double value = 0;
+                    ret = row_view.GetValue(row, i, column.type, &value);
+                    column.double_values.push_back(value);
+                    break;
+                }
+                case ::hybridse::type::kVarchar: {
+                    const char* value = nullptr;
+                    uint32_t length = 0;
+                    ret = row_view.GetValue(row, i, &value, &length);
+                    column.string_values.push_back(ret == 0 ? std::string_view(value, length) : std::string_view());
+                    break;
+                }
+                default: {
+                    LOG(WARNING) << "unsupported type " << ::hybridse::type::Type_Name(column.type);
+                    return false;
+                }
+            }
+            if (ret < 0) {
+                LOG(WARNING) << "fail to decode column " << i << " of row " << row_idx;
+                return false;
+            }
+            column.is_null.push_back(ret == 1 ? 1 : 0);
+        }
+        position += row_size;
+    }
+    columns_ = std::move(columns);
+    columnar_ = true;
+    return true;
+}
+
+bool ResultSetBase::GetStringView(uint32_t index, std::string_view* str) {
+    if (str == NULL) {
+        LOG(WARNING) << "input ptr is null pointer";
+        return false;
+    }
+    auto column = GetColumnValue(index);
+    if (column == nullptr || column->string_values.empty()) {
+        return false;
+    }
+    *str = column->string_values[index_];
+    return true;
+}
 
 bool ResultSetBase::GetString(uint32_t index, std::string* str) {
     if (str == NULL) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->string_values.empty()) {
+            return false;
+        }
+        str->append(column->string_values[index_].data(), column->string_values[index_].size());
+        return true;
+    }
     butil::IOBuf tmp;
     int32_t ret = row_view_->GetString(index, &tmp);
     if (ret == 0) {
@@ -85,6 +234,14 @@ bool ResultSetBase::GetBool(uint32_t index, bool* val) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->bool_values.empty()) {
+            return false;
+        }
+        *val = column->bool_values[index_];
+        return true;
+    }
     int32_t ret = row_view_->GetBool(index, val);
     return ret == 0;
 }
@@ -96,6 +253,14 @@ bool ResultSetBase::GetInt16(uint32_t index, int16_t* result) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->int16_values.empty()) {
+            return false;
+        }
+        *result = column->int16_values[index_];
+        return true;
+    }
     int32_t ret = row_view_->GetInt16(index, result);
     return ret == 0;
 }
@@ -105,6 +270,14 @@ bool ResultSetBase::GetInt32(uint32_t index, int32_t* result) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->int32_values.empty()) {
+            return false;
+        }
+        *result = column->int32_values[index_];
+        return true;
+    }
     int32_t ret = row_view_->GetInt32(index, result);
     return ret == 0;
 }
@@ -114,6 +287,14 @@ bool ResultSetBase::GetInt64(uint32_t index, int64_t* result) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->int64_values.empty()) {
+            return false;
+        }
+        *result = column->int64_values[index_];
+        return true;
+    }
     int32_t ret = row_view_->GetInt64(index, result);
     return ret == 0;
 }
@@ -123,6 +304,14 @@ bool ResultSetBase::GetFloat(uint32_t index, float* result) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->float_values.empty()) {
+            return false;
+        }
+        *result = column->float_values[index_];
+        return true;
+    }
     int32_t ret = row_view_->GetFloat(index, result);
     return ret == 0;
 }
@@ -132,6 +321,14 @@ bool ResultSetBase::GetDouble(uint32_t index, double* result) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->double_values.empty()) {
+            return false;
+        }
+        *result = column->double_values[index_];
+        return true;
+    }
     int32_t ret = row_view_->GetDouble(index, result);
     return ret == 0;
 }
@@ -141,15 +338,35 @@ bool ResultSetBase::GetDate(uint32_t index, int32_t* date) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->int32_values.empty()) {
+            return false;
+        }
+        *date = column->int32_values[index_];
+        return true;
+    }
     int32_t ret = row_view_->GetDate(index, date);
     return ret == 0;
 }
 
 bool ResultSetBase::GetDate(uint32_t index, int32_t* year, int32_t* month, int32_t* day) {
-    if (day == NULL) {
+    if (year == NULL || month == NULL || day == NULL) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->int32_values.empty()) {
+            return false;
+        }
+        int32_t date = column->int32_values[index_];
+        *day = date & 0x0000000FF;
+        date = date >> 8;
+        *month = 1 + (date & 0x0000FF);
+        *year = 1900 + (date >> 8);
+        return true;
+    }
     return 0 == row_view_->GetDate(index, year, month, day);
 }
 
@@ -158,6 +375,14 @@ bool ResultSetBase::GetTime(uint32_t index, int64_t* mills) {
         LOG(WARNING) << "input ptr is null pointer";
         return false;
     }
+    if (columnar_) {
+        auto column = GetColumnValue(index);
+        if (column == nullptr || column->int64_values.empty()) {
+            return false;
+        }
+        *mills = column->int64_values[index_];
+        return true;
+    }
     int32_t ret = row_view_->GetTimestamp(index, mills);
     return ret == 0;
 }
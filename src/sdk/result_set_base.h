@@ -18,6 +18,8 @@
 #define SRC_SDK_RESULT_SET_BASE_H_
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "butil/iobuf.h"
 #include "sdk/base_impl.h"
@@ -26,6 +28,22 @@
 namespace openmldb {
 namespace sdk {
 
+// The values of a column in all the rows of a result set, only the array of the column type is filled
+struct ResultColumn {
+    ::hybridse::type::Type type;
+    std::vector<uint8_t> is_null;
+    std::vector<int8_t> bool_values;
+    std::vector<int16_t> int16_values;
+    // int32 and date
+    std::vector<int32_t> int32_values;
+    // int64 and timestamp
+    std::vector<int64_t> int64_values;
+    std::vector<float> float_values;
+    std::vector<double> double_values;
+    // refer to the buffer of the result set
+    std::vector<std::string_view> string_values;
+};
+
 class ResultSetBase {
  public:
     ResultSetBase(const butil::IOBuf* buf, uint32_t count, uint32_t buf_size,
@@ -60,10 +78,30 @@ class ResultSetBase {
 
     bool GetTime(uint32_t index, int64_t* mills);
 
+    // Decode all the rows into columns in one pass, the getters read the columns after that instead of
+    // decoding the current row on every call. The response is borrowed if it is in one block of the IOBuf,
+    // otherwise it is flattened once
+    bool DecodeColumns();
+
+    inline bool IsColumnar() const { return columnar_; }
+
+    // the string refers to the buffer of the result set and is valid until the result set is destroyed,
+    // only in columnar mode
+    bool GetStringView(uint32_t index, std::string_view* str);
+
+    // the column of all the rows, nullptr if it is not in columnar mode
+    const ResultColumn* GetColumn(uint32_t index) const {
+        return columnar_ && index < columns_.size() ? &columns_[index] : nullptr;
+    }
+
     inline const ::hybridse::sdk::Schema* GetSchema() { return &schema_; }
 
     inline int32_t Size() { return count_; }
 
+ private:
+    // the column `index` if the current row of it is not null in columnar mode
+    const ResultColumn* GetColumnValue(uint32_t index) const;
+
  private:
     const butil::IOBuf* io_buf_;
     uint32_t count_;
@@ -72,6 +110,10 @@ class ResultSetBase {
     ::hybridse::sdk::SchemaImpl schema_;
     uint32_t position_;
     int32_t index_;
+    bool columnar_;
+    std::vector<ResultColumn> columns_;
+    // the flattened response if it is not contiguous in io_buf_
+    std::string flat_buf_;
 };
 
 }  // namespace sdk
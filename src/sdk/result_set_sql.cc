@@ -155,5 +155,70 @@ std::shared_ptr<::hybridse::sdk::ResultSet> ResultSetSQL::MakeResultSet(
     return {};
 }
 
+std::shared_ptr<::hybridse::sdk::ResultSet> PagedResultSetSQL::MakeResultSet(
+    const std::shared_ptr<::openmldb::client::TabletClient>& client, uint32_t page_size, uint32_t timeout_ms,
+    const std::shared_ptr<::openmldb::api::QueryResponse>& response, const std::shared_ptr<brpc::Controller>& cntl,
+    ::hybridse::sdk::Status* status) {
+    if (!status || !client) {
+        return std::shared_ptr<ResultSet>();
+    }
+    auto rs = std::make_shared<PagedResultSetSQL>(client, page_size, timeout_ms);
+    if (!rs->SetPage(response, cntl, status)) {
+        return std::shared_ptr<ResultSet>();
+    }
+    return rs;
+}
+
+bool PagedResultSetSQL::SetPage(const std::shared_ptr<::openmldb::api::QueryResponse>& response,
+                                const std::shared_ptr<brpc::Controller>& cntl, ::hybridse::sdk::Status* status) {
+    auto page = std::dynamic_pointer_cast<ResultSetSQL>(ResultSetSQL::MakeResultSet(response, cntl, status));
+    if (!page) {
+        return false;
+    }
+    if (page_) {
+        fetched_cnt_ += page_->Size();
+        page_idx_++;
+    }
+    page_ = page;
+    has_more_ = response->has_more();
+    cursor_id_ = response->cursor_id();
+    return true;
+}
+
+bool PagedResultSetSQL::FetchNextPage() {
+    auto cntl = std::make_shared<::brpc::Controller>();
+    cntl->set_timeout_ms(timeout_ms_);
+    auto response = std::make_shared<::openmldb::api::QueryResponse>();
+    if (!client_->FetchQueryPage(cursor_id_, page_size_, cntl.get(), response.get())) {
+        LOG(WARNING) << "fail to fetch the next page of cursor " << cursor_id_ << ", " << response->msg();
+        CloseCursor();
+        return false;
+    }
+    ::hybridse::sdk::Status status;
+    if (!SetPage(response, cntl, &status)) {
+        LOG(WARNING) << "fail to make result set of cursor " << cursor_id_ << ", " << status.msg;
+        CloseCursor();
+        return false;
+    }
+    return true;
+}
+
+void PagedResultSetSQL::CloseCursor() {
+    // the cursor is kept by tablet until the last page is fetched, release it if the rest rows are abandoned
+    if (has_more_) {
+        client_->CloseQueryCursor(cursor_id_, timeout_ms_);
+        has_more_ = false;
+    }
+}
+
+bool PagedResultSetSQL::Next() {
+    while (!page_->Next()) {
+        if (!has_more_ || !FetchNextPage()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // namespace sdk
 }  // namespace openmldb
@@ -23,6 +23,7 @@
 
 #include "brpc/controller.h"
 #include "butil/iobuf.h"
+#include "client/tablet_client.h"
 #include "proto/tablet.pb.h"
 #include "sdk/base_impl.h"
 #include "sdk/codec_sdk.h"
@@ -91,6 +92,13 @@ class ResultSetSQL : public ::hybridse::sdk::ResultSet {
 
     int32_t Size() override { return result_set_base_->Size(); }
 
+    // decode all the rows into columns once, see ResultSetBase::DecodeColumns
+    bool DecodeColumns() { return result_set_base_->DecodeColumns(); }
+
+    bool GetStringView(uint32_t index, std::string_view* str) { return result_set_base_->GetStringView(index, str); }
+
+    const ResultColumn* GetColumn(uint32_t index) const { return result_set_base_->GetColumn(index); }
+
  private:
     ::hybridse::vm::Schema schema_;
     uint32_t record_cnt_;
@@ -213,6 +221,73 @@ class MultipleResultSetSQL : public ::hybridse::sdk::ResultSet {
     uint32_t result_idx_;
     std::shared_ptr<ResultSetSQL> result_set_base_;
 };
+
+// PagedResultSetSQL is the result set of a batch query which is fetched from tablet page by page.
+// Only the current page is kept in memory, so it can not be reset after the second page is fetched.
+class PagedResultSetSQL : public ::hybridse::sdk::ResultSet {
+ public:
+    PagedResultSetSQL(const std::shared_ptr<::openmldb::client::TabletClient>& client, uint32_t page_size,
+                      uint32_t timeout_ms)
+        : client_(client), page_size_(page_size), timeout_ms_(timeout_ms), cursor_id_(0), has_more_(false),
+          page_idx_(0), fetched_cnt_(0), page_() {}
+    // the cursor is kept by tablet until the last page is fetched, release it if the rest rows are abandoned
+    ~PagedResultSetSQL() { CloseCursor(); }
+
+    static std::shared_ptr<::hybridse::sdk::ResultSet> MakeResultSet(
+        const std::shared_ptr<::openmldb::client::TabletClient>& client, uint32_t page_size, uint32_t timeout_ms,
+        const std::shared_ptr<::openmldb::api::QueryResponse>& response, const std::shared_ptr<brpc::Controller>& cntl,
+        ::hybridse::sdk::Status* status);
+
+    bool Reset() override { return page_idx_ == 0 && page_->Reset(); }
+
+    bool Next() override;
+
+    bool IsNULL(int index) override { return page_->IsNULL(index); }
+
+    bool GetString(uint32_t index, std::string* str) override { return page_->GetString(index, str); }
+
+    bool GetBool(uint32_t index, bool* result) override { return page_->GetBool(index, result); }
+
+    bool GetChar(uint32_t index, char* result) override { return page_->GetChar(index, result); }
+
+    bool GetInt16(uint32_t index, int16_t* result) override { return page_->GetInt16(index, result); }
+
+    bool GetInt32(uint32_t index, int32_t* result) override { return page_->GetInt32(index, result); }
+
+    bool GetInt64(uint32_t index, int64_t* result) override { return page_->GetInt64(index, result); }
+
+    bool GetFloat(uint32_t index, float* result) override { return page_->GetFloat(index, result); }
+
+    bool GetDouble(uint32_t index, double* result) override { return page_->GetDouble(index, result); }
+
+    bool GetDate(uint32_t index, int32_t* date) override { return page_->GetDate(index, date); }
+
+    bool GetDate(uint32_t index, int32_t* year, int32_t* month, int32_t* day) override {
+        return page_->GetDate(index, year, month, day);
+    }
+
+    bool GetTime(uint32_t index, int64_t* mills) override { return page_->GetTime(index, mills); }
+
+    const ::hybridse::sdk::Schema* GetSchema() override { return page_->GetSchema(); }
+
+    // the count of rows received so far, the total count is unknown until the last page is fetched
+    int32_t Size() override { return fetched_cnt_ + page_->Size(); }
+
+ private:
+    bool SetPage(const std::shared_ptr<::openmldb::api::QueryResponse>& response,
+                 const std::shared_ptr<brpc::Controller>& cntl, ::hybridse::sdk::Status* status);
+    bool FetchNextPage();
+    void CloseCursor();
+
+    std::shared_ptr<::openmldb::client::TabletClient> client_;
+    uint32_t page_size_;
+    uint32_t timeout_ms_;
+    uint64_t cursor_id_;
+    bool has_more_;
+    uint32_t page_idx_;
+    int32_t fetched_cnt_;
+    std::shared_ptr<ResultSetSQL> page_;
+};
 }  // namespace sdk
 }  // namespace openmldb
 #endif  // SRC_SDK_RESULT_SET_SQL_H_
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/result_set_sql.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace sdk {
+
+class ResultSetSQLTest : public ::testing::Test {};
+
+static void CheckColumnar(const std::vector<std::vector<std::string>>& records) {
+    ::hybridse::sdk::Status status;
+    auto rs = ResultSetSQL::MakeResultSet({"c1", "c2"}, records, &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+    auto rs_sql = std::dynamic_pointer_cast<ResultSetSQL>(rs);
+    ASSERT_TRUE(rs_sql);
+    std::string_view view;
+    ASSERT_FALSE(rs_sql->GetStringView(0, &view));
+    ASSERT_EQ(nullptr, rs_sql->GetColumn(0));
+    ASSERT_TRUE(rs_sql->DecodeColumns());
+
+    auto column = rs_sql->GetColumn(1);
+    ASSERT_NE(nullptr, column);
+    ASSERT_EQ(::hybridse::type::kVarchar, column->type);
+    ASSERT_EQ(records.size(), column->string_values.size());
+    ASSERT_EQ(nullptr, rs_sql->GetColumn(2));
+
+    for (int round = 0; round < 2; round++) {
+        size_t row_idx = 0;
+        while (rs->Next()) {
+            ASSERT_LT(row_idx, records.size());
+            for (uint32_t i = 0; i < 2; i++) {
+                ASSERT_FALSE(rs->IsNULL(i));
+                std::string value;
+                ASSERT_TRUE(rs->GetString(i, &value));
+                ASSERT_EQ(records[row_idx][i], value);
+                ASSERT_TRUE(rs_sql->GetStringView(i, &view));
+                ASSERT_EQ(records[row_idx][i], view);
+            }
+            int64_t int_value = 0;
+            ASSERT_FALSE(rs->GetInt64(0, &int_value));
+            row_idx++;
+        }
+        ASSERT_EQ(records.size(), row_idx);
+        ASSERT_TRUE(rs->Reset());
+    }
+}
+
+TEST_F(ResultSetSQLTest, DecodeColumns) {
+    CheckColumnar({{"key1", "1"}, {"key2", ""}, {"key3", "value3"}});
+    // no row
+    CheckColumnar({});
+}
+
+TEST_F(ResultSetSQLTest, DecodeColumnsInBlocks) {
+    // the rows are larger than one block of IOBuf and copied to a flat buffer
+    std::vector<std::vector<std::string>> records;
+    for (int i = 0; i < 4; i++) {
+        records.push_back({"key" + std::to_string(i), std::string(10000, 'a' + i)});
+    }
+    CheckColumnar(records);
+}
+
+}  // namespace sdk
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
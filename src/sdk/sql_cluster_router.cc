@@ -20,12 +20,14 @@
 #include <fstream>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 
 #include "absl/strings/str_cat.h"
 #include "base/ddl_parser.h"
 #include "base/file_util.h"
+#include "boost/algorithm/string/predicate.hpp"
 #include "boost/none.hpp"
 #include "brpc/channel.h"
 #include "cmd/display.h"
@@ -39,12 +41,14 @@
 #include "sdk/base.h"
 #include "sdk/base_impl.h"
 #include "sdk/batch_request_result_set_sql.h"
+#include "sdk/bulk_loader.h"
 #include "sdk/file_option_parser.h"
 #include "sdk/node_adapter.h"
 #include "sdk/result_set_sql.h"
 #include "sdk/split.h"
 
 DECLARE_int32(request_timeout_ms);
+DECLARE_uint64(bulk_load_rpc_size_limit);
 DECLARE_string(mini_window_size);
 
 namespace openmldb {
@@ -217,6 +221,8 @@ bool SQLClusterRouter::Init() {
             coptions.zk_cluster = options_.zk_cluster;
             coptions.zk_path = options_.zk_path;
             coptions.session_timeout = options_.session_timeout;
+            coptions.hot_key_refresh_interval = options_.hot_key_refresh_interval;
+            coptions.hot_key_max_offset_lag = options_.hot_key_max_offset_lag;
             cluster_sdk_ = new ClusterSDK(coptions);
             bool ok = cluster_sdk_->Init();
             if (!ok) {
@@ -256,6 +262,7 @@ bool SQLClusterRouter::Init() {
     session_variables_.emplace("execute_mode", "offline");
     session_variables_.emplace("enable_trace", "false");
     session_variables_.emplace("sync_job", "false");
+    session_variables_.emplace("enable_profile", "false");
     session_variables_.emplace("job_timeout", "20000");  // ref TaskManagerClient::request_timeout_ms_
     return true;
 }
@@ -586,13 +593,15 @@ std::shared_ptr<SQLCache> SQLClusterRouter::GetCache(const std::string& db, cons
     if (it != mode_cache_it->second.end()) {
         auto value = it->second.get(sql);
         if (value != boost::none) {
-            // Check cache validation, the name is the same, but the tid may be different.
+            // Check cache validation, the name is the same, but the tid may be different, or the partitions of
+            // the table may be split.
             // Notice that we won't check it when table_info is disabled and router is enabled.
             //  invalid router info doesn't have tid, so it won't get confused.
             auto cached_info = value.value()->table_info;
             if (cached_info) {
                 auto current_info = cluster_sdk_->GetTableInfo(db, cached_info->name());
-                if (!current_info || cached_info->tid() != current_info->tid()) {
+                if (!current_info || cached_info->tid() != current_info->tid() ||
+                    cached_info->partition_split_size() != current_info->partition_split_size()) {
                     // just leave, this invalid value will be updated by SetCache()
                     return {};
                 }
@@ -909,6 +918,46 @@ std::shared_ptr<::openmldb::client::TabletClient> SQLClusterRouter::GetTabletCli
     return tablet->GetClient();
 }
 
+std::shared_ptr<::openmldb::client::TabletClient> SQLClusterRouter::GetReadTabletClient(
+    const std::string& db, const std::string& sql, const ::hybridse::vm::EngineMode engine_mode,
+    const std::shared_ptr<SQLRequestRow>& row, const ReadOptions& read_options, ::openmldb::api::StalenessBound* bound,
+    std::shared_ptr<::openmldb::client::TabletClient>* leader, hybridse::sdk::Status& status) {
+    bound->Clear();
+    if (read_options.consistency == ReadConsistency::kLeader) {
+        return GetTabletClient(db, sql, engine_mode, row, status);
+    }
+    auto cache = GetSQLCache(db, sql, engine_mode, std::shared_ptr<SQLRequestRow>(), status);
+    if (0 != status.code) {
+        return {};
+    }
+    if (cache && !cache->router.GetMainTable().empty()) {
+        const std::string& col = cache->router.GetRouterCol();
+        const std::string& main_table = cache->router.GetMainTable();
+        const std::string main_db = cache->router.GetMainDb().empty() ? db : cache->router.GetMainDb();
+        std::string val;
+        bool has_key = !col.empty() && row && row->GetRecordVal(col, &val);
+        uint32_t tid = 0;
+        uint32_t pid = 0;
+        auto tablet = cluster_sdk_->GetReplica(main_db, main_table, has_key ? &val : nullptr, &tid, &pid);
+        auto leader_tablet = cluster_sdk_->GetTablet(main_db, main_table, pid);
+        if (tablet && leader_tablet) {
+            if (tablet != leader_tablet && read_options.consistency == ReadConsistency::kBoundedStaleness) {
+                bound->set_tid(tid);
+                bound->set_pid(pid);
+                if (read_options.max_staleness_ms > 0) {
+                    bound->set_max_ms(read_options.max_staleness_ms);
+                }
+                if (read_options.max_staleness_offset > 0) {
+                    bound->set_max_offset(read_options.max_staleness_offset);
+                }
+                *leader = leader_tablet->GetClient();
+            }
+            return tablet->GetClient();
+        }
+    }
+    return GetTabletClient(db, sql, engine_mode, row, status);
+}
+
 // Get clients when online batch query in Cluster OpenMLDB
 bool SQLClusterRouter::GetTabletClientsForClusterOnlineBatchQuery(
     const std::string& db, const std::string& sql, const std::shared_ptr<SQLRequestRow>& parameter,
@@ -1012,6 +1061,14 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLRequest(co
                                                                               const std::string& sql,
                                                                               std::shared_ptr<SQLRequestRow> row,
                                                                               hybridse::sdk::Status* status) {
+    return ExecuteSQLRequest(db, sql, row, options_.read_options, status);
+}
+
+std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLRequest(const std::string& db,
+                                                                              const std::string& sql,
+                                                                              std::shared_ptr<SQLRequestRow> row,
+                                                                              const ReadOptions& read_options,
+                                                                              hybridse::sdk::Status* status) {
     if (!row || !status) {
         LOG(WARNING) << "input is invalid";
         return {};
@@ -1023,7 +1080,9 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLRequest(co
     auto cntl = std::make_shared<::brpc::Controller>();
     cntl->set_timeout_ms(options_.request_timeout);
     auto response = std::make_shared<::openmldb::api::QueryResponse>();
-    auto client = GetTabletClient(db, sql, hybridse::vm::kRequestMode, row, *status);
+    ::openmldb::api::StalenessBound bound;
+    std::shared_ptr<::openmldb::client::TabletClient> leader;
+    auto client = GetReadTabletClient(db, sql, hybridse::vm::kRequestMode, row, read_options, &bound, &leader, *status);
     if (0 != status->code) {
         return {};
     }
@@ -1031,7 +1090,16 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLRequest(co
         status->msg = "not tablet found";
         return {};
     }
-    if (!client->Query(db, sql, row->GetRow(), cntl.get(), response.get(), options_.enable_debug)) {
+    bool ok = client->Query(db, sql, row->GetRow(), cntl.get(), response.get(), options_.enable_debug,
+                            leader ? &bound : nullptr);
+    if (!ok && leader && response->code() == ::openmldb::base::kReplicaTooStale) {
+        DLOG(INFO) << "query the leader " << leader->GetEndpoint() << " instead, " << response->msg();
+        cntl = std::make_shared<::brpc::Controller>();
+        cntl->set_timeout_ms(options_.request_timeout);
+        response = std::make_shared<::openmldb::api::QueryResponse>();
+        ok = leader->Query(db, sql, row->GetRow(), cntl.get(), response.get(), options_.enable_debug);
+    }
+    if (!ok) {
         status->msg = "request server error, msg: " + response->msg();
         return {};
     }
@@ -1068,23 +1136,72 @@ std::shared_ptr<::hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLParamete
         DLOG(INFO) << " send query to tablet " << client->GetEndpoint();
         auto response = std::make_shared<::openmldb::api::QueryResponse>();
         if (!client->Query(db, sql, parameter_types, parameter ? parameter->GetRow() : "", cntl.get(), response.get(),
-                           options_.enable_debug)) {
+                           options_.enable_debug, options_.query_page_size)) {
             status->msg = response->msg();
             status->code = -1;
             return {};
         }
+        if (response->has_more()) {
+            return PagedResultSetSQL::MakeResultSet(client, options_.query_page_size, options_.request_timeout,
+                                                    response, cntl, status);
+        }
         auto rs = ResultSetSQL::MakeResultSet(response, cntl, status);
+        if (rs && options_.columnar_result) {
+            auto rs_sql = std::dynamic_pointer_cast<ResultSetSQL>(rs);
+            if (rs_sql && !rs_sql->DecodeColumns()) {
+                status->msg = "fail to decode the result into columns";
+                status->code = -1;
+                return {};
+            }
+        }
         return rs;
     } else {
-        // Batch query from multiple tablets and merge the result set
-        std::vector<std::shared_ptr<ResultSetSQL>> result_set_list;
+        // Batch query from multiple tablets in parallel and merge the result sets in the order they arrive
+        auto cache = GetSQLCache(db, sql, hybridse::vm::kBatchMode, parameter, *status);
+        if (!cache) {
+            return {};
+        }
+        using QueryCallback = openmldb::RpcCallback<openmldb::api::QueryResponse>;
+        // the queries still running when we return are cancelled, e.g. the limit is reached or one of them failed
+        auto release = [](QueryCallback* callback) {
+            if (!callback->IsDone()) {
+                brpc::StartCancel(callback->GetController()->call_id());
+            }
+            callback->UnRef();
+        };
+        auto queue = std::make_shared<RpcCompletionQueue>();
+        std::vector<std::shared_ptr<QueryCallback>> callbacks;
         for (auto client : clients) {
             DLOG(INFO) << " send query to tablet " << client->GetEndpoint();
             auto cntl = std::make_shared<::brpc::Controller>();
             cntl->set_timeout_ms(options_.request_timeout);
             auto response = std::make_shared<::openmldb::api::QueryResponse>();
-            if (!client->Query(db, sql, parameter_types, parameter ? parameter->GetRow() : "", cntl.get(),
-                               response.get(), options_.enable_debug)) {
+            auto callback = new QueryCallback(response, cntl);
+            callback->Ref();
+            callback->SetCompletionQueue(queue, callbacks.size());
+            callbacks.emplace_back(callback, release);
+            if (!client->Query(db, sql, parameter_types, parameter ? parameter->GetRow() : "", options_.enable_debug,
+                               callback)) {
+                // the request is not sent and the callback will never run
+                callback->UnRef();
+                status->msg = "fail to send query to tablet " + client->GetEndpoint();
+                status->code = -1;
+                return {};
+            }
+        }
+        std::vector<std::shared_ptr<ResultSetSQL>> result_set_list;
+        uint64_t row_cnt = 0;
+        size_t idx = 0;
+        while (result_set_list.size() < callbacks.size()) {
+            queue->Pop(-1, &idx);
+            auto cntl = callbacks[idx]->GetController();
+            auto response = callbacks[idx]->GetResponse();
+            if (cntl->Failed()) {
+                status->msg = "request error. " + cntl->ErrorText();
+                status->code = -1;
+                return {};
+            }
+            if (response->code() != 0) {
                 status->msg = response->msg();
                 status->code = -1;
                 return {};
@@ -1094,10 +1211,11 @@ std::shared_ptr<::hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLParamete
             if (status->code != 0) {
                 return {};
             }
-        }
-        auto cache = GetSQLCache(db, sql, hybridse::vm::kBatchMode, parameter, *status);
-        if (!cache) {
-            return {};
+            row_cnt += response->count();
+            if (cache->limit_cnt > 0 && row_cnt >= cache->limit_cnt) {
+                DLOG(INFO) << "limit " << cache->limit_cnt << " reached, cancel the other queries";
+                break;
+            }
         }
         auto rs = MultipleResultSetSQL::MakeResultSet(result_set_list, cache->limit_cnt, status);
         if (status->code != 0) {
@@ -1107,9 +1225,41 @@ std::shared_ptr<::hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLParamete
     }
 }
 
+std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLProfile(const std::string& db,
+                                                                             const std::string& sql,
+                                                                             ::hybridse::sdk::Status* status) {
+    std::unordered_set<std::shared_ptr<::openmldb::client::TabletClient>> clients;
+    if (!GetTabletClientsForClusterOnlineBatchQuery(db, sql, std::shared_ptr<openmldb::sdk::SQLRequestRow>(), clients,
+                                                    *status)) {
+        return {};
+    }
+    std::vector<std::vector<std::string>> values;
+    for (auto& client : clients) {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(options_.request_timeout);
+        ::openmldb::api::QueryResponse response;
+        // the whole result is computed in one call so that the profile covers all the rows
+        if (!client->Query(db, sql, {}, "", &cntl, &response, options_.enable_debug, 0, true)) {
+            status->msg = response.msg();
+            status->code = -1;
+            return {};
+        }
+        values.push_back({absl::StrCat("TABLET ", client->GetEndpoint(), " ROWS ", response.count(), "\n",
+                                       response.profile(), "\n")});
+    }
+    *status = {};
+    return ResultSetSQL::MakeResultSet({FORMAT_STRING_KEY}, values, status);
+}
+
 std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLBatchRequest(
     const std::string& db, const std::string& sql, std::shared_ptr<SQLRequestRowBatch> row_batch,
     hybridse::sdk::Status* status) {
+    return ExecuteSQLBatchRequest(db, sql, row_batch, options_.read_options, status);
+}
+
+std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLBatchRequest(
+    const std::string& db, const std::string& sql, std::shared_ptr<SQLRequestRowBatch> row_batch,
+    const ReadOptions& read_options, hybridse::sdk::Status* status) {
     if (!row_batch || !status) {
         LOG(WARNING) << "input is invalid";
         return nullptr;
@@ -1117,8 +1267,10 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLBatchReque
     auto cntl = std::make_shared<::brpc::Controller>();
     cntl->set_timeout_ms(options_.request_timeout);
     auto response = std::make_shared<::openmldb::api::SQLBatchRequestQueryResponse>();
-    auto client = GetTabletClient(db, sql, hybridse::vm::kBatchRequestMode, std::shared_ptr<SQLRequestRow>(),
-                                  std::shared_ptr<SQLRequestRow>(), *status);
+    ::openmldb::api::StalenessBound bound;
+    std::shared_ptr<::openmldb::client::TabletClient> leader;
+    auto client = GetReadTabletClient(db, sql, hybridse::vm::kBatchRequestMode, std::shared_ptr<SQLRequestRow>(),
+                                      read_options, &bound, &leader, *status);
     if (0 != status->code) {
         return nullptr;
     }
@@ -1127,7 +1279,16 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLBatchReque
         status->msg = "no tablet found";
         return nullptr;
     }
-    if (!client->SQLBatchRequestQuery(db, sql, row_batch, cntl.get(), response.get(), options_.enable_debug)) {
+    bool ok = client->SQLBatchRequestQuery(db, sql, row_batch, cntl.get(), response.get(), options_.enable_debug,
+                                           leader ? &bound : nullptr);
+    if (!ok && leader && response->code() == ::openmldb::base::kReplicaTooStale) {
+        DLOG(INFO) << "query the leader " << leader->GetEndpoint() << " instead, " << response->msg();
+        cntl = std::make_shared<::brpc::Controller>();
+        cntl->set_timeout_ms(options_.request_timeout);
+        response = std::make_shared<::openmldb::api::SQLBatchRequestQueryResponse>();
+        ok = leader->SQLBatchRequestQuery(db, sql, row_batch, cntl.get(), response.get(), options_.enable_debug);
+    }
+    if (!ok) {
         status->code = -1;
         status->msg = "request server error " + response->msg();
         return nullptr;
@@ -1212,8 +1373,15 @@ bool SQLClusterRouter::PutRow(uint32_t tid, const std::shared_ptr<SQLInsertRow>&
                 if (client) {
                     DLOG(INFO) << "put data to endpoint " << client->GetEndpoint() << " with dimensions size "
                                << kv.second.size();
-                    bool ret = client->Put(tid, pid, cur_ts, row->GetRow(), kv.second, 1);
-                    if (!ret) {
+                    auto ret = client->Put(tid, pid, cur_ts, row->GetRow(), kv.second, 1);
+                    if (ret.GetCode() == ::openmldb::base::ReturnCode::kPartitionKeyMoved) {
+                        // the partition is split, the next insert routes the row with the new table info
+                        cluster_sdk_->Refresh();
+                        status->msg = "partition of table is split, please retry. tid " + std::to_string(tid);
+                        LOG(WARNING) << status->msg;
+                        return false;
+                    }
+                    if (!ret.OK()) {
                         status->msg = "fail to make a put request to table. tid " + std::to_string(tid);
                         LOG(WARNING) << status->msg;
                         return false;
@@ -2303,6 +2471,10 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQL(const std
         case hybridse::node::kPlanTypeFuncDef:
         case hybridse::node::kPlanTypeQuery: {
             if (!cluster_sdk_->IsClusterMode() || IsOnlineMode()) {
+                if (IsEnableProfile()) {
+                    // like EXPLAIN ANALYZE, show the runner statistics instead of the result rows
+                    return ExecuteSQLProfile(db, sql, status);
+                }
                 // Run online query
                 return ExecuteSQLParameterized(db, sql, std::shared_ptr<openmldb::sdk::SQLRequestRow>(), status);
             } else {
@@ -2389,7 +2561,15 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQL(const std
                 *status = {::hybridse::common::StatusCode::kCmdError, " no db in sql and no default db"};
                 return {};
             }
-            if (cluster_sdk_->IsClusterMode()) {
+            // the online bulk load reads the local file and sends the rows to the tablets directly
+            bool bulk_load = false;
+            for (const auto& option : *plan->Options()) {
+                if (boost::iequals(option.first, "load_mode") && option.second != nullptr &&
+                    boost::iequals(option.second->GetAsString(), "bulk_load")) {
+                    bulk_load = true;
+                }
+            }
+            if (cluster_sdk_->IsClusterMode() && !(IsOnlineMode() && bulk_load)) {
                 // Handle in cluster mode
                 ::openmldb::taskmanager::JobInfo job_info;
                 std::map<std::string, std::string> config;
@@ -2412,7 +2592,7 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQL(const std
                     *status = {::hybridse::common::StatusCode::kCmdError, base_status.msg};
                 }
             } else {
-                // Handle in standalone mode
+                // Handle in standalone mode or bulk load
                 *status = HandleLoadDataInfile(database, plan->Table(), plan->File(), plan->Options());
             }
             return {};
@@ -2444,6 +2624,14 @@ bool SQLClusterRouter::IsEnableTrace() {
     }
     return false;
 }
+bool SQLClusterRouter::IsEnableProfile() {
+    std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
+    auto it = session_variables_.find("enable_profile");
+    if (it != session_variables_.end() && it->second == "true") {
+        return true;
+    }
+    return false;
+}
 bool SQLClusterRouter::IsSyncJob() {
     std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
     auto it = session_variables_.find("sync_job");
@@ -2481,7 +2669,7 @@ bool SQLClusterRouter::IsSyncJob() {
         if (value != "online" && value != "offline") {
             return {::hybridse::common::StatusCode::kCmdError, "the value of execute_mode must be online|offline"};
         }
-    } else if (key == "enable_trace" || key == "sync_job") {
+    } else if (key == "enable_trace" || key == "sync_job" || key == "enable_profile") {
         if (value != "true" && value != "false") {
             return {::hybridse::common::StatusCode::kCmdError, "the value of " + key + " must be true|false"};
         }
@@ -2629,7 +2817,7 @@ void SQLClusterRouter::SetInteractive(bool value) { interactive_ = value; }
     return {};
 }
 
-// Only csv format
+// csv format, or parquet format in bulk load mode
 hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
     const std::string& database, const std::string& table, const std::string& file_path,
     const std::shared_ptr<hybridse::node::OptionsMap>& options) {
@@ -2641,6 +2829,13 @@ hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
     if (!st.OK()) {
         return {::hybridse::common::StatusCode::kCmdError, st.msg};
     }
+    if (options_parse.GetLoadMode() == "bulk_load") {
+        return BulkLoadDataInfile(database, table, file_path, options_parse);
+    }
+    if (options_parse.GetFormat() != "csv") {
+        return {::hybridse::common::StatusCode::kCmdError,
+                "format " + options_parse.GetFormat() + " is only supported with load_mode='bulk_load'"};
+    }
     /*std::cout << "Load " << file_path << " to " << real_db << "-" << table << ", options: delimiter ["
               << options_parse.GetDelimiter() << "], has header[" << (options_parse.GetHeader() ? "true" : "false")
               << "], null_value[" << options_parse.GetNullValue() << "], format[" << options_parse.GetFormat()
@@ -2708,6 +2903,50 @@ hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
     return {0, "Load " + std::to_string(i) + " rows"};
 }
 
+hybridse::sdk::Status SQLClusterRouter::BulkLoadDataInfile(const std::string& database, const std::string& table,
+                                                           const std::string& file_path,
+                                                           const ReadFileOptionsParser& options) {
+    auto table_info = cluster_sdk_->GetTableInfo(database, table);
+    if (!table_info) {
+        return {::hybridse::common::StatusCode::kCmdError, "table is not exist"};
+    }
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets;
+    if (!cluster_sdk_->GetTablet(database, table, &tablets) ||
+        static_cast<int>(tablets.size()) != table_info->table_partition_size()) {
+        return {::hybridse::common::StatusCode::kCmdError, "fail to get the leaders of table " + table};
+    }
+    std::vector<std::shared_ptr<::openmldb::client::TabletClient>> clients;
+    for (const auto& tablet : tablets) {
+        clients.push_back(tablet ? tablet->GetClient() : nullptr);
+    }
+    std::string holders;
+    for (int i = 0; i < table_info->column_desc_size(); ++i) {
+        holders += ((i == 0) ? "?" : ",?");
+    }
+    std::string insert_placeholder = "insert into " + table + " values(" + holders + ");";
+    // called by the encoding threads, every call returns a new row built from the cached insert statement
+    auto new_row = [this, database, insert_placeholder]() {
+        hybridse::sdk::Status status;
+        return GetInsertRow(database, insert_placeholder, &status);
+    };
+    uint32_t thread = options.GetThread();
+    if (thread == 0) {
+        thread = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    BulkLoader loader(table_info, clients, new_row, thread, FLAGS_bulk_load_rpc_size_limit);
+    base::Status st;
+    if (options.GetFormat() == "parquet") {
+        st = loader.LoadParquet(file_path);
+    } else {
+        st = loader.LoadCsv(file_path, options.GetDelimiter(), options.GetQuote(), options.GetHeader(),
+                            options.GetNullValue());
+    }
+    if (!st.OK()) {
+        return {::hybridse::common::StatusCode::kCmdError, "bulk load failed, " + st.msg};
+    }
+    return {0, "Load " + std::to_string(loader.GetRowCnt()) + " rows"};
+}
+
 hybridse::sdk::Status SQLClusterRouter::InsertOneRow(const std::string& database, const std::string& insert_placeholder,
                                                      const std::vector<int>& str_col_idx, const std::string& null_value,
                                                      const std::vector<std::string>& cols) {
@@ -31,6 +31,7 @@
 #include "base/lru_cache.h"
 #include "client/tablet_client.h"
 #include "sdk/db_sdk.h"
+#include "sdk/file_option_parser.h"
 #include "sdk/sql_router.h"
 #include "sdk/table_reader_impl.h"
 #include "nameserver/system_table.h"
@@ -157,6 +158,11 @@ class SQLClusterRouter : public SQLRouter {
                                                                 std::shared_ptr<SQLRequestRow> row,
                                                                 hybridse::sdk::Status* status) override;
 
+    std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQLRequest(const std::string& db, const std::string& sql,
+                                                                std::shared_ptr<SQLRequestRow> row,
+                                                                const ReadOptions& read_options,
+                                                                hybridse::sdk::Status* status) override;
+
     std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQL(const std::string& sql,
                                                          ::hybridse::sdk::Status* status) override;
 
@@ -171,6 +177,11 @@ class SQLClusterRouter : public SQLRouter {
                                                                      std::shared_ptr<SQLRequestRowBatch> row_batch,
                                                                      ::hybridse::sdk::Status* status) override;
 
+    std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQLBatchRequest(const std::string& db, const std::string& sql,
+                                                                     std::shared_ptr<SQLRequestRowBatch> row_batch,
+                                                                     const ReadOptions& read_options,
+                                                                     ::hybridse::sdk::Status* status) override;
+
     /// utility functions to query registered components in the current DBMS
     //
     /// \param status result status, will set status.code to error if error happens
@@ -218,9 +229,21 @@ class SQLClusterRouter : public SQLRouter {
         const std::string& db, const std::string& sql, const ::hybridse::vm::EngineMode engine_mode,
         const std::shared_ptr<SQLRequestRow>& row, const std::shared_ptr<SQLRequestRow>& parameter_row,
         hybridse::sdk::Status& status); // NOLINT
+    // like GetTabletClient, but the query may be served by a follower of the main table partition
+    // as `read_options` allows. If the follower has to check its staleness, `bound` is set and `leader`
+    // is the client to fall back to
+    std::shared_ptr<::openmldb::client::TabletClient> GetReadTabletClient(
+        const std::string& db, const std::string& sql, const ::hybridse::vm::EngineMode engine_mode,
+        const std::shared_ptr<SQLRequestRow>& row, const ReadOptions& read_options,
+        ::openmldb::api::StalenessBound* bound, std::shared_ptr<::openmldb::client::TabletClient>* leader,
+        hybridse::sdk::Status& status); // NOLINT
     std::shared_ptr<SQLCache> GetSQLCache(
         const std::string& db, const std::string& sql, const ::hybridse::vm::EngineMode engine_mode,
         const std::shared_ptr<SQLRequestRow>& parameter_row, hybridse::sdk::Status& status); // NOLINT
+    // run an online batch query with profiling and return the runner statistics of every tablet
+    std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQLProfile(const std::string& db, const std::string& sql,
+                                                                ::hybridse::sdk::Status* status);
+
     bool GetTabletClientsForClusterOnlineBatchQuery(
         const std::string& db, const std::string& sql, const std::shared_ptr<SQLRequestRow>& parameter_row,
         std::unordered_set<std::shared_ptr<::openmldb::client::TabletClient>>& clients, //NOLINT
@@ -288,6 +311,7 @@ class SQLClusterRouter : public SQLRouter {
 
     bool IsOnlineMode() override;
     bool IsEnableTrace();
+    bool IsEnableProfile();
     bool IsSyncJob();
 
     std::string GetDatabase();
@@ -348,6 +372,10 @@ class SQLClusterRouter : public SQLRouter {
             const std::string& table, const std::string& file_path,
             const std::shared_ptr<hybridse::node::OptionsMap>& options);
 
+    // load through the bulk load rpc of tablets, the rows are encoded and indexed on the client
+    hybridse::sdk::Status BulkLoadDataInfile(const std::string& database, const std::string& table,
+            const std::string& file_path, const ReadFileOptionsParser& options);
+
     hybridse::sdk::Status InsertOneRow(const std::string& database,
             const std::string& insert_placeholder, const std::vector<int>& str_col_idx,
             const std::string& null_value, const std::vector<std::string>& cols);
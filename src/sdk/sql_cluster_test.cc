@@ -17,13 +17,17 @@
 #include <sched.h>
 #include <unistd.h>
 
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "base/file_util.h"
 #include "base/glog_wapper.h"
+#include "base/partition_router.h"
+#include "client/tablet_client.h"
 #include "codec/fe_row_codec.h"
 #include "common/timer.h"
 #include "gflags/gflags.h"
@@ -34,6 +38,9 @@
 #include "sdk/sql_sdk_test.h"
 #include "vm/catalog.h"
 
+DECLARE_uint32(split_table_clean_delay);
+DECLARE_uint32(hot_key_sample_interval);
+
 namespace openmldb {
 namespace sdk {
 
@@ -970,6 +977,290 @@ TEST_F(SQLClusterTest, GetPreAggrTable) {
     }
 }
 
+// wait for the last split op of the partition to end and return its status
+static std::string WaitSplitOP(::openmldb::client::NsClient* ns, const std::string& name, uint32_t pid) {
+    for (int i = 0; i < 120; i++) {
+        ::openmldb::nameserver::ShowOPStatusResponse response;
+        std::string msg;
+        if (ns->ShowOPStatus(response, name, pid, msg) && response.op_status_size() > 0) {
+            const auto& op_status = response.op_status(response.op_status_size() - 1);
+            if (op_status.op_type() == "kSplitPartitionOP" && op_status.status() != "kInited" &&
+                op_status.status() != "kDoing") {
+                return op_status.status();
+            }
+        }
+        sleep(1);
+    }
+    return "timeout";
+}
+
+TEST_F(SQLClusterTest, SplitPartition) {
+    uint32_t old_delay = FLAGS_split_table_clean_delay;
+    FLAGS_split_table_clean_delay = 100;
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    SetOnlineMode(router);
+    std::string name = "test" + GenRand();
+    std::string db = "db" + GenRand();
+    ::hybridse::sdk::Status status;
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    std::string ddl = "create table " + name +
+                      "("
+                      "col1 string, col2 bigint,"
+                      "index(key=col1, ts=col2)) options(partitionnum=2);";
+    ASSERT_TRUE(router->ExecuteDDL(db, ddl, &status));
+    ASSERT_TRUE(router->RefreshCatalog());
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100; i++) {
+        keys.push_back("hello" + std::to_string(i));
+        std::string insert = "insert into " + name + " values('" + keys.back() + "', 1590);";
+        ASSERT_TRUE(router->ExecuteInsert(db, insert, &status));
+    }
+    auto ns = mc_->GetNsClient();
+    std::string msg;
+    ASSERT_TRUE(ns->Use(db, msg));
+    ASSERT_FALSE(ns->SplitPartition(name, 10, &msg));
+    ASSERT_TRUE(ns->SplitPartition(name, 0, &msg)) << msg;
+    ASSERT_EQ("kDone", WaitSplitOP(ns, name, 0));
+
+    std::vector<::openmldb::nameserver::TableInfo> tables;
+    ASSERT_TRUE(ns->ShowDBTable(db, &tables).OK());
+    ASSERT_EQ(1u, tables.size());
+    const auto& table_info = tables[0];
+    ASSERT_EQ(3, table_info.table_partition_size());
+    ASSERT_EQ(1, table_info.partition_split_size());
+    uint32_t tid = table_info.tid();
+    std::map<uint32_t, uint64_t> key_cnt;
+    std::string moved_key;
+    for (const auto& key : keys) {
+        uint32_t pid = ::openmldb::base::GetPartitionId(key, 3, table_info.partition_split());
+        key_cnt[pid]++;
+        if (pid == 2) {
+            moved_key = key;
+        }
+    }
+    ASSERT_FALSE(moved_key.empty());
+    std::string pid0_leader;
+    std::string pid1_leader;
+    for (const auto& part : table_info.table_partition()) {
+        for (const auto& meta : part.partition_meta()) {
+            if (meta.is_leader() && part.pid() == 0) {
+                pid0_leader = meta.endpoint();
+            } else if (meta.is_leader() && part.pid() == 1) {
+                pid1_leader = meta.endpoint();
+            }
+        }
+    }
+    for (const auto& endpoint : mc_->GetTbEndpoint()) {
+        ::openmldb::api::GetTableStatusRequest request;
+        ::openmldb::api::GetTableStatusResponse response;
+        request.set_tid(tid);
+        request.set_pid(2);
+        MockClosure closure;
+        mc_->GetTablet(endpoint)->GetTableStatus(NULL, &request, &response, &closure);
+        for (const auto& table_status : response.all_table_status()) {
+            ASSERT_EQ(key_cnt[2], table_status.record_cnt());
+        }
+    }
+    // the old partition rejects the moved keys, and the inserts are routed to the new one
+    ::openmldb::client::TabletClient pid0_client(pid0_leader, "");
+    ASSERT_EQ(0, pid0_client.Init());
+    auto ret = pid0_client.Put(tid, 0, 1590, "value", {{moved_key, 0}}, 1);
+    ASSERT_EQ(::openmldb::base::ReturnCode::kPartitionKeyMoved, ret.GetCode());
+    ASSERT_TRUE(router->RefreshCatalog());
+    std::string insert = "insert into " + name + " values('" + moved_key + "', 1591);";
+    ASSERT_TRUE(router->ExecuteInsert(db, insert, &status)) << status.msg;
+
+    // the op fails if the new partition cannot be created, and its replicas are cleaned up
+    ::openmldb::client::TabletClient pid1_client(pid1_leader, "");
+    ASSERT_EQ(0, pid1_client.Init());
+    ::openmldb::api::TableMeta table_meta;
+    ASSERT_TRUE(pid1_client.GetTableSchema(tid, 1, table_meta));
+    table_meta.set_pid(3);
+    table_meta.clear_replicas();
+    ASSERT_TRUE(pid1_client.CreateTable(table_meta));
+    ASSERT_TRUE(ns->SplitPartition(name, 1, &msg)) << msg;
+    ASSERT_EQ("kFailed", WaitSplitOP(ns, name, 1));
+    sleep(2);
+    ASSERT_TRUE(ns->SplitPartition(name, 1, &msg)) << msg;
+    ASSERT_EQ("kDone", WaitSplitOP(ns, name, 1));
+    tables.clear();
+    ASSERT_TRUE(ns->ShowDBTable(db, &tables).OK());
+    ASSERT_EQ(4, tables[0].table_partition_size());
+    ASSERT_EQ(2, tables[0].partition_split_size());
+
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop table " + name + ";", &status));
+    ASSERT_TRUE(router->DropDB(db, &status));
+    FLAGS_split_table_clean_delay = old_delay;
+}
+
+static std::shared_ptr<SQLRequestRow> BuildHotKeyRequestRow(std::shared_ptr<SQLRouter> router, const std::string& db,
+                                                            const std::string& sql, const std::string& key) {
+    hybridse::sdk::Status status;
+    auto row = router->GetRequestRow(db, sql, &status);
+    if (!row || !row->Init(key.size()) || !row->AppendString(key) || !row->AppendInt64(1) ||
+        !row->AppendInt64(1000) || !row->Build()) {
+        return {};
+    }
+    return row;
+}
+
+// the hot keys reported by the leader of the single partition of `table`
+static void GetHotKeys(const std::string& db, const std::string& table, std::map<std::string, uint64_t>* hot_keys) {
+    hot_keys->clear();
+    std::vector<::openmldb::nameserver::TableInfo> tables;
+    std::string msg;
+    ASSERT_TRUE(mc_->GetNsClient()->ShowTable(table, db, false, tables, msg));
+    ASSERT_EQ(1u, tables.size());
+    std::string leader;
+    for (const auto& meta : tables[0].table_partition(0).partition_meta()) {
+        if (meta.is_leader()) {
+            leader = meta.endpoint();
+        }
+    }
+    auto client = mc_->GetTabletClient(leader);
+    ASSERT_TRUE(client != nullptr);
+    ::openmldb::api::GetTableStatusResponse response;
+    ASSERT_TRUE(client->GetTableStatus(true, response));
+    for (const auto& status : response.all_table_status()) {
+        if (status.tid() == tables[0].tid()) {
+            for (const auto& hot_key : status.hot_key()) {
+                hot_keys->emplace(hot_key.key(), hot_key.cnt());
+            }
+        }
+    }
+}
+
+TEST_F(SQLClusterTest, HotKeySample) {
+    uint32_t old_interval = FLAGS_hot_key_sample_interval;
+    FLAGS_hot_key_sample_interval = 1;
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    SetOnlineMode(router);
+    std::string db = "db" + GenRand();
+    std::string name = "test" + GenRand();
+    hybridse::sdk::Status status;
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    ASSERT_TRUE(router->ExecuteDDL(db,
+                                   "create table " + name + "(c1 string, c2 bigint, c3 bigint, index(key=c1, ts=c3)) "
+                                   "options(partitionnum=1, replicanum=2);",
+                                   &status))
+        << status.msg;
+    ASSERT_TRUE(router->RefreshCatalog());
+    std::string sql = "select c1, sum(c2) over w1 from " + name +
+                      " window w1 as (partition by c1 order by c3 rows between 3 preceding and current row);";
+    for (int i = 0; i < 20; i++) {
+        auto row = BuildHotKeyRequestRow(router, db, sql, "hot");
+        ASSERT_TRUE(row);
+        ASSERT_TRUE(router->ExecuteSQLRequest(db, sql, row, &status)) << status.msg;
+    }
+    auto row = BuildHotKeyRequestRow(router, db, sql, "cold");
+    ASSERT_TRUE(row);
+    ASSERT_TRUE(router->ExecuteSQLRequest(db, sql, row, &status)) << status.msg;
+    // batch mode queries are not sampled
+    ASSERT_TRUE(router->ExecuteSQL(db, "select * from " + name + ";", &status)) << status.msg;
+
+    // the key of every request is sampled, the cold key is below --hot_key_min_ratio
+    std::map<std::string, uint64_t> hot_keys;
+    GetHotKeys(db, name, &hot_keys);
+    ASSERT_EQ(1u, hot_keys.size());
+    ASSERT_EQ(20u, hot_keys["hot"]);
+
+    // queries are not sampled without --hot_key_sample_interval
+    FLAGS_hot_key_sample_interval = 0;
+    for (int i = 0; i < 20; i++) {
+        ASSERT_TRUE(router->ExecuteSQLRequest(db, sql, row, &status)) << status.msg;
+    }
+    GetHotKeys(db, name, &hot_keys);
+    ASSERT_EQ(1u, hot_keys.size());
+    ASSERT_EQ(20u, hot_keys["hot"]);
+    FLAGS_hot_key_sample_interval = old_interval;
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop table " + name + ";", &status));
+    ASSERT_TRUE(router->DropDB(db, &status));
+}
+
+TEST_F(SQLClusterTest, HotKeyRouting) {
+    uint32_t old_interval = FLAGS_hot_key_sample_interval;
+    FLAGS_hot_key_sample_interval = 1;
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    sql_opt.hot_key_refresh_interval = 500;
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    SetOnlineMode(router);
+    std::string db = "db" + GenRand();
+    std::string name = "test" + GenRand();
+    hybridse::sdk::Status status;
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    ASSERT_TRUE(router->ExecuteDDL(db,
+                                   "create table " + name + "(c1 string, c2 bigint, c3 bigint, index(key=c1, ts=c3)) "
+                                   "options(partitionnum=1, replicanum=2);",
+                                   &status))
+        << status.msg;
+    ASSERT_TRUE(router->RefreshCatalog());
+    ASSERT_TRUE(router->ExecuteInsert(db, "insert into " + name + " values('hot', 10, 900);", &status)) << status.msg;
+    std::vector<::openmldb::nameserver::TableInfo> tables;
+    std::string msg;
+    ASSERT_TRUE(mc_->GetNsClient()->ShowTable(name, db, false, tables, msg));
+    std::set<std::string> replicas;
+    std::string leader;
+    for (const auto& meta : tables[0].table_partition(0).partition_meta()) {
+        replicas.insert(meta.endpoint());
+        if (meta.is_leader()) {
+            leader = meta.endpoint();
+        }
+    }
+    ASSERT_EQ(2u, replicas.size());
+
+    std::string sql = "select c1, sum(c2) over w1 from " + name +
+                      " window w1 as (partition by c1 order by c3 rows between 3 preceding and current row);";
+    auto sql_cluster_router = std::dynamic_pointer_cast<SQLClusterRouter>(router);
+    auto hot_row = BuildHotKeyRequestRow(router, db, sql, "hot");
+    auto cold_row = BuildHotKeyRequestRow(router, db, sql, "cold");
+    ASSERT_TRUE(hot_row && cold_row);
+    // no key is hot yet, all the queries go to the leader
+    for (int i = 0; i < 20; i++) {
+        auto client = sql_cluster_router->GetTabletClient(db, sql, hybridse::vm::kRequestMode, hot_row, status);
+        ASSERT_TRUE(client);
+        ASSERT_EQ(leader, client->GetEndpoint());
+    }
+    for (int i = 0; i < 20; i++) {
+        ASSERT_TRUE(router->ExecuteSQLRequest(db, sql, hot_row, &status)) << status.msg;
+    }
+    ASSERT_TRUE(router->ExecuteSQLRequest(db, sql, cold_row, &status)) << status.msg;
+    sleep(2);  // let the sdk pull the hot keys
+
+    // the hot key is spread over the leader and the follower, the others stay on the leader
+    std::set<std::string> endpoints;
+    for (int i = 0; i < 100; i++) {
+        auto client = sql_cluster_router->GetTabletClient(db, sql, hybridse::vm::kRequestMode, hot_row, status);
+        ASSERT_TRUE(client);
+        endpoints.insert(client->GetEndpoint());
+        client = sql_cluster_router->GetTabletClient(db, sql, hybridse::vm::kRequestMode, cold_row, status);
+        ASSERT_TRUE(client);
+        ASSERT_EQ(leader, client->GetEndpoint());
+    }
+    ASSERT_EQ(replicas, endpoints);
+    // the follower serves the same window
+    for (int i = 0; i < 20; i++) {
+        auto rs = router->ExecuteSQLRequest(db, sql, hot_row, &status);
+        ASSERT_TRUE(rs != nullptr) << status.msg;
+        ASSERT_EQ(1, rs->Size());
+        ASSERT_TRUE(rs->Next());
+        ASSERT_EQ(11, rs->GetInt64Unsafe(1));
+    }
+    FLAGS_hot_key_sample_interval = old_interval;
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop table " + name + ";", &status));
+    ASSERT_TRUE(router->DropDB(db, &status));
+}
+
 }  // namespace sdk
 }  // namespace openmldb
 
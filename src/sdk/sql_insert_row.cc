@@ -19,7 +19,10 @@
 #include <stdint.h>
 
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "base/partition_router.h"
 #include "glog/logging.h"
 
 namespace openmldb {
@@ -62,6 +65,11 @@ SQLInsertRow::SQLInsertRow(std::shared_ptr<::openmldb::nameserver::TableInfo> ta
                 index_map_[idx].push_back(column_name_map[column]);
                 raw_dimensions_[column_name_map[column]] = hybridse::codec::NONETOKEN;
             }
+            if (table_info_->column_key(idx).key_encoding() == ::openmldb::type::kMemcomparableKey) {
+                ::openmldb::codec::IndexKeyEncoder encoder;
+                encoder.Init(table_info_->column_key(idx), table_info_->column_desc());
+                key_encoders_.emplace(idx, std::move(encoder));
+            }
             if (!table_info_->column_key(idx).ts_name().empty()) {
                 ts_set_.insert(column_name_map[table_info_->column_key(idx).ts_name()]);
             }
@@ -91,18 +99,27 @@ const std::map<uint32_t, std::vector<std::pair<std::string, uint32_t>>>& SQLInse
         return dimensions_;
     }
     uint32_t pid_num = table_info_->table_partition_size();
-    uint32_t pid = 0;
     for (const auto& kv : index_map_) {
         std::string key;
-        for (uint32_t idx : kv.second) {
-            if (!key.empty()) {
-                key += "|";
+        auto encoder = key_encoders_.find(kv.first);
+        if (encoder != key_encoders_.end()) {
+            std::vector<std::string> values;
+            for (uint32_t idx : kv.second) {
+                values.push_back(raw_dimensions_[idx]);
+            }
+            if (!encoder->second.Encode(values, &key)) {
+                LOG(WARNING) << "fail to encode the key of index " << table_info_->column_key(kv.first).index_name();
+                key.clear();
+            }
+        } else {
+            for (uint32_t idx : kv.second) {
+                if (!key.empty()) {
+                    key += "|";
+                }
+                key += raw_dimensions_[idx];
             }
-            key += raw_dimensions_[idx];
-        }
-        if (pid_num > 0) {
-            pid = (uint32_t)(::openmldb::base::hash64(key) % pid_num);
         }
+        uint32_t pid = ::openmldb::base::GetPartitionId(key, pid_num, table_info_->partition_split());
         auto iter = dimensions_.find(pid);
         if (iter == dimensions_.end()) {
             auto result = dimensions_.emplace(pid, std::vector<std::pair<std::string, uint32_t>>());
@@ -27,6 +27,7 @@
 #include "base/hash.h"
 #include "codec/codec.h"
 #include "codec/fe_row_codec.h"
+#include "codec/index_key_codec.h"
 #include "node/sql_node.h"
 #include "proto/name_server.pb.h"
 #include "sdk/base.h"
@@ -108,6 +109,8 @@ class SQLInsertRow {
     DefaultValueMap default_map_;
     uint32_t default_string_length_;
     std::map<uint32_t, std::vector<uint32_t>> index_map_;
+    // the encoders of kMemcomparableKey indexes
+    std::map<uint32_t, ::openmldb::codec::IndexKeyEncoder> key_encoders_;
     std::set<uint32_t> ts_set_;
     std::map<uint32_t, std::string> raw_dimensions_;
     std::map<uint32_t, std::vector<std::pair<std::string, uint32_t>>> dimensions_;
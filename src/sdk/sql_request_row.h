@@ -88,6 +88,8 @@ class SQLRequestRowBatch {
  public:
     SQLRequestRowBatch(std::shared_ptr<hybridse::sdk::Schema> schema, std::shared_ptr<ColumnIndicesSet> indices);
     bool AddRow(std::shared_ptr<SQLRequestRow> row);
+    // add a row already encoded with the request schema
+    bool AddRow(const int8_t* buf, size_t size);
     int Size() const { return non_common_slices_.size(); }
 
     const std::set<size_t>& common_column_indices() const { return common_column_indices_; }
@@ -36,16 +36,40 @@
 namespace openmldb {
 namespace sdk {
 
+// which replicas may serve an online request query
+enum class ReadConsistency {
+    kLeader = 0,
+    // a follower serves the query only if it lags behind the leader within the bound
+    kBoundedStaleness = 1,
+    kAnyReplica = 2,
+};
+
+struct ReadOptions {
+    ReadConsistency consistency = ReadConsistency::kLeader;
+    // the bounds of kBoundedStaleness, 0 means no bound
+    uint64_t max_staleness_ms = 0;
+    uint64_t max_staleness_offset = 0;
+};
+
 struct BasicRouterOptions {
     bool enable_debug = false;
     uint32_t session_timeout = 2000;
     uint32_t max_sql_cache_size = 10;
     uint32_t request_timeout = 60000;
+    // fetch the result of batch query from a single tablet page by page, 0 means fetch the whole result at once
+    uint32_t query_page_size = 0;
+    // decode the result of batch query from a single tablet into columns once, see ResultSetSQL::DecodeColumns
+    bool columnar_result = false;
+    // the default read options of the request queries
+    ReadOptions read_options;
 };
 
 struct SQLRouterOptions : BasicRouterOptions {
     std::string zk_cluster;
     std::string zk_path;
+    // route the request mode queries of hot keys to the followers, see ClusterOptions
+    uint32_t hot_key_refresh_interval = 0;
+    uint64_t hot_key_max_offset_lag = 1000;
 };
 
 struct StandaloneOptions : BasicRouterOptions {
@@ -119,6 +143,10 @@ class SQLRouter {
         const std::string& db, const std::string& sql, std::shared_ptr<openmldb::sdk::SQLRequestRow> row,
         hybridse::sdk::Status* status) = 0;
 
+    virtual std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQLRequest(
+        const std::string& db, const std::string& sql, std::shared_ptr<openmldb::sdk::SQLRequestRow> row,
+        const ReadOptions& read_options, hybridse::sdk::Status* status) = 0;
+
     virtual std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQL(const std::string& db, const std::string& sql,
                                                                  hybridse::sdk::Status* status) = 0;
 
@@ -133,6 +161,10 @@ class SQLRouter {
         const std::string& db, const std::string& sql, std::shared_ptr<openmldb::sdk::SQLRequestRowBatch> row_batch,
         ::hybridse::sdk::Status* status) = 0;
 
+    virtual std::shared_ptr<hybridse::sdk::ResultSet> ExecuteSQLBatchRequest(
+        const std::string& db, const std::string& sql, std::shared_ptr<openmldb::sdk::SQLRequestRowBatch> row_batch,
+        const ReadOptions& read_options, ::hybridse::sdk::Status* status) = 0;
+
     virtual bool RefreshCatalog() = 0;
 
     virtual std::shared_ptr<hybridse::sdk::ResultSet> CallProcedure(const std::string& db, const std::string& sp_name,
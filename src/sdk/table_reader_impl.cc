@@ -19,7 +19,6 @@
 #include <memory>
 #include <utility>
 
-#include "base/hash.h"
 #include "brpc/channel.h"
 #include "client/tablet_client.h"
 #include "proto/tablet.pb.h"
@@ -98,11 +97,7 @@ std::shared_ptr<openmldb::sdk::ScanFuture> TableReaderImpl::AsyncScan(const std:
     }
 
     auto sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
-    uint32_t pid_num = sdk_table_handler->GetPartitionNum();
-    uint32_t pid = 0;
-    if (pid_num > 0) {
-        pid = ::openmldb::base::hash64(key) % pid_num;
-    }
+    uint32_t pid = sdk_table_handler->GetPid(key);
     auto accessor = sdk_table_handler->GetTablet(pid);
     if (!accessor) {
         LOG(WARNING) << "fail to get tablet for db " << db << " table " << table;
@@ -155,11 +150,7 @@ std::shared_ptr<hybridse::sdk::ResultSet> TableReaderImpl::Scan(const std::strin
     }
 
     auto sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
-    uint32_t pid_num = sdk_table_handler->GetPartitionNum();
-    uint32_t pid = 0;
-    if (pid_num > 0) {
-        pid = ::openmldb::base::hash64(key) % pid_num;
-    }
+    uint32_t pid = sdk_table_handler->GetPid(key);
     auto accessor = sdk_table_handler->GetTablet(pid);
     if (!accessor) {
         LOG(WARNING) << "fail to get tablet for db " << db << " table " << table;
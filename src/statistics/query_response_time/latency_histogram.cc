@@ -0,0 +1,120 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "statistics/query_response_time/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace openmldb {
+namespace statistics {
+
+LatencyHistogram::LatencyHistogram() {
+    for (auto& shard : shards_) {
+        for (auto& cnt : shard.counts) {
+            cnt.store(0, std::memory_order_relaxed);
+        }
+        shard.total_us.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Record(absl::Duration time) {
+    int64_t us = absl::ToInt64Microseconds(time);
+    Record(us < 0 ? 0 : static_cast<uint64_t>(us));
+}
+
+void LatencyHistogram::Record(uint64_t us) {
+    auto& shard = shards_[GetShardIdx()];
+    shard.counts[GetBucketIdx(us)].fetch_add(1, std::memory_order_relaxed);
+    shard.total_us.fetch_add(us, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> LatencyHistogram::GetCounts() const {
+    std::vector<uint64_t> counts(kBucketCount, 0);
+    for (const auto& shard : shards_) {
+        for (size_t idx = 0; idx < kBucketCount; idx++) {
+            counts[idx] += shard.counts[idx].load(std::memory_order_relaxed);
+        }
+    }
+    return counts;
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+    uint64_t cnt = 0;
+    for (auto bucket_cnt : GetCounts()) {
+        cnt += bucket_cnt;
+    }
+    return cnt;
+}
+
+uint64_t LatencyHistogram::GetTotalUs() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.total_us.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double p) const {
+    auto counts = GetCounts();
+    uint64_t total = 0;
+    for (auto cnt : counts) {
+        total += cnt;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    p = std::min(std::max(p, 0.0), 1.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * total)));
+    uint64_t seen = 0;
+    for (size_t idx = 0; idx < kBucketCount; idx++) {
+        seen += counts[idx];
+        if (seen >= rank) {
+            return GetUpperBound(idx);
+        }
+    }
+    return GetUpperBound(kBucketCount - 1);
+}
+
+size_t LatencyHistogram::GetBucketIdx(uint64_t us) {
+    if (us < kSubBucketCount) {
+        return us;
+    }
+    uint32_t exponent = 63 - __builtin_clzll(us);
+    if (exponent >= kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    uint32_t shift = exponent - kSubBucketBits;
+    return (shift + 1) * kSubBucketCount + (us >> shift) - kSubBucketCount;
+}
+
+uint64_t LatencyHistogram::GetUpperBound(size_t idx) {
+    if (idx < kSubBucketCount) {
+        return idx;
+    }
+    uint32_t shift = idx / kSubBucketCount - 1;
+    uint64_t lower = static_cast<uint64_t>(kSubBucketCount + idx % kSubBucketCount) << shift;
+    return lower + (1ull << shift) - 1;
+}
+
+size_t LatencyHistogram::GetShardIdx() {
+    static std::atomic<size_t> next_idx{0};
+    thread_local size_t idx = next_idx.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+    return idx;
+}
+
+}  // namespace statistics
+}  // namespace openmldb
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STATISTICS_QUERY_RESPONSE_TIME_LATENCY_HISTOGRAM_H_
+#define SRC_STATISTICS_QUERY_RESPONSE_TIME_LATENCY_HISTOGRAM_H_
+
+#include <atomic>
+#include <vector>
+
+#include "absl/time/time.h"
+
+namespace openmldb {
+namespace statistics {
+
+// Log-linear latency histogram in microseconds, HDR style. Values below kSubBucketCount have a bucket
+// each, above that every power of two range [2^e, 2^(e+1)) is divided into kSubBucketCount linear
+// buckets, so a percentile is off by at most 1 / kSubBucketCount of its value.
+//
+// Recording is lock free. The counters are sharded by thread so that the threads seldom write
+// the same cache line, the shards are merged on read.
+class LatencyHistogram {
+ public:
+    static constexpr uint32_t kSubBucketBits = 4;
+    static constexpr uint32_t kSubBucketCount = 1u << kSubBucketBits;
+    // the values of 2^kMaxExponent us (about 12 days) and above fall into the last bucket
+    static constexpr uint32_t kMaxExponent = 40;
+    static constexpr uint32_t kBucketCount = (kMaxExponent - kSubBucketBits + 1) * kSubBucketCount;
+    static constexpr uint32_t kShardCount = 4;
+
+    LatencyHistogram();
+
+    // histogram is not copyable
+    LatencyHistogram(const LatencyHistogram& h) = delete;
+
+    void Record(absl::Duration time);
+
+    void Record(uint64_t us);
+
+    /// \brief merge the counts of all the shards, indexed by bucket
+    std::vector<uint64_t> GetCounts() const;
+
+    uint64_t GetCount() const;
+
+    uint64_t GetTotalUs() const;
+
+    /// \brief the upper bound in us of the bucket holding the `p` quantile, 0 if nothing recorded
+    /// \param p in [0, 1], e.g. 0.99 for p99
+    uint64_t GetPercentile(double p) const;
+
+    static size_t GetBucketIdx(uint64_t us);
+
+    /// \brief the max value in us falling into bucket `idx`
+    static uint64_t GetUpperBound(size_t idx);
+
+ private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> counts[kBucketCount];
+        std::atomic<uint64_t> total_us;
+    };
+
+    static size_t GetShardIdx();
+
+    Shard shards_[kShardCount];
+};
+
+}  // namespace statistics
+}  // namespace openmldb
+
+#endif  // SRC_STATISTICS_QUERY_RESPONSE_TIME_LATENCY_HISTOGRAM_H_
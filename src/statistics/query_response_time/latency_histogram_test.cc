@@ -0,0 +1,96 @@
+/*
+ * Copyright 2022 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "statistics/query_response_time/latency_histogram.h"
+
+#include <thread>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace statistics {
+
+class LatencyHistogramTest : public ::testing::Test {
+ public:
+    ~LatencyHistogramTest() override {}
+};
+
+TEST_F(LatencyHistogramTest, BucketIdx) {
+    for (uint64_t us = 0; us < LatencyHistogram::kSubBucketCount; us++) {
+        ASSERT_EQ(us, LatencyHistogram::GetBucketIdx(us));
+        ASSERT_EQ(us, LatencyHistogram::GetUpperBound(us));
+    }
+    // the buckets are continuous and each value falls into the bucket bounding it
+    size_t last_idx = 0;
+    for (uint64_t us = 1; us < (1ull << 20); us += us / 7 + 1) {
+        size_t idx = LatencyHistogram::GetBucketIdx(us);
+        ASSERT_LT(idx, LatencyHistogram::kBucketCount);
+        ASSERT_GE(idx, last_idx);
+        ASSERT_LE(us, LatencyHistogram::GetUpperBound(idx));
+        ASSERT_GT(us, LatencyHistogram::GetUpperBound(idx - 1));
+        // the relative error is bounded by the sub bucket count
+        ASSERT_LE(LatencyHistogram::GetUpperBound(idx) - us, us / LatencyHistogram::kSubBucketCount);
+        last_idx = idx;
+    }
+    ASSERT_EQ(LatencyHistogram::kBucketCount - 1, LatencyHistogram::GetBucketIdx(UINT64_MAX));
+    ASSERT_EQ(LatencyHistogram::kBucketCount - 1, LatencyHistogram::GetBucketIdx((1ull << 40) - 1));
+}
+
+TEST_F(LatencyHistogramTest, Percentile) {
+    LatencyHistogram histogram;
+    ASSERT_EQ(0u, histogram.GetPercentile(0.99));
+    for (uint64_t us = 1; us <= 1000; us++) {
+        histogram.Record(absl::Microseconds(us));
+    }
+    ASSERT_EQ(1000u, histogram.GetCount());
+    ASSERT_EQ(500500u, histogram.GetTotalUs());
+    uint64_t p50 = histogram.GetPercentile(0.5);
+    ASSERT_GE(p50, 500u);
+    ASSERT_LE(p50, 500u + 500u / LatencyHistogram::kSubBucketCount);
+    uint64_t p99 = histogram.GetPercentile(0.99);
+    ASSERT_GE(p99, 990u);
+    ASSERT_LE(p99, 990u + 990u / LatencyHistogram::kSubBucketCount);
+    ASSERT_GE(histogram.GetPercentile(1), 1000u);
+    ASSERT_EQ(1u, histogram.GetPercentile(0));
+}
+
+TEST_F(LatencyHistogramTest, MultiThread) {
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([&histogram]() {
+            for (int j = 0; j < 10000; j++) {
+                histogram.Record(static_cast<uint64_t>(100));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(80000u, histogram.GetCount());
+    ASSERT_EQ(80000u * 100, histogram.GetTotalUs());
+    ASSERT_EQ(LatencyHistogram::GetUpperBound(LatencyHistogram::GetBucketIdx(100)), histogram.GetPercentile(0.999));
+}
+
+}  // namespace statistics
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
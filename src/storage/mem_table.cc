@@ -16,12 +16,17 @@
 
 #include "storage/mem_table.h"
 
+#include <snappy.h>
+
 #include <algorithm>
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "base/glog_wapper.h"
 #include "base/hash.h"
 #include "base/slice.h"
+#include "codec/index_key_codec.h"
+#include "codec/row_codec.h"
 #include "common/timer.h"
 #include "gflags/gflags.h"
 #include "storage/record.h"
@@ -32,6 +37,8 @@ DECLARE_uint32(key_entry_max_height);
 DECLARE_uint32(absolute_default_skiplist_height);
 DECLARE_uint32(latest_default_skiplist_height);
 DECLARE_uint32(max_traverse_cnt);
+DECLARE_int32(zstd_compress_level);
+DECLARE_uint32(zstd_dict_sample_cnt);
 
 namespace openmldb {
 namespace storage {
@@ -47,7 +54,9 @@ MemTable::MemTable(const std::string& name, uint32_t id, uint32_t pid, uint32_t
       enable_gc_(true),
       record_cnt_(0),
       segment_released_(false),
-      record_byte_size_(0) {}
+      record_byte_size_(0),
+      compressor_(),
+      dict_train_threshold_(0) {}
 
 MemTable::MemTable(const ::openmldb::api::TableMeta& table_meta)
     : Table(table_meta.storage_mode(), table_meta.name(), table_meta.tid(), table_meta.pid(), 0, true, 60 * 1000,
@@ -59,6 +68,7 @@ MemTable::MemTable(const ::openmldb::api::TableMeta& table_meta)
     record_cnt_ = 0;
     segment_released_ = false;
     record_byte_size_ = 0;
+    dict_train_threshold_ = 0;
     diskused_ = 0;
     table_meta_ = std::make_shared<::openmldb::api::TableMeta>(table_meta);
 }
@@ -85,6 +95,30 @@ bool MemTable::Init() {
     if (!InitFromMeta()) {
         return false;
     }
+    if (compress_type_ == ::openmldb::type::kZstd) {
+        compressor_ = std::make_shared<RowCompressor>(FLAGS_zstd_compress_level);
+        dict_train_threshold_ = std::max(FLAGS_zstd_dict_sample_cnt, 1u);
+        const auto& compress_dict = table_meta_->compress_dict();
+        if (table_meta_->has_compress_dict() && !compressor_->AddDict(compress_dict.version(), compress_dict.dict())) {
+            PDLOG(WARNING, "fail to load compress dict version %u. tid %u pid %u", compress_dict.version(), id_, pid_);
+        }
+    }
+    for (const auto& range_index : table_meta_->range_index()) {
+        int col_idx = -1;
+        for (int i = 0; i < table_meta_->column_desc_size(); i++) {
+            if (table_meta_->column_desc(i).name() == range_index.col_name()) {
+                col_idx = i;
+                break;
+            }
+        }
+        if (col_idx < 0 || !codec::RangeKeyCodec::IsSupportedType(table_meta_->column_desc(col_idx).data_type())) {
+            PDLOG(WARNING, "invalid range index %s on column %s. tid %u pid %u", range_index.index_name().c_str(),
+                  range_index.col_name().c_str(), id_, pid_);
+            return false;
+        }
+        range_indexes_.push_back(std::make_shared<RangeIndex>(range_index.index_name(), col_idx,
+                                                              table_meta_->column_desc(col_idx).data_type()));
+    }
     if (table_meta_->seg_cnt() > 0) {
         seg_cnt_ = table_meta_->seg_cnt();
     }
@@ -127,6 +161,50 @@ void MemTable::SetCompressType(::openmldb::type::CompressType compress_type) { c
 
 ::openmldb::type::CompressType MemTable::GetCompressType() { return compress_type_; }
 
+bool MemTable::NeedTrainCompressDict() {
+    if (!compressor_ || compressor_->GetDictVersion() > 0) {
+        return false;
+    }
+    uint64_t threshold = dict_train_threshold_.load(std::memory_order_relaxed);
+    uint64_t cnt = record_cnt_.load(std::memory_order_relaxed);
+    // try again with twice the rows if the training fails
+    return cnt >= threshold &&
+           dict_train_threshold_.compare_exchange_strong(threshold, cnt * 2, std::memory_order_relaxed);
+}
+
+bool MemTable::TrainCompressDict(uint32_t sample_cnt, uint32_t dict_size) {
+    if (!compressor_) {
+        return false;
+    }
+    // every index refers to the same data blocks, sample them from the first one
+    std::unique_ptr<TableIterator> it(NewTraverseIterator(0));
+    if (!it) {
+        return false;
+    }
+    std::vector<std::string> rows;
+    it->SeekToFirst();
+    while (it->Valid() && rows.size() < sample_cnt) {
+        auto value = it->GetValue();
+        rows.emplace_back(value.data(), value.size());
+        it->Next();
+    }
+    std::vector<Slice> samples(rows.begin(), rows.end());
+    std::string dict;
+    uint32_t version = compressor_->GetDictVersion() + 1;
+    if (!RowCompressor::Train(samples, dict_size, &dict) || !compressor_->AddDict(version, dict)) {
+        PDLOG(WARNING, "fail to train compress dict from %lu rows. tid %u pid %u", rows.size(), id_, pid_);
+        return false;
+    }
+    auto table_meta = std::atomic_load_explicit(&table_meta_, std::memory_order_acquire);
+    auto new_table_meta = std::make_shared<::openmldb::api::TableMeta>(*table_meta);
+    new_table_meta->mutable_compress_dict()->set_version(version);
+    new_table_meta->mutable_compress_dict()->set_dict(dict);
+    std::atomic_store_explicit(&table_meta_, new_table_meta, std::memory_order_release);
+    PDLOG(INFO, "train compress dict version %u from %lu rows, dict size %lu. tid %u pid %u", version, rows.size(),
+          dict.size(), id_, pid_);
+    return true;
+}
+
 bool MemTable::Put(const std::string& pk, uint64_t time, const char* data, uint32_t size) {
     if (segments_.empty()) return false;
     uint32_t index = 0;
@@ -194,7 +272,32 @@ bool MemTable::Put(uint64_t time, const std::string& value, const Dimensions& di
     if (ts_map.empty()) {
         return false;
     }
-    auto* block = new DataBlock(real_ref_cnt, value.c_str(), value.length());
+    // a range scan returns the rows of the primary index as a full scan does, so only they are indexed
+    std::vector<std::string> range_keys;
+    uint32_t range_ref_cnt = 0;
+    Slice primary_key;
+    uint64_t primary_ts = time;
+    auto primary_def = range_indexes_.empty() ? nullptr : GetIndex(0);
+    if (primary_def && primary_def->IsReady()) {
+        auto iter = inner_index_key_map.find(primary_def->GetInnerPos());
+        if (iter != inner_index_key_map.end()) {
+            primary_key = iter->second;
+            auto ts_col = primary_def->GetTsColumn();
+            if (ts_col) {
+                primary_ts = ts_map[ts_col->GetId()];
+            }
+            if (!PackRangeKeys(*decoder, data, &range_keys, &range_ref_cnt)) {
+                return false;
+            }
+        }
+    }
+    const std::string* row = &value;
+    std::string compressed;
+    if (compressor_ && compressor_->Compress(value.data(), value.size(), &compressed)) {
+        row = &compressed;
+    }
+    auto* block = new DataBlock(real_ref_cnt + range_ref_cnt, row->c_str(), row->length());
+    block->range_ref_cnt = range_ref_cnt;
     for (const auto& kv : inner_index_key_map) {
         auto inner_index = table_index_.GetInnerIndex(kv.first);
         bool need_put = false;
@@ -214,8 +317,29 @@ bool MemTable::Put(uint64_t time, const std::string& value, const Dimensions& di
             segment->Put(::openmldb::base::Slice(kv.second), ts_map, block);
         }
     }
+    for (uint32_t i = 0; i < range_keys.size(); i++) {
+        if (!range_keys[i].empty()) {
+            range_indexes_[i]->Put(range_keys[i], primary_key, primary_ts, block);
+        }
+    }
     record_cnt_.fetch_add(1, std::memory_order_relaxed);
-    record_byte_size_.fetch_add(GetRecordSize(value.length()));
+    record_byte_size_.fetch_add(GetRecordSize(row->length()));
+    return true;
+}
+
+bool MemTable::PackRangeKeys(const codec::RowView& decoder, const int8_t* row, std::vector<std::string>* keys,
+                             uint32_t* cnt) {
+    keys->resize(range_indexes_.size());
+    for (uint32_t i = 0; i < range_indexes_.size(); i++) {
+        int ret = range_indexes_[i]->PackKey(decoder, row, &keys->at(i));
+        if (ret < 0) {
+            PDLOG(WARNING, "fail to pack key of range index %s. tid %u pid %u", range_indexes_[i]->GetName().c_str(),
+                  id_, pid_);
+            return false;
+        } else if (ret == 0) {
+            (*cnt)++;
+        }
+    }
     return true;
 }
 
@@ -249,12 +373,17 @@ uint64_t MemTable::Release() {
             }
         }
     }
+    // the blocks are released by the segments first, so a block is freed by the last reference of it
+    for (const auto& range_index : range_indexes_) {
+        range_index->Release();
+    }
     segment_released_ = true;
     segments_.clear();
     return total_cnt;
 }
 
 void MemTable::SchedGc() {
+    std::lock_guard<std::mutex> gc_lock(gc_mu_);
     uint64_t consumed = ::baidu::common::timer::get_micros();
     PDLOG(INFO, "start making gc for table %s, tid %u, pid %u", name_.c_str(), id_, pid_);
     uint64_t gc_idx_cnt = 0;
@@ -300,6 +429,8 @@ void MemTable::SchedGc() {
             continue;
         }
         for (uint32_t j = 0; j < seg_cnt_; j++) {
+            // no lock of the segments is held here
+            ::openmldb::base::YieldPoint::Check();
             uint64_t seg_gc_time = ::baidu::common::timer::get_micros() / 1000;
             Segment* segment = segments_[i][j];
             segment->IncrGcVersion();
@@ -314,6 +445,20 @@ void MemTable::SchedGc() {
                   name_.c_str(), id_, pid_);
         }
     }
+    // the blocks expired in all the segments are only referred by the range indexes now
+    for (const auto& range_index : range_indexes_) {
+        range_index->Gc(gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    }
+    for (auto iter = dedupe_gc_rounds_.begin(); iter != dedupe_gc_rounds_.end();) {
+        if (++iter->second < 2) {
+            iter++;
+            continue;
+        }
+        for (uint32_t k = 0; k < seg_cnt_; k++) {
+            segments_[iter->first][k]->SetDedupe(false);
+        }
+        iter = dedupe_gc_rounds_.erase(iter);
+    }
     consumed = ::baidu::common::timer::get_micros() - consumed;
     record_cnt_.fetch_sub(gc_record_cnt, std::memory_order_relaxed);
     record_byte_size_.fetch_sub(gc_record_byte_size, std::memory_order_relaxed);
@@ -442,6 +587,20 @@ int MemTable::GetCount(uint32_t index, const std::string& pk, uint64_t& count) {
     return segment->GetCount(spk, count);
 }
 
+bool MemTable::GetKeyVersion(uint32_t idx, const std::string& pk, uint64_t* version) {
+    std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(idx);
+    if (!index_def || !index_def->IsReady()) {
+        return false;
+    }
+    uint32_t seg_idx = 0;
+    if (seg_cnt_ > 1) {
+        seg_idx = ::openmldb::base::hash(pk.c_str(), pk.length(), SEED) % seg_cnt_;
+    }
+    Segment* segment = segments_[index_def->GetInnerPos()][seg_idx];
+    auto ts_col = index_def->GetTsColumn();
+    return segment->GetVersion(Slice(pk), ts_col ? ts_col->GetId() : 0, version);
+}
+
 TableIterator* MemTable::NewIterator(const std::string& pk, Ticket& ticket) { return NewIterator(0, pk, ticket); }
 
 TableIterator* MemTable::NewIterator(uint32_t index, const std::string& pk, Ticket& ticket) {
@@ -458,10 +617,63 @@ TableIterator* MemTable::NewIterator(uint32_t index, const std::string& pk, Tick
     uint32_t real_idx = index_def->GetInnerPos();
     Segment* segment = segments_[real_idx][seg_idx];
     auto ts_col = index_def->GetTsColumn();
+    MemTableIterator* it = nullptr;
     if (ts_col) {
-        return segment->NewIterator(spk, ts_col->GetId(), ticket);
+        it = segment->NewIterator(spk, ts_col->GetId(), ticket);
+    } else {
+        it = segment->NewIterator(spk, ticket);
     }
-    return segment->NewIterator(spk, ticket);
+    it->SetCompressor(compressor_);
+    return it;
+}
+
+TableIterator* MemTable::NewRangeIterator(const ::hybridse::vm::ColumnRange& range) {
+    if (!range.Valid()) {
+        return nullptr;
+    }
+    auto table_meta = GetTableMeta();
+    int col_idx = -1;
+    for (int i = 0; i < table_meta->column_desc_size(); i++) {
+        if (table_meta->column_desc(i).name() == range.column) {
+            col_idx = i;
+            break;
+        }
+    }
+    auto primary_def = GetIndex(0);
+    if (!primary_def || !primary_def->IsReady()) {
+        return nullptr;
+    }
+    PrimaryIndexView primary;
+    primary.segments = segments_[primary_def->GetInnerPos()];
+    primary.seg_cnt = seg_cnt_;
+    auto ts_col = primary_def->GetTsColumn();
+    if (ts_col) {
+        primary.ts_col = ts_col->GetId();
+    }
+    auto ttl = primary_def->GetTTL();
+    primary.expire_value.ttl_type = ttl->ttl_type;
+    if (enable_gc_.load(std::memory_order_relaxed)) {
+        primary.expire_value.abs_ttl = GetExpireTime(*ttl);
+        primary.expire_value.lat_ttl = ttl->lat_ttl;
+    }
+    for (const auto& range_index : range_indexes_) {
+        if (static_cast<int>(range_index->GetColumnIdx()) != col_idx) {
+            continue;
+        }
+        std::string lower;
+        std::string upper;
+        bool lower_inclusive = range.lower.inclusive;
+        bool upper_inclusive = range.upper.inclusive;
+        if ((range.lower.bounded && !codec::RangeKeyCodec::PackBound(range.lower.value, range_index->GetType(), true,
+                                                                     &lower_inclusive, &lower)) ||
+            (range.upper.bounded && !codec::RangeKeyCodec::PackBound(range.upper.value, range_index->GetType(), false,
+                                                                     &upper_inclusive, &upper))) {
+            PDLOG(WARNING, "invalid range %s. tid %u pid %u", range.ToString().c_str(), id_, pid_);
+            return nullptr;
+        }
+        return range_index->NewIterator(lower, lower_inclusive, upper, upper_inclusive, primary, compressor_);
+    }
+    return nullptr;
 }
 
 uint64_t MemTable::GetRecordIdxByteSize() {
@@ -542,6 +754,37 @@ bool MemTable::GetRecordIdxCnt(uint32_t idx, uint64_t** stat, uint32_t* size) {
     return true;
 }
 
+bool MemTable::GetIndexStats(uint32_t idx, uint32_t sample_cnt, uint64_t* pk_cnt, uint64_t* idx_cnt,
+                             std::vector<uint64_t>* key_counts) {
+    if (pk_cnt == NULL || idx_cnt == NULL || key_counts == NULL) {
+        return false;
+    }
+    std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(idx);
+    if (!index_def || !index_def->IsReady()) {
+        return false;
+    }
+    uint32_t real_idx = index_def->GetInnerPos();
+    auto ts_col = index_def->GetTsColumn();
+    uint32_t ts_idx = ts_col ? ts_col->GetId() : 0;
+    // spread the samples over all segments as keys are hashed into them
+    uint32_t seg_sample_cnt = (sample_cnt + seg_cnt_ - 1) / seg_cnt_;
+    *pk_cnt = 0;
+    *idx_cnt = 0;
+    for (uint32_t i = 0; i < seg_cnt_; i++) {
+        Segment* segment = segments_[real_idx][i];
+        *pk_cnt += segment->GetPkCnt();
+        uint64_t cnt = 0;
+        if (segment->GetTsCnt() > 1) {
+            segment->GetIdxCnt(ts_idx, cnt);
+        } else {
+            cnt = segment->GetIdxCnt();
+        }
+        *idx_cnt += cnt;
+        segment->SampleCount(ts_idx, seg_sample_cnt, key_counts);
+    }
+    return true;
+}
+
 bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
     // TODO(denglong): support ttl type and merge index
     auto table_meta = GetTableMeta();
@@ -596,6 +839,7 @@ bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
         }
         index_def = std::make_shared<IndexDef>(column_key.index_name(), table_index_.GetMaxIndexId() + 1,
                 IndexStatus::kReady, ::openmldb::type::IndexType::kTimeSerise, col_vec);
+        index_def->SetKeyEncoding(column_key.key_encoding());
         if (table_index_.AddIndex(index_def) < 0) {
             PDLOG(WARNING, "add index failed. tid %u pid %u", id_, pid_);
             return false;
@@ -624,6 +868,174 @@ bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
     return true;
 }
 
+bool MemTable::BackfillIndex(uint32_t idx, uint32_t partition_num, uint32_t thread_num, uint64_t* put_cnt) {
+    std::shared_ptr<IndexDef> index_def = GetIndex(idx);
+    std::shared_ptr<IndexDef> primary_def = GetIndex(0);
+    if (!index_def || !index_def->IsReady() || !primary_def || !primary_def->IsReady() || index_def == primary_def) {
+        PDLOG(WARNING, "index %u can not be backfilled. tid %u pid %u", idx, id_, pid_);
+        return false;
+    }
+    if (partition_num == 0 || thread_num == 0 || put_cnt == nullptr) {
+        return false;
+    }
+    uint32_t inner_pos = index_def->GetInnerPos();
+    if (segments_[inner_pos][0]->GetTsCnt() > 1) {
+        PDLOG(WARNING, "index %s shares the segments with other indexes. tid %u pid %u",
+              index_def->GetName().c_str(), id_, pid_);
+        return false;
+    }
+    auto ts_col = index_def->GetTsColumn();
+    if (!ts_col) {
+        PDLOG(WARNING, "index %s has no ts column. tid %u pid %u", index_def->GetName().c_str(), id_, pid_);
+        return false;
+    }
+    // the indexes may keep different rows as their ttl differ, so the rows are collected from all of them
+    // and deduplicated by their data blocks
+    struct Source {
+        uint32_t inner_pos;
+        uint32_t ts_pos;
+    };
+    std::vector<Source> sources;
+    auto inner_indexes = table_index_.GetAllInnerIndex();
+    for (uint32_t i = 0; i < inner_indexes->size(); i++) {
+        if (i == inner_pos) {
+            continue;
+        }
+        for (const auto& cur_index : inner_indexes->at(i)->GetIndex()) {
+            if (!cur_index->IsReady()) {
+                continue;
+            }
+            auto cur_ts_col = cur_index->GetTsColumn();
+            // the time the row is put is only kept in the keys of the indexes without ts column
+            if (ts_col->IsAutoGenTs() && !(cur_ts_col && cur_ts_col->IsAutoGenTs())) {
+                PDLOG(WARNING, "the ts of index %s is not in index %s. tid %u pid %u", index_def->GetName().c_str(),
+                      cur_index->GetName().c_str(), id_, pid_);
+                return false;
+            }
+            uint32_t ts_pos = 0;
+            if (cur_ts_col) {
+                const auto& ts_idx_map = segments_[i][0]->GetTsIdxMap();
+                auto iter = ts_idx_map.find(cur_ts_col->GetId());
+                if (iter != ts_idx_map.end()) {
+                    ts_pos = iter->second;
+                }
+            }
+            sources.push_back({i, ts_pos});
+        }
+    }
+    if (sources.empty()) {
+        return false;
+    }
+    std::vector<uint32_t> index_cols;
+    std::vector<::openmldb::type::DataType> types;
+    uint32_t max_col = 0;
+    for (const auto& col : index_def->GetColumns()) {
+        index_cols.push_back(col.GetId());
+        types.push_back(col.GetType());
+        max_col = std::max(max_col, col.GetId());
+    }
+    codec::IndexKeyEncoder key_encoder(index_def->GetKeyEncoding(), types);
+    bool is_snappy = GetCompressType() == ::openmldb::type::kSnappy;
+
+    uint32_t task_num = sources.size() * seg_cnt_;
+    thread_num = std::min(thread_num, task_num);
+    std::lock_guard<std::mutex> gc_lock(gc_mu_);
+    // a put of the new index which races with the scan may find the row put by the scan already. It is
+    // decided under the segment lock, so each row is indexed once
+    for (uint32_t i = 0; i < seg_cnt_; i++) {
+        segments_[inner_pos][i]->SetDedupe(true);
+    }
+    std::atomic<uint64_t> total_put_cnt(0);
+    std::atomic<uint64_t> skip_cnt(0);
+    auto backfill = [&](uint32_t start) {
+        std::string buf;
+        std::vector<std::string> row;
+        std::vector<std::string> values;
+        std::string key;
+        for (uint32_t task = start; task < task_num; task += thread_num) {
+            const Source& source = sources[task / seg_cnt_];
+            Segment* segment = segments_[source.inner_pos][task % seg_cnt_];
+            KeyEntries::Iterator* pk_it = segment->GetKeyEntries()->NewIterator();
+            pk_it->SeekToFirst();
+            while (pk_it->Valid()) {
+                KeyEntry* entry = segment->GetTsCnt() > 1
+                                      ? reinterpret_cast<KeyEntry**>(pk_it->GetValue())[source.ts_pos]
+                                      : reinterpret_cast<KeyEntry*>(pk_it->GetValue());
+                TimeEntries::Iterator* it = entry->entries.NewIterator();
+                it->SeekToFirst();
+                for (; it->Valid(); it->Next()) {
+                    DataBlock* block = it->GetValue();
+                    Slice value(block->data, block->size);
+                    if (compressor_ && !compressor_->Decompress(value.data(), value.size(), &value)) {
+                        skip_cnt.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    } else if (is_snappy) {
+                        buf.clear();
+                        snappy::Uncompress(value.data(), value.size(), &buf);
+                        value.reset(buf.data(), buf.size());
+                    }
+                    const int8_t* data = reinterpret_cast<const int8_t*>(value.data());
+                    uint8_t version = codec::RowView::GetSchemaVersion(data);
+                    auto schema = GetVersionSchema(version);
+                    row.clear();
+                    if (schema == nullptr || schema->size() <= static_cast<int>(max_col) ||
+                        !codec::RowCodec::DecodeRow(*schema, data, value.size(), true, 0, max_col + 1, row)) {
+                        skip_cnt.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    values.clear();
+                    for (uint32_t col : index_cols) {
+                        values.push_back(row[col]);
+                    }
+                    key.clear();
+                    if (!key_encoder.Encode(values, &key) || key.empty()) {
+                        skip_cnt.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    // the same partition as the snapshot and the sdk
+                    uint32_t index_pid = ::openmldb::base::hash64(key) % partition_num;
+                    if (index_pid != pid_) {
+                        continue;
+                    }
+                    int64_t ts = 0;
+                    if (ts_col->IsAutoGenTs()) {
+                        ts = it->GetKey();
+                    } else if (GetVersionDecoder(version)->GetInteger(data, ts_col->GetId(), ts_col->GetType(),
+                                                                      &ts) != 0) {
+                        skip_cnt.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    uint32_t dst_idx = 0;
+                    if (seg_cnt_ > 1) {
+                        dst_idx = ::openmldb::base::hash(key.data(), key.size(), SEED) % seg_cnt_;
+                    }
+                    if (segments_[inner_pos][dst_idx]->PutIfAbsent(Slice(key), ts, block)) {
+                        total_put_cnt.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                delete it;
+                pk_it->Next();
+            }
+            delete pk_it;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < thread_num; i++) {
+        threads.emplace_back(backfill, i);
+    }
+    backfill(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // the puts which have read the index before the scan ends may still be running, so the segments keep
+    // deduplicating until the second gc from now
+    dedupe_gc_rounds_[inner_pos] = 0;
+    *put_cnt = total_put_cnt.load(std::memory_order_relaxed);
+    PDLOG(INFO, "backfill index %s with %u threads, put %lu rows and skip %lu rows. tid %u pid %u",
+          index_def->GetName().c_str(), thread_num, *put_cnt, skip_cnt.load(std::memory_order_relaxed), id_, pid_);
+    return true;
+}
+
 bool MemTable::DeleteIndex(const std::string& idx_name) {
     std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(idx_name);
     if (!index_def) {
@@ -667,7 +1079,8 @@ bool MemTable::DeleteIndex(const std::string& idx_name) {
     if (ts_col) {
         ts_idx = ts_col->GetId();
     }
-    return new MemTableKeyIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type, expire_time, expire_cnt, ts_idx);
+    return new MemTableKeyIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type, expire_time, expire_cnt, ts_idx,
+                                   compressor_);
 }
 
 TableIterator* MemTable::NewTraverseIterator(uint32_t index) {
@@ -687,9 +1100,10 @@ TableIterator* MemTable::NewTraverseIterator(uint32_t index) {
     auto ts_col = index_def->GetTsColumn();
     if (ts_col) {
         return new MemTableTraverseIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type, expire_time, expire_cnt,
-                                            ts_col->GetId());
+                                            ts_col->GetId(), compressor_);
     }
-    return new MemTableTraverseIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type, expire_time, expire_cnt, 0);
+    return new MemTableTraverseIterator(segments_[real_idx], seg_cnt_, ttl->ttl_type, expire_time, expire_cnt, 0,
+                                        compressor_);
 }
 
 bool MemTable::GetBulkLoadInfo(::openmldb::api::BulkLoadInfoResponse* response) {
@@ -738,6 +1152,25 @@ bool MemTable::GetBulkLoadInfo(::openmldb::api::BulkLoadInfoResponse* response)
 
 bool MemTable::BulkLoad(const std::vector<DataBlock*>& data_blocks,
                         const ::google::protobuf::RepeatedPtrField<::openmldb::api::BulkLoadIndex>& indexes) {
+    // the key and the time of the blocks in the primary index, only these blocks are put into range indexes
+    std::vector<const std::string*> primary_keys;
+    std::vector<uint64_t> primary_ts;
+    int32_t primary_pos = -1;
+    uint32_t primary_entry_id = 0;
+    auto primary_def = GetIndex(0);
+    if (!range_indexes_.empty() && primary_def && primary_def->IsReady()) {
+        primary_keys.resize(data_blocks.size(), nullptr);
+        primary_ts.resize(data_blocks.size(), 0);
+        primary_pos = primary_def->GetInnerPos();
+        auto ts_col = primary_def->GetTsColumn();
+        if (ts_col && segments_[primary_pos][0]->GetTsCnt() > 1) {
+            const auto& ts_idx_map = segments_[primary_pos][0]->GetTsIdxMap();
+            auto iter = ts_idx_map.find(ts_col->GetId());
+            if (iter != ts_idx_map.end()) {
+                primary_entry_id = iter->second;
+            }
+        }
+    }
     // data_block[i] is the block which id == i
     for (int i = 0; i < indexes.size(); ++i) {
         const auto& inner_index = indexes.Get(i);
@@ -767,17 +1200,93 @@ bool MemTable::BulkLoad(const std::vector<DataBlock*>& data_blocks,
                                 << time_entry.block_id();
                         block->dim_cnt_down++;
                         segment->BulkLoadPut(key_entry_id, pk, time_entry.time(), block);
+                        if (static_cast<int32_t>(real_idx) == primary_pos && key_entry_id == primary_entry_id) {
+                            primary_keys[time_entry.block_id()] = &key_entries.key();
+                            primary_ts[time_entry.block_id()] = time_entry.time();
+                        }
                     }
                 }
             }
         }
     }
+    if (primary_keys.empty()) {
+        return true;
+    }
+    // the blocks put into the primary index are added to range indexes once
+    for (uint32_t block_id = 0; block_id < data_blocks.size(); block_id++) {
+        auto* block = data_blocks[block_id];
+        if (block == nullptr || primary_keys[block_id] == nullptr || block->range_ref_cnt > 0) {
+            continue;
+        }
+        Slice value(block->data, block->size);
+        if (compressor_ && !compressor_->Decompress(value.data(), value.size(), &value)) {
+            PDLOG(WARNING, "fail to decompress row. tid %u pid %u", id_, pid_);
+            return false;
+        }
+        const int8_t* data = reinterpret_cast<const int8_t*>(value.data());
+        auto decoder = GetVersionDecoder(codec::RowView::GetSchemaVersion(data));
+        std::vector<std::string> range_keys;
+        uint32_t range_ref_cnt = 0;
+        if (decoder == nullptr || !PackRangeKeys(*decoder, data, &range_keys, &range_ref_cnt)) {
+            PDLOG(WARNING, "fail to pack range keys. tid %u pid %u", id_, pid_);
+            return false;
+        }
+        block->dim_cnt_down += range_ref_cnt;
+        block->range_ref_cnt = range_ref_cnt;
+        for (uint32_t i = 0; i < range_keys.size(); i++) {
+            if (!range_keys[i].empty()) {
+                range_indexes_[i]->Put(range_keys[i], Slice(*primary_keys[block_id]), primary_ts[block_id], block);
+            }
+        }
+    }
 
     return true;
 }
 
+size_t MemTableWindowIterator::GetBatch(::hybridse::codec::RowRef* batch, size_t max_size) {
+    // walk the time entries first and only prefetch the data blocks, so that
+    // the block misses overlap with the pointer chasing on skiplist nodes
+    static constexpr size_t kMaxBatchSize = 64;
+    DataBlock* blocks[kMaxBatchSize];
+    max_size = std::min(max_size, kMaxBatchSize);
+    size_t cnt = 0;
+    while (cnt < max_size && Valid()) {
+        DataBlock* block = it_->GetValue();
+        __builtin_prefetch(block);
+        batch[cnt].key = it_->GetKey();
+        blocks[cnt] = block;
+        cnt++;
+        Next();
+    }
+    for (size_t i = 0; i < cnt; i++) {
+        batch[i].buf = reinterpret_cast<const int8_t*>(blocks[i]->data);
+        batch[i].size = blocks[i]->size;
+        __builtin_prefetch(blocks[i]->data);
+        ::hybridse::vm::Profiler::CountDecode(blocks[i]->size);
+    }
+    return cnt;
+}
+
+const ::hybridse::codec::Row& MemTableCompressedWindowIterator::GetValue() {
+    const auto& row = it_->GetValue();
+    const char* data = reinterpret_cast<const char*>(row.buf());
+    if (!RowCompressor::IsCompressed(data, row.size())) {
+        return row;
+    }
+    int8_t* buf = nullptr;
+    size_t size = 0;
+    if (!compressor_->Decompress(data, row.size(), &buf, &size)) {
+        PDLOG(WARNING, "fail to decompress row");
+        row_ = ::hybridse::codec::Row();
+        return row_;
+    }
+    row_ = ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::CreateManaged(buf, size));
+    return row_;
+}
+
 MemTableKeyIterator::MemTableKeyIterator(Segment** segments, uint32_t seg_cnt, ::openmldb::storage::TTLType ttl_type,
-                                         uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index)
+                                         uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index,
+                                         const std::shared_ptr<RowCompressor>& compressor)
     : segments_(segments),
       seg_cnt_(seg_cnt),
       seg_idx_(0),
@@ -787,7 +1296,8 @@ MemTableKeyIterator::MemTableKeyIterator(Segment** segments, uint32_t seg_cnt, :
       expire_time_(expire_time),
       expire_cnt_(expire_cnt),
       ticket_(),
-      ts_idx_(0) {
+      ts_idx_(0),
+      compressor_(compressor) {
     uint32_t idx = 0;
     if (segments_[0]->GetTsIdx(ts_index, idx) == 0) {
         ts_idx_ = idx;
@@ -799,6 +1309,7 @@ MemTableKeyIterator::~MemTableKeyIterator() {
 }
 
 void MemTableKeyIterator::SeekToFirst() {
+    ::hybridse::vm::Profiler::CountSeek();
     ticket_.Pop();
     if (pk_it_ != NULL) {
         delete pk_it_;
@@ -814,6 +1325,7 @@ void MemTableKeyIterator::SeekToFirst() {
 }
 
 void MemTableKeyIterator::Seek(const std::string& key) {
+    ::hybridse::vm::Profiler::CountSeek();
     if (pk_it_ != NULL) {
         delete pk_it_;
         pk_it_ = NULL;
@@ -835,7 +1347,11 @@ bool MemTableKeyIterator::Valid() {
     return valid;
 }
 
-void MemTableKeyIterator::Next() { NextPK(); }
+void MemTableKeyIterator::Next() {
+    ::hybridse::vm::Profiler::CountNext();
+    ::openmldb::base::YieldPoint::Check();
+    NextPK();
+}
 
 ::hybridse::vm::RowIterator* MemTableKeyIterator::GetRawValue() {
     TimeEntries::Iterator* it = NULL;
@@ -849,7 +1365,11 @@ void MemTableKeyIterator::Next() { NextPK(); }
         ticket_.Push((KeyEntry*)pk_it_->GetValue());  // NOLINT
     }
     it->SeekToFirst();
-    return new MemTableWindowIterator(it, ttl_type_, expire_time_, expire_cnt_);
+    auto wit = new MemTableWindowIterator(it, ttl_type_, expire_time_, expire_cnt_);
+    if (compressor_) {
+        return new MemTableCompressedWindowIterator(wit, compressor_);
+    }
+    return wit;
 }
 
 std::unique_ptr<::hybridse::vm::RowIterator> MemTableKeyIterator::GetValue() {
@@ -864,8 +1384,11 @@ std::unique_ptr<::hybridse::vm::RowIterator> MemTableKeyIterator::GetValue() {
         ticket_.Push((KeyEntry*)pk_it_->GetValue());  // NOLINT
     }
     it->SeekToFirst();
-    std::unique_ptr<MemTableWindowIterator> wit(new MemTableWindowIterator(it, ttl_type_, expire_time_, expire_cnt_));
-    return std::move(wit);
+    auto wit = new MemTableWindowIterator(it, ttl_type_, expire_time_, expire_cnt_);
+    if (compressor_) {
+        return std::unique_ptr<::hybridse::vm::RowIterator>(new MemTableCompressedWindowIterator(wit, compressor_));
+    }
+    return std::unique_ptr<::hybridse::vm::RowIterator>(wit);
 }
 
 const hybridse::codec::Row MemTableKeyIterator::GetKey() {
@@ -898,7 +1421,8 @@ void MemTableKeyIterator::NextPK() {
 
 MemTableTraverseIterator::MemTableTraverseIterator(Segment** segments, uint32_t seg_cnt,
                                                    ::openmldb::storage::TTLType ttl_type, uint64_t expire_time,
-                                                   uint64_t expire_cnt, uint32_t ts_index)
+                                                   uint64_t expire_cnt, uint32_t ts_index,
+                                                   const std::shared_ptr<RowCompressor>& compressor)
     : segments_(segments),
       seg_cnt_(seg_cnt),
       seg_idx_(0),
@@ -908,7 +1432,8 @@ MemTableTraverseIterator::MemTableTraverseIterator(Segment** segments, uint32_t
       ts_idx_(0),
       expire_value_(expire_time, expire_cnt, ttl_type),
       ticket_(),
-      traverse_cnt_(0) {
+      traverse_cnt_(0),
+      compressor_(compressor) {
     uint32_t idx = 0;
     if (segments_[0]->GetTsIdx(ts_index, idx) == 0) {
         ts_idx_ = idx;
@@ -1043,7 +1568,12 @@ void MemTableTraverseIterator::Seek(const std::string& key, uint64_t ts) {
 }
 
 openmldb::base::Slice MemTableTraverseIterator::GetValue() const {
-    return openmldb::base::Slice(it_->GetValue()->data, it_->GetValue()->size);
+    openmldb::base::Slice value(it_->GetValue()->data, it_->GetValue()->size);
+    if (compressor_ && !compressor_->Decompress(value.data(), value.size(), &value)) {
+        PDLOG(WARNING, "fail to decompress row");
+        return openmldb::base::Slice();
+    }
+    return value;
 }
 
 uint64_t MemTableTraverseIterator::GetKey() const {
@@ -20,15 +20,20 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <vector>
 
+#include "base/yield_point.h"
 #include "proto/tablet.pb.h"
 #include "storage/iterator.h"
+#include "storage/range_index.h"
+#include "storage/row_compressor.h"
 #include "storage/segment.h"
 #include "storage/table.h"
 #include "storage/ticket.h"
 #include "vm/catalog.h"
+#include "vm/profile.h"
 
 using ::openmldb::api::LogEntry;
 using ::openmldb::base::Slice;
@@ -38,7 +43,7 @@ namespace storage {
 
 typedef google::protobuf::RepeatedPtrField<::openmldb::api::Dimension> Dimensions;
 
-class MemTableWindowIterator : public ::hybridse::vm::RowIterator {
+class MemTableWindowIterator final : public ::hybridse::codec::BatchRowIterator {
  public:
     MemTableWindowIterator(TimeEntries::Iterator* it, ::openmldb::storage::TTLType ttl_type, uint64_t expire_time,
                            uint64_t expire_cnt)
@@ -46,28 +51,39 @@ class MemTableWindowIterator : public ::hybridse::vm::RowIterator {
 
     ~MemTableWindowIterator() { delete it_; }
 
-    inline bool Valid() const {
+    inline bool Valid() const override {
         if (!it_->Valid() || expire_value_.IsExpired(it_->GetKey(), record_idx_)) {
             return false;
         }
         return true;
     }
 
-    inline void Next() {
+    inline void Next() override {
+        ::hybridse::vm::Profiler::CountNext();
+        ::openmldb::base::YieldPoint::Check();
         it_->Next();
         record_idx_++;
     }
 
-    inline const uint64_t& GetKey() const { return it_->GetKey(); }
+    inline const uint64_t& GetKey() const override { return it_->GetKey(); }
 
     // TODO(wangtaize) unify the row object
-    inline const ::hybridse::codec::Row& GetValue() {
+    inline const ::hybridse::codec::Row& GetValue() override {
         row_.Reset(reinterpret_cast<const int8_t*>(it_->GetValue()->data), it_->GetValue()->size);
+        ::hybridse::vm::Profiler::CountDecode(it_->GetValue()->size);
         return row_;
     }
-    inline void Seek(const uint64_t& key) { it_->Seek(key); }
-    inline void SeekToFirst() { it_->SeekToFirst(); }
-    inline bool IsSeekable() const { return true; }
+    inline void Seek(const uint64_t& key) override {
+        ::hybridse::vm::Profiler::CountSeek();
+        it_->Seek(key);
+    }
+    inline void SeekToFirst() override {
+        ::hybridse::vm::Profiler::CountSeek();
+        it_->SeekToFirst();
+    }
+    inline bool IsSeekable() const override { return true; }
+
+    size_t GetBatch(::hybridse::codec::RowRef* batch, size_t max_size) override;
 
  private:
     TimeEntries::Iterator* it_;
@@ -76,10 +92,32 @@ class MemTableWindowIterator : public ::hybridse::vm::RowIterator {
     ::hybridse::codec::Row row_;
 };
 
+// Decompresses the rows of a kZstd table, the rows are copied out of the data blocks
+// so it does not gather them in batch
+class MemTableCompressedWindowIterator final : public ::hybridse::codec::RowIterator {
+ public:
+    MemTableCompressedWindowIterator(MemTableWindowIterator* it, const std::shared_ptr<RowCompressor>& compressor)
+        : it_(it), compressor_(compressor), row_() {}
+
+    inline bool Valid() const override { return it_->Valid(); }
+    inline void Next() override { it_->Next(); }
+    inline const uint64_t& GetKey() const override { return it_->GetKey(); }
+    const ::hybridse::codec::Row& GetValue() override;
+    inline void Seek(const uint64_t& key) override { it_->Seek(key); }
+    inline void SeekToFirst() override { it_->SeekToFirst(); }
+    inline bool IsSeekable() const override { return true; }
+
+ private:
+    std::unique_ptr<MemTableWindowIterator> it_;
+    std::shared_ptr<RowCompressor> compressor_;
+    ::hybridse::codec::Row row_;
+};
+
 class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
  public:
     MemTableKeyIterator(Segment** segments, uint32_t seg_cnt, ::openmldb::storage::TTLType ttl_type,
-                        uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index);
+                        uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index,
+                        const std::shared_ptr<RowCompressor>& compressor = std::shared_ptr<RowCompressor>());
 
     ~MemTableKeyIterator() override;
 
@@ -111,12 +149,14 @@ class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
     uint32_t ts_index_{};
     Ticket ticket_;
     uint32_t ts_idx_;
+    std::shared_ptr<RowCompressor> compressor_;
 };
 
 class MemTableTraverseIterator : public TableIterator {
  public:
     MemTableTraverseIterator(Segment** segments, uint32_t seg_cnt, ::openmldb::storage::TTLType ttl_type,
-                             uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index);
+                             uint64_t expire_time, uint64_t expire_cnt, uint32_t ts_index,
+                             const std::shared_ptr<RowCompressor>& compressor = std::shared_ptr<RowCompressor>());
     ~MemTableTraverseIterator() override;
     inline bool Valid() override;
     void Next() override;
@@ -142,6 +182,7 @@ class MemTableTraverseIterator : public TableIterator {
     TTLSt expire_value_;
     Ticket ticket_;
     uint64_t traverse_cnt_;
+    std::shared_ptr<RowCompressor> compressor_;
 };
 
 class MemTable : public Table {
@@ -176,6 +217,8 @@ class MemTable : public Table {
 
     ::hybridse::vm::WindowIterator* NewWindowIterator(uint32_t index);
 
+    TableIterator* NewRangeIterator(const ::hybridse::vm::ColumnRange& range) override;
+
     // release all memory allocated
     uint64_t Release();
 
@@ -184,14 +227,25 @@ class MemTable : public Table {
     int GetCount(uint32_t index, const std::string& pk,
                  uint64_t& count);  // NOLINT
 
+    bool GetKeyVersion(uint32_t idx, const std::string& pk, uint64_t* version) override;
+
     uint64_t GetRecordIdxCnt() override;
     bool GetRecordIdxCnt(uint32_t idx, uint64_t** stat, uint32_t* size) override;
     uint64_t GetRecordIdxByteSize() override;
     uint64_t GetRecordPkCnt() override;
 
+    bool GetIndexStats(uint32_t idx, uint32_t sample_cnt, uint64_t* pk_cnt, uint64_t* idx_cnt,
+                       std::vector<uint64_t>* key_counts) override;
+
     void SetCompressType(::openmldb::type::CompressType compress_type);
     ::openmldb::type::CompressType GetCompressType();
 
+    // true if it is a kZstd table without a dictionary and enough rows are put to train one,
+    // only returns true once for a record count
+    bool NeedTrainCompressDict();
+    // train a dictionary from at most `sample_cnt` rows, the rows put later are compressed with it
+    bool TrainCompressDict(uint32_t sample_cnt, uint32_t dict_size);
+
     inline uint64_t GetRecordByteSize() const override { return record_byte_size_.load(std::memory_order_relaxed); }
 
     uint64_t GetRecordCnt() const override { return record_cnt_.load(std::memory_order_relaxed); }
@@ -216,11 +270,23 @@ class MemTable : public Table {
 
     bool AddIndex(const ::openmldb::common::ColumnKey& column_key);
 
+    // Build the index `idx` added by AddIndex from the rows in memory. The segments of all the other indexes are
+    // scanned by `thread_num` threads, and the rows whose key of the new index is in this partition of
+    // `partition_num` are put into the new index sharing their data blocks. A row kept by several indexes or put
+    // concurrently is put once and gc is paused until it finishes. Returns false without putting any row if the
+    // index can not be built this way
+    bool BackfillIndex(uint32_t idx, uint32_t partition_num, uint32_t thread_num, uint64_t* put_cnt);
+
  private:
     bool CheckAbsolute(const TTLSt& ttl, uint64_t ts);
 
     bool CheckLatest(uint32_t index_id, const std::string& key, uint64_t ts);
 
+    // pack the keys of range indexes for `row`, the key of a null value is empty.
+    // `cnt` is the number of the keys not empty
+    bool PackRangeKeys(const codec::RowView& decoder, const int8_t* row, std::vector<std::string>* keys,
+                       uint32_t* cnt);
+
  private:
     uint32_t seg_cnt_;
     std::vector<Segment**> segments_;
@@ -230,6 +296,16 @@ class MemTable : public Table {
     bool segment_released_;
     std::atomic<uint64_t> record_byte_size_;
     uint32_t key_entry_max_height_;
+    std::shared_ptr<RowCompressor> compressor_;
+    // the record count to train the compress dict at
+    std::atomic<uint64_t> dict_train_threshold_;
+    // built in Init and not changed after
+    std::vector<std::shared_ptr<RangeIndex>> range_indexes_;
+    // held by gc and index backfill
+    std::mutex gc_mu_;
+    // the inner indexes whose segments deduplicate puts after a backfill, to the gc rounds run since.
+    // guarded by gc_mu_
+    std::map<uint32_t, uint32_t> dedupe_gc_rounds_;
 };
 
 }  // namespace storage
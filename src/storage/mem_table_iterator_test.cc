@@ -14,6 +14,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "codec/schema_codec.h"
 #include "codec/sdk_codec.h"
 #include "common/timer.h"
@@ -95,6 +100,144 @@ TEST_F(MemTableIteratorTest, latest) {
     ASSERT_EQ(3, cnt);
 }
 
+// put `row_cnt` rows of key card0 one minute apart, the latest one is at `now`
+void PutRows(MemTable* table, const ::openmldb::api::TableMeta& table_meta, uint64_t now, int row_cnt) {
+    codec::SDKCodec codec(table_meta);
+    for (int j = 0; j < row_cnt; j++) {
+        std::vector<std::string> row = {"card0", "mcc" + std::to_string(j), std::to_string(now - j * (60 * 1000))};
+        ::openmldb::api::PutRequest request;
+        ::openmldb::api::Dimension* dim = request.add_dimensions();
+        dim->set_idx(0);
+        dim->set_key("card0");
+        std::string value;
+        ASSERT_EQ(0, codec.EncodeRow(row, &value));
+        table->Put(0, value, request.dimensions());
+    }
+}
+
+::openmldb::api::TableMeta BuildTableMeta(::openmldb::type::TTLType ttl_type, uint64_t abs_ttl, uint64_t lat_ttl) {
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("table1");
+    table_meta.set_tid(1);
+    table_meta.set_pid(0);
+    table_meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+    table_meta.set_format_version(1);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "mcc", ::openmldb::type::kString);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts", ::openmldb::type::kBigInt);
+    codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts", ttl_type, abs_ttl, lat_ttl);
+    return table_meta;
+}
+
+// gather the rows of card0 with batches of `max_size` and return the size of every batch
+std::vector<size_t> GetBatches(MemTable* table, size_t max_size, std::vector<::hybridse::codec::RowRef>* rows) {
+    std::unique_ptr<::hybridse::vm::WindowIterator> it(table->NewWindowIterator(0));
+    it->Seek("card0");
+    std::vector<size_t> sizes;
+    if (!it->Valid()) {
+        return sizes;
+    }
+    std::unique_ptr<::hybridse::vm::RowIterator> wit = it->GetValue();
+    auto batch_it = dynamic_cast<::hybridse::codec::BatchRowIterator*>(wit.get());
+    if (batch_it == nullptr) {
+        return sizes;
+    }
+    wit->SeekToFirst();
+    std::vector<::hybridse::codec::RowRef> batch(max_size);
+    while (true) {
+        size_t cnt = batch_it->GetBatch(batch.data(), max_size);
+        sizes.push_back(cnt);
+        if (cnt == 0) {
+            break;
+        }
+        rows->insert(rows->end(), batch.begin(), batch.begin() + cnt);
+    }
+    return sizes;
+}
+
+TEST_F(MemTableIteratorTest, GetBatchAbsTTL) {
+    auto table_meta = BuildTableMeta(::openmldb::type::kAbsoluteTime, 10, 0);
+    MemTable table(table_meta);
+    table.Init();
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    PutRows(&table, table_meta, now, 100);
+    // the row at now - 10min is expired
+    std::vector<::hybridse::codec::RowRef> rows;
+    ASSERT_EQ(std::vector<size_t>({10, 0}), GetBatches(&table, 64, &rows));
+    ASSERT_EQ(10u, rows.size());
+    ASSERT_EQ(now - 9 * 60 * 1000, rows.back().key);
+    rows.clear();
+    ASSERT_EQ(std::vector<size_t>({4, 4, 2, 0}), GetBatches(&table, 4, &rows));
+    ASSERT_EQ(10u, rows.size());
+}
+
+TEST_F(MemTableIteratorTest, GetBatchLatTTL) {
+    auto table_meta = BuildTableMeta(::openmldb::type::kLatestTime, 0, 3);
+    MemTable table(table_meta);
+    table.Init();
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    PutRows(&table, table_meta, now, 100);
+    std::vector<::hybridse::codec::RowRef> rows;
+    ASSERT_EQ(std::vector<size_t>({3, 0}), GetBatches(&table, 64, &rows));
+    ASSERT_EQ(now, rows.front().key);
+    ASSERT_EQ(now - 2 * 60 * 1000, rows.back().key);
+    // expire_cnt across batches
+    rows.clear();
+    ASSERT_EQ(std::vector<size_t>({2, 1, 0}), GetBatches(&table, 2, &rows));
+    ASSERT_EQ(3u, rows.size());
+}
+
+TEST_F(MemTableIteratorTest, GetBatchAbsAndLatTTL) {
+    // rows expire only when both the abs and the lat ttl are exceeded
+    auto table_meta = BuildTableMeta(::openmldb::type::kAbsAndLat, 10, 20);
+    MemTable table(table_meta);
+    table.Init();
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    PutRows(&table, table_meta, now, 100);
+    std::vector<::hybridse::codec::RowRef> rows;
+    ASSERT_EQ(std::vector<size_t>({8, 8, 4, 0}), GetBatches(&table, 8, &rows));
+    // kAbsOrLat expires on either of them
+    auto or_meta = BuildTableMeta(::openmldb::type::kAbsOrLat, 10, 20);
+    MemTable or_table(or_meta);
+    or_table.Init();
+    PutRows(&or_table, or_meta, now, 100);
+    rows.clear();
+    ASSERT_EQ(std::vector<size_t>({8, 2, 0}), GetBatches(&or_table, 8, &rows));
+}
+
+TEST_F(MemTableIteratorTest, GetBatchSameAsNext) {
+    auto table_meta = BuildTableMeta(::openmldb::type::kAbsoluteTime, 0, 0);
+    MemTable table(table_meta);
+    table.Init();
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    PutRows(&table, table_meta, now, 100);
+    std::unique_ptr<::hybridse::vm::WindowIterator> it(table.NewWindowIterator(0));
+    it->Seek("card0");
+    ASSERT_TRUE(it->Valid());
+    std::unique_ptr<::hybridse::vm::RowIterator> wit = it->GetValue();
+    wit->SeekToFirst();
+    std::vector<std::pair<uint64_t, std::string>> expect;
+    while (wit->Valid()) {
+        expect.emplace_back(wit->GetKey(), wit->GetValue().ToString());
+        wit->Next();
+    }
+    ASSERT_EQ(100u, expect.size());
+    // a batch never exceeds max_size, a large max_size is capped by the iterator
+    for (size_t max_size : {1, 7, 64, 200}) {
+        std::vector<::hybridse::codec::RowRef> rows;
+        auto sizes = GetBatches(&table, max_size, &rows);
+        ASSERT_EQ(0u, sizes.back());
+        for (auto size : sizes) {
+            ASSERT_LE(size, std::min(max_size, static_cast<size_t>(64)));
+        }
+        ASSERT_EQ(expect.size(), rows.size());
+        for (size_t i = 0; i < rows.size(); i++) {
+            ASSERT_EQ(expect[i].first, rows[i].key);
+            ASSERT_EQ(expect[i].second, std::string(reinterpret_cast<const char*>(rows[i].buf), rows[i].size));
+        }
+    }
+}
+
 }  // namespace storage
 }  // namespace openmldb
 
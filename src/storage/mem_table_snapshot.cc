@@ -61,6 +61,31 @@ const std::string SNAPSHOT_SUBFIX = ".sdb";  // NOLINT
 const uint32_t KEY_NUM_DISPLAY = 1000000;    // NOLINT
 const std::string MANIFEST = "MANIFEST";     // NOLINT
 
+// `cols` are the ids of the key columns in the schema of `table_meta`
+static ::openmldb::codec::IndexKeyEncoder NewKeyEncoder(const ::openmldb::common::ColumnKey& column_key,
+                                                       const ::openmldb::api::TableMeta& table_meta,
+                                                       const std::vector<uint32_t>& cols) {
+    std::vector<::openmldb::type::DataType> types;
+    uint32_t base_size = table_meta.column_desc_size();
+    for (uint32_t col : cols) {
+        if (col < base_size) {
+            types.push_back(table_meta.column_desc(col).data_type());
+        } else {
+            types.push_back(table_meta.added_column_desc(col - base_size).data_type());
+        }
+    }
+    return ::openmldb::codec::IndexKeyEncoder(column_key.key_encoding(), types);
+}
+
+static bool EncodeIndexKey(const ::openmldb::codec::IndexKeyEncoder& encoder, const std::vector<std::string>& row,
+                           const std::vector<uint32_t>& cols, std::string* key) {
+    std::vector<std::string> values;
+    for (uint32_t col : cols) {
+        values.push_back(row[col]);
+    }
+    return encoder.Encode(values, key);
+}
+
 MemTableSnapshot::MemTableSnapshot(uint32_t tid, uint32_t pid, LogParts* log_part, const std::string& db_root_path)
     : Snapshot(tid, pid), log_part_(log_part), db_root_path_(db_root_path) {}
 
@@ -627,6 +652,8 @@ base::Status MemTableSnapshot::GetIndexKey(std::shared_ptr<Table> table,
         return base::Status(base::ReturnCode::kError, "schema version is not exist");
     }
     index_key->clear();
+    std::vector<std::string> values;
+    std::vector<::openmldb::type::DataType> types;
     for (const auto& col : index->GetColumns()) {
         if ((int32_t)col.GetId() >= schema->size()) {
             return base::Status(base::ReturnCode::kError, "cannot found col");
@@ -638,11 +665,12 @@ base::Status MemTableSnapshot::GetIndexKey(std::shared_ptr<Table> table,
         } else if (ret == 1) {
             val = ::openmldb::codec::NONETOKEN;
         }
-        if (index_key->empty()) {
-            *index_key = std::move(val);
-        } else {
-            *index_key += "|" + val;
-        }
+        values.push_back(std::move(val));
+        types.push_back(col.GetType());
+    }
+    ::openmldb::codec::IndexKeyEncoder encoder(index->GetKeyEncoding(), types);
+    if (!encoder.Encode(values, index_key)) {
+        return base::Status(base::ReturnCode::kError, "encode key error");
     }
     return {};
 }
@@ -786,9 +814,11 @@ int MemTableSnapshot::ExtractIndexFromSnapshot(std::shared_ptr<Table> table, con
                                                WriteHandle* wh, const ::openmldb::common::ColumnKey& column_key,
                                                uint32_t idx, uint32_t partition_num, uint32_t max_idx,
                                                const std::vector<uint32_t>& index_cols, uint64_t& count,
-                                               uint64_t& expired_key_num, uint64_t& deleted_key_num) {
+                                               uint64_t& expired_key_num, uint64_t& deleted_key_num,
+                                               bool load_memory) {
     uint32_t tid = table->GetId();
     uint32_t pid = table->GetPid();
+    auto key_encoder = NewKeyEncoder(column_key, *table->GetTableMeta(), index_cols);
     std::string full_path = snapshot_path_ + manifest.name();
     FILE* fd = fopen(full_path.c_str(), "rb");
     if (fd == NULL) {
@@ -879,14 +909,7 @@ int MemTableSnapshot::ExtractIndexFromSnapshot(std::shared_ptr<Table> table, con
                 continue;
             }
             std::string cur_key;
-            for (uint32_t i : index_cols) {
-                if (cur_key.empty()) {
-                    cur_key = row[i];
-                } else {
-                    cur_key += "|" + row[i];
-                }
-            }
-            if (cur_key.empty()) {
+            if (!EncodeIndexKey(key_encoder, row, index_cols, &cur_key) || cur_key.empty()) {
                 other_error_count++;
                 DLOG(INFO) << "skip empty key";
                 continue;
@@ -908,7 +931,9 @@ int MemTableSnapshot::ExtractIndexFromSnapshot(std::shared_ptr<Table> table, con
                 dim = entry.add_dimensions();
                 dim->set_key(cur_key);
                 dim->set_idx(idx);
-                table->Put(entry);
+                if (load_memory) {
+                    table->Put(entry);
+                }
                 extract_count++;
             }
         }
@@ -1189,7 +1214,8 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table,
 }
 
 int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::openmldb::common::ColumnKey& column_key,
-                                       uint32_t idx, uint32_t partition_num, uint64_t& out_offset) {
+                                       uint32_t idx, uint32_t partition_num, uint64_t& out_offset,
+                                       bool load_memory) {
     uint32_t tid = table->GetId();
     uint32_t pid = table->GetPid();
     if (making_snapshot_.exchange(true, std::memory_order_consume)) {
@@ -1246,12 +1272,13 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
             return -1;
         }
     }
+    auto key_encoder = NewKeyEncoder(column_key, *table_meta, index_cols);
 
     int result = GetLocalManifest(snapshot_path_ + MANIFEST, manifest);
     if (result == 0) {
         DLOG(INFO) << "begin extract index data from snapshot";
         if (ExtractIndexFromSnapshot(table, manifest, wh, column_key, idx, partition_num, max_idx, index_cols,
-                                     write_count, expired_key_num, deleted_key_num) < 0) {
+                                     write_count, expired_key_num, deleted_key_num, load_memory) < 0) {
             has_error = true;
         }
         last_term = manifest.term();
@@ -1349,14 +1376,7 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
                     continue;
                 }
                 std::string cur_key;
-                for (uint32_t i : index_cols) {
-                    if (cur_key.empty()) {
-                        cur_key = row[i];
-                    } else {
-                        cur_key += "|" + row[i];
-                    }
-                }
-                if (cur_key.empty()) {
+                if (!EncodeIndexKey(key_encoder, row, index_cols, &cur_key) || cur_key.empty()) {
                     DLOG(INFO) << "skip empty key";
                     continue;
                 }
@@ -1376,7 +1396,9 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
                     dim = entry.add_dimensions();
                     dim->set_key(cur_key);
                     dim->set_idx(idx);
-                    table->Put(entry);
+                    if (load_memory) {
+                        table->Put(entry);
+                    }
                     extract_count++;
                 }
             }
@@ -1456,7 +1478,9 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
 }
 
 bool MemTableSnapshot::PackNewIndexEntry(std::shared_ptr<Table> table,
-                                         const std::vector<std::vector<uint32_t>>& index_cols, uint32_t max_idx,
+                                         const std::vector<std::vector<uint32_t>>& index_cols,
+                                         const std::vector<::openmldb::codec::IndexKeyEncoder>& key_encoders,
+                                         uint32_t max_idx,
                                          uint32_t idx, uint32_t partition_num, ::openmldb::api::LogEntry* entry,
                                          uint32_t* index_pid) {
     if (entry->dimensions_size() == 0) {
@@ -1495,16 +1519,11 @@ bool MemTableSnapshot::PackNewIndexEntry(std::shared_ptr<Table> table,
                 skip_calc = true;
                 break;
             }
-            if (cur_key.empty()) {
-                cur_key = row[j];
-            } else {
-                cur_key += "|" + row[j];
-            }
         }
         if (skip_calc) {
             continue;
         }
-        if (cur_key.empty()) {
+        if (!EncodeIndexKey(key_encoders[i], row, index_cols[i], &cur_key) || cur_key.empty()) {
             DLOG(INFO) << "key is emptry";
             continue;
         }
@@ -1533,7 +1552,9 @@ bool MemTableSnapshot::PackNewIndexEntry(std::shared_ptr<Table> table,
 }
 
 bool MemTableSnapshot::DumpSnapshotIndexData(std::shared_ptr<Table> table,
-                                             const std::vector<std::vector<uint32_t>>& index_cols, uint32_t max_idx,
+                                             const std::vector<std::vector<uint32_t>>& index_cols,
+                                             const std::vector<::openmldb::codec::IndexKeyEncoder>& key_encoders,
+                                             uint32_t max_idx,
                                              uint32_t idx, const std::vector<::openmldb::log::WriteHandle*>& whs,
                                              uint64_t* snapshot_offset) {
     uint32_t partition_num = whs.size();
@@ -1583,7 +1604,7 @@ bool MemTableSnapshot::DumpSnapshotIndexData(std::shared_ptr<Table> table,
             continue;
         }
         uint32_t index_pid = 0;
-        if (!PackNewIndexEntry(table, index_cols, max_idx, idx, partition_num, &entry, &index_pid)) {
+        if (!PackNewIndexEntry(table, index_cols, key_encoders, max_idx, idx, partition_num, &entry, &index_pid)) {
             DLOG(INFO) << "pack new entry fail in snapshot";
             continue;
         }
@@ -1623,6 +1644,7 @@ bool MemTableSnapshot::DumpIndexData(std::shared_ptr<Table> table, const ::openm
         column_desc_map.insert(std::make_pair(table_meta->added_column_desc(i).name(), i + base_size));
     }
     std::vector<std::vector<uint32_t>> index_cols;
+    std::vector<::openmldb::codec::IndexKeyEncoder> key_encoders;
     uint32_t max_idx = 0;
     for (const auto& ck : table_meta->column_key()) {
         std::vector<uint32_t> cols;
@@ -1642,6 +1664,7 @@ bool MemTableSnapshot::DumpIndexData(std::shared_ptr<Table> table, const ::openm
                 return false;
             }
         }
+        key_encoders.push_back(NewKeyEncoder(ck, *table_meta, cols));
         index_cols.push_back(cols);
     }
     std::vector<uint32_t> cols;
@@ -1658,12 +1681,13 @@ bool MemTableSnapshot::DumpIndexData(std::shared_ptr<Table> table, const ::openm
             return false;
         }
     }
+    key_encoders.push_back(NewKeyEncoder(column_key, *table_meta, cols));
     index_cols.push_back(cols);
     uint64_t collected_offset = CollectDeletedKey(0);
     uint64_t snapshot_offset = 0;
     bool ret = true;
-    if (!DumpSnapshotIndexData(table, index_cols, max_idx, idx, whs, &snapshot_offset) ||
-        !DumpBinlogIndexData(table, index_cols, max_idx, idx, whs, snapshot_offset, collected_offset)) {
+    if (!DumpSnapshotIndexData(table, index_cols, key_encoders, max_idx, idx, whs, &snapshot_offset) ||
+        !DumpBinlogIndexData(table, index_cols, key_encoders, max_idx, idx, whs, snapshot_offset, collected_offset)) {
         ret = false;
     }
     making_snapshot_.store(false, std::memory_order_release);
@@ -1671,7 +1695,9 @@ bool MemTableSnapshot::DumpIndexData(std::shared_ptr<Table> table, const ::openm
 }
 
 bool MemTableSnapshot::DumpBinlogIndexData(std::shared_ptr<Table> table,
-                                           const std::vector<std::vector<uint32_t>>& index_cols, uint32_t max_idx,
+                                           const std::vector<std::vector<uint32_t>>& index_cols,
+                                           const std::vector<::openmldb::codec::IndexKeyEncoder>& key_encoders,
+                                           uint32_t max_idx,
                                            uint32_t idx, const std::vector<::openmldb::log::WriteHandle*>& whs,
                                            uint64_t snapshot_offset, uint64_t collected_offset) {
     ::openmldb::log::LogReader log_reader(log_part_, log_path_, false);
@@ -1738,7 +1764,7 @@ bool MemTableSnapshot::DumpBinlogIndexData(std::shared_ptr<Table> table,
                   cur_offset, entry.log_index(), tid_, pid_);
         }
         uint32_t index_pid = 0;
-        if (!PackNewIndexEntry(table, index_cols, max_idx, idx, partition_num, &entry, &index_pid)) {
+        if (!PackNewIndexEntry(table, index_cols, key_encoders, max_idx, idx, partition_num, &entry, &index_pid)) {
             LOG(INFO) << "pack new entry fail in binlog";
             continue;
         }
@@ -1756,6 +1782,133 @@ bool MemTableSnapshot::DumpBinlogIndexData(std::shared_ptr<Table> table,
     return true;
 }
 
+bool MemTableSnapshot::DumpSplitData(std::shared_ptr<Table> table,
+                                     const std::function<bool(const ::openmldb::api::LogEntry&)>& fun,
+                                     const std::function<int(uint64_t)>& caught_up) {
+    if (making_snapshot_.exchange(true, std::memory_order_consume)) {
+        PDLOG(INFO, "snapshot is doing now. tid %u, pid %u", tid_, pid_);
+        return false;
+    }
+    // no snapshot is made until the dump finishes, so the binlog after the snapshot is kept
+    uint64_t snapshot_offset = 0;
+    bool ret = DumpSnapshotSplitData(fun, &snapshot_offset) && DumpBinlogSplitData(fun, caught_up, snapshot_offset);
+    making_snapshot_.store(false, std::memory_order_release);
+    return ret;
+}
+
+bool MemTableSnapshot::DumpSnapshotSplitData(const std::function<bool(const ::openmldb::api::LogEntry&)>& fun,
+                                             uint64_t* snapshot_offset) {
+    ::openmldb::api::Manifest manifest;
+    manifest.set_offset(0);
+    int ret = GetLocalManifest(snapshot_path_ + MANIFEST, manifest);
+    if (ret == -1) {
+        return false;
+    } else if (ret == 1) {
+        *snapshot_offset = 0;
+        return true;
+    }
+    *snapshot_offset = manifest.offset();
+    std::string path = snapshot_path_ + "/" + manifest.name();
+    FILE* fd = fopen(path.c_str(), "rb");
+    if (fd == NULL) {
+        PDLOG(WARNING, "fail to open path %s for error %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFile(path, fd);
+    bool compressed = IsCompressed(path);
+    ::openmldb::log::Reader reader(seq_file, NULL, false, 0, compressed);
+    ::openmldb::api::LogEntry entry;
+    std::string buffer;
+    uint64_t succ_cnt = 0;
+    uint64_t failed_cnt = 0;
+    bool ok = true;
+    while (true) {
+        buffer.clear();
+        ::openmldb::base::Slice record;
+        ::openmldb::log::Status status = reader.ReadRecord(&record, &buffer);
+        if (status.IsWaitRecord() || status.IsEof()) {
+            break;
+        }
+        if (!status.ok() || !entry.ParseFromArray(record.data(), record.size())) {
+            PDLOG(WARNING, "fail to read record for tid %u, pid %u with error %s", tid_, pid_,
+                  status.ToString().c_str());
+            failed_cnt++;
+            continue;
+        }
+        if (!fun(entry)) {
+            ok = false;
+            break;
+        }
+        succ_cnt++;
+    }
+    delete seq_file;
+    PDLOG(INFO, "dump split data from snapshot %s. tid %u pid %u succ_cnt %lu failed_cnt %lu", path.c_str(), tid_,
+          pid_, succ_cnt, failed_cnt);
+    return ok;
+}
+
+bool MemTableSnapshot::DumpBinlogSplitData(const std::function<bool(const ::openmldb::api::LogEntry&)>& fun,
+                                           const std::function<int(uint64_t)>& caught_up, uint64_t snapshot_offset) {
+    ::openmldb::log::LogReader log_reader(log_part_, log_path_, false);
+    log_reader.SetOffset(snapshot_offset);
+    uint64_t cur_offset = snapshot_offset;
+    int last_log_index = log_reader.GetLogIndex();
+    ::openmldb::api::LogEntry entry;
+    std::string buffer;
+    uint64_t succ_cnt = 0;
+    while (true) {
+        buffer.clear();
+        ::openmldb::base::Slice record;
+        ::openmldb::log::Status status = log_reader.ReadNextRecord(&record, &buffer);
+        if (status.IsWaitRecord() || status.IsEof()) {
+            int end_log_index = log_reader.GetEndLogIndex();
+            int cur_log_index = log_reader.GetLogIndex();
+            if (status.IsWaitRecord() && end_log_index >= 0 && end_log_index > cur_log_index) {
+                log_reader.RollRLogFile();
+                continue;
+            }
+            if (status.IsEof() && cur_log_index != last_log_index) {
+                last_log_index = cur_log_index;
+                continue;
+            }
+            int ret = caught_up(cur_offset);
+            if (ret < 0) {
+                PDLOG(WARNING, "fail to catch up binlog. tid %u pid %u offset %lu", tid_, pid_, cur_offset);
+                return false;
+            } else if (ret == 0) {
+                break;
+            }
+            continue;
+        }
+        if (!status.ok()) {
+            PDLOG(WARNING, "fail to read binlog for tid %u, pid %u with error %s", tid_, pid_,
+                  status.ToString().c_str());
+            return false;
+        }
+        if (!entry.ParseFromArray(record.data(), record.size())) {
+            PDLOG(WARNING, "fail parse record for tid %u, pid %u", tid_, pid_);
+            return false;
+        }
+        if (cur_offset >= entry.log_index()) {
+            continue;
+        }
+        if (cur_offset + 1 != entry.log_index()) {
+            // a gap would lose the entries in the new partition
+            PDLOG(WARNING, "missing log entry cur_offset %lu , new entry offset %lu for tid %u, pid %u", cur_offset,
+                  entry.log_index(), tid_, pid_);
+            return false;
+        }
+        if (!fun(entry)) {
+            return false;
+        }
+        cur_offset = entry.log_index();
+        succ_cnt++;
+    }
+    PDLOG(INFO, "dump split data from binlog. tid %u pid %u offset %lu succ_cnt %lu", tid_, pid_, cur_offset,
+          succ_cnt);
+    return true;
+}
+
 int MemTableSnapshot::DecodeData(std::shared_ptr<Table> table, const openmldb::api::LogEntry& entry, uint32_t max_idx,
                                  std::vector<std::string>& row) {
     std::string buff;
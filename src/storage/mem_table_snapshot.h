@@ -17,6 +17,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -24,6 +25,7 @@
 #include <vector>
 
 #include "base/status.h"
+#include "codec/index_key_codec.h"
 #include "codec/schema_codec.h"
 #include "log/log_reader.h"
 #include "log/log_writer.h"
@@ -87,19 +89,22 @@ class MemTableSnapshot : public Snapshot {
                                  uint32_t idx, uint32_t partition_num, uint32_t max_idx,
                                  const std::vector<uint32_t>& index_cols,
                                  uint64_t& count,                                        // NOLINT
-                                 uint64_t& expired_key_num, uint64_t& deleted_key_num);  // NOLINT
+                                 uint64_t& expired_key_num, uint64_t& deleted_key_num,   // NOLINT
+                                 bool load_memory);
 
     bool DumpSnapshotIndexData(std::shared_ptr<Table> table, const std::vector<std::vector<uint32_t>>& index_cols,
-                               uint32_t max_idx, uint32_t idx, const std::vector<::openmldb::log::WriteHandle*>& whs,
+                               const std::vector<::openmldb::codec::IndexKeyEncoder>& key_encoders, uint32_t max_idx, uint32_t idx, const std::vector<::openmldb::log::WriteHandle*>& whs,
                                uint64_t* snapshot_offset);
 
     bool DumpBinlogIndexData(std::shared_ptr<Table> table, const std::vector<std::vector<uint32_t>>& index_cols,
-                             uint32_t max_idx, uint32_t idx, const std::vector<::openmldb::log::WriteHandle*>& whs,
+                             const std::vector<::openmldb::codec::IndexKeyEncoder>& key_encoders, uint32_t max_idx, uint32_t idx, const std::vector<::openmldb::log::WriteHandle*>& whs,
                              uint64_t snapshot_offset, uint64_t collected_offset);
 
+    // rewrite the snapshot with the keys of the new index, the rows of this partition are put into the index in
+    // memory as well unless `load_memory` is false, e.g. they are backfilled by MemTable::BackfillIndex
     int ExtractIndexData(std::shared_ptr<Table> table, const ::openmldb::common::ColumnKey& column_key, uint32_t idx,
                          uint32_t partition_num,
-                         uint64_t& out_offset);  // NOLINT
+                         uint64_t& out_offset, bool load_memory = true);  // NOLINT
 
     int ExtractIndexData(std::shared_ptr<Table> table, const std::vector<::openmldb::common::ColumnKey>& column_key,
                         uint32_t partition_num, uint64_t* out_offset);
@@ -107,8 +112,15 @@ class MemTableSnapshot : public Snapshot {
     bool DumpIndexData(std::shared_ptr<Table> table, const ::openmldb::common::ColumnKey& column_key, uint32_t idx,
                        const std::vector<::openmldb::log::WriteHandle*>& whs);
 
+    // Pass the entries of the snapshot and the binlog to `fun` in the log order. Once the binlog is read
+    // to the end, `caught_up` is called with the offset of the last entry passed. Reading goes on while it
+    // returns a positive value, it finishes on 0 and fails on a negative value
+    bool DumpSplitData(std::shared_ptr<Table> table, const std::function<bool(const ::openmldb::api::LogEntry&)>& fun,
+                       const std::function<int(uint64_t)>& caught_up);
+
+    // `key_encoders` are the key encoders of the indexes in `index_cols`
     bool PackNewIndexEntry(std::shared_ptr<Table> table, const std::vector<std::vector<uint32_t>>& index_cols,
-                           uint32_t max_idx, uint32_t idx, uint32_t partition_num, ::openmldb::api::LogEntry* entry,
+                           const std::vector<::openmldb::codec::IndexKeyEncoder>& key_encoders, uint32_t max_idx, uint32_t idx, uint32_t partition_num, ::openmldb::api::LogEntry* entry,
                            uint32_t* index_pid);
 
     int RemoveDeletedKey(const ::openmldb::api::LogEntry& entry, const std::set<uint32_t>& deleted_index,
@@ -121,6 +133,12 @@ class MemTableSnapshot : public Snapshot {
 
     uint64_t CollectDeletedKey(uint64_t end_offset);
 
+    bool DumpSnapshotSplitData(const std::function<bool(const ::openmldb::api::LogEntry&)>& fun,
+                               uint64_t* snapshot_offset);
+
+    bool DumpBinlogSplitData(const std::function<bool(const ::openmldb::api::LogEntry&)>& fun,
+                             const std::function<int(uint64_t)>& caught_up, uint64_t snapshot_offset);
+
     int DecodeData(std::shared_ptr<Table> table, const openmldb::api::LogEntry& entry, uint32_t maxIdx,
                    std::vector<std::string>& row);  // NOLINT
 
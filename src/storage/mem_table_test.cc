@@ -0,0 +1,149 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/mem_table.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/hash.h"
+#include "codec/schema_codec.h"
+#include "codec/sdk_codec.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace storage {
+
+class MemTableTest : public ::testing::Test {};
+
+static ::openmldb::api::TableMeta CreateTableMeta(uint32_t pid) {
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("t1");
+    table_meta.set_tid(1);
+    table_meta.set_pid(pid);
+    table_meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+    table_meta.set_format_version(1);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "mcc", ::openmldb::type::kString);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts", ::openmldb::type::kBigInt);
+    codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts", ::openmldb::type::kAbsoluteTime,
+                                 0, 0);
+    return table_meta;
+}
+
+static void PutRows(MemTable* table, codec::SDKCodec* codec, int start, int end, bool put_mcc) {
+    for (int i = start; i < end; i++) {
+        std::vector<std::string> row = {"card" + std::to_string(i % 7), "mcc" + std::to_string(i % 10),
+                                        std::to_string(1000 + i)};
+        ::openmldb::api::PutRequest request;
+        ::openmldb::api::Dimension* dim = request.add_dimensions();
+        dim->set_idx(0);
+        dim->set_key(row[0]);
+        if (put_mcc) {
+            dim = request.add_dimensions();
+            dim->set_idx(1);
+            dim->set_key(row[1]);
+        }
+        std::string value;
+        ASSERT_EQ(0, codec->EncodeRow(row, &value));
+        ASSERT_TRUE(table->Put(0, value, request.dimensions()));
+    }
+}
+
+static uint64_t CountKey(MemTable* table, uint32_t idx, const std::string& key) {
+    Ticket ticket;
+    std::unique_ptr<TableIterator> it(table->NewIterator(idx, key, ticket));
+    uint64_t cnt = 0;
+    it->SeekToFirst();
+    while (it->Valid()) {
+        cnt++;
+        it->Next();
+    }
+    return cnt;
+}
+
+TEST_F(MemTableTest, BackfillIndex) {
+    for (uint32_t partition_num : {1, 2}) {
+        auto table_meta = CreateTableMeta(0);
+        MemTable table(table_meta);
+        ASSERT_TRUE(table.Init());
+        codec::SDKCodec codec(table_meta);
+        PutRows(&table, &codec, 0, 100, false);
+
+        ::openmldb::common::ColumnKey column_key;
+        codec::SchemaCodec::SetIndex(&column_key, "mcc", "mcc", "ts", ::openmldb::type::kAbsoluteTime, 0, 0);
+        ASSERT_TRUE(table.AddIndex(column_key));
+        // the rows put after the index is added are in the new index already
+        PutRows(&table, &codec, 100, 120, true);
+        uint64_t put_cnt = 0;
+        ASSERT_TRUE(table.BackfillIndex(1, partition_num, 4, &put_cnt));
+        uint64_t expect_put_cnt = 0;
+        for (int i = 0; i < 10; i++) {
+            std::string key = "mcc" + std::to_string(i);
+            uint32_t index_pid = ::openmldb::base::hash64(key) % partition_num;
+            if (index_pid == 0) {
+                expect_put_cnt += 10;
+                ASSERT_EQ(12u, CountKey(&table, 1, key));
+            } else {
+                ASSERT_EQ(2u, CountKey(&table, 1, key));
+            }
+        }
+        ASSERT_EQ(expect_put_cnt, put_cnt);
+        ASSERT_EQ(120u, table.GetRecordCnt());
+        // nothing more to put
+        ASSERT_TRUE(table.BackfillIndex(1, partition_num, 2, &put_cnt));
+        ASSERT_EQ(0u, put_cnt);
+        // the primary index and the index not exist
+        ASSERT_FALSE(table.BackfillIndex(0, partition_num, 4, &put_cnt));
+        ASSERT_FALSE(table.BackfillIndex(2, partition_num, 4, &put_cnt));
+    }
+}
+
+TEST_F(MemTableTest, BackfillIndexShorterPrimaryTTL) {
+    auto table_meta = CreateTableMeta(0);
+    // the primary index keeps only the latest row of each card, the mcc index keeps all the rows
+    table_meta.mutable_column_key(0)->mutable_ttl()->set_ttl_type(::openmldb::type::kLatestTime);
+    table_meta.mutable_column_key(0)->mutable_ttl()->set_lat_ttl(1);
+    codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "mcc", "mcc", "ts", ::openmldb::type::kAbsoluteTime, 0,
+                                 0);
+    MemTable table(table_meta);
+    ASSERT_TRUE(table.Init());
+    codec::SDKCodec codec(table_meta);
+    PutRows(&table, &codec, 0, 100, true);
+    table.SchedGc();
+    ASSERT_EQ(1u, CountKey(&table, 0, "card0"));
+    ASSERT_EQ(10u, CountKey(&table, 1, "mcc0"));
+
+    ::openmldb::common::ColumnKey column_key;
+    codec::SchemaCodec::SetIndex(&column_key, "card_mcc", "card|mcc", "ts", ::openmldb::type::kAbsoluteTime, 0, 0);
+    ASSERT_TRUE(table.AddIndex(column_key));
+    uint64_t put_cnt = 0;
+    ASSERT_TRUE(table.BackfillIndex(2, 1, 4, &put_cnt));
+    // the rows expired from the primary index are backfilled from the mcc index, each of them once
+    ASSERT_EQ(100u, put_cnt);
+    // the rows 0 and 70
+    ASSERT_EQ(2u, CountKey(&table, 2, "card0|mcc0"));
+    ASSERT_EQ(100u, table.GetRecordCnt());
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/range_index.h"
+
+#include "base/glog_wapper.h"
+#include "base/hash.h"
+#include "codec/index_key_codec.h"
+#include "gflags/gflags.h"
+#include "storage/record.h"
+
+DECLARE_uint32(gc_deleted_pk_version_delta);
+DECLARE_uint32(key_entry_max_height);
+
+namespace openmldb {
+namespace storage {
+
+// the same as MemTable, which picks the segment of a key
+static const uint32_t SEED = 0xe17a1465;
+// the big endian sequence number after the packed value
+static constexpr uint32_t SEQ_SIZE = 8;
+// the time of the row in the primary index after the sequence number, and the size of the primary key at the end.
+// They never take part in the order as the sequence numbers are unique
+static constexpr uint32_t TS_SIZE = 8;
+static constexpr uint32_t PK_LEN_SIZE = 4;
+
+static inline uint32_t GetPkSize(const Slice& key) {
+    uint32_t pk_size = 0;
+    memcpy(&pk_size, key.data() + key.size() - PK_LEN_SIZE, PK_LEN_SIZE);
+    return pk_size;
+}
+
+// the size of the packed value in the key of an entry
+static inline uint32_t GetValueSize(const Slice& key) {
+    return key.size() - PK_LEN_SIZE - GetPkSize(key) - TS_SIZE - SEQ_SIZE;
+}
+
+bool PrimaryIndexView::IsAlive(const Slice& pk, uint64_t ts, const DataBlock* block) const {
+    uint32_t seg_idx = 0;
+    if (seg_cnt > 1) {
+        seg_idx = ::openmldb::base::hash(pk.data(), pk.size(), SEED) % seg_cnt;
+    }
+    Ticket ticket;
+    std::unique_ptr<MemTableIterator> it(ts_col >= 0 ? segments[seg_idx]->NewIterator(pk, ts_col, ticket)
+                                                     : segments[seg_idx]->NewIterator(pk, ticket));
+    // the rank of the row in its key only matters to the latest ttl, which keeps a few rows
+    uint32_t record_idx = 1;
+    if (expire_value.ttl_type != TTLType::kAbsoluteTime && expire_value.lat_ttl > 0) {
+        it->SeekToFirst();
+        for (; it->Valid() && record_idx <= expire_value.lat_ttl; it->Next(), record_idx++) {
+            if (it->GetValue().data() == block->data) {
+                return !expire_value.IsExpired(ts, record_idx);
+            }
+        }
+    }
+    if (expire_value.IsExpired(ts, record_idx)) {
+        return false;
+    }
+    // the row may be deleted from the primary index
+    it->Seek(ts);
+    for (; it->Valid() && it->GetKey() == ts; it->Next()) {
+        if (it->GetValue().data() == block->data) {
+            return true;
+        }
+    }
+    return false;
+}
+
+RangeIndex::RangeIndex(const std::string& name, uint32_t col_idx, ::openmldb::type::DataType type)
+    : name_(name), col_idx_(col_idx), type_(type), seq_(0), idx_cnt_(0), gc_version_(0) {
+    SliceComparator cmp;
+    entries_ = new RangeEntries(FLAGS_key_entry_max_height, 4, cmp);
+    entry_free_list_ = new RangeEntryNodeList(4, 4, tcmp);
+}
+
+RangeIndex::~RangeIndex() {
+    Release();
+    delete entries_;
+    delete entry_free_list_;
+}
+
+int RangeIndex::PackKey(const codec::RowView& decoder, const int8_t* row, std::string* key) const {
+    return codec::RangeKeyCodec::PackRow(decoder, row, col_idx_, type_, key);
+}
+
+void RangeIndex::Put(const std::string& key, const Slice& pk, uint64_t ts, DataBlock* block) {
+    uint64_t seq = seq_.fetch_add(1, std::memory_order_relaxed);
+    uint32_t pk_size = pk.size();
+    uint32_t size = key.size() + SEQ_SIZE + TS_SIZE + pk_size + PK_LEN_SIZE;
+    // need to delete memory when free node
+    char* data = new char[size];
+    char* cur = data;
+    memcpy(cur, key.data(), key.size());
+    cur += key.size();
+    for (uint32_t i = 0; i < SEQ_SIZE; i++) {
+        cur[SEQ_SIZE - 1 - i] = static_cast<char>(seq >> (i * 8));
+    }
+    cur += SEQ_SIZE;
+    memcpy(cur, &ts, TS_SIZE);
+    cur += TS_SIZE;
+    memcpy(cur, pk.data(), pk_size);
+    cur += pk_size;
+    memcpy(cur, &pk_size, PK_LEN_SIZE);
+    Slice skey(data, size);
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        entries_->Insert(skey, block);
+    }
+    idx_cnt_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RangeIndex::Gc(uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size) {
+    gc_version_++;
+    RangeEntries::Iterator* it = entries_->NewIterator();
+    it->SeekToFirst();
+    while (it->Valid()) {
+        DataBlock* block = it->GetValue();
+        Slice key = it->GetKey();
+        // move on before the node is unlinked
+        it->Next();
+        if (block->dim_cnt_down > block->range_ref_cnt) {
+            continue;
+        }
+        ::openmldb::base::Node<Slice, DataBlock*>* node = NULL;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            node = entries_->Remove(key);
+        }
+        if (node == NULL) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(gc_mu_);
+            entry_free_list_->Insert(gc_version_, node);
+        }
+        gc_idx_cnt++;
+        idx_cnt_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    delete it;
+    if (gc_version_ < FLAGS_gc_deleted_pk_version_delta) {
+        return;
+    }
+    ::openmldb::base::Node<uint64_t, ::openmldb::base::Node<Slice, DataBlock*>*>* node = NULL;
+    {
+        std::lock_guard<std::mutex> lock(gc_mu_);
+        node = entry_free_list_->Split(gc_version_ - FLAGS_gc_deleted_pk_version_delta);
+    }
+    FreeList(node, gc_record_cnt, gc_record_byte_size);
+}
+
+void RangeIndex::FreeBlock(DataBlock* block, uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size) {
+    // Avoid double free
+    if (block->dim_cnt_down > 1) {
+        block->dim_cnt_down--;
+        block->range_ref_cnt--;
+    } else {
+        gc_record_byte_size += GetRecordSize(block->size);
+        delete block;
+        gc_record_cnt++;
+    }
+}
+
+void RangeIndex::FreeList(::openmldb::base::Node<uint64_t, ::openmldb::base::Node<Slice, DataBlock*>*>* node,
+                          uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size) {
+    while (node != NULL) {
+        ::openmldb::base::Node<Slice, DataBlock*>* entry_node = node->GetValue();
+        delete[] entry_node->GetKey().data();
+        FreeBlock(entry_node->GetValue(), gc_record_cnt, gc_record_byte_size);
+        delete entry_node;
+        ::openmldb::base::Node<uint64_t, ::openmldb::base::Node<Slice, DataBlock*>*>* tmp = node;
+        node = node->GetNextNoBarrier(0);
+        delete tmp;
+    }
+}
+
+uint64_t RangeIndex::Release() {
+    uint64_t cnt = 0;
+    uint64_t gc_record_cnt = 0;
+    uint64_t gc_record_byte_size = 0;
+    RangeEntries::Iterator* it = entries_->NewIterator();
+    it->SeekToFirst();
+    while (it->Valid()) {
+        delete[] it->GetKey().data();
+        FreeBlock(it->GetValue(), gc_record_cnt, gc_record_byte_size);
+        cnt++;
+        it->Next();
+    }
+    delete it;
+    entries_->Clear();
+    idx_cnt_.store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(gc_mu_);
+    RangeEntryNodeList::Iterator* f_it = entry_free_list_->NewIterator();
+    f_it->SeekToFirst();
+    while (f_it->Valid()) {
+        ::openmldb::base::Node<Slice, DataBlock*>* entry_node = f_it->GetValue();
+        delete[] entry_node->GetKey().data();
+        FreeBlock(entry_node->GetValue(), gc_record_cnt, gc_record_byte_size);
+        delete entry_node;
+        f_it->Next();
+    }
+    delete f_it;
+    entry_free_list_->Clear();
+    return cnt;
+}
+
+TableIterator* RangeIndex::NewIterator(const std::string& lower, bool lower_inclusive, const std::string& upper,
+                                       bool upper_inclusive, const PrimaryIndexView& primary,
+                                       const std::shared_ptr<RowCompressor>& compressor) {
+    return new RangeIndexIterator(entries_->NewIterator(), lower, lower_inclusive, upper, upper_inclusive, primary,
+                                  compressor);
+}
+
+RangeIndexIterator::RangeIndexIterator(RangeEntries::Iterator* it, const std::string& lower, bool lower_inclusive,
+                                       const std::string& upper, bool upper_inclusive,
+                                       const PrimaryIndexView& primary,
+                                       const std::shared_ptr<RowCompressor>& compressor)
+    : it_(it),
+      lower_(lower),
+      lower_inclusive_(lower_inclusive),
+      upper_(upper),
+      upper_inclusive_(upper_inclusive),
+      primary_(primary),
+      compressor_(compressor) {}
+
+RangeIndexIterator::~RangeIndexIterator() { delete it_; }
+
+void RangeIndexIterator::SeekToFirst() {
+    if (lower_.empty()) {
+        it_->SeekToFirst();
+    } else if (lower_inclusive_) {
+        it_->Seek(Slice(lower_));
+    } else {
+        // skip all the sequence numbers of the lower value
+        std::string key = lower_ + std::string(SEQ_SIZE, '\xff');
+        it_->Seek(Slice(key));
+    }
+    SkipExpired();
+}
+
+bool RangeIndexIterator::InRange() const {
+    if (!it_->Valid()) {
+        return false;
+    }
+    if (upper_.empty()) {
+        return true;
+    }
+    const Slice& key = it_->GetKey();
+    int ret = Slice(key.data(), GetValueSize(key)).compare(Slice(upper_));
+    return upper_inclusive_ ? ret <= 0 : ret < 0;
+}
+
+void RangeIndexIterator::SkipExpired() {
+    if (primary_.segments == nullptr) {
+        return;
+    }
+    for (; InRange(); it_->Next()) {
+        const Slice& key = it_->GetKey();
+        uint32_t pk_size = GetPkSize(key);
+        const char* pk = key.data() + key.size() - PK_LEN_SIZE - pk_size;
+        uint64_t ts = 0;
+        memcpy(&ts, pk - TS_SIZE, TS_SIZE);
+        if (primary_.IsAlive(Slice(pk, pk_size), ts, it_->GetValue())) {
+            return;
+        }
+    }
+}
+
+bool RangeIndexIterator::Valid() { return InRange(); }
+
+void RangeIndexIterator::Next() {
+    it_->Next();
+    SkipExpired();
+}
+
+openmldb::base::Slice RangeIndexIterator::GetValue() const {
+    openmldb::base::Slice value(it_->GetValue()->data, it_->GetValue()->size);
+    if (compressor_ && !compressor_->Decompress(value.data(), value.size(), &value)) {
+        PDLOG(WARNING, "fail to decompress row");
+        return openmldb::base::Slice();
+    }
+    return value;
+}
+
+std::string RangeIndexIterator::GetPK() const {
+    const Slice& key = it_->GetKey();
+    return std::string(key.data(), GetValueSize(key));
+}
+
+uint64_t RangeIndexIterator::GetKey() const {
+    const Slice& key = it_->GetKey();
+    uint32_t value_size = GetValueSize(key);
+    uint64_t seq = 0;
+    for (uint32_t i = value_size; i < value_size + SEQ_SIZE; i++) {
+        seq = (seq << 8) | static_cast<uint8_t>(key.data()[i]);
+    }
+    return seq;
+}
+
+}  // namespace storage
+}  // namespace openmldb
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STORAGE_RANGE_INDEX_H_
+#define SRC_STORAGE_RANGE_INDEX_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "base/skiplist.h"
+#include "base/slice.h"
+#include "codec/codec.h"
+#include "storage/iterator.h"
+#include "storage/row_compressor.h"
+#include "storage/segment.h"
+
+namespace openmldb {
+namespace storage {
+
+typedef ::openmldb::base::Skiplist<Slice, DataBlock*, SliceComparator> RangeEntries;
+typedef ::openmldb::base::Skiplist<uint64_t, ::openmldb::base::Node<Slice, DataBlock*>*, TimeComparator>
+    RangeEntryNodeList;
+
+// The primary index of a partition, which a full scan traverses. A range scan returns the rows alive in it
+// under its ttl, so it returns the same rows as a full scan
+struct PrimaryIndexView {
+    Segment** segments = nullptr;
+    uint32_t seg_cnt = 0;
+    // the id of the ts column, -1 if the index has none
+    int32_t ts_col = -1;
+    // the expire time and the count to keep, like the ones of MemTableTraverseIterator
+    TTLSt expire_value;
+
+    // `ts` is the time of the row in the index
+    bool IsAlive(const Slice& pk, uint64_t ts, const DataBlock* block) const;
+};
+
+// An ordered index on the values of one column, a row is found by the memcomparable key of its value
+// followed by a sequence number, so the rows with the same value are kept in the order they are put.
+// The key and the time of the row in the primary index follow, which are needed to check its ttl.
+// Only the rows put to the primary index of the partition are indexed.
+//
+// The index holds a reference of the data block, which is counted in both `dim_cnt_down` and `range_ref_cnt`.
+// The blocks expired in all the segments are only referred by range indexes, they are removed in Gc and
+// freed after `gc_deleted_pk_version_delta` rounds of gc like the deleted keys of segments
+class RangeIndex {
+ public:
+    RangeIndex(const std::string& name, uint32_t col_idx, ::openmldb::type::DataType type);
+    ~RangeIndex();
+    RangeIndex(const RangeIndex&) = delete;
+    RangeIndex& operator=(const RangeIndex&) = delete;
+
+    const std::string& GetName() const { return name_; }
+    uint32_t GetColumnIdx() const { return col_idx_; }
+    ::openmldb::type::DataType GetType() const { return type_; }
+
+    // pack the value of the column in `row`, returns 1 if the value is null which is not indexed
+    int PackKey(const codec::RowView& decoder, const int8_t* row, std::string* key) const;
+
+    // the reference of `block` must be added before. `pk` and `ts` are the key and the time of the row in the
+    // primary index
+    void Put(const std::string& key, const Slice& pk, uint64_t ts, DataBlock* block);
+
+    void Gc(uint64_t& gc_idx_cnt, uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size);  // NOLINT
+
+    // release all the entries, returns the number of them
+    uint64_t Release();
+
+    uint64_t GetIdxCnt() const { return idx_cnt_.load(std::memory_order_relaxed); }
+
+    // the rows in [lower, upper] of the packed values which are alive in `primary`, an empty bound is unbounded.
+    // The caller should keep the table alive until the iterator is deleted
+    TableIterator* NewIterator(const std::string& lower, bool lower_inclusive, const std::string& upper,
+                               bool upper_inclusive, const PrimaryIndexView& primary,
+                               const std::shared_ptr<RowCompressor>& compressor);
+
+ private:
+    void FreeList(::openmldb::base::Node<uint64_t, ::openmldb::base::Node<Slice, DataBlock*>*>* node,
+                  uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size);  // NOLINT
+    static void FreeBlock(DataBlock* block, uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size);  // NOLINT
+
+ private:
+    std::string name_;
+    uint32_t col_idx_;
+    ::openmldb::type::DataType type_;
+    RangeEntries* entries_;
+    // only Put and Gc need mutex
+    std::mutex mu_;
+    std::mutex gc_mu_;
+    RangeEntryNodeList* entry_free_list_;
+    std::atomic<uint64_t> seq_;
+    std::atomic<uint64_t> idx_cnt_;
+    uint64_t gc_version_;
+};
+
+class RangeIndexIterator : public TableIterator {
+ public:
+    RangeIndexIterator(RangeEntries::Iterator* it, const std::string& lower, bool lower_inclusive,
+                       const std::string& upper, bool upper_inclusive, const PrimaryIndexView& primary,
+                       const std::shared_ptr<RowCompressor>& compressor);
+    ~RangeIndexIterator() override;
+    bool Valid() override;
+    void Next() override;
+    openmldb::base::Slice GetValue() const override;
+    // the packed value of the row
+    std::string GetPK() const override;
+    // the sequence number of the row
+    uint64_t GetKey() const override;
+    void SeekToFirst() override;
+
+ private:
+    bool InRange() const;
+    // move to the first row alive in the primary index from the current one
+    void SkipExpired();
+
+ private:
+    RangeEntries::Iterator* it_;
+    std::string lower_;
+    bool lower_inclusive_;
+    std::string upper_;
+    bool upper_inclusive_;
+    PrimaryIndexView primary_;
+    std::shared_ptr<RowCompressor> compressor_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
+
+#endif  // SRC_STORAGE_RANGE_INDEX_H_
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/range_index.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "codec/schema_codec.h"
+#include "codec/sdk_codec.h"
+#include "common/timer.h"
+#include "gtest/gtest.h"
+#include "storage/mem_table.h"
+
+namespace openmldb {
+namespace storage {
+
+class RangeIndexTest : public ::testing::Test {};
+
+static ::openmldb::api::TableMeta CreateTableMeta() {
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("t1");
+    table_meta.set_tid(1);
+    table_meta.set_pid(0);
+    table_meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+    table_meta.set_format_version(1);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "amount", ::openmldb::type::kDouble);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts", ::openmldb::type::kBigInt);
+    codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts", ::openmldb::type::kLatestTime, 0,
+                                 3);
+    auto range_index = table_meta.add_range_index();
+    range_index->set_index_name("amount_range");
+    range_index->set_col_name("amount");
+    return table_meta;
+}
+
+static ::hybridse::vm::ColumnRange MakeRange(const std::string& lower, bool lower_inclusive, const std::string& upper,
+                                             bool upper_inclusive) {
+    ::hybridse::vm::ColumnRange range;
+    range.column = "amount";
+    range.lower.bounded = !lower.empty();
+    range.lower.inclusive = lower_inclusive;
+    range.lower.value = lower;
+    range.upper.bounded = !upper.empty();
+    range.upper.inclusive = upper_inclusive;
+    range.upper.value = upper;
+    return range;
+}
+
+static std::vector<double> ScanRange(MemTable* table, codec::SDKCodec* codec,
+                                     const ::hybridse::vm::ColumnRange& range) {
+    std::vector<double> amounts;
+    std::unique_ptr<TableIterator> it(table->NewRangeIterator(range));
+    if (!it) {
+        return amounts;
+    }
+    it->SeekToFirst();
+    while (it->Valid()) {
+        std::vector<std::string> row;
+        auto value = it->GetValue();
+        codec->DecodeRow(std::string(value.data(), value.size()), &row);
+        amounts.push_back(std::stod(row[1]));
+        it->Next();
+    }
+    return amounts;
+}
+
+TEST_F(RangeIndexTest, ScanAndGc) {
+    auto table_meta = CreateTableMeta();
+    MemTable table(table_meta);
+    ASSERT_TRUE(table.Init());
+    codec::SDKCodec codec(table_meta);
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    // amount of card i is i * 10 + j, the rows of j >= 3 are expired by latest ttl
+    for (int i = 0; i < 5; i++) {
+        std::string key = "card" + std::to_string(i);
+        for (int j = 9; j >= 0; j--) {
+            std::vector<std::string> row = {key, std::to_string(i * 10 + j), std::to_string(now - j * (60 * 1000))};
+            ::openmldb::api::PutRequest request;
+            ::openmldb::api::Dimension* dim = request.add_dimensions();
+            dim->set_idx(0);
+            dim->set_key(key);
+            std::string value;
+            ASSERT_EQ(0, codec.EncodeRow(row, &value));
+            ASSERT_TRUE(table.Put(0, value, request.dimensions()));
+        }
+    }
+    ASSERT_EQ(50u, table.GetRecordCnt());
+
+    // the expired rows are hidden before gc
+    auto amounts = ScanRange(&table, &codec, MakeRange("20", true, "40", false));
+    ASSERT_EQ(std::vector<double>({20, 21, 22, 30, 31, 32}), amounts);
+    amounts = ScanRange(&table, &codec, MakeRange("20", false, "22", true));
+    ASSERT_EQ(std::vector<double>({21, 22}), amounts);
+    amounts = ScanRange(&table, &codec, MakeRange("", false, "1.5", true));
+    ASSERT_EQ(std::vector<double>({0, 1}), amounts);
+    amounts = ScanRange(&table, &codec, MakeRange("41.5", false, "", false));
+    ASSERT_EQ(std::vector<double>({42}), amounts);
+    ASSERT_TRUE(ScanRange(&table, &codec, MakeRange("48.5", false, "", false)).empty());
+    // no range index on the column
+    auto range = MakeRange("1", true, "", false);
+    range.column = "ts";
+    ASSERT_EQ(nullptr, table.NewRangeIterator(range));
+
+    // the expired rows are removed from the range index and freed after some rounds of gc
+    table.SchedGc();
+    amounts = ScanRange(&table, &codec, MakeRange("20", true, "40", false));
+    ASSERT_EQ(std::vector<double>({20, 21, 22, 30, 31, 32}), amounts);
+    for (int i = 0; i < 3; i++) {
+        table.SchedGc();
+    }
+    ASSERT_EQ(15u, table.GetRecordCnt());
+    amounts = ScanRange(&table, &codec, MakeRange("", false, "100", true));
+    ASSERT_EQ(15u, amounts.size());
+}
+
+// the amounts of the rows in [lower, upper] a full scan returns
+static std::vector<double> FilterFullScan(MemTable* table, codec::SDKCodec* codec, double lower, double upper) {
+    std::vector<double> amounts;
+    std::unique_ptr<TableIterator> it(table->NewTraverseIterator(0));
+    it->SeekToFirst();
+    while (it->Valid()) {
+        std::vector<std::string> row;
+        auto value = it->GetValue();
+        codec->DecodeRow(std::string(value.data(), value.size()), &row);
+        double amount = std::stod(row[1]);
+        if (amount >= lower && amount <= upper) {
+            amounts.push_back(amount);
+        }
+        it->Next();
+    }
+    std::sort(amounts.begin(), amounts.end());
+    return amounts;
+}
+
+TEST_F(RangeIndexTest, SameRowsAsFullScan) {
+    for (auto ttl_type : {::openmldb::type::kAbsoluteTime, ::openmldb::type::kLatestTime,
+                          ::openmldb::type::kAbsAndLat, ::openmldb::type::kAbsOrLat}) {
+        auto table_meta = CreateTableMeta();
+        table_meta.clear_column_key();
+        codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts", ttl_type, 5, 3);
+        codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "amount", "amount", "ts",
+                                     ::openmldb::type::kAbsoluteTime, 0, 0);
+        MemTable table(table_meta);
+        ASSERT_TRUE(table.Init());
+        codec::SDKCodec codec(table_meta);
+        uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+        // the row of j is put j minutes ago, the rows of odd i are not in the primary index of this partition
+        for (int i = 0; i < 5; i++) {
+            std::string key = "card" + std::to_string(i);
+            for (int j = 9; j >= 0; j--) {
+                std::string amount = std::to_string(i * 10 + j);
+                std::vector<std::string> row = {key, amount, std::to_string(now - j * (60 * 1000))};
+                ::openmldb::api::PutRequest request;
+                if (i % 2 == 0) {
+                    ::openmldb::api::Dimension* dim = request.add_dimensions();
+                    dim->set_idx(0);
+                    dim->set_key(key);
+                }
+                ::openmldb::api::Dimension* dim = request.add_dimensions();
+                dim->set_idx(1);
+                dim->set_key(amount);
+                std::string value;
+                ASSERT_EQ(0, codec.EncodeRow(row, &value));
+                ASSERT_TRUE(table.Put(0, value, request.dimensions()));
+            }
+        }
+        // delete a key from the primary index
+        ASSERT_TRUE(table.Delete("card4", 0));
+        for (const auto& bound : std::vector<std::pair<double, double>>({{0, 100}, {5, 25}, {22, 22}})) {
+            auto amounts = ScanRange(&table, &codec,
+                                     MakeRange(std::to_string(bound.first), true, std::to_string(bound.second), true));
+            std::sort(amounts.begin(), amounts.end());
+            ASSERT_EQ(FilterFullScan(&table, &codec, bound.first, bound.second), amounts) << ttl_type;
+        }
+        auto amounts = ScanRange(&table, &codec, MakeRange("", false, "", false));
+        std::sort(amounts.begin(), amounts.end());
+        switch (ttl_type) {
+            case ::openmldb::type::kAbsoluteTime:
+            case ::openmldb::type::kAbsAndLat:
+                ASSERT_EQ(std::vector<double>({0, 1, 2, 3, 4, 20, 21, 22, 23, 24}), amounts);
+                break;
+            default:
+                ASSERT_EQ(std::vector<double>({0, 1, 2, 20, 21, 22}), amounts);
+        }
+        // gc does not change the rows
+        table.SchedGc();
+        amounts = ScanRange(&table, &codec, MakeRange("", false, "", false));
+        ASSERT_EQ(FilterFullScan(&table, &codec, 0, 100), amounts);
+    }
+}
+
+TEST_F(RangeIndexTest, InvalidRangeIndex) {
+    auto table_meta = CreateTableMeta();
+    table_meta.mutable_range_index(0)->set_col_name("not_exist");
+    MemTable table(table_meta);
+    ASSERT_FALSE(table.Init());
+
+    table_meta = CreateTableMeta();
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "flag", ::openmldb::type::kBool);
+    table_meta.mutable_range_index(0)->set_col_name("flag");
+    MemTable bool_table(table_meta);
+    ASSERT_FALSE(bool_table.Init());
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
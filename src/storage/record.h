@@ -30,18 +30,19 @@ static const uint32_t KEY_ENTRY_PTR_SIZE = sizeof(KeyEntry*);
 
 static inline uint32_t GetRecordSize(uint32_t value_size) { return value_size + DATA_BLOCK_BYTE_SIZE; }
 
-// the input height which is the height of skiplist node
+// the input height which is the height of skiplist node, the level 0 link is
+// stored inline in the node and already counted in ENTRY_NODE_SIZE/DATA_NODE_SIZE
 static inline uint32_t GetRecordPkIdxSize(uint8_t height, uint32_t key_size, uint8_t key_entry_max_height) {
-    return height * 8 + ENTRY_NODE_SIZE + KEY_ENTRY_BYTE_SIZE + key_size + key_entry_max_height * 8 + DATA_NODE_SIZE;
+    return (height - 1) * 8 + ENTRY_NODE_SIZE + KEY_ENTRY_BYTE_SIZE + key_size + key_entry_max_height * 8 + DATA_NODE_SIZE;
 }
 
 static inline uint32_t GetRecordPkMultiIdxSize(uint8_t height, uint32_t key_size, uint8_t key_entry_max_height,
                                                uint32_t ts_cnt) {
-    return height * 8 + ENTRY_NODE_SIZE + key_size +
+    return (height - 1) * 8 + ENTRY_NODE_SIZE + key_size +
            (KEY_ENTRY_PTR_SIZE + KEY_ENTRY_BYTE_SIZE + key_entry_max_height * 8 + DATA_NODE_SIZE) * ts_cnt;
 }
 
-static inline uint32_t GetRecordTsIdxSize(uint8_t height) { return height * 8 + DATA_NODE_SIZE; }
+static inline uint32_t GetRecordTsIdxSize(uint8_t height) { return (height - 1) * 8 + DATA_NODE_SIZE; }
 
 }  // namespace storage
 }  // namespace openmldb
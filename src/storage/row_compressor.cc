@@ -0,0 +1,189 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/row_compressor.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <zdict.h>
+#include <zstd.h>
+
+#include "base/glog_wapper.h"
+
+namespace openmldb {
+namespace storage {
+
+struct CompressDict {
+    CompressDict(uint32_t version, uint32_t id, ZSTD_CDict* cdict, ZSTD_DDict* ddict)
+        : version(version), id(id), cdict(cdict), ddict(ddict) {}
+    ~CompressDict() {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict);
+    }
+    const uint32_t version;
+    const uint32_t id;
+    ZSTD_CDict* const cdict;
+    ZSTD_DDict* const ddict;
+};
+
+namespace {
+
+// the zstd contexts are expensive to create, reuse them in each thread
+struct ZstdContext {
+    ZstdContext() : cctx(ZSTD_createCCtx()), dctx(ZSTD_createDCtx()), buf() {}
+    ~ZstdContext() {
+        ZSTD_freeCCtx(cctx);
+        ZSTD_freeDCtx(dctx);
+    }
+    ZSTD_CCtx* cctx;
+    ZSTD_DCtx* dctx;
+    std::string buf;
+};
+
+ZstdContext& GetContext() {
+    static thread_local ZstdContext context;
+    return context;
+}
+
+}  // namespace
+
+RowCompressor::RowCompressor(int level)
+    : level_(level), version_(0), dicts_(std::make_shared<std::vector<std::shared_ptr<CompressDict>>>()) {}
+
+RowCompressor::~RowCompressor() {}
+
+bool RowCompressor::Train(const std::vector<::openmldb::base::Slice>& samples, uint32_t dict_size,
+                          std::string* dict) {
+    if (samples.empty() || dict_size == 0 || dict == nullptr) {
+        return false;
+    }
+    std::string buffer;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        buffer.append(sample.data(), sample.size());
+        sizes.push_back(sample.size());
+    }
+    dict->resize(dict_size);
+    size_t size = ZDICT_trainFromBuffer(&(*dict)[0], dict_size, buffer.data(), sizes.data(), sizes.size());
+    if (ZDICT_isError(size)) {
+        PDLOG(WARNING, "fail to train dict from %lu samples: %s", sizes.size(), ZDICT_getErrorName(size));
+        dict->clear();
+        return false;
+    }
+    dict->resize(size);
+    return true;
+}
+
+bool RowCompressor::IsCompressed(const char* data, size_t size) {
+    uint32_t magic = 0;
+    if (size < sizeof(magic)) {
+        return false;
+    }
+    memcpy(&magic, data, sizeof(magic));
+    return magic == ZSTD_MAGICNUMBER;
+}
+
+bool RowCompressor::AddDict(uint32_t version, const std::string& dict) {
+    uint32_t id = ZDICT_getDictID(dict.data(), dict.size());
+    if (id == 0) {
+        PDLOG(WARNING, "invalid compress dict, version %u", version);
+        return false;
+    }
+    ZSTD_CDict* cdict = ZSTD_createCDict(dict.data(), dict.size(), level_);
+    ZSTD_DDict* ddict = ZSTD_createDDict(dict.data(), dict.size());
+    if (cdict == nullptr || ddict == nullptr) {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict);
+        PDLOG(WARNING, "fail to load compress dict, version %u", version);
+        return false;
+    }
+    auto old_dicts = std::atomic_load_explicit(&dicts_, std::memory_order_acquire);
+    auto new_dicts = std::make_shared<std::vector<std::shared_ptr<CompressDict>>>(*old_dicts);
+    new_dicts->push_back(std::make_shared<CompressDict>(version, id, cdict, ddict));
+    std::atomic_store_explicit(&dicts_, new_dicts, std::memory_order_release);
+    version_.store(version, std::memory_order_relaxed);
+    return true;
+}
+
+std::shared_ptr<CompressDict> RowCompressor::GetDict(uint32_t dict_id) const {
+    auto dicts = std::atomic_load_explicit(&dicts_, std::memory_order_acquire);
+    for (auto it = dicts->rbegin(); it != dicts->rend(); ++it) {
+        if ((*it)->id == dict_id) {
+            return *it;
+        }
+    }
+    return std::shared_ptr<CompressDict>();
+}
+
+bool RowCompressor::Compress(const char* data, size_t size, std::string* out) const {
+    auto dicts = std::atomic_load_explicit(&dicts_, std::memory_order_acquire);
+    if (dicts->empty()) {
+        return false;
+    }
+    auto& context = GetContext();
+    out->resize(ZSTD_compressBound(size));
+    size_t compressed_size =
+        ZSTD_compress_usingCDict(context.cctx, &(*out)[0], out->size(), data, size, dicts->back()->cdict);
+    if (ZSTD_isError(compressed_size) || compressed_size >= size) {
+        return false;
+    }
+    out->resize(compressed_size);
+    return true;
+}
+
+bool RowCompressor::Decompress(const char* data, size_t size, ::openmldb::base::Slice* row) const {
+    if (!IsCompressed(data, size)) {
+        row->reset(data, size);
+        return true;
+    }
+    auto dict = GetDict(ZSTD_getDictID_fromFrame(data, size));
+    uint64_t row_size = ZSTD_getFrameContentSize(data, size);
+    if (!dict || row_size == ZSTD_CONTENTSIZE_UNKNOWN || row_size == ZSTD_CONTENTSIZE_ERROR) {
+        return false;
+    }
+    auto& context = GetContext();
+    // never shrinks, so that it is not reallocated for every row
+    if (context.buf.size() < row_size) {
+        context.buf.resize(row_size);
+    }
+    size_t ret = ZSTD_decompress_usingDDict(context.dctx, &context.buf[0], row_size, data, size, dict->ddict);
+    if (ZSTD_isError(ret)) {
+        return false;
+    }
+    row->reset(context.buf.data(), ret);
+    return true;
+}
+
+bool RowCompressor::Decompress(const char* data, size_t size, int8_t** buf, size_t* buf_size) const {
+    auto dict = GetDict(ZSTD_getDictID_fromFrame(data, size));
+    uint64_t row_size = ZSTD_getFrameContentSize(data, size);
+    if (!dict || row_size == ZSTD_CONTENTSIZE_UNKNOWN || row_size == ZSTD_CONTENTSIZE_ERROR || row_size == 0) {
+        return false;
+    }
+    auto row = reinterpret_cast<int8_t*>(malloc(row_size));
+    size_t ret = ZSTD_decompress_usingDDict(GetContext().dctx, row, row_size, data, size, dict->ddict);
+    if (ZSTD_isError(ret)) {
+        free(row);
+        return false;
+    }
+    *buf = row;
+    *buf_size = ret;
+    return true;
+}
+
+}  // namespace storage
+}  // namespace openmldb
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_STORAGE_ROW_COMPRESSOR_H_
+#define SRC_STORAGE_ROW_COMPRESSOR_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/slice.h"
+
+namespace openmldb {
+namespace storage {
+
+struct CompressDict;
+
+// Compresses the rows of a table with a zstd dictionary trained from the rows of the table.
+//
+// The rows put before a dictionary is trained, and the rows which do not shrink, are kept as they are.
+// They are told apart from the compressed ones by the zstd magic number, an encoded row always starts
+// with its format version.
+class RowCompressor {
+ public:
+    explicit RowCompressor(int level);
+    ~RowCompressor();
+    RowCompressor(const RowCompressor&) = delete;
+    RowCompressor& operator=(const RowCompressor&) = delete;
+
+    // train a dictionary of at most `dict_size` bytes from the sample rows
+    static bool Train(const std::vector<::openmldb::base::Slice>& samples, uint32_t dict_size, std::string* dict);
+
+    static bool IsCompressed(const char* data, size_t size);
+
+    // compress the new rows with `dict`, the rows compressed with the previous dictionaries are still readable
+    bool AddDict(uint32_t version, const std::string& dict);
+
+    // the version of the latest dictionary, 0 if there is none
+    uint32_t GetDictVersion() const { return version_.load(std::memory_order_relaxed); }
+
+    // compress a row into `out`, returns false if the row should be stored as it is
+    bool Compress(const char* data, size_t size, std::string* out) const;
+
+    // decompress a row into a buffer of current thread, which is valid until the next call on the thread.
+    // A row which is not compressed is returned as it is
+    bool Decompress(const char* data, size_t size, ::openmldb::base::Slice* row) const;
+
+    // decompress a compressed row into a buffer allocated by malloc, which is owned by the caller
+    bool Decompress(const char* data, size_t size, int8_t** buf, size_t* buf_size) const;
+
+ private:
+    std::shared_ptr<CompressDict> GetDict(uint32_t dict_id) const;
+
+    const int level_;
+    std::atomic<uint32_t> version_;
+    // the latest one is the last, it is replaced as a whole on AddDict
+    std::shared_ptr<std::vector<std::shared_ptr<CompressDict>>> dicts_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
+
+#endif  // SRC_STORAGE_ROW_COMPRESSOR_H_
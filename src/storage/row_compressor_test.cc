@@ -0,0 +1,139 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/row_compressor.h"
+
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include "base/glog_wapper.h"  // NOLINT
+#include "base/slice.h"
+#include "gtest/gtest.h"
+
+using ::openmldb::base::Slice;
+
+namespace openmldb {
+namespace storage {
+
+class RowCompressorTest : public ::testing::Test {
+ public:
+    RowCompressorTest() {}
+    ~RowCompressorTest() {}
+};
+
+// a row starts with the format version and the schema version like an encoded one
+static std::string MakeRow(uint32_t i, const std::string& tag) {
+    std::string row("\x01\x01", 2);
+    row.append("card_" + std::to_string(i % 50) + "|merchant_" + std::to_string(i % 7) + "|" + tag +
+               "|amount_" + std::to_string(i * 13 % 1000) + "|city_shanghai|channel_online|" + std::to_string(i));
+    return row;
+}
+
+static std::string Train(uint32_t start, const std::string& tag) {
+    std::vector<std::string> rows;
+    for (uint32_t i = start; i < start + 2000; i++) {
+        rows.push_back(MakeRow(i, tag));
+    }
+    std::vector<Slice> samples(rows.begin(), rows.end());
+    std::string dict;
+    EXPECT_TRUE(RowCompressor::Train(samples, 4096, &dict));
+    return dict;
+}
+
+TEST_F(RowCompressorTest, CompressWithoutDict) {
+    RowCompressor compressor(3);
+    ASSERT_EQ(0u, compressor.GetDictVersion());
+    std::string row = MakeRow(1, "tag_a");
+    std::string compressed;
+    ASSERT_FALSE(compressor.Compress(row.data(), row.size(), &compressed));
+    ASSERT_FALSE(RowCompressor::IsCompressed(row.data(), row.size()));
+    // the rows which are not compressed are returned as they are
+    Slice value;
+    ASSERT_TRUE(compressor.Decompress(row.data(), row.size(), &value));
+    ASSERT_EQ(row.data(), value.data());
+    ASSERT_EQ(row.size(), value.size());
+
+    std::vector<Slice> samples;
+    std::string dict;
+    ASSERT_FALSE(RowCompressor::Train(samples, 4096, &dict));
+    ASSERT_FALSE(compressor.AddDict(1, "invalid dict"));
+    ASSERT_EQ(0u, compressor.GetDictVersion());
+}
+
+TEST_F(RowCompressorTest, CompressAndDecompress) {
+    RowCompressor compressor(3);
+    ASSERT_TRUE(compressor.AddDict(1, Train(0, "tag_a")));
+    ASSERT_EQ(1u, compressor.GetDictVersion());
+    for (uint32_t i = 5000; i < 5100; i++) {
+        std::string row = MakeRow(i, "tag_a");
+        std::string compressed;
+        ASSERT_TRUE(compressor.Compress(row.data(), row.size(), &compressed));
+        ASSERT_LT(compressed.size(), row.size());
+        ASSERT_TRUE(RowCompressor::IsCompressed(compressed.data(), compressed.size()));
+
+        Slice value;
+        ASSERT_TRUE(compressor.Decompress(compressed.data(), compressed.size(), &value));
+        ASSERT_EQ(row, value.ToString());
+
+        int8_t* buf = nullptr;
+        size_t size = 0;
+        ASSERT_TRUE(compressor.Decompress(compressed.data(), compressed.size(), &buf, &size));
+        ASSERT_EQ(row, std::string(reinterpret_cast<char*>(buf), size));
+        free(buf);
+    }
+    // a row which is not compressed can not be decompressed into a new buffer
+    std::string row = MakeRow(1, "tag_a");
+    int8_t* buf = nullptr;
+    size_t size = 0;
+    ASSERT_FALSE(compressor.Decompress(row.data(), row.size(), &buf, &size));
+}
+
+TEST_F(RowCompressorTest, AddDict) {
+    RowCompressor compressor(3);
+    ASSERT_TRUE(compressor.AddDict(1, Train(0, "tag_a")));
+    std::string row1 = MakeRow(5000, "tag_a");
+    std::string compressed1;
+    ASSERT_TRUE(compressor.Compress(row1.data(), row1.size(), &compressed1));
+
+    ASSERT_TRUE(compressor.AddDict(2, Train(10000, "tag_b")));
+    ASSERT_EQ(2u, compressor.GetDictVersion());
+    std::string row2 = MakeRow(5000, "tag_b");
+    std::string compressed2;
+    ASSERT_TRUE(compressor.Compress(row2.data(), row2.size(), &compressed2));
+
+    // the rows compressed with the previous dictionary are still readable
+    Slice value;
+    ASSERT_TRUE(compressor.Decompress(compressed1.data(), compressed1.size(), &value));
+    ASSERT_EQ(row1, value.ToString());
+    ASSERT_TRUE(compressor.Decompress(compressed2.data(), compressed2.size(), &value));
+    ASSERT_EQ(row2, value.ToString());
+
+    // the rows compressed with an unknown dictionary are not
+    RowCompressor other(3);
+    ASSERT_TRUE(other.AddDict(2, Train(10000, "tag_b")));
+    ASSERT_FALSE(other.Decompress(compressed1.data(), compressed1.size(), &value));
+}
+
+}  // namespace storage
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::openmldb::base::SetLogLevel(INFO);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
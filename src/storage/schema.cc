@@ -65,6 +65,9 @@ void TableColumn::AddColumn(std::shared_ptr<ColumnDef> column_def) {
     if (ts_column_) {
         column_key.set_ts_name(ts_column_->GetName());
     }
+    if (key_encoding_ != ::openmldb::type::kDelimitedKey) {
+        column_key.set_key_encoding(key_encoding_);
+    }
     auto index_ttl = GetTTL();
     auto ttl = column_key.mutable_ttl();
     ttl->set_ttl_type(index_ttl->GetProtoTTLType());
@@ -81,7 +84,8 @@ IndexDef::IndexDef(const std::string& name, uint32_t id)
       type_(::openmldb::type::IndexType::kTimeSerise),
       columns_(),
       ttl_st_(),
-      ts_column_(nullptr) {}
+      ts_column_(nullptr),
+      key_encoding_(::openmldb::type::kDelimitedKey) {}
 
 IndexDef::IndexDef(const std::string& name, uint32_t id, IndexStatus status)
     : name_(name),
@@ -91,7 +95,8 @@ IndexDef::IndexDef(const std::string& name, uint32_t id, IndexStatus status)
       type_(::openmldb::type::IndexType::kTimeSerise),
       columns_(),
       ttl_st_(),
-      ts_column_(nullptr) {}
+      ts_column_(nullptr),
+      key_encoding_(::openmldb::type::kDelimitedKey) {}
 
 IndexDef::IndexDef(const std::string& name, uint32_t id, const IndexStatus& status, ::openmldb::type::IndexType type,
                    const std::vector<ColumnDef>& columns)
@@ -102,7 +107,8 @@ IndexDef::IndexDef(const std::string& name, uint32_t id, const IndexStatus& stat
       type_(type),
       columns_(columns),
       ttl_st_(),
-      ts_column_(nullptr) {}
+      ts_column_(nullptr),
+      key_encoding_(::openmldb::type::kDelimitedKey) {}
 
 void IndexDef::SetTTL(const TTLSt& ttl) {
     auto cur_ttl = std::make_shared<TTLSt>(ttl);
@@ -211,6 +217,7 @@ int TableIndex::ParseFromMeta(const ::openmldb::api::TableMeta& table_meta) {
             if (column_key.has_ttl()) {
                 index->SetTTL(::openmldb::storage::TTLSt(column_key.ttl()));
             }
+            index->SetKeyEncoding(column_key.key_encoding());
             if (AddIndex(index) < 0) {
                 DLOG(WARNING) << "add index failed";
                 return -1;
@@ -484,7 +491,8 @@ TableSt::TableSt(const ::openmldb::nameserver::TableInfo& table_info)
       tid_(table_info.tid()),
       pid_num_(table_info.table_partition_size()),
       column_desc_(table_info.column_desc()),
-      column_key_(table_info.column_key()) {
+      column_key_(table_info.column_key()),
+      partition_split_(table_info.partition_split()) {
     partitions_ = std::make_shared<std::vector<PartitionSt>>();
     for (const auto& table_partition : table_info.table_partition()) {
         uint32_t pid = table_partition.pid();
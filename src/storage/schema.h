@@ -206,6 +206,8 @@ class IndexDef {
     std::shared_ptr<TTLSt> GetTTL() const;
     inline void SetInnerPos(int32_t inner_pos) { inner_pos_ = inner_pos; }
     inline uint32_t GetInnerPos() const { return inner_pos_; }
+    inline void SetKeyEncoding(::openmldb::type::KeyEncoding key_encoding) { key_encoding_ = key_encoding; }
+    inline ::openmldb::type::KeyEncoding GetKeyEncoding() const { return key_encoding_; }
     ::openmldb::common::ColumnKey GenColumnKey();
 
  private:
@@ -217,6 +219,7 @@ class IndexDef {
     std::vector<ColumnDef> columns_;
     std::shared_ptr<TTLSt> ttl_st_;
     std::shared_ptr<ColumnDef> ts_column_;
+    ::openmldb::type::KeyEncoding key_encoding_;
 };
 
 class InnerIndexSt {
@@ -323,6 +326,10 @@ class TableSt {
 
     inline uint32_t GetPartitionNum() const { return pid_num_; }
 
+    inline const ::google::protobuf::RepeatedPtrField<::openmldb::common::PartitionSplit>& GetPartitionSplit() const {
+        return partition_split_;
+    }
+
     inline const ::google::protobuf::RepeatedPtrField<::openmldb::common::ColumnDesc>& GetColumns() const {
         return column_desc_;
     }
@@ -338,6 +345,7 @@ class TableSt {
     uint32_t pid_num_;
     ::google::protobuf::RepeatedPtrField<::openmldb::common::ColumnDesc> column_desc_;
     ::google::protobuf::RepeatedPtrField<::openmldb::common::ColumnKey> column_key_;
+    ::google::protobuf::RepeatedPtrField<::openmldb::common::PartitionSplit> partition_split_;
     std::shared_ptr<std::vector<PartitionSt>> partitions_;
 };
 
@@ -16,6 +16,8 @@
 
 #include "storage/segment.h"
 
+#include <algorithm>
+
 #include <gflags/gflags.h>
 
 #include "base/glog_wapper.h"
@@ -31,6 +33,14 @@ namespace openmldb {
 namespace storage {
 
 static const SliceComparator scmp;
+
+// every segment hands out the versions of its keys from a separate range, so a key which is deleted and put
+// again, even in a recreated table, never gets a version it had before
+static uint64_t NewVersionSeq() {
+    static std::atomic<uint64_t> epoch(0);
+    return (epoch.fetch_add(1, std::memory_order_relaxed) + 1) << 40;
+}
+
 Segment::Segment()
     : entries_(NULL),
       mu_(),
@@ -39,7 +49,9 @@ Segment::Segment()
       pk_cnt_(0),
       ts_cnt_(1),
       gc_version_(0),
-      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000) {
+      version_seq_(NewVersionSeq()),
+      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000),
+      dedupe_(false) {
     entries_ = new KeyEntries((uint8_t)FLAGS_skiplist_max_height, 4, scmp);
     key_entry_max_height_ = (uint8_t)FLAGS_skiplist_max_height;
     entry_free_list_ = new KeyEntryNodeList(4, 4, tcmp);
@@ -54,7 +66,9 @@ Segment::Segment(uint8_t height)
       key_entry_max_height_(height),
       ts_cnt_(1),
       gc_version_(0),
-      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000) {
+      version_seq_(NewVersionSeq()),
+      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000),
+      dedupe_(false) {
     entries_ = new KeyEntries((uint8_t)FLAGS_skiplist_max_height, 4, scmp);
     entry_free_list_ = new KeyEntryNodeList(4, 4, tcmp);
 }
@@ -68,7 +82,9 @@ Segment::Segment(uint8_t height, const std::vector<uint32_t>& ts_idx_vec)
       key_entry_max_height_(height),
       ts_cnt_(ts_idx_vec.size()),
       gc_version_(0),
-      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000) {
+      version_seq_(NewVersionSeq()),
+      ttl_offset_(FLAGS_gc_safe_offset * 60 * 1000),
+      dedupe_(false) {
     entries_ = new KeyEntries((uint8_t)FLAGS_skiplist_max_height, 4, scmp);
     entry_free_list_ = new KeyEntryNodeList(4, 4, tcmp);
     for (uint32_t i = 0; i < ts_idx_vec.size(); i++) {
@@ -168,6 +184,10 @@ void Segment::Put(const Slice& key, uint64_t time, DataBlock* row) {
         return;
     }
     std::lock_guard<std::mutex> lock(mu_);
+    if (dedupe_ && ContainsUnlock(key, time, row)) {
+        row->dim_cnt_down--;
+        return;
+    }
     PutUnlock(key, time, row);
 }
 
@@ -189,10 +209,43 @@ void Segment::PutUnlock(const Slice& key, uint64_t time, DataBlock* row) {
     uint8_t height = ((KeyEntry*)entry)->entries.Insert(time, row);  // NOLINT
     ((KeyEntry*)entry)                                               // NOLINT
         ->count_.fetch_add(1, std::memory_order_relaxed);
+    UpdateVersion((KeyEntry*)entry);  // NOLINT
     byte_size += GetRecordTsIdxSize(height);
     idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
 }
 
+bool Segment::PutIfAbsent(const Slice& key, uint64_t time, DataBlock* row) {
+    if (ts_cnt_ > 1) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    if (ContainsUnlock(key, time, row)) {
+        return false;
+    }
+    row->dim_cnt_down++;
+    PutUnlock(key, time, row);
+    return true;
+}
+
+bool Segment::ContainsUnlock(const Slice& key, uint64_t time, DataBlock* row) {
+    void* entry = nullptr;
+    if (entries_->Get(key, entry) < 0 || entry == nullptr) {
+        return false;
+    }
+    bool found = false;
+    TimeEntries::Iterator* it = ((KeyEntry*)entry)->entries.NewIterator();  // NOLINT
+    it->Seek(time);
+    while (it->Valid() && it->GetKey() == time) {
+        if (it->GetValue() == row) {
+            found = true;
+            break;
+        }
+        it->Next();
+    }
+    delete it;
+    return found;
+}
+
 void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row) {
     void* key_entry_or_list = nullptr;
     uint32_t byte_size = 0;
@@ -209,8 +262,8 @@ void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t
             for (uint32_t i = 0; i < ts_cnt_; i++) {
                 entry_arr_tmp[i] = new KeyEntry(key_entry_max_height_);
             }
-            auto entry_arr = (void*)entry_arr_tmp;  // NOLINT
-            uint8_t height = entries_->Insert(skey, entry_arr);
+            key_entry_or_list = (void*)entry_arr_tmp;  // NOLINT
+            uint8_t height = entries_->Insert(skey, key_entry_or_list);
             byte_size += GetRecordPkMultiIdxSize(height, key.size(), key_entry_max_height_, ts_cnt_);
             pk_cnt_.fetch_add(1, std::memory_order_relaxed);
         }
@@ -218,6 +271,7 @@ void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t
             time, row);
         ((KeyEntry**)key_entry_or_list)[key_entry_id]->count_.fetch_add(  // NOLINT
             1, std::memory_order_relaxed);
+        UpdateVersion(((KeyEntry**)key_entry_or_list)[key_entry_id]);  // NOLINT
         byte_size += GetRecordTsIdxSize(height);
         idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
         idx_cnt_vec_[key_entry_id]->fetch_add(1, std::memory_order_relaxed);
@@ -264,6 +318,7 @@ void Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, D
             kv.second, row);
         ((KeyEntry**)entry_arr)[pos->second]->count_.fetch_add(  // NOLINT
             1, std::memory_order_relaxed);
+        UpdateVersion(((KeyEntry**)entry_arr)[pos->second]);  // NOLINT
         byte_size += GetRecordTsIdxSize(height);
         idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
         idx_cnt_vec_[pos->second]->fetch_add(1, std::memory_order_relaxed);
@@ -495,6 +550,9 @@ void Segment::Gc4Head(uint64_t keep_cnt, uint64_t& gc_idx_cnt, uint64_t& gc_reco
         uint64_t entry_gc_idx_cnt = 0;
         FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
         entry->count_.fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
+        if (entry_gc_idx_cnt > 0) {
+            UpdateVersion(entry);
+        }
         gc_idx_cnt += entry_gc_idx_cnt;
         it->Next();
     }
@@ -592,6 +650,9 @@ void Segment::GcAllType(const std::map<uint32_t, TTLSt>& ttl_st_map, uint64_t& g
             uint64_t entry_gc_idx_cnt = 0;
             FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
             entry->count_.fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
+            if (entry_gc_idx_cnt > 0) {
+                UpdateVersion(entry);
+            }
             idx_cnt_vec_[pos->second]->fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
             gc_idx_cnt += entry_gc_idx_cnt;
         }
@@ -665,6 +726,9 @@ void Segment::Gc4TTL(const uint64_t time, uint64_t& gc_idx_cnt, uint64_t& gc_rec
         uint64_t entry_gc_idx_cnt = 0;
         FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
         entry->count_.fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
+        if (entry_gc_idx_cnt > 0) {
+            UpdateVersion(entry);
+        }
         gc_idx_cnt += entry_gc_idx_cnt;
     }
     DEBUGLOG("[Gc4TTL] segment gc with key %lu ,consumed %lu, count %lu", time,
@@ -706,6 +770,9 @@ void Segment::Gc4TTLAndHead(const uint64_t time, const uint64_t keep_cnt, uint64
         uint64_t entry_gc_idx_cnt = 0;
         FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
         entry->count_.fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
+        if (entry_gc_idx_cnt > 0) {
+            UpdateVersion(entry);
+        }
         gc_idx_cnt += entry_gc_idx_cnt;
     }
     DEBUGLOG(
@@ -758,6 +825,9 @@ void Segment::Gc4TTLOrHead(const uint64_t time, const uint64_t keep_cnt, uint64_
         uint64_t entry_gc_idx_cnt = 0;
         FreeList(node, entry_gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
         entry->count_.fetch_sub(entry_gc_idx_cnt, std::memory_order_relaxed);
+        if (entry_gc_idx_cnt > 0) {
+            UpdateVersion(entry);
+        }
         gc_idx_cnt += entry_gc_idx_cnt;
     }
     DEBUGLOG(
@@ -797,6 +867,56 @@ int Segment::GetCount(const Slice& key, uint32_t idx, uint64_t& count) {
     return 0;
 }
 
+bool Segment::GetVersion(const Slice& key, uint32_t idx, uint64_t* version) {
+    uint32_t real_idx = 0;
+    if (ts_cnt_ > 1 && GetTsIdx(idx, real_idx) < 0) {
+        return false;
+    }
+    void* entry = NULL;
+    if (entries_->Get(key, entry) < 0 || entry == NULL) {
+        return false;
+    }
+    if (ts_cnt_ > 1) {
+        entry = ((KeyEntry**)entry)[real_idx];  // NOLINT
+    }
+    *version = ((KeyEntry*)entry)->GetVersion();  // NOLINT
+    return true;
+}
+
+void Segment::SampleCount(uint32_t idx, uint32_t max_cnt, std::vector<uint64_t>* counts) {
+    uint32_t real_idx = 0;
+    if (max_cnt == 0 || (ts_cnt_ > 1 && GetTsIdx(idx, real_idx) < 0)) {
+        return;
+    }
+    // the keys are sorted in the skiplist, so the first keys are not a fair sample of them. Walk the
+    // highest level still linking about max_cnt keys, and take every `step` keys of the level
+    uint8_t branch = entries_->GetBranch();
+    uint8_t level = 0;
+    uint64_t level_cnt = GetPkCnt();
+    while (level + 1 < FLAGS_skiplist_max_height && level_cnt / branch >= max_cnt) {
+        level_cnt /= branch;
+        level++;
+    }
+    // round the step up, or the samples may stop short of the last keys
+    uint64_t step = std::max((level_cnt + max_cnt - 1) / max_cnt, static_cast<uint64_t>(1));
+    uint32_t sample_cnt = 0;
+    KeyEntries::Iterator* it = entries_->NewIterator();
+    it->SeekToFirst(level);
+    for (uint64_t pos = 0; sample_cnt < max_cnt && it->Valid(); pos++) {
+        if (pos % step == 0) {
+            sample_cnt++;
+            void* entry = it->GetValue();
+            if (ts_cnt_ > 1) {
+                counts->push_back(((KeyEntry**)entry)[real_idx]->GetCount());  // NOLINT
+            } else {
+                counts->push_back(((KeyEntry*)entry)->GetCount());  // NOLINT
+            }
+        }
+        it->Next(level);
+    }
+    delete it;
+}
+
 // Iterator
 MemTableIterator* Segment::NewIterator(const Slice& key, Ticket& ticket) {
     if (entries_ == NULL || ts_cnt_ > 1) {
@@ -856,7 +976,12 @@ void MemTableIterator::Next() {
 }
 
 ::openmldb::base::Slice MemTableIterator::GetValue() const {
-    return ::openmldb::base::Slice(it_->GetValue()->data, it_->GetValue()->size);
+    ::openmldb::base::Slice value(it_->GetValue()->data, it_->GetValue()->size);
+    if (compressor_ && !compressor_->Decompress(value.data(), value.size(), &value)) {
+        PDLOG(WARNING, "fail to decompress row");
+        return ::openmldb::base::Slice();
+    }
+    return value;
 }
 
 uint64_t MemTableIterator::GetKey() const { return it_->GetKey(); }
@@ -27,6 +27,7 @@
 #include "base/slice.h"
 #include "proto/tablet.pb.h"
 #include "storage/iterator.h"
+#include "storage/row_compressor.h"
 #include "storage/schema.h"
 #include "storage/ticket.h"
 
@@ -43,16 +44,19 @@ class Ticket;
 struct DataBlock {
     // dimension count down
     uint8_t dim_cnt_down;
+    // the references of range indexes in dim_cnt_down
+    uint8_t range_ref_cnt;
     uint32_t size;
     char* data;
 
-    DataBlock(uint8_t dim_cnt, const char* input, uint32_t len) : dim_cnt_down(dim_cnt), size(len), data(NULL) {
+    DataBlock(uint8_t dim_cnt, const char* input, uint32_t len)
+        : dim_cnt_down(dim_cnt), range_ref_cnt(0), size(len), data(NULL) {
         data = new char[len];
         memcpy(data, input, len);
     }
 
     DataBlock(uint8_t dim_cnt, char* input, uint32_t len, bool skip_copy)
-        : dim_cnt_down(dim_cnt), size(len), data(NULL) {
+        : dim_cnt_down(dim_cnt), range_ref_cnt(0), size(len), data(NULL) {
         if (skip_copy) {
             data = input;
         } else {
@@ -93,15 +97,18 @@ class MemTableIterator : public TableIterator {
     uint64_t GetKey() const override;
     void SeekToFirst() override;
     void SeekToLast() override;
+    // decompress the rows of a kZstd table
+    void SetCompressor(const std::shared_ptr<RowCompressor>& compressor) { compressor_ = compressor; }
 
  private:
     TimeEntries::Iterator* it_;
+    std::shared_ptr<RowCompressor> compressor_;
 };
 
 class KeyEntry {
  public:
-    KeyEntry() : entries(12, 4, tcmp), refs_(0), count_(0) {}
-    explicit KeyEntry(uint8_t height) : entries(height, 4, tcmp), refs_(0), count_(0) {}
+    KeyEntry() : entries(12, 4, tcmp), refs_(0), count_(0), version_(0) {}
+    explicit KeyEntry(uint8_t height) : entries(height, 4, tcmp), refs_(0), count_(0), version_(0) {}
     ~KeyEntry() {}
 
     // just return the count of datablock
@@ -131,10 +138,14 @@ class KeyEntry {
 
     uint64_t GetCount() { return count_.load(std::memory_order_relaxed); }
 
+    // it changes once a row is put into or removed from the key, 0 means no row has ever been put
+    uint64_t GetVersion() { return version_.load(std::memory_order_acquire); }
+
  public:
     TimeEntries entries;
     std::atomic<uint64_t> refs_;
     std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> version_;
     friend Segment;
 };
 
@@ -159,6 +170,17 @@ class Segment {
 
     void PutUnlock(const Slice& key, uint64_t time, DataBlock* row);
 
+    // Put `row` if it is not in the entries of `key` at `time` yet, the reference of `row` is added under the lock
+    // once it is put. Returns false if it is there already. Only for the segment of one ts column
+    bool PutIfAbsent(const Slice& key, uint64_t time, DataBlock* row);
+
+    // While set, Put skips a row that is in the entries of `key` at `time` already and releases the reference
+    // counted for it instead. Set while an index is backfilled, see MemTable::BackfillIndex
+    void SetDedupe(bool dedupe) {
+        std::lock_guard<std::mutex> lock(mu_);
+        dedupe_ = dedupe;
+    }
+
     void BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row);
 
     void Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, DataBlock* row);
@@ -239,6 +261,13 @@ class Segment {
     int GetCount(const Slice& key, uint64_t& count);                // NOLINT
     int GetCount(const Slice& key, uint32_t idx, uint64_t& count);  // NOLINT
 
+    // the version of the rows of key on ts index `idx`, see KeyEntry::GetVersion
+    bool GetVersion(const Slice& key, uint32_t idx, uint64_t* version);
+
+    // Append the row count of about `max_cnt` keys on ts index `idx` to `counts`, the keys are sampled
+    // evenly over the whole key range
+    void SampleCount(uint32_t idx, uint32_t max_cnt, std::vector<uint64_t>* counts);
+
     void IncrGcVersion() { gc_version_.fetch_add(1, std::memory_order_relaxed); }
 
     void ReleaseAndCount(uint64_t& gc_idx_cnt,            // NOLINT
@@ -259,6 +288,12 @@ class Segment {
                    uint64_t& gc_record_byte_size);  // NOLINT
 
  private:
+    bool ContainsUnlock(const Slice& key, uint64_t time, DataBlock* row);
+
+    void UpdateVersion(KeyEntry* entry) {
+        entry->version_.store(version_seq_.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
     KeyEntries* entries_;
     // only Put need mutex
     std::mutex mu_;
@@ -270,9 +305,12 @@ class Segment {
     KeyEntryNodeList* entry_free_list_;
     uint32_t ts_cnt_;
     std::atomic<uint64_t> gc_version_;
+    std::atomic<uint64_t> version_seq_;
     std::map<uint32_t, uint32_t> ts_idx_map_;
     std::vector<std::shared_ptr<std::atomic<uint64_t>>> idx_cnt_vec_;
     uint64_t ttl_offset_;
+    // guarded by mu_
+    bool dedupe_;
 };
 
 }  // namespace storage
@@ -16,6 +16,7 @@
 
 #include "storage/segment.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -66,6 +67,45 @@ TEST_F(SegmentTest, PutAndGet) {
     ASSERT_EQ(e, t);
 }
 
+TEST_F(SegmentTest, PutIfAbsent) {
+    Segment segment;
+    Slice pk("pk");
+    DataBlock* db1 = new DataBlock(0, "test1", 5);
+    DataBlock* db2 = new DataBlock(0, "test2", 5);
+    ASSERT_TRUE(segment.PutIfAbsent(pk, 9768, db1));
+    ASSERT_FALSE(segment.PutIfAbsent(pk, 9768, db1));
+    // another row at the same time
+    ASSERT_TRUE(segment.PutIfAbsent(pk, 9768, db2));
+    ASSERT_TRUE(segment.PutIfAbsent(Slice("pk1"), 9768, db1));
+    ASSERT_EQ(2, (int64_t)db1->dim_cnt_down);
+    ASSERT_EQ(1, (int64_t)db2->dim_cnt_down);
+    ASSERT_EQ(3, (int64_t)segment.GetIdxCnt());
+    ASSERT_EQ(2, (int64_t)segment.GetPkCnt());
+}
+
+TEST_F(SegmentTest, PutDedupe) {
+    Segment segment;
+    Slice pk("pk");
+    // the references of the rows put are counted already
+    DataBlock* db1 = new DataBlock(2, "test1", 5);
+    DataBlock* db2 = new DataBlock(2, "test2", 5);
+    segment.SetDedupe(true);
+    // put by a backfill first
+    ASSERT_TRUE(segment.PutIfAbsent(pk, 9768, db1));
+    ASSERT_EQ(3, (int64_t)db1->dim_cnt_down);
+    segment.Put(pk, 9768, db1);
+    ASSERT_EQ(2, (int64_t)db1->dim_cnt_down);
+    ASSERT_EQ(1, (int64_t)segment.GetIdxCnt());
+    // put before the backfill
+    segment.Put(pk, 9768, db2);
+    ASSERT_FALSE(segment.PutIfAbsent(pk, 9768, db2));
+    ASSERT_EQ(2, (int64_t)db2->dim_cnt_down);
+    ASSERT_EQ(2, (int64_t)segment.GetIdxCnt());
+    segment.SetDedupe(false);
+    segment.Put(pk, 9768, db2);
+    ASSERT_EQ(3, (int64_t)segment.GetIdxCnt());
+}
+
 TEST_F(SegmentTest, PutAndScan) {
     Segment segment;
     Slice pk("test1");
@@ -175,6 +215,93 @@ TEST_F(SegmentTest, GetCount) {
     ASSERT_EQ(1, (int64_t)count);
 }
 
+TEST_F(SegmentTest, GetVersion) {
+    Segment segment;
+    Slice pk("test1");
+    std::string value = "test0";
+    uint64_t version = 0;
+    ASSERT_FALSE(segment.GetVersion(pk, 0, &version));
+    segment.Put(pk, 9527, value.c_str(), value.size());
+    ASSERT_TRUE(segment.GetVersion(pk, 0, &version));
+    ASSERT_NE(0, (int64_t)version);
+    uint64_t version1 = 0;
+    ASSERT_TRUE(segment.GetVersion(pk, 0, &version1));
+    ASSERT_EQ(version, version1);
+    segment.Put(pk, 9528, value.c_str(), value.size());
+    ASSERT_TRUE(segment.GetVersion(pk, 0, &version1));
+    ASSERT_NE(version, version1);
+
+    version = version1;
+    uint64_t gc_idx_cnt = 0;
+    uint64_t gc_record_cnt = 0;
+    uint64_t gc_record_byte_size = 0;
+    segment.Gc4TTL(9000, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_TRUE(segment.GetVersion(pk, 0, &version1));
+    ASSERT_EQ(version, version1);
+    segment.Gc4TTL(9527, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_TRUE(segment.GetVersion(pk, 0, &version1));
+    ASSERT_NE(version, version1);
+
+    // the keys of another segment never get the same version
+    Segment segment1;
+    segment1.Put(pk, 9527, value.c_str(), value.size());
+    ASSERT_TRUE(segment1.GetVersion(pk, 0, &version));
+    ASSERT_NE(version, version1);
+
+    std::vector<uint32_t> ts_idx_vec = {1, 3};
+    Segment segment2(8, ts_idx_vec);
+    std::map<int32_t, uint64_t> ts_map = {{1, 1100}, {3, 1100}};
+    DataBlock db(1, "test1", 5);
+    segment2.Put(pk, ts_map, &db);
+    ASSERT_FALSE(segment2.GetVersion(pk, 0, &version));
+    ASSERT_TRUE(segment2.GetVersion(pk, 1, &version));
+    ASSERT_TRUE(segment2.GetVersion(pk, 3, &version1));
+    ts_map = {{1, 1200}};
+    segment2.Put(pk, ts_map, &db);
+    uint64_t version2 = 0;
+    ASSERT_TRUE(segment2.GetVersion(pk, 3, &version2));
+    ASSERT_EQ(version1, version2);
+    ASSERT_TRUE(segment2.GetVersion(pk, 1, &version2));
+    ASSERT_NE(version, version2);
+}
+
+TEST_F(SegmentTest, SampleCount) {
+    Segment segment;
+    std::vector<uint64_t> counts;
+    segment.SampleCount(0, 100, &counts);
+    ASSERT_TRUE(counts.empty());
+    // the row count grows with the key, from 1 of key0000 to 20 of key1999
+    for (int i = 0; i < 2000; i++) {
+        char key[8];
+        snprintf(key, sizeof(key), "key%04d", i);
+        Slice pk(key);
+        for (int j = 0; j <= i / 100; j++) {
+            segment.Put(pk, 9527 + j, "test1", 5);
+        }
+    }
+    segment.SampleCount(0, 0, &counts);
+    ASSERT_TRUE(counts.empty());
+    segment.SampleCount(0, 100, &counts);
+    ASSERT_GT(counts.size(), 10u);
+    ASSERT_LE(counts.size(), 100u);
+    // the sample covers the whole key range instead of the first keys
+    uint64_t min_cnt = *std::min_element(counts.begin(), counts.end());
+    uint64_t max_cnt = *std::max_element(counts.begin(), counts.end());
+    ASSERT_LE(min_cnt, 3u);
+    ASSERT_GE(max_cnt, 18u);
+
+    // all keys are taken if there are not so many
+    Segment segment1;
+    segment1.Put(Slice("pk1"), 9527, "test1", 5);
+    segment1.Put(Slice("pk2"), 9527, "test1", 5);
+    segment1.Put(Slice("pk2"), 9528, "test1", 5);
+    counts.clear();
+    segment1.SampleCount(0, 100, &counts);
+    ASSERT_EQ(2u, counts.size());
+    ASSERT_EQ(1u, counts[0]);
+    ASSERT_EQ(2u, counts[1]);
+}
+
 TEST_F(SegmentTest, Iterator) {
     Segment segment;
     Slice pk("test1");
@@ -173,9 +173,39 @@ bool Table::InitFromMeta() {
     if (table_meta_->has_compress_type()) {
         compress_type_ = table_meta_->compress_type();
     }
+    InitSplitModulus();
     return true;
 }
 
+void Table::AddSplitModulus(uint64_t modulus) {
+    auto table_meta = std::make_shared<::openmldb::api::TableMeta>(*GetTableMeta());
+    for (auto cur_modulus : table_meta->split_modulus()) {
+        if (cur_modulus == modulus) {
+            return;
+        }
+    }
+    table_meta->add_split_modulus(modulus);
+    std::atomic_store_explicit(&table_meta_, table_meta, std::memory_order_release);
+    InitSplitModulus();
+}
+
+void Table::InitSplitModulus() {
+    auto table_meta = GetTableMeta();
+    uint64_t first = 0;
+    uint64_t last = 0;
+    for (auto modulus : table_meta->split_modulus()) {
+        if (first == 0 || modulus < first) {
+            first = modulus;
+        }
+        last = std::max(last, modulus);
+    }
+    if (last == 0) {
+        return;
+    }
+    split_bound_.store(first / 2, std::memory_order_relaxed);
+    split_modulus_.store(last, std::memory_order_release);
+}
+
 bool Table::CheckFieldExist(const std::string& name) {
     auto table_meta = std::atomic_load_explicit(&table_meta_, std::memory_order_acquire);
     for (const auto& column : table_meta->column_desc()) {
@@ -22,6 +22,8 @@
 #include <string>
 #include <vector>
 
+#include "base/hash.h"
+#include "base/space_saving.h"
 #include "codec/codec.h"
 #include "proto/tablet.pb.h"
 #include "storage/iterator.h"
@@ -69,6 +71,9 @@ class Table {
 
     virtual ::hybridse::vm::WindowIterator* NewWindowIterator(uint32_t index) = 0;
 
+    // the rows in `range` of a column with range index, nullptr if the table has no range index on it
+    virtual TableIterator* NewRangeIterator(const ::hybridse::vm::ColumnRange& range) { return nullptr; }
+
     virtual void SchedGc() = 0;
 
     virtual uint64_t GetRecordCnt() const = 0;
@@ -104,6 +109,15 @@ class Table {
 
     inline void SetDiskused(uint64_t size) { diskused_.store(size, std::memory_order_relaxed); }
 
+    // the number of reads served by this partition, reported to the nameserver for load balance. It counts the
+    // Get/Scan/Count/Traverse requests, and the key lookups and partition scans of sql queries
+    inline void IncrReadCnt() { read_cnt_.fetch_add(1, std::memory_order_relaxed); }
+
+    inline uint64_t GetReadCnt() const { return read_cnt_.load(std::memory_order_relaxed); }
+
+    // the sampled keys of the request mode queries on this partition
+    inline ::openmldb::base::SpaceSaving& GetHotKeySketch() { return hot_key_sketch_; }
+
     inline const ::openmldb::type::CompressType GetCompressType() { return compress_type_; }
 
     void AddVersionSchema(const ::openmldb::api::TableMeta& table_meta);
@@ -114,6 +128,19 @@ class Table {
 
     void SetTableMeta(::openmldb::api::TableMeta& table_meta);  // NOLINT
 
+    // record the split of this partition by `modulus`, which moves the keys in the upper half of it to the
+    // new partition. See base/partition_router.h
+    void AddSplitModulus(uint64_t modulus);
+
+    // whether the splits of this partition have moved `key` to other partitions
+    inline bool IsMovedBySplit(const std::string& key) const {
+        uint64_t modulus = split_modulus_.load(std::memory_order_acquire);
+        // the modulus doubles on each split of the partition, the keys kept by all of them have hash % modulus
+        // below the half of the first split modulus
+        return modulus > 0 && static_cast<uint64_t>(::openmldb::base::hash64(key)) % modulus >=
+                                  split_bound_.load(std::memory_order_relaxed);
+    }
+
     std::shared_ptr<Schema> GetVersionSchema(int32_t ver) {
         auto versions = std::atomic_load_explicit(&version_schema_, std::memory_order_relaxed);
         auto it = versions->find(ver);
@@ -171,18 +198,30 @@ class Table {
     virtual uint64_t GetRecordIdxCnt() = 0;
     virtual bool GetRecordIdxCnt(uint32_t idx, uint64_t** stat, uint32_t* size) = 0;
     virtual uint64_t GetRecordPkCnt() = 0;
+    // Collect the statistics of index `idx` for the sql planner, and append the row count of at most
+    // `sample_cnt` keys to `key_counts`. Return false if the statistics are not available
+    virtual bool GetIndexStats(uint32_t idx, uint32_t sample_cnt, uint64_t* pk_cnt, uint64_t* idx_cnt,
+                               std::vector<uint64_t>* key_counts) {
+        return false;
+    }
+    // Get the version of the rows of `pk` on index `idx`, it changes once the rows of the key change.
+    // Return false if the table does not keep versions or the key does not exist
+    virtual bool GetKeyVersion(uint32_t idx, const std::string& pk, uint64_t* version) { return false; }
     virtual inline uint64_t GetRecordByteSize() const = 0;
     virtual uint64_t GetRecordIdxByteSize() = 0;
 
  protected:
     void UpdateTTL();
     bool InitFromMeta();
+    void InitSplitModulus();
 
     ::openmldb::common::StorageMode storage_mode_;
     std::string name_;
     uint32_t id_;
     uint32_t pid_;
     std::atomic<uint64_t> diskused_;
+    std::atomic<uint64_t> read_cnt_{0};
+    ::openmldb::base::SpaceSaving hot_key_sketch_{64};
     bool is_leader_;
     uint64_t ttl_offset_;
     std::atomic<uint32_t> table_status_;
@@ -193,6 +232,9 @@ class Table {
     std::shared_ptr<std::map<int32_t, std::shared_ptr<Schema>>> version_schema_;
     std::shared_ptr<std::map<int32_t, std::shared_ptr<codec::RowView>>> version_decoder_;
     std::shared_ptr<std::vector<::openmldb::storage::UpdateTTLMeta>> update_ttl_;
+    // the last split modulus of this partition and the half of the first one, 0 if it is never split
+    std::atomic<uint64_t> split_modulus_{0};
+    std::atomic<uint64_t> split_bound_{0};
 };
 
 }  // namespace storage
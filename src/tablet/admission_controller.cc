@@ -0,0 +1,118 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/admission_controller.h"
+
+#include <algorithm>
+
+#include "absl/strings/str_cat.h"
+
+namespace openmldb::tablet {
+
+namespace {
+
+int64_t GetCounter(void* arg) {
+    return static_cast<const std::atomic<int64_t>*>(arg)->load(std::memory_order_relaxed);
+}
+
+}  // namespace
+
+void AdmissionController::Ticket::Release() {
+    if (controller_ == nullptr) {
+        return;
+    }
+    if (is_query_) {
+        controller_->inflight_query_cnt_.fetch_sub(1, std::memory_order_relaxed);
+    } else {
+        controller_->inflight_put_cnt_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    controller_->inflight_bytes_.fetch_sub(bytes_, std::memory_order_relaxed);
+    controller_ = nullptr;
+}
+
+AdmissionController::AdmissionController(uint32_t max_concurrent_query, uint64_t max_inflight_bytes,
+                                         uint64_t memory_high_water_mark)
+    : max_concurrent_query_(max_concurrent_query),
+      max_inflight_bytes_(max_inflight_bytes),
+      memory_high_water_mark_(memory_high_water_mark),
+      inflight_query_cnt_(0),
+      inflight_put_cnt_(0),
+      inflight_bytes_(0),
+      memory_used_(0),
+      reject_cnt_(0) {
+    vars_.emplace_back(new bvar::PassiveStatus<int64_t>("tablet_admission", "inflight_query", GetCounter,
+                                                        &inflight_query_cnt_));
+    vars_.emplace_back(new bvar::PassiveStatus<int64_t>("tablet_admission", "inflight_put", GetCounter,
+                                                        &inflight_put_cnt_));
+    vars_.emplace_back(new bvar::PassiveStatus<int64_t>("tablet_admission", "inflight_bytes", GetCounter,
+                                                        &inflight_bytes_));
+    vars_.emplace_back(new bvar::PassiveStatus<int64_t>("tablet_admission", "memory_used", GetCounter,
+                                                        &memory_used_));
+    vars_.emplace_back(
+        new bvar::PassiveStatus<int64_t>("tablet_admission", "reject", GetCounter, &reject_cnt_));
+}
+
+base::Status AdmissionController::AdmitPut(uint64_t request_bytes, Ticket* ticket) {
+    return Admit(false, request_bytes, ticket);
+}
+
+base::Status AdmissionController::AdmitQuery(uint64_t request_bytes, Ticket* ticket) {
+    return Admit(true, request_bytes, ticket);
+}
+
+base::Status AdmissionController::Admit(bool is_query, uint64_t request_bytes, Ticket* ticket) {
+    ticket->Release();
+    int64_t query_cnt = 0;
+    if (is_query) {
+        query_cnt = inflight_query_cnt_.fetch_add(1, std::memory_order_relaxed) + 1;
+    } else {
+        inflight_put_cnt_.fetch_add(1, std::memory_order_relaxed);
+    }
+    int64_t bytes = inflight_bytes_.fetch_add(request_bytes, std::memory_order_relaxed) + request_bytes;
+    // hold the resources first, so that the concurrent requests can not pass the limits together
+    ticket->controller_ = this;
+    ticket->is_query_ = is_query;
+    ticket->bytes_ = request_bytes;
+    if (is_query && max_concurrent_query_ > 0 && query_cnt > max_concurrent_query_) {
+        ticket->Release();
+        Reject();
+        return {base::ReturnCode::kTabletOverloaded,
+                absl::StrCat("too many queries running, the limit is ", max_concurrent_query_)};
+    }
+    // a single request larger than the limit is admitted when nothing else is in flight
+    if (max_inflight_bytes_ > 0 && static_cast<uint64_t>(bytes) > max_inflight_bytes_ &&
+        static_cast<uint64_t>(bytes) != request_bytes) {
+        ticket->Release();
+        Reject();
+        return {base::ReturnCode::kTabletOverloaded,
+                absl::StrCat("too many request bytes in flight, the limit is ", max_inflight_bytes_)};
+    }
+    if (memory_high_water_mark_ > 0 &&
+        static_cast<uint64_t>(memory_used_.load(std::memory_order_relaxed)) > memory_high_water_mark_ &&
+        (!is_query || query_cnt > 1)) {
+        ticket->Release();
+        Reject();
+        return {base::ReturnCode::kTabletOverloaded,
+                absl::StrCat("memory used is above the high water mark ", memory_high_water_mark_)};
+    }
+    return {};
+}
+
+void AdmissionController::SetMemoryUsed(uint64_t table_bytes, uint64_t allocated_bytes) {
+    memory_used_.store(static_cast<int64_t>(std::max(table_bytes, allocated_bytes)), std::memory_order_relaxed);
+}
+
+}  // namespace openmldb::tablet
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_ADMISSION_CONTROLLER_H_
+#define SRC_TABLET_ADMISSION_CONTROLLER_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/status.h"
+#include "bvar/bvar.h"
+
+namespace openmldb::tablet {
+
+// Admission control of the puts and queries served by a tablet. A request is rejected before it runs with
+// kTabletOverloaded if too many queries are running, the bytes of the requests in flight are over the limit or
+// the memory used is above the high water mark. A limit of 0 is not checked.
+// The counters are exposed as bvars named tablet_admission_*, which also show up in /brpc_metrics
+class AdmissionController {
+ public:
+    // the resources held by an admitted request, they are given back when the ticket is destroyed
+    class Ticket {
+     public:
+        Ticket() = default;
+        ~Ticket() { Release(); }
+
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+
+        void Release();
+
+     private:
+        friend class AdmissionController;
+        AdmissionController* controller_ = nullptr;
+        bool is_query_ = false;
+        uint64_t bytes_ = 0;
+    };
+
+    AdmissionController(uint32_t max_concurrent_query, uint64_t max_inflight_bytes, uint64_t memory_high_water_mark);
+
+    AdmissionController(const AdmissionController&) = delete;
+
+    base::Status AdmitPut(uint64_t request_bytes, Ticket* ticket);
+
+    // a query is still admitted above the memory high water mark if no other query is running,
+    // so that the tablet keeps serving reads one by one
+    base::Status AdmitQuery(uint64_t request_bytes, Ticket* ticket);
+
+    // the memory used is the larger one of the record bytes of the tables and the bytes allocated from tcmalloc,
+    // it is refreshed in background
+    void SetMemoryUsed(uint64_t table_bytes, uint64_t allocated_bytes);
+
+    inline uint64_t GetMemoryHighWaterMark() const { return memory_high_water_mark_; }
+
+    inline int64_t GetInflightQueryCnt() const { return inflight_query_cnt_.load(std::memory_order_relaxed); }
+
+    inline int64_t GetInflightPutCnt() const { return inflight_put_cnt_.load(std::memory_order_relaxed); }
+
+    inline int64_t GetInflightBytes() const { return inflight_bytes_.load(std::memory_order_relaxed); }
+
+    inline int64_t GetMemoryUsed() const { return memory_used_.load(std::memory_order_relaxed); }
+
+    inline int64_t GetRejectCnt() const { return reject_cnt_.load(std::memory_order_relaxed); }
+
+ private:
+    base::Status Admit(bool is_query, uint64_t request_bytes, Ticket* ticket);
+    void Reject() { reject_cnt_.fetch_add(1, std::memory_order_relaxed); }
+
+    uint32_t max_concurrent_query_;
+    uint64_t max_inflight_bytes_;
+    uint64_t memory_high_water_mark_;
+    std::atomic<int64_t> inflight_query_cnt_;
+    std::atomic<int64_t> inflight_put_cnt_;
+    std::atomic<int64_t> inflight_bytes_;
+    std::atomic<int64_t> memory_used_;
+    std::atomic<int64_t> reject_cnt_;
+    std::vector<std::unique_ptr<bvar::PassiveStatus<int64_t>>> vars_;
+};
+
+}  // namespace openmldb::tablet
+#endif  // SRC_TABLET_ADMISSION_CONTROLLER_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/admission_controller.h"
+
+#include "base/glog_wapper.h"
+#include "gtest/gtest.h"
+
+namespace openmldb::tablet {
+
+class AdmissionControllerTest : public ::testing::Test {};
+
+TEST_F(AdmissionControllerTest, concurrent_query) {
+    AdmissionController controller(2, 0, 0);
+    AdmissionController::Ticket t1, t2, t3;
+    ASSERT_TRUE(controller.AdmitQuery(10, &t1).OK());
+    ASSERT_TRUE(controller.AdmitQuery(10, &t2).OK());
+    auto status = controller.AdmitQuery(10, &t3);
+    ASSERT_EQ(base::ReturnCode::kTabletOverloaded, status.code);
+    ASSERT_EQ(2, controller.GetInflightQueryCnt());
+    ASSERT_EQ(20, controller.GetInflightBytes());
+    ASSERT_EQ(1, controller.GetRejectCnt());
+    // puts are not limited by the count of queries
+    AdmissionController::Ticket put_ticket;
+    ASSERT_TRUE(controller.AdmitPut(10, &put_ticket).OK());
+    ASSERT_EQ(1, controller.GetInflightPutCnt());
+    t1.Release();
+    ASSERT_TRUE(controller.AdmitQuery(10, &t3).OK());
+    {
+        AdmissionController::Ticket t4;
+        ASSERT_FALSE(controller.AdmitQuery(10, &t4).OK());
+    }
+    t2.Release();
+    t3.Release();
+    put_ticket.Release();
+    ASSERT_EQ(0, controller.GetInflightQueryCnt());
+    ASSERT_EQ(0, controller.GetInflightPutCnt());
+    ASSERT_EQ(0, controller.GetInflightBytes());
+}
+
+TEST_F(AdmissionControllerTest, inflight_bytes) {
+    AdmissionController controller(0, 100, 0);
+    AdmissionController::Ticket t1, t2;
+    // a request larger than the limit is admitted when nothing else is in flight
+    ASSERT_TRUE(controller.AdmitQuery(200, &t1).OK());
+    ASSERT_FALSE(controller.AdmitPut(1, &t2).OK());
+    t1.Release();
+    ASSERT_TRUE(controller.AdmitPut(60, &t1).OK());
+    ASSERT_TRUE(controller.AdmitPut(40, &t2).OK());
+    {
+        AdmissionController::Ticket t3;
+        ASSERT_EQ(base::ReturnCode::kTabletOverloaded, controller.AdmitQuery(1, &t3).code);
+    }
+    ASSERT_EQ(100, controller.GetInflightBytes());
+    ASSERT_EQ(2, controller.GetRejectCnt());
+}
+
+TEST_F(AdmissionControllerTest, memory_high_water_mark) {
+    AdmissionController controller(0, 0, 1000);
+    AdmissionController::Ticket t1, t2;
+    controller.SetMemoryUsed(500, 800);
+    ASSERT_EQ(800, controller.GetMemoryUsed());
+    ASSERT_TRUE(controller.AdmitPut(10, &t1).OK());
+    t1.Release();
+    controller.SetMemoryUsed(1200, 0);
+    ASSERT_FALSE(controller.AdmitPut(10, &t1).OK());
+    // only one query runs at a time above the high water mark
+    ASSERT_TRUE(controller.AdmitQuery(10, &t1).OK());
+    ASSERT_FALSE(controller.AdmitQuery(10, &t2).OK());
+    t1.Release();
+    controller.SetMemoryUsed(100, 100);
+    ASSERT_TRUE(controller.AdmitPut(10, &t1).OK());
+    ASSERT_TRUE(controller.AdmitQuery(10, &t2).OK());
+}
+
+}  // namespace openmldb::tablet
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/deploy_latency.h"
+
+#include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
+namespace openmldb::tablet {
+
+namespace {
+
+const char* const kStageNames[kDeployStageCount] = {"total", "compile", "run", "encode"};
+
+int64_t GetCount(void* arg) {
+    return static_cast<int64_t>(static_cast<const statistics::LatencyHistogram*>(arg)->GetCount());
+}
+
+template <int PerMille>
+int64_t GetPercentile(void* arg) {
+    return static_cast<int64_t>(
+        static_cast<const statistics::LatencyHistogram*>(arg)->GetPercentile(PerMille / 1000.0));
+}
+
+// bvar lower cases a var name and turns any other character into a single '_', e.g. "aB" and "a__b" are both
+// exposed as "a_b". So a name bvar keeps as is is written as <length>_<name>, any other name is written as
+// <length>x_<hex of name>. The length tells where the name ends, so two deployments never share a var name
+bool IsVarSafe(const std::string& name) {
+    if (name.empty() || name.front() == '_' || name.back() == '_' || absl::StrContains(name, "__")) {
+        return false;
+    }
+    for (char c : name) {
+        if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AppendVarName(const std::string& name, std::string* out) {
+    if (IsVarSafe(name)) {
+        absl::StrAppend(out, name.size(), "_", name);
+    } else {
+        std::string hex = absl::BytesToHexString(name);
+        absl::StrAppend(out, hex.size(), "x_", hex);
+    }
+}
+
+std::string GetVarPrefix(const std::string& db, const std::string& deploy_name) {
+    std::string prefix = "deploy_";
+    AppendVarName(db, &prefix);
+    prefix.push_back('_');
+    AppendVarName(deploy_name, &prefix);
+    return prefix;
+}
+
+}  // namespace
+
+DeployLatency::DeployLatency(const std::string& var_prefix) {
+    for (size_t stage = 0; stage < kDeployStageCount; stage++) {
+        std::string prefix = absl::StrCat(var_prefix, "_", kStageNames[stage], "_latency");
+        void* arg = &histograms_[stage];
+        vars_.emplace_back(new bvar::PassiveStatus<int64_t>(prefix, "count", GetCount, arg));
+        vars_.emplace_back(new bvar::PassiveStatus<int64_t>(prefix, "p50", GetPercentile<500>, arg));
+        vars_.emplace_back(new bvar::PassiveStatus<int64_t>(prefix, "p99", GetPercentile<990>, arg));
+        vars_.emplace_back(new bvar::PassiveStatus<int64_t>(prefix, "p999", GetPercentile<999>, arg));
+    }
+}
+
+std::shared_ptr<DeployLatency> DeployLatencyMgr::Get(const std::string& db, const std::string& deploy_name) {
+    std::string key = GetVarPrefix(db, deploy_name);
+    {
+        absl::ReaderMutexLock lock(&mutex_);
+        auto it = deploys_.find(key);
+        if (it != deploys_.end()) {
+            return it->second;
+        }
+    }
+    absl::WriterMutexLock lock(&mutex_);
+    auto it = deploys_.find(key);
+    if (it != deploys_.end()) {
+        return it->second;
+    }
+    auto latency = std::make_shared<DeployLatency>(key);
+    deploys_.emplace(key, latency);
+    return latency;
+}
+
+void DeployLatencyMgr::Delete(const std::string& db, const std::string& deploy_name) {
+    absl::WriterMutexLock lock(&mutex_);
+    auto it = deploys_.find(GetVarPrefix(db, deploy_name));
+    if (it == deploys_.end()) {
+        return;
+    }
+    it->second->Hide();
+    deploys_.erase(it);
+}
+
+}  // namespace openmldb::tablet
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_DEPLOY_LATENCY_H_
+#define SRC_TABLET_DEPLOY_LATENCY_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "bvar/bvar.h"
+#include "statistics/query_response_time/latency_histogram.h"
+
+namespace openmldb::tablet {
+
+// the stages of serving a deployment request. kRun covers both the storage scan and the jit
+// execution, they are interleaved inside the engine
+enum class DeployStage { kTotal = 0, kCompile, kRun, kEncode };
+
+constexpr size_t kDeployStageCount = 4;
+
+// The latency histograms of a deployment, exposed as bvars named
+// deploy_<db>_<deployment>_<stage>_latency_{count,p50,p99,p999} in us, which also show up in /brpc_metrics.
+// <db> and <deployment> are encoded by DeployLatencyMgr so that the names of different deployments never collide
+class DeployLatency {
+ public:
+    explicit DeployLatency(const std::string& var_prefix);
+
+    DeployLatency(const DeployLatency&) = delete;
+
+    inline void Record(DeployStage stage, absl::Duration time) { histograms_[static_cast<size_t>(stage)].Record(time); }
+
+    // hide the bvars, the requests still holding the latency keep recording to the histograms only
+    void Hide() { vars_.clear(); }
+
+    inline const statistics::LatencyHistogram& GetHistogram(DeployStage stage) const {
+        return histograms_[static_cast<size_t>(stage)];
+    }
+
+ private:
+    statistics::LatencyHistogram histograms_[kDeployStageCount];
+    std::vector<std::unique_ptr<bvar::PassiveStatus<int64_t>>> vars_;
+};
+
+class DeployLatencyMgr {
+ public:
+    // the latency of a deployment, it is created on the first request
+    std::shared_ptr<DeployLatency> Get(const std::string& db, const std::string& deploy_name) LOCKS_EXCLUDED(mutex_);
+
+    // hide the bvars of the deployment before it is removed, so the deployment can be created again with the same
+    // bvar names
+    void Delete(const std::string& db, const std::string& deploy_name) LOCKS_EXCLUDED(mutex_);
+
+ private:
+    std::unordered_map<std::string, std::shared_ptr<DeployLatency>> deploys_ GUARDED_BY(mutex_);
+    absl::Mutex mutex_;  // protects deploys_
+};
+
+}  // namespace openmldb::tablet
+
+#endif  // SRC_TABLET_DEPLOY_LATENCY_H_
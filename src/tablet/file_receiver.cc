@@ -16,15 +16,28 @@
 
 #include "tablet/file_receiver.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+
 #include "base/file_util.h"
 #include "base/glog_wapper.h"
 #include "base/strings.h"
+#include "log/crc32c.h"
 
 namespace openmldb {
 namespace tablet {
 
 FileReceiver::FileReceiver(const std::string& file_name, const std::string& dir_name, const std::string& path)
-    : file_name_(file_name), dir_name_(dir_name), path_(path), size_(0), block_id_(0), file_(NULL) {}
+    : file_name_(file_name),
+      dir_name_(dir_name),
+      path_(path),
+      size_(0),
+      block_id_(0),
+      file_(NULL),
+      mu_(),
+      received_size_(0),
+      pending_blocks_() {}
 
 FileReceiver::~FileReceiver() {
     if (file_) fclose(file_);
@@ -50,6 +63,10 @@ bool FileReceiver::Init() {
     }
     file_ = file;
     block_id_ = 0;
+    size_ = 0;
+    std::lock_guard<std::mutex> lock(mu_);
+    received_size_ = 0;
+    pending_blocks_.clear();
     return true;
 }
 
@@ -80,7 +97,52 @@ int FileReceiver::WriteData(const std::string& data, uint64_t block_id) {
     return 0;
 }
 
+int FileReceiver::WriteData(const std::string& data, uint64_t offset, uint32_t crc) {
+    if (file_ == NULL) {
+        PDLOG(WARNING, "file is NULL");
+        return -1;
+    }
+    if (::openmldb::log::Value(data.c_str(), data.size()) != crc) {
+        PDLOG(WARNING, "crc mismatch. name %s%s offset %lu", path_.c_str(), file_name_.c_str(), offset);
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (offset + data.size() <= received_size_) {
+            DEBUGLOG("block at offset %lu has been received", offset);
+            return 0;
+        }
+    }
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t r = pwrite(fileno(file_), data.c_str() + written, data.size() - written, offset + written);
+        if (r < 0) {
+            PDLOG(WARNING, "write error. name %s%s offset %lu", path_.c_str(), file_name_.c_str(), offset);
+            return -1;
+        }
+        written += r;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    pending_blocks_[offset] = offset + data.size();
+    // advance over the blocks which have no hole before them
+    auto iter = pending_blocks_.begin();
+    while (iter != pending_blocks_.end() && iter->first <= received_size_) {
+        received_size_ = std::max(received_size_, iter->second);
+        iter = pending_blocks_.erase(iter);
+    }
+    size_ = received_size_;
+    return 0;
+}
+
+uint64_t FileReceiver::GetReceivedSize() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return received_size_;
+}
+
 void FileReceiver::SaveFile() {
+    if (file_ != NULL) {
+        fflush(file_);
+    }
     std::string full_path = path_ + file_name_;
     std::string tmp_file_path = full_path + ".tmp";
     if (::openmldb::base::IsExists(full_path)) {
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <map>
+#include <mutex>  // NOLINT
 #include <string>
 
 namespace openmldb {
@@ -29,8 +31,12 @@ class FileReceiver {
     FileReceiver& operator=(const FileReceiver&) = delete;
     bool Init();
     int WriteData(const std::string& data, uint64_t block_id);
+    // write a block at `offset` after checking its crc32c, the blocks may arrive out of order
+    int WriteData(const std::string& data, uint64_t offset, uint32_t crc);
     void SaveFile();
     uint64_t GetBlockId();
+    // the size of the data received from the start of the file without holes
+    uint64_t GetReceivedSize();
 
  private:
     std::string file_name_;
@@ -39,6 +45,10 @@ class FileReceiver {
     uint64_t size_;
     uint64_t block_id_;
     FILE* file_;
+    std::mutex mu_;
+    uint64_t received_size_;
+    // the blocks received after a hole, offset -> end
+    std::map<uint64_t, uint64_t> pending_blocks_;
 };
 
 }  // namespace tablet
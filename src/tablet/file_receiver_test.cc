@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/file_receiver.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "base/file_util.h"
+#include "base/glog_wapper.h"
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+#include "log/crc32c.h"
+
+namespace openmldb {
+namespace tablet {
+
+class FileReceiverTest : public ::testing::Test {
+ public:
+    FileReceiverTest() {}
+    ~FileReceiverTest() {}
+};
+
+static std::string ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+TEST_F(FileReceiverTest, OutOfOrder) {
+    std::string path = "/tmp/file_receiver_test/out_of_order/";
+    ::openmldb::base::RemoveDirRecursive(path);
+    FileReceiver receiver("data", "", path);
+    ASSERT_TRUE(receiver.Init());
+    std::string block1(100, 'a');
+    std::string block2(100, 'b');
+    std::string block3(50, 'c');
+    ASSERT_EQ(0, receiver.WriteData(block3, 200, ::openmldb::log::Value(block3.data(), block3.size())));
+    ASSERT_EQ(0u, receiver.GetReceivedSize());
+    ASSERT_EQ(0, receiver.WriteData(block1, 0, ::openmldb::log::Value(block1.data(), block1.size())));
+    ASSERT_EQ(100u, receiver.GetReceivedSize());
+    // the block with a wrong crc is rejected
+    ASSERT_EQ(-1, receiver.WriteData(block2, 100, ::openmldb::log::Value(block1.data(), block1.size())));
+    ASSERT_EQ(100u, receiver.GetReceivedSize());
+    ASSERT_EQ(0, receiver.WriteData(block2, 100, ::openmldb::log::Value(block2.data(), block2.size())));
+    ASSERT_EQ(250u, receiver.GetReceivedSize());
+    // a block which has been received is skipped
+    ASSERT_EQ(0, receiver.WriteData(block1, 0, ::openmldb::log::Value(block1.data(), block1.size())));
+    ASSERT_EQ(250u, receiver.GetReceivedSize());
+    receiver.SaveFile();
+    ASSERT_EQ(block1 + block2 + block3, ReadFile(path + "data"));
+}
+
+TEST_F(FileReceiverTest, Reinit) {
+    std::string path = "/tmp/file_receiver_test/reinit/";
+    ::openmldb::base::RemoveDirRecursive(path);
+    FileReceiver receiver("data", "", path);
+    ASSERT_TRUE(receiver.Init());
+    std::string block(100, 'a');
+    ASSERT_EQ(0, receiver.WriteData(block, 0, ::openmldb::log::Value(block.data(), block.size())));
+    ASSERT_EQ(100u, receiver.GetReceivedSize());
+    // a new transfer starts from the beginning
+    ASSERT_TRUE(receiver.Init());
+    ASSERT_EQ(0u, receiver.GetReceivedSize());
+}
+
+}  // namespace tablet
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    return RUN_ALL_TESTS();
+}
@@ -16,21 +16,29 @@
 
 #include "tablet/file_sender.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <thread>  // NOLINT
 #include <vector>
 
 #include "base/file_util.h"
 #include "base/glog_wapper.h"
+#include "brpc/callback.h"
 #include "boost/algorithm/string/predicate.hpp"
 #include "common/timer.h"
 #include "gflags/gflags.h"
+#include "log/crc32c.h"
 
 DECLARE_int32(send_file_max_try);
 DECLARE_uint32(stream_block_size);
 DECLARE_int32(stream_bandwidth_limit);
-DECLARE_uint32(stream_block_size);
-DECLARE_int32(stream_bandwidth_limit);
-DECLARE_int32(stream_close_wait_time_ms);
+DECLARE_uint32(stream_max_inflight_blocks);
+DECLARE_uint32(send_file_concurrency);
 DECLARE_int32(retry_send_file_wait_time_ms);
 DECLARE_int32(request_max_retry);
 DECLARE_int32(request_timeout_ms);
@@ -38,13 +46,23 @@ DECLARE_int32(request_timeout_ms);
 namespace openmldb {
 namespace tablet {
 
+namespace {
+
+struct SendDataCall {
+    brpc::Controller cntl;
+    ::openmldb::api::SendDataRequest request;
+    ::openmldb::api::SendDataResponse response;
+};
+
+}  // namespace
+
 FileSender::FileSender(uint32_t tid, uint32_t pid, const std::string& endpoint)
     : tid_(tid),
       pid_(pid),
       endpoint_(endpoint),
       cur_try_time_(0),
       max_try_time_(FLAGS_send_file_max_try),
-      limit_time_(0),
+      limit_next_time_(0),
       channel_(NULL),
       stub_(NULL) {}
 
@@ -54,12 +72,6 @@ FileSender::~FileSender() {
 }
 
 bool FileSender::Init() {
-    // compute the used time(microseconds) that send a block by limit bandwidth.
-    // limit_time = (FLAGS_stream_block_size / FLAGS_stream_bandwidth_limit) *
-    // 1000 * 1000
-    if (FLAGS_stream_bandwidth_limit > 0) {
-        limit_time_ = (FLAGS_stream_block_size * 1000000) / FLAGS_stream_bandwidth_limit;
-    }
     channel_ = new brpc::Channel();
     brpc::ChannelOptions options;
     options.timeout_ms = FLAGS_request_timeout_ms;
@@ -78,7 +90,7 @@ int FileSender::WriteData(const std::string& file_name, const std::string& dir_n
     if (buffer == NULL) {
         return -1;
     }
-    uint64_t cur_time = ::baidu::common::timer::get_micros();
+    Throttle(len);
     ::openmldb::api::SendDataRequest request;
     request.set_tid(tid_);
     request.set_pid(pid_);
@@ -95,7 +107,7 @@ int FileSender::WriteData(const std::string& file_name, const std::string& dir_n
     if (len > 0 && len < FLAGS_stream_block_size) {
         request.set_eof(true);
     }
-    ::openmldb::api::GeneralResponse response;
+    ::openmldb::api::SendDataResponse response;
     stub_->SendData(&cntl, &request, &response, NULL);
     if (cntl.Failed()) {
         PDLOG(WARNING, "send data failed. tid %u pid %u file %s error msg %s", tid_, pid_, file_name.c_str(),
@@ -106,15 +118,29 @@ int FileSender::WriteData(const std::string& file_name, const std::string& dir_n
               response.msg().c_str());
         return -1;
     }
-    uint64_t time_used = ::baidu::common::timer::get_micros() - cur_time;
-    if (limit_time_ > time_used && len > FLAGS_stream_block_size / 2) {
-        uint64_t sleep_time = limit_time_ - time_used;
-        DEBUGLOG("sleep %lu us, limit_time %lu time_used %lu", sleep_time, limit_time_, time_used);
-        std::this_thread::sleep_for(std::chrono::microseconds(sleep_time));
-    }
     return 0;
 }
 
+void FileSender::Throttle(uint64_t len) {
+    if (FLAGS_stream_bandwidth_limit <= 0 || len == 0) {
+        return;
+    }
+    uint64_t cost = len * 1000000 / FLAGS_stream_bandwidth_limit;
+    uint64_t now = ::baidu::common::timer::get_micros();
+    uint64_t start = 0;
+    {
+        // all the threads of the sender reserve their blocks in turn, the bandwidth unused while idle is not
+        // saved up for a burst
+        std::lock_guard<std::mutex> lock(limit_mu_);
+        start = std::max(limit_next_time_, now);
+        limit_next_time_ = start + cost;
+    }
+    if (start > now) {
+        DEBUGLOG("sleep %lu us to send %lu bytes", start - now, len);
+        std::this_thread::sleep_for(std::chrono::microseconds(start - now));
+    }
+}
+
 int FileSender::SendFile(const std::string& file_name, const std::string& full_path) {
     return SendFile(file_name, "", full_path);
 }
@@ -138,8 +164,9 @@ int FileSender::SendFile(const std::string& file_name, const std::string& dir_na
             PDLOG(INFO, "retry to send file %s to %s. total size[%lu]", full_path.c_str(), endpoint_.c_str(),
                   file_size);
         }
+        bool resume = try_times < FLAGS_send_file_max_try;
         try_times--;
-        if (SendFileInternal(file_name, dir_name, full_path, file_size) < 0) {
+        if (SendFileInternal(file_name, dir_name, full_path, file_size, resume) < 0) {
             continue;
         }
         if (CheckFile(file_name, dir_name, file_size) < 0) {
@@ -150,57 +177,219 @@ int FileSender::SendFile(const std::string& file_name, const std::string& dir_na
     return -1;
 }
 
+int FileSender::SendFiles(const std::vector<std::pair<std::string, std::string>>& files, const std::string& dir_name) {
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    auto send = [&]() {
+        for (size_t i = next++; i < files.size() && !failed.load(std::memory_order_relaxed); i = next++) {
+            if (SendFile(files[i].first, dir_name, files[i].second) < 0) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+    size_t concurrency = std::min<size_t>(std::max(FLAGS_send_file_concurrency, 1u), files.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < concurrency; i++) {
+        threads.emplace_back(send);
+    }
+    send();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return failed.load(std::memory_order_relaxed) ? -1 : 0;
+}
+
+int FileSender::InitReceiver(const std::string& file_name, const std::string& dir_name, bool resume,
+                             uint64_t* offset, bool* pipelined) {
+    ::openmldb::api::SendDataRequest request;
+    request.set_tid(tid_);
+    request.set_pid(pid_);
+    request.set_file_name(file_name);
+    if (!dir_name.empty()) {
+        request.set_dir_name(dir_name);
+    }
+    request.set_block_id(0);
+    request.set_block_size(0);
+    request.set_offset(0);
+    request.set_resume(resume);
+    brpc::Controller cntl;
+    ::openmldb::api::SendDataResponse response;
+    stub_->SendData(&cntl, &request, &response, NULL);
+    if (cntl.Failed()) {
+        PDLOG(WARNING, "init file receiver failed. tid %u pid %u file %s error msg %s", tid_, pid_, file_name.c_str(),
+              cntl.ErrorText().c_str());
+        return -1;
+    } else if (response.code() != 0) {
+        PDLOG(WARNING, "init file receiver failed. tid %u pid %u file %s error msg %s", tid_, pid_, file_name.c_str(),
+              response.msg().c_str());
+        return -1;
+    }
+    // the receivers of old versions answer with a GeneralResponse, which has no received size
+    *pipelined = response.has_received_size();
+    *offset = response.received_size();
+    return 0;
+}
+
 int FileSender::SendFileInternal(const std::string& file_name, const std::string& dir_name,
-                                 const std::string& full_path, uint64_t file_size) {
-    FILE* file = fopen(full_path.c_str(), "rb");
-    if (file == NULL) {
+                                 const std::string& full_path, uint64_t file_size, bool resume) {
+    uint64_t offset = 0;
+    bool pipelined = false;
+    if (InitReceiver(file_name, dir_name, resume, &offset, &pipelined) < 0) {
+        return -1;
+    }
+    if (!pipelined) {
+        PDLOG(INFO, "receiver does not support pipelined transfer, send file %s sequentially. endpoint[%s]",
+              file_name.c_str(), endpoint_.c_str());
+        return SendFileSequential(file_name, dir_name, full_path, file_size);
+    }
+    if (offset > file_size && InitReceiver(file_name, dir_name, false, &offset, &pipelined) < 0) {
+        return -1;
+    }
+    if (offset > 0) {
+        PDLOG(INFO, "resume to send file %s from offset %lu. tid[%u] pid[%u] endpoint[%s]", file_name.c_str(), offset,
+              tid_, pid_, endpoint_.c_str());
+    }
+    int fd = open(full_path.c_str(), O_RDONLY);
+    if (fd < 0) {
         PDLOG(WARNING, "fail to open file %s", full_path.c_str());
         return -1;
     }
-    char buffer[FLAGS_stream_block_size];
-
-    uint64_t block_num = file_size / FLAGS_stream_block_size + 1;
+    uint64_t block_size = FLAGS_stream_block_size;
+    uint64_t block_num = file_size / block_size + 1;
     uint64_t report_block_num = block_num / 100;
+    uint32_t max_window = std::max(FLAGS_stream_max_inflight_blocks, 1u);
+    uint32_t window = 1;
+    uint64_t min_latency = UINT64_MAX;
+    std::deque<std::unique_ptr<SendDataCall>> calls;
+    // wait for the oldest block. The ack of a block is sent after it is written, so the latency follows the
+    // disk of the receiver, the window grows while the latency is stable and halves when it rises
+    auto wait = [&]() {
+        auto call = std::move(calls.front());
+        calls.pop_front();
+        brpc::Join(call->cntl.call_id());
+        if (call->cntl.Failed()) {
+            PDLOG(WARNING, "send data failed. tid %u pid %u file %s offset %lu error msg %s", tid_, pid_,
+                  file_name.c_str(), call->request.offset(), call->cntl.ErrorText().c_str());
+            return -1;
+        } else if (call->response.code() != 0) {
+            PDLOG(WARNING, "send data failed. tid %u pid %u file %s offset %lu error msg %s", tid_, pid_,
+                  file_name.c_str(), call->request.offset(), call->response.msg().c_str());
+            return -1;
+        }
+        uint64_t latency = call->cntl.latency_us();
+        min_latency = std::min(min_latency, latency);
+        if (latency > min_latency * 2) {
+            window = std::max(window / 2, 1u);
+        } else if (window < max_window) {
+            window++;
+        }
+        return 0;
+    };
+    std::string buffer(block_size, '\0');
     int ret = 0;
-    uint64_t block_count = 0;
-    do {
-        if (block_count == 0 && WriteData(file_name, dir_name, buffer, 0, block_count) < 0) {
-            PDLOG(WARNING, "Init file receiver failed. tid[%u] pid[%u] file %s", tid_, pid_, file_name.c_str());
+    while (offset < file_size && ret == 0) {
+        while (calls.size() >= window && ret == 0) {
+            ret = wait();
+        }
+        if (ret < 0) {
+            break;
+        }
+        size_t len = std::min(block_size, file_size - offset);
+        if (pread(fd, &buffer[0], len, offset) != static_cast<ssize_t>(len)) {
+            PDLOG(WARNING, "read file %s error. error message: %s", file_name.c_str(), strerror(errno));
             ret = -1;
             break;
         }
-        block_count++;
-
-#ifdef __APPLE__
-        size_t len = fread(buffer, 1, FLAGS_stream_block_size, file);
-#else
-        size_t len = fread_unlocked(buffer, 1, FLAGS_stream_block_size, file);
-#endif
-        if (len < FLAGS_stream_block_size) {
-            if (feof(file)) {
-                if (len > 0) {
-                    ret = WriteData(file_name, dir_name, buffer, len, block_count);
-                }
-                break;
-            }
+        // the bandwidth limit is still the upper bound
+        Throttle(len);
+        auto call = std::make_unique<SendDataCall>();
+        call->request.set_tid(tid_);
+        call->request.set_pid(pid_);
+        call->request.set_file_name(file_name);
+        if (!dir_name.empty()) {
+            call->request.set_dir_name(dir_name);
+        }
+        uint64_t block_id = offset / block_size + 1;
+        call->request.set_block_id(block_id);
+        call->request.set_block_size(len);
+        call->request.set_offset(offset);
+        call->request.set_crc(::openmldb::log::Value(buffer.data(), len));
+        call->cntl.request_attachment().append(buffer.data(), len);
+        stub_->SendData(&call->cntl, &call->request, &call->response, brpc::DoNothing());
+        calls.push_back(std::move(call));
+        offset += len;
+        if (report_block_num == 0 || block_id % report_block_num == 0) {
+            PDLOG(INFO,
+                  "send block num[%lu] total block num[%lu] inflight[%u]. tid[%u] pid[%u] "
+                  "file[%s] endpoint[%s]",
+                  block_id, block_num, window, tid_, pid_, file_name.c_str(), endpoint_.c_str());
+        }
+    }
+    while (!calls.empty()) {
+        if (wait() < 0) {
+            ret = -1;
+        }
+    }
+    close(fd);
+    if (ret < 0) {
+        return -1;
+    }
+    ::openmldb::api::SendDataRequest request;
+    request.set_tid(tid_);
+    request.set_pid(pid_);
+    request.set_file_name(file_name);
+    if (!dir_name.empty()) {
+        request.set_dir_name(dir_name);
+    }
+    request.set_block_id(block_num);
+    request.set_block_size(0);
+    request.set_offset(file_size);
+    request.set_eof(true);
+    brpc::Controller cntl;
+    ::openmldb::api::SendDataResponse response;
+    stub_->SendData(&cntl, &request, &response, NULL);
+    if (cntl.Failed() || response.code() != 0) {
+        PDLOG(WARNING, "finish file %s failed. tid %u pid %u error msg %s", file_name.c_str(), tid_, pid_,
+              cntl.Failed() ? cntl.ErrorText().c_str() : response.msg().c_str());
+        return -1;
+    }
+    return 0;
+}
+
+int FileSender::SendFileSequential(const std::string& file_name, const std::string& dir_name,
+                                   const std::string& full_path, uint64_t file_size) {
+    int fd = open(full_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        PDLOG(WARNING, "fail to open file %s", full_path.c_str());
+        return -1;
+    }
+    uint64_t block_size = FLAGS_stream_block_size;
+    uint64_t block_num = file_size / block_size + 1;
+    uint64_t report_block_num = block_num / 100;
+    std::string buffer(block_size, '\0');
+    int ret = 0;
+    uint64_t offset = 0;
+    for (uint64_t block_id = 1; offset < file_size; block_id++) {
+        size_t len = std::min(block_size, file_size - offset);
+        if (pread(fd, &buffer[0], len, offset) != static_cast<ssize_t>(len)) {
             PDLOG(WARNING, "read file %s error. error message: %s", file_name.c_str(), strerror(errno));
             ret = -1;
             break;
         }
-        if (WriteData(file_name, dir_name, buffer, len, block_count) < 0) {
+        if (WriteData(file_name, dir_name, buffer.data(), len, block_id) < 0) {
             PDLOG(WARNING, "data write failed. tid[%u] pid[%u] file %s", tid_, pid_, file_name.c_str());
             ret = -1;
             break;
         }
-        if (report_block_num == 0 || block_count % report_block_num == 0) {
+        offset += len;
+        if (report_block_num == 0 || block_id % report_block_num == 0) {
             PDLOG(INFO,
                   "send block num[%lu] total block num[%lu]. tid[%u] pid[%u] "
                   "file[%s] endpoint[%s]",
-                  block_count, block_num, tid_, pid_, file_name.c_str(), endpoint_.c_str());
+                  block_id, block_num, tid_, pid_, file_name.c_str(), endpoint_.c_str());
         }
-    } while (true);
-    fclose(file);
-    std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_stream_close_wait_time_ms));
+    }
+    close(fd);
     return ret;
 }
 
@@ -232,12 +421,11 @@ int FileSender::CheckFile(const std::string& file_name, const std::string& dir_n
 int FileSender::SendDir(const std::string& dir_name, const std::string& full_path) {
     std::vector<std::string> file_vec;
     ::openmldb::base::GetFileName(full_path, file_vec);
+    std::vector<std::pair<std::string, std::string>> files;
     for (const std::string& file : file_vec) {
-        if (SendFile(file.substr(file.find_last_of("/") + 1), dir_name, file) < 0) {
-            return -1;
-        }
+        files.emplace_back(file.substr(file.find_last_of("/") + 1), file);
     }
-    return 0;
+    return SendFiles(files, dir_name);
 }
 
 }  // namespace tablet
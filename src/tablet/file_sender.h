@@ -19,7 +19,10 @@
 #include <brpc/channel.h>
 #include <brpc/controller.h>
 
+#include <mutex>  // NOLINT
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "proto/tablet.pb.h"
 
@@ -33,20 +36,37 @@ class FileSender {
     bool Init();
     int SendFile(const std::string& file_name, const std::string& dir_name, const std::string& full_path);
     int SendFile(const std::string& file_name, const std::string& full_path);
+    // send the files of the same dir in parallel, `files` holds the file name and the full path. The threads share
+    // the stream_bandwidth_limit of the sender
+    int SendFiles(const std::vector<std::pair<std::string, std::string>>& files, const std::string& dir_name);
+    // keep up to `stream_max_inflight_blocks` blocks in flight, a retry with `resume` starts from the data
+    // which the receiver has got. It falls back to SendFileSequential if the receiver does not support it
     int SendFileInternal(const std::string& file_name, const std::string& dir_name, const std::string& full_path,
-                         uint64_t file_size);
+                         uint64_t file_size, bool resume);
+    // send the blocks one by one in block_id order, which is the only way the receivers of old versions accept
+    int SendFileSequential(const std::string& file_name, const std::string& dir_name, const std::string& full_path,
+                           uint64_t file_size);
     int SendDir(const std::string& dir_name, const std::string& full_path);
     int WriteData(const std::string& file_name, const std::string& dir_name, const char* buffer, size_t len,
                   uint64_t block_id);
     int CheckFile(const std::string& file_name, const std::string& dir_name, uint64_t file_size);
 
  private:
+    // init the receiver of a file, returns the size it has received. `pipelined` is false if the receiver does not
+    // report the received size, that is it does not place the blocks by offset
+    int InitReceiver(const std::string& file_name, const std::string& dir_name, bool resume, uint64_t* offset,
+                     bool* pipelined);
+    // wait for the share of stream_bandwidth_limit to send `len` bytes
+    void Throttle(uint64_t len);
+
     uint32_t tid_;
     uint32_t pid_;
     std::string endpoint_;
     uint32_t cur_try_time_;
     uint32_t max_try_time_;
-    uint64_t limit_time_;
+    std::mutex limit_mu_;
+    // the time in microseconds when the bandwidth reserved by the sent blocks runs out
+    uint64_t limit_next_time_;
     brpc::Channel* channel_;
     ::openmldb::api::TabletServer_Stub* stub_;
 };
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/query_cursor_mgr.h"
+
+#include <vector>
+
+#include "common/timer.h"
+
+namespace openmldb::tablet {
+
+uint64_t QueryCursorMgr::Add(const std::shared_ptr<QueryCursor>& cursor) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (cursors_.size() >= max_cnt_) {
+        return 0;
+    }
+    uint64_t id = next_id_++;
+    cursor->last_access_time = ::baidu::common::timer::get_millis();
+    cursors_.emplace(id, cursor);
+    return id;
+}
+
+std::shared_ptr<QueryCursor> QueryCursorMgr::Take(uint64_t id) {
+    std::shared_ptr<QueryCursor> cursor;
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = cursors_.find(id);
+    if (it == cursors_.end()) {
+        return nullptr;
+    }
+    cursor = it->second;
+    cursors_.erase(it);
+    if (::baidu::common::timer::get_millis() - cursor->last_access_time > timeout_ms_) {
+        return nullptr;
+    }
+    return cursor;
+}
+
+void QueryCursorMgr::Put(uint64_t id, const std::shared_ptr<QueryCursor>& cursor) {
+    std::lock_guard<std::mutex> lock(mu_);
+    cursor->last_access_time = ::baidu::common::timer::get_millis();
+    cursors_[id] = cursor;
+}
+
+uint32_t QueryCursorMgr::Expire() {
+    // release outside the lock, destroying a cursor releases its runner context
+    std::vector<std::shared_ptr<QueryCursor>> expired;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        uint64_t now = ::baidu::common::timer::get_millis();
+        for (auto it = cursors_.begin(); it != cursors_.end();) {
+            if (now - it->second->last_access_time > timeout_ms_) {
+                expired.push_back(it->second);
+                it = cursors_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return expired.size();
+}
+
+size_t QueryCursorMgr::Size() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return cursors_.size();
+}
+
+}  // namespace openmldb::tablet
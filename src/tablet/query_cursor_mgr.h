@@ -0,0 +1,66 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_QUERY_CURSOR_MGR_H_
+#define SRC_TABLET_QUERY_CURSOR_MGR_H_
+
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "vm/engine.h"
+
+namespace openmldb::tablet {
+
+// An opened batch query whose rows are sent to the client page by page
+struct QueryCursor {
+    QueryCursor(const std::shared_ptr<hybridse::vm::BatchRunCursor>& run_cursor, const std::string& encoded_schema)
+        : cursor(run_cursor), schema(encoded_schema), last_access_time(0) {}
+    std::shared_ptr<hybridse::vm::BatchRunCursor> cursor;
+    std::string schema;
+    uint64_t last_access_time;
+};
+
+class QueryCursorMgr {
+ public:
+    QueryCursorMgr(uint32_t max_cnt, uint64_t timeout_ms) : max_cnt_(max_cnt), timeout_ms_(timeout_ms) {}
+
+    // register a cursor and return its id, return 0 if too many cursors are opened
+    uint64_t Add(const std::shared_ptr<QueryCursor>& cursor);
+
+    // take the cursor out, so that a cursor is read by only one request at a time.
+    // return nullptr if the cursor does not exist or it is expired
+    std::shared_ptr<QueryCursor> Take(uint64_t id);
+
+    // give back a cursor taken before, it will be read by the next page request
+    void Put(uint64_t id, const std::shared_ptr<QueryCursor>& cursor);
+
+    // release the cursors idle for more than timeout, return the count of released cursors
+    uint32_t Expire();
+
+    size_t Size();
+
+ private:
+    uint32_t max_cnt_;
+    uint64_t timeout_ms_;
+    std::mutex mu_;
+    uint64_t next_id_ = 1;
+    std::map<uint64_t, std::shared_ptr<QueryCursor>> cursors_;
+};
+
+}  // namespace openmldb::tablet
+#endif  // SRC_TABLET_QUERY_CURSOR_MGR_H_
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/query_cursor_mgr.h"
+
+#include <unistd.h>
+
+#include <memory>
+
+#include "base/glog_wapper.h"
+#include "gtest/gtest.h"
+
+namespace openmldb::tablet {
+
+class QueryCursorMgrTest : public ::testing::Test {};
+
+TEST_F(QueryCursorMgrTest, take_and_put) {
+    QueryCursorMgr mgr(2, 60000);
+    auto cursor = std::make_shared<QueryCursor>(nullptr, "schema");
+    uint64_t id = mgr.Add(cursor);
+    ASSERT_NE(0u, id);
+    ASSERT_EQ(1u, mgr.Size());
+    // a cursor can be taken by only one request at a time
+    ASSERT_EQ(cursor, mgr.Take(id));
+    ASSERT_EQ(nullptr, mgr.Take(id));
+    mgr.Put(id, cursor);
+    ASSERT_EQ(cursor, mgr.Take(id));
+    ASSERT_EQ(0u, mgr.Size());
+    ASSERT_EQ(nullptr, mgr.Take(id + 1));
+}
+
+TEST_F(QueryCursorMgrTest, max_cnt) {
+    QueryCursorMgr mgr(2, 60000);
+    ASSERT_NE(0u, mgr.Add(std::make_shared<QueryCursor>(nullptr, "")));
+    uint64_t id = mgr.Add(std::make_shared<QueryCursor>(nullptr, ""));
+    ASSERT_NE(0u, id);
+    ASSERT_EQ(0u, mgr.Add(std::make_shared<QueryCursor>(nullptr, "")));
+    auto cursor = mgr.Take(id);
+    ASSERT_NE(nullptr, cursor);
+    ASSERT_NE(0u, mgr.Add(std::make_shared<QueryCursor>(nullptr, "")));
+}
+
+TEST_F(QueryCursorMgrTest, expire) {
+    QueryCursorMgr mgr(8, 10);
+    uint64_t id1 = mgr.Add(std::make_shared<QueryCursor>(nullptr, ""));
+    uint64_t id2 = mgr.Add(std::make_shared<QueryCursor>(nullptr, ""));
+    ASSERT_EQ(0u, mgr.Expire());
+    sleep(1);
+    auto cursor = mgr.Take(id1);
+    ASSERT_EQ(nullptr, cursor);
+    ASSERT_EQ(1u, mgr.Expire());
+    ASSERT_EQ(0u, mgr.Size());
+    ASSERT_EQ(nullptr, mgr.Take(id2));
+}
+
+}  // namespace openmldb::tablet
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    return RUN_ALL_TESTS();
+}
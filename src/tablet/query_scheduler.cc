@@ -0,0 +1,100 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/query_scheduler.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "base/yield_point.h"
+#include "common/timer.h"
+
+namespace openmldb::tablet {
+
+namespace {
+
+// the clock is read once in every kCheckInterval yield points
+constexpr uint32_t kCheckInterval = 64;
+constexpr uint64_t kYieldSliceUs = 100;
+
+thread_local uint32_t check_cnt = 0;
+thread_local uint64_t last_yield_time = 0;
+
+int64_t ReadRunningRequestCnt(void* arg) { return static_cast<QueryScheduler*>(arg)->GetRunningRequestCnt(); }
+
+int64_t ReadYieldCnt(void* arg) { return static_cast<QueryScheduler*>(arg)->GetYieldCnt(); }
+
+int64_t ReadPendingBatchCnt(void* arg) { return static_cast<QueryScheduler*>(arg)->GetPendingBatchCnt(); }
+
+}  // namespace
+
+QueryScheduler::QueryScheduler(uint32_t batch_thread_num, uint64_t run_quantum_us, uint64_t max_yield_us)
+    : batch_pool_(),
+      run_quantum_us_(run_quantum_us),
+      max_yield_us_(max_yield_us),
+      running_request_cnt_(0),
+      yield_cnt_(0) {
+    if (batch_thread_num > 0) {
+        batch_pool_ = std::make_unique<::baidu::common::ThreadPool>(batch_thread_num);
+    }
+    vars_.emplace_back(
+        new bvar::PassiveStatus<int64_t>("tablet_scheduler", "running_request", ReadRunningRequestCnt, this));
+    vars_.emplace_back(
+        new bvar::PassiveStatus<int64_t>("tablet_scheduler", "pending_batch", ReadPendingBatchCnt, this));
+    vars_.emplace_back(new bvar::PassiveStatus<int64_t>("tablet_scheduler", "yield", ReadYieldCnt, this));
+}
+
+QueryScheduler::~QueryScheduler() {
+    // hide the vars before the pool is gone
+    vars_.clear();
+    if (batch_pool_) {
+        batch_pool_->Stop(true);
+    }
+}
+
+void QueryScheduler::RunBatch(const boost::function<void()>& task) {
+    batch_pool_->AddTask([this, task]() {
+        base::YieldPoint::Guard guard(&QueryScheduler::YieldHandler, this);
+        task();
+    });
+}
+
+void QueryScheduler::Yield() {
+    if (max_yield_us_ == 0 || ++check_cnt < kCheckInterval) {
+        return;
+    }
+    check_cnt = 0;
+    if (running_request_cnt_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    uint64_t now = ::baidu::common::timer::get_micros();
+    if (now < last_yield_time + run_quantum_us_) {
+        return;
+    }
+    yield_cnt_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t waited = 0;
+    while (waited < max_yield_us_ && running_request_cnt_.load(std::memory_order_relaxed) > 0) {
+        uint64_t slice = std::min(kYieldSliceUs, max_yield_us_ - waited);
+        usleep(slice);
+        waited += slice;
+    }
+    last_yield_time = ::baidu::common::timer::get_micros();
+}
+
+int64_t QueryScheduler::GetPendingBatchCnt() const { return batch_pool_ ? batch_pool_->PendingNum() : 0; }
+
+}  // namespace openmldb::tablet
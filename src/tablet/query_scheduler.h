@@ -0,0 +1,88 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_QUERY_SCHEDULER_H_
+#define SRC_TABLET_QUERY_SCHEDULER_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "boost/function.hpp"
+#include "bvar/bvar.h"
+#include "common/thread_pool.h"
+
+namespace openmldb::tablet {
+
+// Priorities of the work in a tablet:
+//  - latency critical: the request mode queries and deployments, they run in brpc workers and hold a RequestGuard
+//  - batch: the batch queries, they run on a separate executor of a few threads if it is enabled
+//  - background: gc and the other maintenance tasks on the tablet thread pools
+// The batch and background work yield at the storage iterator boundaries while latency critical requests are
+// running. A low priority thread runs at least run_quantum_us between two yields, each of which lasts at most
+// max_yield_us, so it still gets a share of cpu under a steady load of requests.
+// The counters are exposed as bvars named tablet_scheduler_*, which also show up in /brpc_metrics
+class QueryScheduler {
+ public:
+    // mark a latency critical request running during the lifetime of the guard
+    class RequestGuard {
+     public:
+        explicit RequestGuard(QueryScheduler* scheduler) : scheduler_(scheduler) {
+            scheduler_->running_request_cnt_.fetch_add(1, std::memory_order_relaxed);
+        }
+        ~RequestGuard() { scheduler_->running_request_cnt_.fetch_sub(1, std::memory_order_relaxed); }
+
+        RequestGuard(const RequestGuard&) = delete;
+        RequestGuard& operator=(const RequestGuard&) = delete;
+
+     private:
+        QueryScheduler* scheduler_;
+    };
+
+    // batch_thread_num of 0 disables the batch executor, max_yield_us of 0 disables yielding
+    QueryScheduler(uint32_t batch_thread_num, uint64_t run_quantum_us, uint64_t max_yield_us);
+    ~QueryScheduler();
+
+    QueryScheduler(const QueryScheduler&) = delete;
+
+    inline bool IsBatchExecutorEnabled() const { return batch_pool_ != nullptr; }
+
+    // run a batch query on the batch executor, the query yields to the latency critical requests
+    void RunBatch(const boost::function<void()>& task);
+
+    // pause the low priority work on current thread if latency critical requests are running.
+    // It is called through base::YieldPoint, install it with base::YieldPoint::Guard(YieldHandler, scheduler)
+    void Yield();
+
+    static void YieldHandler(void* arg) { static_cast<QueryScheduler*>(arg)->Yield(); }
+
+    inline int64_t GetRunningRequestCnt() const { return running_request_cnt_.load(std::memory_order_relaxed); }
+
+    inline int64_t GetYieldCnt() const { return yield_cnt_.load(std::memory_order_relaxed); }
+
+    int64_t GetPendingBatchCnt() const;
+
+ private:
+    std::unique_ptr<::baidu::common::ThreadPool> batch_pool_;
+    uint64_t run_quantum_us_;
+    uint64_t max_yield_us_;
+    std::atomic<int64_t> running_request_cnt_;
+    std::atomic<int64_t> yield_cnt_;
+    std::vector<std::unique_ptr<bvar::PassiveStatus<int64_t>>> vars_;
+};
+
+}  // namespace openmldb::tablet
+#endif  // SRC_TABLET_QUERY_SCHEDULER_H_
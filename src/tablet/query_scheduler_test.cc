@@ -0,0 +1,107 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/query_scheduler.h"
+
+#include <atomic>
+#include <thread>  // NOLINT
+
+#include "base/glog_wapper.h"
+#include "base/yield_point.h"
+#include "common/timer.h"
+#include "gtest/gtest.h"
+
+namespace openmldb::tablet {
+
+class QuerySchedulerTest : public ::testing::Test {};
+
+// call the yield point like a scan of cnt rows, return the time in us
+static uint64_t Scan(uint32_t cnt) {
+    uint64_t start = ::baidu::common::timer::get_micros();
+    for (uint32_t i = 0; i < cnt; i++) {
+        base::YieldPoint::Check();
+    }
+    return ::baidu::common::timer::get_micros() - start;
+}
+
+TEST_F(QuerySchedulerTest, yield) {
+    QueryScheduler scheduler(0, 1000, 5000);
+    ASSERT_FALSE(scheduler.IsBatchExecutorEnabled());
+    // no handler installed on this thread
+    {
+        QueryScheduler::RequestGuard request_guard(&scheduler);
+        Scan(1000);
+        ASSERT_EQ(0, scheduler.GetYieldCnt());
+    }
+    base::YieldPoint::Guard yield_guard(&QueryScheduler::YieldHandler, &scheduler);
+    // no request is running
+    Scan(1000);
+    ASSERT_EQ(0, scheduler.GetYieldCnt());
+    {
+        QueryScheduler::RequestGuard request_guard(&scheduler);
+        ASSERT_EQ(1, scheduler.GetRunningRequestCnt());
+        ASSERT_GE(Scan(64), 5000u);
+        ASSERT_EQ(1, scheduler.GetYieldCnt());
+    }
+    ASSERT_EQ(0, scheduler.GetRunningRequestCnt());
+}
+
+TEST_F(QuerySchedulerTest, yield_stop_when_request_done) {
+    QueryScheduler scheduler(0, 0, 10 * 1000 * 1000);
+    base::YieldPoint::Guard yield_guard(&QueryScheduler::YieldHandler, &scheduler);
+    std::atomic<bool> started(false);
+    std::thread request([&scheduler, &started]() {
+        QueryScheduler::RequestGuard request_guard(&scheduler);
+        started.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+    while (!started.load()) {
+    }
+    // the scan goes on once the request is done instead of waiting for the max yield time
+    ASSERT_LT(Scan(64), 5 * 1000 * 1000u);
+    request.join();
+    ASSERT_EQ(1, scheduler.GetYieldCnt());
+}
+
+TEST_F(QuerySchedulerTest, run_batch) {
+    QueryScheduler scheduler(2, 0, 5000);
+    ASSERT_TRUE(scheduler.IsBatchExecutorEnabled());
+    std::atomic<uint64_t> time(0);
+    std::atomic<bool> done(false);
+    {
+        QueryScheduler::RequestGuard request_guard(&scheduler);
+        // the yield handler is installed on the batch executor
+        scheduler.RunBatch([&time, &done]() {
+            time.store(Scan(64));
+            done.store(true);
+        });
+        while (!done.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    ASSERT_GE(time.load(), 5000u);
+    ASSERT_EQ(1, scheduler.GetYieldCnt());
+    ASSERT_EQ(0, scheduler.GetPendingBatchCnt());
+}
+
+}  // namespace openmldb::tablet
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    return RUN_ALL_TESTS();
+}
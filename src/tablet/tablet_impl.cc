@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory>
+#include <mutex>  // NOLINT
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #ifdef DISALLOW_COPY_AND_ASSIGN
@@ -46,10 +47,13 @@
 #include "base/hash.h"
 #include "base/proto_util.h"
 #include "base/status.h"
+#include "base/yield_point.h"
 #include "base/strings.h"
 #include "brpc/controller.h"
+#include "bthread/bthread.h"
 #include "butil/iobuf.h"
 #include "codec/codec.h"
+#include "codec/index_key_codec.h"
 #include "codec/row_codec.h"
 #include "codec/sql_rpc_row_codec.h"
 #include "common/timer.h"
@@ -58,6 +62,7 @@
 #include "storage/binlog.h"
 #include "storage/segment.h"
 #include "tablet/file_sender.h"
+#include "vm/profile.h"
 #include "absl/cleanup/cleanup.h"
 
 using google::protobuf::RepeatedPtrField;
@@ -70,6 +75,15 @@ DECLARE_int32(gc_interval);
 DECLARE_int32(gc_pool_size);
 DECLARE_int32(statdb_ttl);
 DECLARE_uint32(scan_max_bytes_size);
+DECLARE_uint32(query_cursor_max_cnt);
+DECLARE_uint32(query_cursor_timeout_ms);
+DECLARE_uint32(max_concurrent_query);
+DECLARE_uint64(max_inflight_request_bytes);
+DECLARE_uint64(memory_high_water_mark_mb);
+DECLARE_uint32(memory_check_interval);
+DECLARE_uint32(batch_query_thread_num);
+DECLARE_uint32(low_priority_run_quantum_us);
+DECLARE_uint32(low_priority_max_yield_us);
 DECLARE_uint32(scan_reserve_size);
 DECLARE_double(mem_release_rate);
 DECLARE_string(db_root_path);
@@ -86,6 +100,7 @@ DECLARE_int32(make_snapshot_threshold_offset);
 DECLARE_uint32(get_table_diskused_interval);
 DECLARE_uint32(task_check_interval);
 DECLARE_uint32(load_index_max_wait_time);
+DECLARE_uint32(add_index_backfill_thread_num);
 DECLARE_bool(use_name);
 DECLARE_bool(enable_distsql);
 DECLARE_string(snapshot_compression);
@@ -108,6 +123,13 @@ DECLARE_uint32(snapshot_ttl_check_interval);
 DECLARE_uint32(put_slow_log_threshold);
 DECLARE_uint32(query_slow_log_threshold);
 DECLARE_int32(snapshot_pool_size);
+DECLARE_uint32(split_table_catch_up_round);
+DECLARE_uint32(split_table_clean_delay);
+DECLARE_uint32(hot_key_sample_interval);
+DECLARE_double(hot_key_min_ratio);
+DECLARE_uint32(hot_key_decay_interval);
+DECLARE_uint32(zstd_dict_sample_cnt);
+DECLARE_uint32(zstd_dict_size);
 
 namespace openmldb {
 namespace tablet {
@@ -117,6 +139,25 @@ static const uint32_t SEED = 0xe17a1465;
 
 static constexpr const char DEPLOY_STATS[] = "deploy_stats";
 
+// the rows of a kZstd table are decompressed into a buffer reused by the next row, copy them if kept
+static ::openmldb::base::Slice OwnRow(const ::openmldb::base::Slice& data) {
+    char* row = new char[data.size()];
+    memcpy(row, data.data(), data.size());
+    return ::openmldb::base::Slice(row, data.size(), true);
+}
+
+// the queries run in bthreads, which may resume on another pthread after blocking on the rpc of a sub query,
+// so the profile counters of a run are found through bthread local storage
+static bthread_key_t profile_counters_key;
+
+static ::hybridse::vm::ProfileCounters* GetProfileCounters() {
+    return static_cast<::hybridse::vm::ProfileCounters*>(bthread_getspecific(profile_counters_key));
+}
+
+static void SetProfileCounters(::hybridse::vm::ProfileCounters* counters) {
+    bthread_setspecific(profile_counters_key, counters);
+}
+
 TabletImpl::TabletImpl()
     : tables_(),
       mu_(),
@@ -137,6 +178,12 @@ TabletImpl::TabletImpl()
       zk_path_(),
       endpoint_(),
       sp_cache_(std::shared_ptr<SpCache>(new SpCache())),
+      query_cursor_mgr_(FLAGS_query_cursor_max_cnt, FLAGS_query_cursor_timeout_ms),
+      admission_controller_(FLAGS_max_concurrent_query, FLAGS_max_inflight_request_bytes,
+                            FLAGS_memory_high_water_mark_mb * 1024 * 1024),
+      query_scheduler_(FLAGS_batch_query_thread_num, FLAGS_low_priority_run_quantum_us,
+                       FLAGS_low_priority_max_yield_us),
+      hot_key_sample_cnt_(0),
       notify_path_(),
       globalvar_changed_notify_path_(),
       startup_mode_(::openmldb::type::StartupMode::kStandalone) {}
@@ -168,6 +215,15 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
 
     deploy_collector_ = std::make_unique<::openmldb::statistics::DeployQueryTimeCollector>();
 
+    static std::once_flag profile_slot_once;
+    std::call_once(profile_slot_once, []() {
+        if (bthread_key_create(&profile_counters_key, nullptr) == 0) {
+            ::hybridse::vm::Profiler::SetLocalSlot(GetProfileCounters, SetProfileCounters);
+        } else {
+            LOG(WARNING) << "fail to create bthread key, profile counters fall back to thread local";
+        }
+    });
+
     ::openmldb::base::SplitString(FLAGS_db_root_path, ",", mode_root_paths_);
     ::openmldb::base::SplitString(FLAGS_recycle_bin_root_path, ",", mode_recycle_root_paths_);
     if (!zk_cluster.empty()) {
@@ -225,6 +281,13 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
 
     snapshot_pool_.DelayTask(FLAGS_make_snapshot_check_interval, boost::bind(&TabletImpl::SchedMakeSnapshot, this));
     task_pool_.AddTask(boost::bind(&TabletImpl::GetDiskused, this));
+    task_pool_.DelayTask(FLAGS_query_cursor_timeout_ms, boost::bind(&TabletImpl::SchedExpireQueryCursor, this));
+    if (admission_controller_.GetMemoryHighWaterMark() > 0) {
+        task_pool_.AddTask(boost::bind(&TabletImpl::SchedUpdateMemoryUsed, this));
+    }
+    if (FLAGS_hot_key_sample_interval > 0 && FLAGS_hot_key_decay_interval > 0) {
+        task_pool_.DelayTask(FLAGS_hot_key_decay_interval, boost::bind(&TabletImpl::SchedDecayHotKey, this));
+    }
     if (FLAGS_recycle_ttl != 0) {
         task_pool_.DelayTask(FLAGS_recycle_ttl * 60 * 1000, boost::bind(&TabletImpl::SchedDelRecycle, this));
     }
@@ -412,9 +475,8 @@ int32_t TabletImpl::GetIndex(const ::openmldb::api::GetRequest* request, const :
             if (enable_project) {
                 int8_t* ptr = nullptr;
                 uint32_t size = 0;
-                openmldb::base::Slice data = it->GetValue();
-                const int8_t* row_ptr = reinterpret_cast<const int8_t*>(data.data());
-                bool ok = row_project.Project(row_ptr, data.size(), &ptr, &size);
+                const int8_t* row_ptr = reinterpret_cast<const int8_t*>(it_value.data());
+                bool ok = row_project.Project(row_ptr, it_value.size(), &ptr, &size);
                 if (!ok) {
                     PDLOG(WARNING, "fail to make a projection");
                     return -4;
@@ -465,7 +527,8 @@ int32_t TabletImpl::GetIndex(const ::openmldb::api::GetRequest* request, const :
             value->assign(reinterpret_cast<char*>(ptr), size);
             delete[] ptr;
         } else {
-            value->assign(it->GetValue().data(), it->GetValue().size());
+            openmldb::base::Slice data = it->GetValue();
+            value->assign(data.data(), data.size());
         }
         return 0;
     }
@@ -515,6 +578,7 @@ void TabletImpl::Get(RpcController* controller, const ::openmldb::api::GetReques
             response->set_msg("table is loading");
             return;
         }
+        table->IncrReadCnt();
         std::string index_name;
         if (request->has_idx_name() && request->idx_name().size() > 0) {
             index_name = request->idx_name();
@@ -588,6 +652,12 @@ void TabletImpl::Put(RpcController* controller, const ::openmldb::api::PutReques
         response->set_msg("is follower cluster");
         return;
     }
+    AdmissionController::Ticket ticket;
+    auto admit_status = admission_controller_.AdmitPut(request->ByteSizeLong(), &ticket);
+    if (!admit_status.OK()) {
+        base::SetResponseStatus(admit_status, response);
+        return;
+    }
     uint64_t start_time = ::baidu::common::timer::get_micros();
     std::shared_ptr<Table> table = GetTable(request->tid(), request->pid());
     if (!table) {
@@ -616,6 +686,13 @@ void TabletImpl::Put(RpcController* controller, const ::openmldb::api::PutReques
             response->set_msg("invalid dimension parameter");
             return;
         }
+        for (const auto& dimension : request->dimensions()) {
+            if (table->IsMovedBySplit(dimension.key())) {
+                response->set_code(::openmldb::base::ReturnCode::kPartitionKeyMoved);
+                response->set_msg("key is moved to another partition, refresh the table info and retry");
+                return;
+            }
+        }
         DLOG(INFO) << "put data to tid " << request->tid() << " pid " << request->pid() << " with key "
                    << request->dimensions(0).key();
         ok = table->Put(request->time(), request->value(), request->dimensions());
@@ -625,6 +702,7 @@ void TabletImpl::Put(RpcController* controller, const ::openmldb::api::PutReques
         response->set_msg("put failed");
         return;
     }
+    SchedTrainCompressDict(table);
 
     response->set_code(::openmldb::base::ReturnCode::kOk);
     std::shared_ptr<LogReplicator> replicator;
@@ -752,6 +830,22 @@ int TabletImpl::CheckTableMeta(const openmldb::api::TableMeta* table_meta, std::
             }
         }
     }
+    std::set<std::string> range_index_set;
+    for (const auto& range_index : table_meta->range_index()) {
+        if (!range_index_set.insert(range_index.index_name()).second) {
+            msg = "has repeated range index name " + range_index.index_name();
+            return -1;
+        }
+        auto iter = column_map.find(range_index.col_name());
+        if (iter == column_map.end()) {
+            msg = "not found column name " + range_index.col_name();
+            return -1;
+        }
+        if (!::openmldb::codec::RangeKeyCodec::IsSupportedType(iter->second)) {
+            msg = "column type of range index is not supported " + range_index.col_name();
+            return -1;
+        }
+    }
     return 0;
 }
 
@@ -960,7 +1054,11 @@ int32_t TabletImpl::ScanIndex(const ::openmldb::api::ScanRequest* request, const
         } else {
             openmldb::base::Slice data = combine_it->GetValue();
             total_block_size += data.size();
-            tmp.emplace_back(ts, data);
+            if (meta.compress_type() == ::openmldb::type::kZstd) {
+                tmp.emplace_back(ts, OwnRow(data));
+            } else {
+                tmp.emplace_back(ts, data);
+            }
         }
         if (total_block_size > FLAGS_scan_max_bytes_size) {
             LOG(WARNING) << "reach the max byte size " << FLAGS_scan_max_bytes_size << " cur is " << total_block_size;
@@ -1128,6 +1226,7 @@ void TabletImpl::Scan(RpcController* controller, const ::openmldb::api::ScanRequ
             response->set_msg("table is loading");
             return;
         }
+        table->IncrReadCnt();
         uint32_t index = 0;
         std::string index_name;
         if (request->has_idx_name() && !request->idx_name().empty()) {
@@ -1225,6 +1324,7 @@ void TabletImpl::Count(RpcController* controller, const ::openmldb::api::CountRe
         response->set_msg("table is loading");
         return;
     }
+    table->IncrReadCnt();
     uint32_t index = 0;
     ::openmldb::storage::TTLSt ttl;
     std::shared_ptr<IndexDef> index_def;
@@ -1310,6 +1410,7 @@ void TabletImpl::Traverse(RpcController* controller, const ::openmldb::api::Trav
         response->set_msg("table is loading");
         return;
     }
+    table->IncrReadCnt();
     uint32_t index = 0;
     std::string index_name;
     if (request->has_idx_name() && !request->idx_name().empty()) {
@@ -1371,8 +1472,12 @@ void TabletImpl::Traverse(RpcController* controller, const ::openmldb::api::Trav
             value_map[last_pk].reserve(request->limit());
         }
         openmldb::base::Slice value = it->GetValue();
-        value_map[last_pk].push_back(std::make_pair(it->GetKey(), value));
         total_block_size += last_pk.length() + value.size();
+        if (table->GetCompressType() == ::openmldb::type::kZstd) {
+            value_map[last_pk].emplace_back(it->GetKey(), OwnRow(value));
+        } else {
+            value_map[last_pk].push_back(std::make_pair(it->GetKey(), value));
+        }
         scount++;
         if (it->GetCount() >= FLAGS_max_traverse_cnt) {
             DEBUGLOG("traverse cnt %lu max %lu, key %s ts %lu", it->GetCount(), FLAGS_max_traverse_cnt, last_pk.c_str(),
@@ -1487,19 +1592,155 @@ void TabletImpl::Delete(RpcController* controller, const ::openmldb::api::Delete
     return;
 }
 
+void TabletImpl::FillQueryPage(QueryCursor* cursor, uint32_t page_size, ::openmldb::api::QueryResponse* response,
+                               butil::IOBuf* buf) {
+    uint32_t byte_size = response->byte_size();
+    uint32_t count = response->count();
+    auto& run_cursor = cursor->cursor;
+    while (run_cursor->Valid() && (page_size == 0 || count < page_size) && byte_size < FLAGS_scan_max_bytes_size) {
+        const auto& row = run_cursor->GetValue();
+        byte_size += row.size();
+        buf->append(reinterpret_cast<void*>(row.buf()), row.size());
+        count += 1;
+        run_cursor->Next();
+    }
+    response->set_schema(cursor->schema);
+    response->set_byte_size(byte_size);
+    response->set_count(count);
+    response->set_has_more(run_cursor->Valid());
+    response->set_code(::openmldb::base::kOk);
+}
+
+void TabletImpl::SchedExpireQueryCursor() {
+    uint32_t cnt = query_cursor_mgr_.Expire();
+    if (cnt > 0) {
+        PDLOG(INFO, "release %u expired query cursors", cnt);
+    }
+    task_pool_.DelayTask(FLAGS_query_cursor_timeout_ms, boost::bind(&TabletImpl::SchedExpireQueryCursor, this));
+}
+
+void TabletImpl::SchedUpdateMemoryUsed() {
+    uint64_t table_bytes = 0;
+    {
+        std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
+        for (const auto& kv : tables_) {
+            for (const auto& pkv : kv.second) {
+                table_bytes += pkv.second->GetRecordByteSize();
+            }
+        }
+    }
+    size_t allocated_bytes = 0;
+#ifdef TCMALLOC_ENABLE
+    MallocExtension::instance()->GetNumericProperty("generic.current_allocated_bytes", &allocated_bytes);
+#endif
+    admission_controller_.SetMemoryUsed(table_bytes, allocated_bytes);
+    task_pool_.DelayTask(FLAGS_memory_check_interval, boost::bind(&TabletImpl::SchedUpdateMemoryUsed, this));
+}
+
+void TabletImpl::SchedDecayHotKey() {
+    std::vector<std::shared_ptr<Table>> tables;
+    {
+        std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
+        for (const auto& kv : tables_) {
+            for (const auto& pkv : kv.second) {
+                tables.push_back(pkv.second);
+            }
+        }
+    }
+    for (const auto& table : tables) {
+        table->GetHotKeySketch().Decay();
+    }
+    task_pool_.DelayTask(FLAGS_hot_key_decay_interval, boost::bind(&TabletImpl::SchedDecayHotKey, this));
+}
+
 void TabletImpl::Query(RpcController* ctrl, const openmldb::api::QueryRequest* request,
                        openmldb::api::QueryResponse* response, Closure* done) {
     DLOG(INFO) << "handle query request begin!";
     brpc::ClosureGuard done_guard(done);
+    std::string msg;
+    if (request->has_staleness_bound() && !CheckStaleness(request->staleness_bound(), &msg)) {
+        response->set_code(::openmldb::base::ReturnCode::kReplicaTooStale);
+        response->set_msg(msg);
+        return;
+    }
+    auto ticket = std::make_shared<AdmissionController::Ticket>();
+    auto admit_status = admission_controller_.AdmitQuery(request->ByteSizeLong(), ticket.get());
+    if (!admit_status.OK()) {
+        base::SetResponseStatus(admit_status, response);
+        return;
+    }
+    ScheduleQuery(ctrl, request, response, &done_guard, ticket);
+}
+
+void TabletImpl::ScheduleQuery(RpcController* ctrl, const openmldb::api::QueryRequest* request,
+                               openmldb::api::QueryResponse* response, brpc::ClosureGuard* done_guard,
+                               const std::shared_ptr<AdmissionController::Ticket>& ticket) {
     brpc::Controller* cntl = static_cast<brpc::Controller*>(ctrl);
-    butil::IOBuf& buf = cntl->response_attachment();
-    ProcessQuery(ctrl, request, response, &buf);
+    if (!request->is_batch()) {
+        QueryScheduler::RequestGuard request_guard(&query_scheduler_);
+        ProcessQuery(ctrl, request, response, &cntl->response_attachment());
+        return;
+    }
+    if (!query_scheduler_.IsBatchExecutorEnabled()) {
+        ProcessQuery(ctrl, request, response, &cntl->response_attachment());
+        return;
+    }
+    // the batch query runs on the batch executor and finishes the rpc there
+    Closure* done = done_guard->release();
+    query_scheduler_.RunBatch([this, cntl, request, response, done, ticket]() {
+        brpc::ClosureGuard done_guard(done);
+        ProcessQuery(cntl, request, response, &cntl->response_attachment());
+    });
+}
+
+bool TabletImpl::CheckStaleness(const ::openmldb::api::StalenessBound& bound, std::string* msg) {
+    std::shared_ptr<Table> table = GetTable(bound.tid(), bound.pid());
+    if (!table) {
+        *msg = "table is not exist";
+        return false;
+    }
+    if (table->IsLeader()) {
+        return true;
+    }
+    std::shared_ptr<LogReplicator> replicator = GetReplicator(bound.tid(), bound.pid());
+    if (!replicator) {
+        *msg = "replicator is not exist";
+        return false;
+    }
+    uint64_t offset = replicator->GetOffset();
+    uint64_t leader_offset = replicator->GetLeaderOffset();
+    uint64_t caught_up_time = replicator->GetCaughtUpTime();
+    if (leader_offset == 0 && caught_up_time == 0) {
+        *msg = "replica has not heard from the leader";
+        return false;
+    }
+    if (bound.has_max_offset() && leader_offset > offset + bound.max_offset()) {
+        *msg = absl::StrCat("replica lags behind the leader by ", leader_offset - offset, " offsets");
+        return false;
+    }
+    if (bound.has_max_ms()) {
+        uint64_t cur_time = ::baidu::common::timer::get_micros() / 1000;
+        if (caught_up_time == 0) {
+            *msg = "replica has never caught up with the leader";
+            return false;
+        }
+        if (cur_time > caught_up_time + bound.max_ms()) {
+            *msg = absl::StrCat("replica has not caught up with the leader for ", cur_time - caught_up_time, " ms");
+            return false;
+        }
+    }
+    return true;
 }
 
 void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryRequest* request,
                               ::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
     auto start = absl::Now();
-    absl::Cleanup deploy_collect_task = [this, request, start]() {
+    // only set for the procedure requests from the sdk
+    std::shared_ptr<DeployLatency> latency;
+    absl::Cleanup deploy_collect_task = [this, request, start, &latency]() {
+        if (latency) {
+            latency->Record(DeployStage::kTotal, absl::Now() - start);
+        }
         if (this->IsCollectDeployStatsEnabled()) {
             if (request->is_procedure() && request->has_db() && request->has_sp_name()) {
                 this->TryCollectDeployStats(request->db(), request->sp_name(), start);
@@ -1509,6 +1750,25 @@ void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryReq
 
     ::hybridse::base::Status status;
     if (request->is_batch()) {
+        if (request->has_cursor_id()) {
+            auto cursor = query_cursor_mgr_.Take(request->cursor_id());
+            if (request->close_cursor()) {
+                // the client abandons the rest of the result, the cursor is released with the taken one
+                response->set_code(::openmldb::base::kOk);
+                return;
+            }
+            if (!cursor) {
+                response->set_code(::openmldb::base::kQueryCursorNotFound);
+                response->set_msg("query cursor not found or expired");
+                return;
+            }
+            FillQueryPage(cursor.get(), request->page_size(), response, buf);
+            if (response->has_more()) {
+                query_cursor_mgr_.Put(request->cursor_id(), cursor);
+                response->set_cursor_id(request->cursor_id());
+            }
+            return;
+        }
         // convert repeated openmldb:type::DataType into hybridse::codec::Schema
         hybridse::codec::Schema parameter_schema;
         for (int i = 0; i < request->parameter_types().size(); i++) {
@@ -1527,6 +1787,9 @@ void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryReq
         if (request->is_debug()) {
             session.EnableDebug();
         }
+        if (request->is_profile()) {
+            session.EnableProfile();
+        }
         session.SetParameterSchema(parameter_schema);
         {
             bool ok = engine_->Get(request->sql(), request->db(), session, status);
@@ -1547,6 +1810,33 @@ void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryReq
             response->set_msg("fail to decode parameter row");
             return;
         }
+        if (request->page_size() > 0) {
+            // pull rows from runners page by page instead of materializing the whole result
+            auto run_cursor = session.OpenCursor(parameter_row);
+            if (!run_cursor) {
+                response->set_msg(status.msg);
+                response->set_code(::openmldb::base::kSQLRunError);
+                DLOG(WARNING) << "fail to run sql: " << request->sql();
+                return;
+            }
+            auto cursor = std::make_shared<QueryCursor>(run_cursor, session.GetEncodedSchema());
+            FillQueryPage(cursor.get(), request->page_size(), response, buf);
+            if (response->has_more()) {
+                uint64_t cursor_id = query_cursor_mgr_.Add(cursor);
+                if (cursor_id == 0) {
+                    // too many opened cursors, respond the whole result at once like a query without page size
+                    LOG(WARNING) << "too many opened query cursors, fetch the whole result of " << request->sql();
+                    FillQueryPage(cursor.get(), 0, response, buf);
+                    if (response->has_more()) {
+                        LOG(WARNING) << "reach the max byte size truncate result";
+                        response->set_has_more(false);
+                    }
+                    return;
+                }
+                response->set_cursor_id(cursor_id);
+            }
+            return;
+        }
         std::vector<::hybridse::codec::Row> output_rows;
         int32_t run_ret = session.Run(parameter_row, output_rows);
         if (run_ret != 0) {
@@ -1570,6 +1860,9 @@ void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryReq
             buf->append(reinterpret_cast<void*>(output_row.buf()), output_row.size());
             count += 1;
         }
+        if (session.GetProfile()) {
+            response->set_profile(session.GetProfile()->ToString());
+        }
         response->set_schema(session.GetEncodedSchema());
         response->set_byte_size(byte_size);
         response->set_count(count);
@@ -1595,9 +1888,13 @@ void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryReq
                     return;
                 }
             }
+            if (!request->has_task_id()) {
+                latency = deploy_latency_mgr_.Get(db_name, sp_name);
+                latency->Record(DeployStage::kCompile, absl::Now() - start);
+            }
             session.SetCompileInfo(request_compile_info);
             session.SetSpName(sp_name);
-            RunRequestQuery(ctrl, *request, session, *response, *buf);
+            RunRequestQuery(ctrl, *request, session, *response, *buf, latency.get());
         } else {
             bool ok = engine_->Get(request->sql(), request->db(), session, status);
             if (!ok || session.GetCompileInfo() == nullptr) {
@@ -1621,16 +1918,28 @@ void TabletImpl::SubQuery(RpcController* ctrl, const openmldb::api::QueryRequest
                           openmldb::api::QueryResponse* response, Closure* done) {
     DLOG(INFO) << "handle subquery request begin!";
     brpc::ClosureGuard done_guard(done);
-    brpc::Controller* cntl = static_cast<brpc::Controller*>(ctrl);
-    butil::IOBuf& buf = cntl->response_attachment();
-    ProcessQuery(ctrl, request, response, &buf);
+    ScheduleQuery(ctrl, request, response, &done_guard, nullptr);
 }
 
 void TabletImpl::SQLBatchRequestQuery(RpcController* ctrl, const openmldb::api::SQLBatchRequestQueryRequest* request,
                                       openmldb::api::SQLBatchRequestQueryResponse* response, Closure* done) {
     DLOG(INFO) << "handle query batch request begin!";
     brpc::ClosureGuard done_guard(done);
+    std::string msg;
+    if (request->has_staleness_bound() && !CheckStaleness(request->staleness_bound(), &msg)) {
+        response->set_code(::openmldb::base::ReturnCode::kReplicaTooStale);
+        response->set_msg(msg);
+        return;
+    }
     brpc::Controller* cntl = static_cast<brpc::Controller*>(ctrl);
+    AdmissionController::Ticket ticket;
+    auto admit_status = admission_controller_.AdmitQuery(
+        request->ByteSizeLong() + cntl->request_attachment().size(), &ticket);
+    if (!admit_status.OK()) {
+        base::SetResponseStatus(admit_status, response);
+        return;
+    }
+    QueryScheduler::RequestGuard request_guard(&query_scheduler_);
     butil::IOBuf& buf = cntl->response_attachment();
     return ProcessBatchRequestQuery(ctrl, request, response, buf);
 }
@@ -1638,7 +1947,12 @@ void TabletImpl::ProcessBatchRequestQuery(RpcController* ctrl,
                                           const openmldb::api::SQLBatchRequestQueryRequest* request,
                                           openmldb::api::SQLBatchRequestQueryResponse* response, butil::IOBuf& buf) {
     absl::Time start = absl::Now();
-    absl::Cleanup deploy_collect_task = [this, request, start]() {
+    // only set for the procedure requests from the sdk
+    std::shared_ptr<DeployLatency> latency;
+    absl::Cleanup deploy_collect_task = [this, request, start, &latency]() {
+        if (latency) {
+            latency->Record(DeployStage::kTotal, absl::Now() - start);
+        }
         if (this->IsCollectDeployStatsEnabled()) {
             if (request->is_procedure() && request->has_db() && request->has_sp_name()) {
                 this->TryCollectDeployStats(request->db(), request->sp_name(), start);
@@ -1652,6 +1966,9 @@ void TabletImpl::ProcessBatchRequestQuery(RpcController* ctrl,
     if (request->is_debug()) {
         session.EnableDebug();
     }
+    if (request->is_profile()) {
+        session.EnableProfile();
+    }
     bool is_procedure = request->is_procedure();
 
     if (is_procedure) {
@@ -1668,6 +1985,10 @@ void TabletImpl::ProcessBatchRequestQuery(RpcController* ctrl,
             session.SetCompileInfo(request_compile_info);
             session.SetSpName(request->sp_name());
         }
+        if (!request->has_task_id()) {
+            latency = deploy_latency_mgr_.Get(request->db(), request->sp_name());
+            latency->Record(DeployStage::kCompile, absl::Now() - start);
+        }
     } else {
         size_t common_column_num = request->common_column_indices().size();
         for (size_t i = 0; i < common_column_num; ++i) {
@@ -1741,11 +2062,21 @@ void TabletImpl::ProcessBatchRequestQuery(RpcController* ctrl,
     }
     std::vector<::hybridse::codec::Row> output_rows;
     int32_t run_ret = 0;
+    absl::Time run_start = absl::Now();
     if (request->has_task_id()) {
         run_ret = session.Run(request->task_id(), input_rows, output_rows);
     } else {
         run_ret = session.Run(input_rows, output_rows);
     }
+    absl::Time encode_start = absl::Now();
+    if (latency) {
+        latency->Record(DeployStage::kRun, encode_start - run_start);
+    }
+    absl::Cleanup encode_collect_task = [&latency, encode_start]() {
+        if (latency) {
+            latency->Record(DeployStage::kEncode, absl::Now() - encode_start);
+        }
+    };
     if (run_ret != 0) {
         response->set_msg(status.msg);
         response->set_code(::openmldb::base::kSQLRunError);
@@ -1800,6 +2131,9 @@ void TabletImpl::ProcessBatchRequestQuery(RpcController* ctrl,
     for (size_t idx : output_common_indices) {
         response->add_common_column_indices(idx);
     }
+    if (session.GetProfile()) {
+        response->set_profile(session.GetProfile()->ToString());
+    }
     response->set_schema(session.GetEncodedSchema());
     response->set_count(output_rows.size());
     response->set_code(::openmldb::base::kOk);
@@ -1810,7 +2144,15 @@ void TabletImpl::SubBatchRequestQuery(RpcController* ctrl, const openmldb::api::
                                       openmldb::api::SQLBatchRequestQueryResponse* response, Closure* done) {
     DLOG(INFO) << "handle subquery batch request begin!";
     brpc::ClosureGuard done_guard(done);
+    // the hedged sub queries sent to followers carry a staleness bound
+    std::string msg;
+    if (request->has_staleness_bound() && !CheckStaleness(request->staleness_bound(), &msg)) {
+        response->set_code(::openmldb::base::ReturnCode::kReplicaTooStale);
+        response->set_msg(msg);
+        return;
+    }
     brpc::Controller* cntl = static_cast<brpc::Controller*>(ctrl);
+    QueryScheduler::RequestGuard request_guard(&query_scheduler_);
     butil::IOBuf& buf = cntl->response_attachment();
     return ProcessBatchRequestQuery(ctrl, request, response, buf);
 }
@@ -2112,6 +2454,9 @@ void TabletImpl::AppendEntries(RpcController* controller, const ::openmldb::api:
             return;
         }
     }
+    if (request->has_leader_offset()) {
+        replicator->UpdateLeaderOffset(request->leader_offset());
+    }
     response->set_log_offset(replicator->GetOffset());
 }
 
@@ -2234,6 +2579,16 @@ void TabletImpl::GetTableStatus(RpcController* controller, const ::openmldb::api
             status->set_compress_type(table->GetCompressType());
             status->set_name(table->GetName());
             status->set_diskused(table->GetDiskused());
+            status->set_read_cnt(table->GetReadCnt());
+            if (request->need_hot_key()) {
+                std::vector<std::pair<std::string, uint64_t>> hot_keys;
+                table->GetHotKeySketch().GetTopK(UINT32_MAX, FLAGS_hot_key_min_ratio, &hot_keys);
+                for (const auto& kv : hot_keys) {
+                    ::openmldb::api::HotKey* hot_key = status->add_hot_key();
+                    hot_key->set_key(kv.first);
+                    hot_key->set_cnt(kv.second);
+                }
+            }
             if (::openmldb::api::TableState_IsValid(table->GetTableStat())) {
                 status->set_state(::openmldb::api::TableState(table->GetTableStat()));
             }
@@ -2452,7 +2807,7 @@ void TabletImpl::SchedMakeSnapshot() {
 }
 
 void TabletImpl::SendData(RpcController* controller, const ::openmldb::api::SendDataRequest* request,
-                          ::openmldb::api::GeneralResponse* response, Closure* done) {
+                          ::openmldb::api::SendDataResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
     brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
     uint32_t tid = request->tid();
@@ -2496,6 +2851,14 @@ void TabletImpl::SendData(RpcController* controller, const ::openmldb::api::Send
                 file_receiver_map_.insert(
                     std::make_pair(combine_key, std::make_shared<FileReceiver>(request->file_name(), dir_name, path)));
                 iter = file_receiver_map_.find(combine_key);
+            } else if (request->resume() && request->has_offset()) {
+                // keep the data received by the last try
+                PDLOG(INFO, "resume file receiver. tid %u, pid %u, file_name %s, received size %lu", tid, pid,
+                      request->file_name().c_str(), iter->second->GetReceivedSize());
+                response->set_code(::openmldb::base::ReturnCode::kOk);
+                response->set_msg("ok");
+                response->set_received_size(iter->second->GetReceivedSize());
+                return;
             }
             if (!iter->second->Init()) {
                 PDLOG(WARNING, "file receiver init failed. tid %u, pid %u, file_name %s", tid, pid,
@@ -2506,6 +2869,10 @@ void TabletImpl::SendData(RpcController* controller, const ::openmldb::api::Send
                 return;
             }
             PDLOG(INFO, "file receiver init ok. tid %u, pid %u, file_name %s", tid, pid, request->file_name().c_str());
+            if (request->has_offset()) {
+                // tell the sender that the blocks can be pipelined
+                response->set_received_size(iter->second->GetReceivedSize());
+            }
             response->set_code(::openmldb::base::ReturnCode::kOk);
             response->set_msg("ok");
         } else if (iter == file_receiver_map_.end()) {
@@ -2523,6 +2890,42 @@ void TabletImpl::SendData(RpcController* controller, const ::openmldb::api::Send
         response->set_msg("cannot find receiver");
         return;
     }
+    if (request->has_offset()) {
+        // the blocks are pipelined, they are placed by offset and verified by crc
+        if (request->eof()) {
+            if (receiver->GetReceivedSize() != request->offset()) {
+                PDLOG(WARNING, "file is not complete. tid %u, pid %u, file_name %s, size %lu received size %lu", tid,
+                      pid, request->file_name().c_str(), request->offset(), receiver->GetReceivedSize());
+                response->set_code(::openmldb::base::ReturnCode::kReceiveDataError);
+                response->set_msg("file is not complete");
+                response->set_received_size(receiver->GetReceivedSize());
+                return;
+            }
+            receiver->SaveFile();
+            std::lock_guard<std::mutex> lock(mu_);
+            file_receiver_map_.erase(combine_key);
+        } else if (request->block_id() > 0) {
+            const auto& data = cntl->request_attachment();
+            if (data.length() != request->block_size()) {
+                PDLOG(WARNING, "receive data error. tid %u, pid %u, file_name %s, expected length %u real length %u",
+                      tid, pid, request->file_name().c_str(), request->block_size(), data.length());
+                response->set_code(::openmldb::base::ReturnCode::kReceiveDataError);
+                response->set_msg("receive data error");
+                return;
+            }
+            if (receiver->WriteData(data.to_string(), request->offset(), request->crc()) < 0) {
+                PDLOG(WARNING, "receiver write data failed. tid %u, pid %u, file_name %s, offset %lu", tid, pid,
+                      request->file_name().c_str(), request->offset());
+                response->set_code(::openmldb::base::ReturnCode::kWriteDataFailed);
+                response->set_msg("write data failed");
+                return;
+            }
+        }
+        response->set_received_size(receiver->GetReceivedSize());
+        response->set_msg("ok");
+        response->set_code(::openmldb::base::ReturnCode::kOk);
+        return;
+    }
     if (receiver->GetBlockId() == request->block_id()) {
         response->set_msg("ok");
         response->set_code(::openmldb::base::ReturnCode::kOk);
@@ -2650,23 +3053,12 @@ void TabletImpl::SendSnapshotInternal(const std::string& endpoint, uint32_t tid,
             PDLOG(WARNING, "Init FileSender failed. tid[%u] pid[%u] endpoint[%s]", tid, pid, endpoint.c_str());
             break;
         }
-        // send table_meta file
         std::string full_path = GetDBPath(db_root_path, tid, pid) + "/";
-        std::string file_name = "table_meta.txt";
-        if (sender.SendFile(file_name, full_path + file_name) < 0) {
-            PDLOG(WARNING, "send table_meta.txt failed. tid[%u] pid[%u]", tid, pid);
-            break;
-        }
+        std::vector<std::pair<std::string, std::string>> files = {{"table_meta.txt", full_path + "table_meta.txt"}};
         full_path.append("snapshot/");
         std::string manifest_file = full_path + "MANIFEST";
-        std::string snapshot_file;
-        {
-            int fd = open(manifest_file.c_str(), O_RDONLY);
-            if (fd < 0) {
-                PDLOG(WARNING, "[%s] is not exist", manifest_file.c_str());
-                has_error = false;
-                break;
-            }
+        int fd = open(manifest_file.c_str(), O_RDONLY);
+        if (fd >= 0) {
             google::protobuf::io::FileInputStream fileInput(fd);
             fileInput.SetCloseOnDelete(true);
             ::openmldb::api::Manifest manifest;
@@ -2674,15 +3066,20 @@ void TabletImpl::SendSnapshotInternal(const std::string& endpoint, uint32_t tid,
                 PDLOG(WARNING, "parse manifest failed. tid[%u] pid[%u]", tid, pid);
                 break;
             }
-            snapshot_file = manifest.name();
+            files.emplace_back(manifest.name(), full_path + manifest.name());
         }
-        // send snapshot file
-        if (sender.SendFile(snapshot_file, full_path + snapshot_file) < 0) {
-            PDLOG(WARNING, "send snapshot failed. tid[%u] pid[%u]", tid, pid);
+        // send table_meta file and snapshot file in parallel
+        if (sender.SendFiles(files, "") < 0) {
+            PDLOG(WARNING, "send table_meta.txt or snapshot failed. tid[%u] pid[%u]", tid, pid);
             break;
         }
-        // send manifest file
-        file_name = "MANIFEST";
+        if (fd < 0) {
+            PDLOG(WARNING, "[%s] is not exist", manifest_file.c_str());
+            has_error = false;
+            break;
+        }
+        // send manifest file at last, the snapshot is complete once it is received
+        std::string file_name = "MANIFEST";
         if (sender.SendFile(file_name, full_path + file_name) < 0) {
             PDLOG(WARNING, "send MANIFEST failed. tid[%u] pid[%u]", tid, pid);
             break;
@@ -3735,7 +4132,13 @@ void TabletImpl::GcTable(uint32_t tid, uint32_t pid, bool execute_once) {
     std::shared_ptr<Table> table = GetTable(tid, pid);
     if (table) {
         int32_t gc_interval = FLAGS_gc_interval;
-        table->SchedGc();
+        {
+            // gc is background work, it yields to the latency critical requests
+            base::YieldPoint::Guard yield_guard(&QueryScheduler::YieldHandler, &query_scheduler_);
+            table->SchedGc();
+        }
+        // the followers put the rows through binlog, they train their own dictionaries here
+        SchedTrainCompressDict(table);
         if (!execute_once) {
             gc_pool_.DelayTask(gc_interval * 60 * 1000, boost::bind(&TabletImpl::GcTable, this, tid, pid, false));
         }
@@ -3743,6 +4146,34 @@ void TabletImpl::GcTable(uint32_t tid, uint32_t pid, bool execute_once) {
     }
 }
 
+void TabletImpl::SchedTrainCompressDict(const std::shared_ptr<Table>& table) {
+    auto mem_table = std::dynamic_pointer_cast<MemTable>(table);
+    if (mem_table && mem_table->NeedTrainCompressDict()) {
+        task_pool_.AddTask(boost::bind(&TabletImpl::TrainCompressDict, this, table->GetId(), table->GetPid()));
+    }
+}
+
+void TabletImpl::TrainCompressDict(uint32_t tid, uint32_t pid) {
+    auto mem_table = std::dynamic_pointer_cast<MemTable>(GetTable(tid, pid));
+    if (!mem_table) {
+        PDLOG(WARNING, "table is not exist. tid %u, pid %u", tid, pid);
+        return;
+    }
+    if (!mem_table->TrainCompressDict(FLAGS_zstd_dict_sample_cnt, FLAGS_zstd_dict_size)) {
+        return;
+    }
+    // persist the dictionary, so that the rows are compressed with it after the table is loaded again
+    std::string db_root_path;
+    if (!ChooseDBRootPath(tid, pid, db_root_path)) {
+        PDLOG(WARNING, "fail to get table db root path for tid %u, pid %u", tid, pid);
+        return;
+    }
+    std::string db_path = GetDBPath(db_root_path, tid, pid);
+    if (WriteTableMeta(db_path, mem_table->GetTableMeta().get()) < 0) {
+        PDLOG(WARNING, "write table_meta failed. tid[%u] pid[%u]", tid, pid);
+    }
+}
+
 std::shared_ptr<Snapshot> TabletImpl::GetSnapshot(uint32_t tid, uint32_t pid) {
     std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
     return GetSnapshotUnLock(tid, pid);
@@ -4487,6 +4918,331 @@ void TabletImpl::DumpIndexDataInternal(std::shared_ptr<::openmldb::storage::Tabl
     }
 }
 
+void TabletImpl::SplitTable(RpcController* controller, const ::openmldb::api::SplitTableRequest* request,
+                            ::openmldb::api::GeneralResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    std::shared_ptr<::openmldb::api::TaskInfo> task_ptr;
+    if (request->has_task_info() && request->task_info().IsInitialized()) {
+        if (AddOPTask(request->task_info(), ::openmldb::api::TaskType::kSplitTable, task_ptr) < 0) {
+            response->set_code(-1);
+            response->set_msg("add task failed");
+            return;
+        }
+    }
+    uint32_t tid = request->tid();
+    uint32_t pid = request->pid();
+    uint32_t new_pid = request->new_pid();
+    do {
+        if (request->modulus() < 2 || request->modulus() % 2 != 0) {
+            PDLOG(WARNING, "invalid modulus %lu. tid[%u] pid[%u]", request->modulus(), tid, pid);
+            response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+            response->set_msg("invalid modulus");
+            break;
+        }
+        std::shared_ptr<Table> table;
+        std::shared_ptr<Table> new_table;
+        std::shared_ptr<Snapshot> snapshot;
+        std::shared_ptr<LogReplicator> replicator;
+        std::shared_ptr<LogReplicator> new_replicator;
+        {
+            std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
+            table = GetTableUnLock(tid, pid);
+            new_table = GetTableUnLock(tid, new_pid);
+            if (!table || !new_table) {
+                PDLOG(WARNING, "table is not exist. tid[%u] pid[%u] new_pid[%u]", tid, pid, new_pid);
+                response->set_code(::openmldb::base::ReturnCode::kTableIsNotExist);
+                response->set_msg("table is not exist");
+                break;
+            }
+            if (!table->IsLeader() || !new_table->IsLeader()) {
+                PDLOG(WARNING, "table is follower. tid[%u] pid[%u] new_pid[%u]", tid, pid, new_pid);
+                response->set_code(::openmldb::base::ReturnCode::kTableIsFollower);
+                response->set_msg("table is follower");
+                break;
+            }
+            if (table->GetTableStat() != ::openmldb::storage::kNormal ||
+                new_table->GetTableStat() != ::openmldb::storage::kNormal) {
+                PDLOG(WARNING, "table state is not kNormal, cannot split. tid[%u] pid[%u] new_pid[%u]", tid, pid,
+                      new_pid);
+                response->set_code(::openmldb::base::ReturnCode::kTableStatusIsNotKnormal);
+                response->set_msg("table status is not kNormal");
+                break;
+            }
+            snapshot = GetSnapshotUnLock(tid, pid);
+            if (!snapshot) {
+                PDLOG(WARNING, "snapshot is not exist. tid[%u] pid[%u]", tid, pid);
+                response->set_code(::openmldb::base::ReturnCode::kSnapshotIsNotExist);
+                response->set_msg("table snapshot is not exist");
+                break;
+            }
+            replicator = GetReplicatorUnLock(tid, pid);
+            new_replicator = GetReplicatorUnLock(tid, new_pid);
+            if (!replicator || !new_replicator) {
+                PDLOG(WARNING, "replicator is not exist. tid[%u] pid[%u] new_pid[%u]", tid, pid, new_pid);
+                response->set_code(::openmldb::base::ReturnCode::kReplicatorIsNotExist);
+                response->set_msg("replicator is not exist");
+                break;
+            }
+        }
+        auto aggrs = GetAggregators(tid, pid);
+        if (aggrs && !aggrs->empty()) {
+            PDLOG(WARNING, "table with pre-aggregation cannot be split. tid[%u] pid[%u]", tid, pid);
+            response->set_code(::openmldb::base::ReturnCode::kOperatorNotSupport);
+            response->set_msg("table with pre-aggregation cannot be split");
+            break;
+        }
+        std::shared_ptr<::openmldb::storage::MemTableSnapshot> memtable_snapshot =
+            std::static_pointer_cast<::openmldb::storage::MemTableSnapshot>(snapshot);
+        if (task_ptr) {
+            std::lock_guard<std::mutex> lock(mu_);
+            split_ops_[task_ptr->op_id()] = std::make_pair(tid, pid);
+        }
+        task_pool_.AddTask(boost::bind(&TabletImpl::SplitTableInternal, this, table, memtable_snapshot, replicator,
+                                       new_table, new_replicator, request->modulus(), task_ptr));
+        response->set_code(::openmldb::base::ReturnCode::kOk);
+        response->set_msg("ok");
+        PDLOG(INFO, "split table tid[%u] pid[%u] to new_pid[%u] modulus[%lu]", tid, pid, new_pid, request->modulus());
+        return;
+    } while (0);
+    SetTaskStatus(task_ptr, ::openmldb::api::TaskStatus::kFailed);
+}
+
+bool TabletImpl::ForwardSplitEntry(std::shared_ptr<Table> new_table, std::shared_ptr<LogReplicator> new_replicator,
+                                   uint64_t modulus, const ::openmldb::api::LogEntry& entry) {
+    ::openmldb::api::LogEntry new_entry;
+    if (entry.dimensions_size() > 0) {
+        for (const auto& dimension : entry.dimensions()) {
+            if (::openmldb::base::hash64(dimension.key()) % modulus >= modulus / 2) {
+                new_entry.add_dimensions()->CopyFrom(dimension);
+            }
+        }
+    } else if (::openmldb::base::hash64(entry.pk()) % modulus >= modulus / 2) {
+        ::openmldb::api::Dimension* dimension = new_entry.add_dimensions();
+        dimension->set_key(entry.pk());
+        dimension->set_idx(0);
+    }
+    if (new_entry.dimensions_size() == 0) {
+        return true;
+    }
+    bool ok = true;
+    if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete) {
+        new_entry.set_method_type(::openmldb::api::MethodType::kDelete);
+        for (const auto& dimension : new_entry.dimensions()) {
+            new_table->Delete(dimension.key(), dimension.idx());
+        }
+    } else {
+        new_entry.set_pk(new_entry.dimensions(0).key());
+        new_entry.set_ts(entry.ts());
+        new_entry.set_value(entry.value());
+        new_entry.mutable_ts_dimensions()->CopyFrom(entry.ts_dimensions());
+        ok = new_table->Put(entry.ts(), entry.value(), new_entry.dimensions());
+    }
+    new_entry.set_term(new_replicator->GetLeaderTerm());
+    if (!new_replicator->AppendEntry(new_entry)) {
+        ok = false;
+    }
+    return ok;
+}
+
+void TabletImpl::SplitTableInternal(std::shared_ptr<Table> table,
+                                    std::shared_ptr<::openmldb::storage::MemTableSnapshot> memtable_snapshot,
+                                    std::shared_ptr<LogReplicator> replicator, std::shared_ptr<Table> new_table,
+                                    std::shared_ptr<LogReplicator> new_replicator, uint64_t modulus,
+                                    std::shared_ptr<::openmldb::api::TaskInfo> task) {
+    uint32_t tid = table->GetId();
+    uint32_t pid = table->GetPid();
+    uint32_t new_pid = new_table->GetPid();
+    auto forward = [this, new_table, new_replicator, modulus](const ::openmldb::api::LogEntry& entry) {
+        return ForwardSplitEntry(new_table, new_replicator, modulus, entry);
+    };
+    // once the copy has caught up with the binlog, the new entries of the table are forwarded by the
+    // append hook of the replicator. It can only be set while no entry is appended after the copied one
+    uint32_t round = 0;
+    auto caught_up = [this, &round, replicator, forward, task, tid, pid](uint64_t offset) {
+        if (replicator->SetAppendHook(offset, [forward](const ::openmldb::api::LogEntry& entry) { forward(entry); })) {
+            // the op may be canceled while the data is copied, and nothing would clear the hook after it
+            bool canceled = false;
+            if (task) {
+                std::lock_guard<std::mutex> lock(mu_);
+                canceled = split_ops_.find(task->op_id()) == split_ops_.end();
+            }
+            if (canceled) {
+                replicator->ClearAppendHook();
+                PDLOG(WARNING, "split op %lu is canceled. tid[%u] pid[%u]", task->op_id(), tid, pid);
+                return -1;
+            }
+            PDLOG(INFO, "split data caught up at offset %lu. tid[%u] pid[%u]", offset, tid, pid);
+            return 0;
+        }
+        if (++round >= FLAGS_split_table_catch_up_round) {
+            PDLOG(WARNING, "split data cannot catch up with the binlog in %u rounds. tid[%u] pid[%u]", round, tid,
+                  pid);
+            return -1;
+        }
+        replicator->SyncToDisk();
+        return 1;
+    };
+    if (memtable_snapshot->DumpSplitData(table, forward, caught_up)) {
+        new_replicator->Notify();
+        PDLOG(INFO, "split table tid[%u] pid[%u] to new_pid[%u] succeed", tid, pid, new_pid);
+        SetTaskStatus(task, ::openmldb::api::kDone);
+    } else {
+        replicator->ClearAppendHook();
+        if (task) {
+            std::lock_guard<std::mutex> lock(mu_);
+            split_ops_.erase(task->op_id());
+        }
+        PDLOG(WARNING, "fail to split table tid[%u] pid[%u] to new_pid[%u]", tid, pid, new_pid);
+        SetTaskStatus(task, ::openmldb::api::kFailed);
+    }
+}
+
+void TabletImpl::FinishSplitTable(RpcController* controller, const ::openmldb::api::FinishSplitTableRequest* request,
+                                  ::openmldb::api::GeneralResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    std::shared_ptr<::openmldb::api::TaskInfo> task_ptr;
+    if (request->has_task_info() && request->task_info().IsInitialized()) {
+        if (AddOPTask(request->task_info(), ::openmldb::api::TaskType::kFinishSplitTable, task_ptr) < 0) {
+            response->set_code(-1);
+            response->set_msg("add task failed");
+            return;
+        }
+    }
+    uint32_t tid = request->tid();
+    uint32_t pid = request->pid();
+    if (request->modulus() < 2 || request->modulus() % 2 != 0) {
+        PDLOG(WARNING, "invalid modulus %lu. tid[%u] pid[%u]", request->modulus(), tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+        response->set_msg("invalid modulus");
+        SetTaskStatus(task_ptr, ::openmldb::api::TaskStatus::kFailed);
+        return;
+    }
+    std::shared_ptr<Table> table = GetTable(tid, pid);
+    if (!table) {
+        PDLOG(WARNING, "table is not exist. tid[%u] pid[%u]", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kTableIsNotExist);
+        response->set_msg("table is not exist");
+        SetTaskStatus(task_ptr, ::openmldb::api::TaskStatus::kFailed);
+        return;
+    }
+    if (!table->IsLeader()) {
+        // a follower takes no puts, it only keeps the split in case it becomes the leader later
+        if (!AddSplitModulus(table, request->modulus())) {
+            response->set_code(::openmldb::base::ReturnCode::kWriteDataFailed);
+            response->set_msg("fail to write table meta");
+            SetTaskStatus(task_ptr, ::openmldb::api::TaskStatus::kFailed);
+            return;
+        }
+        response->set_code(::openmldb::base::ReturnCode::kOk);
+        response->set_msg("ok");
+        SetTaskStatus(task_ptr, ::openmldb::api::TaskStatus::kDone);
+        PDLOG(INFO, "add split modulus %lu to follower tid[%u] pid[%u]", request->modulus(), tid, pid);
+        return;
+    }
+    // the clients route the moved keys to the new partition once they have seen the table change,
+    // keep forwarding the writes to the old partition for a while before cleaning them up
+    task_pool_.DelayTask(FLAGS_split_table_clean_delay, boost::bind(&TabletImpl::FinishSplitTableInternal, this, tid,
+                                                                     pid, request->modulus(), task_ptr));
+    response->set_code(::openmldb::base::ReturnCode::kOk);
+    response->set_msg("ok");
+    PDLOG(INFO, "finish split table tid[%u] pid[%u] after %u ms", tid, pid, FLAGS_split_table_clean_delay);
+}
+
+void TabletImpl::FinishSplitTableInternal(uint32_t tid, uint32_t pid, uint64_t modulus,
+                                          std::shared_ptr<::openmldb::api::TaskInfo> task) {
+    std::shared_ptr<Table> table = GetTable(tid, pid);
+    std::shared_ptr<LogReplicator> replicator = GetReplicator(tid, pid);
+    if (!table || !replicator) {
+        PDLOG(WARNING, "table is not exist. tid[%u] pid[%u]", tid, pid);
+        SetTaskStatus(task, ::openmldb::api::kFailed);
+        return;
+    }
+    // the moved keys are rejected before the forwarding stops, so none of their writes is lost
+    if (!AddSplitModulus(table, modulus)) {
+        PDLOG(WARNING, "fail to keep split modulus %lu in table meta. tid[%u] pid[%u]", modulus, tid, pid);
+    }
+    replicator->ClearAppendHook();
+    if (task) {
+        std::lock_guard<std::mutex> lock(mu_);
+        split_ops_.erase(task->op_id());
+    }
+    if (!table->IsLeader()) {
+        PDLOG(WARNING, "table is follower. tid[%u] pid[%u]", tid, pid);
+        SetTaskStatus(task, ::openmldb::api::kFailed);
+        return;
+    }
+    uint64_t cnt = 0;
+    for (const auto& index_def : table->GetAllIndex()) {
+        if (!index_def->IsReady()) {
+            continue;
+        }
+        uint32_t idx = index_def->GetId();
+        std::vector<std::string> keys;
+        std::unique_ptr<::hybridse::vm::WindowIterator> it(table->NewWindowIterator(idx));
+        if (!it) {
+            continue;
+        }
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            auto key_row = it->GetKey();
+            std::string key(reinterpret_cast<const char*>(key_row.buf()), key_row.size());
+            if (::openmldb::base::hash64(key) % modulus >= modulus / 2) {
+                keys.push_back(std::move(key));
+            }
+        }
+        it.reset();
+        for (const auto& key : keys) {
+            table->Delete(key, idx);
+            ::openmldb::api::LogEntry entry;
+            entry.set_term(replicator->GetLeaderTerm());
+            entry.set_method_type(::openmldb::api::MethodType::kDelete);
+            ::openmldb::api::Dimension* dimension = entry.add_dimensions();
+            dimension->set_key(key);
+            dimension->set_idx(idx);
+            replicator->AppendEntry(entry);
+        }
+        cnt += keys.size();
+    }
+    replicator->Notify();
+    PDLOG(INFO, "delete %lu moved keys after split. tid[%u] pid[%u]", cnt, tid, pid);
+    SetTaskStatus(task, ::openmldb::api::kDone);
+}
+
+bool TabletImpl::AddSplitModulus(std::shared_ptr<Table> table, uint64_t modulus) {
+    uint32_t tid = table->GetId();
+    uint32_t pid = table->GetPid();
+    table->AddSplitModulus(modulus);
+    std::string db_root_path;
+    if (!ChooseDBRootPath(tid, pid, db_root_path)) {
+        PDLOG(WARNING, "fail to get table db root path. tid[%u] pid[%u]", tid, pid);
+        return false;
+    }
+    std::string db_path = GetDBPath(db_root_path, tid, pid);
+    if (WriteTableMeta(db_path, table->GetTableMeta().get()) < 0) {
+        PDLOG(WARNING, "write table_meta failed. tid[%u] pid[%u]", tid, pid);
+        return false;
+    }
+    return true;
+}
+
+void TabletImpl::ClearSplitHook(uint64_t op_id) {
+    std::pair<uint32_t, uint32_t> table_pid;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto iter = split_ops_.find(op_id);
+        if (iter == split_ops_.end()) {
+            return;
+        }
+        table_pid = iter->second;
+        split_ops_.erase(iter);
+    }
+    std::shared_ptr<LogReplicator> replicator = GetReplicator(table_pid.first, table_pid.second);
+    if (replicator) {
+        replicator->ClearAppendHook();
+    }
+    PDLOG(INFO, "stop forwarding the writes of split op %lu. tid[%u] pid[%u]", op_id, table_pid.first,
+          table_pid.second);
+}
+
 void TabletImpl::LoadIndexData(RpcController* controller, const ::openmldb::api::LoadIndexDataRequest* request,
                                ::openmldb::api::GeneralResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -4743,7 +5499,17 @@ void TabletImpl::ExtractIndexDataInternal(std::shared_ptr<::openmldb::storage::T
     uint64_t offset = 0;
     uint32_t tid = table->GetId();
     uint32_t pid = table->GetPid();
-    if (memtable_snapshot->ExtractIndexData(table, column_key, idx, partition_num, offset) < 0) {
+    // the rows in memory are put into the new index directly, the snapshot is still rewritten for recovery
+    bool backfilled = false;
+    auto* mem_table = dynamic_cast<MemTable*>(table.get());
+    if (FLAGS_add_index_backfill_thread_num > 0 && mem_table != nullptr) {
+        uint64_t put_cnt = 0;
+        backfilled = mem_table->BackfillIndex(idx, partition_num, FLAGS_add_index_backfill_thread_num, &put_cnt);
+        if (!backfilled) {
+            PDLOG(WARNING, "fail to backfill index from memory, load it from snapshot. tid %u pid %u", tid, pid);
+        }
+    }
+    if (memtable_snapshot->ExtractIndexData(table, column_key, idx, partition_num, offset, !backfilled) < 0) {
         PDLOG(WARNING, "fail to extract index. tid %u pid %u", tid, pid);
         SetTaskStatus(task, ::openmldb::api::TaskStatus::kFailed);
         return;
@@ -4838,6 +5604,8 @@ void TabletImpl::CancelOP(RpcController* controller, const openmldb::api::Cancel
             }
         }
     }
+    // a canceled or failed split op must not keep forwarding the writes to the new partition
+    ClearSplitHook(op_id);
     response->set_code(::openmldb::base::ReturnCode::kOk);
     response->set_msg("ok");
 }
@@ -4903,11 +5671,15 @@ void TabletImpl::CreateProcedure(RpcController* controller, const openmldb::api:
     ::hybridse::base::Status status;
     auto sp_info_impl = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(sp_info);
 
-    auto long_windows = sp_info_impl->GetOption(hybridse::vm::LONG_WINDOWS);
     std::shared_ptr<std::unordered_map<std::string, std::string>> options = nullptr;
-    if (long_windows) {
-        options = std::make_shared<std::unordered_map<std::string, std::string>>();
-        options->emplace(hybridse::vm::LONG_WINDOWS, *long_windows);
+    for (const char* name : {hybridse::vm::LONG_WINDOWS, hybridse::vm::WINDOW_CACHE}) {
+        auto value = sp_info_impl->GetOption(name);
+        if (value) {
+            if (!options) {
+                options = std::make_shared<std::unordered_map<std::string, std::string>>();
+            }
+            options->emplace(name, *value);
+        }
     }
 
     // build for single request
@@ -4951,6 +5723,8 @@ void TabletImpl::CreateProcedure(RpcController* controller, const openmldb::api:
         LOG(WARNING) << "fail to add procedure " << sp_name << " to catalog with db " << db_name;
     }
 
+    // a request racing the last drop of the deployment may have created its latency again
+    deploy_latency_mgr_.Delete(db_name, sp_name);
     sp_cache_->InsertSQLProcedureCacheEntry(db_name, sp_name, sp_info_impl, session.GetCompileInfo(),
                                             batch_session.GetCompileInfo());
 
@@ -4969,6 +5743,7 @@ void TabletImpl::DropProcedure(RpcController* controller, const ::openmldb::api:
     auto is_deployment_procedure = sp_info.ok() && sp_info.value()->GetType() == hybridse::sdk::kReqDeployment;
 
     sp_cache_->DropSQLProcedureCacheEntry(db_name, sp_name);
+    deploy_latency_mgr_.Delete(db_name, sp_name);
     if (!catalog_->DropProcedure(db_name, sp_name)) {
         LOG(WARNING) << "drop procedure" << db_name << "." << sp_name << " in catalog failed";
     }
@@ -4989,10 +5764,13 @@ void TabletImpl::DropProcedure(RpcController* controller, const ::openmldb::api:
 
 void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::QueryRequest& request,
                                  ::hybridse::vm::RequestRunSession& session, openmldb::api::QueryResponse& response,
-                                 butil::IOBuf& buf) {
+                                 butil::IOBuf& buf, DeployLatency* latency) {
     if (request.is_debug()) {
         session.EnableDebug();
     }
+    if (request.is_profile()) {
+        session.EnableProfile();
+    }
     ::hybridse::codec::Row row;
     auto& request_buf = dynamic_cast<brpc::Controller*>(ctrl)->request_attachment();
     size_t input_slices = request.row_slices();
@@ -5003,11 +5781,16 @@ void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::Query
     }
     ::hybridse::codec::Row output;
     int32_t ret = 0;
+    absl::Time run_start = absl::Now();
     if (request.has_task_id()) {
         ret = session.Run(request.task_id(), row, &output);
     } else {
         ret = session.Run(row, &output);
     }
+    absl::Time encode_start = absl::Now();
+    if (latency != nullptr) {
+        latency->Record(DeployStage::kRun, encode_start - run_start);
+    }
     if (ret != 0) {
         response.set_code(::openmldb::base::kSQLRunError);
         response.set_msg("fail to run sql");
@@ -5023,8 +5806,19 @@ void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::Query
         response.set_msg("fail to encode sql output row");
         return;
     }
+    if (latency != nullptr) {
+        latency->Record(DeployStage::kEncode, absl::Now() - encode_start);
+    }
     if (!request.has_task_id()) {
         response.set_schema(session.GetEncodedSchema());
+        // only the queries sent by the sdk are routed by key, the sub tasks of a query are not
+        if (FLAGS_hot_key_sample_interval > 0 &&
+            hot_key_sample_cnt_.fetch_add(1, std::memory_order_relaxed) % FLAGS_hot_key_sample_interval == 0) {
+            SampleHotKey(*session.GetCompileInfo(), row);
+        }
+    }
+    if (session.GetProfile()) {
+        response.set_profile(session.GetProfile()->ToString());
     }
     response.set_byte_size(buf_total_size);
     response.set_count(1);
@@ -5032,15 +5826,39 @@ void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::Query
     response.set_code(::openmldb::base::kOk);
 }
 
+void TabletImpl::SampleHotKey(const ::hybridse::vm::CompileInfo& compile_info, const ::hybridse::codec::Row& row) {
+    int32_t idx = compile_info.GetRouterColIdx();
+    if (idx < 0) {
+        return;
+    }
+    const auto& schema = compile_info.GetRequestSchema();
+    auto handler = std::dynamic_pointer_cast<::openmldb::catalog::TabletTableHandler>(
+        catalog_->GetTable(compile_info.GetRequestDbName(), compile_info.GetRequestName()));
+    if (!handler) {
+        return;
+    }
+    // the key is formatted as the sdk does, so that the sdk can recognize it
+    ::hybridse::codec::RowView row_view(schema, row.buf(), row.size());
+    std::string key = row_view.GetAsString(idx);
+    std::shared_ptr<Table> table = GetTable(handler->GetTid(), handler->GetPid(key));
+    if (table) {
+        table->GetHotKeySketch().Offer(key);
+    }
+}
+
 void TabletImpl::CreateProcedure(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info) {
     const std::string& db_name = sp_info->GetDbName();
     const std::string& sp_name = sp_info->GetSpName();
     const std::string& sql = sp_info->GetSql();
-    auto long_windows = sp_info->GetOption(hybridse::vm::LONG_WINDOWS);
     std::shared_ptr<std::unordered_map<std::string, std::string>> options = nullptr;
-    if (long_windows) {
-        options = std::make_shared<std::unordered_map<std::string, std::string>>();
-        options->emplace(hybridse::vm::LONG_WINDOWS, *long_windows);
+    for (const char* name : {hybridse::vm::LONG_WINDOWS, hybridse::vm::WINDOW_CACHE}) {
+        auto value = sp_info->GetOption(name);
+        if (value) {
+            if (!options) {
+                options = std::make_shared<std::unordered_map<std::string, std::string>>();
+            }
+            options->emplace(name, *value);
+        }
     }
 
     ::hybridse::base::Status status;
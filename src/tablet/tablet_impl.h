@@ -17,6 +17,7 @@
 #ifndef SRC_TABLET_TABLET_IMPL_H_
 #define SRC_TABLET_TABLET_IMPL_H_
 
+#include <brpc/closure_guard.h>
 #include <brpc/server.h>
 
 #include <list>
@@ -39,9 +40,13 @@
 #include "statistics/query_response_time/deploy_query_response_time.h"
 #include "storage/mem_table.h"
 #include "storage/mem_table_snapshot.h"
+#include "tablet/admission_controller.h"
 #include "tablet/bulk_load_mgr.h"
 #include "tablet/combine_iterator.h"
+#include "tablet/deploy_latency.h"
 #include "tablet/file_receiver.h"
+#include "tablet/query_cursor_mgr.h"
+#include "tablet/query_scheduler.h"
 #include "tablet/sp_cache.h"
 #include "vm/engine.h"
 #include "zk/zk_client.h"
@@ -145,7 +150,7 @@ class TabletImpl : public ::openmldb::api::TabletServer {
                       ::openmldb::api::GeneralResponse* response, Closure* done);
 
     void SendData(RpcController* controller, const ::openmldb::api::SendDataRequest* request,
-                  ::openmldb::api::GeneralResponse* response, Closure* done);
+                  ::openmldb::api::SendDataResponse* response, Closure* done);
 
     void GetTaskStatus(RpcController* controller, const ::openmldb::api::TaskStatusRequest* request,
                        ::openmldb::api::TaskStatusResponse* response, Closure* done);
@@ -213,6 +218,12 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void ExtractMultiIndexData(RpcController* controller, const ::openmldb::api::ExtractMultiIndexDataRequest* request,
                           ::openmldb::api::GeneralResponse* response, Closure* done);
 
+    void SplitTable(RpcController* controller, const ::openmldb::api::SplitTableRequest* request,
+                    ::openmldb::api::GeneralResponse* response, Closure* done);
+
+    void FinishSplitTable(RpcController* controller, const ::openmldb::api::FinishSplitTableRequest* request,
+                          ::openmldb::api::GeneralResponse* response, Closure* done);
+
     void AddIndex(RpcController* controller, const ::openmldb::api::AddIndexRequest* request,
                   ::openmldb::api::GeneralResponse* response, Closure* done);
 
@@ -294,6 +305,10 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     void GcTable(uint32_t tid, uint32_t pid, bool execute_once);
 
+    void SchedTrainCompressDict(const std::shared_ptr<Table>& table);
+
+    void TrainCompressDict(uint32_t tid, uint32_t pid);
+
     void GcTableSnapshot(uint32_t tid, uint32_t pid);
 
     int CheckTableMeta(const openmldb::api::TableMeta* table_meta,
@@ -326,10 +341,37 @@ class TabletImpl : public ::openmldb::api::TabletServer {
                                   ::openmldb::common::ColumnKey& column_key, uint32_t idx,  // NOLINT
                                   uint32_t partition_num, std::shared_ptr<::openmldb::api::TaskInfo> task);
 
+    void SplitTableInternal(std::shared_ptr<::openmldb::storage::Table> table,
+                            std::shared_ptr<::openmldb::storage::MemTableSnapshot> memtable_snapshot,
+                            std::shared_ptr<LogReplicator> replicator,
+                            std::shared_ptr<::openmldb::storage::Table> new_table,
+                            std::shared_ptr<LogReplicator> new_replicator, uint64_t modulus,
+                            std::shared_ptr<::openmldb::api::TaskInfo> task);
+
+    // put the part of `entry` whose keys are moved by the split into the new partition
+    bool ForwardSplitEntry(std::shared_ptr<::openmldb::storage::Table> new_table,
+                           std::shared_ptr<LogReplicator> new_replicator, uint64_t modulus,
+                           const ::openmldb::api::LogEntry& entry);
+
+    void FinishSplitTableInternal(uint32_t tid, uint32_t pid, uint64_t modulus,
+                                  std::shared_ptr<::openmldb::api::TaskInfo> task);
+
+    // reject the puts of the keys moved by the split from now on, and keep it in the table meta on disk
+    bool AddSplitModulus(std::shared_ptr<::openmldb::storage::Table> table, uint64_t modulus);
+
+    // stop forwarding the writes of the table split by the op `op_id` to the new partition
+    void ClearSplitHook(uint64_t op_id);
+
     void SchedMakeSnapshot();
 
     void GetDiskused();
 
+    void SchedExpireQueryCursor();
+
+    void SchedUpdateMemoryUsed();
+
+    void SchedDecayHotKey();
+
     void CheckZkClient();
 
     void RefreshTableInfo();
@@ -395,8 +437,18 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     bool GetRealEp(uint64_t tid, uint64_t pid, std::map<std::string, std::string>* real_ep_map);
 
+    // run a batch query on the batch executor if it is enabled, a request mode query runs at once as a latency
+    // critical request. The admission ticket is released after the query is done
+    void ScheduleQuery(RpcController* controller, const openmldb::api::QueryRequest* request,
+                       ::openmldb::api::QueryResponse* response, brpc::ClosureGuard* done_guard,
+                       const std::shared_ptr<AdmissionController::Ticket>& ticket);
+
     void ProcessQuery(RpcController* controller, const openmldb::api::QueryRequest* request,
                       ::openmldb::api::QueryResponse* response, butil::IOBuf* buf);
+    // move rows of a batch query cursor into buf until the page is full, appended to the rows already in response.
+    // page_size 0 means the page is bounded by scan_max_bytes_size only
+    void FillQueryPage(QueryCursor* cursor, uint32_t page_size, ::openmldb::api::QueryResponse* response,
+                       butil::IOBuf* buf);
     void ProcessBatchRequestQuery(RpcController* controller, const openmldb::api::SQLBatchRequestQueryRequest* request,
                                   openmldb::api::SQLBatchRequestQueryResponse* response,
                                   butil::IOBuf& buf);  // NOLINT
@@ -418,7 +470,14 @@ class TabletImpl : public ::openmldb::api::TabletServer {
  private:
     void RunRequestQuery(RpcController* controller, const openmldb::api::QueryRequest& request,
                          ::hybridse::vm::RequestRunSession& session,                  // NOLINT
-                         openmldb::api::QueryResponse& response, butil::IOBuf& buf);  // NOLINT
+                         openmldb::api::QueryResponse& response, butil::IOBuf& buf,  // NOLINT
+                         DeployLatency* latency = nullptr);
+
+    // a follower serves a read only if it is within the staleness bound, the leader always does
+    bool CheckStaleness(const ::openmldb::api::StalenessBound& bound, std::string* msg);
+
+    // count the router key of a request mode query into the hot key sketch of its partition
+    void SampleHotKey(const ::hybridse::vm::CompileInfo& compile_info, const ::hybridse::codec::Row& row);
 
     void CreateProcedure(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info);
 
@@ -437,6 +496,8 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     ThreadPool io_pool_;
     ThreadPool snapshot_pool_;
     std::map<uint64_t, std::list<std::shared_ptr<::openmldb::api::TaskInfo>>> task_map_;
+    // the split ops to the tid and pid of the tables whose writes are forwarded, guarded by mu_
+    std::map<uint64_t, std::pair<uint32_t, uint32_t>> split_ops_;
     std::set<std::string> sync_snapshot_set_;
     std::map<std::string, std::shared_ptr<FileReceiver>> file_receiver_map_;
     BulkLoadMgr bulk_load_mgr_;
@@ -453,6 +514,10 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     std::string zk_path_;
     std::string endpoint_;
     std::shared_ptr<SpCache> sp_cache_;
+    QueryCursorMgr query_cursor_mgr_;
+    AdmissionController admission_controller_;
+    QueryScheduler query_scheduler_;
+    std::atomic<uint64_t> hot_key_sample_cnt_;
     std::string notify_path_;
     std::string sp_root_path_;
     std::string globalvar_changed_notify_path_;
@@ -462,6 +527,7 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     std::shared_ptr<std::map<std::string, std::string>> global_variables_;
 
     std::unique_ptr<openmldb::statistics::DeployQueryTimeCollector> deploy_collector_;
+    DeployLatencyMgr deploy_latency_mgr_;
 };
 
 }  // namespace tablet
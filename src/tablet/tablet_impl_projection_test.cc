@@ -45,6 +45,7 @@ DECLARE_int32(gc_interval);
 DECLARE_int32(gc_safe_offset);
 DECLARE_int32(make_snapshot_threshold_offset);
 DECLARE_int32(binlog_delete_interval);
+DECLARE_uint32(query_cursor_max_cnt);
 
 namespace openmldb {
 namespace tablet {
@@ -435,6 +436,117 @@ TEST_P(TabletProjectTest, sql_case) {
         ASSERT_EQ(0, response.code());
         ASSERT_EQ(1, (int32_t)response.count());
     }
+    // put another record and query page by page
+    {
+        ::openmldb::api::PutRequest request;
+        request.set_tid(tid);
+        request.set_pid(0);
+        request.set_format_version(1);
+        ::openmldb::api::Dimension* dim = request.add_dimensions();
+        dim->set_idx(0);
+        dim->set_key(args->pk);
+        request.set_value(args->input_row);
+        ::openmldb::api::PutResponse response;
+        tablet_.Put(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+    }
+    {
+        ::openmldb::api::QueryRequest request;
+        request.set_db(db);
+        request.set_sql("select col1 from " + name + ";");
+        request.set_is_batch(true);
+        request.set_page_size(1);
+        brpc::Controller cntl;
+        ::openmldb::api::QueryResponse response;
+        tablet_.Query(&cntl, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+        ASSERT_EQ(1, (int32_t)response.count());
+        ASSERT_TRUE(response.has_more());
+
+        ::openmldb::api::QueryRequest next_request;
+        next_request.set_is_batch(true);
+        next_request.set_page_size(1);
+        next_request.set_cursor_id(response.cursor_id());
+        brpc::Controller next_cntl;
+        ::openmldb::api::QueryResponse next_response;
+        tablet_.Query(&next_cntl, &next_request, &next_response, &closure);
+        ASSERT_EQ(0, next_response.code());
+        ASSERT_EQ(1, (int32_t)next_response.count());
+        ASSERT_FALSE(next_response.has_more());
+        ASSERT_EQ(response.schema(), next_response.schema());
+
+        // the cursor is released after the last page
+        brpc::Controller last_cntl;
+        ::openmldb::api::QueryResponse last_response;
+        tablet_.Query(&last_cntl, &next_request, &last_response, &closure);
+        ASSERT_EQ(::openmldb::base::kQueryCursorNotFound, last_response.code());
+    }
+    // an abandoned cursor is released by close_cursor
+    {
+        ::openmldb::api::QueryRequest request;
+        request.set_db(db);
+        request.set_sql("select col1 from " + name + ";");
+        request.set_is_batch(true);
+        request.set_page_size(1);
+        brpc::Controller cntl;
+        ::openmldb::api::QueryResponse response;
+        tablet_.Query(&cntl, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+        ASSERT_TRUE(response.has_more());
+
+        ::openmldb::api::QueryRequest close_request;
+        close_request.set_is_batch(true);
+        close_request.set_cursor_id(response.cursor_id());
+        close_request.set_close_cursor(true);
+        brpc::Controller close_cntl;
+        ::openmldb::api::QueryResponse close_response;
+        tablet_.Query(&close_cntl, &close_request, &close_response, &closure);
+        ASSERT_EQ(0, close_response.code());
+
+        ::openmldb::api::QueryRequest next_request;
+        next_request.set_is_batch(true);
+        next_request.set_page_size(1);
+        next_request.set_cursor_id(response.cursor_id());
+        brpc::Controller next_cntl;
+        ::openmldb::api::QueryResponse next_response;
+        tablet_.Query(&next_cntl, &next_request, &next_response, &closure);
+        ASSERT_EQ(::openmldb::base::kQueryCursorNotFound, next_response.code());
+    }
+    // the whole result is responded at once if no more cursors can be opened
+    {
+        ::openmldb::api::QueryRequest request;
+        request.set_db(db);
+        request.set_sql("select col1 from " + name + ";");
+        request.set_is_batch(true);
+        request.set_page_size(1);
+        std::vector<uint64_t> cursor_ids;
+        for (uint32_t i = 0; i < FLAGS_query_cursor_max_cnt; i++) {
+            brpc::Controller cntl;
+            ::openmldb::api::QueryResponse response;
+            tablet_.Query(&cntl, &request, &response, &closure);
+            ASSERT_EQ(0, response.code());
+            ASSERT_TRUE(response.has_more());
+            cursor_ids.push_back(response.cursor_id());
+        }
+        brpc::Controller cntl;
+        ::openmldb::api::QueryResponse response;
+        tablet_.Query(&cntl, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+        ASSERT_EQ(2, (int32_t)response.count());
+        ASSERT_FALSE(response.has_more());
+        ASSERT_FALSE(response.has_cursor_id());
+
+        for (auto cursor_id : cursor_ids) {
+            ::openmldb::api::QueryRequest close_request;
+            close_request.set_is_batch(true);
+            close_request.set_cursor_id(cursor_id);
+            close_request.set_close_cursor(true);
+            brpc::Controller close_cntl;
+            ::openmldb::api::QueryResponse close_response;
+            tablet_.Query(&close_cntl, &close_request, &close_response, &closure);
+            ASSERT_EQ(0, close_response.code());
+        }
+    }
 }
 
 TEST_P(TabletProjectTest, scan_case) {
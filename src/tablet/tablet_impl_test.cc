@@ -27,6 +27,7 @@
 
 #include "base/file_util.h"
 #include "base/glog_wapper.h"
+#include "base/hash.h"
 #include "base/kv_iterator.h"
 #include "base/strings.h"
 #include "boost/lexical_cast.hpp"
@@ -53,6 +54,7 @@ DECLARE_string(db_root_path);
 DECLARE_string(recycle_bin_root_path);
 DECLARE_string(endpoint);
 DECLARE_uint32(recycle_ttl);
+DECLARE_uint32(split_table_clean_delay);
 
 namespace openmldb {
 namespace tablet {
@@ -5831,6 +5833,261 @@ TEST_F(TabletImplTest, CreateAggregator) {
     }
 }
 
+// create partition 1 of table `tid` in follower mode
+void CreateReplicaTable(TabletImpl* tablet, uint32_t tid, ::openmldb::api::TableMode mode, uint32_t pid = 1) {
+    ::openmldb::api::CreateTableRequest request;
+    ::openmldb::api::TableMeta* table_meta = request.mutable_table_meta();
+    table_meta->set_name("t0");
+    table_meta->set_tid(tid);
+    table_meta->set_pid(pid);
+    AddDefaultSchema(0, 0, ::openmldb::type::TTLType::kAbsoluteTime, table_meta);
+    table_meta->set_mode(mode);
+    ::openmldb::api::CreateTableResponse response;
+    MockClosure closure;
+    tablet->CreateTable(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+}
+
+void CreateFollowerTable(TabletImpl* tablet, uint32_t tid) {
+    CreateReplicaTable(tablet, tid, ::openmldb::api::TableMode::kTableFollower);
+}
+
+// replicate the entry of `log_index` to the follower from a leader whose last offset is `leader_offset`
+void AppendFollowerEntry(TabletImpl* tablet, uint32_t tid, uint64_t log_index, uint64_t leader_offset) {
+    ::openmldb::api::AppendEntriesRequest request;
+    request.set_tid(tid);
+    request.set_pid(1);
+    request.set_pre_log_index(log_index - 1);
+    request.set_leader_offset(leader_offset);
+    auto entry = request.add_entries();
+    entry->set_log_index(log_index);
+    entry->set_ts(9527);
+    entry->set_value(::openmldb::test::EncodeKV("test1", "test0"));
+    auto dimension = entry->add_dimensions();
+    dimension->set_key("test1");
+    dimension->set_idx(0);
+    ::openmldb::api::AppendEntriesResponse response;
+    MockClosure closure;
+    tablet->AppendEntries(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+}
+
+int SubBatchRequestQueryWithBound(TabletImpl* tablet, uint32_t tid, uint64_t max_offset) {
+    ::openmldb::api::SQLBatchRequestQueryRequest request;
+    request.set_db("db");
+    request.set_sql("select * from t0;");
+    auto bound = request.mutable_staleness_bound();
+    bound->set_tid(tid);
+    bound->set_pid(1);
+    bound->set_max_offset(max_offset);
+    ::openmldb::api::SQLBatchRequestQueryResponse response;
+    brpc::Controller cntl;
+    MockClosure closure;
+    tablet->SubBatchRequestQuery(&cntl, &request, &response, &closure);
+    return response.code();
+}
+
+TEST_F(TabletImplTest, SubBatchRequestQueryStaleness) {
+    TabletImpl tablet;
+    tablet.Init("");
+    uint32_t tid = counter++;
+    CreateFollowerTable(&tablet, tid);
+    // the follower has not heard from the leader
+    ASSERT_EQ(::openmldb::base::ReturnCode::kReplicaTooStale, SubBatchRequestQueryWithBound(&tablet, tid, 10));
+    // the follower lags behind the leader by 99 offsets
+    AppendFollowerEntry(&tablet, tid, 1, 100);
+    ASSERT_EQ(::openmldb::base::ReturnCode::kReplicaTooStale, SubBatchRequestQueryWithBound(&tablet, tid, 10));
+    // the query is not rejected by the staleness check once the follower catches up
+    AppendFollowerEntry(&tablet, tid, 2, 5);
+    ASSERT_NE(::openmldb::base::ReturnCode::kReplicaTooStale, SubBatchRequestQueryWithBound(&tablet, tid, 10));
+}
+
+int QueryWithBound(TabletImpl* tablet, const ::openmldb::api::StalenessBound& bound) {
+    ::openmldb::api::QueryRequest request;
+    request.set_db("db");
+    request.set_sql("select * from t0;");
+    request.set_is_batch(true);
+    request.mutable_staleness_bound()->CopyFrom(bound);
+    ::openmldb::api::QueryResponse response;
+    brpc::Controller cntl;
+    MockClosure closure;
+    tablet->Query(&cntl, &request, &response, &closure);
+    return response.code();
+}
+
+TEST_F(TabletImplTest, QueryStalenessOffset) {
+    TabletImpl tablet;
+    tablet.Init("");
+    uint32_t tid = counter++;
+    CreateFollowerTable(&tablet, tid);
+    ::openmldb::api::StalenessBound bound;
+    bound.set_tid(tid);
+    bound.set_pid(1);
+    bound.set_max_offset(10);
+    // the follower has not heard from the leader
+    ASSERT_EQ(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+    // the follower lags behind the leader by exactly the bound
+    AppendFollowerEntry(&tablet, tid, 1, 11);
+    ASSERT_NE(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+    // one offset more than the bound
+    bound.set_max_offset(9);
+    ASSERT_EQ(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+    AppendFollowerEntry(&tablet, tid, 2, 11);
+    ASSERT_NE(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+    // the partition is not on this tablet
+    bound.set_pid(2);
+    ASSERT_EQ(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+}
+
+TEST_F(TabletImplTest, QueryStalenessMs) {
+    TabletImpl tablet;
+    tablet.Init("");
+    uint32_t tid = counter++;
+    CreateFollowerTable(&tablet, tid);
+    ::openmldb::api::StalenessBound bound;
+    bound.set_tid(tid);
+    bound.set_pid(1);
+    bound.set_max_ms(60 * 1000);
+    // the follower hears from the leader, but has never caught up with it
+    AppendFollowerEntry(&tablet, tid, 1, 100);
+    ASSERT_EQ(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+    // caught up just now
+    AppendFollowerEntry(&tablet, tid, 2, 2);
+    ASSERT_NE(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+    // the leader moves on, the follower is still within the bound since it caught up recently
+    AppendFollowerEntry(&tablet, tid, 3, 100);
+    ASSERT_NE(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+    // but not once the bound is shorter than the time since it caught up
+    bound.set_max_ms(1);
+    sleep(1);
+    ASSERT_EQ(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+}
+
+TEST_F(TabletImplTest, QueryStalenessLeader) {
+    TabletImpl tablet;
+    tablet.Init("");
+    uint32_t tid = counter++;
+    CreateReplicaTable(&tablet, tid, ::openmldb::api::TableMode::kTableLeader);
+    ::openmldb::api::StalenessBound bound;
+    bound.set_tid(tid);
+    bound.set_pid(1);
+    bound.set_max_ms(1);
+    bound.set_max_offset(0);
+    // the leader is never stale
+    ASSERT_NE(::openmldb::base::ReturnCode::kReplicaTooStale, QueryWithBound(&tablet, bound));
+}
+
+// find a key which the split by `modulus` moves to the new partition, or keeps in the old one
+std::string FindSplitKey(uint64_t modulus, bool moved) {
+    for (uint32_t i = 0;; i++) {
+        std::string key = "key" + std::to_string(i);
+        if ((static_cast<uint64_t>(::openmldb::base::hash64(key)) % modulus >= modulus / 2) == moved) {
+            return key;
+        }
+    }
+}
+
+int PutKey(TabletImpl* tablet, uint32_t tid, uint32_t pid, const std::string& key) {
+    ::openmldb::api::PutRequest request;
+    request.set_tid(tid);
+    request.set_pid(pid);
+    request.set_time(9527);
+    request.set_value(::openmldb::test::EncodeKV(key, "value"));
+    PackDefaultDimension(key, &request);
+    ::openmldb::api::PutResponse response;
+    MockClosure closure;
+    tablet->Put(NULL, &request, &response, &closure);
+    return response.code();
+}
+
+void SetSplitTaskInfo(uint64_t op_id, ::openmldb::api::TaskType task_type, ::openmldb::api::TaskInfo* task_info) {
+    task_info->set_op_id(op_id);
+    task_info->set_op_type(::openmldb::api::OPType::kSplitPartitionOP);
+    task_info->set_task_type(task_type);
+    task_info->set_status(::openmldb::api::TaskStatus::kInited);
+}
+
+void StartSplitTable(TabletImpl* tablet, uint32_t tid, uint64_t op_id) {
+    ::openmldb::api::SplitTableRequest request;
+    request.set_tid(tid);
+    request.set_pid(1);
+    request.set_new_pid(2);
+    request.set_modulus(2);
+    SetSplitTaskInfo(op_id, ::openmldb::api::TaskType::kSplitTable, request.mutable_task_info());
+    ::openmldb::api::GeneralResponse response;
+    MockClosure closure;
+    tablet->SplitTable(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+    sleep(1);
+}
+
+TEST_F(TabletImplTest, SplitTableCancel) {
+    TabletImpl tablet;
+    tablet.Init("");
+    uint32_t id = counter++;
+    CreateReplicaTable(&tablet, id, ::openmldb::api::TableMode::kTableLeader);
+    CreateReplicaTable(&tablet, id, ::openmldb::api::TableMode::kTableLeader, 2);
+    uint64_t op_id = counter++;
+    StartSplitTable(&tablet, id, op_id);
+    std::string moved_key = FindSplitKey(2, true);
+    auto new_table = tablet.GetTable(id, 2);
+    ASSERT_EQ(0, PutKey(&tablet, id, 1, moved_key));
+    ASSERT_EQ(1u, new_table->GetRecordCnt());
+
+    // the writes are not forwarded any more once the op is canceled
+    ::openmldb::api::CancelOPRequest request;
+    request.set_op_id(op_id);
+    ::openmldb::api::GeneralResponse response;
+    MockClosure closure;
+    tablet.CancelOP(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+    ASSERT_EQ(0, PutKey(&tablet, id, 1, moved_key));
+    ASSERT_EQ(1u, new_table->GetRecordCnt());
+}
+
+TEST_F(TabletImplTest, FinishSplitTable) {
+    uint32_t old_delay = FLAGS_split_table_clean_delay;
+    FLAGS_split_table_clean_delay = 100;
+    TabletImpl tablet;
+    tablet.Init("");
+    uint32_t id = counter++;
+    CreateReplicaTable(&tablet, id, ::openmldb::api::TableMode::kTableLeader);
+    CreateReplicaTable(&tablet, id, ::openmldb::api::TableMode::kTableLeader, 2);
+    uint64_t op_id = counter++;
+    StartSplitTable(&tablet, id, op_id);
+    std::string moved_key = FindSplitKey(2, true);
+    std::string kept_key = FindSplitKey(2, false);
+    ASSERT_EQ(0, PutKey(&tablet, id, 1, moved_key));
+
+    ::openmldb::api::FinishSplitTableRequest request;
+    request.set_tid(id);
+    request.set_pid(1);
+    request.set_modulus(2);
+    SetSplitTaskInfo(op_id, ::openmldb::api::TaskType::kFinishSplitTable, request.mutable_task_info());
+    ::openmldb::api::GeneralResponse response;
+    MockClosure closure;
+    tablet.FinishSplitTable(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+    sleep(1);
+    // the moved keys are rejected instead of being written to the old partition silently
+    ASSERT_EQ(::openmldb::base::ReturnCode::kPartitionKeyMoved, PutKey(&tablet, id, 1, moved_key));
+    ASSERT_EQ(0, PutKey(&tablet, id, 1, kept_key));
+    ASSERT_EQ(1u, tablet.GetTable(id, 2)->GetRecordCnt());
+
+    // a follower keeps the split in case it becomes the leader
+    uint32_t follower_id = counter++;
+    CreateFollowerTable(&tablet, follower_id);
+    request.set_tid(follower_id);
+    request.clear_task_info();
+    tablet.FinishSplitTable(NULL, &request, &response, &closure);
+    ASSERT_EQ(0, response.code());
+    auto follower_table = tablet.GetTable(follower_id, 1);
+    ASSERT_TRUE(follower_table->IsMovedBySplit(moved_key));
+    ASSERT_FALSE(follower_table->IsMovedBySplit(kept_key));
+    ASSERT_EQ(1, follower_table->GetTableMeta()->split_modulus_size());
+    FLAGS_split_table_clean_delay = old_delay;
+}
+
 }  // namespace tablet
 }  // namespace openmldb
 
@@ -0,0 +1,31 @@
+# Copyright 2021 4Paradigm
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+set(ZSTD_URL https://github.com/facebook/zstd/releases/download/v1.5.5/zstd-1.5.5.tar.gz)
+
+message(STATUS "build zstd from ${ZSTD_URL}")
+
+find_program(MAKE_EXE NAMES gmake nmake make REQUIRED)
+
+ExternalProject_Add(
+  zstd
+  URL ${ZSTD_URL}
+  URL_HASH SHA256=9c4396cc829cfae319a6e2615202e82aad41372073ee9c5a50b4e1cbe9cb7b1a
+  PREFIX ${DEPS_BUILD_DIR}
+  DOWNLOAD_DIR ${DEPS_DOWNLOAD_DIR}/zstd
+  INSTALL_DIR ${DEPS_INSTALL_DIR}
+  BUILD_IN_SOURCE True
+  CONFIGURE_COMMAND ""
+  BUILD_COMMAND bash -c "${CONFIGURE_OPTS} ${MAKE_EXE} ${MAKEOPTS} -C lib libzstd.a"
+  INSTALL_COMMAND ${MAKE_EXE} -C lib install-static install-includes PREFIX=<INSTALL_DIR>)